@@ -0,0 +1,268 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+#include <QObject>
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include "../../../fitshelpers.h"
+#include "fitsviewer/fitsdata.h"
+#include "ekos/auxiliary/incrementalsolver.h"
+#include "skyobjects/skypoint.h"
+
+class TestIncrementalSolver : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestIncrementalSolver();
+        ~TestIncrementalSolver() override = default;
+
+    private slots:
+        void testOffsetSequence_data();
+        void testOffsetSequence();
+        void testFallback();
+        void testSparseCatalog();
+};
+
+#include "testincrementalsolver.moc"
+
+namespace
+{
+constexpr int WIDTH = 800;
+constexpr int HEIGHT = 600;
+constexpr double PIXSCALE = 4.0;
+// Catalog stars fainter than that are not in the frames
+constexpr double FRAME_MAGNITUDE_LIMIT = 11.5;
+
+// Random catalog stars within two degrees of (ra, dec)
+QVector<IncrementalSolver::ReferenceStar> syntheticCatalog(double ra, double dec, QRandomGenerator &random)
+{
+    QVector<IncrementalSolver::ReferenceStar> catalog;
+    for (int i = 0; i < 1500; i++)
+    {
+        double const decOffset = random.bounded(4.0) - 2;
+        double const raOffset = (random.bounded(4.0) - 2) / std::max(0.05, std::cos((dec + decOffset) * M_PI / 180));
+        catalog.append({std::fmod(ra + raOffset + 360, 360), qBound(-89.99, dec + decOffset, 89.99), 7 + 5 * std::sqrt(random.generateDouble())});
+    }
+    return catalog;
+}
+
+/* A frame of the catalog stars seen with a solution. The stars are placed with the WCS that FITSData injects for
+ * that solution, so that the frame is solved with the conventions of the rest of KStars.
+ */
+bool renderFrame(const QVector<IncrementalSolver::ReferenceStar> &catalog, const FITSImage::Solution &solution,
+                 QRandomGenerator &random, QByteArray &frame)
+{
+    FITSData blank;
+    if (!blank.loadFromBuffer(fitsFrame16(QVector<float>(WIDTH * HEIGHT, 0), WIDTH, HEIGHT, random), "fits"))
+        return false;
+    blank.injectWCS(solution.orientation, solution.ra, solution.dec, solution.pixscale, solution.parity != FITSImage::POSITIVE);
+    if (!blank.checkForWCS())
+        return false;
+
+    QVector<float> image(WIDTH * HEIGHT, 1000.0f);
+    for (auto const &star : catalog)
+    {
+        QPointF pixel, imagePoint;
+        if (star.mag > FRAME_MAGNITUDE_LIMIT || !blank.wcsToPixel(SkyPoint(star.ra / 15, star.dec), pixel, imagePoint))
+            continue;
+        double const peak = 30000 * std::pow(10, -0.4 * (star.mag - 7));
+        for (int y = static_cast<int>(pixel.y()) - 6; y <= static_cast<int>(pixel.y()) + 6; y++)
+            for (int x = static_cast<int>(pixel.x()) - 6; x <= static_cast<int>(pixel.x()) + 6; x++)
+                if (x >= 0 && y >= 0 && x < WIDTH && y < HEIGHT)
+                    image[x + y * WIDTH] += peak * std::exp(-((x - pixel.x()) * (x - pixel.x()) + (y - pixel.y()) * (y - pixel.y())) /
+                                                            (2 * 1.3 * 1.3));
+    }
+    frame = fitsFrame16(image, WIDTH, HEIGHT, random);
+    return true;
+}
+
+double arcsecondsBetween(const FITSImage::Solution &a, const FITSImage::Solution &b)
+{
+    SkyPoint const pa(a.ra / 15, a.dec), pb(b.ra / 15, b.dec);
+    return pa.angularDistanceTo(&pb).Degrees() * 3600;
+}
+}
+
+TestIncrementalSolver::TestIncrementalSolver() : QObject()
+{
+}
+
+void TestIncrementalSolver::testOffsetSequence_data()
+{
+    QTest::addColumn<double>("DEC");
+    QTest::addColumn<double>("ORIENTATION");
+    QTest::addColumn<bool>("EAST_TO_THE_RIGHT");
+
+    QTest::newRow("near the north pole") << 88.7 << 30.0 << true;
+    QTest::newRow("northern field, east to the left") << 41.0 << -75.0 << false;
+    QTest::newRow("southern field") << -62.0 << 160.0 << true;
+}
+
+/* A regression harness over a sequence of frames moving by a few arcminutes, as polar alignment knob adjustments
+ * or a re-centring loop would. Each frame is solved from the solution of the previous one, and the time of each
+ * solve and its error against the solution the frame was made with are reported.
+ */
+void TestIncrementalSolver::testOffsetSequence()
+{
+    QFETCH(double, DEC);
+    QFETCH(double, ORIENTATION);
+    QFETCH(bool, EAST_TO_THE_RIGHT);
+
+    QRandomGenerator random(42);
+    QVector<IncrementalSolver::ReferenceStar> const catalog = syntheticCatalog(40, DEC, random);
+
+    // The catalog misses a tenth of the stars of the frames
+    QVector<IncrementalSolver::ReferenceStar> references;
+    for (auto const &star : catalog)
+        if (random.bounded(10) > 0)
+            references.append(star);
+
+    FITSImage::Solution truth;
+    truth.ra = 40;
+    truth.dec = DEC;
+    truth.orientation = ORIENTATION;
+    truth.pixscale = PIXSCALE;
+    truth.parity = EAST_TO_THE_RIGHT ? FITSImage::NEGATIVE : FITSImage::POSITIVE;
+
+    // The first frame was solved by the full solver
+    FITSImage::Solution previous = truth;
+    for (int frame = 1; frame <= 6; frame++)
+    {
+        // Move by about three arcminutes and rotate slightly
+        SkyPoint moved(truth.ra / 15, truth.dec);
+        moved.setRA(moved.ra().Degrees() / 15 + 2.5 / 60 / 15 / std::cos(truth.dec * M_PI / 180));
+        moved.setDec(moved.dec().Degrees() - 1.5 / 60);
+        truth.ra = moved.ra().Degrees();
+        truth.dec = moved.dec().Degrees();
+        truth.orientation += 0.1;
+
+        QByteArray buffer;
+        if (!renderFrame(catalog, truth, random, buffer))
+            QSKIP("WCS is not available, skipping test.");
+
+        QSharedPointer<FITSData> image(new FITSData());
+        QVERIFY(image->loadFromBuffer(buffer, "fits"));
+
+        IncrementalSolver solver(previous);
+        solver.setReferenceStars(references);
+
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY2(solver.solve(image), qPrintable(solver.failure()));
+        double const elapsed = timer.elapsed();
+
+        FITSImage::Solution const &solution = solver.solution();
+        double const error = arcsecondsBetween(solution, truth);
+        double const orientationError = std::remainder(solution.orientation - truth.orientation, 360);
+        qInfo() << QString("Frame %1: %2 ms, %3 stars matched, residual %4 px, error %5\" orientation %6\" scale %7%")
+                .arg(frame).arg(elapsed).arg(solver.matchedStars()).arg(solver.residual(), 0, 'f', 3)
+                .arg(error, 0, 'f', 2).arg(orientationError * 3600, 0, 'f', 1)
+                .arg((solution.pixscale / truth.pixscale - 1) * 100, 0, 'f', 3);
+
+        QVERIFY(solver.matchedStars() >= IncrementalSolver::MINIMUM_MATCHES);
+        QVERIFY2(error < PIXSCALE / 4, qPrintable(QString("Error of %1 arcseconds").arg(error)));
+        QVERIFY(std::fabs(orientationError) < 0.02);
+        QVERIFY(std::fabs(solution.pixscale / truth.pixscale - 1) < 0.001);
+        QCOMPARE(solution.parity, truth.parity);
+
+        previous = solution;
+    }
+}
+
+void TestIncrementalSolver::testFallback()
+{
+    QRandomGenerator random(7);
+    QVector<IncrementalSolver::ReferenceStar> const catalog = syntheticCatalog(40, 30, random);
+
+    FITSImage::Solution truth;
+    truth.ra = 40;
+    truth.dec = 30;
+    truth.orientation = 10;
+    truth.pixscale = PIXSCALE;
+    truth.parity = FITSImage::NEGATIVE;
+
+    QByteArray buffer;
+    if (!renderFrame(catalog, truth, random, buffer))
+        QSKIP("WCS is not available, skipping test.");
+    QSharedPointer<FITSData> image(new FITSData());
+    QVERIFY(image->loadFromBuffer(buffer, "fits"));
+
+    // The pointing moved further than the search radius, the full solver is needed
+    FITSImage::Solution far = truth;
+    far.dec += 1;
+    IncrementalSolver farSolver(far);
+    farSolver.setReferenceStars(catalog);
+    QVERIFY(!farSolver.solve(image));
+    QVERIFY(!farSolver.failure().isEmpty());
+
+    // The scale changed, binning for instance
+    FITSImage::Solution binned = truth;
+    binned.pixscale *= 2;
+    IncrementalSolver binnedSolver(binned);
+    binnedSolver.setReferenceStars(catalog);
+    QVERIFY(!binnedSolver.solve(image));
+
+    // No reference stars
+    IncrementalSolver emptySolver(truth);
+    emptySolver.setReferenceStars({{truth.ra, truth.dec, 8}});
+    QVERIFY(!emptySolver.solve(image));
+
+    // The right guess solves, the stars being detected in a thread without changing the image
+    IncrementalSolver solver(truth);
+    solver.setReferenceStars(catalog);
+    QSignalSpy done(&solver, &IncrementalSolver::done);
+    QVERIFY2(solver.start(image), qPrintable(solver.failure()));
+    QVERIFY(done.wait(10000));
+    QVERIFY2(done.first().first().toBool(), qPrintable(solver.failure()));
+    QVERIFY(arcsecondsBetween(solver.solution(), truth) < PIXSCALE / 4);
+    QVERIFY(solver.detectedStars() >= IncrementalSolver::MINIMUM_MATCHES);
+    QVERIFY(image->getStarCenters().isEmpty());
+}
+
+/* The KStars catalog without the deep star catalogs holds about a star per square degree. The frames of a small
+ * field have more stars than that, and the solver should give up before detecting them.
+ */
+void TestIncrementalSolver::testSparseCatalog()
+{
+    QRandomGenerator random(11);
+    QVector<IncrementalSolver::ReferenceStar> const catalog = syntheticCatalog(40, 30, random);
+
+    QVector<IncrementalSolver::ReferenceStar> references;
+    for (auto const &star : catalog)
+        if (star.mag < 7.5)
+            references.append(star);
+    QVERIFY(references.size() < 30);
+
+    FITSImage::Solution truth;
+    truth.ra = 40;
+    truth.dec = 30;
+    truth.orientation = 10;
+    truth.pixscale = PIXSCALE;
+    truth.parity = FITSImage::NEGATIVE;
+
+    QByteArray buffer;
+    if (!renderFrame(catalog, truth, random, buffer))
+        QSKIP("WCS is not available, skipping test.");
+    QSharedPointer<FITSData> image(new FITSData());
+    QVERIFY(image->loadFromBuffer(buffer, "fits"));
+
+    IncrementalSolver solver(truth);
+    solver.setReferenceStars(references);
+    QVERIFY(!solver.solve(image));
+    QVERIFY2(solver.failure().contains("catalog stars"), qPrintable(solver.failure()));
+    QCOMPARE(solver.detectedStars(), 0);
+
+    // Nothing is started, the caller runs the full solver at once
+    QSignalSpy done(&solver, &IncrementalSolver::done);
+    QVERIFY(!solver.start(image));
+    QVERIFY(!done.wait(500));
+}
+
+QTEST_GUILESS_MAIN(TestIncrementalSolver)
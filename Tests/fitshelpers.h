@@ -0,0 +1,51 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QRandomGenerator>
+#include <QString>
+#include <QVector>
+
+/** @brief The header of a FITS frame of unsigned values of @p bitpix bits, padded to a block. */
+inline QByteArray fitsHeader(int width, int height, int bitpix)
+{
+    QByteArray fits;
+    auto const card = [&fits](const QString & text)
+    {
+        fits.append(text.leftJustified(80, ' ', true).toLatin1());
+    };
+    card("SIMPLE  =                    T");
+    card(QString("BITPIX  = %1").arg(bitpix, 20));
+    card(QString("NAXIS   = %1").arg(2, 20));
+    card(QString("NAXIS1  = %1").arg(width, 20));
+    card(QString("NAXIS2  = %1").arg(height, 20));
+    if (bitpix == 16)
+    {
+        card(QString("BZERO   = %1").arg(32768, 20));
+        card(QString("BSCALE  = %1").arg(1, 20));
+    }
+    card("END");
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, ' '));
+    return fits;
+}
+
+/** @brief A 16-bit FITS frame of the pixel values of @p image, with +/-20 of uniform noise. */
+inline QByteArray fitsFrame16(const QVector<float> &image, int width, int height, QRandomGenerator &random)
+{
+    QByteArray fits = fitsHeader(width, height, 16);
+
+    // Unsigned values stored as signed big endian integers
+    for (float const value : image)
+    {
+        int const pixel = qBound(0, static_cast<int>(value + 40 * (random.generateDouble() - 0.5)), 65535) - 32768;
+        fits.append(static_cast<char>((pixel >> 8) & 0xFF));
+        fits.append(static_cast<char>(pixel & 0xFF));
+    }
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, '\0'));
+    return fits;
+}
@@ -7,12 +7,24 @@
 #include <QtTest>
 #include <memory>
 #include "testfitsdata.h"
+#include "../fitshelpers.h"
 #include "Options.h"
 #include "ekos/auxiliary/solverutils.h"
 #include "ekos/auxiliary/stellarsolverprofile.h"
+#include "fitsviewer/framebufferpool.h"
+#include "fitsviewer/previewcache.h"
+#include "skyobjects/skypoint.h"
+#include <QBuffer>
+#include <QImage>
 #include <QtGlobal>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
 Q_DECLARE_METATYPE(FITSMode);
+Q_DECLARE_METATYPE(FITSScale);
 
 TestFitsData::TestFitsData(QObject *parent) : QObject(parent)
 {
@@ -104,7 +116,7 @@ void TestFitsData::testBahtinovFocusHFR_data()
     QTest::addColumn<int>("NSTARS");
     QTest::addColumn<double>("HFR");
 
-    QTest::newRow("BAHTINOV-1-NORMAL") << "bahtinov-focus.fits" << FITS_NORMAL << 1 << 1.544;
+    QTest::newRow("BAHTINOV-1-NORMAL") << "bahtinov-focus.fits" << FITS_NORMAL << 1 << 2.033;
 #endif
 }
 
@@ -173,7 +185,7 @@ void TestFitsData::initGenericDataFixture()
             << FITS_NORMAL
             << 80       // Stars found with the Centroid detection
             << 104      // Stars found with the StellarSolver detection - default profile limits count
-            << 1.49     // HFR found with the Centroid detection
+            << 1.54     // HFR found with the Centroid detection
             << 1.482291 // HFR found with the Gradient detection
             << 0.0      // HFR found with the Threshold detection - not used
             << 1.482291 // HFR found with the StellarSolver detection
@@ -246,13 +258,13 @@ void TestFitsData::testLoadFits()
     QCOMPARE(fd->getStarCenters().count(), 0);
     QCOMPARE(fd->getHFR(), -1.0);
 
-    // Default algorithm is centroid, 80 stars with 1.495 as HFR
+    // Default algorithm is centroid, 80 stars with 1.54 as HFR
     fd->findStars().waitForFinished();
     QCOMPARE(fd->getDetectedStars(), NSTARS_CENTROID);
     QCOMPARE(fd->getStarCenters().count(), NSTARS_CENTROID);
     QVERIFY(abs(fd->getHFR() - HFR_CENTROID) < 0.01);
 
-    // With the centroid algorithm, 80 stars with MEAN HFR 1.495
+    // With the centroid algorithm, 80 stars with MEAN HFR 1.54
     fd->findStars(ALGORITHM_CENTROID).waitForFinished();
     QCOMPARE(fd->getDetectedStars(), NSTARS_CENTROID);
     QCOMPARE(fd->getStarCenters().count(), NSTARS_CENTROID);
@@ -287,6 +299,264 @@ void TestFitsData::testLoadFits()
 #endif
 }
 
+namespace
+{
+// Star centers found by merging the colliding edges, the centroid detector used before the components were labelled.
+// It is kept here as the reference of the positions.
+template <typename T>
+QVector<QPointF> mergedEdgeCenters(FITSData const &data, FITSMode mode)
+{
+    int const MINIMUM_STDVAR = 5, MINIMUM_ROWS_PER_CENTER = 3, LOW_EDGE_CUTOFF_1 = 50, LOW_EDGE_CUTOFF_2 = 10;
+    int const MAX_EDGE_LIMIT = 10000;
+    double const DIFFUSE_THRESHOLD = 0.15;
+
+    FITSImage::Statistic const &stats = data.getStatistics();
+    auto const * buffer = reinterpret_cast<T const *>(data.getImageBuffer());
+    double const JMIndex = data.getJMIndex();
+
+    // Only the central 70% of guide and focus frames
+    int subX = 0, subY = 0, subW = stats.width, subH = stats.height;
+    if (mode == FITS_GUIDE || mode == FITS_FOCUS)
+    {
+        subX = round(stats.width * 0.15);
+        subY = round(stats.height * 0.15);
+        subW = stats.width - subX;
+        subH = stats.height - subY;
+    }
+
+    int minEdgeWidth = JMIndex < DIFFUSE_THRESHOLD ? JMIndex * 35 + 1 : 6;
+    int minimumEdgeCount = JMIndex < DIFFUSE_THRESHOLD ? minEdgeWidth - 1 : 4;
+    int initStdDev = MINIMUM_STDVAR;
+    double min = 0;
+    QVector<Edge> edges;
+
+    while (initStdDev >= 1)
+    {
+        minEdgeWidth = qMax(3, minEdgeWidth - 1);
+        minimumEdgeCount = qMax(3, minimumEdgeCount - 1);
+
+        double threshold = 0;
+        float dispersionRatio = 1.5;
+        if (JMIndex < DIFFUSE_THRESHOLD)
+        {
+            threshold = stats.max[0] - stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
+            min = stats.min[0];
+            if (threshold - min < 0)
+            {
+                threshold = stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
+                min = 0;
+            }
+            dispersionRatio = 1.4 - (MINIMUM_STDVAR - initStdDev) * 0.08;
+        }
+        else
+        {
+            threshold = stats.mean[0] + stats.stddev[0] * initStdDev * (0.3 - (MINIMUM_STDVAR - initStdDev) * 0.05);
+            min = stats.min[0];
+            dispersionRatio = 1.8 - (MINIMUM_STDVAR - initStdDev) * 0.2;
+        }
+        threshold -= min;
+
+        // Runs above threshold whose center is brighter than their ends by the dispersion ratio
+        edges.clear();
+        for (int i = subY; i < subH; i++)
+        {
+            double avg = 0, sum = 0;
+            int diameter = 0;
+            for (int j = subX; j < subW; j++)
+            {
+                int const pixVal = buffer[j + i * stats.width] - min;
+                if (pixVal >= threshold)
+                {
+                    avg += j * pixVal;
+                    sum += pixVal;
+                    diameter++;
+                    continue;
+                }
+                if (sum > 0 && diameter >= minEdgeWidth && avg / sum + 0.5 > 0)
+                {
+                    float const center = avg / sum + 0.5;
+                    T const * row = buffer + i * stats.width;
+                    int const c = std::floor(center);
+                    if ((row[c] - min) / (row[c - diameter / 2] - min) >= dispersionRatio &&
+                            (row[c] - min) / (row[c + diameter / 2] - min) >= dispersionRatio)
+                    {
+                        Edge edge;
+                        edge.x = center;
+                        edge.y = i + 0.5;
+                        edge.scanned = 0;
+                        edge.val = row[c] - min;
+                        edge.width = diameter;
+                        edge.sum = sum;
+                        edges.append(edge);
+                    }
+                }
+                avg = sum = diameter = 0;
+            }
+        }
+
+        // In case of hot pixels
+        if (edges.count() == 1 && initStdDev > 1)
+        {
+            initStdDev--;
+            continue;
+        }
+        if (edges.count() >= MAX_EDGE_LIMIT)
+            return QVector<QPointF>();
+        if (edges.count() >= minimumEdgeCount)
+            break;
+
+        edges.clear();
+        initStdDev--;
+    }
+
+    // Merge the edges colliding with the widest ones
+    std::sort(edges.begin(), edges.end(), [](Edge const & a, Edge const & b)
+    {
+        return a.sum > b.sum;
+    });
+
+    int centerLimit = MINIMUM_ROWS_PER_CENTER - (MINIMUM_STDVAR - initStdDev);
+    if (edges.count() < LOW_EDGE_CUTOFF_1)
+        centerLimit = edges.count() < LOW_EDGE_CUTOFF_2 ? 1 : 2;
+    if (centerLimit < 1)
+        return QVector<QPointF>();
+
+    QVector<QPointF> centers;
+    QVector<int> widths;
+    for (Edge &edge : edges)
+    {
+        if (edge.scanned)
+            continue;
+
+        double sumX = 0, sumY = 0, sum = 0;
+        double largest = edge.sum;
+        int width = edge.width, count = 0;
+        for (Edge &other : edges)
+        {
+            if (other.scanned)
+                continue;
+
+            int distance = std::abs(sqrt((other.x - edge.x) * (other.x - edge.x) + (other.y - edge.y) * (other.y - edge.y)));
+            distance -= other.width / 2 + edge.width / 2;
+            if (distance > 0)
+                continue;
+
+            if (other.sum >= largest)
+            {
+                largest = other.sum;
+                width = other.width;
+            }
+            other.scanned = 1;
+            count++;
+            sumX += other.x * other.val;
+            sumY += other.y * other.val;
+            sum += other.val;
+        }
+
+        QPointF const center(sumX / sum, sumY / sum);
+        if (count < centerLimit || center.x() < 0 || center.x() > stats.width + 1 || center.y() < 0 ||
+                center.y() > stats.height + 1)
+            continue;
+        centers.append(center);
+        widths.append(width);
+    }
+
+    // Reject the sources wider than four times the root mean square width, except when focusing
+    if (centers.count() > 1 && mode != FITS_FOCUS)
+    {
+        double squares = 0;
+        for (int const width : widths)
+            squares += width * width;
+        double const limit = std::sqrt(squares / (centers.count() - 1)) * 4;
+        for (int i = centers.count() - 1; i >= 0; i--)
+            if (widths[i] > limit)
+                centers.remove(i);
+    }
+
+    return centers;
+}
+
+QVector<QPointF> mergedEdgeCenters(FITSData const &data, FITSMode mode)
+{
+    switch (data.getStatistics().dataType)
+    {
+        case TBYTE:
+            return mergedEdgeCenters<uint8_t>(data, mode);
+        case TSHORT:
+            return mergedEdgeCenters<int16_t>(data, mode);
+        case TUSHORT:
+            return mergedEdgeCenters<uint16_t>(data, mode);
+        case TLONG:
+            return mergedEdgeCenters<int32_t>(data, mode);
+        case TULONG:
+            return mergedEdgeCenters<uint32_t>(data, mode);
+        case TFLOAT:
+            return mergedEdgeCenters<float>(data, mode);
+        case TLONGLONG:
+            return mergedEdgeCenters<int64_t>(data, mode);
+        default:
+            return mergedEdgeCenters<double>(data, mode);
+    }
+}
+}
+
+void TestFitsData::testCentroidLabelling_data()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QTest::addColumn<QString>("NAME");
+    QTest::addColumn<FITSMode>("MODE");
+
+    QTest::newRow("M47-1-NORMAL") << "m47_sim_stars.fits" << FITS_NORMAL;
+    QTest::newRow("M47-1-FOCUS") << "m47_sim_stars.fits" << FITS_FOCUS;
+    QTest::newRow("NGC4535-1-NORMAL") << "ngc4535-autofocus1.fits" << FITS_NORMAL;
+    QTest::newRow("NGC4535-1-FOCUS") << "ngc4535-autofocus1.fits" << FITS_FOCUS;
+    QTest::newRow("NGC4535-2-NORMAL") << "ngc4535-autofocus2.fits" << FITS_NORMAL;
+    QTest::newRow("NGC4535-2-FOCUS") << "ngc4535-autofocus2.fits" << FITS_FOCUS;
+#endif
+}
+
+void TestFitsData::testCentroidLabelling()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(FITSMode, MODE);
+
+    if(!QFile::exists(NAME))
+        QSKIP("Skipping load test because of missing fixture");
+
+    std::unique_ptr<FITSData> fd(new FITSData(MODE));
+    QVERIFY(fd != nullptr);
+
+    QFuture<bool> worker = fd->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    // Stars found by labelling the components
+    worker = fd->findStars(ALGORITHM_CENTROID);
+    worker.waitForFinished();
+    QVERIFY(worker.result());
+    QList<Edge*> const labelled = fd->getStarCenters();
+
+    // Stars found by merging the colliding edges, with the contrast index of the histogram built for the detection
+    QVector<QPointF> const merged = mergedEdgeCenters(*fd, MODE);
+    QVERIFY(!merged.isEmpty());
+
+    // Each former star is found again, a faint star next to a bright one may be found separately
+    for (QPointF const &star : merged)
+    {
+        bool found = false;
+        for (Edge const * center : labelled)
+            found = found || std::hypot(center->x - star.x(), center->y - star.y()) <= 1.5;
+        QVERIFY2(found, qPrintable(QString("No star at %1,%2").arg(star.x()).arg(star.y())));
+    }
+    QVERIFY(labelled.count() - merged.count() <= qMax(1, merged.count() / 4));
+#endif
+}
+
 void TestFitsData::testCentroidAlgorithmBenchmark_data()
 {
 #if QT_VERSION < 0x050900
@@ -317,6 +587,996 @@ void TestFitsData::testCentroidAlgorithmBenchmark()
 #endif
 }
 
+namespace
+{
+// A 16-bit FITS frame of Gaussian stars of random position and brightness over a noisy sky
+QByteArray syntheticStarField(int width, int height, int stars, double sigma = 1.5)
+{
+    QRandomGenerator random(stars);
+    QVector<float> image(width * height, 1000.0f);
+    int const radius = std::ceil(4 * sigma), margin = radius + 2;
+    for (int s = 0; s < stars; s++)
+    {
+        double const x0 = margin + random.bounded(width - 2.0 * margin);
+        double const y0 = margin + random.bounded(height - 2.0 * margin);
+        double const peak = 2000 + random.bounded(18000.0);
+        for (int y = static_cast<int>(y0) - radius; y <= static_cast<int>(y0) + radius; y++)
+            for (int x = static_cast<int>(x0) - radius; x <= static_cast<int>(x0) + radius; x++)
+                image[x + y * width] += peak * std::exp(-((x - x0) * (x - x0) + (y - y0) * (y - y0)) / (2 * sigma * sigma));
+    }
+
+    return fitsFrame16(image, width, height, random);
+}
+}
+
+void TestFitsData::testCentroidHFR_data()
+{
+    QTest::addColumn<double>("SIGMA");
+
+    QTest::newRow("sigma 1.0") << 1.0;
+    QTest::newRow("sigma 1.5") << 1.5;
+    QTest::newRow("sigma 2.5") << 2.5;
+}
+
+void TestFitsData::testCentroidHFR()
+{
+    QFETCH(double, SIGMA);
+
+    QByteArray const buffer = syntheticStarField(1024, 1024, 50, SIGMA);
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    QVERIFY(d->loadFromBuffer(buffer, "fits"));
+
+    QFuture<bool> worker = d->findStars(ALGORITHM_CENTROID);
+    worker.waitForFinished();
+    QVERIFY(worker.result());
+    QVERIFY(d->getDetectedStars() >= 40);
+
+    QVector<double> hfrs;
+    for (Edge const * center : d->getStarCenters())
+        hfrs.append(center->HFR);
+    std::sort(hfrs.begin(), hfrs.end());
+    double const hfr = hfrs[hfrs.count() / 2];
+
+    // The half flux radius of a Gaussian star, the wings below the threshold are a few percent of its variance
+    double const expected = SIGMA * std::sqrt(2 * std::log(2.0));
+    QVERIFY2(std::fabs(hfr - expected) <= expected * 0.1,
+             qPrintable(QString("HFR %1 instead of %2").arg(hfr).arg(expected)));
+}
+
+void TestFitsData::testCentroidStarFieldBenchmark_data()
+{
+    QTest::addColumn<int>("STARS");
+
+    QTest::newRow("100 stars") << 100;
+    QTest::newRow("1000 stars") << 1000;
+    QTest::newRow("5000 stars") << 5000;
+    QTest::newRow("20000 stars") << 20000;
+}
+
+void TestFitsData::testCentroidStarFieldBenchmark()
+{
+    QFETCH(int, STARS);
+
+    QByteArray const buffer = syntheticStarField(4096, 4096, STARS);
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    QVERIFY(d->loadFromBuffer(buffer, "fits"));
+
+    QBENCHMARK { d->findStars(ALGORITHM_CENTROID).waitForFinished(); }
+    QVERIFY(d->getDetectedStars() > 0);
+}
+
+namespace
+{
+// An 8-bit FITS frame of the pattern of a Bahtinov mask centered on the frame. The two outer spikes go through the
+// star at ANGLE +/- 20 degrees, the middle spike at ANGLE is moved aside by DISTANCE pixels.
+QByteArray syntheticBahtinovPattern(int width, int height, double angle, double distance)
+{
+    QVector<float> image(width * height, 10.0f);
+    double const cx = width / 2.0, cy = height / 2.0;
+    auto const spike = [&](double spikeAngle, double offset, double peak)
+    {
+        double const ux = std::cos(spikeAngle * M_PI / 180), uy = std::sin(spikeAngle * M_PI / 180);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+            {
+                double const along = (x - cx) * ux + (y - cy) * uy;
+                double const across = (y - cy) * ux - (x - cx) * uy - offset;
+                image[x + y * width] += peak * std::exp(-across * across / (2 * 0.8 * 0.8) - std::fabs(along) / 40);
+            }
+    };
+    spike(angle, distance, 120);
+    spike(angle - 20, 0, 100);
+    spike(angle + 20, 0, 100);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            image[x + y * width] += 200 * std::exp(-((x - cx) * (x - cx) + (y - cy) * (y - cy)) / (2 * 2.0 * 2.0));
+
+    QRandomGenerator random(1);
+    QByteArray fits = fitsHeader(width, height, 8);
+    for (float const value : image)
+        fits.append(static_cast<char>(qBound(0, static_cast<int>(value + 8 * (random.generateDouble() - 0.5)), 255)));
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, '\0'));
+    return fits;
+}
+}
+
+void TestFitsData::testBahtinovSynthetic_data()
+{
+    QTest::addColumn<double>("ANGLE");
+    QTest::addColumn<double>("DISTANCE");
+
+    QTest::newRow("30 degrees, in focus") << 30.0 << 0.0;
+    QTest::newRow("45 degrees, 1 pixel") << 45.0 << 1.0;
+    QTest::newRow("60 degrees, 2.5 pixels") << 60.0 << 2.5;
+    QTest::newRow("90 degrees, 4 pixels") << 90.0 << 4.0;
+    QTest::newRow("120 degrees, 1.5 pixels") << 120.0 << 1.5;
+    QTest::newRow("135 degrees, 3 pixels") << 135.0 << 3.0;
+    QTest::newRow("150 degrees, 0.5 pixel") << 150.0 << 0.5;
+}
+
+void TestFitsData::testBahtinovSynthetic()
+{
+    QFETCH(double, ANGLE);
+    QFETCH(double, DISTANCE);
+
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    QVERIFY(d->loadFromBuffer(syntheticBahtinovPattern(128, 128, ANGLE, DISTANCE), "fits"));
+
+    d->findStars(ALGORITHM_BAHTINOV, QRect(0, 0, 128, 128)).waitForFinished();
+    QCOMPARE(d->getStarCenters().count(), 1);
+    QVERIFY2(abs(d->getHFR() - DISTANCE) < 0.2, qPrintable(QString("Distance %1").arg(d->getHFR())));
+}
+
+void TestFitsData::testBahtinovAlgorithmBenchmark_data()
+{
+    QTest::addColumn<int>("SIZE");
+
+    QTest::newRow("128 pixels") << 128;
+    QTest::newRow("256 pixels") << 256;
+    QTest::newRow("512 pixels") << 512;
+}
+
+void TestFitsData::testBahtinovAlgorithmBenchmark()
+{
+    QFETCH(int, SIZE);
+
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    QVERIFY(d->loadFromBuffer(syntheticBahtinovPattern(SIZE, SIZE, 60, 2), "fits"));
+
+    QBENCHMARK { d->findStars(ALGORITHM_BAHTINOV, QRect(0, 0, SIZE, SIZE)).waitForFinished(); }
+    QCOMPARE(d->getStarCenters().count(), 1);
+}
+
+void TestFitsData::testTrackingBoxFrame_data()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QTest::addColumn<QString>("NAME");
+    QTest::addColumn<FITSMode>("MODE");
+    QTest::addColumn<int>("ALGORITHM");
+    QTest::addColumn<QRect>("TRACKING_BOX");
+
+    QRect const star(591 - 64 / 2, 482 - 64 / 2, 64, 64);
+    QTest::newRow("FOCUS-GRADIENT") << "m47_sim_stars.fits" << FITS_FOCUS << static_cast<int>(ALGORITHM_GRADIENT) << star;
+    QTest::newRow("FOCUS-CENTROID") << "m47_sim_stars.fits" << FITS_FOCUS << static_cast<int>(ALGORITHM_CENTROID) << star;
+    QTest::newRow("FOCUS-BAHTINOV") << "bahtinov-focus.fits" << FITS_FOCUS << static_cast<int>(ALGORITHM_BAHTINOV)
+                                    << QRect(204, 240, 128, 128);
+    QTest::newRow("GUIDE-CENTROID") << "m47_sim_stars.fits" << FITS_GUIDE << static_cast<int>(ALGORITHM_CENTROID) << star;
+#endif
+}
+
+void TestFitsData::testTrackingBoxFrame()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(FITSMode, MODE);
+    QFETCH(int, ALGORITHM);
+    QFETCH(QRect, TRACKING_BOX);
+
+    if(!QFile::exists(NAME))
+        QSKIP("Skipping load test because of missing fixture");
+
+    std::unique_ptr<FITSData> d(new FITSData(MODE));
+    QVERIFY(d != nullptr);
+
+    QFuture<bool> worker = d->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    // A frame finds the star in the tracking box, and calculates the statistics of the box as the viewer does
+    auto const frame = [&]()
+    {
+        d->findStars(static_cast<StarAlgorithm>(ALGORITHM), TRACKING_BOX).waitForFinished();
+        d->calculateRoiStats(TRACKING_BOX.translated(1, 1));
+    };
+
+    // The first frame sizes the buffers of the detector and of the statistics
+    frame();
+    int const stars = d->getStarCenters().count();
+    QVERIFY(stars > 0);
+    double const hfr = d->getHFR();
+    double const median = d->getMedian(0, true);
+    QCOMPARE(static_cast<int>(d->width(true)), TRACKING_BOX.width());
+    QCOMPARE(static_cast<int>(d->height(true)), TRACKING_BOX.height());
+    QVERIFY(d->getMin(0, true) <= median && median <= d->getMax(0, true));
+
+    // The buffers kept by the detector and by the statistics of the box
+    auto const reusedBuffers = [&]()
+    {
+        QVector<QPair<void const *, size_t>> buffers = d->m_StarDetector->reusedBuffers();
+        buffers.append(qMakePair<void const *, size_t>(d->m_ROISamples.data(), d->m_ROISamples.capacity()));
+        return buffers;
+    };
+    QVector<QPair<void const *, size_t>> const buffers = reusedBuffers();
+    QVERIFY(!buffers.isEmpty());
+
+    // The next frames read the tracking box in place, reusing the buffers of the first one
+    for (int i = 0; i < 10; i++)
+    {
+        frame();
+        QCOMPARE(reusedBuffers(), buffers);
+    }
+
+    QCOMPARE(d->getStarCenters().count(), stars);
+    QCOMPARE(d->getHFR(), hfr);
+    QCOMPARE(d->getMedian(0, true), median);
+#endif
+}
+
+void TestFitsData::testTrackingBoxFrameBenchmark_data()
+{
+    testTrackingBoxFrame_data();
+}
+
+void TestFitsData::testTrackingBoxFrameBenchmark()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(FITSMode, MODE);
+    QFETCH(int, ALGORITHM);
+    QFETCH(QRect, TRACKING_BOX);
+
+    if(!QFile::exists(NAME))
+        QSKIP("Skipping load test because of missing fixture");
+
+    std::unique_ptr<FITSData> d(new FITSData(MODE));
+    QVERIFY(d != nullptr);
+
+    QFuture<bool> worker = d->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    QBENCHMARK
+    {
+        d->findStars(static_cast<StarAlgorithm>(ALGORITHM), TRACKING_BOX).waitForFinished();
+        d->calculateRoiStats(TRACKING_BOX.translated(1, 1));
+    }
+    QVERIFY(d->getStarCenters().count() > 0);
+#endif
+}
+
+namespace
+{
+// A FITS frame of the given BITPIX whose pixels are numbered line after line, wrapping at 251 for 8-bit frames
+QByteArray numberedFrame(int width, int height, int bitpix)
+{
+    QByteArray fits = fitsHeader(width, height, bitpix);
+    QDataStream stream(&fits, QIODevice::WriteOnly | QIODevice::Append);
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.setFloatingPointPrecision(bitpix == -64 ? QDataStream::DoublePrecision : QDataStream::SinglePrecision);
+    for (int i = 0; i < width * height; i++)
+    {
+        switch (bitpix)
+        {
+            case 8:
+                stream << static_cast<quint8>(i % 251);
+                break;
+            case 16:
+                // Unsigned values stored as signed integers
+                stream << static_cast<qint16>(i % 65536 - 32768);
+                break;
+            case -32:
+                stream << static_cast<float>(i) / 3;
+                break;
+            default:
+                stream << static_cast<double>(i) / 3;
+                break;
+        }
+    }
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, '\0'));
+    return fits;
+}
+}
+
+void TestFitsData::testRotateFlip_data()
+{
+    QTest::addColumn<int>("BITPIX");
+    QTest::addColumn<int>("WIDTH");
+    QTest::addColumn<int>("HEIGHT");
+
+    for (int const bitpix : {8, 16, -32, -64})
+    {
+        // Sizes that are not multiples of the tiles, and a frame thinner than a tile
+        QTest::newRow(qPrintable(QString("BITPIX %1, 67x131").arg(bitpix))) << bitpix << 67 << 131;
+        QTest::newRow(qPrintable(QString("BITPIX %1, 130x3").arg(bitpix))) << bitpix << 130 << 3;
+    }
+}
+
+void TestFitsData::testRotateFlip()
+{
+    QFETCH(int, BITPIX);
+    QFETCH(int, WIDTH);
+    QFETCH(int, HEIGHT);
+
+    // The eight orientations, the position each pixel moves to and the resulting frame width
+    struct Orientation
+    {
+        char const * name;
+        QVector<FITSScale> filters;
+        std::function<QPoint(int x, int y)> target;
+        int width;
+    };
+    int const nx = WIDTH, ny = HEIGHT;
+    QVector<Orientation> const orientations =
+    {
+        {"identity", {FITS_FLIP_H, FITS_FLIP_H}, [](int x, int y) { return QPoint(x, y); }, nx},
+        {"flip H", {FITS_FLIP_H}, [nx](int x, int y) { return QPoint(nx - x - 1, y); }, nx},
+        {"flip V", {FITS_FLIP_V}, [ny](int x, int y) { return QPoint(x, ny - y - 1); }, nx},
+        {"rotate 180", {FITS_ROTATE_CW, FITS_ROTATE_CW}, [nx, ny](int x, int y) { return QPoint(nx - x - 1, ny - y - 1); }, nx},
+        {"rotate CW", {FITS_ROTATE_CW}, [ny](int x, int y) { return QPoint(ny - y - 1, x); }, ny},
+        {"rotate CCW", {FITS_ROTATE_CCW}, [nx](int x, int y) { return QPoint(y, nx - x - 1); }, ny},
+        {"transpose", {FITS_ROTATE_CW, FITS_FLIP_H}, [](int x, int y) { return QPoint(y, x); }, ny},
+        {"anti-transpose", {FITS_ROTATE_CW, FITS_FLIP_V}, [nx, ny](int x, int y) { return QPoint(ny - y - 1, nx - x - 1); }, ny},
+    };
+
+    QByteArray const buffer = numberedFrame(WIDTH, HEIGHT, BITPIX);
+    for (Orientation const &orientation : orientations)
+    {
+        std::unique_ptr<FITSData> d(new FITSData());
+        QVERIFY(d != nullptr);
+        QVERIFY(d->loadFromBuffer(buffer, "fits"));
+
+        int const bpp = d->getStatistics().bytesPerPixel;
+        QByteArray const original(reinterpret_cast<char const *>(d->getImageBuffer()), WIDTH * HEIGHT * bpp);
+
+        for (FITSScale const filter : orientation.filters)
+            d->applyFilter(filter);
+
+        QCOMPARE(d->getStatistics().width, orientation.width);
+        QCOMPARE(d->getStatistics().height, WIDTH * HEIGHT / orientation.width);
+
+        // Bytes of each pixel where the former implementation moved them
+        QByteArray expected(original.size(), '\0');
+        for (int y = 0; y < HEIGHT; y++)
+            for (int x = 0; x < WIDTH; x++)
+            {
+                QPoint const target = orientation.target(x, y);
+                int const index = target.y() * orientation.width + target.x();
+                memcpy(expected.data() + index * bpp, original.constData() + (y * WIDTH + x) * bpp, bpp);
+            }
+        QVERIFY2(memcmp(d->getImageBuffer(), expected.constData(), expected.size()) == 0, orientation.name);
+    }
+}
+
+void TestFitsData::testRotateFlipBenchmark_data()
+{
+    QTest::addColumn<FITSScale>("FILTER");
+
+    QTest::newRow("rotate CW") << FITS_ROTATE_CW;
+    QTest::newRow("rotate CCW") << FITS_ROTATE_CCW;
+    QTest::newRow("flip H") << FITS_FLIP_H;
+    QTest::newRow("flip V") << FITS_FLIP_V;
+}
+
+void TestFitsData::testRotateFlipBenchmark()
+{
+    QFETCH(FITSScale, FILTER);
+
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    QVERIFY(d->loadFromBuffer(numberedFrame(4096, 3072, 16), "fits"));
+
+    QBENCHMARK { d->applyFilter(FILTER); }
+}
+
+namespace
+{
+// Write a FITS frame to disk, tile compressed in tiles of tileHeight lines unless compression is 0
+bool writeFrame(const QByteArray &frame, int width, const QString &filename, int compression, int tileHeight)
+{
+    if (compression == 0)
+    {
+        QFile file(filename);
+        return file.open(QIODevice::WriteOnly) && file.write(frame) == frame.size();
+    }
+
+    QByteArray copy(frame);
+    void *data = copy.data();
+    size_t size = copy.size();
+    long tile[2] = { width, tileHeight };
+    int status = 0;
+    fitsfile *source = nullptr, *target = nullptr;
+    fits_open_memfile(&source, "frame", READONLY, &data, &size, 0, nullptr, &status);
+    fits_create_file(&target, QString("!%1").arg(filename).toLocal8Bit(), &status);
+    fits_set_compression_type(target, compression, &status);
+    fits_set_tile_dim(target, 2, tile, &status);
+    fits_img_compress(source, target, &status);
+
+    int closeStatus = 0;
+    if (target != nullptr)
+        fits_close_file(target, &closeStatus);
+    if (source != nullptr)
+        fits_close_file(source, &closeStatus);
+    return status == 0;
+}
+}
+
+void TestFitsData::testLoadRegion_data()
+{
+    QTest::addColumn<int>("COMPRESSION");
+    QTest::addColumn<QRect>("REGION");
+    QTest::addColumn<int>("MAXIMUM_SIZE");
+
+    QVector<QPair<QString, int>> const compressions = {{"uncompressed", 0}, {"Rice", RICE_1}, {"GZIP", GZIP_1}};
+    for (auto const &compression : compressions)
+    {
+        QTest::newRow(qPrintable(compression.first + ", whole frame")) << compression.second << QRect() << 0;
+        // Starting on odd pixels, which are moved to even ones
+        QTest::newRow(qPrintable(compression.first + ", region")) << compression.second << QRect(37, 101, 301, 203) << 0;
+        QTest::newRow(qPrintable(compression.first + ", preview")) << compression.second << QRect() << 256;
+        QTest::newRow(qPrintable(compression.first + ", region preview")) << compression.second << QRect(100, 50, 600, 400) << 100;
+        // Larger than the frame
+        QTest::newRow(qPrintable(compression.first + ", clipped region")) << compression.second << QRect(900, 700, 400, 400) << 0;
+    }
+}
+
+void TestFitsData::testLoadRegion()
+{
+    QFETCH(int, COMPRESSION);
+    QFETCH(QRect, REGION);
+    QFETCH(int, MAXIMUM_SIZE);
+
+    // Neither dimension a multiple of the bands or of the tiles
+    int const width = 1021, height = 767;
+    QTemporaryDir folder;
+    QVERIFY(folder.isValid());
+    QString const filename = folder.filePath(COMPRESSION ? "frame.fits.fz" : "frame.fits");
+    QVERIFY(writeFrame(numberedFrame(width, height, 16), width, filename, COMPRESSION, 16));
+
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d != nullptr);
+    d->setReadRegion(REGION, MAXIMUM_SIZE);
+    QVERIFY(d->loadFromFile(filename).result());
+    QCOMPARE(d->isCompressed(), COMPRESSION != 0);
+
+    // The header still describes the whole frame
+    QVariant value;
+    QVERIFY(d->getRecordValue("NAXIS1", value));
+    QCOMPARE(value.toInt(), width);
+    QVERIFY(d->getRecordValue("NAXIS2", value));
+    QCOMPARE(value.toInt(), height);
+
+    QRect area(0, 0, width, height);
+    if (!REGION.isNull())
+        area = QRect(QPoint(REGION.left() & ~1, REGION.top() & ~1), REGION.bottomRight()).intersected(area);
+    int sampling = 1;
+    if (MAXIMUM_SIZE > 0)
+        sampling = ((std::max(area.width(), area.height()) + MAXIMUM_SIZE - 1) / MAXIMUM_SIZE) | 1;
+    int const columns = (area.width() + sampling - 1) / sampling;
+    int const lines = (area.height() + sampling - 1) / sampling;
+    QCOMPARE(static_cast<int>(d->width()), columns);
+    QCOMPARE(static_cast<int>(d->height()), lines);
+
+    uint16_t const * const pixels = reinterpret_cast<uint16_t const *>(d->getImageBuffer());
+    int mismatches = 0;
+    for (int y = 0; y < lines; y++)
+        for (int x = 0; x < columns; x++)
+        {
+            int const index = (area.top() + y * sampling) * width + area.left() + x * sampling;
+            if (pixels[y * columns + x] != index % 65536)
+                mismatches++;
+        }
+    QCOMPARE(mismatches, 0);
+}
+
+void TestFitsData::testLoadBenchmark_data()
+{
+    QTest::addColumn<int>("COMPRESSION");
+    QTest::addColumn<int>("THREADS");
+
+    QVector<QPair<QString, int>> const compressions = {{"uncompressed", 0}, {"Rice", RICE_1}, {"GZIP", GZIP_1}};
+    for (auto const &compression : compressions)
+        for (int const threads : {1, QThread::idealThreadCount()})
+            QTest::newRow(qPrintable(QString("%1, %2 threads").arg(compression.first).arg(threads)))
+                    << compression.second << threads;
+}
+
+// Loads a 16-bit frame from disk, sequentially and across threads
+void TestFitsData::testLoadBenchmark()
+{
+    QFETCH(int, COMPRESSION);
+    QFETCH(int, THREADS);
+
+    int const width = 4096, height = 3072;
+    QTemporaryDir folder;
+    QVERIFY(folder.isValid());
+    QString const filename = folder.filePath(COMPRESSION ? "frame.fits.fz" : "frame.fits");
+    QVERIFY(writeFrame(numberedFrame(width, height, 16), width, filename, COMPRESSION, 16));
+    qInfo() << QString("%1 bytes on disk").arg(QFileInfo(filename).size());
+
+    QThreadPool * const pool = QThreadPool::globalInstance();
+    int const threads = pool->maxThreadCount();
+    pool->setMaxThreadCount(THREADS);
+
+    bool loaded = true;
+    QBENCHMARK
+    {
+        std::unique_ptr<FITSData> d(new FITSData());
+        loaded = loaded && d->loadFromFile(filename).result();
+    }
+
+    pool->setMaxThreadCount(threads);
+    QVERIFY(loaded);
+}
+
+void TestFitsData::testFrameBufferPool()
+{
+    FrameBufferPool * const pool = FrameBufferPool::Instance();
+    size_t const budget = pool->budget();
+
+    // Buckets are a quarter of a power of two apart, small sizes are not rounded
+    QCOMPARE(FrameBufferPool::bucketSize(1000), static_cast<size_t>(1000));
+    QCOMPARE(FrameBufferPool::bucketSize(FrameBufferPool::MINIMUM_SIZE), FrameBufferPool::MINIMUM_SIZE);
+    QCOMPARE(FrameBufferPool::bucketSize(4096 * 3072 * 2), static_cast<size_t>(4096 * 3072 * 2));
+    QCOMPARE(FrameBufferPool::bucketSize(4000 * 3000 * 2), static_cast<size_t>(4096 * 3072 * 2));
+    QCOMPARE(FrameBufferPool::bucketSize(4096 * 3072 * 2 + 1), static_cast<size_t>(4096 * 3584 * 2));
+
+    pool->trim();
+    pool->resetStatistics();
+    FrameBufferPool::Statistics const initial = pool->statistics();
+
+    // A buffer released is handed out again for a request of a similar size
+    uint8_t *buffer = pool->acquire(1024 * 1024);
+    pool->release(buffer);
+    QCOMPARE(pool->acquire(1000 * 1000), buffer);
+    pool->release(buffer);
+
+    FrameBufferPool::Statistics statistics = pool->statistics();
+    QCOMPARE(statistics.requests, 2ULL);
+    QCOMPARE(statistics.hits, 1ULL);
+    QCOMPARE(statistics.used, initial.used);
+    QCOMPARE(statistics.idle, static_cast<size_t>(1024 * 1024));
+
+    // The budget limits the idle buffers, those in use do not count against it
+    pool->setBudget(3 * 1024 * 1024);
+    FrameBuffer first(2 * 1024 * 1024), second(1024 * 1024);
+    QCOMPARE(pool->statistics().hits, 2ULL);
+    FrameBuffer third(2 * 1024 * 1024 + 1);
+    first.release();
+    second.release();
+    statistics = pool->statistics();
+    QCOMPARE(statistics.evictions, 0ULL);
+    QCOMPARE(statistics.idle, static_cast<size_t>(3 * 1024 * 1024));
+
+    // The pool stays within its budget by freeing the buffers released the longest ago
+    pool->setBudget(2 * 1024 * 1024);
+    statistics = pool->statistics();
+    QCOMPARE(statistics.evictions, 1ULL);
+    QCOMPARE(statistics.idle, static_cast<size_t>(1024 * 1024));
+
+    // A buffer larger than the budget is freed when released, keeping the other idle buffers
+    third.release();
+    statistics = pool->statistics();
+    QCOMPARE(statistics.discards, 1ULL);
+    QCOMPARE(statistics.evictions, 1ULL);
+    QCOMPARE(statistics.idle, static_cast<size_t>(1024 * 1024));
+
+    // Idle buffers are freed once unused long enough
+    pool->trimIdle(FrameBufferPool::IDLE_TIMEOUT);
+    QCOMPARE(pool->statistics().idle, static_cast<size_t>(1024 * 1024));
+    pool->trimIdle(0);
+    statistics = pool->statistics();
+    QCOMPARE(statistics.trims, 1ULL);
+    QCOMPARE(statistics.idle, static_cast<size_t>(0));
+
+    // Buffers too small for the pool, or not from it, are deleted
+    pool->release(new uint8_t[16]);
+    uint8_t *small = pool->acquire(16);
+    pool->release(small);
+    QCOMPARE(pool->statistics().requests, statistics.requests);
+
+    pool->setBudget(budget);
+}
+
+namespace
+{
+// Resident memory of the process in kB, or -1 where it cannot be read
+qint64 residentMemory()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine())
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).simplified().split(' ').first().toLongLong();
+    return -1;
+}
+}
+
+// Loads, rotates and measures thousands of frames of a few sizes, as a guide loop switching subframes does
+void TestFitsData::testFrameBufferPoolSoak()
+{
+    int const FRAMES = 3000;
+    QVector<QByteArray> const frames = { numberedFrame(1280, 960, 16), numberedFrame(1250, 950, 16), numberedFrame(640, 480, 16) };
+    FrameBufferPool * const pool = FrameBufferPool::Instance();
+
+    auto const frame = [&](int i)
+    {
+        std::unique_ptr<FITSData> d(new FITSData(FITS_GUIDE));
+        if (!d->loadFromBuffer(frames[i % frames.size()], "fits"))
+            return false;
+        d->applyFilter(FITS_ROTATE_CW);
+        d->calculateRoiStats(QRect(101, 101, 200, 200));
+        return true;
+    };
+
+    // The first frames fill the pool and the heap
+    for (int i = 0; i < 30; i++)
+        QVERIFY(frame(i));
+
+    pool->resetStatistics();
+    size_t const used = pool->statistics().used;
+    qint64 const before = residentMemory();
+    qint64 peak = before;
+    for (int i = 0; i < FRAMES; i++)
+    {
+        QVERIFY(frame(i));
+        if (i % 100 == 0)
+            peak = std::max(peak, residentMemory());
+    }
+    qint64 const after = residentMemory();
+
+    FrameBufferPool::Statistics const statistics = pool->statistics();
+    qInfo() << QString("%1 frames: %2 of %3 buffers reused, %4 evicted, %5 discarded, %6 MB in use and %7 MB held at most")
+            .arg(FRAMES).arg(statistics.hits).arg(statistics.requests).arg(statistics.evictions).arg(statistics.discards)
+            .arg(statistics.peakUsed / (1024 * 1024)).arg(statistics.peakHeld / (1024 * 1024));
+
+    // Every buffer came back, and was reused for the next frames
+    QCOMPARE(statistics.used, used);
+    QCOMPARE(statistics.hits, statistics.requests);
+    QVERIFY(statistics.peakHeld <= statistics.peakUsed + pool->budget());
+
+    if (before < 0)
+        QSKIP("Resident memory is not available on this platform");
+
+    // Memory stays flat, within the size of a few frames
+    qInfo() << QString("Resident memory %1 MB before, %2 MB after, %3 MB at most")
+            .arg(before / 1024).arg(after / 1024).arg(peak / 1024);
+    QVERIFY2(peak - before < 8 * 1024, qPrintable(QString("Resident memory grew by %1 kB").arg(peak - before)));
+}
+
+void TestFitsData::testPreviewCache()
+{
+    QTemporaryDir folder;
+    QVERIFY(folder.isValid());
+    QString const frame = folder.filePath("m47_sim_stars.fits");
+    QVERIFY(QFile::copy("m47_sim_stars.fits", frame));
+
+    QElapsedTimer timer;
+    timer.start();
+    QSharedPointer<FITSData> data(new FITSData());
+    QVERIFY(data->loadFromFile(frame).result());
+    QVERIFY(data->findStars(ALGORITHM_SEP).result());
+    qint64 const loading = timer.elapsed();
+
+    {
+        PreviewCache cache(folder.filePath("previews"));
+        QSignalSpy ready(&cache, &PreviewCache::ready);
+        PreviewCache::Entry entry;
+        QVERIFY(!cache.find(frame, entry));
+
+        // A frame just captured keeps the statistics of the capture
+        cache.add(data);
+        QVERIFY(ready.wait(10000));
+        QCOMPARE(ready.first().first().toString(), frame);
+        QVERIFY(cache.find(frame, entry));
+        QCOMPARE(entry.width, static_cast<int>(data->width()));
+        QCOMPARE(entry.height, static_cast<int>(data->height()));
+        QCOMPARE(entry.stars, data->getDetectedStars());
+        QCOMPARE(entry.hfr, data->getHFR(HFR_AVERAGE));
+        QCOMPARE(entry.median, data->getMedian());
+    }
+
+    // The preview is read back from disk
+    PreviewCache cache(folder.filePath("previews"));
+    PreviewCache::Entry entry;
+    timer.restart();
+    QVERIFY(cache.find(frame, entry));
+    QSharedPointer<FITSData> const preview = entry.toFITSData();
+    QVERIFY(!preview.isNull());
+    qint64 const previewing = timer.elapsed();
+    qInfo() << QString("Frame loaded in %1 ms, preview in %2 ms, %3 bytes").arg(loading).arg(previewing).arg(entry.image.size());
+
+    int const sampling = std::max(1, (std::max(entry.width, entry.height) + PreviewCache::PREVIEW_SIZE - 1) / PreviewCache::PREVIEW_SIZE);
+    QCOMPARE(preview->channels(), data->channels());
+    QCOMPARE(static_cast<int>(preview->width()), (entry.width + sampling - 1) / sampling);
+    QCOMPARE(static_cast<int>(preview->height()), (entry.height + sampling - 1) / sampling);
+
+    // An overwritten frame needs a new preview
+    QFile file(frame);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    QVERIFY(!cache.find(frame, entry));
+
+    // Which is built from disk, without searching for stars
+    QSignalSpy ready(&cache, &PreviewCache::ready);
+    cache.request(frame);
+    QVERIFY(ready.wait(10000));
+    QVERIFY(cache.find(frame, entry));
+    QCOMPARE(entry.stars, -1);
+    QCOMPARE(entry.median, data->getMedian());
+
+    // Grey images keep their lines when their width is not a multiple of 4
+    QImage grey(101, 7, QImage::Format_Grayscale8);
+    for (int y = 0; y < grey.height(); y++)
+        for (int x = 0; x < grey.width(); x++)
+            grey.scanLine(y)[x] = static_cast<uchar>(x + y * 20);
+    QByteArray png;
+    QBuffer buffer(&png);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(grey.save(&buffer, "PNG"));
+    FITSData image;
+    QVERIFY(image.loadFromBuffer(png, "png"));
+    QCOMPARE(image.channels(), 1);
+    QCOMPARE(static_cast<int>(image.width()), grey.width());
+    for (int y = 0; y < grey.height(); y++)
+        QCOMPARE(image.getImageBuffer()[y * grey.width() + grey.width() - 1], grey.constScanLine(y)[grey.width() - 1]);
+}
+
+namespace
+{
+// A blank 8-bit FITS frame with a WCS of the given projection, rotated and optionally distorted by SIP polynomials
+QByteArray wcsFrame(int width, int height, const QString &projection, double ra, double dec, double pixscale,
+                    double rotation, bool distorted)
+{
+    QByteArray fits;
+    auto const card = [&fits](const QString & text)
+    {
+        fits.append(text.leftJustified(80, ' ', true).toLatin1());
+    };
+    auto const value = [&card](const QString & keyword, double number)
+    {
+        card(QString("%1= %2").arg(keyword, -8).arg(number, 20, 'g', 12));
+    };
+    card("SIMPLE  =                    T");
+    card(QString("BITPIX  = %1").arg(8, 20));
+    card(QString("NAXIS   = %1").arg(2, 20));
+    card(QString("NAXIS1  = %1").arg(width, 20));
+    card(QString("NAXIS2  = %1").arg(height, 20));
+    card(QString("CTYPE1  = 'RA---%1%2'").arg(projection, distorted ? "-SIP" : ""));
+    card(QString("CTYPE2  = 'DEC--%1%2'").arg(projection, distorted ? "-SIP" : ""));
+    value("EQUINOX", 2000);
+    value("CRVAL1", ra);
+    value("CRVAL2", dec);
+    value("CRPIX1", width / 2.0);
+    value("CRPIX2", height / 2.0);
+    double const scale = pixscale / 3600, angle = rotation * M_PI / 180;
+    value("CD1_1", -scale * std::cos(angle));
+    value("CD1_2", scale * std::sin(angle));
+    value("CD2_1", scale * std::sin(angle));
+    value("CD2_2", scale * std::cos(angle));
+    if (distorted)
+    {
+        // A few pixels of distortion in the corners, including a saddle the centre of the cells would not see
+        value("A_ORDER", 2);
+        value("A_2_0", 2e-6);
+        value("A_1_1", 1e-6);
+        value("A_0_2", -1.5e-6);
+        value("B_ORDER", 2);
+        value("B_2_0", -1e-6);
+        value("B_1_1", 5e-7);
+        value("B_0_2", 2e-6);
+    }
+    card("END");
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, ' '));
+    fits.append(QByteArray(width * height, '\0'));
+    fits.append(QByteArray((2880 - fits.size() % 2880) % 2880, '\0'));
+    return fits;
+}
+
+// J2000 coordinates in degrees of random pixels, over the frame and a margin around it, and the pixels
+void randomSkyPoints(FITSData &data, int count, double margin, QVector<QPointF> &pixels, QVector<QPointF> &coords)
+{
+    QRandomGenerator random(count);
+    double const width = data.width(), height = data.height();
+    while (coords.size() < count)
+    {
+        QPointF const pixel(-margin * width + random.bounded((1 + 2 * margin) * width),
+                            -margin * height + random.bounded((1 + 2 * margin) * height));
+        SkyPoint coord;
+        if (!data.pixelToWCS(pixel, coord))
+            continue;
+        pixels.append(pixel);
+        coords.append(QPointF(coord.ra0().Degrees(), coord.dec0().Degrees()));
+    }
+}
+}
+
+void TestFitsData::testWCSGrid_data()
+{
+    QTest::addColumn<QString>("PROJECTION");
+    QTest::addColumn<double>("DEC");
+    QTest::addColumn<double>("PIXSCALE");
+    QTest::addColumn<bool>("DISTORTED");
+
+    QTest::newRow("TAN") << "TAN" << 30.0 << 1.5 << false;
+    QTest::newRow("TAN around the north pole") << "TAN" << 89.8 << 1.5 << false;
+    QTest::newRow("TAN-SIP") << "TAN" << -45.0 << 1.5 << true;
+    QTest::newRow("ZEA wide field") << "ZEA" << 60.0 << 60.0 << false;
+}
+
+/* The grid against wcslib for random positions over the frame and around it. Away from the frame, positions are
+ * converted exactly and must be those of wcsToPixel.
+ */
+void TestFitsData::testWCSGrid()
+{
+#if !defined(HAVE_WCSLIB)
+    QSKIP("WCS is not available, skipping test.");
+#else
+    QFETCH(QString, PROJECTION);
+    QFETCH(double, DEC);
+    QFETCH(double, PIXSCALE);
+    QFETCH(bool, DISTORTED);
+
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d->loadFromBuffer(wcsFrame(3000, 2000, PROJECTION, 150, DEC, PIXSCALE, 30, DISTORTED), "fits"));
+    QVERIFY2(d->hasWCS(), qPrintable(d->getLastError()));
+
+    WCSGrid const * const grid = d->wcsGrid();
+    QVERIFY(grid != nullptr);
+    qInfo() << QString("Nodes every %1 pixels, largest error %2 pixels").arg(grid->step()).arg(grid->maximumError());
+    QVERIFY(grid->maximumError() <= WCSGrid::DEFAULT_TOLERANCE);
+
+    QVector<QPointF> pixels, coords;
+    randomSkyPoints(*d, 3000, 0.2, pixels, coords);
+
+    // The checks of the grid are halfway between the nodes, leave some room elsewhere
+    double const tolerance = 2 * WCSGrid::DEFAULT_TOLERANCE;
+    double worldError = 0, pixelError = 0, outsideError = 0;
+    for (int i = 0; i < pixels.size(); i++)
+    {
+        if (!d->contains(pixels[i]))
+            continue;
+        QPointF world;
+        QVERIFY(grid->pixelToWorld(pixels[i], world));
+        SkyPoint const exact(coords[i].x() / 15, coords[i].y()), interpolated(world.x() / 15, world.y());
+        worldError = std::max(worldError, exact.angularDistanceTo(&interpolated).Degrees() * 3600 / PIXSCALE);
+    }
+
+    QVector<QPointF> converted;
+    QVERIFY(d->wcsToPixels(coords, converted));
+    QCOMPARE(converted.size(), coords.size());
+    for (int i = 0; i < coords.size(); i++)
+    {
+        QPointF pixel, image;
+        QVERIFY(d->wcsToPixel(SkyPoint(coords[i].x() / 15, coords[i].y()), pixel, image));
+        double const error = std::hypot(converted[i].x() - pixel.x(), converted[i].y() - pixel.y());
+        if (grid->covers(converted[i]))
+            pixelError = std::max(pixelError, error);
+        else
+            outsideError = std::max(outsideError, error);
+    }
+
+    qInfo() << QString("Largest errors: %1 pixels to the sky, %2 pixels from the sky, %3 pixels away from the frame")
+            .arg(worldError).arg(pixelError).arg(outsideError);
+    QVERIFY(worldError < tolerance);
+    QVERIFY(pixelError < tolerance);
+    QVERIFY(outsideError < 1e-6);
+
+    // The bounds of the frame hold the sky at its corners
+    double minRA, maxRA, minDec, maxDec;
+    QVERIFY(d->findWCSBounds(minRA, maxRA, minDec, maxDec));
+    if (DEC > 89)
+        QCOMPARE(maxDec, 90.0);
+    SkyPoint corner;
+    QVERIFY(d->pixelToWCS(QPointF(d->width() - 1, d->height() - 1), corner));
+    QVERIFY(corner.dec0().Degrees() >= minDec && corner.dec0().Degrees() <= maxDec);
+#endif
+}
+
+// The WCS of a region preview gives the coordinates of the pixels of the whole frame that were read
+void TestFitsData::testWCSRegion()
+{
+#if !defined(HAVE_WCSLIB)
+    QSKIP("WCS is not available, skipping test.");
+#else
+    QByteArray const frame = wcsFrame(3000, 2000, "TAN", 150, 30, 1.5, 30, false);
+    std::unique_ptr<FITSData> full(new FITSData());
+    QVERIFY(full->loadFromBuffer(frame, "fits"));
+    QVERIFY2(full->hasWCS(), qPrintable(full->getLastError()));
+
+    QRect const region(400, 300, 1800, 1200);
+    std::unique_ptr<FITSData> preview(new FITSData());
+    preview->setReadRegion(region, 600);
+    QVERIFY(preview->loadFromBuffer(frame, "fits"));
+    QVERIFY2(preview->hasWCS(), qPrintable(preview->getLastError()));
+    int const sampling = 3;
+    QCOMPARE(static_cast<int>(preview->width()), 600);
+
+    // wcslib pixels are 1-based
+    for (QPointF const pixel : {QPointF(1, 1), QPointF(300, 200), QPointF(600, 400), QPointF(123.5, 321.25)})
+    {
+        QPointF const image(region.left() + 1 + (pixel.x() - 1) * sampling, region.top() + 1 + (pixel.y() - 1) * sampling);
+        SkyPoint read, expected;
+        QVERIFY(preview->pixelToWCS(pixel, read));
+        QVERIFY(full->pixelToWCS(image, expected));
+        QVERIFY2(read.angularDistanceTo(&expected).Degrees() * 3600 < 0.01,
+                 qPrintable(QString("%1,%2").arg(pixel.x()).arg(pixel.y())));
+    }
+
+    // Distortions are not mapped to part of the frame
+    std::unique_ptr<FITSData> distorted(new FITSData());
+    distorted->setReadRegion(region);
+    QVERIFY(distorted->loadFromBuffer(wcsFrame(3000, 2000, "TAN", 150, 30, 1.5, 30, true), "fits"));
+    QVERIFY(!distorted->hasWCS());
+#endif
+}
+
+// Projects 100,000 catalog objects of a distorted frame one at a time with wcslib, and at once with the grid
+void TestFitsData::testWCSGridBenchmark()
+{
+#if !defined(HAVE_WCSLIB)
+    QSKIP("WCS is not available, skipping test.");
+#else
+    std::unique_ptr<FITSData> d(new FITSData());
+    QVERIFY(d->loadFromBuffer(wcsFrame(6000, 4000, "TAN", 80, 20, 1.2, 10, true), "fits"));
+    QVERIFY2(d->hasWCS(), qPrintable(d->getLastError()));
+
+    // A catalog query returns objects in a box around the frame
+    QVector<QPointF> pixels, coords;
+    randomSkyPoints(*d, 100000, 0.25, pixels, coords);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QPointF> exact(coords.size());
+    for (int i = 0; i < coords.size(); i++)
+    {
+        QPointF image;
+        QVERIFY(d->wcsToPixel(SkyPoint(coords[i].x() / 15, coords[i].y()), exact[i], image));
+    }
+    qint64 const direct = timer.nsecsElapsed();
+
+    timer.restart();
+    WCSGrid const * const grid = d->wcsGrid();
+    QVERIFY(grid != nullptr);
+    qint64 const sampling = timer.nsecsElapsed();
+
+    timer.restart();
+    QVector<QPointF> converted;
+    QVERIFY(d->wcsToPixels(coords, converted));
+    qint64 const batched = timer.nsecsElapsed();
+
+    double error = 0;
+    for (int i = 0; i < coords.size(); i++)
+        error = std::max(error, std::hypot(converted[i].x() - exact[i].x(), converted[i].y() - exact[i].y()));
+
+    qInfo() << QString("%1 objects: %2 ms one at a time, %3 ms at once after sampling the grid in %4 ms, largest error %5 pixels")
+            .arg(coords.size()).arg(direct / 1e6, 0, 'f', 1).arg(batched / 1e6, 0, 'f', 1).arg(sampling / 1e6, 0, 'f', 1)
+            .arg(error, 0, 'f', 3);
+    QVERIFY(error < 2 * WCSGrid::DEFAULT_TOLERANCE);
+#endif
+}
+
 void TestFitsData::testGradientAlgorithmBenchmark_data()
 {
 #if QT_VERSION < 0x050900
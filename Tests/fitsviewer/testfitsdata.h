@@ -34,9 +34,46 @@ class TestFitsData : public QObject
         void testLoadFits_data();
         void testLoadFits();
 
+        void testCentroidLabelling_data();
+        void testCentroidLabelling();
+
         void testCentroidAlgorithmBenchmark_data();
         void testCentroidAlgorithmBenchmark();
 
+        void testCentroidHFR_data();
+        void testCentroidHFR();
+
+        void testCentroidStarFieldBenchmark_data();
+        void testCentroidStarFieldBenchmark();
+
+        void testTrackingBoxFrame_data();
+        void testTrackingBoxFrame();
+
+        void testTrackingBoxFrameBenchmark_data();
+        void testTrackingBoxFrameBenchmark();
+
+        void testRotateFlip_data();
+        void testRotateFlip();
+
+        void testRotateFlipBenchmark_data();
+        void testRotateFlipBenchmark();
+
+        void testLoadRegion_data();
+        void testLoadRegion();
+
+        void testLoadBenchmark_data();
+        void testLoadBenchmark();
+
+        void testFrameBufferPool();
+        void testFrameBufferPoolSoak();
+
+        void testPreviewCache();
+
+        void testWCSGrid_data();
+        void testWCSGrid();
+        void testWCSRegion();
+        void testWCSGridBenchmark();
+
         void testGradientAlgorithmBenchmark_data();
         void testGradientAlgorithmBenchmark();
 
@@ -52,6 +89,12 @@ class TestFitsData : public QObject
         void testBahtinovFocusHFR_data();
         void testBahtinovFocusHFR();
 
+        void testBahtinovSynthetic_data();
+        void testBahtinovSynthetic();
+
+        void testBahtinovAlgorithmBenchmark_data();
+        void testBahtinovAlgorithmBenchmark();
+
         void testParallelSolvers();
     private:
         void startGuideDetect(const QString &filename);
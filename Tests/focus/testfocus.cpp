@@ -7,6 +7,7 @@
 #include "ekos/focus/focusalgorithms.h"
 
 #include <QtTest>
+#include <QRegularExpression>
 #include <memory>
 
 #include <QObject>
@@ -30,6 +31,9 @@ class TestFocus : public QObject
         void L1PHyperbolaTest();
         void L1PParabolaTest();
         void L1PQuadraticTest();
+        void anticipatedPositionTest();
+        void anticipationReplayTest_data();
+        void anticipationReplayTest();
 };
 
 #include "testfocus.moc"
@@ -820,4 +824,243 @@ void TestFocus::L1PQuadraticTest()
     QCOMPARE(focuser->doneReason(), "Solution found.");
 }
 
+void TestFocus::anticipatedPositionTest()
+{
+    auto params = makeL1PHyperbolaParams();
+    std::unique_ptr<FocusAlgorithmInterface> focuser(MakeLinearFocuser(params));
+    int currentPosition = focuser->initialPosition();
+
+    // Through the first pass, the anticipated position is the one requested by the measurement.
+    for (const double hfr : {5.0, 4.0, 3.0, 2.0, 1.0, 0.9, 1.1, 2.0, 3.0, 4.0})
+    {
+        const int anticipated = focuser->anticipatedPosition();
+        QCOMPARE(anticipated, currentPosition - params.initialStepSize);
+        const int position = focuser->newMeasurement(currentPosition, hfr);
+        QCOMPARE(position, anticipated);
+        currentPosition = position;
+    }
+
+    // The end of the first pass can't be anticipated, the focuser goes back out to the solution.
+    QCOMPARE(focuser->anticipatedPosition(), currentPosition - params.initialStepSize);
+    int position = focuser->newMeasurement(currentPosition, 5);
+    QCOMPARE(position, 10000);
+    QCOMPARE(focuser->anticipatedPosition(), -1);
+
+    position = focuser->newMeasurement(position, 0.91);
+    QCOMPARE(position, -1);
+    QCOMPARE(focuser->anticipatedPosition(), -1);
+
+    // Nothing is anticipated past the limits of travel.
+    params.minPositionAllowed = focuser->initialPosition() - params.initialStepSize / 2;
+    focuser.reset(MakeLinearFocuser(params));
+    QCOMPARE(focuser->anticipatedPosition(), -1);
+}
+
+namespace
+{
+// V-curves in the format the Linear algorithm logs its points, "Linear: points=[(position, HFR, sigma), ...]",
+// so that runs from a focus log can be added to the replay.
+const char *FOCUS_RUN_NEAR =
+    "(10500, 4.896, 1), (10475, 4.762, 1), (10450, 4.537, 1), (10425, 4.386, 1), (10400, 4.197, 1), "
+    "(10375, 3.916, 1), (10350, 3.721, 1), (10325, 3.654, 1), (10300, 3.385, 1), (10275, 3.197, 1), "
+    "(10250, 3.107, 1), (10225, 2.860, 1), (10200, 2.719, 1), (10175, 2.504, 1), (10150, 2.345, 1), "
+    "(10125, 2.133, 1), (10100, 2.011, 1), (10075, 1.871, 1), (10050, 1.699, 1), (10025, 1.577, 1), "
+    "(10000, 1.452, 1), (9975, 1.318, 1), (9950, 1.278, 1), (9925, 1.221, 1), (9900, 1.190, 1), "
+    "(9875, 1.194, 1), (9850, 1.283, 1), (9825, 1.340, 1), (9800, 1.455, 1), (9775, 1.586, 1), "
+    "(9750, 1.712, 1), (9725, 1.875, 1), (9700, 1.992, 1), (9675, 2.189, 1), (9650, 2.327, 1), "
+    "(9625, 2.550, 1), (9600, 2.724, 1), (9575, 2.817, 1), (9550, 3.002, 1), (9525, 3.195, 1), "
+    "(9500, 3.481, 1), (9475, 3.596, 1), (9450, 3.814, 1), (9425, 3.953, 1), (9400, 4.177, 1), "
+    "(9375, 4.348, 1), (9350, 4.534, 1), (9325, 4.770, 1), (9300, 4.964, 1)";
+const char *FOCUS_RUN_CENTERED =
+    "(10500, 6.408, 1), (10475, 6.047, 1), (10450, 5.799, 1), (10425, 5.477, 1), (10400, 5.201, 1), "
+    "(10375, 4.836, 1), (10350, 4.446, 1), (10325, 4.274, 1), (10300, 3.996, 1), (10275, 3.695, 1), "
+    "(10250, 3.363, 1), (10225, 3.104, 1), (10200, 2.777, 1), (10175, 2.584, 1), (10150, 2.312, 1), "
+    "(10125, 2.060, 1), (10100, 1.842, 1), (10075, 1.730, 1), (10050, 1.612, 1), (10025, 1.487, 1), "
+    "(10000, 1.523, 1), (9975, 1.557, 1), (9950, 1.654, 1), (9925, 1.823, 1), (9900, 2.057, 1), "
+    "(9875, 2.291, 1), (9850, 2.454, 1), (9825, 2.769, 1), (9800, 2.968, 1), (9775, 3.327, 1), "
+    "(9750, 3.555, 1), (9725, 3.924, 1), (9700, 4.235, 1), (9675, 4.449, 1), (9650, 4.838, 1), "
+    "(9625, 5.002, 1), (9600, 5.250, 1), (9575, 5.663, 1), (9550, 5.831, 1), (9525, 6.170, 1), "
+    "(9500, 6.525, 1), (9475, 6.884, 1), (9450, 7.060, 1), (9425, 7.328, 1), (9400, 7.885, 1), "
+    "(9375, 8.018, 1), (9350, 8.539, 1), (9325, 8.831, 1), (9300, 8.957, 1)";
+const char *FOCUS_RUN_FAR =
+    "(10500, 7.530, 1), (10475, 7.319, 1), (10450, 7.125, 1), (10425, 6.883, 1), (10400, 6.644, 1), "
+    "(10375, 6.432, 1), (10350, 6.283, 1), (10325, 5.949, 1), (10300, 5.705, 1), (10275, 5.544, 1), "
+    "(10250, 5.215, 1), (10225, 5.005, 1), (10200, 4.914, 1), (10175, 4.602, 1), (10150, 4.385, 1), "
+    "(10125, 4.074, 1), (10100, 3.922, 1), (10075, 3.729, 1), (10050, 3.433, 1), (10025, 3.301, 1), "
+    "(10000, 3.090, 1), (9975, 2.815, 1), (9950, 2.674, 1), (9925, 2.457, 1), (9900, 2.283, 1), "
+    "(9875, 2.069, 1), (9850, 1.921, 1), (9825, 1.759, 1), (9800, 1.567, 1), (9775, 1.449, 1), "
+    "(9750, 1.390, 1), (9725, 1.345, 1), (9700, 1.287, 1), (9675, 1.318, 1), (9650, 1.386, 1), "
+    "(9625, 1.464, 1), (9600, 1.589, 1), (9575, 1.730, 1), (9550, 1.895, 1), (9525, 2.089, 1), "
+    "(9500, 2.249, 1), (9475, 2.449, 1), (9450, 2.690, 1), (9425, 2.811, 1), (9400, 3.083, 1), "
+    "(9375, 3.317, 1), (9350, 3.474, 1), (9325, 3.676, 1), (9300, 3.983, 1), (9275, 4.112, 1), "
+    "(9250, 4.321, 1), (9225, 4.586, 1), (9200, 4.860, 1), (9175, 4.965, 1), (9150, 5.232, 1), "
+    "(9125, 5.459, 1), (9100, 5.797, 1)";
+
+// Time in milliseconds taken by each stage of an autofocus step.
+struct ReplayTiming
+{
+    double exposure { 3000 };
+    double readout { 1500 };
+    double detection { 1200 };
+    double settle { 1000 };
+    double moveOverhead { 300 };
+    double movePerStep { 2 };
+};
+
+struct ReplayResult
+{
+    int frames { 0 };
+    // Frames after which the position was anticipated, and those after which the measurement requested another
+    int anticipated { 0 };
+    int mispredicted { 0 };
+    int solution { -1 };
+    // Autofocus time in the timing model, moving after each measurement or while it runs
+    double sequentialDuration { 0 };
+    double pipelinedDuration { 0 };
+};
+
+QVector<QPointF> parseRun(const QString &run)
+{
+    QVector<QPointF> curve;
+    const QRegularExpression point("\\((\\d+), ([\\d.]+), [\\d.]+\\)");
+    auto matches = point.globalMatch(run);
+    while (matches.hasNext())
+    {
+        const auto match = matches.next();
+        curve.append(QPointF(match.captured(1).toDouble(), match.captured(2).toDouble()));
+    }
+    std::sort(curve.begin(), curve.end(), [](const QPointF & a, const QPointF & b)
+    {
+        return a.x() < b.x();
+    });
+    return curve;
+}
+
+// The HFR at a position, interpolated between the recorded points and extrapolated past them.
+double replayHFR(const QVector<QPointF> &curve, int position)
+{
+    int i = 1;
+    while (i < curve.size() - 1 && curve[i].x() < position)
+        i++;
+    const QPointF &a = curve[i - 1], &b = curve[i];
+    return std::max(0.1, a.y() + (b.y() - a.y()) * (position - a.x()) / (b.x() - a.x()));
+}
+
+// Time to move and settle, with the outward moves extended and brought back in as Focus does.
+double moveTime(const FocusAlgorithmInterface::FocusParams &params, const ReplayTiming &timing, int from, int to)
+{
+    if (std::abs(to - from) <= 1)
+        return timing.settle;
+
+    double travel = std::abs(to - from);
+    int moves = 1;
+    if (to > from)
+    {
+        const int extension = (params.focusAlgorithm == Ekos::Focus::FOCUS_LINEAR1PASS && params.backlash > 0) ?
+                              params.backlash : 5 * params.initialStepSize;
+        travel += 2 * extension;
+        moves = 2;
+    }
+    return moves * timing.moveOverhead + travel * timing.movePerStep + timing.settle;
+}
+
+/* Runs the algorithm against a recorded curve, comparing the position anticipated before each measurement with the
+ * one the measurement requests. The time of the run is estimated with a deterministic timing model, moving once the
+ * frame is analyzed, or moving to the anticipated position while it is and moving again if it was not the one.
+ * Only the algorithm is run, not the Focus module that moves the focuser.
+ */
+ReplayResult replay(const FocusAlgorithmInterface::FocusParams &params, const QVector<QPointF> &curve,
+                    const ReplayTiming &timing)
+{
+    ReplayResult result;
+    std::unique_ptr<FocusAlgorithmInterface> focuser(MakeLinearFocuser(params));
+
+    int position = params.startPosition;
+    int requested = focuser->initialPosition();
+    result.sequentialDuration = result.pipelinedDuration = moveTime(params, timing, position, requested);
+    position = requested;
+
+    while (!focuser->isDone() && result.frames < 100)
+    {
+        result.sequentialDuration += timing.exposure + timing.readout;
+        result.pipelinedDuration += timing.exposure + timing.readout;
+        result.frames++;
+
+        const int anticipated = focuser->anticipatedPosition();
+        requested = focuser->newMeasurement(position, replayHFR(curve, position));
+        if (focuser->isDone())
+        {
+            result.sequentialDuration += timing.detection;
+            result.pipelinedDuration += timing.detection;
+            break;
+        }
+
+        const double sequential = timing.detection + moveTime(params, timing, position, requested);
+        result.sequentialDuration += sequential;
+        if (anticipated >= 0 && anticipated < position)
+        {
+            result.anticipated++;
+            double ready = std::max(timing.detection, moveTime(params, timing, position, anticipated));
+            if (requested != anticipated)
+            {
+                ready += moveTime(params, timing, anticipated, requested);
+                result.mispredicted++;
+            }
+            result.pipelinedDuration += ready;
+        }
+        else
+            result.pipelinedDuration += sequential;
+        position = requested;
+    }
+
+    result.solution = focuser->solution();
+    return result;
+}
+}
+
+void TestFocus::anticipationReplayTest_data()
+{
+    QTest::addColumn<QString>("RUN");
+    QTest::addColumn<int>("ALGORITHM");
+    QTest::addColumn<int>("CURVE");
+
+    QTest::newRow("L1P hyperbola, minimum near the start") << FOCUS_RUN_NEAR
+            << static_cast<int>(Ekos::Focus::FOCUS_LINEAR1PASS) << static_cast<int>(Ekos::CurveFitting::FOCUS_HYPERBOLA);
+    QTest::newRow("L1P parabola, minimum at the start") << FOCUS_RUN_CENTERED
+            << static_cast<int>(Ekos::Focus::FOCUS_LINEAR1PASS) << static_cast<int>(Ekos::CurveFitting::FOCUS_PARABOLA);
+    QTest::newRow("L1P hyperbola, minimum far in") << FOCUS_RUN_FAR
+            << static_cast<int>(Ekos::Focus::FOCUS_LINEAR1PASS) << static_cast<int>(Ekos::CurveFitting::FOCUS_HYPERBOLA);
+    QTest::newRow("Linear, minimum near the start") << FOCUS_RUN_NEAR
+            << static_cast<int>(Ekos::Focus::FOCUS_LINEAR) << static_cast<int>(Ekos::CurveFitting::FOCUS_QUADRATIC);
+}
+
+/* Replays focus runs through the algorithm, checks that the positions it anticipates are mostly the ones it then
+ * requests, and reports the autofocus time the timing model estimates with and without moving ahead.
+ */
+void TestFocus::anticipationReplayTest()
+{
+    QFETCH(QString, RUN);
+    QFETCH(int, ALGORITHM);
+    QFETCH(int, CURVE);
+
+    const QVector<QPointF> curve = parseRun(RUN);
+    QVERIFY(curve.size() > 10);
+
+    auto params = makeL1PHyperbolaParams();
+    params.focusAlgorithm = static_cast<Ekos::Focus::FocusAlgorithm>(ALGORITHM);
+    params.curveFit = static_cast<Ekos::CurveFitting::CurveFit>(CURVE);
+    params.useWeights = false;
+
+    const ReplayResult result = replay(params, curve, ReplayTiming());
+
+    qInfo() << QString("%1 frames, solution %2, %3 positions anticipated, %4 mispredicted: estimated %5 s, %6 s moving ahead")
+            .arg(result.frames).arg(result.solution).arg(result.anticipated).arg(result.mispredicted)
+            .arg(result.sequentialDuration / 1000, 0, 'f', 1).arg(result.pipelinedDuration / 1000, 0, 'f', 1);
+
+    QVERIFY(result.solution > 0);
+    QVERIFY(result.anticipated > 0);
+    QVERIFY2(result.mispredicted * 2 < result.anticipated,
+             qPrintable(QString("%1 of %2 anticipated positions mispredicted").arg(result.mispredicted).arg(result.anticipated)));
+}
+
 QTEST_GUILESS_MAIN(TestFocus)
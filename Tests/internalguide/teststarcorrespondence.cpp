@@ -9,6 +9,7 @@
 #include <QtTest>
 
 #include <QObject>
+#include <random>
 
 
 class TestStarCorrespondence : public QObject
@@ -24,6 +25,10 @@ class TestStarCorrespondence : public QObject
 
     private slots:
         void basicTest();
+        void matchesBruteForceTest_data();
+        void matchesBruteForceTest();
+        void benchmarkFind_data();
+        void benchmarkFind();
 };
 
 #include "teststarcorrespondence.moc"
@@ -238,4 +243,136 @@ void TestStarCorrespondence::basicTest()
     runNoCorrespondenceTest();
 }
 
+namespace
+{
+// Synthetic star field of numStars stars spread over a width x height image.
+QList<Edge> makeStarField(int numStars, int width, int height, std::mt19937 *generator)
+{
+    std::uniform_real_distribution<float> xDist(0, width), yDist(0, height);
+    QList<Edge> stars;
+    for (int i = 0; i < numStars; ++i)
+        stars.append(makeEdge(xDist(*generator), yDist(*generator)));
+    return stars;
+}
+
+// Moves the whole field by a few pixels, adds positional noise, and shuffles the order.
+QList<Edge> perturbStarField(const QList<Edge> &stars, std::mt19937 *generator)
+{
+    std::uniform_real_distribution<float> shiftDist(-4, 4), noiseDist(-1.5, 1.5);
+    const float dx = shiftDist(*generator), dy = shiftDist(*generator);
+    QList<Edge> moved;
+    for (const auto &star : stars)
+        moved.append(makeEdge(star.x + dx + noiseDist(*generator), star.y + dy + noiseDist(*generator)));
+    std::shuffle(moved.begin(), moved.end(), *generator);
+    return moved;
+}
+
+// A direct implementation of the correspondence search (guide star present), which
+// exhaustively compares every detected star against every reference offset.
+// Returns the index of the detected guide star and fills starMap.
+int bruteForceFind(const QList<Edge> &refs, int guideStar, const QList<Edge> &stars,
+                   double maxDistance, QVector<int> *starMap)
+{
+    constexpr double missingRefStarCost = 100;
+    constexpr double minFraction = 0.5;
+    *starMap = QVector<int>(stars.size(), -1);
+    // Like StarCorrespondence, keep the best cost as an integer.
+    int bestCost = refs.size() * missingRefStarCost * (1 - minFraction);
+    int bestIndex = -1;
+    for (int s = 0; s < stars.size(); ++s)
+    {
+        double cost = 0;
+        QVector<int> mapping(stars.size(), -1);
+        for (int r = 0; r < refs.size() && cost <= bestCost; ++r)
+        {
+            if (r == guideStar) continue;
+            const double x = stars[s].x + refs[r].x - refs[guideStar].x;
+            const double y = stars[s].y + refs[r].y - refs[guideStar].y;
+            int closest = -1;
+            double closestSq = maxDistance * maxDistance;
+            for (int i = 0; i < stars.size(); ++i)
+            {
+                const double sq = (stars[i].x - x) * (stars[i].x - x) + (stars[i].y - y) * (stars[i].y - y);
+                if (sq <= closestSq)
+                {
+                    closest = i;
+                    closestSq = sq;
+                }
+            }
+            if (closest < 0)
+                cost += missingRefStarCost;
+            else
+            {
+                mapping[closest] = r;
+                cost += sqrt(closestSq);
+            }
+        }
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestIndex = s;
+            *starMap = mapping;
+            (*starMap)[s] = guideStar;
+        }
+    }
+    return bestIndex;
+}
+}  // namespace
+
+void TestStarCorrespondence::matchesBruteForceTest_data()
+{
+    QTest::addColumn<int>("numStars");
+    for (int numStars : {50, 200, 500, 1000, 2000})
+        QTest::newRow(QString("%1 stars").arg(numStars).toLatin1().constData()) << numStars;
+}
+
+// The grid-indexed search must return exactly the same correspondence as an exhaustive search.
+void TestStarCorrespondence::matchesBruteForceTest()
+{
+    QFETCH(int, numStars);
+    constexpr int width = 3000, height = 2000, numRefs = 20, guideStar = 3;
+    constexpr double maxDistance = 5.0;
+    std::mt19937 generator(numStars);
+
+    const QList<Edge> field = makeStarField(numStars, width, height, &generator);
+    const QList<Edge> refs = field.mid(0, numRefs);
+    StarCorrespondence c(refs, guideStar);
+    c.setImageSize(width, height);
+
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        const QList<Edge> stars = perturbStarField(field, &generator);
+        QVector<int> output, expected;
+        const Edge gStar = c.find(stars, maxDistance, &output, false);
+        const int expectedIndex = bruteForceFind(refs, guideStar, stars, maxDistance, &expected);
+        QVERIFY(expectedIndex >= 0);
+        QCOMPARE(gStar.x, stars[expectedIndex].x);
+        QCOMPARE(gStar.y, stars[expectedIndex].y);
+        QCOMPARE(output, expected);
+    }
+}
+
+void TestStarCorrespondence::benchmarkFind_data()
+{
+    matchesBruteForceTest_data();
+}
+
+void TestStarCorrespondence::benchmarkFind()
+{
+    QFETCH(int, numStars);
+    constexpr int width = 3000, height = 2000, numRefs = 20;
+    std::mt19937 generator(numStars);
+
+    const QList<Edge> field = makeStarField(numStars, width, height, &generator);
+    StarCorrespondence c(field.mid(0, numRefs), 0);
+    c.setImageSize(width, height);
+    c.setAllowMissingGuideStar(true);
+
+    // Drop the guide star so the benchmark also covers the substitute guide-star search.
+    QList<Edge> stars = perturbStarField(field.mid(1), &generator);
+    QVector<int> output;
+    QBENCHMARK { c.find(stars, 5.0, &output, false); }
+    QVERIFY(c.getNumReferencesFound() > numRefs / 2);
+}
+
 QTEST_GUILESS_MAIN(TestStarCorrespondence)
@@ -0,0 +1,277 @@
+/*  Batch projection tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_batch_projection.h"
+
+#if defined(HAVE_INDI)
+
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "projections/azimuthalequidistantprojector.h"
+#include "projections/equirectangularprojector.h"
+#include "projections/gnomonicprojector.h"
+#include "projections/lambertprojector.h"
+#include "projections/orthographicprojector.h"
+#include "projections/stereographicprojector.h"
+#include "test_ekos.h"
+
+#include <QRandomGenerator>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+TestBatchProjection::TestBatchProjection(QObject *parent) : QObject(parent)
+{
+}
+
+void TestBatchProjection::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+}
+
+void TestBatchProjection::cleanupTestCase()
+{
+}
+
+namespace
+{
+std::unique_ptr<Projector> makeProjector(Projector::Projection type, const ViewParams &vp)
+{
+    switch (type)
+    {
+        case Projector::Lambert:
+            return std::unique_ptr<Projector>(new LambertProjector(vp));
+        case Projector::AzimuthalEquidistant:
+            return std::unique_ptr<Projector>(new AzimuthalEquidistantProjector(vp));
+        case Projector::Orthographic:
+            return std::unique_ptr<Projector>(new OrthographicProjector(vp));
+        case Projector::Equirectangular:
+            return std::unique_ptr<Projector>(new EquirectangularProjector(vp));
+        case Projector::Stereographic:
+            return std::unique_ptr<Projector>(new StereographicProjector(vp));
+        case Projector::Gnomonic:
+        default:
+            return std::unique_ptr<Projector>(new GnomonicProjector(vp));
+    }
+}
+
+const QList<Projector::Projection> projections =
+{
+    Projector::Lambert, Projector::AzimuthalEquidistant, Projector::Orthographic,
+    Projector::Equirectangular, Projector::Stereographic, Projector::Gnomonic
+};
+
+QString projectionName(Projector::Projection projection)
+{
+    return QMetaEnum::fromType<Projector::Projection>().valueToKey(projection);
+}
+
+// Points spread over the whole sphere, with their horizontal coordinates
+std::vector<SkyPoint> randomPoints(int count)
+{
+    QRandomGenerator random(42);
+    KStarsData *data = KStarsData::Instance();
+    std::vector<SkyPoint> points(count);
+    for (auto &point : points)
+    {
+        point.set(dms(random.bounded(360.0)).reduce(), dms(std::asin(2 * random.generateDouble() - 1) / dms::DegToRad));
+        point.EquatorialToHorizontal(data->lst(), data->geo()->lat());
+    }
+    return points;
+}
+
+struct View
+{
+    SkyPoint focus;
+    ViewParams vp;
+
+    View(bool altAz, bool refraction, double zoom)
+    {
+        focus.setAz(130);
+        focus.setAlt(35);
+        focus.HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
+        vp.width         = 1920;
+        vp.height        = 1080;
+        vp.zoomFactor    = zoom;
+        vp.useAltAz      = altAz;
+        vp.useRefraction = refraction;
+        vp.fillGround    = false;
+        vp.focus         = &focus;
+    }
+};
+
+// Coordinates of the points in the frame of the view, in radians
+void coordinates(const std::vector<SkyPoint> &points, bool altAz, std::vector<double> &longitude,
+                 std::vector<double> &latitude)
+{
+    longitude.clear();
+    latitude.clear();
+    for (const auto &point : points)
+    {
+        longitude.push_back(altAz ? point.az().radians() : point.ra().radians());
+        latitude.push_back(altAz ? point.alt().radians() : point.dec().radians());
+    }
+}
+}  // namespace
+
+void TestBatchProjection::testSameAsScalar_data()
+{
+    QTest::addColumn<int>("projection");
+    QTest::addColumn<bool>("altAz");
+    QTest::addColumn<bool>("refraction");
+    QTest::addColumn<bool>("oRefract");
+
+    for (const auto projection : projections)
+    {
+        const QString name = projectionName(projection);
+        QTest::newRow(QString("%1 equatorial").arg(name).toLatin1().constData())
+                << static_cast<int>(projection) << false << false << true;
+        QTest::newRow(QString("%1 horizontal").arg(name).toLatin1().constData())
+                << static_cast<int>(projection) << true << false << true;
+        QTest::newRow(QString("%1 refracted").arg(name).toLatin1().constData())
+                << static_cast<int>(projection) << true << true << true;
+        QTest::newRow(QString("%1 not refracted").arg(name).toLatin1().constData())
+                << static_cast<int>(projection) << true << true << false;
+    }
+}
+
+void TestBatchProjection::testSameAsScalar()
+{
+    QFETCH(int, projection);
+    QFETCH(bool, altAz);
+    QFETCH(bool, refraction);
+    QFETCH(bool, oRefract);
+
+    View view(altAz, refraction, 600);
+    auto proj = makeProjector(static_cast<Projector::Projection>(projection), view.vp);
+
+    // Not a multiple of the batch size, so that the last batch is partial
+    const std::vector<SkyPoint> points = randomPoints(3 * Projector::BatchSize + 17);
+    const int count = int(points.size());
+    std::vector<double> longitude, latitude;
+    coordinates(points, altAz, longitude, latitude);
+
+    std::vector<float> x(count), y(count);
+    std::unique_ptr<bool[]> visible(new bool[count]);
+    proj->toScreen(longitude.data(), latitude.data(), count, x.data(), y.data(), visible.get(), oRefract);
+
+    int visibleCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        bool expectedVisible = false;
+        const Eigen::Vector2f expected = proj->toScreenVec(&points[i], oRefract, &expectedVisible);
+        QCOMPARE(visible[i], expectedVisible);
+        if (!expectedVisible)
+            continue;
+
+        // The scalar and array functions may round differently, a hundredth of pixel is plenty
+        visibleCount++;
+        QVERIFY2(std::fabs(x[i] - expected.x()) < 0.01 && std::fabs(y[i] - expected.y()) < 0.01,
+                 qPrintable(QString("Point %1 at %2, %3 instead of %4, %5").arg(i).arg(x[i]).arg(y[i])
+                            .arg(expected.x()).arg(expected.y())));
+    }
+    QVERIFY(visibleCount > 0);
+}
+
+void TestBatchProjection::testSkyPoints_data()
+{
+    QTest::addColumn<int>("projection");
+
+    for (const auto projection : projections)
+        QTest::newRow(projectionName(projection).toLatin1().constData()) << static_cast<int>(projection);
+}
+
+void TestBatchProjection::testSkyPoints()
+{
+    QFETCH(int, projection);
+
+    View view(true, true, 600);
+    auto proj = makeProjector(static_cast<Projector::Projection>(projection), view.vp);
+
+    std::vector<SkyPoint> points = randomPoints(Projector::BatchSize + 1);
+    // Points with non finite coordinates are projected to the origin and not visible
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    points[10].setAz(nan);
+    points[Projector::BatchSize].setAlt(nan);
+
+    const int count = int(points.size());
+    std::vector<QPointF> screen(count);
+    std::unique_ptr<bool[]> visible(new bool[count]);
+    proj->toScreen(count, [&points](int i)
+    {
+        return &points[i];
+    }, screen.data(), visible.get());
+
+    for (int i = 0; i < count; i++)
+    {
+        if (i == 10 || i == Projector::BatchSize)
+        {
+            QVERIFY(!visible[i]);
+            QCOMPARE(screen[i], QPointF(0, 0));
+            continue;
+        }
+
+        bool expectedVisible = false;
+        const QPointF expected = proj->toScreen(&points[i], true, &expectedVisible);
+        QCOMPARE(visible[i], expectedVisible);
+        if (expectedVisible)
+            QVERIFY((screen[i] - expected).manhattanLength() < 0.02);
+    }
+}
+
+void TestBatchProjection::benchmarkProjection_data()
+{
+    QTest::addColumn<int>("projection");
+    QTest::addColumn<bool>("batch");
+
+    for (const auto projection : projections)
+    {
+        const QString name = projectionName(projection);
+        QTest::newRow(QString("%1 scalar").arg(name).toLatin1().constData()) << static_cast<int>(projection) << false;
+        QTest::newRow(QString("%1 batch").arg(name).toLatin1().constData()) << static_cast<int>(projection) << true;
+    }
+}
+
+// Throughput of the projection of a million points in horizontal coordinates, with refraction
+void TestBatchProjection::benchmarkProjection()
+{
+    QFETCH(int, projection);
+    QFETCH(bool, batch);
+
+    View view(true, true, 600);
+    auto proj = makeProjector(static_cast<Projector::Projection>(projection), view.vp);
+
+    const std::vector<SkyPoint> points = randomPoints(1000000);
+    const int count = int(points.size());
+    std::vector<double> longitude, latitude;
+    coordinates(points, true, longitude, latitude);
+    std::vector<float> x(count), y(count);
+    std::unique_ptr<bool[]> visible(new bool[count]);
+
+    QBENCHMARK
+    {
+        if (batch)
+        {
+            proj->toScreen(longitude.data(), latitude.data(), count, x.data(), y.data(), visible.get());
+        }
+        else
+        {
+            for (int i = 0; i < count; i++)
+            {
+                const Eigen::Vector2f p = proj->toScreenVec(&points[i], true, &visible[i]);
+                x[i] = p.x();
+                y[i] = p.y();
+            }
+        }
+    }
+}
+
+QTEST_KSTARS_MAIN(TestBatchProjection)
+
+#endif // HAVE_INDI
@@ -0,0 +1,37 @@
+/*  Batch projection tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestBatchProjection_H
+#define TestBatchProjection_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestBatchProjection : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestBatchProjection(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testSameAsScalar_data();
+        void testSameAsScalar();
+        void testSkyPoints_data();
+        void testSkyPoints();
+        void benchmarkProjection_data();
+        void benchmarkProjection();
+};
+
+#endif // HAVE_INDI
+#endif // TestBatchProjection_H
@@ -0,0 +1,229 @@
+/*  Conjunction search tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_conjunctions.h"
+
+#if defined(HAVE_INDI)
+
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skycomponents/skymapcomposite.h"
+#include "skyobjects/ksplanetbase.h"
+#include "test_ekos.h"
+#include "tools/conjunctionsearch.h"
+#include "tools/ksconjunct.h"
+
+#include <QtConcurrent>
+
+#include <atomic>
+#include <cmath>
+
+TestConjunctions::TestConjunctions(QObject *parent) : QObject(parent)
+{
+}
+
+void TestConjunctions::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+}
+
+void TestConjunctions::cleanupTestCase()
+{
+}
+
+namespace
+{
+// 2026-01-01 0h UT
+const long double startJD = 2461041.5;
+const long double stopJD  = startJD + 365;
+
+QMap<long double, dms> solve(const SkyObject *object, int planet, const dms &maxSeparation, bool opposition)
+{
+    KSConjunct ksc;
+    ksc.setGeoLocation(KStarsData::Instance()->geo());
+    SkyObject_s object1(object->clone());
+    KSPlanetBase_s object2(KSPlanetBase::createPlanet(planet));
+    ksc.setObject1(object1);
+    ksc.setObject2(object2);
+    ksc.setMaxSeparation(maxSeparation);
+    ksc.setOpposition(opposition);
+    return ksc.findClosestApproach(startJD, stopJD);
+}
+
+QVector<ConjunctionSearch::Event> search(const QVector<QPair<QString, const SkyObject *>> &objects, int planet,
+        const dms &maxSeparation, bool opposition)
+{
+    ConjunctionSearch search;
+    search.setGeoLocation(KStarsData::Instance()->geo());
+    search.setPlanet(planet);
+    search.setMaxSeparation(maxSeparation);
+    search.setOpposition(opposition);
+    return search.find(objects, startJD, stopJD);
+}
+
+// Events close to the ends of the range may be found by one method only
+bool nearEnds(long double jd)
+{
+    return jd - startJD < 2 || stopJD - jd < 2;
+}
+
+// Events closer than 2 minutes and 1 arcminute are the same event
+bool sameEvent(long double jd1, const dms &separation1, long double jd2, const dms &separation2)
+{
+    return std::fabs(double(jd1 - jd2)) * 1440 < 2 &&
+           std::fabs(separation1.Degrees() - separation2.Degrees()) * 60 < 1;
+}
+}  // namespace
+
+void TestConjunctions::testSameAsSolver_data()
+{
+    QTest::addColumn<QString>("object");
+    QTest::addColumn<int>("planet");
+    QTest::addColumn<double>("maxSeparation");
+    QTest::addColumn<bool>("opposition");
+
+    QTest::newRow("Mars and Moon") << "Mars" << int(KSPlanetBase::MOON) << 5.0 << false;
+    QTest::newRow("Regulus and Moon") << "Regulus" << int(KSPlanetBase::MOON) << 5.0 << false;
+    QTest::newRow("Spica and Moon") << "Spica" << int(KSPlanetBase::MOON) << 5.0 << false;
+    QTest::newRow("Jupiter and Venus") << "Jupiter" << int(KSPlanetBase::VENUS) << 10.0 << false;
+    QTest::newRow("Saturn and Sun") << "Saturn" << int(KSPlanetBase::SUN) << 5.0 << true;
+    QTest::newRow("Antares and Mars") << "Antares" << int(KSPlanetBase::MARS) << 20.0 << false;
+}
+
+void TestConjunctions::testSameAsSolver()
+{
+    QFETCH(QString, object);
+    QFETCH(int, planet);
+    QFETCH(double, maxSeparation);
+    QFETCH(bool, opposition);
+
+    const SkyObject *object1 = KStarsData::Instance()->skyComposite()->findByName(object);
+    QVERIFY(object1 != nullptr);
+
+    const QMap<long double, dms> expected = solve(object1, planet, dms(maxSeparation), opposition);
+    const QVector<ConjunctionSearch::Event> events = search({ qMakePair(object, object1) }, planet,
+            dms(maxSeparation), opposition);
+
+    // Every event of the solver is found
+    for (auto it = expected.constBegin(); it != expected.constEnd(); ++it)
+    {
+        if (nearEnds(it.key()))
+            continue;
+        bool found = false;
+        for (const auto &event : events)
+            found = found || sameEvent(it.key(), it.value(), event.jd, event.separation);
+        QVERIFY2(found, qPrintable(QString("Missed the event at %1 (%2)")
+                                   .arg(KStarsDateTime(it.key()).toString(Qt::ISODate), it.value().toDMSString())));
+    }
+
+    // And nothing else
+    for (const auto &event : events)
+    {
+        QCOMPARE(event.object, object);
+        QVERIFY(event.separation.Degrees() < maxSeparation);
+        if (nearEnds(event.jd))
+            continue;
+        bool found = false;
+        for (auto it = expected.constBegin(); it != expected.constEnd(); ++it)
+            found = found || sameEvent(it.key(), it.value(), event.jd, event.separation);
+        QVERIFY2(found, qPrintable(QString("Unexpected event at %1 (%2)")
+                                   .arg(KStarsDateTime(event.jd).toString(Qt::ISODate), event.separation.toDMSString())));
+    }
+}
+
+void TestConjunctions::testSeveralObjects()
+{
+    // Searching many objects at once splits the work differently, the events must not change
+    QVector<QPair<QString, const SkyObject *>> objects;
+    for (const QString &name : QStringList{ "Mars", "Jupiter", "Regulus", "Spica", "Aldebaran", "Antares" })
+    {
+        const SkyObject *object = KStarsData::Instance()->skyComposite()->findByName(name);
+        QVERIFY(object != nullptr);
+        objects.append(qMakePair(name, object));
+    }
+
+    const QVector<ConjunctionSearch::Event> all = search(objects, KSPlanetBase::MOON, dms(5.0), false);
+    QVector<ConjunctionSearch::Event> separate;
+    for (const auto &object : objects)
+        separate += search({ object }, KSPlanetBase::MOON, dms(5.0), false);
+
+    QCOMPARE(all.size(), separate.size());
+    for (int i = 0; i < all.size(); ++i)
+    {
+        QCOMPARE(all[i].object, separate[i].object);
+        QVERIFY(sameEvent(all[i].jd, all[i].separation, separate[i].jd, separate[i].separation));
+    }
+}
+
+// The searches and the What's Interesting models look objects up by name from pool threads,
+// while the sky map looks up the Sun for the light bending of the stars it updates
+void TestConjunctions::testFindByNameFromThreads()
+{
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    const QStringList names = { "Sun", "Moon", "Mars", "Jupiter", "Regulus", "Spica", "Aldebaran", "Antares", "Ceres" };
+    QHash<QString, const SkyObject *> expected;
+    for (const QString &name : names)
+        expected.insert(name, composite->findByName(name));
+    QVERIFY(expected.value("Sun") != nullptr);
+
+    std::atomic<int> failures { 0 };
+    QVector<int> threads(2 * QThread::idealThreadCount());
+    QtConcurrent::blockingMap(threads, [&](int)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            const QString &name = names[i % names.size()];
+            if (composite->findByName(name) != expected.value(name))
+                failures++;
+        }
+    });
+    QCOMPARE(failures.load(), 0);
+}
+
+void TestConjunctions::benchmarkSearch_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("parallel");
+
+    for (const int count : { 10, 100, 1000 })
+    {
+        // The solver takes too long with more objects
+        if (count <= 100)
+            QTest::newRow(QString("%1 asteroids solver").arg(count).toLatin1().constData()) << count << false;
+        QTest::newRow(QString("%1 asteroids search").arg(count).toLatin1().constData()) << count << true;
+    }
+}
+
+void TestConjunctions::benchmarkSearch()
+{
+    QFETCH(int, count);
+    QFETCH(bool, parallel);
+
+    const auto &asteroids = KStarsData::Instance()->skyComposite()->objectLists(SkyObject::ASTEROID);
+    if (asteroids.size() < count)
+        QSKIP("Not enough asteroids loaded");
+    const QVector<QPair<QString, const SkyObject *>> objects = asteroids.mid(0, count);
+
+    // Conjunctions of the asteroids with the Moon over a year
+    QBENCHMARK_ONCE
+    {
+        if (parallel)
+        {
+            search(objects, KSPlanetBase::MOON, dms(1.0), false);
+        }
+        else
+        {
+            for (const auto &object : objects)
+                solve(object.second, KSPlanetBase::MOON, dms(1.0), false);
+        }
+    }
+}
+
+QTEST_KSTARS_MAIN(TestConjunctions)
+
+#endif // HAVE_INDI
@@ -0,0 +1,37 @@
+/*  Conjunction search tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestConjunctions_H
+#define TestConjunctions_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestConjunctions : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestConjunctions(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testSameAsSolver_data();
+        void testSameAsSolver();
+        void testSeveralObjects();
+        void testFindByNameFromThreads();
+        void benchmarkSearch_data();
+        void benchmarkSearch();
+};
+
+#endif // HAVE_INDI
+#endif // TestConjunctions_H
@@ -15,6 +15,20 @@
 #include "test_ekos_mount.h"
 #include "Options.h"
 
+/** @brief Helper to configure a pipelined Linear 1 Pass autofocus, with steps large enough for the simulated
+ * focuser to still be moving to the anticipated position when the test acts.
+ */
+#define KTRY_FOCUS_CONFIGURE_PIPELINED() do { \
+    KTRY_FOCUS_SHOW(); \
+    KTRY_MOUNT_SYNC(60.0, true, -1); \
+    KTRY_FOCUS_MOVETO(35000); \
+    KTRY_FOCUS_CONFIGURE("SEP", "Linear 1 Pass", 0.0, 100.0, 30); \
+    KTRY_FOCUS_EXPOSURE(3, 99); \
+    KTRY_FOCUS_GADGET(QSpinBox, stepIN); \
+    stepIN->setValue(1000); \
+    KTRY_FOCUS_GADGET(QCheckBox, pipelineFocus); \
+    pipelineFocus->setChecked(true); } while (false)
+
 class KFocusProcedureSteps: public QObject
 {
 public:
@@ -597,6 +611,73 @@ void TestEkosFocus::testFocusOptions()
     }
 }
 
+void TestEkosFocus::testPipelinedFocusAbort()
+{
+    KTELL("Sync high on meridian to avoid jitter in CCD Simulator.\nConfigure a pipelined Linear 1 Pass autofocus.");
+    KTRY_FOCUS_CONFIGURE_PIPELINED();
+
+    KTRY_FOCUS_GADGET(QPushButton, startFocusB);
+    KTRY_FOCUS_GADGET(QLineEdit, absTicksLabel);
+    QTRY_VERIFY_WITH_TIMEOUT(startFocusB->isEnabled(), 1000);
+    Ekos::Focus * const focus = Ekos::Manager::Instance()->focusModule();
+
+    KFocusProcedureSteps autofocus;
+    volatile bool movingWhenAborted = true;
+    autofocus.aborting = connect(focus, &Ekos::Focus::autofocusAborted, &autofocus, [&]() {
+        autofocus.aborted = true;
+        autofocus.started = false;
+        movingWhenAborted = focus->isPipelinedMoveInProgress();
+    }, Qt::UniqueConnection);
+    QVERIFY(autofocus.aborting);
+
+    KTELL("Run autofocus, abort it while the focuser moves to the anticipated position.\nExpect the abort to complete once the focuser stopped.");
+    KTRY_FOCUS_CLICK(startFocusB);
+    QTRY_VERIFY_WITH_TIMEOUT(autofocus.started, 500);
+    QTRY_VERIFY_WITH_TIMEOUT(focus->isPipelinedMoveInProgress(), 60000);
+    focus->abort();
+    QTRY_VERIFY_WITH_TIMEOUT(autofocus.aborted, 20000);
+    QVERIFY(!movingWhenAborted);
+    QCOMPARE(focus->status(), Ekos::FOCUS_ABORTED);
+
+    KTELL("Expect the focuser to stay where it stopped.");
+    int const stopped = absTicksLabel->text().toInt();
+    QTest::qWait(2000);
+    QCOMPARE(absTicksLabel->text().toInt(), stopped);
+}
+
+void TestEkosFocus::testPipelinedFocusFailure()
+{
+    KTELL("Sync high on meridian to avoid jitter in CCD Simulator.\nConfigure a pipelined Linear 1 Pass autofocus.");
+    KTRY_FOCUS_CONFIGURE_PIPELINED();
+
+    KTRY_FOCUS_GADGET(QPushButton, startFocusB);
+    KTRY_FOCUS_GADGET(QLineEdit, absTicksLabel);
+    QTRY_VERIFY_WITH_TIMEOUT(startFocusB->isEnabled(), 1000);
+    Ekos::Focus * const focus = Ekos::Manager::Instance()->focusModule();
+
+    KFocusProcedureSteps autofocus;
+    volatile int restartPosition = -1;
+    autofocus.starting = connect(focus, &Ekos::Focus::autofocusStarting, &autofocus, [&]() {
+        if (autofocus.aborted)
+            restartPosition = absTicksLabel->text().toInt();
+        autofocus.started = true;
+    }, Qt::UniqueConnection);
+    QVERIFY(autofocus.starting);
+
+    KTELL("Run autofocus, fail it while the focuser moves to the anticipated position.\nExpect the focuser to return to its initial position before the retry starts.");
+    KTRY_FOCUS_CLICK(startFocusB);
+    QTRY_VERIFY_WITH_TIMEOUT(autofocus.started, 500);
+    QTRY_VERIFY_WITH_TIMEOUT(focus->isPipelinedMoveInProgress(), 60000);
+    focus->checkStopFocus(false);
+    QTRY_VERIFY_WITH_TIMEOUT(autofocus.aborted, 20000);
+    QTRY_VERIFY_WITH_TIMEOUT(restartPosition >= 0, 30000);
+    QCOMPARE(restartPosition, 35000);
+
+    KTELL("Stop the retry.");
+    focus->abort();
+    QTRY_VERIFY_WITH_TIMEOUT(focus->status() == Ekos::FOCUS_ABORTED, 20000);
+}
+
 void TestEkosFocus::testStarDetection_data()
 {
 #if QT_VERSION < 0x050900
@@ -157,6 +157,8 @@ private slots:
     void testFocusFailure();
     void testFocusOptions();
     void testFocusWhenMountFlips();
+    void testPipelinedFocusAbort();
+    void testPipelinedFocusFailure();
 
     void testStarDetection_data();
     void testStarDetection();
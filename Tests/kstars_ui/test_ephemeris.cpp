@@ -0,0 +1,247 @@
+/*  Ephemeris interpolation tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_ephemeris.h"
+
+#if defined(HAVE_INDI)
+
+#include "geolocation.h"
+#include "ksalmanac.h"
+#include "ksephemeris.h"
+#include "ksnumbers.h"
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skycomponents/skymapcomposite.h"
+#include "skyobjects/ksplanet.h"
+#include "test_ekos.h"
+
+#include <cmath>
+#include <memory>
+
+TestEphemeris::TestEphemeris(QObject *parent) : QObject(parent)
+{
+}
+
+void TestEphemeris::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+}
+
+void TestEphemeris::cleanupTestCase()
+{
+}
+
+namespace
+{
+// 2026-01-01 0h UT
+const long double startJD = 2461041.5;
+const long double stopJD  = startJD + 365;
+
+// Positions computed from the theory of the body, as SkyObject::recomputeCoords() does
+class Direct
+{
+    public:
+        Direct(int planet, const GeoLocation *geo)
+            : m_Body(KSPlanetBase::createPlanet(planet)),
+              m_Earth(i18n("Earth"), QString(), QColor("white"), 12756.28), m_Geo(geo)
+        {
+        }
+
+        SkyPoint position(long double jd)
+        {
+            KSNumbers num(jd);
+            CachingDms lst(m_Geo->GSTtoLST(KStarsDateTime(jd).gst()));
+            m_Earth.findPosition(&num);
+            m_Body->findPosition(&num, m_Geo->lat(), &lst, &m_Earth);
+            return SkyPoint(m_Body->ra(), m_Body->dec());
+        }
+
+        dms altitude(long double jd)
+        {
+            SkyPoint p = position(jd);
+            CachingDms lst(m_Geo->GSTtoLST(KStarsDateTime(jd).gst()));
+            p.EquatorialToHorizontal(&lst, m_Geo->lat());
+            return p.alt();
+        }
+
+        SkyObject::PositionFunction positions()
+        {
+            return [this](const KStarsDateTime & dt)
+            {
+                return position(dt.djd());
+            };
+        }
+
+    private:
+        std::unique_ptr<KSPlanetBase> m_Body;
+        KSPlanet m_Earth;
+        const GeoLocation *m_Geo;
+};
+
+// Difference between two times of the day in seconds, across midnight if shorter
+int difference(const QTime &t1, const QTime &t2)
+{
+    const int seconds = std::abs(t1.secsTo(t2));
+    return std::min(seconds, 86400 - seconds);
+}
+}  // namespace
+
+void TestEphemeris::testPositions_data()
+{
+    QTest::addColumn<int>("planet");
+    QTest::addColumn<double>("tolerance");
+
+    // Arcseconds, the Moon moves the fastest but has the finest grid
+    QTest::newRow("Sun") << int(KSPlanetBase::SUN) << 3.0;
+    QTest::newRow("Moon") << int(KSPlanetBase::MOON) << 3.0;
+    QTest::newRow("Mercury") << int(KSPlanetBase::MERCURY) << 5.0;
+    QTest::newRow("Venus") << int(KSPlanetBase::VENUS) << 5.0;
+    QTest::newRow("Mars") << int(KSPlanetBase::MARS) << 5.0;
+    QTest::newRow("Jupiter") << int(KSPlanetBase::JUPITER) << 5.0;
+}
+
+void TestEphemeris::testPositions()
+{
+    QFETCH(int, planet);
+    QFETCH(double, tolerance);
+
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+    const KSEphemeris::TablePtr table = KSEphemeris::Instance()->table(planet, geo, startJD, stopJD);
+    QVERIFY(table->covers(startJD, stopJD));
+    QCOMPARE(table->planet(), planet);
+
+    // Samples that are not on the grid
+    Direct direct(planet, geo);
+    double worst = 0;
+    for (long double jd = startJD; jd <= stopJD; jd += 0.37)
+    {
+        const SkyPoint expected = direct.position(jd);
+        const SkyPoint actual   = table->position(jd);
+        worst = std::max(worst, actual.angularDistanceTo(&expected).Degrees() * 3600);
+    }
+    QVERIFY2(worst < tolerance, qPrintable(QString("Error up to %1\"").arg(worst)));
+
+    // The same table is served for a smaller range
+    QCOMPARE(KSEphemeris::Instance()->table(planet, geo, startJD + 10, startJD + 20), table);
+}
+
+void TestEphemeris::testRiseSetTransit_data()
+{
+    QTest::addColumn<int>("planet");
+
+    QTest::newRow("Sun") << int(KSPlanetBase::SUN);
+    QTest::newRow("Moon") << int(KSPlanetBase::MOON);
+    QTest::newRow("Venus") << int(KSPlanetBase::VENUS);
+    QTest::newRow("Saturn") << int(KSPlanetBase::SATURN);
+}
+
+void TestEphemeris::testRiseSetTransit()
+{
+    QFETCH(int, planet);
+
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+    const KSPlanetBase *body = KStarsData::Instance()->skyComposite()->planet(planet);
+    QVERIFY(body != nullptr);
+
+    // Same range and times as the sky calendar
+    const KSEphemeris::TablePtr table = KSEphemeris::Instance()->table(planet, geo, startJD - 2, stopJD + 2);
+    const SkyObject::PositionFunction interpolated = table->positions();
+    Direct direct(planet, geo);
+    const SkyObject::PositionFunction computed = direct.positions();
+
+    for (KStarsDateTime kdt(QDate(2026, 1, 1), QTime(12, 0, 0)); kdt.date().year() == 2026; kdt = kdt.addDays(7))
+    {
+        for (const bool rise : { true, false })
+        {
+            const QTime expected = body->riseSetTime(kdt, geo, rise, true, computed);
+            const QTime actual   = body->riseSetTime(kdt, geo, rise, true, interpolated);
+            QCOMPARE(actual.isValid(), expected.isValid());
+            if (expected.isValid())
+                QVERIFY2(difference(actual, expected) <= 60,
+                         qPrintable(QString("%1 %2: %3 instead of %4").arg(kdt.date().toString(Qt::ISODate),
+                                    rise ? "rise" : "set", actual.toString(), expected.toString())));
+        }
+
+        const QTime expected = body->transitTime(kdt, geo, computed);
+        const QTime actual   = body->transitTime(kdt, geo, interpolated);
+        QVERIFY2(difference(actual, expected) <= 60,
+                 qPrintable(QString("%1 transit: %2 instead of %3").arg(kdt.date().toString(Qt::ISODate),
+                            actual.toString(), expected.toString())));
+        QVERIFY(std::fabs(body->transitAltitude(kdt, geo, interpolated).Degrees() -
+                          body->transitAltitude(kdt, geo, computed).Degrees()) < 0.05);
+    }
+}
+
+void TestEphemeris::testDawnDusk()
+{
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+    Direct sun(KSPlanetBase::SUN, geo);
+
+    // The almanac samples the altitude every 3 minutes, the Sun moves by less than a degree meanwhile
+    for (int day = 0; day < 365; day += 11)
+    {
+        const KStarsDateTime midnight = geo->LTtoUT(KStarsDateTime(QDate(2026, 1, 1).addDays(day), QTime(0, 0, 0)));
+        KSAlmanac almanac(midnight, geo);
+        if (almanac.getSunMinAlt() > -18 || almanac.getSunMaxAlt() < -18)
+            continue;
+
+        const double dawn = sun.altitude(midnight.djd() + almanac.getDawnAstronomicalTwilight()).Degrees();
+        const double dusk = sun.altitude(midnight.djd() + almanac.getDuskAstronomicalTwilight()).Degrees();
+        QVERIFY2(std::fabs(dawn + 18) < 0.5, qPrintable(QString("Sun at %1 at dawn").arg(dawn)));
+        QVERIFY2(std::fabs(dusk + 18) < 0.5, qPrintable(QString("Sun at %1 at dusk").arg(dusk)));
+    }
+}
+
+void TestEphemeris::benchmarkCalendar_data()
+{
+    QTest::addColumn<bool>("interpolated");
+
+    QTest::newRow("computed") << false;
+    QTest::newRow("interpolated") << true;
+}
+
+void TestEphemeris::benchmarkCalendar()
+{
+    QFETCH(bool, interpolated);
+
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+
+    // The events of the sky calendar for a year, the tables computed within the benchmark
+    KSEphemeris::Instance()->clear();
+    QBENCHMARK_ONCE
+    {
+        for (int planet = KSPlanetBase::MERCURY; planet <= KSPlanetBase::NEPTUNE; ++planet)
+        {
+            const KSPlanetBase *body = KStarsData::Instance()->skyComposite()->planet(planet);
+            KSEphemeris::TablePtr table;
+            if (interpolated)
+                table = KSEphemeris::Instance()->table(planet, geo, startJD - 2, stopJD + 2);
+
+            for (KStarsDateTime kdt(QDate(2026, 1, 1), QTime(12, 0, 0)); kdt.date().year() == 2026;
+                    kdt = kdt.addDays(1))
+            {
+                if (interpolated)
+                {
+                    body->riseSetTime(kdt, geo, true, true, table->positions());
+                    body->riseSetTime(kdt, geo, false, true, table->positions());
+                    body->transitTime(kdt, geo, table->positions());
+                }
+                else
+                {
+                    body->riseSetTime(kdt, geo, true, true);
+                    body->riseSetTime(kdt, geo, false, true);
+                    body->transitTime(kdt, geo);
+                }
+            }
+        }
+    }
+}
+
+QTEST_KSTARS_MAIN(TestEphemeris)
+
+#endif // HAVE_INDI
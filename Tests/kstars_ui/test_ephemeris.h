@@ -0,0 +1,38 @@
+/*  Ephemeris interpolation tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestEphemeris_H
+#define TestEphemeris_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestEphemeris : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestEphemeris(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testPositions_data();
+        void testPositions();
+        void testRiseSetTransit_data();
+        void testRiseSetTransit();
+        void testDawnDusk();
+        void benchmarkCalendar_data();
+        void benchmarkCalendar();
+};
+
+#endif // HAVE_INDI
+#endif // TestEphemeris_H
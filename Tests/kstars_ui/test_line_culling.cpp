@@ -0,0 +1,201 @@
+/*  Culled line drawing tests and frame benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_line_culling.h"
+
+#if defined(HAVE_INDI)
+
+#include <QImage>
+
+#include <algorithm>
+
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skymap.h"
+#include "skyqpainter.h"
+#include "skycomponents/constellationboundarylines.h"
+#include "skycomponents/constellationlines.h"
+#include "skycomponents/ecliptic.h"
+#include "skycomponents/equator.h"
+#include "skycomponents/equatorialcoordinategrid.h"
+#include "skycomponents/milkyway.h"
+#include "skycomponents/skymapcomposite.h"
+#include "skycomponents/skymesh.h"
+#include "test_ekos.h"
+
+TestLineCulling::TestLineCulling(QObject *parent) : QObject(parent)
+{
+}
+
+void TestLineCulling::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+
+    m_SavedZoom    = Options::zoomFactor();
+    m_SavedOptions = { Options::showCLines(), Options::showCBounds(), Options::showEcliptic(),
+                       Options::showEquator(), Options::showEquatorialGrid(), Options::showMilkyWay()
+                     };
+
+    Options::setShowCLines(true);
+    Options::setShowCBounds(true);
+    Options::setShowEcliptic(true);
+    Options::setShowEquator(true);
+    Options::setShowEquatorialGrid(true);
+    Options::setShowMilkyWay(true);
+}
+
+void TestLineCulling::cleanupTestCase()
+{
+    Options::setShowCLines(m_SavedOptions[0]);
+    Options::setShowCBounds(m_SavedOptions[1]);
+    Options::setShowEcliptic(m_SavedOptions[2]);
+    Options::setShowEquator(m_SavedOptions[3]);
+    Options::setShowEquatorialGrid(m_SavedOptions[4]);
+    Options::setShowMilkyWay(m_SavedOptions[5]);
+    SkyMap::Instance()->setZoomFactor(m_SavedZoom);
+}
+
+namespace
+{
+// Points the map at the celestial equator in the south at the requested zoom, and waits for the frame to be drawn
+void pointMap(double zoom)
+{
+    SkyMap *map = SkyMap::Instance();
+    map->setFocusAltAz(dms(90 - KStarsData::Instance()->geo()->lat()->Degrees()), dms(180));
+    map->setDestination(*map->focus());
+    map->setZoomFactor(zoom);
+    map->forceUpdate(true);
+    QTest::qWait(100);
+}
+
+// Draws the line components over the trixels within @p radius of the focus, as SkyMapComposite::draw() does
+QImage drawLines(double radius)
+{
+    SkyMap *map = SkyMap::Instance();
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    SkyMesh *mesh = SkyMesh::Instance();
+
+    QImage image(map->size(), QImage::Format_ARGB32);
+    image.fill(Qt::black);
+
+    SkyQPainter painter(map, &image);
+    painter.begin();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    mesh->inDraw(true);
+    mesh->aperture(map->focus(), radius, DRAW_BUF);
+    mesh->index(map->focus(), radius, NO_PRECESS_BUF);
+    composite->milkyWay()->draw(&painter);
+    composite->equatorialCoordGrid()->draw(&painter);
+    composite->constellationBoundary()->draw(&painter);
+    composite->constellationLines()->draw(&painter);
+    composite->equator()->draw(&painter);
+    composite->ecliptic()->draw(&painter);
+    mesh->inDraw(false);
+
+    painter.end();
+    return image;
+}
+
+// The radius of the aperture of SkyMapComposite::draw()
+double drawRadius()
+{
+    return std::min(180.0, double(SkyMap::Instance()->projector()->fov())) + 1.0;
+}
+
+void addZoomRows()
+{
+    QTest::addColumn<double>("zoom");
+
+    for (const double zoom : { 250.0, 1000.0, 4000.0, 16000.0, 64000.0 })
+        QTest::newRow(QString("zoom %1").arg(zoom).toLatin1().constData()) << zoom;
+}
+}  // namespace
+
+void TestLineCulling::testCulledLines_data()
+{
+    addZoomRows();
+}
+
+// Drawing the lines of the visible trixels only must draw the same pixels as drawing all of them
+void TestLineCulling::testCulledLines()
+{
+    QFETCH(double, zoom);
+
+    pointMap(zoom);
+
+    // Force the update of all the lines, then of the visible ones
+    KStarsData::Instance()->incUpdateID();
+    const QImage all = drawLines(180.0);
+    KStarsData::Instance()->incUpdateID();
+    const QImage culled = drawLines(drawRadius());
+
+    QCOMPARE(culled.size(), all.size());
+    int drawn = 0, different = 0;
+    for (int y = 0; y < all.height(); ++y)
+    {
+        const QRgb *a = reinterpret_cast<const QRgb *>(all.constScanLine(y));
+        const QRgb *c = reinterpret_cast<const QRgb *>(culled.constScanLine(y));
+        for (int x = 0; x < all.width(); ++x)
+        {
+            drawn += a[x] != qRgb(0, 0, 0);
+            different += a[x] != c[x];
+        }
+    }
+    QVERIFY(drawn > 0);
+    QVERIFY2(different == 0, qPrintable(QString("%1 of %2 pixels differ").arg(different).arg(drawn)));
+}
+
+void TestLineCulling::benchmarkLines_data()
+{
+    addZoomRows();
+}
+
+// The line components after every clock tick, the lists being updated before they are drawn
+void TestLineCulling::benchmarkLines()
+{
+    QFETCH(double, zoom);
+
+    pointMap(zoom);
+
+    const double radius = drawRadius();
+    QBENCHMARK
+    {
+        KStarsData::Instance()->incUpdateID();
+        drawLines(radius);
+    }
+}
+
+void TestLineCulling::benchmarkFrame_data()
+{
+    addZoomRows();
+}
+
+// The whole sky map after every clock tick, as exported
+void TestLineCulling::benchmarkFrame()
+{
+    QFETCH(double, zoom);
+
+    pointMap(zoom);
+
+    SkyMap *map = SkyMap::Instance();
+    QImage image(map->size(), QImage::Format_ARGB32);
+    QBENCHMARK
+    {
+        KStarsData::Instance()->incUpdateID();
+        SkyQPainter painter(map, &image);
+        painter.begin();
+        painter.drawSkyBackground();
+        KStarsData::Instance()->skyComposite()->draw(&painter);
+        painter.end();
+    }
+}
+
+QTEST_KSTARS_MAIN(TestLineCulling)
+
+#endif // HAVE_INDI
@@ -0,0 +1,41 @@
+/*  Culled line drawing tests and frame benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestLineCulling_H
+#define TestLineCulling_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestLineCulling : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestLineCulling(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testCulledLines_data();
+        void testCulledLines();
+        void benchmarkLines_data();
+        void benchmarkLines();
+        void benchmarkFrame_data();
+        void benchmarkFrame();
+
+    private:
+        double m_SavedZoom { 0 };
+        QList<bool> m_SavedOptions;
+};
+
+#endif // HAVE_INDI
+#endif // TestLineCulling_H
@@ -0,0 +1,148 @@
+/*  Sky map picking benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_picking_index.h"
+
+#if defined(HAVE_INDI)
+
+#include <QRandomGenerator>
+
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skymap.h"
+#include "skycomponents/pickingindex.h"
+#include "skycomponents/skymapcomposite.h"
+#include "test_ekos.h"
+
+TestPickingIndex::TestPickingIndex(QObject *parent) : QObject(parent)
+{
+}
+
+void TestPickingIndex::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+
+    m_SavedZoom = Options::zoomFactor();
+}
+
+void TestPickingIndex::cleanupTestCase()
+{
+    SkyMap::Instance()->setZoomFactor(m_SavedZoom);
+}
+
+namespace
+{
+// Points the map high in the southern sky at the requested zoom, and waits for the frame to be drawn
+bool drawFrame(double zoom)
+{
+    SkyMap *map = SkyMap::Instance();
+    map->setFocusAltAz(dms(45), dms(180));
+    map->setDestination(*map->focus());
+    map->setZoomFactor(zoom);
+    map->forceUpdate(true);
+    QTest::qWait(100);
+
+    SkyPoint center = map->projector()->fromScreen(QPointF(map->width() / 2.0, map->height() / 2.0),
+                      KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
+    return PickingIndex::Instance()->covers(&center, 0, map->projector());
+}
+
+// Random points in the central half of the map, as the mouse would hover them
+QList<SkyPoint> hoverPoints(int count)
+{
+    SkyMap *map = SkyMap::Instance();
+    KStarsData *data = KStarsData::Instance();
+    QRandomGenerator rng(42);
+    QList<SkyPoint> points;
+    for (int i = 0; i < count; ++i)
+    {
+        const QPointF pos(map->width() * (0.25 + 0.5 * rng.generateDouble()),
+                          map->height() * (0.25 + 0.5 * rng.generateDouble()));
+        points.append(map->projector()->fromScreen(pos, data->lst(), data->geo()->lat()));
+    }
+    return points;
+}
+
+void addZoomRows()
+{
+    QTest::addColumn<double>("zoom");
+
+    for (const double zoom : { 250.0, 1000.0, 4000.0, 16000.0, 64000.0 })
+        QTest::newRow(QString("zoom %1").arg(zoom).toLatin1().constData()) << zoom;
+}
+}  // namespace
+
+void TestPickingIndex::testIndexedNearest_data()
+{
+    addZoomRows();
+}
+
+// The index only holds drawn objects, so whenever it finds one the component search must find one too.
+// Neither may return an object farther than the search radius.
+void TestPickingIndex::testIndexedNearest()
+{
+    QFETCH(double, zoom);
+
+    QVERIFY(drawFrame(zoom));
+    QVERIFY(PickingIndex::Instance()->size() > 0);
+
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    for (auto point : hoverPoints(200))
+    {
+        const double maxrad = 1000.0 / zoom;
+
+        double indexedRadius = maxrad;
+        SkyObject *indexed = composite->objectNearest(&point, indexedRadius);
+        double searchedRadius = maxrad;
+        SkyObject *searched = composite->objectNearestInComponents(&point, searchedRadius);
+
+        if (indexed)
+        {
+            QVERIFY(searched);
+            QVERIFY(indexed->angularDistanceTo(&point).Degrees() < maxrad);
+        }
+    }
+}
+
+void TestPickingIndex::benchmarkHover_data()
+{
+    QTest::addColumn<double>("zoom");
+    QTest::addColumn<bool>("indexed");
+
+    for (const double zoom : { 250.0, 1000.0, 4000.0, 16000.0, 64000.0 })
+    {
+        QTest::newRow(QString("zoom %1 components").arg(zoom).toLatin1().constData()) << zoom << false;
+        QTest::newRow(QString("zoom %1 index").arg(zoom).toLatin1().constData()) << zoom << true;
+    }
+}
+
+void TestPickingIndex::benchmarkHover()
+{
+    QFETCH(double, zoom);
+    QFETCH(bool, indexed);
+
+    QVERIFY(drawFrame(zoom));
+
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    QList<SkyPoint> points = hoverPoints(100);
+    QBENCHMARK
+    {
+        for (auto &point : points)
+        {
+            double maxrad = 1000.0 / zoom;
+            if (indexed)
+                composite->objectNearest(&point, maxrad);
+            else
+                composite->objectNearestInComponents(&point, maxrad);
+        }
+    }
+}
+
+QTEST_KSTARS_MAIN(TestPickingIndex)
+
+#endif // HAVE_INDI
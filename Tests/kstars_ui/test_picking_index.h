@@ -0,0 +1,38 @@
+/*  Sky map picking benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestPickingIndex_H
+#define TestPickingIndex_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestPickingIndex : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestPickingIndex(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testIndexedNearest_data();
+        void testIndexedNearest();
+        void benchmarkHover_data();
+        void benchmarkHover();
+
+    private:
+        double m_SavedZoom { 0 };
+};
+
+#endif // HAVE_INDI
+#endif // TestPickingIndex_H
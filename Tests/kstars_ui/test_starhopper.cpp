@@ -0,0 +1,111 @@
+/*  Star hopper tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_starhopper.h"
+
+#if defined(HAVE_INDI)
+
+#include "kstars_ui_tests.h"
+#include "skyobjects/starobject.h"
+#include "test_ekos.h"
+#include "tools/starhopper.h"
+
+#include <memory>
+
+TestStarHopper::TestStarHopper(QObject *parent) : QObject(parent)
+{
+}
+
+void TestStarHopper::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+}
+
+void TestStarHopper::cleanupTestCase()
+{
+}
+
+namespace
+{
+// Hops southwards from Lyra, across the Milky Way
+SkyPoint source()
+{
+    return SkyPoint(dms(285.0), dms(35.0));
+}
+
+SkyPoint destination(double distance)
+{
+    return SkyPoint(dms(285.0), dms(35.0 - distance));
+}
+}  // namespace
+
+void TestStarHopper::testPath_data()
+{
+    QTest::addColumn<double>("distance");
+    QTest::addColumn<double>("fov");
+    QTest::addColumn<double>("maglim");
+
+    QTest::newRow("5 degrees") << 5.0 << 2.0 << 8.0;
+    QTest::newRow("20 degrees") << 20.0 << 3.0 << 7.0;
+    QTest::newRow("40 degrees") << 40.0 << 5.0 << 6.0;
+}
+
+void TestStarHopper::testPath()
+{
+    QFETCH(double, distance);
+    QFETCH(double, fov);
+    QFETCH(double, maglim);
+
+    const SkyPoint src = source(), dest = destination(distance);
+    StarHopper hopper;
+    QStringList directions;
+    std::unique_ptr<QList<StarObject *>> path(hopper.computePath(src, dest, fov, maglim, &directions));
+    QVERIFY(!path->isEmpty());
+    QCOMPARE(directions.size(), path->size());
+
+    // Every hop stays within a field of view, with stars bright enough
+    const SkyPoint *previous = &src;
+    for (const StarObject *star : *path)
+    {
+        QVERIFY(star->mag() <= maglim);
+        QVERIFY(previous->angularDistanceTo(star).Degrees() <= fov + 1e-3);
+        previous = star;
+    }
+
+    // The search stops on a star within half a field of view of the destination, which is left out of the path.
+    // That star is a hop of at most a field of view from the last one, so the destination is within one and a half.
+    QVERIFY(previous->angularDistanceTo(&dest).Degrees() <= 1.5 * fov + 1e-3);
+}
+
+void TestStarHopper::benchmarkPath_data()
+{
+    QTest::addColumn<double>("distance");
+    QTest::addColumn<double>("maglim");
+
+    for (const double distance : { 5.0, 20.0, 40.0 })
+        for (const double maglim : { 6.0, 8.0, 10.0, 12.0 })
+            QTest::newRow(QString("%1 degrees to mag %2").arg(distance).arg(maglim).toLatin1().constData())
+                    << distance << maglim;
+}
+
+void TestStarHopper::benchmarkPath()
+{
+    QFETCH(double, distance);
+    QFETCH(double, maglim);
+
+    // A finder field of view
+    const SkyPoint src = source(), dest = destination(distance);
+    StarHopper hopper;
+    QBENCHMARK
+    {
+        std::unique_ptr<QList<StarObject *>> path(hopper.computePath(src, dest, 3.0, maglim));
+    }
+}
+
+QTEST_KSTARS_MAIN(TestStarHopper)
+
+#endif // HAVE_INDI
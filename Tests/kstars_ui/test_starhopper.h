@@ -0,0 +1,35 @@
+/*  Star hopper tests and benchmark
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestStarHopper_H
+#define TestStarHopper_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QtTest>
+
+class TestStarHopper : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestStarHopper(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testPath_data();
+        void testPath();
+        void benchmarkPath_data();
+        void benchmarkPath();
+};
+
+#endif // HAVE_INDI
+#endif // TestStarHopper_H
@@ -0,0 +1,260 @@
+/*  Terrain rendering tests and benchmarks
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_terrain_renderer.h"
+
+#if defined(HAVE_INDI)
+
+#include <QImage>
+#include <memory>
+
+#include "kstars_ui_tests.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "projections/azimuthalequidistantprojector.h"
+#include "projections/equirectangularprojector.h"
+#include "projections/gnomonicprojector.h"
+#include "projections/lambertprojector.h"
+#include "projections/orthographicprojector.h"
+#include "projections/stereographicprojector.h"
+#include "terrain/terrainrenderer.h"
+#include "test_ekos.h"
+
+TestTerrainRenderer::TestTerrainRenderer(QObject *parent) : QObject(parent)
+{
+}
+
+void TestTerrainRenderer::initTestCase()
+{
+    // HACK: Reset clock to initial conditions
+    KHACK_RESET_EKOS_TIME();
+
+    // A synthetic 360x180 degree panorama: opaque ground with some structure below the horizon,
+    // and a partially transparent band of "trees" above it.
+    QImage panorama(4096, 2048, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < panorama.height(); ++y)
+        for (int x = 0; x < panorama.width(); ++x)
+        {
+            const int alpha = y > 1024 ? 255 : (y > 900 && (x / 16) % 3 == 0 ? 200 : 0);
+            panorama.setPixel(x, y, qPremultiply(qRgba(x % 256, y % 256, 64, alpha)));
+        }
+    QVERIFY(m_TempDir.isValid());
+    const QString filename = m_TempDir.filePath("terrain.png");
+    QVERIFY(panorama.save(filename));
+
+    m_SavedTerrainSource = Options::terrainSource();
+    Options::setTerrainSource(filename);
+}
+
+void TestTerrainRenderer::cleanupTestCase()
+{
+    Options::setTerrainSource(m_SavedTerrainSource);
+}
+
+namespace
+{
+std::unique_ptr<Projector> makeProjector(Projector::Projection type, const ViewParams &vp)
+{
+    switch (type)
+    {
+        case Projector::Lambert:
+            return std::unique_ptr<Projector>(new LambertProjector(vp));
+        case Projector::AzimuthalEquidistant:
+            return std::unique_ptr<Projector>(new AzimuthalEquidistantProjector(vp));
+        case Projector::Orthographic:
+            return std::unique_ptr<Projector>(new OrthographicProjector(vp));
+        case Projector::Equirectangular:
+            return std::unique_ptr<Projector>(new EquirectangularProjector(vp));
+        case Projector::Stereographic:
+            return std::unique_ptr<Projector>(new StereographicProjector(vp));
+        case Projector::Gnomonic:
+        default:
+            return std::unique_ptr<Projector>(new GnomonicProjector(vp));
+    }
+}
+
+// Points the view at az, alt. The renderer compares the equatorial coordinates
+// of the focus between frames, so they need to be kept in sync.
+void setFocus(SkyPoint *focus, double az, double alt)
+{
+    focus->setAz(az);
+    focus->setAlt(alt);
+    focus->HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
+}
+
+void addRenderRows()
+{
+    QTest::addColumn<int>("projection");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    const QList<Projector::Projection> projections =
+    {
+        Projector::Lambert, Projector::AzimuthalEquidistant, Projector::Orthographic,
+        Projector::Equirectangular, Projector::Stereographic, Projector::Gnomonic
+    };
+    for (const auto projection : projections)
+    {
+        const QString name = QMetaEnum::fromType<Projector::Projection>().valueToKey(projection);
+        QTest::newRow(QString("%1 1080p").arg(name).toLatin1().constData()) << static_cast<int>(projection) << 1920 << 1080;
+        QTest::newRow(QString("%1 4K").arg(name).toLatin1().constData()) << static_cast<int>(projection) << 3840 << 2160;
+    }
+}
+
+// Renders the view at az, alt and zoom with the lookup left by the previous frames
+bool renderView(QImage *image, Projector::Projection projection, int width, int height, double az, double alt,
+                double zoom)
+{
+    SkyPoint focus;
+    setFocus(&focus, az, alt);
+    ViewParams vp;
+    vp.width = width;
+    vp.height = height;
+    vp.zoomFactor = zoom;
+    vp.useAltAz = true;
+    vp.useRefraction = false;
+    vp.fillGround = false;
+    vp.focus = &focus;
+    auto proj = makeProjector(projection, vp);
+    return TerrainRenderer::Instance()->render(width, height, image, proj.get());
+}
+}  // namespace
+
+void TestTerrainRenderer::testIncrementalRender_data()
+{
+    QTest::addColumn<int>("projection");
+
+    const QList<Projector::Projection> projections =
+    {
+        Projector::Lambert, Projector::AzimuthalEquidistant, Projector::Orthographic,
+        Projector::Equirectangular, Projector::Stereographic, Projector::Gnomonic
+    };
+    for (const auto projection : projections)
+        QTest::newRow(QMetaEnum::fromType<Projector::Projection>().valueToKey(projection)) << static_cast<int>(projection);
+}
+
+// Pans and zooms re-use the lookup of the previous frames, the last frame must be the one a fresh render gives.
+void TestTerrainRenderer::testIncrementalRender()
+{
+    QFETCH(int, projection);
+    const auto type = static_cast<Projector::Projection>(projection);
+    const int width = 800, height = 600;
+
+    QImage incremental(width, height, QImage::Format_ARGB32_Premultiplied);
+    double az = 340, alt = 20, zoom = 1000;
+    QVERIFY(renderView(&incremental, type, width, height, az, alt, zoom));
+    // Pans in azimuth across north, a zoom, an altitude change, then pans again
+    for (int i = 0; i < 30; i++)
+    {
+        az = az + 0.7 >= 360 ? az + 0.7 - 360 : az + 0.7;
+        QVERIFY(renderView(&incremental, type, width, height, az, alt, zoom));
+    }
+    zoom = 1500;
+    QVERIFY(renderView(&incremental, type, width, height, az, alt, zoom));
+    alt = 25;
+    QVERIFY(renderView(&incremental, type, width, height, az, alt, zoom));
+    for (int i = 0; i < 30; i++)
+    {
+        az = az - 1.3 < 0 ? az - 1.3 + 360 : az - 1.3;
+        QVERIFY(renderView(&incremental, type, width, height, az, alt, zoom));
+    }
+
+    // Another size drops the lookup, so that the same view is then computed from scratch
+    QImage fresh(width / 2, height / 2, QImage::Format_ARGB32_Premultiplied);
+    QVERIFY(renderView(&fresh, type, width / 2, height / 2, az, alt, zoom));
+    fresh = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+    QVERIFY(renderView(&fresh, type, width, height, az, alt, zoom));
+
+    // The shifted azimuths differ from the projected ones by float rounding only,
+    // which may move a few pixels to the neighbouring pixel of the panorama
+    QCOMPARE(incremental.size(), fresh.size());
+    int different = 0;
+    for (int y = 0; y < height; y++)
+    {
+        const QRgb *a = reinterpret_cast<const QRgb *>(incremental.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(fresh.constScanLine(y));
+        for (int x = 0; x < width; x++)
+            if (a[x] != b[x])
+                different++;
+    }
+    QVERIFY2(different <= width * height / 1000, qPrintable(QString("%1 pixels differ").arg(different)));
+}
+
+void TestTerrainRenderer::benchmarkRender_data()
+{
+    addRenderRows();
+}
+
+// Every frame moves the view in altitude, so the alt/az lookup is recomputed.
+void TestTerrainRenderer::benchmarkRender()
+{
+    QFETCH(int, projection);
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    SkyPoint focus;
+    setFocus(&focus, 180, 20);
+    ViewParams vp;
+    vp.width = width;
+    vp.height = height;
+    vp.zoomFactor = 1000;
+    vp.useAltAz = true;
+    vp.useRefraction = false;
+    vp.fillGround = false;
+    vp.focus = &focus;
+    auto proj = makeProjector(static_cast<Projector::Projection>(projection), vp);
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    TerrainRenderer *renderer = TerrainRenderer::Instance();
+    double alt = 20;
+    QBENCHMARK
+    {
+        alt = alt > 30 ? 20 : alt + 0.1;
+        setFocus(&focus, 180, alt);
+        proj->setViewParams(vp);
+        QVERIFY(renderer->render(width, height, &image, proj.get()));
+    }
+}
+
+void TestTerrainRenderer::benchmarkAzimuthPan_data()
+{
+    addRenderRows();
+}
+
+// Every frame pans the view in azimuth only, which lets the renderer shift its lookup.
+void TestTerrainRenderer::benchmarkAzimuthPan()
+{
+    QFETCH(int, projection);
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    SkyPoint focus;
+    setFocus(&focus, 180, 20);
+    ViewParams vp;
+    vp.width = width;
+    vp.height = height;
+    vp.zoomFactor = 1000;
+    vp.useAltAz = true;
+    vp.useRefraction = false;
+    vp.fillGround = false;
+    vp.focus = &focus;
+    auto proj = makeProjector(static_cast<Projector::Projection>(projection), vp);
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    TerrainRenderer *renderer = TerrainRenderer::Instance();
+    double az = 180;
+    QBENCHMARK
+    {
+        az = az >= 359 ? 0 : az + 0.5;
+        setFocus(&focus, az, 20);
+        proj->setViewParams(vp);
+        QVERIFY(renderer->render(width, height, &image, proj.get()));
+    }
+}
+
+QTEST_KSTARS_MAIN(TestTerrainRenderer)
+
+#endif // HAVE_INDI
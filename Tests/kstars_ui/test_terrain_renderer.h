@@ -0,0 +1,43 @@
+/*  Terrain rendering tests and benchmarks
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TestTerrainRenderer_H
+#define TestTerrainRenderer_H
+
+#include "config-kstars.h"
+
+#if defined(HAVE_INDI)
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class TestTerrainRenderer : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit TestTerrainRenderer(QObject *parent = nullptr);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testIncrementalRender_data();
+        void testIncrementalRender();
+
+        void benchmarkRender_data();
+        void benchmarkRender();
+        void benchmarkAzimuthPan_data();
+        void benchmarkAzimuthPan();
+
+    private:
+        QTemporaryDir m_TempDir;
+        QString m_SavedTerrainSource;
+};
+
+#endif // HAVE_INDI
+#endif // TestTerrainRenderer_H
@@ -0,0 +1,422 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_nameindex.h"
+
+#include "skycomponents/nameindex.h"
+#include "skyobjects/skyobject.h"
+
+#include <QRandomGenerator>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+// Names in the style of the asteroid list: numbered names and provisional designations
+NameIndex::NameList randomNames(int count, quint32 seed)
+{
+    static const QString letters = QStringLiteral("abcdefghijklmnopqrstuvwxyz");
+    QRandomGenerator rng(seed);
+    NameIndex::NameList names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        QString name;
+        if (rng.bounded(3) == 0)
+        {
+            name = QString("%1 %2%3%4").arg(1900 + rng.bounded(125)).arg(letters[rng.bounded(26)].toUpper())
+                   .arg(letters[rng.bounded(26)].toUpper()).arg(rng.bounded(200));
+        }
+        else
+        {
+            const int length = 3 + rng.bounded(9);
+            for (int j = 0; j < length; ++j)
+                name.append(j == 0 ? letters[rng.bounded(26)].toUpper() : letters[rng.bounded(26)]);
+            if (rng.bounded(4) == 0)
+                name = QString("%1 %2").arg(name).arg(rng.bounded(1000));
+        }
+        // The index never looks at the objects, the benchmarks do without them
+        names.append({ name, nullptr });
+    }
+    return names;
+}
+
+// Same names with one character replaced, removed or inserted
+QString typo(const QString &name, QRandomGenerator &rng)
+{
+    QString result = name;
+    const int position = rng.bounded(result.size());
+    switch (rng.bounded(3))
+    {
+        case 0:
+            result[position] = QChar('x');
+            break;
+        case 1:
+            result.remove(position, 1);
+            break;
+        default:
+            result.insert(position, QChar('q'));
+            break;
+    }
+    return result;
+}
+
+QStringList matchedNames(const QVector<NameIndex::Match> &matches)
+{
+    QStringList names;
+    for (const auto &match : matches)
+        names.append(match.name);
+    names.sort();
+    return names;
+}
+
+int levenshtein(const QString &a, const QString &b)
+{
+    std::vector<int> row(b.size() + 1), next(b.size() + 1);
+    for (int j = 0; j <= b.size(); ++j)
+        row[j] = j;
+    for (int i = 1; i <= a.size(); ++i)
+    {
+        next[0] = i;
+        for (int j = 1; j <= b.size(); ++j)
+            next[j] = std::min({ row[j] + 1, next[j - 1] + 1, row[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0) });
+        row.swap(next);
+    }
+    return row.back();
+}
+}  // namespace
+
+TestNameIndex::TestNameIndex() : QObject()
+{
+}
+
+void TestNameIndex::testNormalize_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("key");
+
+    QTest::newRow("spaces") << "M 31" << "m31";
+    QTest::newRow("case") << "Andromeda Galaxy" << "andromedagalaxy";
+    QTest::newRow("designation") << "C/2020 F3 (NEOWISE)" << "c/2020f3(neowise)";
+    QTest::newRow("empty") << "" << "";
+}
+
+void TestNameIndex::testNormalize()
+{
+    QFETCH(QString, name);
+    QFETCH(QString, key);
+
+    QCOMPARE(NameIndex::normalize(name), key);
+}
+
+void TestNameIndex::testQueries()
+{
+    SkyObject andromeda(SkyObject::GALAXY, 0.0, 0.0, 3.4, "M 31", QString(), "Andromeda Galaxy");
+    SkyObject triangulum(SkyObject::GALAXY, 0.0, 0.0, 5.7, "M 33", QString(), "Triangulum Galaxy");
+    SkyObject mars(SkyObject::PLANET, 0.0, 0.0, 0.0, "Mars");
+    SkyObject comet(SkyObject::COMET, 0.0, 0.0, 0.0, "C/2020 F3 (NEOWISE)");
+
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::GALAXY] = { { "M 31", &andromeda }, { "Andromeda Galaxy", &andromeda }, { "M 33", &triangulum },
+        { "Triangulum Galaxy", &triangulum }
+    };
+    lists[SkyObject::PLANET] = { { "Mars", &mars } };
+    lists[SkyObject::COMET]  = { { "C/2020 F3 (NEOWISE)", &comet } };
+
+    NameIndex index(lists);
+    index.waitForBuilds();
+    QVERIFY(index.isReady());
+
+    auto exact = index.exact("m31");
+    QCOMPARE(exact.size(), 1);
+    QVERIFY(exact.first().object == &andromeda);
+    QCOMPARE(exact.first().type, int(SkyObject::GALAXY));
+    QVERIFY(index.exact("MARS").first().object == &mars);
+    QVERIFY(index.exact("Mar").isEmpty());
+    QVERIFY(index.exact("Mars", { SkyObject::GALAXY }).isEmpty());
+
+    QCOMPARE(matchedNames(index.prefix("m 3")), QStringList({ "M 31", "M 33" }));
+    QCOMPARE(matchedNames(index.prefix("ma")), QStringList({ "Mars" }));
+    // The words of the names match too
+    QCOMPARE(matchedNames(index.prefix("galaxy")), QStringList({ "Andromeda Galaxy", "Triangulum Galaxy" }));
+    QCOMPARE(matchedNames(index.prefix("neowise")), QStringList({ "C/2020 F3 (NEOWISE)" }));
+    QCOMPARE(index.prefix("m", QList<int>(), 2).size(), 2);
+    QCOMPARE(matchedNames(index.prefix("m", { SkyObject::PLANET })), QStringList({ "Mars" }));
+
+    auto fuzzy = index.fuzzy("Andromeda Galxy", 1);
+    QCOMPARE(fuzzy.size(), 1);
+    QVERIFY(fuzzy.first().object == &andromeda);
+    QCOMPARE(fuzzy.first().distance, 1);
+    QVERIFY(index.fuzzy("Andromda Galxy", 1).isEmpty());
+    QCOMPARE(index.fuzzy("Andromda Galxy", 2).size(), 1);
+    // Sorted by distance
+    fuzzy = index.fuzzy("M 3", 1);
+    QCOMPARE(matchedNames(fuzzy), QStringList({ "M 31", "M 33" }));
+    // Names containing the text anywhere
+    QCOMPARE(matchedNames(index.contains("romeda")), QStringList({ "Andromeda Galaxy" }));
+    QCOMPARE(matchedNames(index.contains("f3 (neo")), QStringList({ "C/2020 F3 (NEOWISE)" }));
+    QCOMPARE(index.contains("a", QList<int>(), 2).size(), 2);
+    QVERIFY(index.contains("m31").isEmpty());
+    fuzzy = index.fuzzy("Mar", 2);
+    QCOMPARE(fuzzy.first().name, QString("Mars"));
+    QCOMPARE(fuzzy.first().distance, 1);
+    for (int i = 1; i < fuzzy.size(); ++i)
+        QVERIFY(fuzzy[i - 1].distance <= fuzzy[i].distance);
+}
+
+// Objects of the same type sharing a name are returned in the order of their list, those with the case of the
+// query first, whether the list is indexed or scanned
+void TestNameIndex::testSharedNames()
+{
+    SkyObject first(SkyObject::GALAXY, 0.0, 0.0, 0.0, "Crab");
+    SkyObject second(SkyObject::GALAXY, 0.0, 0.0, 0.0, "Crab");
+    SkyObject upper(SkyObject::GALAXY, 0.0, 0.0, 0.0, "CRAB");
+    SkyObject nebula(SkyObject::SUPERNOVA_REMNANT, 0.0, 0.0, 0.0, "Crab");
+
+    for (int round = 0; round < 10; ++round)
+    {
+        QHash<int, NameIndex::NameList> lists;
+        lists[SkyObject::SUPERNOVA_REMNANT] = { { "Crab", &nebula } };
+        lists[SkyObject::GALAXY] = { { "CRAB", &upper }, { "Crab", &first } };
+        // Enough other names for the sort of the index to move the equal keys around
+        lists[SkyObject::GALAXY] += randomNames(1000 + round, round);
+        lists[SkyObject::GALAXY].append({ "Crab", &second });
+
+        NameIndex index(lists);
+        for (const bool indexed : { false, true })
+        {
+            if (indexed)
+                index.waitForBuilds();
+            const auto matches = index.exact("Crab");
+            QCOMPARE(matches.size(), 4);
+            // Types in increasing order
+            QVERIFY(matches[0].object == &nebula);
+            QVERIFY(matches[1].object == &first);
+            QVERIFY(matches[2].object == &second);
+            QVERIFY(matches[3].object == &upper);
+            QVERIFY(index.exact("CRAB").first().object == &upper);
+        }
+    }
+}
+
+// Changed lists are searched directly until their index is rebuilt
+void TestNameIndex::testChangedList()
+{
+    SkyObject vega(SkyObject::STAR, 0.0, 0.0, 0.0, "Vega");
+    SkyObject deneb(SkyObject::STAR, 0.0, 0.0, 1.25, "Deneb");
+
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::STAR] = { { "Vega", &vega } };
+
+    NameIndex index(lists);
+    index.waitForBuilds();
+    QVERIFY(index.isReady());
+
+    lists[SkyObject::STAR].append({ "Deneb", &deneb });
+    QCOMPARE(index.exact("deneb").size(), 1);
+    QVERIFY(index.exact("deneb").first().object == &deneb);
+    QCOMPARE(index.prefix("de").size(), 1);
+    QCOMPARE(index.fuzzy("denen", 1).size(), 1);
+
+    index.waitForBuilds();
+    QVERIFY(index.isReady());
+    QVERIFY(index.exact("deneb").first().object == &deneb);
+
+    lists[SkyObject::STAR].clear();
+    QVERIFY(index.exact("vega").isEmpty());
+    QVERIFY(index.prefix("v").isEmpty());
+
+    lists.remove(SkyObject::STAR);
+    QVERIFY(index.exact("vega").isEmpty());
+    index.waitForBuilds();
+    QVERIFY(index.isReady());
+}
+
+// Queries from several threads at once, as findByName() gets from the model and JIT update threads,
+// while the indexes are built and swapped in
+void TestNameIndex::testConcurrentQueries()
+{
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::ASTEROID] = randomNames(40000, 1);
+    lists[SkyObject::COMET]    = randomNames(5000, 2);
+    lists[SkyObject::STAR]     = randomNames(10000, 3);
+
+    // Expected counts from a scan of the names
+    QHash<QString, int> counts;
+    QStringList queries;
+    QRandomGenerator rng(4);
+    for (const auto &list : lists)
+    {
+        for (const auto &item : list)
+            counts[NameIndex::normalize(item.first)]++;
+        for (int i = 0; i < 200; ++i)
+            queries.append(list[rng.bounded(list.size())].first);
+    }
+
+    NameIndex index(lists);
+    std::atomic<int> failures { 0 };
+    QVector<int> threads(2 * QThread::idealThreadCount());
+    std::iota(threads.begin(), threads.end(), 0);
+    QtConcurrent::blockingMap(threads, [&](int thread)
+    {
+        for (int i = 0; i < queries.size(); ++i)
+        {
+            const QString &query = queries[(i + thread * 37) % queries.size()];
+            if (index.exact(query).size() != counts.value(NameIndex::normalize(query)))
+                failures++;
+            if (index.prefix(query, QList<int>(), 1).isEmpty())
+                failures++;
+            if (i % 50 == 0)
+                index.update();
+        }
+    });
+    QCOMPARE(failures.load(), 0);
+
+    index.waitForBuilds();
+    QVERIFY(index.isReady());
+    for (const QString &query : queries)
+        QCOMPARE(index.exact(query).size(), counts.value(NameIndex::normalize(query)));
+}
+
+void TestNameIndex::testAgainstScan_data()
+{
+    QTest::addColumn<int>("maxDistance");
+
+    QTest::newRow("distance 1") << 1;
+    QTest::newRow("distance 2") << 2;
+}
+
+void TestNameIndex::testAgainstScan()
+{
+    QFETCH(int, maxDistance);
+
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::ASTEROID] = randomNames(20000, 1);
+    lists[SkyObject::COMET]    = randomNames(2000, 2);
+
+    NameIndex index(lists);
+    index.waitForBuilds();
+
+    QRandomGenerator rng(3);
+    for (int i = 0; i < 50; ++i)
+    {
+        const auto &names   = lists[i % 2 ? SkyObject::COMET : SkyObject::ASTEROID];
+        const QString name  = names[rng.bounded(names.size())].first;
+        const QString query = typo(name, rng);
+        const QString key   = NameIndex::normalize(query);
+        const QString start = NameIndex::normalize(name.left(1 + rng.bounded(name.size())));
+
+        QStringList exact, prefix, fuzzy;
+        for (const auto &list : lists)
+        {
+            for (const auto &item : list)
+            {
+                const QString itemKey = NameIndex::normalize(item.first);
+                if (itemKey == NameIndex::normalize(name))
+                    exact.append(item.first);
+                if (itemKey.startsWith(start))
+                    prefix.append(item.first);
+                if (levenshtein(itemKey, key) <= maxDistance)
+                    fuzzy.append(item.first);
+            }
+        }
+        exact.sort();
+        fuzzy.sort();
+        prefix.sort();
+
+        QCOMPARE(matchedNames(index.exact(name)), exact);
+        QCOMPARE(matchedNames(index.fuzzy(query, maxDistance, QList<int>(), -1)), fuzzy);
+        // The word matches come on top of the whole names
+        const QStringList prefixed = matchedNames(index.prefix(start));
+        for (const auto &found : prefix)
+            QVERIFY(prefixed.contains(found));
+    }
+}
+
+void TestNameIndex::benchmarkBuild()
+{
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::ASTEROID] = randomNames(1000000, 1);
+
+    QBENCHMARK_ONCE
+    {
+        NameIndex index(lists);
+        index.waitForBuilds();
+    }
+}
+
+void TestNameIndex::benchmarkQueries_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<bool>("indexed");
+
+    for (const auto &query : QStringList({ "exact", "prefix", "fuzzy 1", "fuzzy 2" }))
+    {
+        QTest::newRow(QString("%1 scan").arg(query).toLatin1().constData()) << query << false;
+        QTest::newRow(QString("%1 index").arg(query).toLatin1().constData()) << query << true;
+    }
+}
+
+// A million names, queried with 10 names taken from the list. The scan is a case insensitive
+// comparison of every name, as the filter of the Find dialog did.
+void TestNameIndex::benchmarkQueries()
+{
+    QFETCH(QString, query);
+    QFETCH(bool, indexed);
+
+    QHash<int, NameIndex::NameList> lists;
+    lists[SkyObject::ASTEROID] = randomNames(1000000, 1);
+    const NameIndex::NameList &names = lists[SkyObject::ASTEROID];
+
+    NameIndex index(lists);
+    index.waitForBuilds();
+
+    QRandomGenerator rng(4);
+    QStringList queries;
+    for (int i = 0; i < 10; ++i)
+    {
+        const QString name = names[rng.bounded(names.size())].first;
+        if (query == "prefix")
+            queries.append(name.left(4));
+        else if (query.startsWith("fuzzy"))
+            queries.append(typo(name, rng));
+        else
+            queries.append(name);
+    }
+    const int maxDistance = query == "fuzzy 2" ? 2 : 1;
+
+    int found = 0;
+    QBENCHMARK
+    {
+        for (const auto &text : queries)
+        {
+            if (!indexed)
+            {
+                for (const auto &item : names)
+                {
+                    if (query == "exact" ? item.first.compare(text, Qt::CaseInsensitive) == 0
+                            : query == "prefix" ? item.first.startsWith(text, Qt::CaseInsensitive)
+                            : qAbs(item.first.size() - text.size()) <= maxDistance &&
+                            levenshtein(item.first.toLower(), text.toLower()) <= maxDistance)
+                        ++found;
+                }
+            }
+            else if (query == "exact")
+                found += index.exact(text).size();
+            else if (query == "prefix")
+                found += index.prefix(text, QList<int>(), 200).size();
+            else
+                found += index.fuzzy(text, maxDistance).size();
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_GUILESS_MAIN(TestNameIndex)
@@ -0,0 +1,36 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestNameIndex
+ * @short Tests the exact, prefix and fuzzy name queries against a scan of the names, and their speed
+ */
+class TestNameIndex : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestNameIndex();
+        ~TestNameIndex() override = default;
+
+    private slots:
+        void testNormalize_data();
+        void testNormalize();
+        void testQueries();
+        void testSharedNames();
+        void testChangedList();
+        void testConcurrentQueries();
+        void testAgainstScan_data();
+        void testAgainstScan();
+        void benchmarkBuild();
+        void benchmarkQueries_data();
+        void benchmarkQueries();
+};
@@ -0,0 +1,226 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_skylabeler.h"
+
+#include "skycomponents/skylabeler.h"
+
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// A labeler sized without a sky map
+class Labeler : public SkyLabeler
+{
+    public:
+        Labeler() : SkyLabeler() {}
+
+        using SkyLabeler::resizeScreen;
+};
+
+// A 4K screen
+constexpr int width  = 3840;
+constexpr int height = 2160;
+
+// Rectangle of the virtual screen, in pixels and rows
+struct Box
+{
+    int minX, maxX, minY, maxY;
+
+    bool overlaps(const Box &other) const
+    {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+};
+}  // namespace
+
+TestSkyLabeler::TestSkyLabeler() : QObject()
+{
+}
+
+void TestSkyLabeler::testOverlap()
+{
+    Labeler labeler;
+    labeler.resizeScreen(width, height);
+    const qreal h = labeler.fontMetrics().height();
+
+    QVERIFY(labeler.markRegion(100, 200, 500, 500 - h));
+    QVERIFY(!labeler.markRegion(150, 250, 500, 500 - h));
+    // Overlapping by one pixel
+    QVERIFY(!labeler.markRegion(200, 300, 500, 500 - h));
+    QVERIFY(labeler.markRegion(201, 300, 500, 500 - h));
+    // Across a word of the rows
+    QVERIFY(labeler.markRegion(60, 70, 500, 500 - h));
+    QVERIFY(!labeler.markRegion(0, 64, 500, 500 - h));
+    QVERIFY(labeler.markRegion(0, 59, 500, 500 - h));
+    // Other rows
+    QVERIFY(labeler.markRegion(100, 200, 1000, 1000 - h));
+    // Beyond the sides of the screen, and partly on it
+    QVERIFY(labeler.markRegion(-300, -100, 500, 500 - h));
+    QVERIFY(labeler.markRegion(width + 10, width + 100, 500, 500 - h));
+    QVERIFY(labeler.markRegion(width - 10, width + 100, 500, 500 - h));
+    QVERIFY(!labeler.markRegion(width - 20, width - 10, 500, 500 - h));
+
+    QCOMPARE(labeler.hits(), 6);
+}
+
+void TestSkyLabeler::testReset()
+{
+    Labeler labeler;
+    labeler.resizeScreen(width, height);
+    const qreal h = labeler.fontMetrics().height();
+
+    QVERIFY(labeler.markRegion(100, 200, 500, 500 - h));
+    QVERIFY(!labeler.markRegion(100, 200, 500, 500 - h));
+
+    // A new frame of the same size
+    labeler.resizeScreen(width, height);
+    QVERIFY(labeler.markRegion(100, 200, 500, 500 - h));
+    QVERIFY(!labeler.markRegion(100, 200, 500, 500 - h));
+
+    // A smaller screen, then a larger one
+    labeler.resizeScreen(800, 600);
+    QVERIFY(labeler.markRegion(100, 200, 500, 500 - h));
+    labeler.resizeScreen(width, height);
+    QVERIFY(labeler.markRegion(100, 200, 500, 500 - h));
+    QVERIFY(labeler.markRegion(3000, 3100, 2000, 2000 - h));
+}
+
+void TestSkyLabeler::testAgainstList_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("sparse") << 500;
+    QTest::newRow("dense") << 20000;
+}
+
+void TestSkyLabeler::testAgainstList()
+{
+    QFETCH(int, count);
+
+    Labeler labeler;
+    labeler.resizeScreen(width, height);
+    // Rows of a quarter of a line
+    const qreal rowHeight = (labeler.fontMetrics().height() + 1.0) / 4;
+    const int maxRow      = int(height / rowHeight);
+
+    QRandomGenerator random(count);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        labeler.resizeScreen(width, height);
+
+        // The rectangles marked so far, clipped to the screen as the labeler does
+        std::vector<Box> marked;
+        for (int i = 0; i < count; ++i)
+        {
+            const qreal left   = random.bounded(width + 200.0) - 100.0;
+            const qreal right  = left + 10.0 + random.bounded(150.0);
+            const qreal bottom = random.bounded(height * 1.0);
+            const qreal top    = bottom - labeler.fontMetrics().height();
+
+            const int minY = int(std::floor(top / rowHeight));
+            const int maxY = std::max(int(std::ceil(bottom / rowHeight)) - 1, minY);
+            Box box { std::max(int(left), 0), std::min(int(right), width - 1),
+                      qBound(0, minY, maxRow), qBound(0, maxY, maxRow) };
+            bool expected = true;
+            if (int(right) >= 0 && int(left) < width)
+            {
+                expected = std::none_of(marked.begin(), marked.end(), [&](const Box & other)
+                {
+                    return box.overlaps(other);
+                });
+                if (expected)
+                    marked.push_back(box);
+            }
+
+            QCOMPARE(labeler.markRegion(left, right, bottom, top), expected);
+        }
+    }
+}
+
+void TestSkyLabeler::testCandidates()
+{
+    Labeler labeler;
+    labeler.resizeScreen(width, height);
+    const QString text = QStringLiteral("Betelgeuse");
+    const qreal w      = labeler.fontMetrics().width(text);
+    const qreal h      = labeler.fontMetrics().height();
+    const qreal line   = h + (h + 1.0) / 4;
+    const qreal offset = 4.0;
+    const QPointF o(1000, 1000);
+
+    // Each label takes the first free position: right, left, then above and below on either side
+    const QList<QPointF> expected = { { offset, offset },
+                                      { -offset - w, offset },
+                                      { offset, offset - line },
+                                      { offset, offset + line },
+                                      { -offset - w, offset - line },
+                                      { -offset - w, offset + line } };
+    for (const QPointF &position : expected)
+    {
+        QPointF p;
+        QVERIFY(labeler.markLabel(o, offset, text, p));
+        QCOMPARE(p, o + position);
+    }
+
+    // No room left
+    QPointF p;
+    QVERIFY(!labeler.markLabel(o, offset, text, p));
+
+    // Room to the left of a point whose right is taken
+    const QPointF o2(2000, 1000);
+    QVERIFY(labeler.markRegion(o2.x() + 2, o2.x() + 100, o2.y() - 2 * h, o2.y() + 2 * h));
+    QVERIFY(labeler.markLabel(o2, offset, text, p));
+    QCOMPARE(p, o2 + QPointF(-offset - w, offset));
+}
+
+void TestSkyLabeler::benchmarkMark_data()
+{
+    QTest::addColumn<bool>("candidates");
+
+    QTest::newRow("one position") << false;
+    QTest::newRow("candidate positions") << true;
+}
+
+void TestSkyLabeler::benchmarkMark()
+{
+    QFETCH(bool, candidates);
+
+    Labeler labeler;
+
+    // 50k labels on a 4K screen, as with all the names shown in a dense field
+    constexpr int count = 50000;
+    QRandomGenerator random(42);
+    QVector<QPointF> points(count);
+    QStringList texts;
+    for (int i = 0; i < count; ++i)
+    {
+        points[i] = QPointF(random.bounded(width * 1.0), random.bounded(height * 1.0));
+        texts.append(QString("NGC %1").arg(random.bounded(8000)));
+    }
+
+    int placed = 0;
+    QBENCHMARK
+    {
+        labeler.resizeScreen(width, height);
+        placed = 0;
+        QPointF p;
+        for (int i = 0; i < count; ++i)
+        {
+            if (candidates)
+                placed += labeler.markLabel(points[i], 4.0, texts[i], p);
+            else
+                placed += labeler.markText(points[i] + QPointF(4.0, 4.0), texts[i]);
+        }
+    }
+    qDebug() << placed << "labels placed";
+}
+
+QTEST_MAIN(TestSkyLabeler)
@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestSkyLabeler
+ * @short Tests the label overlap checks against a list of the marked rectangles, and their speed
+ */
+class TestSkyLabeler : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestSkyLabeler();
+        ~TestSkyLabeler() override = default;
+
+    private slots:
+        void testOverlap();
+        void testReset();
+        void testAgainstList_data();
+        void testAgainstList();
+        void testCandidates();
+        void benchmarkMark_data();
+        void benchmarkMark();
+};
@@ -0,0 +1,181 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_ksnumbers.h"
+
+#include "ksnumbers.h"
+#include "ksnumberscache.h"
+
+#include <QRandomGenerator>
+
+#include <cmath>
+
+namespace
+{
+// 2026-01-01 0h UT
+const long double startJD = 2461041.5;
+
+// Aberration of a velocity of the Earth in km/s, in arcseconds
+double aberration(double velocity)
+{
+    return velocity / 299792.458 * 3600. / dms::DegToRad;
+}
+}  // namespace
+
+TestKSNumbers::TestKSNumbers() : QObject()
+{
+    m_Capacity = KSNumbersCache::Instance()->capacity();
+}
+
+TestKSNumbers::~TestKSNumbers()
+{
+    KSNumbersCache::Instance()->setCapacity(m_Capacity);
+}
+
+void TestKSNumbers::testCache()
+{
+    KSNumbersCache *cache = KSNumbersCache::Instance();
+    cache->clear();
+
+    // The same date, or a date within the resolution, share their numbers
+    const KSNumbersCache::NumbersPtr num = cache->numbers(startJD + 0.25);
+    QCOMPARE(cache->numbers(startJD + 0.25), num);
+    QCOMPARE(cache->numbers(startJD + 0.25 + 1e-10), num);
+    QVERIFY(cache->numbers(startJD + 0.26) != num);
+
+    // Which are the numbers of the date
+    const KSNumbers direct(startJD + 0.25);
+    QCOMPARE(double(num->julianDay()), double(direct.julianDay()));
+    QCOMPARE(num->dEcLong(), direct.dEcLong());
+    QCOMPARE(num->dObliq(), direct.dObliq());
+    QCOMPARE(num->obliquity()->Degrees(), direct.obliquity()->Degrees());
+    for (int i = 0; i < 3; i++)
+    {
+        QCOMPARE(num->vEarth(i), direct.vEarth(i));
+        for (int j = 0; j < 3; j++)
+            QCOMPARE(num->p2(i, j), direct.p2(i, j));
+    }
+
+    // A coarser resolution rounds the date
+    const KSNumbersCache::NumbersPtr minute = cache->numbers(startJD + 0.25 + 10. / 86400, 1. / 1440);
+    QCOMPARE(minute, num);
+    QCOMPARE(cache->numbers(startJD + 0.25 + 50. / 86400, 1. / 1440), cache->numbers(startJD + 0.25 + 1. / 1440));
+}
+
+void TestKSNumbers::testCapacity()
+{
+    KSNumbersCache *cache = KSNumbersCache::Instance();
+    cache->clear();
+    cache->setCapacity(8);
+
+    const KSNumbersCache::NumbersPtr first = cache->numbers(startJD);
+    for (int i = 1; i < 8; i++)
+        cache->numbers(startJD + i);
+
+    // Using the first numbers again keeps them in the cache
+    QCOMPARE(cache->numbers(startJD), first);
+    cache->numbers(startJD + 8);
+    QCOMPARE(cache->numbers(startJD), first);
+
+    // Until they are the least recently used
+    for (int i = 10; i < 20; i++)
+        cache->numbers(startJD + i);
+    QVERIFY(cache->numbers(startJD) != first);
+
+    cache->setCapacity(m_Capacity);
+}
+
+void TestKSNumbers::testInterpolatedNutation_data()
+{
+    QTest::addColumn<double>("tolerance");
+
+    QTest::newRow("0.1\"") << 0.1;
+    QTest::newRow("0.01\"") << 0.01;
+    QTest::newRow("0.001\"") << 0.001;
+}
+
+void TestKSNumbers::testInterpolatedNutation()
+{
+    QFETCH(double, tolerance);
+
+    KSNumbersCache *cache = KSNumbersCache::Instance();
+    cache->clear();
+    const double step = KSNumbersCache::interpolationStep(tolerance);
+    QVERIFY(step > 0);
+    QVERIFY(KSNumbers::interpolationError(step) <= tolerance);
+
+    // Random dates over a year and a few centuries away
+    QRandomGenerator random(42);
+    double worstNutation = 0, worstAberration = 0;
+    for (int i = 0; i < 5000; i++)
+    {
+        const long double jd = startJD + (i % 5 == 0 ? 36525 * random.bounded(4.0) : 0) + random.bounded(365.0);
+        const KSNumbers exact(jd);
+        const KSNumbers interpolated = cache->interpolated(jd, tolerance);
+
+        // The cheap values are computed for the date
+        QCOMPARE(double(interpolated.julianDay()), double(jd));
+        QCOMPARE(interpolated.obliquity()->Degrees(), exact.obliquity()->Degrees());
+        QCOMPARE(interpolated.sunTrueLongitude().Degrees(), exact.sunTrueLongitude().Degrees());
+        QCOMPARE(interpolated.p1(0, 1), exact.p1(0, 1));
+
+        worstNutation = std::max(worstNutation, 3600 * std::abs(interpolated.dEcLong() - exact.dEcLong()));
+        worstNutation = std::max(worstNutation, 3600 * std::abs(interpolated.dObliq() - exact.dObliq()));
+        double velocity = 0;
+        for (int j = 0; j < 3; j++)
+            velocity += std::pow(interpolated.vEarth(j) - exact.vEarth(j), 2);
+        worstAberration = std::max(worstAberration, aberration(std::sqrt(velocity)));
+    }
+
+    qDebug() << "Step" << step << "days, nutation error up to" << worstNutation << "\", aberration error up to"
+             << worstAberration << "\"";
+    QVERIFY2(worstNutation + worstAberration <= tolerance,
+             qPrintable(QString("Error up to %1\" and %2\"").arg(worstNutation).arg(worstAberration)));
+}
+
+void TestKSNumbers::benchmarkConstruction_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("constructed") << 0;
+    QTest::newRow("cached minutes") << 1;
+    QTest::newRow("interpolated") << 2;
+}
+
+// A million dates over a year, about every half minute, as the planning tools ask for
+void TestKSNumbers::benchmarkConstruction()
+{
+    QFETCH(int, mode);
+
+    KSNumbersCache *cache = KSNumbersCache::Instance();
+    const int count       = 1000000;
+    const double interval = 365.0 / count;
+    double sum            = 0;
+
+    cache->clear();
+    QBENCHMARK_ONCE
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const long double jd = startJD + i * interval;
+            switch (mode)
+            {
+                case 0:
+                    sum += KSNumbers(jd).dEcLong();
+                    break;
+                case 1:
+                    sum += cache->numbers(jd, 1. / 1440)->dEcLong();
+                    break;
+                default:
+                    sum += cache->interpolated(jd).dEcLong();
+                    break;
+            }
+        }
+    }
+    QVERIFY(std::isfinite(sum));
+}
+
+QTEST_GUILESS_MAIN(TestKSNumbers)
@@ -0,0 +1,36 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TEST_KSNUMBERS_H
+#define TEST_KSNUMBERS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestKSNumbers
+ * @short Tests and benchmark of the shared and interpolated KSNumbers
+ */
+class TestKSNumbers : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestKSNumbers();
+        ~TestKSNumbers() override;
+
+    private slots:
+        void testCache();
+        void testCapacity();
+        void testInterpolatedNutation_data();
+        void testInterpolatedNutation();
+        void benchmarkConstruction_data();
+        void benchmarkConstruction();
+
+    private:
+        int m_Capacity { 0 };
+};
+
+#endif
@@ -0,0 +1,284 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_satellite.h"
+
+#include "skyobjects/satellite.h"
+#include "auxiliary/geolocation.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Test cases from the SGP4 verification set (Vallado et al., "Revisiting Spacetrack Report #3")
+const QString VANGUARD_LINE1 = QStringLiteral("1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753");
+const QString VANGUARD_LINE2 = QStringLiteral("2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667");
+const QString DELTA1_LINE1 = QStringLiteral("1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985");
+const QString DELTA1_LINE2 = QStringLiteral("2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774");
+const QString DECAY_LINE1 = QStringLiteral("1 28350U 04020A   06167.21788666  .16154492  76267-5  18678-3 0  8894");
+const QString DECAY_LINE2 = QStringLiteral("2 28350  64.9977 345.6130 0024870 269.3428  90.4855 16.46538406  9996");
+
+const GeoLocation &observerLocation()
+{
+    static const GeoLocation location(dms(-96, 49), dms(32, 46, 45));
+    return location;
+}
+
+// Observer at the given number of minutes after the TLE epoch of the satellite
+Satellite::Observer observerAfterEpoch(const Satellite &sat, double minutes)
+{
+    return Satellite::observerAt(sat.tleJD() + minutes / 1440.0, &observerLocation());
+}
+
+// Same orbit as line2, with the mean anomaly moved by offset degrees
+QString shiftMeanAnomaly(const QString &line2, double offset)
+{
+    double anomaly = fmod(line2.mid(43, 8).toDouble() + offset, 360.0);
+    return line2.left(43) + QString("%1").arg(anomaly, 8, 'f', 4) + line2.mid(51);
+}
+}
+
+TestSatellite::TestSatellite() : QObject()
+{
+}
+
+void TestSatellite::testSGP4Reference_data()
+{
+    QTest::addColumn<QString>("line1");
+    QTest::addColumn<QString>("line2");
+    QTest::addColumn<double>("tsince");
+    QTest::addColumn<double>("x");
+    QTest::addColumn<double>("y");
+    QTest::addColumn<double>("z");
+
+    QTest::newRow("00005 t=0") << VANGUARD_LINE1 << VANGUARD_LINE2 << 0.0 << 7022.46529266 << -1400.08296755 << 0.03995155;
+    QTest::newRow("00005 t=360") << VANGUARD_LINE1 << VANGUARD_LINE2 << 360.0 << -7154.03120202 << -3783.17682504 <<
+                                 -3536.19412294;
+    QTest::newRow("00005 t=720") << VANGUARD_LINE1 << VANGUARD_LINE2 << 720.0 << -7134.59340119 << 6531.68641334 <<
+                                 3260.27186483;
+    QTest::newRow("00005 t=1080") << VANGUARD_LINE1 << VANGUARD_LINE2 << 1080.0 << 5568.53901181 << 4492.06992591 <<
+                                  3863.87641983;
+    QTest::newRow("00005 t=1440") << VANGUARD_LINE1 << VANGUARD_LINE2 << 1440.0 << -938.55923943 << -6268.18748831 <<
+                                  -4294.02924751;
+    QTest::newRow("06251 t=0") << DELTA1_LINE1 << DELTA1_LINE2 << 0.0 << 3988.31022699 << 5498.96657235 << 0.90055879;
+    QTest::newRow("06251 t=360") << DELTA1_LINE1 << DELTA1_LINE2 << 360.0 << 4993.62642836 << 2890.54969900 <<
+                                 -3600.40145627;
+    QTest::newRow("06251 t=720") << DELTA1_LINE1 << DELTA1_LINE2 << 720.0 << 3692.60030028 << -976.24265255 <<
+                                 -5623.36447493;
+    QTest::newRow("06251 t=1080") << DELTA1_LINE1 << DELTA1_LINE2 << 1080.0 << 642.27769977 << -4332.89821901 <<
+                                  -5183.31523910;
+    QTest::newRow("06251 t=1440") << DELTA1_LINE1 << DELTA1_LINE2 << 1440.0 << -2777.14682335 << -5663.16031708 <<
+                                  -2462.54889123;
+    QTest::newRow("28350 t=0") << DECAY_LINE1 << DECAY_LINE2 << 0.0 << 6324.12761151 << -1622.51719998 << -0.59485031;
+    QTest::newRow("28350 t=360") << DECAY_LINE1 << DECAY_LINE2 << 360.0 << 4982.68704374 << 637.94384565 << 4146.27361476;
+    QTest::newRow("28350 t=720") << DECAY_LINE1 << DECAY_LINE2 << 720.0 << 200.73975012 << 2790.23828761 << 5857.76594416;
+}
+
+void TestSatellite::testSGP4Reference()
+{
+    QFETCH(QString, line1);
+    QFETCH(QString, line2);
+    QFETCH(double, tsince);
+    QFETCH(double, x);
+    QFETCH(double, y);
+    QFETCH(double, z);
+
+    Satellite sat("Test", line1, line2);
+    QCOMPARE(sat.updatePos(observerAfterEpoch(sat, tsince)), 0);
+
+    double px, py, pz;
+    sat.positionECI(px, py, pz);
+    QVERIFY2(fabs(px - x) < 1e-3, qPrintable(QString("x %1 expected %2").arg(px, 0, 'f', 8).arg(x, 0, 'f', 8)));
+    QVERIFY2(fabs(py - y) < 1e-3, qPrintable(QString("y %1 expected %2").arg(py, 0, 'f', 8).arg(y, 0, 'f', 8)));
+    QVERIFY2(fabs(pz - z) < 1e-3, qPrintable(QString("z %1 expected %2").arg(pz, 0, 'f', 8).arg(z, 0, 'f', 8)));
+}
+
+void TestSatellite::testEarliestRiseBound_data()
+{
+    QTest::addColumn<QString>("line1");
+    QTest::addColumn<QString>("line2");
+
+    QTest::newRow("00005") << VANGUARD_LINE1 << VANGUARD_LINE2;
+    QTest::newRow("06251") << DELTA1_LINE1 << DELTA1_LINE2;
+    QTest::newRow("28350") << DECAY_LINE1 << DECAY_LINE2;
+}
+
+void TestSatellite::testEarliestRiseBound()
+{
+    QFETCH(QString, line1);
+    QFETCH(QString, line2);
+
+    // Sample one day every 10 seconds, a satellite declared below the horizon until some
+    // time must not be seen above it before that time.
+    Satellite sat("Test", line1, line2);
+    std::vector<double> jds, altitudes, earliestRise;
+    for (double minutes = 0; minutes <= 1440.0; minutes += 10.0 / 60.0)
+    {
+        Satellite::Observer observer = observerAfterEpoch(sat, minutes);
+        QCOMPARE(sat.updatePos(observer), 0);
+        jds.push_back(observer.jd);
+        altitudes.push_back(sat.alt().Degrees());
+
+        // Find the end of the skippable interval
+        double lo = observer.jd, hi = observer.jd + 1.0;
+        if (!sat.isBelowHorizonUntil(observer))
+            hi = lo;
+        while (hi - lo > 1e-6)
+        {
+            double mid = 0.5 * (lo + hi);
+            Satellite::Observer later = observer;
+            later.jd = mid;
+            if (sat.isBelowHorizonUntil(later))
+                lo = mid;
+            else
+                hi = mid;
+        }
+        earliestRise.push_back(lo);
+    }
+
+    int skipped = 0;
+    for (size_t i = 0; i < jds.size(); i++)
+    {
+        for (size_t j = i + 1; j < jds.size() && jds[j] < earliestRise[i]; j++)
+        {
+            QVERIFY2(altitudes[j] < 0, qPrintable(QString("Satellite above horizon %1 min after a skip bound was set")
+                                                  .arg((jds[j] - jds[i]) * 1440.0)));
+            skipped++;
+        }
+    }
+    // The bound must be useful, not only correct
+    QVERIFY(skipped > 0);
+
+    // Moving the observer invalidates the bound
+    Satellite::Observer observer = observerAfterEpoch(sat, 0);
+    sat.updatePos(observer);
+    if (sat.isBelowHorizonUntil(observer))
+    {
+        observer.lat.setD(observer.lat.Degrees() + 1.0);
+        QVERIFY(!sat.isBelowHorizonUntil(observer));
+    }
+}
+
+void TestSatellite::testPasses()
+{
+    Satellite sat("Test", DELTA1_LINE1, DELTA1_LINE2);
+    const double startJD = sat.tleJD();
+    const double endJD   = startJD + 2.0;
+
+    QList<Satellite::Pass> passes = sat.findPasses(&observerLocation(), startJD, endJD);
+    QVERIFY(!passes.isEmpty());
+
+    // Brute force reference, sampled every 5 seconds
+    Satellite reference("Reference", DELTA1_LINE1, DELTA1_LINE2);
+    double previousAlt = -90;
+    bool initialPass = true;
+    int found = 0;
+    for (double jd = startJD; jd <= endJD; jd += 5.0 / 86400.0)
+    {
+        QCOMPARE(reference.updatePos(Satellite::observerAt(jd, &observerLocation())), 0);
+        double alt = reference.alt().Degrees();
+
+        // Ignore a pass already in progress at the beginning of the window
+        initialPass = initialPass && alt > 0;
+        // Grazing passes shorter than the search step may be missed, only check clear passes
+        if (alt > 2 && !initialPass)
+        {
+            // Every sample above the horizon belongs to a predicted pass, and does not exceed its maximum
+            bool inPass = false;
+            for (const auto &pass : passes)
+            {
+                if (jd >= pass.riseJD - 1e-5 && jd <= pass.setJD + 1e-5)
+                {
+                    inPass = true;
+                    QVERIFY(alt <= pass.maxAltitude + 1e-3);
+                }
+            }
+            QVERIFY2(inPass, qPrintable(QString("Sample at JD %1 is not in a pass").arg(jd, 0, 'f', 6)));
+            if (previousAlt <= 2)
+                found++;
+        }
+        previousAlt = alt;
+    }
+    QVERIFY(found > 0);
+    QVERIFY(found <= passes.size());
+
+    for (const auto &pass : passes)
+    {
+        QVERIFY(pass.riseJD < pass.culminationJD);
+        QVERIFY(pass.culminationJD < pass.setJD);
+        QVERIFY(pass.riseJD >= startJD && pass.riseJD <= endJD);
+        QVERIFY(pass.maxAltitude > 0 && pass.maxAltitude <= 90);
+
+        // Rise and set are on the horizon
+        reference.updatePos(Satellite::observerAt(pass.riseJD, &observerLocation()));
+        QVERIFY(fabs(reference.alt().Degrees()) < 0.1);
+        reference.updatePos(Satellite::observerAt(pass.setJD, &observerLocation()));
+        QVERIFY(fabs(reference.alt().Degrees()) < 0.1);
+
+        // Plain TLE files do not give the standard magnitude
+        QVERIFY(std::isnan(pass.magnitude));
+    }
+
+    // McCants TLE files give it after the dimensions of the satellite
+    Satellite mccants("DELTA 1 R/B              6.0  2.4  0.0  3.5 d", DELTA1_LINE1, DELTA1_LINE2);
+    QCOMPARE(mccants.name(), QString("DELTA 1 R/B"));
+    QCOMPARE(mccants.standardMagnitude(), 3.5);
+    const QList<Satellite::Pass> magnitudes = mccants.findPasses(&observerLocation(), startJD, endJD);
+    QCOMPARE(magnitudes.size(), passes.size());
+    for (const auto &pass : magnitudes)
+        QVERIFY(std::isfinite(pass.magnitude));
+}
+
+void TestSatellite::benchmarkPropagation_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("parallel");
+
+    for (int count : { 1000, 5000, 10000 })
+    {
+        QTest::newRow(QString("%1 serial").arg(count).toLatin1().constData()) << count << false;
+        QTest::newRow(QString("%1 parallel").arg(count).toLatin1().constData()) << count << true;
+    }
+}
+
+void TestSatellite::benchmarkPropagation()
+{
+    QFETCH(int, count);
+    QFETCH(bool, parallel);
+
+    // Mix low circular and eccentric orbits
+    const QString lines[][2] = { { DELTA1_LINE1, DELTA1_LINE2 }, { VANGUARD_LINE1, VANGUARD_LINE2 } };
+    std::vector<std::unique_ptr<Satellite>> owners;
+    QVector<Satellite *> sats;
+    for (int i = 0; i < count; i++)
+    {
+        const QString *tle = lines[i % 2];
+        owners.emplace_back(new Satellite(QString("Sat %1").arg(i), tle[0], shiftMeanAnomaly(tle[1], i * 360.0 / count)));
+        sats.append(owners.back().get());
+    }
+
+    const Satellite::Observer observer = observerAfterEpoch(*sats.first(), 60.0);
+
+    auto update = [&observer](Satellite * sat)
+    {
+        sat->updatePos(observer);
+    };
+
+    QBENCHMARK
+    {
+        if (parallel)
+            QtConcurrent::blockingMap(sats, update);
+        else
+            std::for_each(sats.begin(), sats.end(), update);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSatellite)
@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestSatellite
+ * @short Tests SGP4 propagation against reference values, the horizon skipping bound and pass prediction
+ */
+class TestSatellite : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestSatellite();
+        ~TestSatellite() override = default;
+
+    private slots:
+        void testSGP4Reference_data();
+        void testSGP4Reference();
+        void testEarliestRiseBound_data();
+        void testEarliestRiseBound();
+        void testPasses();
+        void benchmarkPropagation_data();
+        void benchmarkPropagation();
+};
@@ -13,9 +13,15 @@
 #include <memory>
 
 #include "artificialhorizoncomponent.h"
+#include "geolocation.h"
+#include "kstarsdatetime.h"
 #include "linelist.h"
 #include "Options.h"
 
+#include <QRandomGenerator>
+
+#include <cmath>
+
 class TestArtificialHorizon : public QObject
 {
         Q_OBJECT
@@ -29,6 +35,12 @@ class TestArtificialHorizon : public QObject
 
     private slots:
         void artificialHorizonTest();
+        void rasterAgreementTest_data();
+        void rasterAgreementTest();
+        void rasterUpdateTest();
+        void segmentAndTimeTest();
+        void benchmarkIsVisible_data();
+        void benchmarkIsVisible();
 
     private:
 };
@@ -87,6 +99,51 @@ bool checkHorizon(const ArtificialHorizon &horizon, double az, double alt,
     return (horizon.isVisible(az, alt) == visibility) && (azAltInPolygon != visibility);
 }
 
+// Adds random horizon lines and ceilings, some crossing 0 degrees in azimuth and some
+// not closed, with vertices on whole degrees so that queries fall on the raster cell edges.
+void addRandomRegions(ArtificialHorizon &horizon, QRandomGenerator &rng, int count)
+{
+    for (int r = 0; r < count; ++r)
+    {
+        QList<double> az, alt;
+        double a = rng.bounded(360);
+        const int points = 2 + rng.bounded(10);
+        for (int i = 0; i < points; ++i)
+        {
+            az.append(std::fmod(a, 360.0));
+            alt.append(rng.bounded(80) - 10);
+            a += rng.bounded(70) - 20;
+        }
+        horizon.addRegion(QString("R%1").arg(r), true, setupHorizonEntities(az, alt), rng.bounded(3) == 0);
+    }
+}
+
+// Random points, and points on and next to the vertices and lines of the regions
+QList<QPointF> queryPoints(const ArtificialHorizon &horizon, QRandomGenerator &rng, int count)
+{
+    QList<QPointF> points;
+    for (int i = 0; i < count; ++i)
+        points.append(QPointF(rng.generateDouble() * 360, rng.generateDouble() * 180 - 90));
+
+    for (const ArtificialHorizonEntity *entity : *horizon.horizonList())
+    {
+        for (const auto &p : *entity->list()->points())
+        {
+            for (const double dAz : { 0.0, 1e-9, -1e-9, 0.25, -0.5, 1.0 })
+            {
+                const double az = p->az().Degrees() + dAz;
+                for (const double dAlt : { 0.0, 1e-9, -1e-9, 0.5 })
+                {
+                    points.append(QPointF(az, p->alt().Degrees() + dAlt));
+                    bool exists = false;
+                    points.append(QPointF(az, entity->altitudeConstraint(az, &exists) + dAlt));
+                }
+            }
+        }
+    }
+    return points;
+}
+
 }  // namespace
 
 void TestArtificialHorizon::artificialHorizonTest()
@@ -211,4 +268,148 @@ void TestArtificialHorizon::artificialHorizonTest()
 
 }
 
+void TestArtificialHorizon::rasterAgreementTest_data()
+{
+    QTest::addColumn<int>("resolution");
+    QTest::addColumn<int>("regions");
+
+    QTest::newRow("1 per degree, 1 region") << 1 << 1;
+    QTest::newRow("2 per degree, 3 regions") << 2 << 3;
+    QTest::newRow("2 per degree, 6 regions") << 2 << 6;
+    QTest::newRow("5 per degree, 4 regions") << 5 << 4;
+}
+
+// The raster must give the same visibility as the line segments of the regions, everywhere.
+void TestArtificialHorizon::rasterAgreementTest()
+{
+    QFETCH(int, resolution);
+    QFETCH(int, regions);
+
+    QRandomGenerator rng(resolution * 100 + regions);
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        ArtificialHorizon horizon;
+        horizon.setTesting();
+        horizon.setRasterResolution(resolution);
+        addRandomRegions(horizon, rng, regions);
+
+        int looked = 0;
+        const QList<QPointF> points = queryPoints(horizon, rng, 5000);
+        for (const QPointF &point : points)
+        {
+            const double az = point.x(), alt = point.y();
+            QVERIFY2(horizon.isVisible(az, alt) == horizon.isVisibleInternal(az, alt),
+                     qPrintable(QString("trial %1 at az %2 alt %3").arg(trial).arg(az, 0, 'g', 17).arg(alt, 0, 'g', 17)));
+
+            if (alt >= -90 && alt < 90)
+            {
+                const int rows = 180 * resolution;
+                const int column = std::min(int(std::fmod(az + 720, 360.0) * resolution), 360 * resolution - 1);
+                const int row = std::min(int((alt + 90) * resolution), rows - 1);
+                looked += horizon.m_Raster[column * rows + row] == ArtificialHorizon::RASTER_ENTITY;
+            }
+        }
+        // Most of the sky is decided by the raster alone
+        QVERIFY2(looked < points.size() / 2, qPrintable(QString("%1 of %2 points checked").arg(looked).arg(points.size())));
+    }
+}
+
+// The raster is computed again when the regions change.
+void TestArtificialHorizon::rasterUpdateTest()
+{
+    ArtificialHorizon horizon;
+    horizon.setTesting();
+
+    QVERIFY(horizon.isVisible(20, 30));
+
+    horizon.addRegion("R1", true, setupHorizonEntities({10.0, 20.0, 30.0}, {20.0, 40.0, 26.0}), false);
+    QVERIFY(!horizon.isVisible(20, 30));
+    QVERIFY(!horizon.m_Raster.isEmpty());
+
+    horizon.findRegion("R1")->setEnabled(false);
+    QVERIFY(horizon.isVisible(20, 30));
+
+    horizon.findRegion("R1")->setEnabled(true);
+    QVERIFY(!horizon.isVisible(20, 30));
+
+    horizon.findRegion("R1")->setCeiling(true);
+    QVERIFY(horizon.isVisible(20, 30));
+    QVERIFY(!horizon.isVisible(20, 50));
+
+    horizon.removeRegion("R1");
+    QVERIFY(horizon.isVisible(20, 50));
+
+    // The resolution may change at any time
+    horizon.addRegion("R2", true, setupHorizonEntities({0.0, 120.0, 240.0, 360.0}, {10.0, 10.0, 10.0, 10.0}), false);
+    for (const int resolution : { 1, 3, 10 })
+    {
+        horizon.setRasterResolution(resolution);
+        QVERIFY(!horizon.isVisible(100, 9.9));
+        QVERIFY(horizon.isVisible(100, 10.1));
+        QCOMPARE(horizon.rasterResolution(), resolution);
+    }
+}
+
+void TestArtificialHorizon::segmentAndTimeTest()
+{
+    ArtificialHorizon horizon;
+    horizon.setTesting();
+    // A wall from 350 to 10 degrees, up to 40 degrees
+    horizon.addRegion("R1", true, setupHorizonEntities({350.0, 10.0}, {40.0, 40.0}), false);
+
+    QVERIFY(horizon.isVisible(300, 20, 340, 30));
+    QVERIFY(!horizon.isVisible(340, 30, 20, 30));
+    QVERIFY(horizon.isVisible(340, 45, 20, 45));
+    QVERIFY(!horizon.isVisible(0, 80, 0, 30));
+
+    // Seen from 30 degrees north, a star near the north celestial pole stays behind the wall.
+    // A star near the south pole stays below the horizon, which the regions do not block.
+    GeoLocation geo(dms(0), dms(30));
+    const KStarsDateTime start(QDate(2026, 1, 1), QTime(0, 0, 0));
+    const SkyPoint north(dms(0), dms(89.5));
+    QVERIFY(!horizon.isVisible(north, &geo, start, start.addSecs(86400), 600));
+    const SkyPoint south(dms(0), dms(-89.5));
+    QVERIFY(horizon.isVisible(south, &geo, start, start.addSecs(86400), 600));
+
+    // A star crossing the meridian north of the zenith is behind the wall only around the crossing
+    const SkyPoint star(dms(0), dms(75));
+    QVERIFY(!horizon.isVisible(star, &geo, start, start.addSecs(86400), 600));
+    bool visibleOnce = false;
+    for (int hour = 0; hour < 24; ++hour)
+        visibleOnce |= horizon.isVisible(star, &geo, start.addSecs(hour * 3600), start.addSecs(hour * 3600 + 600));
+    QVERIFY(visibleOnce);
+}
+
+void TestArtificialHorizon::benchmarkIsVisible_data()
+{
+    QTest::addColumn<bool>("raster");
+
+    QTest::newRow("lines") << false;
+    QTest::newRow("raster") << true;
+}
+
+void TestArtificialHorizon::benchmarkIsVisible()
+{
+    QFETCH(bool, raster);
+
+    QRandomGenerator rng(42);
+    ArtificialHorizon horizon;
+    horizon.setTesting();
+    addRandomRegions(horizon, rng, 5);
+
+    QList<QPointF> points;
+    for (int i = 0; i < 100000; ++i)
+        points.append(QPointF(rng.generateDouble() * 360, rng.generateDouble() * 180 - 90));
+
+    // The raster is computed before the measure
+    horizon.isVisible(0, 0);
+    int visible = 0;
+    QBENCHMARK
+    {
+        for (const QPointF &point : points)
+            visible += raster ? horizon.isVisible(point.x(), point.y()) : horizon.isVisibleInternal(point.x(), point.y());
+    }
+    QVERIFY(visible > 0);
+}
+
 QTEST_GUILESS_MAIN(TestArtificialHorizon)
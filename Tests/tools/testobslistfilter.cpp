@@ -0,0 +1,345 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+/*
+ * This file contains unit tests for the ObsListFilter class.
+ */
+
+#include <QObject>
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <cmath>
+
+#include "tools/obslistfilter.h"
+#include "skyobjects/skyobject.h"
+
+class TestObsListFilter : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestObsListFilter();
+
+        /** @short Destructor */
+        ~TestObsListFilter() override;
+
+    private slots:
+        void testRegions();
+        void testMagnitude();
+        void testObservable();
+        void testConstellations();
+        void testIncremental();
+        void benchmarkCount_data();
+        void benchmarkCount();
+
+    private:
+        QList<SkyObject *> m_Stars;
+        QList<SkyObject *> m_Comets;
+};
+
+// This include must go after the class declaration.
+#include "testobslistfilter.moc"
+
+namespace
+{
+const uint allCategories = (1u << ObsListFilter::CATEGORY_COUNT) - 1;
+
+QList<SkyObject *> randomObjects(int count, int type, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QList<SkyObject *> objects;
+    for (int i = 0; i < count; ++i)
+    {
+        const double ra  = random.bounded(360.0);
+        const double dec = qRadiansToDegrees(std::asin(random.bounded(2.0) - 1));
+        // A tenth of the objects have no magnitude
+        const float mag = random.bounded(10) == 0 ? 99.0f : float(random.bounded(15.0) - 1.0);
+        objects.append(new SkyObject(type, dms(ra), dms(dec), mag, QString("object %1").arg(i)));
+    }
+    return objects;
+}
+
+// The predicates evaluated one object at a time, as the wizard did
+bool reference(const ObsListFilter::Criteria &criteria, SkyObject *o)
+{
+    switch (criteria.region)
+    {
+        case ObsListFilter::RECTANGLE:
+        {
+            const double ra = o->ra().Hours(), dec = o->dec().Degrees();
+            if (dec < criteria.decMin || dec > criteria.decMax)
+                return false;
+            if (criteria.raMin < 0.0 ? !(ra >= criteria.raMin + 24.0 || ra <= criteria.raMax) :
+                    !(ra >= criteria.raMin && ra <= criteria.raMax))
+                return false;
+            break;
+        }
+        case ObsListFilter::CIRCLE:
+        {
+            const SkyPoint center(dms(criteria.centerRA), dms(criteria.centerDec));
+            if (o->angularDistanceTo(&center).Degrees() >= criteria.radius)
+                return false;
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (criteria.byMagnitude)
+    {
+        if (o->mag() > 90 ? !criteria.includeNoMag : o->mag() > criteria.maglim)
+            return false;
+    }
+
+    if (criteria.byDate)
+    {
+        SkyPoint p = *o;
+        const CachingDms latitude(criteria.latitude);
+        int visible = 0;
+        for (const double lst : criteria.siderealTimes)
+        {
+            const CachingDms LST(lst);
+            p.EquatorialToHorizontal(&LST, &latitude);
+            if (p.alt().Degrees() >= criteria.minAlt && p.alt().Degrees() <= criteria.maxAlt)
+                visible++;
+        }
+        if (double(visible) / criteria.siderealTimes.size() < criteria.coverage / 100.0)
+            return false;
+    }
+    return true;
+}
+
+int referenceCount(const ObsListFilter::Criteria &criteria, const QList<SkyObject *> &objects)
+{
+    int count = 0;
+    for (SkyObject *o : objects)
+        count += reference(criteria, o);
+    return count;
+}
+
+ObsListFilter::Criteria tonight()
+{
+    ObsListFilter::Criteria criteria;
+    criteria.categories = allCategories;
+    criteria.byDate     = true;
+    // Hourly samples over six hours
+    for (int hour = 0; hour < 6; ++hour)
+        criteria.siderealTimes.append(250.0 + 15.0 * hour);
+    criteria.latitude = 45.0;
+    criteria.minAlt   = 20.0;
+    criteria.maxAlt   = 80.0;
+    criteria.coverage = 50.0;
+    return criteria;
+}
+}  // namespace
+
+TestObsListFilter::TestObsListFilter() : QObject()
+{
+    m_Stars  = randomObjects(20000, SkyObject::STAR, 1);
+    m_Comets = randomObjects(2000, SkyObject::COMET, 2);
+}
+
+TestObsListFilter::~TestObsListFilter()
+{
+    qDeleteAll(m_Stars);
+    qDeleteAll(m_Comets);
+}
+
+void TestObsListFilter::testRegions()
+{
+    ObsListFilter filter;
+    filter.addObjects(ObsListFilter::STARS, m_Stars);
+
+    ObsListFilter::Criteria criteria;
+    criteria.categories = allCategories;
+    QCOMPARE(filter.count(criteria), m_Stars.size());
+
+    criteria.region = ObsListFilter::RECTANGLE;
+    criteria.raMin  = 3.5;
+    criteria.raMax  = 8.25;
+    criteria.decMin = -20;
+    criteria.decMax = 35;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    // Across 0h
+    criteria.raMin = -2.0;
+    criteria.raMax = 1.5;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    criteria.region    = ObsListFilter::CIRCLE;
+    criteria.centerRA  = 83.8;
+    criteria.centerDec = -5.4;
+    criteria.radius    = 12.0;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    // Around the pole
+    criteria.centerRA  = 37.9;
+    criteria.centerDec = 89.3;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+}
+
+void TestObsListFilter::testMagnitude()
+{
+    ObsListFilter filter;
+    filter.addObjects(ObsListFilter::COMETS, m_Comets);
+
+    ObsListFilter::Criteria criteria;
+    criteria.categories  = allCategories;
+    criteria.byMagnitude = true;
+    criteria.maglim      = 6.5;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Comets));
+
+    criteria.includeNoMag = true;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Comets));
+
+    // Only the selected categories are counted
+    criteria.categories = 1u << ObsListFilter::STARS;
+    QCOMPARE(filter.count(criteria), 0);
+}
+
+void TestObsListFilter::testObservable()
+{
+    ObsListFilter filter;
+    filter.addObjects(ObsListFilter::STARS, m_Stars);
+
+    ObsListFilter::Criteria criteria = tonight();
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    criteria.coverage = 100.0;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    criteria.latitude = -33.9;
+    criteria.minAlt   = -10.0;
+    QCOMPARE(filter.count(criteria), referenceCount(criteria, m_Stars));
+
+    // The matches are the objects of the reference, in order
+    const QVector<int> matches = filter.matches(criteria);
+    QVector<int> expected;
+    for (int i = 0; i < m_Stars.size(); ++i)
+    {
+        if (reference(criteria, m_Stars[i]))
+            expected.append(i);
+    }
+    QCOMPARE(matches, expected);
+}
+
+void TestObsListFilter::testConstellations()
+{
+    ObsListFilter filter;
+    filter.addObjects(ObsListFilter::STARS, m_Stars);
+    filter.addObjects(ObsListFilter::COMETS, m_Comets);
+
+    // Constellations of 3 hours of right ascension
+    int located = 0;
+    auto constellation = [&](const SkyPoint * p)
+    {
+        located++;
+        return QString("C%1").arg(int(p->ra().Hours() / 3));
+    };
+
+    ObsListFilter::Criteria criteria;
+    criteria.categories     = 1u << ObsListFilter::STARS;
+    criteria.region         = ObsListFilter::CONSTELLATIONS;
+    criteria.constellations = { "C1", "C5" };
+    filter.updateConstellations(criteria, constellation);
+    QCOMPARE(located, m_Stars.size());
+
+    int expected = 0;
+    for (SkyObject *o : m_Stars)
+        expected += int(o->ra().Hours() / 3) == 1 || int(o->ra().Hours() / 3) == 5;
+    QCOMPARE(filter.count(criteria), expected);
+
+    // Objects are located once, those of newly selected categories when needed
+    filter.updateConstellations(criteria, constellation);
+    QCOMPARE(located, m_Stars.size());
+    criteria.categories |= 1u << ObsListFilter::COMETS;
+    filter.updateConstellations(criteria, constellation);
+    QCOMPARE(located, m_Stars.size() + m_Comets.size());
+    for (SkyObject *o : m_Comets)
+        expected += int(o->ra().Hours() / 3) == 1 || int(o->ra().Hours() / 3) == 5;
+    QCOMPARE(filter.count(criteria), expected);
+}
+
+void TestObsListFilter::testIncremental()
+{
+    // A filter kept across changes counts the same as a new one
+    ObsListFilter kept;
+    kept.addObjects(ObsListFilter::STARS, m_Stars);
+    kept.addObjects(ObsListFilter::COMETS, m_Comets);
+
+    QList<ObsListFilter::Criteria> changes;
+    ObsListFilter::Criteria criteria = tonight();
+    changes.append(criteria);
+    criteria.byMagnitude = true;
+    criteria.maglim      = 8.0;
+    changes.append(criteria);
+    criteria.region    = ObsListFilter::CIRCLE;
+    criteria.centerRA  = 200.0;
+    criteria.centerDec = 10.0;
+    criteria.radius    = 40.0;
+    changes.append(criteria);
+    criteria.maglim = 4.0;
+    changes.append(criteria);
+    criteria.categories = 1u << ObsListFilter::COMETS;
+    changes.append(criteria);
+    criteria.byDate = false;
+    changes.append(criteria);
+    criteria.includeNoMag = true;
+    changes.append(criteria);
+    criteria.region = ObsListFilter::ALL_SKY;
+    changes.append(criteria);
+    criteria.byDate = true;
+    criteria.siderealTimes.removeLast();
+    changes.append(criteria);
+
+    for (const auto &change : changes)
+    {
+        ObsListFilter fresh;
+        fresh.addObjects(ObsListFilter::STARS, m_Stars);
+        fresh.addObjects(ObsListFilter::COMETS, m_Comets);
+        QCOMPARE(kept.matches(change), fresh.matches(change));
+    }
+}
+
+void TestObsListFilter::benchmarkCount_data()
+{
+    QTest::addColumn<bool>("dateChanges");
+
+    QTest::newRow("magnitude changes") << false;
+    QTest::newRow("date changes") << true;
+}
+
+void TestObsListFilter::benchmarkCount()
+{
+    QFETCH(bool, dateChanges);
+
+    // A large deep sky catalog
+    const QList<SkyObject *> objects = randomObjects(500000, SkyObject::GALAXY, 3);
+    ObsListFilter filter;
+    filter.addObjects(ObsListFilter::GALAXIES, objects);
+
+    ObsListFilter::Criteria criteria = tonight();
+    criteria.byMagnitude = true;
+    filter.count(criteria);
+
+    int step = 0;
+    QBENCHMARK
+    {
+        // What a click in the wizard changes
+        step++;
+        if (dateChanges)
+            criteria.siderealTimes[0] = 250.0 + step % 10;
+        else
+            criteria.maglim = 5.0 + step % 10;
+        filter.count(criteria);
+    }
+
+    qDeleteAll(objects);
+}
+
+QTEST_GUILESS_MAIN(TestObsListFilter)
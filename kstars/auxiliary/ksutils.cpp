@@ -32,6 +32,7 @@
 #include "windows.h"
 #else //Linux
 #include <QProcess>
+#include <unistd.h>
 #endif
 
 #include <QPointer>
@@ -1735,6 +1736,32 @@ double getAvailableRAM()
     return 0;
 }
 
+double getTotalRAM()
+{
+#if defined(Q_OS_OSX)
+    int mib[] = { CTL_HW, HW_MEMSIZE };
+    int64_t memory = 0;
+    size_t length = sizeof(memory);
+    if (sysctl(mib, 2, &memory, &length, NULL, 0))
+        return 0;
+    return memory;
+#elif defined(Q_OS_LINUX)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0)
+        return 0;
+    return static_cast<double>(pages) * pageSize;
+#elif defined(Q_OS_WIN32)
+    MEMORYSTATUSEX memory_status;
+    ZeroMemory(&memory_status, sizeof(MEMORYSTATUSEX));
+    memory_status.dwLength = sizeof(MEMORYSTATUSEX);
+    if (GlobalMemoryStatusEx(&memory_status))
+        return memory_status.ullTotalPhys;
+    return 0;
+#endif
+    return 0;
+}
+
 JPLParser::JPLParser(const QString &path)
 {
     QFile jpl_file(path);
@@ -346,4 +346,10 @@ bool RAWToJPEG(const QString &rawImage, const QString &output, QString &errorMes
  */
 double getAvailableRAM();
 
+/**
+ * @brief getTotalRAM Try to get the physical RAM of the system
+ * @return Total system RAM in bytes. 0 if failed to determine RAM
+ */
+double getTotalRAM();
+
 } // namespace KSUtils
@@ -20,6 +20,7 @@
 #include "catalogscomponent.h"
 #include <KMessageBox>
 
+#include <QSet>
 #include <QSortFilterProxyModel>
 #include <QStringListModel>
 #include <QTimer>
@@ -224,74 +225,53 @@ void FindDialog::initSelection()
     listFiltered = true;
 }
 
-void FindDialog::filterByType()
+QList<int> FindDialog::filterTypes() const
 {
-    KStarsData *data = KStarsData::Instance();
-
     switch (ui->FilterType->currentIndex())
     {
-        case 0: // All object types
-        {
-            QVector<QPair<QString, const SkyObject *>> allObjects;
-            foreach (int type, data->skyComposite()->objectLists().keys())
-            {
-                allObjects.append(data->skyComposite()->objectLists(SkyObject::TYPE(type)));
-            }
-            fModel->setSkyObjectsList(allObjects);
-            break;
-        }
         case 1: //Stars
-        {
-            QVector<QPair<QString, const SkyObject *>> starObjects;
-            starObjects.append(data->skyComposite()->objectLists(SkyObject::STAR));
-            starObjects.append(data->skyComposite()->objectLists(SkyObject::CATALOG_STAR));
-            fModel->setSkyObjectsList(starObjects);
-            break;
-        }
+            return { SkyObject::STAR, SkyObject::CATALOG_STAR };
         case 2: //Solar system
-        {
-            QVector<QPair<QString, const SkyObject *>> ssObjects;
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::PLANET));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::COMET));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::ASTEROID));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::MOON));
-
-            fModel->setSkyObjectsList(ssObjects);
-            break;
-        }
+            return { SkyObject::PLANET, SkyObject::COMET, SkyObject::ASTEROID, SkyObject::MOON };
         case 3: //Open Clusters
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::OPEN_CLUSTER));
-            break;
+            return { SkyObject::OPEN_CLUSTER };
         case 4: //Globular Clusters
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GLOBULAR_CLUSTER));
-            break;
+            return { SkyObject::GLOBULAR_CLUSTER };
         case 5: //Gaseous nebulae
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GASEOUS_NEBULA));
-            break;
+            return { SkyObject::GASEOUS_NEBULA };
         case 6: //Planetary nebula
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::PLANETARY_NEBULA));
-            break;
+            return { SkyObject::PLANETARY_NEBULA };
         case 7: //Galaxies
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GALAXY));
-            break;
+            return { SkyObject::GALAXY };
         case 8: //Comets
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::COMET));
-            break;
+            return { SkyObject::COMET };
         case 9: //Asteroids
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::ASTEROID));
-            break;
+            return { SkyObject::ASTEROID };
         case 10: //Constellations
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::CONSTELLATION));
-            break;
+            return { SkyObject::CONSTELLATION };
         case 11: //Supernovae
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::SUPERNOVA));
-            break;
+            return { SkyObject::SUPERNOVA };
         case 12: //Satellites
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::SATELLITE));
-            break;
+            return { SkyObject::SATELLITE };
+        default: // All object types
+            return QList<int>();
     }
 }
 
+void FindDialog::filterByType()
+{
+    KStarsData *data = KStarsData::Instance();
+
+    QList<int> types = filterTypes();
+    if (types.isEmpty())
+        types = data->skyComposite()->objectLists().keys();
+
+    QVector<QPair<QString, const SkyObject *>> objects;
+    for (const int type : types)
+        objects.append(data->skyComposite()->objectLists(SkyObject::TYPE(type)));
+    fModel->setSkyObjectsList(objects);
+}
+
 void FindDialog::filterList()
 {
     QString SearchText = processSearchText();
@@ -318,10 +298,34 @@ void FindDialog::filterList()
             obj);
     }
 
-    sortModel->setFilterFixedString(SearchText);
     ui->InternetSearchButton->setText(i18n("Search the Internet for %1", SearchText.isEmpty() ? i18nc("no text to search for",
                                            "(nothing)") : SearchText));
-    filterByType();
+    if (SearchText.isEmpty())
+        filterByType();
+    else
+    {
+        // The name index only returns the matching objects, instead of filtering all of them in the model.
+        // The names starting with the text come first, then those containing it anywhere like the filter
+        // of the model did, and if there are none the names close to it.
+        NameIndex *nameIndex = KStarsData::Instance()->skyComposite()->nameIndex();
+        QVector<NameIndex::Match> matches = nameIndex->prefix(SearchText, filterTypes());
+        matches += nameIndex->contains(SearchText, filterTypes());
+        if (matches.isEmpty())
+            matches = nameIndex->fuzzy(SearchText, SearchText.size() > 5 ? 2 : 1, filterTypes());
+
+        QVector<QPair<QString, const SkyObject *>> objects;
+        QSet<QPair<QString, const SkyObject *>> found;
+        objects.reserve(matches.size());
+        for (const auto &match : matches)
+        {
+            const QPair<QString, const SkyObject *> object(match.name, match.object);
+            if (found.contains(object))
+                continue;
+            found.insert(object);
+            objects.append(object);
+        }
+        fModel->setSkyObjectsList(objects);
+    }
     initSelection();
 
     bool enableInternetSearch = (!exactMatchExists) && (ui->FilterType->currentIndex() == 0);
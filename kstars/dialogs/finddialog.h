@@ -78,7 +78,9 @@ class FindDialog : public QDialog
   public slots:
     /**
      * When Text is entered in the QLineEdit, filter the List of objects
-     * so that only objects which start with the filter text are shown.
+     * so that only objects which start with the filter text, or with a word
+     * starting with it, are shown. If there are none, the objects with a name
+     * close to the filter text are shown instead.
      */
     void filterList();
 
@@ -144,6 +146,9 @@ class FindDialog : public QDialog
     /** @short pre-filter the list of objects according to the selected object type. */
     void filterByType();
 
+    /** @return the object types selected by the type filter, empty for all types */
+    QList<int> filterTypes() const;
+
     FindDialogUI *ui { nullptr };
     SkyObjectListModel *fModel { nullptr };
     QSortFilterProxyModel *sortModel { nullptr };
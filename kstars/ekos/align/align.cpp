@@ -32,6 +32,7 @@
 #include "auxiliary/QProgressIndicator.h"
 #include "auxiliary/ksmessagebox.h"
 #include "ekos/auxiliary/stellarsolverprofileeditor.h"
+#include "ekos/auxiliary/incrementalsolver.h"
 #include "ksnotification.h"
 #include "kspaths.h"
 #include "fov.h"
@@ -1958,6 +1959,11 @@ void Align::startSolving()
 
     if (solverModeButtonGroup->checkedId() == SOLVER_LOCAL)
     {
+        if (!m_ImageData)
+            m_ImageData = m_AlignView->imageData();
+        if (solveIncrementally())
+            return;
+
         if(Options::solverType() != SSolver::SOLVER_ASTAP
                 && Options::solverType() != SSolver::SOLVER_WATNEYASTROMETRY) //You don't need astrometry index files to use ASTAP or Watney
         {
@@ -1987,8 +1993,6 @@ void Align::startSolving()
         }
         if (m_StellarSolver->isRunning())
             m_StellarSolver->abort();
-        if (!m_ImageData)
-            m_ImageData = m_AlignView->imageData();
         m_StellarSolver->loadNewImageBuffer(m_ImageData->getStatistics(), m_ImageData->getImageBuffer());
         m_StellarSolver->setProperty("ProcessType", SSolver::SOLVE);
         m_StellarSolver->setProperty("ExtractorType", Options::solveSextractorType());
@@ -2121,6 +2125,66 @@ void Align::startSolving()
     emit newStatus(state);
 }
 
+bool Align::solveIncrementally()
+{
+    // The image the update failed on goes to the solver
+    if (m_IncrementalSolveFailed)
+    {
+        m_IncrementalSolveFailed = false;
+        return false;
+    }
+
+    // Only the iterations after a solution, the mount having moved by the correction since.
+    if (!Options::astrometryIncrementalSolve() || m_SolveFromFile || solverIterations == 0 || sPixScale <= 0
+            || m_ImageData.isNull() || (m_PolarAlignmentAssistant && !matchPAHStage(PAA::PAH_IDLE)))
+        return false;
+
+    FITSImage::Solution guess;
+    guess.ra = range360(sRA + (m_TelescopeCoord.ra().Degrees() - sTelescopeCoord.ra().Degrees()));
+    guess.dec = sDEC + (m_TelescopeCoord.dec().Degrees() - sTelescopeCoord.dec().Degrees());
+    guess.orientation = sOrientation;
+    guess.pixscale = sPixScale;
+    guess.parity = sEastToTheRight ? FITSImage::NEGATIVE : FITSImage::POSITIVE;
+    if (std::fabs(guess.dec) > 90)
+        return false;
+
+    m_IncrementalSolver.reset(new IncrementalSolver(guess), &QObject::deleteLater);
+    auto params = m_StellarSolverProfiles.at(Options::solveOptionsProfile());
+    params.partition = Options::stellarSolverPartition();
+    m_IncrementalSolver->setParameters(params);
+    connect(m_IncrementalSolver.get(), &IncrementalSolver::done, this, &Align::incrementalSolverDone);
+    if (!m_IncrementalSolver->start(m_ImageData))
+    {
+        qCDebug(KSTARS_EKOS_ALIGN) << "Incremental solve skipped," << m_IncrementalSolver->failure();
+        m_IncrementalSolver.reset();
+        return false;
+    }
+
+    solverTimer.start();
+    state = ALIGN_PROGRESS;
+    emit newStatus(state);
+    return true;
+}
+
+void Align::incrementalSolverDone(bool success)
+{
+    disconnect(m_IncrementalSolver.get(), &IncrementalSolver::done, this, &Align::incrementalSolverDone);
+
+    if (!success)
+    {
+        qCDebug(KSTARS_EKOS_ALIGN) << "Incremental solve failed," << m_IncrementalSolver->failure();
+        m_IncrementalSolveFailed = true;
+        startSolving();
+        return;
+    }
+
+    qCDebug(KSTARS_EKOS_ALIGN) << "Incremental solve matched" << m_IncrementalSolver->matchedStars() << "stars, residual"
+                               << m_IncrementalSolver->residual() << "pixels";
+    const FITSImage::Solution solution = m_IncrementalSolver->solution();
+    solverFinished(solution.orientation, solution.ra, solution.dec, solution.pixscale,
+                   solution.parity != FITSImage::POSITIVE);
+}
+
 void Align::solverComplete()
 {
     disconnect(m_StellarSolver.get(), &StellarSolver::ready, this, &Align::solverComplete);
@@ -2149,6 +2213,9 @@ void Align::solverFinished(double orientation, double ra, double dec, double pix
     sOrientation = orientation;
     sRA          = ra;
     sDEC         = dec;
+    sPixScale    = pixscale;
+    sEastToTheRight = eastToTheRight;
+    sTelescopeCoord = m_TelescopeCoord;
 
     double elapsed = solverTimer.elapsed() / 1000.0;
     appendLogText(i18n("Solver completed after %1 seconds.", QString::number(elapsed, 'f', 2)));
@@ -2522,6 +2589,12 @@ void Align::solverFailed()
 void Align::stop(Ekos::AlignState mode)
 {
     m_CaptureTimer.stop();
+    if (m_IncrementalSolver)
+    {
+        // Drop the update in progress
+        disconnect(m_IncrementalSolver.get(), &IncrementalSolver::done, this, &Align::incrementalSolverDone);
+        m_IncrementalSolver.reset();
+    }
     if (solverModeButtonGroup->checkedId() == SOLVER_LOCAL)
         m_StellarSolver->abort();
     else if (solverModeButtonGroup->checkedId() == SOLVER_REMOTE && remoteParser)
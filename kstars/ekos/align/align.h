@@ -39,6 +39,7 @@ class AlignView;
 class FOV;
 class StarObject;
 class ProfileInfo;
+class IncrementalSolver;
 
 namespace Ekos
 {
@@ -637,6 +638,18 @@ class Align : public QWidget, public Ui::Align
          */
         void calculateAlignTargetDiff();
 
+        /**
+         * @brief solveIncrementally Start updating the last solution from the catalog stars around the current
+         * pointing, so that re-centring iterations do not run the solver.
+         * @return true if the update was started, false if the solver is needed.
+         */
+        bool solveIncrementally();
+
+        /**
+         * @brief incrementalSolverDone Process the updated solution, or run the solver if the update failed.
+         */
+        void incrementalSolverDone(bool success);
+
         /**
              * @brief Get formatted RA & DEC coordinates compatible with astrometry.net format.
              * @param ra Right ascension
@@ -731,6 +744,10 @@ class Align : public QWidget, public Ui::Align
         double sOrientation { INVALID_VALUE };
         double sRA { INVALID_VALUE };
         double sDEC { INVALID_VALUE };
+        double sPixScale { INVALID_VALUE };
+        bool sEastToTheRight { false };
+        // Telescope coordinates when the last solution was found
+        SkyPoint sTelescopeCoord;
 
         /// Solver alignment coordinates
         SkyPoint m_AlignCoord;
@@ -751,6 +768,9 @@ class Align : public QWidget, public Ui::Align
 
         // The StellarSolver
         std::unique_ptr<StellarSolver> m_StellarSolver;
+        // The update of the last solution, and whether it failed on the image to solve
+        QSharedPointer<IncrementalSolver> m_IncrementalSolver;
+        bool m_IncrementalSolveFailed { false };
         // StellarSolver Profiles
         QList<SSolver::Parameters> m_StellarSolverProfiles;
 
@@ -14,6 +14,7 @@
 #include "ksmessagebox.h"
 #include "ekos/auxiliary/stellarsolverprofile.h"
 #include "ekos/auxiliary/solverutils.h"
+#include "ekos/auxiliary/incrementalsolver.h"
 #include "Options.h"
 #include "QProgressIndicator.h"
 #include "polaralignwidget.h"
@@ -144,6 +145,12 @@ void PolarAlignmentAssistant::setEnabled(bool enabled)
 
 // This solver is only used by the refresh plate-solving scheme.
 void PolarAlignmentAssistant::startSolver()
+{
+    if (!solveIncrementally())
+        startRefreshSolver();
+}
+
+void PolarAlignmentAssistant::startRefreshSolver()
 {
     auto profiles = getDefaultAlignOptionsProfiles();
     auto parameters = profiles.at(Options::solveOptionsProfile());
@@ -203,38 +210,95 @@ void PolarAlignmentAssistant::solverDone(bool timedOut, bool success, const FITS
     else
     {
         m_NumHealpixFailures = 0;
-        refreshIteration++;
-        const double ra = solution.ra;
-        const double dec = solution.dec;
-        m_LastRa = solution.ra;
-        m_LastDec = solution.dec;
-        m_LastOrientation = solution.orientation;
-        m_LastPixscale = solution.pixscale;
-
-        emit newLog(QString("Refresh solver success %1s: ra %2 dec %3 scale %4")
-                    .arg(elapsedSeconds, 0, 'f', 1).arg(ra, 0, 'f', 3)
-                    .arg(dec, 0, 'f', 3).arg(solution.pixscale));
-
-        // RA is input in hours, not degrees!
-        SkyPoint refreshCoords(ra / 15.0, dec);
-        double azError = 0, altError = 0;
-        if (polarAlign.processRefreshCoords(refreshCoords, m_ImageData->getDateTime(), &azError, &altError))
-        {
-            updateRefreshDisplay(azError, altError);
+        processRefreshSolution(solution, elapsedSeconds);
+    }
+    // Start the next refresh capture.
+    emit captureAndSolve();
+}
 
-            const bool eastToTheRight = solution.parity == FITSImage::POSITIVE ? false : true;
-            // The 2nd false means don't block. The code below doesn't work if we block
-            // because wcsToPixel in updateTriangle() depends on the injectWCS being finished.
-            m_AlignView->injectWCS(solution.orientation, ra, dec, solution.pixscale, eastToTheRight, false, false);
-            updatePlateSolveTriangle(m_ImageData);
-        }
-        else
-            emit newLog(QString("Could not estimate mount rotation"));
+// Knob adjustments move the field by a few arcminutes from the last solution, so most refreshes
+// are solved from the catalog stars around it, and the solver only runs when that fails.
+bool PolarAlignmentAssistant::solveIncrementally()
+{
+    if (!Options::astrometryIncrementalSolve() || m_LastPixscale <= 0 || m_ImageData.isNull())
+        return false;
+
+    FITSImage::Solution guess;
+    guess.ra = m_LastRa;
+    guess.dec = m_LastDec;
+    guess.orientation = m_LastOrientation;
+    guess.pixscale = m_LastPixscale;
+    guess.parity = m_LastEastToTheRight ? FITSImage::NEGATIVE : FITSImage::POSITIVE;
+
+    QElapsedTimer timer;
+    timer.start();
+    m_IncrementalSolver.reset(new IncrementalSolver(guess), &QObject::deleteLater);
+    connect(m_IncrementalSolver.get(), &IncrementalSolver::done, this, [this, timer](bool success)
+    {
+        incrementalSolverDone(success, timer.elapsed() / 1000.0);
+    });
+    if (!m_IncrementalSolver->start(m_ImageData))
+    {
+        qCDebug(KSTARS_EKOS_ALIGN) << "PAA Refresh: incremental solve skipped," << m_IncrementalSolver->failure();
+        m_IncrementalSolver.reset();
+        return false;
     }
+    return true;
+}
+
+void PolarAlignmentAssistant::incrementalSolverDone(bool success, double elapsedSeconds)
+{
+    disconnect(m_IncrementalSolver.get(), &IncrementalSolver::done, this, nullptr);
+
+    if (m_PAHStage != PAH_REFRESH)
+        return;
+
+    if (!success)
+    {
+        qCDebug(KSTARS_EKOS_ALIGN) << "PAA Refresh: incremental solve failed," << m_IncrementalSolver->failure();
+        startRefreshSolver();
+        return;
+    }
+
+    qCDebug(KSTARS_EKOS_ALIGN) << "PAA Refresh: incremental solve matched" << m_IncrementalSolver->matchedStars()
+                               << "stars, residual" << m_IncrementalSolver->residual() << "pixels";
+    processRefreshSolution(m_IncrementalSolver->solution(), elapsedSeconds);
     // Start the next refresh capture.
     emit captureAndSolve();
 }
 
+void PolarAlignmentAssistant::processRefreshSolution(const FITSImage::Solution &solution, double elapsedSeconds)
+{
+    refreshIteration++;
+    const double ra = solution.ra;
+    const double dec = solution.dec;
+    const bool eastToTheRight = solution.parity == FITSImage::POSITIVE ? false : true;
+    m_LastRa = solution.ra;
+    m_LastDec = solution.dec;
+    m_LastOrientation = solution.orientation;
+    m_LastPixscale = solution.pixscale;
+    m_LastEastToTheRight = eastToTheRight;
+
+    emit newLog(QString("Refresh solver success %1s: ra %2 dec %3 scale %4")
+                .arg(elapsedSeconds, 0, 'f', 1).arg(ra, 0, 'f', 3)
+                .arg(dec, 0, 'f', 3).arg(solution.pixscale));
+
+    // RA is input in hours, not degrees!
+    SkyPoint refreshCoords(ra / 15.0, dec);
+    double azError = 0, altError = 0;
+    if (polarAlign.processRefreshCoords(refreshCoords, m_ImageData->getDateTime(), &azError, &altError))
+    {
+        updateRefreshDisplay(azError, altError);
+
+        // The 2nd false means don't block. The code below doesn't work if we block
+        // because wcsToPixel in updateTriangle() depends on the injectWCS being finished.
+        m_AlignView->injectWCS(solution.orientation, ra, dec, solution.pixscale, eastToTheRight, false, false);
+        updatePlateSolveTriangle(m_ImageData);
+    }
+    else
+        emit newLog(QString("Could not estimate mount rotation"));
+}
+
 void PolarAlignmentAssistant::updatePlateSolveTriangle(const QSharedPointer<FITSData> &image)
 {
     if (image.isNull())
@@ -1079,6 +1143,7 @@ void PolarAlignmentAssistant::processPAHStage(double orientation, double ra, dou
         m_LastDec = dec;
         m_LastOrientation = orientation;
         m_LastPixscale = pixscale;
+        m_LastEastToTheRight = eastToTheRight;
 
         bool doWcs = (m_PAHStage == PAH_THIRD_SOLVE) || !Options::limitedResourcesMode();
         if (doWcs)
@@ -17,6 +17,7 @@
 
 class QProgressIndicator;
 class SolverUtils;
+class IncrementalSolver;
 
 namespace Ekos
 {
@@ -216,6 +217,11 @@ class PolarAlignmentAssistant : public QWidget, public Ui::PolarAlignmentAssista
         // These are only used in the plate-solve refresh scheme.
         void solverDone(bool timedOut, bool success, const FITSImage::Solution &solution, double elapsedSeconds);
         void startSolver();
+        void startRefreshSolver();
+        // Starts solving the refresh image from the last solution, returns false if the solver is needed.
+        bool solveIncrementally();
+        void incrementalSolverDone(bool success, double elapsedSeconds);
+        void processRefreshSolution(const FITSImage::Solution &solution, double elapsedSeconds);
         void updatePlateSolveTriangle(const QSharedPointer<FITSData> &image);
 
         // Polar Alignment Helper
@@ -273,10 +279,12 @@ class PolarAlignmentAssistant : public QWidget, public Ui::PolarAlignmentAssista
 
         // Used in the refresh part of polar alignment.
         QSharedPointer<SolverUtils> m_Solver;
+        QSharedPointer<IncrementalSolver> m_IncrementalSolver;
         double m_LastRa {0};
         double m_LastDec {0};
         double m_LastOrientation {0};
         double m_LastPixscale {0};
+        bool m_LastEastToTheRight {false};
 
         // Restricts (the internal solver) to using the index and healpix
         // from the previous solve, if that solve was successful.
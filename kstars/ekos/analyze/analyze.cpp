@@ -17,6 +17,7 @@
 #include "ekos/manager.h"
 #include "fitsviewer/fitsdata.h"
 #include "fitsviewer/fitsviewer.h"
+#include "fitsviewer/previewcache.h"
 #include "ksmessagebox.h"
 #include "kstars.h"
 #include "Options.h"
@@ -346,6 +347,7 @@ Analyze::Analyze()
     connect(zoomOutB, &QPushButton::clicked, this, &Ekos::Analyze::zoomOut);
     connect(timelinePlot, &QCustomPlot::mousePress, this, &Ekos::Analyze::timelineMousePress);
     connect(timelinePlot, &QCustomPlot::mouseDoubleClick, this, &Ekos::Analyze::timelineMouseDoubleClick);
+    connect(PreviewCache::Instance(), &PreviewCache::ready, this, &Ekos::Analyze::previewReady);
     connect(timelinePlot, &QCustomPlot::mouseWheel, this, &Ekos::Analyze::timelineMouseWheel);
     connect(statsPlot, &QCustomPlot::mousePress, this, &Ekos::Analyze::statsMousePress);
     connect(statsPlot, &QCustomPlot::mouseDoubleClick, this, &Ekos::Analyze::statsMouseDoubleClick);
@@ -922,6 +924,7 @@ void Analyze::Session::setupTable(const QString &name, const QString &status,
 {
     details = table;
     details->clear();
+    details->clearSpans();
     details->setRowCount(0);
     details->setEditTriggers(QAbstractItemView::NoEditTriggers);
     details->setColumnCount(3);
@@ -1013,7 +1016,12 @@ void Analyze::captureSessionClicked(CaptureSession &c, bool doubleClick)
 
     c.addRow("Exposure", QString::number(c.duration, 'f', 2));
     if (!c.isTemporary())
+    {
         c.addRow("Filename", c.filename);
+        // The preview is added to the details once built, if the file can be found.
+        previewFilename = findFilename(c.filename, alternateFolder);
+        PreviewCache::Instance()->request(previewFilename);
+    }
 
     if (doubleClick && !c.isTemporary())
     {
@@ -1984,6 +1992,50 @@ void Analyze::resetGraphicsPlot()
     graphicsPlot->clearItems();
 }
 
+// Adds the statistics and the preview of a capture to its details, if they are still displayed.
+void Analyze::previewReady(const QString &filename)
+{
+    if (filename.isEmpty() || filename != previewFilename)
+        return;
+
+    const QString name = QFileInfo(filename).fileName();
+    bool displayed = false;
+    for (int row = 0; row < detailsTable->rowCount(); row++)
+    {
+        const QTableWidgetItem *key = detailsTable->item(row, 0);
+        const QTableWidgetItem *value = detailsTable->item(row, 1);
+        if (key == nullptr)
+            continue;
+        if (key->text() == "Preview")
+            return;
+        if (key->text() == "Filename" && value != nullptr && QFileInfo(value->text()).fileName() == name)
+            displayed = true;
+    }
+
+    PreviewCache::Entry preview;
+    if (!displayed || !PreviewCache::Instance()->find(filename, preview))
+        return;
+
+    if (preview.hfr > 0)
+        addDetailsRow(detailsTable, "HFR", Qt::yellow, QString::number(preview.hfr, 'f', 2), Qt::white);
+    if (preview.stars >= 0)
+        addDetailsRow(detailsTable, "Stars", Qt::yellow, QString::number(preview.stars), Qt::white);
+    if (preview.median >= 0)
+        addDetailsRow(detailsTable, "Median", Qt::yellow, QString::number(preview.median, 'f', 0), Qt::white);
+
+    const QImage image = preview.toImage();
+    if (image.isNull())
+        return;
+    const QPixmap thumbnail = QPixmap::fromImage(image.scaledToWidth(
+                                  std::max(100, detailsTable->viewport()->width() - 110), Qt::SmoothTransformation));
+
+    addDetailsRow(detailsTable, "Preview", Qt::yellow, "", Qt::white);
+    const int row = detailsTable->rowCount() - 1;
+    detailsTable->item(row, 1)->setData(Qt::DecorationRole, thumbnail);
+    detailsTable->setSpan(row, 1, 1, 2);
+    detailsTable->setRowHeight(row, thumbnail.height() + 4);
+}
+
 void Analyze::displayFITS(const QString &filename)
 {
     QUrl url = QUrl::fromLocalFile(filename);
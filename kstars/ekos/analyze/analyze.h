@@ -242,6 +242,8 @@ class Analyze : public QWidget, public Ui::Analyze
         void alignSessionClicked(AlignSession &c, bool doubleClick);
         void mountFlipSessionClicked(MountFlipSession &c, bool doubleClick);
         void schedulerSessionClicked(SchedulerJobSession &c, bool doubleClick);
+        // Called when the preview of a capture was built.
+        void previewReady(const QString &filename);
 
         // Low-level callbacks.
         // These two call processTimelineClick().
@@ -420,6 +422,8 @@ class Analyze : public QWidget, public Ui::Analyze
         // When trying to load a FITS file, if the original file path doesn't
         // work, Analyze tries to find the file under the alternate folder.
         QString alternateFolder;
+        // File of the capture whose details are displayed, for its preview.
+        QString previewFilename;
 
         // The vertical line in the stats plot.
         QCPItemLine *statsCursor { nullptr };
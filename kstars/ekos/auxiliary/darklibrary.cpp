@@ -18,6 +18,7 @@
 #include "kstarsdata.h"
 #include "fitsviewer/fitsdata.h"
 #include "fitsviewer/fitsview.h"
+#include "fitsviewer/framebufferpool.h"
 
 #include "ekos_debug.h"
 
@@ -359,9 +360,13 @@ bool DarkLibrary::findDarkFrame(ISD::CameraChip *m_TargetChip, double duration,
     }
 
     // Before adding to cache, clear the cache if memory drops too low.
+    // The frames dropped return their buffers to the pool, which are freed as well.
     auto memoryMB = KSUtils::getAvailableRAM() / 1e6;
     if (memoryMB < CACHE_MEMORY_LIMIT)
+    {
         m_CachedDarkFrames.clear();
+        FrameBufferPool::Instance()->trim();
+    }
 
     // Finally we made it, let's put it in the hash
     if (cacheDarkFrameFromFile(filename))
@@ -0,0 +1,451 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "incrementalsolver.h"
+
+#include "fitsviewer/fitsdata.h"
+#include "ekos/auxiliary/stellarsolverprofile.h"
+#include "kstarsdata.h"
+#include "skycomponents/starcomponent.h"
+#include "Options.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Bright stars of the frame and of the catalog paired to find the offset of the frame
+constexpr int VOTING_STARS = 50;
+// Size in pixels of the bins of the offsets voted for, also the tolerance of the first match
+constexpr double VOTING_BIN = 8.0;
+// Rounds of matching and fitting, the tolerance shrinking to three times the residual
+constexpr int FITTING_ROUNDS = 4;
+// Largest change of scale from the expected solution
+constexpr double MAXIMUM_SCALE_CHANGE = 0.05;
+
+constexpr double DEG = M_PI / 180;
+
+/* Standard coordinates in degrees of (ra, dec) on the plane tangent to the sky at (ra0, dec0).
+ * Return false for points on the other side of the sky.
+ */
+bool project(double ra0, double dec0, double ra, double dec, double &xi, double &eta)
+{
+    double const dra = (ra - ra0) * DEG;
+    double const d = std::sin(dec * DEG) * std::sin(dec0 * DEG) + std::cos(dec * DEG) * std::cos(dec0 * DEG) * std::cos(dra);
+    if (d <= 0)
+        return false;
+    xi = std::cos(dec * DEG) * std::sin(dra) / d / DEG;
+    eta = (std::sin(dec * DEG) * std::cos(dec0 * DEG) - std::cos(dec * DEG) * std::sin(dec0 * DEG) * std::cos(dra)) / d / DEG;
+    return true;
+}
+
+// Position of the standard coordinates (xi, eta) in degrees on the plane tangent to the sky at (ra0, dec0)
+void deproject(double ra0, double dec0, double xi, double eta, double &ra, double &dec)
+{
+    xi *= DEG;
+    eta *= DEG;
+    double const c = std::cos(dec0 * DEG) - eta * std::sin(dec0 * DEG);
+    ra = std::fmod(ra0 + std::atan2(xi, c) / DEG + 360, 360);
+    dec = std::atan2(std::sin(dec0 * DEG) + eta * std::cos(dec0 * DEG), std::hypot(xi, c)) / DEG;
+}
+
+/* Linear WCS from pixels, relative to the center of the frame, to the tangent plane, in degrees.
+ * xi = a[0] * dx + a[1] * dy + a[2], eta = b[0] * dx + b[1] * dy + b[2]
+ */
+struct Wcs
+{
+    double a[3] { 0, 0, 0 };
+    double b[3] { 0, 0, 0 };
+
+    double determinant() const
+    {
+        return a[0] * b[1] - a[1] * b[0];
+    }
+
+    bool toPixel(double xi, double eta, double &dx, double &dy) const
+    {
+        double const det = determinant();
+        if (det == 0)
+            return false;
+        xi -= a[2];
+        eta -= b[2];
+        dx = (b[1] * xi - a[1] * eta) / det;
+        dy = (a[0] * eta - b[0] * xi) / det;
+        return true;
+    }
+};
+
+/* WCS of a solution, with the conventions of FITSData::injectWCS: CDELT1 is negative unless east is to the right,
+ * and CROTA2 is the opposite of the orientation.
+ */
+Wcs fromSolution(const FITSImage::Solution &solution)
+{
+    double const scale = solution.pixscale / 3600;
+    double const parity = solution.parity == FITSImage::POSITIVE ? -1 : 1;
+    double const rotation = -solution.orientation * DEG;
+    Wcs wcs;
+    wcs.a[0] = parity * scale * std::cos(rotation);
+    wcs.a[1] = -scale * std::sin(rotation);
+    wcs.b[0] = parity * scale * std::sin(rotation);
+    wcs.b[1] = scale * std::cos(rotation);
+    return wcs;
+}
+
+// Least squares fit of value = c[0] * x + c[1] * y + c[2], false if the points are aligned
+bool fitPlane(const QVector<double> &x, const QVector<double> &y, const QVector<double> &value, double c[3])
+{
+    double sxx = 0, sxy = 0, syy = 0, sx = 0, sy = 0, sv = 0, sxv = 0, syv = 0;
+    int const n = x.size();
+    for (int i = 0; i < n; i++)
+    {
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+        syy += y[i] * y[i];
+        sx += x[i];
+        sy += y[i];
+        sv += value[i];
+        sxv += x[i] * value[i];
+        syv += y[i] * value[i];
+    }
+
+    // Cramer's rule on the normal equations
+    double const det = sxx * (syy * n - sy * sy) - sxy * (sxy * n - sy * sx) + sx * (sxy * sy - syy * sx);
+    if (std::fabs(det) < 1e-9 * std::max(1.0, sxx * syy * n))
+        return false;
+    c[0] = (sxv * (syy * n - sy * sy) - sxy * (syv * n - sy * sv) + sx * (syv * sy - syy * sv)) / det;
+    c[1] = (sxx * (syv * n - sy * sv) - sxv * (sxy * n - sy * sx) + sx * (sxy * sv - syv * sx)) / det;
+    c[2] = (sxx * (syy * sv - sy * syv) - sxy * (sxy * sv - sx * syv) + sxv * (sxy * sy - syy * sx)) / det;
+    return true;
+}
+
+struct Projected
+{
+    double ra, dec, xi, eta, mag;
+};
+
+// Largest offset in pixels between the expected and the actual position of a star
+double searchMargin(const FITSImage::Solution &guess, double searchRadius, int width, int height)
+{
+    return std::min(searchRadius * 60 / guess.pixscale, static_cast<double>(std::max(width, height)));
+}
+
+// Reference stars expected on a width x height frame, the pointing error aside
+QVector<Projected> projectReferences(const QVector<IncrementalSolver::ReferenceStar> &stars, double ra0, double dec0,
+                                     const Wcs &wcs, int width, int height, double margin)
+{
+    QVector<Projected> references;
+    for (auto const &star : stars)
+    {
+        Projected p { star.ra, star.dec, 0, 0, star.mag };
+        double dx, dy;
+        if (!project(ra0, dec0, star.ra, star.dec, p.xi, p.eta) || !wcs.toPixel(p.xi, p.eta, dx, dy))
+            continue;
+        if (std::fabs(dx) <= width / 2.0 + margin && std::fabs(dy) <= height / 2.0 + margin)
+            references.append(p);
+    }
+    return references;
+}
+
+// Stars of the image, detected as the solver would without changing the image or its detected stars
+QList<FITSImage::Star> extractStars(const QSharedPointer<FITSData> &image, const SSolver::Parameters &parameters)
+{
+    QScopedPointer<StellarSolver, QScopedPointerDeleteLater> solver(new StellarSolver(image->getStatistics(),
+            image->getImageBuffer()));
+    solver->setParameters(parameters);
+    solver->setLogLevel(SSolver::LOG_NONE);
+    solver->setSSLogLevel(SSolver::LOG_OFF);
+    solver->extract(false);
+    return solver->getStarList();
+}
+
+struct Detected
+{
+    double dx, dy, flux;
+};
+
+struct Match
+{
+    int reference, detected;
+    double distance;
+};
+}
+
+IncrementalSolver::IncrementalSolver(const FITSImage::Solution &guess, QObject *parent) : QObject(parent), m_Guess(guess)
+{
+    QList<SSolver::Parameters> const profiles = Ekos::getDefaultAlignOptionsProfiles();
+    if (Options::solveOptionsProfile() >= 0 && Options::solveOptionsProfile() < profiles.size())
+        m_Parameters = profiles.at(Options::solveOptionsProfile());
+    m_Parameters.partition = Options::stellarSolverPartition();
+
+    connect(&m_Watcher, &QFutureWatcher<QList<FITSImage::Star>>::finished, this, [this]()
+    {
+        emit done(solve(m_Watcher.result(), m_Width, m_Height));
+    });
+}
+
+bool IncrementalSolver::fail(const QString &reason)
+{
+    m_Failure = reason;
+    return false;
+}
+
+void IncrementalSolver::loadCatalogStars(int width, int height)
+{
+    m_References.clear();
+    StarComponent *catalog = StarComponent::Instance();
+    if (catalog == nullptr || KStarsData::Instance() == nullptr || m_Guess.pixscale <= 0)
+        return;
+
+    SkyPoint center;
+    center.setRA0(m_Guess.ra / 15.0);
+    center.setDec0(m_Guess.dec);
+    center.apparentCoord(static_cast<long double>(J2000), KStarsData::Instance()->ut().djd());
+
+    double const radius = std::hypot(width, height) / 2 * m_Guess.pixscale / 3600 + m_SearchRadius / 60;
+    QList<StarObject *> stars;
+    catalog->starsInAperture(stars, center, radius);
+
+    m_References.reserve(stars.size());
+    for (auto const &star : stars)
+        m_References.append({star->ra0().Degrees(), star->dec0().Degrees(), star->mag()});
+}
+
+bool IncrementalSolver::prepare(const QSharedPointer<FITSData> &image)
+{
+    m_Detected = 0;
+    m_Matched = 0;
+    m_Residual = 0;
+    m_Failure.clear();
+
+    if (image.isNull())
+        return fail("No image");
+    if (m_Guess.pixscale <= 0)
+        return fail("No expected scale");
+
+    // Without enough catalog stars in the field, detecting the stars of the frame is not worth it
+    if (m_References.isEmpty())
+        loadCatalogStars(image->width(), image->height());
+    int const references = projectReferences(m_References, m_Guess.ra, m_Guess.dec, fromSolution(m_Guess), image->width(),
+                           image->height(), searchMargin(m_Guess, m_SearchRadius, image->width(), image->height())).size();
+    if (references < MINIMUM_MATCHES)
+        return fail(QString("%1 catalog stars in the field").arg(references));
+
+    return true;
+}
+
+bool IncrementalSolver::start(const QSharedPointer<FITSData> &image)
+{
+    if (m_Watcher.isRunning() || !prepare(image))
+        return false;
+
+    m_Width = image->width();
+    m_Height = image->height();
+    m_Watcher.setFuture(QtConcurrent::run(&extractStars, image, m_Parameters));
+    return true;
+}
+
+bool IncrementalSolver::solve(const QSharedPointer<FITSData> &image)
+{
+    if (!prepare(image))
+        return false;
+
+    return solve(extractStars(image, m_Parameters), image->width(), image->height());
+}
+
+bool IncrementalSolver::solve(const QList<FITSImage::Star> &stars, int width, int height)
+{
+    m_Detected = stars.size();
+    m_Matched = 0;
+    m_Residual = 0;
+    m_Failure.clear();
+
+    if (m_Guess.pixscale <= 0)
+        return fail("No expected scale");
+
+    double const cx = width / 2.0, cy = height / 2.0;
+    double const margin = searchMargin(m_Guess, m_SearchRadius, width, height);
+    Wcs wcs = fromSolution(m_Guess);
+    double ra0 = m_Guess.ra, dec0 = m_Guess.dec;
+
+    QVector<Projected> references = projectReferences(m_References, ra0, dec0, wcs, width, height, margin);
+    if (references.size() < MINIMUM_MATCHES)
+        return fail(QString("%1 catalog stars in the field").arg(references.size()));
+
+    QVector<Detected> detected;
+    detected.reserve(stars.size());
+    for (auto const &star : stars)
+        detected.append({star.x - cx, star.y - cy, star.flux});
+    if (detected.size() < MINIMUM_MATCHES)
+        return fail(QString("%1 stars detected").arg(detected.size()));
+
+    std::sort(references.begin(), references.end(), [](const Projected & a, const Projected & b)
+    {
+        return a.mag < b.mag;
+    });
+    std::sort(detected.begin(), detected.end(), [](const Detected & a, const Detected & b)
+    {
+        return a.flux > b.flux;
+    });
+
+    // Vote for the offset between the bright catalog stars and the bright detected stars
+    int const bins = static_cast<int>(std::ceil(2 * margin / VOTING_BIN)) + 1;
+    std::vector<int> votes(bins * bins, 0);
+    QVector<QPointF> predicted;
+    for (int r = 0; r < std::min(VOTING_STARS, references.size()); r++)
+    {
+        double dx, dy;
+        wcs.toPixel(references[r].xi, references[r].eta, dx, dy);
+        predicted.append(QPointF(dx, dy));
+    }
+    auto const forEachOffset = [&](auto function)
+    {
+        for (auto const &p : predicted)
+            for (int d = 0; d < std::min(VOTING_STARS, detected.size()); d++)
+            {
+                double const ox = detected[d].dx - p.x(), oy = detected[d].dy - p.y();
+                if (std::fabs(ox) <= margin && std::fabs(oy) <= margin)
+                    function(ox, oy, static_cast<int>((ox + margin) / VOTING_BIN), static_cast<int>((oy + margin) / VOTING_BIN));
+            }
+    };
+    forEachOffset([&](double, double, int bx, int by)
+    {
+        votes[by * bins + bx]++;
+    });
+
+    // Best square of two by two bins, so that an offset on the border of a bin is not split
+    int bestX = 0, bestY = 0, bestVotes = 0;
+    for (int by = 0; by + 1 < bins; by++)
+        for (int bx = 0; bx + 1 < bins; bx++)
+        {
+            int const sum = votes[by * bins + bx] + votes[by * bins + bx + 1] + votes[(by + 1) * bins + bx] +
+                            votes[(by + 1) * bins + bx + 1];
+            if (sum > bestVotes)
+            {
+                bestVotes = sum;
+                bestX = bx;
+                bestY = by;
+            }
+        }
+    if (bestVotes < 3)
+        return fail("No consistent offset between the catalog and the frame");
+
+    double offsetX = 0, offsetY = 0;
+    int offsets = 0;
+    forEachOffset([&](double ox, double oy, int bx, int by)
+    {
+        if (bx - bestX >= 0 && bx - bestX <= 1 && by - bestY >= 0 && by - bestY <= 1)
+        {
+            offsetX += ox;
+            offsetY += oy;
+            offsets++;
+        }
+    });
+    offsetX /= offsets;
+    offsetY /= offsets;
+
+    // The detected stars are where the catalog stars are expected, moved by the offset
+    wcs.a[2] = -(wcs.a[0] * offsetX + wcs.a[1] * offsetY);
+    wcs.b[2] = -(wcs.b[0] * offsetX + wcs.b[1] * offsetY);
+
+    QVector<Match> matches;
+    double tolerance = VOTING_BIN;
+    for (int round = 0; round <= FITTING_ROUNDS; round++)
+    {
+        // Pair each catalog star with the nearest detected star, each detected star being paired once
+        QVector<Match> candidates;
+        for (int r = 0; r < references.size(); r++)
+        {
+            double dx, dy;
+            if (!wcs.toPixel(references[r].xi, references[r].eta, dx, dy))
+                return fail("Degenerate solution");
+            if (std::fabs(dx) > cx + tolerance || std::fabs(dy) > cy + tolerance)
+                continue;
+            Match nearest { r, -1, tolerance };
+            for (int d = 0; d < detected.size(); d++)
+            {
+                double const distance = std::hypot(detected[d].dx - dx, detected[d].dy - dy);
+                if (distance < nearest.distance)
+                {
+                    nearest.detected = d;
+                    nearest.distance = distance;
+                }
+            }
+            if (nearest.detected >= 0)
+                candidates.append(nearest);
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Match & a, const Match & b)
+        {
+            return a.distance < b.distance;
+        });
+        std::vector<bool> paired(detected.size(), false);
+        matches.clear();
+        for (auto const &match : candidates)
+            if (!paired[match.detected])
+            {
+                paired[match.detected] = true;
+                matches.append(match);
+            }
+
+        if (matches.size() < MINIMUM_MATCHES)
+            return fail(QString("%1 stars matched").arg(matches.size()));
+
+        // On the last round, move the tangent point to the center of the frame
+        if (round == FITTING_ROUNDS)
+        {
+            deproject(ra0, dec0, wcs.a[2], wcs.b[2], ra0, dec0);
+            for (auto &reference : references)
+                project(ra0, dec0, reference.ra, reference.dec, reference.xi, reference.eta);
+        }
+
+        QVector<double> x, y, xi, eta;
+        for (auto const &match : matches)
+        {
+            x.append(detected[match.detected].dx);
+            y.append(detected[match.detected].dy);
+            xi.append(references[match.reference].xi);
+            eta.append(references[match.reference].eta);
+        }
+        if (!fitPlane(x, y, xi, wcs.a) || !fitPlane(x, y, eta, wcs.b))
+            return fail("Degenerate solution");
+
+        double squares = 0;
+        for (auto const &match : matches)
+        {
+            double dx, dy;
+            wcs.toPixel(references[match.reference].xi, references[match.reference].eta, dx, dy);
+            squares += std::pow(detected[match.detected].dx - dx, 2) + std::pow(detected[match.detected].dy - dy, 2);
+        }
+        m_Residual = std::sqrt(squares / matches.size());
+        tolerance = std::max(1.0, 3 * m_Residual);
+    }
+    m_Matched = matches.size();
+    deproject(ra0, dec0, wcs.a[2], wcs.b[2], ra0, dec0);
+
+    if (m_Residual > MAXIMUM_RESIDUAL)
+        return fail(QString("Residual of %1 pixels").arg(m_Residual, 0, 'f', 2));
+
+    double const determinant = wcs.determinant();
+    double const pixscale = std::sqrt(std::fabs(determinant)) * 3600;
+    if (std::fabs(pixscale / m_Guess.pixscale - 1) > MAXIMUM_SCALE_CHANGE)
+        return fail(QString("Scale of %1 arcsec/pixel").arg(pixscale, 0, 'f', 3));
+    if ((determinant > 0) != (fromSolution(m_Guess).determinant() > 0))
+        return fail("Parity changed");
+
+    double const parity = determinant > 0 ? 1 : -1;
+    double const rotation = std::atan2(parity * wcs.b[0] - wcs.a[1], parity * wcs.a[0] + wcs.b[1]) / DEG;
+
+    m_Solution = m_Guess;
+    m_Solution.ra = ra0;
+    m_Solution.dec = dec0;
+    m_Solution.pixscale = pixscale;
+    m_Solution.orientation = -rotation;
+    m_Solution.parity = determinant > 0 ? FITSImage::NEGATIVE : FITSImage::POSITIVE;
+    m_Solution.fieldWidth = width * pixscale / 60;
+    m_Solution.fieldHeight = height * pixscale / 60;
+    return true;
+}
@@ -0,0 +1,142 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <stellarsolver.h>
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+class FITSData;
+
+/**
+ * @class IncrementalSolver
+ * @short Updates a plate solution from the stars of a frame taken a few arcminutes away from a solved one.
+ *
+ * The reference stars around the expected pointing are projected on the frame with the expected solution. The
+ * offset between the projected and the detected stars is found by voting over pairs of bright stars, then the
+ * stars are matched and a linear WCS on the tangent plane is fitted by least squares, rejecting outliers. No index
+ * file is read, so a solve takes a few milliseconds once the stars are detected.
+ *
+ * The solve fails, and the caller should fall back to a full solve, when too few stars match, when the residuals
+ * are too high, or when the fitted scale or parity departs from the expected solution. It fails before detecting
+ * any star when the catalog has too few stars in the expected field, as without the deep star catalogs.
+ *
+ * The stars are detected by a StellarSolver of their own, the image and its detected stars are not changed.
+ */
+class IncrementalSolver : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @brief A catalog star, J2000 coordinates in degrees. */
+        struct ReferenceStar
+        {
+            double ra { 0 };
+            double dec { 0 };
+            double mag { 0 };
+        };
+
+        /**
+         * @param guess solution expected for the frame, usually the last solution with its center moved to the
+         * current pointing of the mount.
+         */
+        explicit IncrementalSolver(const FITSImage::Solution &guess, QObject *parent = nullptr);
+
+        /** @brief Star extraction parameters, by default the align profile of the solver options. */
+        void setParameters(const SSolver::Parameters &parameters)
+        {
+            m_Parameters = parameters;
+        }
+
+        /** @brief Largest offset in arcminutes between the expected and the actual pointing. */
+        void setSearchRadius(double arcminutes)
+        {
+            m_SearchRadius = arcminutes;
+        }
+
+        /** @brief Set the reference stars instead of reading them from the KStars catalog. */
+        void setReferenceStars(const QVector<ReferenceStar> &stars)
+        {
+            m_References = stars;
+        }
+
+        /** @brief Read the reference stars around the expected pointing of a frame from the KStars star catalog. */
+        void loadCatalogStars(int width, int height);
+
+        /**
+         * @brief Detect the stars of @p image in a thread, then fit the solution and emit done().
+         * The reference stars are read from the catalog if none was set. Destroying the solver drops the detection.
+         * @return false, and nothing is started, if too few reference stars are expected in the frame.
+         */
+        bool start(const QSharedPointer<FITSData> &image);
+
+        /**
+         * @brief Same as start(), waiting for the stars to be detected.
+         * @return true if a solution was found.
+         */
+        bool solve(const QSharedPointer<FITSData> &image);
+
+        /** @brief Fit the solution of a width x height frame to its detected @p stars. */
+        bool solve(const QList<FITSImage::Star> &stars, int width, int height);
+
+        /** @return the last solution found. */
+        const FITSImage::Solution &solution() const
+        {
+            return m_Solution;
+        }
+        /** @return number of stars detected for the last solve, none if it failed before detecting. */
+        int detectedStars() const
+        {
+            return m_Detected;
+        }
+        /** @return number of stars the last solution was fitted to. */
+        int matchedStars() const
+        {
+            return m_Matched;
+        }
+        /** @return RMS of the residuals of the last solution, in pixels. */
+        double residual() const
+        {
+            return m_Residual;
+        }
+        /** @return why the last solve failed. */
+        const QString &failure() const
+        {
+            return m_Failure;
+        }
+
+        /** @brief Minimum number of matched stars for a solution. */
+        static constexpr int MINIMUM_MATCHES { 8 };
+        /** @brief Maximum RMS of the residuals of a solution, in pixels. */
+        static constexpr double MAXIMUM_RESIDUAL { 1.5 };
+
+    signals:
+        /** @brief The solve started by start() finished, @p success being true if a solution was found. */
+        void done(bool success);
+
+    private:
+        bool fail(const QString &reason);
+        /** Read the reference stars if needed, and check that enough of them are expected on @p image */
+        bool prepare(const QSharedPointer<FITSData> &image);
+
+        FITSImage::Solution m_Guess;
+        FITSImage::Solution m_Solution;
+        SSolver::Parameters m_Parameters;
+        QVector<ReferenceStar> m_References;
+        double m_SearchRadius { 15 };
+        QFutureWatcher<QList<FITSImage::Star>> m_Watcher;
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_Detected { 0 };
+        int m_Matched { 0 };
+        double m_Residual { 0 };
+        QString m_Failure;
+};
@@ -7,6 +7,8 @@
 
 #include "capturepreviewwidget.h"
 #include "sequencejob.h"
+#include "fitsviewer/previewcache.h"
+#include "fitsviewer/fitsloader.h"
 #include <ekos_capture_debug.h>
 #include "ksutils.h"
 #include "ksmessagebox.h"
@@ -85,6 +87,7 @@ void CapturePreviewWidget::updateJobProgress(Ekos::SequenceJob *job, const QShar
     m_currentFrame.filename    = data->filename();
     m_currentFrame.width       = data->width();
     m_currentFrame.height      = data->height();
+    m_currentData = data;
 
     const auto ISOIndex = job->getCoreProperty(SequenceJob::SJ_Offset).toInt();
     if (ISOIndex >= 0 && ISOIndex <= captureProcess->captureISOS->count())
@@ -101,7 +104,7 @@ void CapturePreviewWidget::showNextFrame()
 {
     overlay->setEnabled(false);
     if (overlay->showNextFrame())
-        m_fitsPreview->loadFile(overlay->currentFrame().filename);
+        loadFrame(overlay->currentFrame().filename);
     // Hint: since the FITSView loads in the background, we have to wait for FITSView::load() to enable the layer
     else
         overlay->setEnabled(true);
@@ -111,7 +114,7 @@ void CapturePreviewWidget::showPreviousFrame()
 {
     overlay->setEnabled(false);
     if (overlay->showPreviousFrame())
-        m_fitsPreview->loadFile(overlay->currentFrame().filename);
+        loadFrame(overlay->currentFrame().filename);
     // Hint: since the FITSView loads in the background, we have to wait for FITSView::load() to enable the layer
     else
         overlay->setEnabled(true);
@@ -150,7 +153,7 @@ void CapturePreviewWidget::deleteCurrentFrame()
         // delete it from the history and update the FITS view
         if (overlay->deleteFrame(pos) && overlay->hasFrames())
         {
-            m_fitsPreview->loadFile(overlay->currentFrame().filename);
+            loadFrame(overlay->currentFrame().filename);
             // Hint: since the FITSView loads in the background, we have to wait for FITSView::load() to enable the layer
         }
         else
@@ -195,6 +198,8 @@ void CapturePreviewWidget::setSummaryFITSView(SummaryFITSView *view)
     connect(view, &FITSView::loaded, [&]()
     {
         overlay->setEnabled(true);
+        // a frame of the history that had no preview yet
+        PreviewCache::Instance()->add(m_fitsPreview->imageData());
     });
     connect(view, &FITSView::failed, [&]()
     {
@@ -225,6 +230,10 @@ void CapturePreviewWidget::updateCaptureStatus(Ekos::CaptureState status)
     {
         overlay->addFrameData(m_currentFrame);
         overlay->setVisible(true);
+        // the frame is saved and its statistics computed, build its preview for the history
+        if (m_currentData != nullptr && m_currentData->filename() == m_currentFrame.filename)
+            PreviewCache::Instance()->add(m_currentData);
+        m_currentData.clear();
     }
 
     // forward to sub widget
@@ -242,3 +251,25 @@ void CapturePreviewWidget::updateCaptureCountDown(int delta)
     // forward to sub widget
     captureCountsWidget->updateCaptureCountDown(delta);
 }
+
+void CapturePreviewWidget::loadFrame(const QString &filename)
+{
+    // read the neighbours into the system cache, so that navigating to them loads faster
+    const int position = overlay->currentPosition();
+    for (const int neighbour : {position - 1, position + 1})
+        if (neighbour >= 0 && neighbour < overlay->historySize())
+            FITSLoader::prefetch(overlay->getFrame(neighbour).filename);
+
+    PreviewCache::Entry preview;
+    QSharedPointer<FITSData> data;
+    if (PreviewCache::Instance()->find(filename, preview) && (data = preview.toFITSData()) != nullptr
+            && m_fitsPreview->loadPreview(data))
+    {
+        // the preview is displayed at once
+        overlay->setEnabled(true);
+        return;
+    }
+
+    m_fitsPreview->loadFile(filename);
+    // Hint: since the FITSView loads in the background, we have to wait for FITSView::load() to enable the layer
+}
@@ -87,12 +87,19 @@ public slots:
     void updateCaptureCountDown(int delta);
 
 private:
+    /**
+     * @brief Display a frame of the history, from its cached preview if possible
+     */
+    void loadFrame(const QString &filename);
+
     Ekos::Scheduler *schedulerProcess = nullptr;
     Ekos::Capture *captureProcess = nullptr;
     Ekos::Mount *mountProcess = nullptr;
 
     // cache frame data
     CaptureProcessOverlay::FrameData m_currentFrame;
+    // data of the frame being captured, until its preview is built
+    QSharedPointer<FITSData> m_currentData;
 
     // target the mount is pointing to (may be different to the scheduler job name)
     QString m_mountTarget = "";
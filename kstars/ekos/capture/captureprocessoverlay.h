@@ -152,6 +152,11 @@ public:
      */
     bool hasFrames() {return m_captureHistory.size() > 0;}
 
+    /**
+     * @brief Number of frames in the capture history
+     */
+    int historySize() {return m_captureHistory.size();}
+
     /**
      * @brief Update the statistics display for captured frames
      */
@@ -1020,7 +1020,8 @@ void Focus::start()
                                << " Frames: " << 1 /*focusFramesSpin->value()*/ << " Maximum Travel: " << maxTravelIN->value()
                                << " Curve Fit: " << curveFitCombo->currentText()
                                << " Use Weights: " << ( useWeights->isChecked() ? "yes" : "no" )
-                               << " R2 Limit: " << R2Limit->value();
+                               << " R2 Limit: " << R2Limit->value()
+                               << " Pipelined: " << ( pipelineFocus->isChecked() ? "yes" : "no" );
 
     if (currentTemperatureSourceElement)
         emit autofocusStarting(currentTemperatureSourceElement->value, filter());
@@ -1159,6 +1160,10 @@ void Focus::abort()
     if (state <= FOCUS_ABORTED)
         return;
 
+    // Stop the anticipated move, the abort completes once the focuser reports where it stopped
+    if (isPipelinedMoveInProgress() && m_Focuser)
+        m_Focuser->stop();
+
     checkStopFocus(true);
     appendLogText(i18n("Autofocus aborted."));
 }
@@ -1468,6 +1473,8 @@ void Focus::handleFocusMotionTimeout()
     if (++m_FocusMotionTimerCounter > 3)
     {
         appendLogText(i18n("Focuser is not responding to commands. Aborting..."));
+        // Do not wait for the end of an anticipated move that is not reported
+        m_PipelinedMoveComplete = true;
         completeFocusProcedure(Ekos::FOCUS_ABORTED);
     }
 
@@ -1512,6 +1519,10 @@ void Focus::processData(const QSharedPointer<FITSData> &data)
     disconnect(m_Camera, &ISD::Camera::newImage, this, &Ekos::Focus::processData);
     disconnect(m_Camera, &ISD::Camera::error, this, &Ekos::Focus::processCaptureError);
 
+    // The frame is read out, the focuser may already move to the next position
+    if (m_ImageData)
+        anticipateLinearPosition();
+
     if (m_ImageData && darkFrameCheck->isChecked())
     {
         QVariantMap settings = frameSettings[targetChip];
@@ -1719,6 +1730,22 @@ void Focus::settle(const FocusState completionState, const bool autoFocusUsed)
 
 void Focus::completeFocusProcedure(FocusState completionState, bool plot)
 {
+    // The focuser is sent elsewhere and its position reported, once it is done with the anticipated move
+    const auto complete = [this, completionState, plot]()
+    {
+        completeFocusProcedure(completionState, plot);
+    };
+    if (deferUntilPipelinedMove(complete))
+    {
+        qCDebug(KSTARS_EKOS_FOCUS) << "Linear: completing once the anticipated move to" << m_PipelinedPosition << "ends";
+        return;
+    }
+
+    // Whatever move was anticipated, the focuser is going elsewhere or stopping
+    m_PipelinedPosition = -1;
+    m_PipelinedRequest = -1;
+    m_PipelinedPending.clear();
+
     if (inAutoFocus)
     {
         if (completionState == Ekos::FOCUS_COMPLETE)
@@ -1819,6 +1846,13 @@ void Focus::completeFocusProcedure(FocusState completionState, bool plot)
 
 void Focus::resetFocuser()
 {
+    const auto reset = [this]()
+    {
+        resetFocuser();
+    };
+    if (deferUntilPipelinedMove(reset))
+        return;
+
     // If we are able to and need to, move the focuser back to the initial position and let the procedure restart from its termination
     if (m_Focuser && m_Focuser->isConnected() && initialFocuserAbsPosition >= 0)
     {
@@ -1848,9 +1882,10 @@ void Focus::setCurrentHFR(double value)
     }
     else HFRFrames.clear();
 
-    // Let signal the current HFR now depending on whether the focuser is absolute or relative
+    // Let signal the current HFR now depending on whether the focuser is absolute or relative.
+    // The focuser may already be moving to the next position, report the one the frame was captured at.
     if (canAbsMove)
-        emit newHFR(currentHFR, currentPosition);
+        emit newHFR(currentHFR, m_FramePosition);
     else
         emit newHFR(currentHFR, -1);
 
@@ -2259,7 +2294,14 @@ bool Focus::autoFocusChecks()
         {
             noStarCount++;
             appendLogText(i18n("No stars detected, capturing again..."));
-            capture();
+            if (m_PipelinedPosition >= 0)
+            {
+                // The focuser was sent ahead, bring it back to where the frame was captured
+                m_PipelinedRequest = m_FramePosition;
+                resumePipelinedFocus();
+            }
+            else
+                capture();
             return false;
         }
         else if (m_FocusAlgorithm == FOCUS_LINEAR)
@@ -2429,14 +2471,17 @@ void Focus::autoFocusLinear()
         }
     }
 
-    addPlotPosition(currentPosition, currentHFR, false);
+    // When pipelined, the focuser has already left the position of the frame
+    const bool pipelined = m_PipelinedPosition >= 0;
+    const int framePosition = pipelined ? m_FramePosition : static_cast<int>(currentPosition);
+
+    addPlotPosition(framePosition, currentHFR, false);
 
     // Only use the relativeHFR algorithm if full field is enabled with one capture/measurement.
     bool useFocusStarsHFR = Options::focusUseFullField() && focusFramesSpin->value() == 1;
     auto focusStars = useFocusStarsHFR || (m_FocusAlgorithm == FOCUS_LINEAR1PASS) ? &(m_ImageData->getStarCenters()) : nullptr;
-    int nextPosition;
 
-    linearRequestedPosition = linearFocuser->newMeasurement(currentPosition, currentHFR, focusStars);
+    linearRequestedPosition = linearFocuser->newMeasurement(framePosition, currentHFR, focusStars);
     if (m_FocusAlgorithm == FOCUS_LINEAR1PASS && linearFocuser->isDone())
         // Linear 1 Pass is done, graph is drawn, so just move to the focus position, and update the graph title.
         plotLinearFinalUpdates();
@@ -2444,8 +2489,6 @@ void Focus::autoFocusLinear()
         // Update the graph with the next datapoint, draw the curve, etc.
         plotLinearFocus();
 
-    nextPosition = adjustLinearPosition(currentPosition, linearRequestedPosition, focusBacklashSpin->value());
-
     if (linearFocuser->isDone())
     {
         if (linearFocuser->solution() != -1)
@@ -2484,8 +2527,16 @@ void Focus::autoFocusLinear()
         }
         return;
     }
+    else if (pipelined)
+    {
+        // The focuser is on its way to the anticipated position, capture or correct once it gets there
+        m_PipelinedRequest = linearRequestedPosition;
+        resumePipelinedFocus();
+        return;
+    }
     else
     {
+        const int nextPosition = adjustLinearPosition(currentPosition, linearRequestedPosition, focusBacklashSpin->value());
         const int delta = nextPosition - currentPosition;
 
         if (!changeFocus(delta))
@@ -2495,6 +2546,71 @@ void Focus::autoFocusLinear()
     }
 }
 
+void Focus::anticipateLinearPosition()
+{
+    m_FramePosition = static_cast<int>(currentPosition);
+
+    if (!Options::focusPipelined() || !inAutoFocus || inFocusLoop || !canAbsMove || !linearFocuser)
+        return;
+    if (m_FocusAlgorithm != FOCUS_LINEAR && m_FocusAlgorithm != FOCUS_LINEAR1PASS)
+        return;
+    // Averaged frames are taken at the same position, and so is the frame following the star selection
+    if (focusFramesSpin->value() > 1 || (Options::focusUseFullField() == false && starSelected == false))
+        return;
+
+    // Only anticipate moves inward, so that a larger step requested by the measurement keeps going the same way
+    const int position = linearFocuser->anticipatedPosition();
+    if (position < 0 || position >= m_FramePosition - 1)
+        return;
+
+    qCDebug(KSTARS_EKOS_FOCUS) << QString("Linear: moving to anticipated position %1 while analyzing the frame at %2")
+                               .arg(position).arg(m_FramePosition);
+
+    m_PipelinedPosition = position;
+    m_PipelinedRequest = -1;
+    m_PipelinedMoveComplete = false;
+    if (!changeFocus(position - m_FramePosition))
+        m_PipelinedPosition = -1;
+}
+
+bool Focus::deferUntilPipelinedMove(const std::function<void()> &action)
+{
+    if (!isPipelinedMoveInProgress())
+        return false;
+
+    m_PipelinedRequest = -1;
+    m_PipelinedPending.append(action);
+    return true;
+}
+
+void Focus::resumePipelinedFocus()
+{
+    if (m_PipelinedPosition < 0 || !m_PipelinedMoveComplete || m_PipelinedRequest < 0)
+        return;
+
+    const int requestedPosition = m_PipelinedRequest;
+    m_PipelinedPosition = -1;
+    m_PipelinedRequest = -1;
+
+    const int nextPosition = adjustLinearPosition(currentPosition, requestedPosition, focusBacklashSpin->value());
+    const int delta = nextPosition - currentPosition;
+
+    if (abs(delta) <= 1)
+    {
+        // The focuser settled while the frame was analyzed
+        const double settled = m_PipelinedSettleTimer.elapsed() / 1000.0;
+        qCDebug(KSTARS_EKOS_FOCUS) << QString("Linear: anticipated position %1 confirmed, capturing").arg(currentPosition);
+        capture(std::max(0.0, FocusSettleTime->value() - settled));
+    }
+    else
+    {
+        qCDebug(KSTARS_EKOS_FOCUS) << QString("Linear: requested position %1 differs from the anticipated %2")
+                                   .arg(requestedPosition).arg(currentPosition);
+        if (!changeFocus(delta))
+            completeFocusProcedure(Ekos::FOCUS_ABORTED, false);
+    }
+}
+
 void Focus::autoFocusAbs()
 {
     // Q_ASSERT_X(canAbsMove || canRelMove, __FUNCTION__, "Prerequisite: only absolute and relative focusers");
@@ -2926,7 +3042,23 @@ void Focus::autoFocusRel()
 
 void Focus::autoFocusProcessPositionChange(IPState state)
 {
-    if (state == IPS_OK && captureInProgress == false)
+    if (state != IPS_BUSY && isPipelinedMoveInProgress() && !m_PipelinedPending.isEmpty())
+    {
+        // The run completed or was aborted during the anticipated move, finish it now that the focuser stopped
+        m_PipelinedMoveComplete = true;
+        const QList<std::function<void()>> pending = m_PipelinedPending;
+        m_PipelinedPending.clear();
+        for (const auto &action : pending)
+            action();
+    }
+    else if (state == IPS_OK && m_PipelinedPosition >= 0)
+    {
+        // The capture waits for the measurement of the previous frame, which may still be analyzed
+        m_PipelinedMoveComplete = true;
+        m_PipelinedSettleTimer.start();
+        resumePipelinedFocus();
+    }
+    else if (state == IPS_OK && captureInProgress == false)
     {
         // Normally, if we are auto-focusing, after we move the focuser we capture an image.
         // However, the Linear algorithm, at the start of its passes, requires two
@@ -4155,6 +4287,8 @@ void Focus::syncSettings()
             Options::setSuspendGuiding(cb->isChecked());
         else if (cb == useWeights)
             Options::setFocusUseWeights(cb->isChecked());
+        else if (cb == pipelineFocus)
+            Options::setFocusPipelined(cb->isChecked());
 
     }
     else if ( (cbox = qobject_cast<QComboBox*>(sender())))
@@ -4229,6 +4363,7 @@ void Focus::loadSettings()
     GuideSettleTime->setValue(Options::guideSettleTime());
     // Use Weights
     useWeights->setChecked(Options::focusUseWeights());
+    pipelineFocus->setChecked(Options::focusPipelined());
     // R2Limit
     R2Limit->setValue(Options::focusR2Limit());
 
@@ -4491,6 +4626,7 @@ void Focus::setFocusAlgorithm(FocusAlgorithm algorithm)
             toleranceIN->setEnabled(true);             // Solution tolerance
             curveFitCombo->setEnabled(false);          // Curve fit can only be QUADRATIC
             curveFitCombo->setCurrentIndex(CurveFitting::FOCUS_QUADRATIC);
+            pipelineFocus->setEnabled(false);          // Pipelining needs a linear sweep
             break;
 
         case FOCUS_POLYNOMIAL:
@@ -4501,6 +4637,7 @@ void Focus::setFocusAlgorithm(FocusAlgorithm algorithm)
             toleranceIN->setEnabled(true);             // Solution tolerance
             curveFitCombo->setEnabled(false);          // Curve fit can only be QUADRATIC
             curveFitCombo->setCurrentIndex(CurveFitting::FOCUS_QUADRATIC);
+            pipelineFocus->setEnabled(false);          // Pipelining needs a linear sweep
             break;
 
         case FOCUS_LINEAR:
@@ -4511,6 +4648,7 @@ void Focus::setFocusAlgorithm(FocusAlgorithm algorithm)
             toleranceIN->setEnabled(true);             // Solution tolerance
             curveFitCombo->setEnabled(false);          // Curve fit can only be QUADRATIC
             curveFitCombo->setCurrentIndex(CurveFitting::FOCUS_QUADRATIC);
+            pipelineFocus->setEnabled(true);           // Pipelined moves
             break;
 
         case FOCUS_LINEAR1PASS:
@@ -4520,6 +4658,7 @@ void Focus::setFocusAlgorithm(FocusAlgorithm algorithm)
             maxSingleStepIN->setEnabled(false);        // Max Step Size
             toleranceIN->setEnabled(false);            // Solution tolerance
             curveFitCombo->setEnabled(true);           // Curve fit
+            pipelineFocus->setEnabled(true);           // Pipelined moves
             break;
     }
 }
@@ -4637,6 +4776,7 @@ QJsonObject Focus::getPrimarySettings() const
     settings.insert("suspend", suspendGuideCheck->isChecked());
     settings.insert("guide_settle", GuideSettleTime->value());
     settings.insert("useweights", useWeights->isChecked());
+    settings.insert("pipeline", pipelineFocus->isChecked());
     settings.insert("R2Limit", R2Limit->value());
 
     return settings;
@@ -4657,6 +4797,7 @@ void Focus::setPrimarySettings(const QJsonObject &settings)
     syncControl(settings, "suspend", suspendGuideCheck);
     syncControl(settings, "guide_settle", GuideSettleTime);
     syncControl(settings, "useweights", useWeights);
+    syncControl(settings, "pipeline", pipelineFocus);
     syncControl(settings, "R2Limit", R2Limit);
 
 }
@@ -21,6 +21,7 @@
 #include "indi/indimount.h"
 
 #include <QtDBus/QtDBus>
+#include <functional>
 #include <parameters.h>
 
 namespace Ekos
@@ -210,6 +211,12 @@ class Focus : public QWidget, public Ui::Focus
 
         void setFilterManager(const QSharedPointer<FilterManager> &manager);
 
+        /** @return true while the focuser moves to the position anticipated by a pipelined Linear autofocus. */
+        bool isPipelinedMoveInProgress() const
+        {
+            return m_PipelinedPosition >= 0 && !m_PipelinedMoveComplete;
+        }
+
         void clearLog();
         QStringList logText()
         {
@@ -630,6 +637,15 @@ class Focus : public QWidget, public Ui::Focus
         // For LINEAR1PASS algo use the user-defined backlash value to adjust by
         int adjustLinearPosition(int position, int newPosition, int backlash);
 
+        // When pipelining the Linear algorithms, the focuser is sent to the position the algorithm anticipates
+        // as soon as a frame is read out, while the frame is analyzed. The next capture starts once both the
+        // move and the measurement are complete, after a corrective move if another position was requested.
+        void anticipateLinearPosition();
+        void resumePipelinedFocus();
+        // Run the action once the anticipated move in progress ends, so that the focuser is not sent elsewhere
+        // while busy and its position is known. Returns false if there is no such move.
+        bool deferUntilPipelinedMove(const std::function<void()> &action);
+
         /**
          * @brief syncTrackingBoxPosition Sync the tracking box to the current selected star center
          */
@@ -885,6 +901,19 @@ class Focus : public QWidget, public Ui::Focus
         int focuserAdditionalMovement { 0 };
         int linearRequestedPosition { 0 };
 
+        // Pipelined Linear focus.
+        // Position the focuser was sent to while the last frame is analyzed, or -1.
+        int m_PipelinedPosition { -1 };
+        // Position the last frame was captured at.
+        int m_FramePosition { 0 };
+        // Position requested by the measurement of the last frame, or -1 until it is known.
+        int m_PipelinedRequest { -1 };
+        bool m_PipelinedMoveComplete { false };
+        // Time since the pipelined move completed, which counts towards the settle time.
+        QElapsedTimer m_PipelinedSettleTimer;
+        // Completion and moves waiting for the anticipated move to end.
+        QList<std::function<void()>> m_PipelinedPending;
+
         bool hasDeviation { false };
 
         //double observatoryTemperature { INVALID_VALUE };
@@ -48,6 +48,9 @@ class LinearFocusAlgorithm : public FocusAlgorithmInterface
         int newMeasurement(int position, double value,
                            const QList<Edge*> *stars) override;
 
+        // In the first pass, the next sample is usually one step further in.
+        int anticipatedPosition() const override;
+
         FocusAlgorithmInterface *Copy() override;
 
         void getMeasurements(QVector<int> *pos, QVector<double> *hfrs, QVector<double> *sds) const override
@@ -622,6 +625,23 @@ int LinearFocusAlgorithm::newMeasurement(int position, double value, const QList
     return completeIteration(thisStepSize, foundFit, minPos, minVal);
 }
 
+int LinearFocusAlgorithm::anticipatedPosition() const
+{
+    // The second pass, restarts and retries depend on the value measured.
+    if (done || !inFirstPass)
+        return -1;
+    // Close to the iteration limit, Linear goes to its second pass and L1P fails.
+    if (numSteps + 1 >= params.maxIterations - 2)
+        return -1;
+
+    // newMeasurement() may take a larger step when the minimum is far in. The focuser then
+    // carries on inward from here, which keeps the backlash taken up.
+    const int position = requestedPosition - stepSize;
+    if (position < minPositionLimit)
+        return -1;
+    return position;
+}
+
 int LinearFocusAlgorithm::setupSolution(int position, double value, double sigma)
 {
     focusSolution = position;
@@ -90,6 +90,11 @@ class FocusAlgorithmInterface
         // If stars is not nullptr, then the they may be used to modify the HFR value.
         virtual int newMeasurement(int position, double value, const QList<Edge*> *stars = nullptr) = 0;
 
+        // Returns the position newMeasurement() is expected to request after the measurement at the
+        // last requested position, or -1 if it can't be told before the measurement is known.
+        // The focuser may be sent there while the frame at the last requested position is analyzed.
+        virtual int anticipatedPosition() const = 0;
+
         // Returns true if the algorithm has terminated either successfully or in error.
         bool isDone() const
         {
@@ -7,52 +7,103 @@
 #include "starcorrespondence.h"
 
 #include <math.h>
+#include <algorithm>
 #include "ekos_guide_debug.h"
 
+// Bins the stars into a grid whose cells are at least minCellSize wide.
+// The cell size is grown if needed so that the grid never has many more cells than stars.
+void StarCorrespondence::StarGrid::build(const QList<Edge> &stars, double minCellSize)
+{
+    cellStart.clear();
+    indices.clear();
+    width = 0;
+    height = 0;
+    const int size = stars.size();
+    if (size == 0)
+        return;
+
+    double maxX = stars[0].x, maxY = stars[0].y;
+    minX = stars[0].x;
+    minY = stars[0].y;
+    for (const auto &star : stars)
+    {
+        minX = std::min(minX, static_cast<double>(star.x));
+        minY = std::min(minY, static_cast<double>(star.y));
+        maxX = std::max(maxX, static_cast<double>(star.x));
+        maxY = std::max(maxY, static_cast<double>(star.y));
+    }
+
+    constexpr int maxCellsPerStar = 4;
+    cellSize = std::max(minCellSize, 1.0);
+    while (true)
+    {
+        width = static_cast<int>((maxX - minX) / cellSize) + 1;
+        height = static_cast<int>((maxY - minY) / cellSize) + 1;
+        if (static_cast<double>(width) * height <= maxCellsPerStar * size + 16)
+            break;
+        cellSize *= 2;
+    }
+
+    // Counting sort of the star indices into their cells. Iterating over the stars
+    // in order keeps the indices within each cell increasing.
+    const int numCells = width * height;
+    cellStart = QVector<int>(numCells + 1, 0);
+    QVector<int> cells(size);
+    for (int i = 0; i < size; ++i)
+    {
+        const int cell = cellY(stars[i].y) * width + cellX(stars[i].x);
+        cells[i] = cell;
+        cellStart[cell + 1]++;
+    }
+    for (int c = 0; c < numCells; ++c)
+        cellStart[c + 1] += cellStart[c];
+    QVector<int> next = cellStart;
+    indices.resize(size);
+    for (int i = 0; i < size; ++i)
+        indices[next[cells[i]]++] = i;
+}
+
 // Finds the star in sortedStars that's closest to x,y and within maxDistance pixels.
 // Returns the index of the closest star in  sortedStars, or -1 if none satisfies the criteria.
-// sortedStars must be sorted by x, from lower x to higher x.
+// grid must index sortedStars. When several stars are equally close, the one with the
+// highest index wins, which is what the previous x-sorted linear scan returned.
 // Fills distance to the pixel distance to the closest star.
-int StarCorrespondence::findClosestStar(double x, double y, const QList<Edge> sortedStars,
+int StarCorrespondence::findClosestStar(double x, double y, const QList<Edge> &sortedStars, const StarGrid &grid,
                                         double maxDistance, double *distance) const
 {
     if (x < -maxDistance || y < -maxDistance ||
-            x > imageWidth + maxDistance || y > imageWidth + maxDistance)
+            x > imageWidth + maxDistance || y > imageHeight + maxDistance)
         return -1;
 
-    const int size = sortedStars.size();
-    int startPoint = 0;
+    if (grid.width == 0)
+        return -1;
 
-    // Efficiency improvement to quickly find the start point.
-    // Increments by size/10 to find a better start point.
-    const int coarseIncrement = size / 10;
-    if (coarseIncrement > 1)
-    {
-        for (int i = 0; i < size; i += coarseIncrement)
-        {
-            if (sortedStars[i].x < x - maxDistance)
-                startPoint = i;
-            else
-                break;
-        }
-    }
+    const int x0 = std::max(0, grid.cellX(x - maxDistance));
+    const int x1 = std::min(grid.width - 1, grid.cellX(x + maxDistance));
+    const int y0 = std::max(0, grid.cellY(y - maxDistance));
+    const int y1 = std::min(grid.height - 1, grid.cellY(y + maxDistance));
 
-    // Iterate through the stars starting with the star with lowest x where x >= x - maxDistance
-    // through the star with greatest x where x <= x + maxDistance.  Find the closest star to x,y.
     int bestIndex = -1;
     double bestSquaredDistance = maxDistance * maxDistance;
-    for (int i = startPoint; i < size; ++i)
+    for (int cy = y0; cy <= y1; ++cy)
     {
-        auto &star = sortedStars[i];
-        if (star.x < x - maxDistance) continue;
-        if (star.x > x + maxDistance) break;
-        const double xDiff = star.x - x;
-        const double yDiff = star.y - y;
-        const double squaredDistance = xDiff * xDiff + yDiff * yDiff;
-        if (squaredDistance <= bestSquaredDistance)
+        for (int cx = x0; cx <= x1; ++cx)
         {
-            bestIndex = i;
-            bestSquaredDistance = squaredDistance;
+            const int cell = cy * grid.width + cx;
+            for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; ++k)
+            {
+                const int i = grid.indices[k];
+                const auto &star = sortedStars[i];
+                const double xDiff = star.x - x;
+                const double yDiff = star.y - y;
+                const double squaredDistance = xDiff * xDiff + yDiff * yDiff;
+                if (squaredDistance < bestSquaredDistance ||
+                        (squaredDistance == bestSquaredDistance && i > bestIndex))
+                {
+                    bestIndex = i;
+                    bestSquaredDistance = squaredDistance;
+                }
+            }
         }
     }
     if (distance != nullptr) *distance = sqrt(bestSquaredDistance);
@@ -120,6 +171,7 @@ void StarCorrespondence::initialize(const QList<Edge> &stars, int guideStar)
     }
 
     initializeAdaptation();
+    substituteOffsetsValid = false;
 
     initialized = true;
 }
@@ -130,10 +182,13 @@ void StarCorrespondence::reset()
     guideStarOffsets.clear();
     referenceSums.clear();
     referenceNumPixels.clear();
+    substituteOffsets.clear();
+    substituteOffsetsValid = false;
     initialized = false;
 }
 
-int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistance, QVector<int> *starMap,
+int StarCorrespondence::findInternal(const QList<Edge> &stars, const StarGrid &grid, double maxDistance,
+                                     QVector<int> *starMap,
                                      int guideStarIndex, const QVector<Offsets> &offsets,
                                      int *numFound, int *numNotFound, double minFraction) const
 {
@@ -182,7 +237,7 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
             const auto &offset = offsets[offsetIndex];
             double distance;
             const int closestIndex = findClosestStar(starX + offset.x, starY + offset.y,
-                                     stars, maxDistance, &distance);
+                                     stars, grid, maxDistance, &distance);
             if (closestIndex < 0)
             {
                 // This reference star position had no corresponding input star.
@@ -238,6 +293,17 @@ void StarCorrespondence::makeOffsets(const QVector<Offsets> &offsets, QVector<Of
 
 }
 
+void StarCorrespondence::updateSubstituteOffsets()
+{
+    if (substituteOffsetsValid)
+        return;
+    const int numRefs = guideStarOffsets.size();
+    substituteOffsets.resize(numRefs);
+    for (int i = 0; i < numRefs; ++i)
+        makeOffsets(guideStarOffsets, &substituteOffsets[i], i);
+    substituteOffsetsValid = true;
+}
+
 // We create an imaginary star from the ones we did find.
 Edge StarCorrespondence::inventStarPosition(const QList<Edge> &stars, const QVector<int> &starMap,
         QVector<Offsets> offsets, Offsets offset) const
@@ -332,8 +398,12 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
     QVector<int> sortedToOriginal;
     sortByX(stars, &sortedStars, &sortedToOriginal);
 
+    // The grid is shared by all the findInternal() calls below.
+    StarGrid grid;
+    grid.build(sortedStars, maxDistance);
+
     QVector<int> sortedStarMap;
-    int bestStarIndex = findInternal(sortedStars, maxDistance, &sortedStarMap, guideStarIndex,
+    int bestStarIndex = findInternal(sortedStars, grid, maxDistance, &sortedStarMap, guideStarIndex,
                                      guideStarOffsets, &numFound, &numNotFound, minFraction);
 
     if (bestStarIndex > -1)
@@ -360,14 +430,14 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
         int bestNumNotFound = 0;
         Edge bestInvented;
         bestInvented.invalidate();
+        updateSubstituteOffsets();
         for (int gStarIndex = 0; gStarIndex < guideStarOffsets.size(); gStarIndex++)
         {
             if (gStarIndex == guideStarIndex)
                 continue;
-            QVector<Offsets> gStarOffsets;
-            makeOffsets(guideStarOffsets, &gStarOffsets, gStarIndex);
+            const QVector<Offsets> &gStarOffsets = substituteOffsets[gStarIndex];
             QVector<int> newStarMap;
-            int detectedStarIndex = findInternal(sortedStars, maxDistance, &newStarMap,
+            int detectedStarIndex = findInternal(sortedStars, grid, maxDistance, &newStarMap,
                                                  gStarIndex, gStarOffsets,
                                                  &numFound, &numNotFound, minFraction);
             if (detectedStarIndex >= 0 && numFound > bestNumFound)
@@ -474,6 +544,7 @@ void StarCorrespondence::adaptOffsets(const QList<Edge> &stars, const QVector<in
         {
             guideStarOffsets[refIndex].x = newXOffset;
             guideStarOffsets[refIndex].y = newYOffset;
+            substituteOffsetsValid = false;
         }
     }
 }
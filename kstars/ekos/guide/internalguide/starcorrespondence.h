@@ -11,6 +11,8 @@
 #include <QVector>
 #include <QVector2D>
 
+#include <cmath>
+
 #include "fitsviewer/fitsdata.h"
 #include "vect.h"
 
@@ -110,8 +112,34 @@ class StarCorrespondence
         void initializeAdaptation();
         void adaptOffsets(const QList<Edge> &stars, const QVector<int> &starMap);
 
+        // A uniform grid over the input stars, built once per call to find().
+        // Each cell holds the indices (in increasing order) of the stars that fall in it,
+        // stored contiguously in indices, with cell c covering indices[cellStart[c]..cellStart[c+1]).
+        // With cells at least maxDistance wide, a closest-star lookup only visits the
+        // cells neighboring the search position instead of a range of the sorted star list.
+        struct StarGrid
+        {
+            void build(const QList<Edge> &stars, double minCellSize);
+            int cellX(double x) const
+            {
+                return static_cast<int>(std::floor((x - minX) / cellSize));
+            }
+            int cellY(double y) const
+            {
+                return static_cast<int>(std::floor((y - minY) / cellSize));
+            }
+
+            double minX { 0 };
+            double minY { 0 };
+            double cellSize { 1 };
+            int width { 0 };
+            int height { 0 };
+            QVector<int> cellStart;
+            QVector<int> indices;
+        };
+
         // Utility used by find. Useful for iterating when the guide star is missing.
-        int findInternal(const QList<Edge> &stars, double maxDistance, QVector<int> *starMap,
+        int findInternal(const QList<Edge> &stars, const StarGrid &grid, double maxDistance, QVector<int> *starMap,
                          int guideStarIndex, const QVector<Offsets> &offsets,
                          int *numFound, int *numNotFound, double minFraction) const;
 
@@ -128,10 +156,14 @@ class StarCorrespondence
                                 QVector<Offsets> offsets, Offsets offset) const;
 
         // Finds the star closest to x,y. Returns the index in sortedStars.
-        // sortedStars should be sorted in x, which allows for a speedup in search.
-        int findClosestStar(double x, double y, const QList<Edge> sortedStars,
+        // grid must have been built from sortedStars with a cell size of at least maxDistance.
+        int findClosestStar(double x, double y, const QList<Edge> &sortedStars, const StarGrid &grid,
                             double maxDistance, double *distance) const;
 
+        // Fills substituteOffsets, if needed, with the offsets from each reference star to all others.
+        // These are used when the guide star is missing and only change when the references do.
+        void updateSubstituteOffsets();
+
         // The offsets of the reference stars relative to the guide star.
         QVector<Offsets> guideStarOffsets;
 
@@ -159,5 +191,10 @@ class StarCorrespondence
 
         // A copy of the original reference offsets used so that the values don't move too far.
         QVector<Offsets> originalGuideStarOffsets;
+
+        // substituteOffsets[i] are the offsets computed by makeOffsets() for reference star i.
+        // It is rebuilt lazily after the references are initialized or adapted.
+        QVector<QVector<Offsets>> substituteOffsets;
+        bool substituteOffsetsValid { false };
 };
 
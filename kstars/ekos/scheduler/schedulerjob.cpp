@@ -9,6 +9,7 @@
 #include "dms.h"
 #include "artificialhorizoncomponent.h"
 #include "kstarsdata.h"
+#include "ksnumberscache.h"
 #include "skymapcomposite.h"
 #include "Options.h"
 #include "scheduler.h"
@@ -958,8 +959,8 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when, double *altPtr) co
     o.setDec0(target.dec0());
 
     // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltWhen.djd());
+    o.updateCoordsNow(numbers.data());
 
     // Compute local sidereal time for the current fraction of the day, calculate altitude
     CachingDms const LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltWhen).gst());
@@ -1036,15 +1037,15 @@ int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
     o.setDec0(target.dec0());
 
     // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltWhen.djd());
+    o.updateCoordsNow(numbers.data());
 
     // Update moon
     //ut = getGeo()->LTtoUT(ltWhen);
     //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
     //LST = getGeo()->GSTtoLST(ut.gst());
     CachingDms LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, getGeo()->lat(), &LST, true);
+    moon->updateCoords(numbers.data(), true, getGeo()->lat(), &LST, true);
 
     double const moonAltitude = moon->alt().Degrees();
 
@@ -1111,15 +1112,15 @@ double SchedulerJob::getCurrentMoonSeparation() const
     o.setDec0(target.dec0());
 
     // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltWhen.djd());
+    o.updateCoordsNow(numbers.data());
 
     // Update moon
     //ut = getGeo()->LTtoUT(ltWhen);
     //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
     //LST = getGeo()->GSTtoLST(ut.gst());
     CachingDms LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, getGeo()->lat(), &LST, true);
+    moon->updateCoords(numbers.data(), true, getGeo()->lat(), &LST, true);
 
     // Moon/Sky separation p
     return moon->angularDistanceTo(&o).Degrees();
@@ -1181,8 +1182,8 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
         }
 
         // Update RA/DEC of the target for the current fraction of the day
-        KSNumbers numbers(ltOffset.djd());
-        o.updateCoordsNow(&numbers);
+        const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltOffset.djd());
+        o.updateCoordsNow(numbers.data());
 
         // Compute local sidereal time for the current fraction of the day, calculate altitude
         CachingDms const LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltOffset).gst());
@@ -1255,8 +1256,8 @@ QDateTime SchedulerJob::calculateCulmination(QDateTime const &when) const
     o.setDec0(target.dec0());
 
     // Update RA/DEC for the argument date/time
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltWhen.djd());
+    o.updateCoordsNow(numbers.data());
 
     // Calculate transit date/time at the argument date - transitTime requires UT and returns LocalTime
     KStarsDateTime transitDateTime(ltWhen.date(), o.transitTime(getGeo()->LTtoUT(ltWhen), getGeo()), Qt::LocalTime);
@@ -1303,8 +1304,8 @@ double SchedulerJob::findAltitude(const SkyPoint &target, const QDateTime &when,
     o.setDec0(target.dec0());
 
     // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    const KSNumbersCache::NumbersPtr numbers = KSNumbersCache::Instance()->numbers(ltWhen.djd());
+    o.updateCoordsNow(numbers.data());
 
     // Calculate alt/az coordinates using KStars instance's geolocation
     CachingDms const LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltWhen).gst());
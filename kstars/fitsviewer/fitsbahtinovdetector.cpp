@@ -18,6 +18,8 @@
 #include <QElapsedTimer>
 #include <QtConcurrent>
 
+#include <algorithm>
+
 //void FITSBahtinovDetector::configure(const QString &setting, const QVariant &value)
 //{
 //    if (!setting.compare("NUMBER_OF_AVERAGE_ROWS", Qt::CaseInsensitive))
@@ -77,125 +79,243 @@ QFuture<bool> FITSBahtinovDetector::findSources(QRect const &boundary)
     }
 }
 
+QVector<QPair<void const *, size_t>> FITSBahtinovDetector::reusedBuffers() const
+{
+    QVector<QPair<void const *, size_t>> buffers;
+    for (std::vector<float> const * samples : {&m_Samples.dx, &m_Samples.dy, &m_Samples.value})
+        buffers.append(qMakePair<void const *, size_t>(samples->data(), samples->capacity() * sizeof(float)));
+    buffers.append(qMakePair<void const *, size_t>(m_Projections.data(), m_Projections.capacity()));
+    return buffers;
+}
+
 template <typename T>
-bool FITSBahtinovDetector::findBahtinovStar(const QRect &boundary)
+void FITSBahtinovDetector::gatherSamples(const FITSImageView &view, BahtinovSamples &samples) const
 {
-    if (boundary.isEmpty())
-        return false;
+    int const numChannels = view.channels();
+
+    samples.width = view.width();
+    samples.height = view.height();
+    samples.dx.clear();
+    samples.dy.clear();
+    samples.value.clear();
+
+    // Pixels within the circle inscribed in the area, which is the same for every direction
+    int const hx = qFloor((samples.width + 1) / 2.0);
+    int const hy = qFloor((samples.height + 1) / 2.0);
+    double const innerCircleRadius = (0.5 * qSqrt(2.0) * qMin(hx, hy));
+    int const leftEdge = qCeil(hx - innerCircleRadius);
+    int const rightEdge = qFloor(hx + innerCircleRadius);
+    int const topEdge = qCeil(hy - innerCircleRadius);
+    int const bottomEdge = qFloor(hy + innerCircleRadius);
+
+    size_t const count = static_cast<size_t>(qMax(0, rightEdge - leftEdge)) * qMax(0, bottomEdge - topEdge);
+    samples.dx.reserve(count);
+    samples.dy.reserve(count);
+    samples.value.reserve(count);
+
+    for (int y = topEdge; y < bottomEdge; y++)
+    {
+        for (int x = leftEdge; x < rightEdge; x++)
+        {
+            double value = 0;
+            for (int i = 0; i < numChannels; i++)
+                value += view.at<T>(x, y, i);
 
-    QList<Edge*> starCenters;
-    int subX = qMax(0, boundary.isNull() ? 0 : boundary.x());
-    int subY = qMax(0, boundary.isNull() ? 0 : boundary.y());
-    int subW = (boundary.isNull() ? m_ImageData->width() : boundary.width());
-    int subH = (boundary.isNull() ? m_ImageData->height() : boundary.height());
-
-    int BBP = m_ImageData->getBytesPerPixel();
-    uint16_t dataWidth = m_ImageData->width();
-
-    // #1 Find offsets
-    uint32_t size   = subW * subH;
-    uint32_t offset = subX + subY * dataWidth;
-
-    // #2 Create new buffer
-    auto * buffer = new uint8_t[size * BBP];
-    // If there is no offset, copy whole buffer in one go
-    if (offset == 0)
+            samples.dx.push_back(x - hx);
+            samples.dy.push_back(y - hy);
+            samples.value.push_back(value / numChannels);
+        }
+    }
+}
+
+BahtinovLineAverage FITSBahtinovDetector::calculateMaxAverage(const BahtinovSamples &samples, double angle,
+        int averageRows, double *lines)
+{
+    int const width = samples.width;
+    int const height = samples.height;
+    double const hy = qFloor((height + 1) / 2.0);
+    double const sinAngle = qSin(angle);
+    double const cosAngle = qCos(angle);
+
+    // Sum the pixels along each line of the direction, which is a row of the image rotated by the angle.
+    // Each pixel is shared between the two lines nearest to it.
+    double * const sums = lines;
+    std::fill(sums, sums + height, 0.0);
+    size_t const count = samples.value.size();
+    for (size_t k = 0; k < count; k++)
     {
-        memcpy(buffer, m_ImageData->getImageBuffer(), size * BBP);
+        double const position = samples.dx[k] * sinAngle + samples.dy[k] * cosAngle + hy;
+        int const line = qFloor(position);
+        double const fraction = position - line;
+        if (line >= 0 && line < height)
+            sums[line] += samples.value[k] * (1 - fraction);
+        if (line + 1 >= 0 && line + 1 < height)
+            sums[line + 1] += samples.value[k] * fraction;
     }
-    else
+
+    // Average over multiple rows
+    BahtinovLineAverage lineAverage;
+    lineAverage.angle = angle;
+    double * const averages = lines + height;
+    for (int y = 0; y < height; y++)
     {
-        uint8_t * dataPtr = buffer;
-        const uint8_t * origDataPtr = m_ImageData->getImageBuffer();
-        // Copy data line by line
-        for (int height = subY; height < (subY + subH); height++)
+        double multiRowSum = 0;
+        for (int y1 = y - (averageRows - 1) / 2; y1 <= y + (averageRows - 1) / 2; y1++)
+            multiRowSum += sums[(y1 % height + height) % height];
+
+        averages[y] = multiRowSum / (width * averageRows);
+        if (averages[y] > lineAverage.average)
         {
-            uint32_t lineOffset = (subX + height * dataWidth) * BBP;
-            memcpy(dataPtr, origDataPtr + lineOffset, subW * BBP);
-            dataPtr += (subW * BBP);
+            lineAverage.average = averages[y];
+            lineAverage.offset = y;
         }
     }
 
-    // #3 Create new FITSData to hold it
-    FITSImage::Statistic stats;
-    stats.width = subW;
-    stats.height = subH;
-    stats.dataType = m_ImageData->getStatistics().dataType;
-    stats.bytesPerPixel = BBP;
-    stats.samples_per_channel = size;
-    FITSData* boundedImage = new FITSData();
-    boundedImage->restoreStatistics(stats);
-    boundedImage->setProperty("dataType", stats.dataType);
-
-    // #4 Set image buffer
-    boundedImage->setImageBuffer(buffer);
+    // Interpolate the peak with a parabola through the lines around it
+    lineAverage.score = lineAverage.average;
+    int const y = static_cast<int>(lineAverage.offset);
+    if (y > 0 && y < height - 1)
+    {
+        double const before = averages[y - 1];
+        double const after = averages[y + 1];
+        double const curvature = before - 2 * averages[y] + after;
+        if (curvature < 0)
+        {
+            lineAverage.offset += 0.5 * (before - after) / curvature;
+            lineAverage.score = averages[y] - (before - after) * (before - after) / (8 * curvature);
+        }
+    }
 
-    boundedImage->calculateStats(true);
+    return lineAverage;
+}
 
-    QElapsedTimer timer1;
+template <typename T>
+bool FITSBahtinovDetector::findBahtinovStar(const QRect &boundary)
+{
+    if (boundary.isEmpty())
+        return false;
 
-    // Rotate image 180 degrees in steps of 1 degree
-    QMap<int, BahtinovLineAverage> lineAveragesPerAngle;
-    const int steps = 180;
-    double radPerStep = M_PI / steps;
+    QList<Edge*> starCenters;
+    QRect const area = boundary.intersected(QRect(0, 0, m_ImageData->width(), m_ImageData->height()));
+    if (area.isEmpty())
+    {
+        m_ImageData->setStarCenters(starCenters);
+        return true;
+    }
 
-    timer1.start();
+    int subX = area.x();
+    int subY = area.y();
+    int subW = area.width();
+    int subH = area.height();
 
-    for (int angle = 0; angle < steps; angle++)
+    int NUMBER_OF_AVERAGE_ROWS = getValue("NUMBER_OF_AVERAGE_ROWS", 1).toInt();
+    if (NUMBER_OF_AVERAGE_ROWS % 2 == 0)
     {
-        // TODO Apply multi threading to speed up calculation
-        BahtinovLineAverage lineAverage = calculateMaxAverage<T>(boundedImage, angle);
-        // Store line average in map
-        lineAveragesPerAngle.insert(angle, lineAverage);
+        NUMBER_OF_AVERAGE_ROWS--;
+        qCWarning(KSTARS_FITS) << "Warning, number of rows must be an odd number, correcting number of rows to "
+                               << NUMBER_OF_AVERAGE_ROWS;
+    }
+    // Rows must be a positive number!
+    if (NUMBER_OF_AVERAGE_ROWS < 1)
+    {
+        NUMBER_OF_AVERAGE_ROWS = 1;
+        qCWarning(KSTARS_FITS) << "Warning, number of rows must be positive correcting number of rows to "
+                               << NUMBER_OF_AVERAGE_ROWS;
     }
 
-    qCDebug(KSTARS_FITS) << "Getting max average for all 180 rotations took" << timer1.elapsed() << "milliseconds";
+    QElapsedTimer timer1;
+    timer1.start();
 
-    // Not needed anymore
-    delete boundedImage;
+    BahtinovSamples &samples = m_Samples;
+    gatherSamples<T>(m_ImageData->getImageView().sub(area), samples);
 
-    // Calculate Bahtinov angles
-    QVector<HoughLine*> bahtinov_angles;
+    // Radon transform over half a turn, in steps of 1 degree
+    const int steps = ANGLE_STEPS;
+    double radPerStep = M_PI / steps;
+    QVector<BahtinovLineAverage> lineAverages(steps);
+    for (int angle = 0; angle < steps; angle++)
+        lineAverages[angle].angle = angle * radPerStep;
 
-    // For all three Bahtinov angles
+    // Each direction sums and averages its lines in its own slice of the projections
+    int const directions = std::max(steps, 3 * 2 * REFINEMENT_STEPS);
+    double * const projections = reinterpret_cast<double *>(m_Projections.allocate(directions * 2 * samples.height *
+                                 sizeof(double)));
+    auto const project = [&samples, projections, NUMBER_OF_AVERAGE_ROWS](QVector<BahtinovLineAverage> &lineAverages)
+    {
+        BahtinovLineAverage * const first = lineAverages.data();
+        QtConcurrent::blockingMap(lineAverages, [&samples, projections, NUMBER_OF_AVERAGE_ROWS,
+                                                 first](BahtinovLineAverage & lineAverage)
+        {
+            double * const lines = projections + (&lineAverage - first) * 2 * samples.height;
+            lineAverage = calculateMaxAverage(samples, lineAverage.angle, NUMBER_OF_AVERAGE_ROWS, lines);
+        });
+    };
+    project(lineAverages);
+
+    QMap<int, BahtinovLineAverage> lineAveragesPerAngle;
+    for (int angle = 0; angle < steps; angle++)
+        lineAveragesPerAngle.insert(angle, lineAverages[angle]);
+
+    // Find the directions of the three Bahtinov lines
+    QVector<int> peakAngles;
     for (int index1 = 0; index1 < 3; index1++)
     {
         double maxAverage = 0.0;
-        double maxAngle = 0.0;
-        int maxAverageOffset = 0;
-        for (int angle = 0; angle < steps; angle++)
+        int maxAngle = -1;
+        for (auto it = lineAveragesPerAngle.constBegin(); it != lineAveragesPerAngle.constEnd(); ++it)
         {
-            BahtinovLineAverage lineAverage = lineAveragesPerAngle[angle];
-            if (lineAverage.average > maxAverage)
+            if (it.value().average > maxAverage)
             {
-                maxAverage = lineAverage.average;
-                maxAverageOffset = lineAverage.offset;
-                maxAngle = angle;
+                maxAverage = it.value().average;
+                maxAngle = it.key();
             }
         }
-        HoughLine* pHoughLine = new HoughLine(maxAngle * radPerStep, maxAverageOffset, subW, subH, maxAverage);
-        if (pHoughLine != nullptr)
+        if (maxAngle < 0)
+            break;
+        peakAngles.append(maxAngle);
+
+        // Remove data around peak to prevent it from being detected again
+        for (int subAngle = maxAngle - MINIMUM_LINE_ANGLE; subAngle < maxAngle + MINIMUM_LINE_ANGLE; subAngle++)
+            lineAveragesPerAngle.remove((subAngle + steps) % steps);
+    }
+
+    // Refine the directions around the peaks, all of them at once
+    QVector<BahtinovLineAverage> refinements;
+    for (int maxAngle : peakAngles)
+    {
+        for (int i = -REFINEMENT_STEPS; i <= REFINEMENT_STEPS; i++)
         {
-            bahtinov_angles.append(pHoughLine);
+            if (i == 0)
+                continue;
+            BahtinovLineAverage refinement;
+            refinement.angle = (maxAngle + i / 10.0) * radPerStep;
+            refinements.append(refinement);
         }
+    }
+    project(refinements);
 
-        // Remove data around peak to prevent it from being detected again
-        int minBahtinovAngleOffset = 18;
-        for (int subAngle = maxAngle - minBahtinovAngleOffset; subAngle < maxAngle + minBahtinovAngleOffset; subAngle++)
+    // Calculate Bahtinov angles
+    QVector<HoughLine*> bahtinov_angles;
+    for (int index1 = 0; index1 < peakAngles.size(); index1++)
+    {
+        BahtinovLineAverage peak = lineAverages[peakAngles[index1]];
+        for (int i = 0; i < 2 * REFINEMENT_STEPS; i++)
         {
-            int angleInRange = subAngle;
-            if (angleInRange < 0)
-            {
-                angleInRange += 180;
-            }
-            if (angleInRange >= 180)
-            {
-                angleInRange -= 180;
-            }
-            lineAveragesPerAngle.remove(angleInRange);
+            BahtinovLineAverage const &refinement = refinements[index1 * 2 * REFINEMENT_STEPS + i];
+            if (refinement.score > peak.score)
+                peak = refinement;
+        }
+
+        HoughLine* pHoughLine = new HoughLine(peak.angle, peak.offset, subW, subH, peak.average);
+        if (pHoughLine != nullptr)
+        {
+            bahtinov_angles.append(pHoughLine);
         }
     }
 
+    qCDebug(KSTARS_FITS) << "Radon transform of" << samples.value.size() << "pixels over" << steps + refinements.size()
+                         << "directions took" << timer1.elapsed() << "milliseconds";
+
     // Proceed with focus offset calculation, but only when at least 3 lines have been detected
     QVector<HoughLine*> top3Lines;
     if (bahtinov_angles.size() >= 3)
@@ -280,176 +400,3 @@ bool FITSBahtinovDetector::findBahtinovStar(const QRect &boundary)
 
     return true;
 }
-
-template <typename T>
-BahtinovLineAverage FITSBahtinovDetector::calculateMaxAverage(const FITSData *data, int angle)
-{
-    int BBP = data->getBytesPerPixel();
-    int size = data->getStatistics().samples_per_channel;
-    int width = data->width();
-    int height = data->height();
-    int numChannels = data->channels();
-
-    BahtinovLineAverage lineAverage;
-    auto * rotimage = new T[size * BBP];
-
-    rotateImage(data, angle, rotimage);
-
-    // Calculate average pixel value for each row
-    auto * rotBuffer = reinterpret_cast<T *>(rotimage);
-
-    //    printf("Angle;%d;Width;%d;Height;%d;Rows;%d;;RowSum;", angle, width, height, NUMBER_OF_AVERAGE_ROWS);
-
-    int NUMBER_OF_AVERAGE_ROWS = getValue("NUMBER_OF_AVERAGE_ROWS", 1).toInt();
-    if (NUMBER_OF_AVERAGE_ROWS % 2 == 0)
-    {
-        NUMBER_OF_AVERAGE_ROWS--;
-        qCWarning(KSTARS_FITS) << "Warning, number of rows must be an odd number, correcting number of rows to "
-                               << NUMBER_OF_AVERAGE_ROWS;
-    }
-    // Rows must be a positive number!
-    if (NUMBER_OF_AVERAGE_ROWS < 1)
-    {
-        NUMBER_OF_AVERAGE_ROWS = 1;
-        qCWarning(KSTARS_FITS) << "Warning, number of rows must be positive correcting number of rows to "
-                               << NUMBER_OF_AVERAGE_ROWS;
-    }
-
-    for (int y = 0; y < height; y++)
-    {
-        int yMin = y - ((NUMBER_OF_AVERAGE_ROWS - 1) / 2);
-        int yMax = y + ((NUMBER_OF_AVERAGE_ROWS - 1) / 2);
-
-        unsigned long multiRowSum = 0;
-        // Calculate average over multiple rows
-        for (int y1 = yMin; y1 <= yMax; y1++)
-        {
-            int y2 = y1;
-            if (y2 < 0)
-            {
-                y2 += height;
-            }
-            if (y2 >= height)
-            {
-                y2 -= height;
-            }
-            if (y2 < 0 || y2 >= height)
-            {
-                qCWarning(KSTARS_FITS) << "Y still out of bounds: 0 <=" << y2 << "<" << height;
-            }
-
-            for (int x1 = 0; x1 < width; x1++)
-            {
-                int index = y2 * width + x1;
-                unsigned long channelAverage = 0;
-                for (int i = 0; i < numChannels; i++)
-                {
-                    int offset = size * i;
-                    channelAverage += rotBuffer[index + offset];
-                }
-                multiRowSum += qRound(channelAverage / static_cast<double>(numChannels));
-            }
-        }
-        //        printf("%lu;", multiRowSum);
-
-        double average = multiRowSum / static_cast<double>(width * NUMBER_OF_AVERAGE_ROWS);
-        if (average > lineAverage.average)
-        {
-            lineAverage.average = average;
-            lineAverage.offset = y;
-        }
-    }
-    //    printf(";;MaxAverage;%.3f;MaxAverageIndex;%lu\r\n", lineAverage.average, lineAverage.offset);
-    //    fflush(stdout);
-
-    rotBuffer = nullptr;
-    delete[] rotimage;
-    rotimage = nullptr;
-
-    return lineAverage;
-}
-
-/** Rotate an image by angle degrees.
- * verbose generates extra info on stdout.
- * return true if successful and rotated image.
- * @param angle The angle over which the image needs to be rotated
- * @param rotImage The image that needs to be rotated, also the rotated image return value
- */
-template <typename T>
-bool FITSBahtinovDetector::rotateImage(const FITSData *data, int angle, T * rotImage)
-{
-    int BBP = data->getBytesPerPixel();
-    int size = data->getStatistics().samples_per_channel;
-    int width = data->width();
-    int height = data->height();
-    int numChannels = data->channels();
-
-    int hx, hy;
-    size_t bufferSize;
-
-    /* Check allocation buffer for rotated image */
-    if (rotImage == nullptr)
-    {
-        qWarning() << "No memory allocated for rotated image buffer!";
-        return false;
-    }
-
-    while (angle < 0)
-    {
-        angle = angle + 360;
-    }
-    while (angle >= 360)
-    {
-        angle = angle - 360;
-    }
-
-    hx = qFloor((width + 1) / 2.0);
-    hy = qFloor((height + 1) / 2.0);
-
-    bufferSize = size * numChannels * BBP;
-    memset(rotImage, 0, bufferSize);
-
-    auto * rotBuffer = reinterpret_cast<T *>(rotImage);
-    auto * buffer = reinterpret_cast<const T *>(data->getImageBuffer());
-
-    double innerCircleRadius = (0.5 * qSqrt(2.0) * qMin(hx, hy));
-    double angleInRad = angle * M_PI / 180.0;
-    double sinAngle = qSin(angleInRad);
-    double cosAngle = qCos(angleInRad);
-    int leftEdge = qCeil(hx - innerCircleRadius);
-    int rightEdge = qFloor(hx + innerCircleRadius);
-    int topEdge = qCeil(hy - innerCircleRadius);
-    int bottomEdge = qFloor(hy + innerCircleRadius);
-
-    for (int i = 0; i < numChannels; i++)
-    {
-        int offset = size * i;
-        for (int x1 = leftEdge; x1 < rightEdge; x1++)
-        {
-            for (int y1 = topEdge; y1 < bottomEdge; y1++)
-            {
-                // translate point back to origin:
-                double x2 = x1 - hx;
-                double y2 = y1 - hy;
-
-                // rotate point
-                double xnew = x2 * cosAngle - y2 * sinAngle;
-                double ynew = x2 * sinAngle + y2 * cosAngle;
-
-                // translate point back:
-                x2 = xnew + hx;
-                y2 = ynew + hy;
-
-                int orgIndex = y1 * height + x1;
-                int newIndex = qRound(y2) * height + qRound(x2);
-
-                if (newIndex >= 0 && newIndex < static_cast<int>(bufferSize))
-                {
-                    rotBuffer[newIndex + offset] = buffer[orgIndex + offset];
-                } // else index out of bounds, do not update pixel
-            }
-        }
-    }
-
-    return true;
-}
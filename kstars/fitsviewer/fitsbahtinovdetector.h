@@ -8,6 +8,11 @@
 #define FITSBAHTINOVDETECTOR_H
 
 #include "fitsstardetector.h"
+#include "framebufferpool.h"
+
+#include <vector>
+
+class FITSImageView;
 
 class BahtinovLineAverage
 {
@@ -16,13 +21,41 @@ class BahtinovLineAverage
         {
             average = 0.0;
             offset = 0;
+            angle = 0.0;
+            score = 0.0;
         }
         virtual ~BahtinovLineAverage() = default;
 
+        /** @brief Highest average along the lines of the direction, and offset of its line with subpixel accuracy. */
         double average;
-        size_t offset;
+        double offset;
+        /** @brief Direction of the lines in radians. */
+        double angle;
+        /** @brief Highest average interpolated between the lines, less dependent on where the line falls. */
+        double score;
+};
+
+/** @brief Pixels of the inscribed circle of the searched area, relative to its center. */
+class BahtinovSamples
+{
+    public:
+        int width { 0 };
+        int height { 0 };
+        std::vector<float> dx;
+        std::vector<float> dy;
+        std::vector<float> value;
 };
 
+/**
+ * @class FITSBahtinovDetector
+ * @short Finds the three lines of the diffraction pattern of a Bahtinov mask.
+ *
+ * The averages of the pixels along the lines of each direction are the Radon transform of the area. The pixels are
+ * gathered once, then the transform is computed for each degree, the directions being spread across the global
+ * thread pool. Each pixel is shared between the two nearest lines so that the averages vary smoothly with the
+ * direction. The directions of the three highest averages are refined to a tenth of a degree, and the offsets of
+ * their lines are interpolated between pixels.
+ */
 class FITSBahtinovDetector: public FITSStarDetector
 {
         Q_OBJECT
@@ -36,6 +69,9 @@ class FITSBahtinovDetector: public FITSStarDetector
          */
         QFuture<bool> findSources(QRect const &boundary = QRect()) override;
 
+        /** @see FITSStarDetector::reusedBuffers(). */
+        QVector<QPair<void const *, size_t>> reusedBuffers() const override;
+
         /** @brief Configure the detection method.
          * @see FITSStarDetector::configure().
          * @note Parameter "numaveragerows" defaults to NUMBER_OF_AVERAGE_ROWS of the mean pixel value of the frame.
@@ -47,6 +83,12 @@ class FITSBahtinovDetector: public FITSStarDetector
         /** @group Detection parameters.
          * @{ */
         //int NUMBER_OF_AVERAGE_ROWS { 1 };
+        /** @brief Directions searched over half a turn. */
+        int ANGLE_STEPS { 180 };
+        /** @brief Directions tried on each side of a peak, by tenths of a step. */
+        int REFINEMENT_STEPS { 5 };
+        /** @brief Minimum angle between two lines of the mask, in steps. */
+        int MINIMUM_LINE_ANGLE { 18 };
         /** @} */
 
     protected:
@@ -57,10 +99,21 @@ class FITSBahtinovDetector: public FITSStarDetector
         bool findBahtinovStar(const QRect &boundary);
 
     private:
+        /** @internal Gather the pixels of the inscribed circle of @p view, averaged over the channels. */
         template <typename T>
-        BahtinovLineAverage calculateMaxAverage(const FITSData *data, int angle);
-        template <typename T>
-        bool rotateImage(const FITSData *data, int angle, T * rotimage);
+        void gatherSamples(const FITSImageView &view, BahtinovSamples &samples) const;
+
+        /**
+         * @internal Find the line of highest average among the lines of direction @p angle, in radians.
+         * @param lines room for the sums and the averages of the lines, twice the height of the samples.
+         */
+        static BahtinovLineAverage calculateMaxAverage(const BahtinovSamples &samples, double angle, int averageRows,
+                double *lines);
+
+        /** Samples of the last detection, whose buffers are reused by the next one */
+        BahtinovSamples m_Samples;
+        /** Sums and averages of the lines of each direction, reused by the next detection */
+        FrameBuffer m_Projections;
 };
 
 #endif // FITSBAHTINOVDETECTOR_H
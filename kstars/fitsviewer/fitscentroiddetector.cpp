@@ -11,6 +11,7 @@
 #include <math.h>
 #include <cmath>
 #include <QtConcurrent>
+#include <QThread>
 
 #include "fitscentroiddetector.h"
 #include "fits_debug.h"
@@ -31,24 +32,6 @@
 //            JMINDEX = value.value <double> ();
 //}
 
-bool FITSCentroidDetector::checkCollision(Edge * s1, Edge * s2) const
-{
-    int dis; //distance
-
-    int diff_x = s1->x - s2->x;
-    int diff_y = s1->y - s2->y;
-
-    dis = std::abs(sqrt(diff_x * diff_x + diff_y * diff_y));
-    dis -= s1->width / 2;
-    dis -= s2->width / 2;
-
-    if (dis <= 0) //collision
-        return true;
-
-    //no collision
-    return false;
-}
-
 /*** Find center of stars and calculate Half Flux Radius */
 QFuture<bool> FITSCentroidDetector::findSources(const QRect &boundary)
 {
@@ -83,6 +66,111 @@ QFuture<bool> FITSCentroidDetector::findSources(const QRect &boundary)
     }
 }
 
+QVector<QPair<void const *, size_t>> FITSCentroidDetector::reusedBuffers() const
+{
+    QVector<QPair<void const *, size_t>> buffers;
+    buffers.append(qMakePair<void const *, size_t>(m_Bands.data(), m_Bands.capacity() * sizeof(Band)));
+    for (Band const &band : m_Bands)
+        buffers.append(qMakePair<void const *, size_t>(band.runs.data(), band.runs.capacity() * sizeof(Run)));
+    buffers.append(qMakePair<void const *, size_t>(m_Runs.data(), m_Runs.capacity() * sizeof(Run)));
+    buffers.append(qMakePair<void const *, size_t>(m_Labels.data(), m_Labels.capacity() * sizeof(int)));
+    buffers.append(qMakePair<void const *, size_t>(m_Components.data(), m_Components.capacity() * sizeof(Component)));
+    return buffers;
+}
+
+int FITSCentroidDetector::root(std::vector<Run> &runs, int index)
+{
+    while (runs[index].parent != index)
+    {
+        runs[index].parent = runs[runs[index].parent].parent;
+        index = runs[index].parent;
+    }
+    return index;
+}
+
+void FITSCentroidDetector::joinRows(std::vector<Run> &runs, int a, int aEnd, int b, int bEnd)
+{
+    // Both rows are sorted, runs touching diagonally are connected
+    while (a < aEnd && b < bEnd)
+    {
+        if (runs[a].x1 + 1 >= runs[b].x0 && runs[b].x1 + 1 >= runs[a].x0)
+        {
+            int const rootA = root(runs, a);
+            int const rootB = root(runs, b);
+            // The root of a component is its first run
+            if (rootA < rootB)
+                runs[rootB].parent = rootA;
+            else if (rootB < rootA)
+                runs[rootA].parent = rootB;
+        }
+
+        if (runs[a].x1 < runs[b].x1)
+            a++;
+        else
+            b++;
+    }
+}
+
+template <typename T>
+void FITSCentroidDetector::labelBand(Band &band, T const *buffer, int width, const QRect &area,
+                                     const Level &level) const
+{
+    band.runs.clear();
+    band.edges = 0;
+    band.firstRowEnd = band.lastRowBegin = 0;
+
+    for (int y = band.begin; y < band.end; y++)
+    {
+        T const *row = buffer + static_cast<size_t>(y) * width;
+        int const rowBegin = static_cast<int>(band.runs.size());
+
+        for (int x = area.left(); x <= area.right();)
+        {
+            if (row[x] - level.min < level.threshold)
+            {
+                x++;
+                continue;
+            }
+
+            Run run;
+            run.y = y;
+            run.x0 = x;
+            run.parent = static_cast<int>(band.runs.size());
+            for (; x <= area.right() && row[x] - level.min >= level.threshold; x++)
+            {
+                double const weight = std::max(0.0, row[x] - level.sky);
+                run.flux += weight;
+                run.sumX += weight * x;
+                run.sumXX += weight * x * x;
+                run.peak = std::max(run.peak, static_cast<int>(row[x] - level.min));
+            }
+            run.x1 = x - 1;
+
+            // Check if center is brighter than the edges of the run, as the edges of the former detector
+            int const runWidth = run.x1 - run.x0 + 1;
+            if (runWidth >= level.minEdgeWidth)
+            {
+                double const center = run.flux > 0 ? run.sumX / run.flux : (run.x0 + run.x1) / 2.0;
+                int const c = qBound(run.x0, static_cast<int>(std::floor(center + 0.5)), run.x1);
+                double const peak = row[c] - level.min;
+                double const left = row[std::max(0, c - runWidth / 2)] - level.min;
+                double const right = row[std::min(width - 1, c + runWidth / 2)] - level.min;
+                run.edge = peak >= level.dispersionRatio * left && peak >= level.dispersionRatio * right;
+                band.edges += run.edge;
+            }
+
+            band.runs.push_back(run);
+        }
+
+        int const rowEnd = static_cast<int>(band.runs.size());
+        if (y == band.begin)
+            band.firstRowEnd = rowEnd;
+        else
+            joinRows(band.runs, band.lastRowBegin, rowBegin, rowBegin, rowEnd);
+        band.lastRowBegin = rowBegin;
+    }
+}
+
 template <typename T>
 bool FITSCentroidDetector::findSources(const QRect &boundary)
 {
@@ -94,16 +182,41 @@ bool FITSCentroidDetector::findSources(const QRect &boundary)
     double JMIndex = getValue("JMINDEX", 100.0).toDouble();
 
     int initStdDev = MINIMUM_STDVAR;
-    double threshold = 0, sum = 0, avg = 0, min = 0;
-    int starDiameter     = 0;
-    int pixVal           = 0;
     int minimumEdgeCount = MINIMUM_EDGE_LIMIT;
-
     auto * buffer = reinterpret_cast<T const *>(m_ImageData->getImageBuffer());
 
-    float dispersion_ratio = 1.5;
+    QRect area;
+    if (!boundary.isNull())
+        area = boundary.intersected(QRect(0, 0, stats.width, stats.height));
+    else if (m_Mode == FITS_GUIDE || m_Mode == FITS_FOCUS)
+    {
+        // Only consider the central 70%
+        int const subX = round(stats.width * 0.15);
+        int const subY = round(stats.height * 0.15);
+        area = QRect(subX, subY, stats.width - 2 * subX, stats.height - 2 * subY);
+    }
+    else
+        area = QRect(0, 0, stats.width, stats.height);
+
+    QList<Edge*> starCenters;
+    if (area.isEmpty())
+    {
+        m_ImageData->setStarCenters(starCenters);
+        return true;
+    }
+
+    // Bands of rows scanned in parallel
+    int const bandCount = qBound(1, area.height() / MINIMUM_BAND_HEIGHT, QThread::idealThreadCount());
+    m_Bands.resize(bandCount);
+    for (int b = 0; b < bandCount; b++)
+    {
+        m_Bands[b].begin = area.top() + area.height() * b / bandCount;
+        m_Bands[b].end = area.top() + area.height() * (b + 1) / bandCount;
+    }
 
-    QList<Edge *> edges;
+    Level level;
+    // The sky is subtracted from the flux, not from the pixels compared to the threshold
+    level.sky = std::max(stats.min[0], stats.median[0]);
 
     if (JMIndex < DIFFUSE_THRESHOLD)
     {
@@ -116,6 +229,8 @@ bool FITSCentroidDetector::findSources(const QRect &boundary)
         minimumEdgeCount = 4;
     }
 
+    int edgeCount = 0;
+    bool found = false;
     while (initStdDev >= 1)
     {
         minEdgeWidth--;
@@ -127,325 +242,178 @@ bool FITSCentroidDetector::findSources(const QRect &boundary)
         if (JMIndex < DIFFUSE_THRESHOLD)
         {
             // Taking the average out seems to have better result for noisy images
-            threshold = stats.max[0] - stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
+            level.threshold = stats.max[0] - stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
 
-            min = stats.min[0];
-            if (threshold - min < 0)
+            level.min = stats.min[0];
+            if (level.threshold - level.min < 0)
             {
-                threshold = stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
-                min       = 0;
+                level.threshold = stats.mean[0] * ((MINIMUM_STDVAR - initStdDev) * 0.5 + 1);
+                level.min       = 0;
             }
 
-            dispersion_ratio = 1.4 - (MINIMUM_STDVAR - initStdDev) * 0.08;
+            level.dispersionRatio = 1.4 - (MINIMUM_STDVAR - initStdDev) * 0.08;
         }
         else
         {
-            threshold = stats.mean[0] + stats.stddev[0] * initStdDev * (0.3 - (MINIMUM_STDVAR - initStdDev) * 0.05);
-            min       = stats.min[0];
+            level.threshold = stats.mean[0] + stats.stddev[0] * initStdDev * (0.3 - (MINIMUM_STDVAR - initStdDev) * 0.05);
+            level.min       = stats.min[0];
             // Ratio between centeroid center and edge
-            dispersion_ratio = 1.8 - (MINIMUM_STDVAR - initStdDev) * 0.2;
+            level.dispersionRatio = 1.8 - (MINIMUM_STDVAR - initStdDev) * 0.2;
         }
 
-        qCDebug(KSTARS_FITS) << "SNR: " << stats.SNR;
-        qCDebug(KSTARS_FITS) << "The threshold level is " << threshold << "(actual " << threshold - min
-                             << ")  minimum edge width" << minEdgeWidth << " minimum edge limit " << minimumEdgeCount;
-
-        threshold -= min;
+        level.threshold -= level.min;
+        level.minEdgeWidth = minEdgeWidth;
 
-        int subX, subY, subW, subH;
+        qCDebug(KSTARS_FITS) << "The threshold level is " << level.threshold << " minimum edge width" << minEdgeWidth
+                             << " minimum edge limit " << minimumEdgeCount;
 
-        if (boundary.isNull())
+        QtConcurrent::blockingMap(m_Bands, [&](Band & band)
         {
-            if (m_Mode == FITS_GUIDE || m_Mode == FITS_FOCUS)
-            {
-                // Only consider the central 70%
-                subX = round(stats.width * 0.15);
-                subY = round(stats.height * 0.15);
-                subW = stats.width - subX;
-                subH = stats.height - subY;
-            }
-            else
-            {
-                // Consider the complete area 100%
-                subX = 0;
-                subY = 0;
-                subW = stats.width;
-                subH = stats.height;
-            }
-        }
-        else
-        {
-            subX = boundary.x();
-            subY = boundary.y();
-            subW = subX + boundary.width();
-            subH = subY + boundary.height();
-        }
+            labelBand<T>(band, buffer, stats.width, area, level);
+        });
 
-        // Detect "edges" that are above threshold
-        for (int i = subY; i < subH; i++)
-        {
-            starDiameter = 0;
+        edgeCount = 0;
+        for (Band const &band : m_Bands)
+            edgeCount += band.edges;
 
-            for (int j = subX; j < subW; j++)
-            {
-                pixVal = buffer[j + (i * stats.width)] - min;
-
-                // If pixel value > threshold, let's get its weighted average
-                if (pixVal >= threshold)
-                {
-                    avg += j * pixVal;
-                    sum += pixVal;
-                    starDiameter++;
-                }
-                // Value < threshold but avg exists
-                else if (sum > 0)
-                {
-                    // We found a potential centroid edge
-                    if (starDiameter >= minEdgeWidth)
-                    {
-                        float center = avg / sum + 0.5;
-                        if (center > 0)
-                        {
-                            int i_center = std::floor(center);
-
-                            // Check if center is 10% or more brighter than edge, if not skip
-                            if (((buffer[i_center + (i * stats.width)] - min) /
-                                    (buffer[i_center + (i * stats.width) - starDiameter / 2] - min) >=
-                                    dispersion_ratio) &&
-                                    ((buffer[i_center + (i * stats.width)] - min) /
-                                     (buffer[i_center + (i * stats.width) + starDiameter / 2] - min) >=
-                                     dispersion_ratio))
-                            {
-                                qCDebug(KSTARS_FITS)
-                                        << "Edge center is " << buffer[i_center + (i * stats.width)] - min
-                                        << " Edge is " << buffer[i_center + (i * stats.width) - starDiameter / 2] - min
-                                        << " and ratio is "
-                                        << ((buffer[i_center + (i * stats.width)] - min) /
-                                            (buffer[i_center + (i * stats.width) - starDiameter / 2] - min))
-                                        << " located at X: " << center << " Y: " << i + 0.5;
-
-                                auto * newEdge = new Edge();
-
-                                newEdge->x       = center;
-                                newEdge->y       = i + 0.5;
-                                newEdge->scanned = 0;
-                                newEdge->val     = buffer[i_center + (i * stats.width)] - min;
-                                newEdge->width   = starDiameter;
-                                newEdge->HFR     = 0;
-                                newEdge->sum     = sum;
-
-                                edges.append(newEdge);
-                            }
-                        }
-                    }
-
-                    // Reset
-                    avg = sum = starDiameter = 0;
-                }
-            }
-        }
-
-        qCDebug(KSTARS_FITS) << "Total number of edges found is: " << edges.count();
+        qCDebug(KSTARS_FITS) << "Total number of edges found is: " << edgeCount;
 
         // In case of hot pixels
-        if (edges.count() == 1 && initStdDev > 1)
+        if (edgeCount == 1 && initStdDev > 1)
         {
             initStdDev--;
             continue;
         }
 
-        if (edges.count() >= MAX_EDGE_LIMIT)
+        if (edgeCount >= MAX_EDGE_LIMIT)
         {
-            qCWarning(KSTARS_FITS) << "Too many edges, aborting... " << edges.count();
-            qDeleteAll(edges);
-            return -1;
+            qCWarning(KSTARS_FITS) << "Too many edges, aborting... " << edgeCount;
+            return false;
         }
 
-        if (edges.count() >= minimumEdgeCount)
+        if (edgeCount >= minimumEdgeCount)
+        {
+            found = true;
             break;
+        }
 
-        qDeleteAll(edges);
-        edges.clear();
         initStdDev--;
     }
 
-    int cen_count = 0;
-    int cen_x     = 0;
-    int cen_y     = 0;
-    int cen_v     = 0;
-    int cen_w     = 0;
-    int width_sum = 0;
-
-    // Let's sort edges, starting with widest
-    auto const greaterThan = [](Edge const * a, Edge const * b)
+    if (!found)
     {
-        return a->sum > b->sum;
-    };
-    std::sort(edges.begin(), edges.end(), greaterThan);
+        m_ImageData->setStarCenters(starCenters);
+        return true;
+    }
 
-    QList<Edge*> starCenters;
-    // Now, let's scan the edges and find the maximum centroid vertically
-    for (int i = 0; i < edges.count(); i++)
+    // Gather the runs of the bands, and join the runs across the seams between bands
+    m_Runs.clear();
+    int previousLastRow = 0;
+    for (int b = 0; b < bandCount; b++)
     {
-        qCDebug(KSTARS_FITS) << "# " << i << " Edge at (" << edges[i]->x << "," << edges[i]->y << ") With a value of "
-                             << edges[i]->val << " and width of " << edges[i]->width << " pixels. with sum " << edges[i]->sum;
-
-        // If edge scanned already, skip
-        if (edges[i]->scanned == 1)
+        Band const &band = m_Bands[b];
+        int const offset = static_cast<int>(m_Runs.size());
+        for (Run run : band.runs)
         {
-            qCDebug(KSTARS_FITS) << "Skipping check for center " << i << " because it was already counted";
-            continue;
+            run.parent += offset;
+            m_Runs.push_back(run);
         }
 
-        qCDebug(KSTARS_FITS) << "Investigating edge # " << i << " now ...";
-
-        // Get X, Y, and Val of edge
-        cen_x = edges[i]->x;
-        cen_y = edges[i]->y;
-        cen_v = edges[i]->sum;
-        cen_w = edges[i]->width;
-
-        float avg_x = 0;
-        float avg_y = 0;
-
-        sum       = 0;
-        cen_count = 0;
+        if (b > 0)
+            joinRows(m_Runs, previousLastRow, offset, offset, offset + band.firstRowEnd);
+        previousLastRow = offset + band.lastRowBegin;
+    }
 
-        // Now let's compare to other edges until we hit a maxima
-        for (int j = 0; j < edges.count(); j++)
+    // Sum the moments of the runs of each component
+    m_Labels.assign(m_Runs.size(), -1);
+    m_Components.clear();
+    for (int i = 0; i < static_cast<int>(m_Runs.size()); i++)
+    {
+        int const r = root(m_Runs, i);
+        if (m_Labels[r] < 0)
         {
-            if (edges[j]->scanned)
-                continue;
-
-            if (checkCollision(edges[j], edges[i]))
-            {
-                if (edges[j]->sum >= cen_v)
-                {
-                    cen_v = edges[j]->sum;
-                    cen_w = edges[j]->width;
-                }
-
-                edges[j]->scanned = 1;
-                cen_count++;
-
-                avg_x += edges[j]->x * edges[j]->val;
-                avg_y += edges[j]->y * edges[j]->val;
-                sum += edges[j]->val;
-
-                continue;
-            }
+            m_Labels[r] = static_cast<int>(m_Components.size());
+            m_Components.emplace_back();
         }
 
-        int cen_limit = (MINIMUM_ROWS_PER_CENTER - (MINIMUM_STDVAR - initStdDev));
-
-        if (edges.count() < LOW_EDGE_CUTOFF_1)
+        Run const &run = m_Runs[i];
+        Component &component = m_Components[m_Labels[r]];
+        double const y = run.y;
+        component.flux += run.flux;
+        component.sumX += run.sumX;
+        component.sumY += y * run.flux;
+        component.sumXX += run.sumXX;
+        component.sumYY += y * y * run.flux;
+        component.sumXY += y * run.sumX;
+        component.peak = std::max(component.peak, run.peak);
+        component.pixels += run.x1 - run.x0 + 1;
+        if (run.edge)
         {
-            if (edges.count() < LOW_EDGE_CUTOFF_2)
-                cen_limit = 1;
-            else
-                cen_limit = 2;
+            component.edges++;
+            component.width = std::max(component.width, run.x1 - run.x0 + 1);
         }
+    }
 
-        qCDebug(KSTARS_FITS) << "center_count: " << cen_count << " and initstdDev= " << initStdDev << " and limit is "
-                             << cen_limit;
-
-        if (cen_limit < 1)
-            continue;
-
-        // If centroid count is within acceptable range
-        //if (cen_limit >= 2 && cen_count >= cen_limit)
-        if (cen_count >= cen_limit)
-        {
-            // We detected a centroid, let's init it
-            auto * rCenter = new Edge();
-
-            rCenter->x = avg_x / sum;
-            rCenter->y = avg_y / sum;
-            width_sum += rCenter->width;
-            rCenter->width = cen_w;
-
-            qCDebug(KSTARS_FITS) << "Found a real center with number with (" << rCenter->x << "," << rCenter->y << ")";
-
-            // Calculate Total Flux From Center, Half Flux, Full Summation
-            double TF   = 0;
-            double HF   = 0;
-            double FSum = 0;
-
-            cen_x = (int)std::floor(rCenter->x);
-            cen_y = (int)std::floor(rCenter->y);
-
-            if (cen_x < 0 || cen_x > stats.width || cen_y < 0 || cen_y > stats.height)
-            {
-                delete rCenter;
-                continue;
-            }
-
-            // Complete sum along the radius
-            //for (int k=0; k < rCenter->width; k++)
-            for (int k = rCenter->width / 2; k >= -(rCenter->width / 2); k--)
-            {
-                FSum += buffer[cen_x - k + (cen_y * stats.width)] - min;
-                //qDebug() << Q_FUNC_INFO << image_buffer[cen_x-k+(cen_y*stats.width)] - min;
-            }
-
-            // Half flux
-            HF = FSum / 2.0;
-
-            // Total flux starting from center
-            TF = buffer[cen_y * stats.width + cen_x] - min;
-
-            int pixelCounter = 1;
-
-            // Integrate flux along radius axis until we reach half flux
-            for (int k = 1; k < rCenter->width / 2; k++)
-            {
-                if (TF >= HF)
-                {
-                    qCDebug(KSTARS_FITS) << "Stopping at TF " << TF << " after #" << k << " pixels.";
-                    break;
-                }
-
-                TF += buffer[cen_y * stats.width + cen_x + k] - min;
-                TF += buffer[cen_y * stats.width + cen_x - k] - min;
+    qCDebug(KSTARS_FITS) << "Labelled " << m_Components.size() << " components from " << m_Runs.size() << " runs";
 
-                pixelCounter++;
-            }
+    int cen_limit = (MINIMUM_ROWS_PER_CENTER - (MINIMUM_STDVAR - initStdDev));
 
-            // Calculate weighted Half Flux Radius
-            rCenter->HFR = pixelCounter * (HF / TF);
-            // Store full flux
-            rCenter->val = FSum;
+    if (edgeCount < LOW_EDGE_CUTOFF_1)
+    {
+        if (edgeCount < LOW_EDGE_CUTOFF_2)
+            cen_limit = 1;
+        else
+            cen_limit = 2;
+    }
 
-            qCDebug(KSTARS_FITS) << "HFR for this center is " << rCenter->HFR << " pixels and the total flux is " << FSum;
+    for (Component const &component : m_Components)
+    {
+        if (cen_limit < 1 || component.edges < cen_limit || component.flux <= 0)
+            continue;
 
-            starCenters.append(rCenter);
-        }
+        double const x = component.sumX / component.flux;
+        double const y = component.sumY / component.flux;
+        double const xx = std::max(0.0, component.sumXX / component.flux - x * x);
+        double const yy = std::max(0.0, component.sumYY / component.flux - y * y);
+        double const xy = component.sumXY / component.flux - x * y;
+
+        // Axes of the ellipse of same second moments
+        double const variance = (xx + yy) / 2;
+        double const spread = std::sqrt((xx - yy) * (xx - yy) / 4 + xy * xy);
+        double const major = variance + spread;
+        double const minor = std::max(0.0, variance - spread);
+
+        auto * center = new Edge();
+        center->x = x + 0.5;
+        center->y = y + 0.5;
+        center->width = component.width;
+        center->val = component.peak;
+        center->sum = component.flux;
+        center->numPixels = component.pixels;
+        center->ellipticity = major > 0 ? 1 - std::sqrt(minor / major) : 0;
+        // Half flux radius of the Gaussian of same variance, less the variance of the sampling by pixels
+        center->HFR = std::sqrt(2 * std::log(2.0) * std::max(0.0, variance - 1.0 / 12));
+
+        starCenters.append(center);
     }
 
     if (starCenters.count() > 1 && m_Mode != FITS_FOCUS)
     {
-        float width_avg = (float)width_sum / starCenters.count();
-        float lsum = 0, sdev = 0;
-
-        for (auto &center : starCenters)
-            lsum += (center->width - width_avg) * (center->width - width_avg);
-
-        sdev = (std::sqrt(lsum / (starCenters.count() - 1))) * 4;
-
-        // Reject stars > 4 * stddev
-        foreach (Edge * center, starCenters)
-            if (center->width > sdev)
-                starCenters.removeOne(center);
+        // Reject sources wider than four times the root mean square width
+        double squares = 0;
+        for (Edge const * center : starCenters)
+            squares += center->width * center->width;
+        double const limit = std::sqrt(squares / (starCenters.count() - 1)) * 4;
 
-        //foreach(Edge *center, starCenters)
-        //qDebug() << Q_FUNC_INFO << center->x << "," << center->y << "," << center->width << "," << center->val << Qt::endl;
+        starCenters.erase(std::remove_if(starCenters.begin(), starCenters.end(), [limit](Edge * center)
+        {
+            if (center->width <= limit)
+                return false;
+            delete center;
+            return true;
+        }), starCenters.end());
     }
 
     m_ImageData->setStarCenters(starCenters);
-    // Release memory
-    qDeleteAll(edges);
-
     return true;
 }
-
-
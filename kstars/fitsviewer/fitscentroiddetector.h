@@ -14,6 +14,21 @@
 #include <QObject>
 #include "fitsstardetector.h"
 
+#include <vector>
+
+/**
+ * @class FITSCentroidDetector
+ * @short Detects stars as the connected components of the pixels above a threshold.
+ *
+ * The rows of each band of the frame are scanned in parallel into runs of pixels above threshold, and the runs
+ * overlapping in consecutive rows are joined with a union-find structure. The bands are then joined along their
+ * seams. The flux, centroid and second moments of each component are accumulated from its runs, so the detection
+ * is linear in the number of pixels and runs. The HFR is the one of a Gaussian with the second moments of the
+ * component.
+ *
+ * The runs wide and peaked enough are the "edges" of the former detector, which merged the edges colliding with
+ * each other. Their count drives the threshold search and the minimum size of a source as before.
+ */
 class FITSCentroidDetector: public FITSStarDetector
 {
         Q_OBJECT
@@ -27,6 +42,9 @@ class FITSCentroidDetector: public FITSStarDetector
          */
         QFuture<bool> findSources(QRect const &boundary = QRect()) override;
 
+        /** @see FITSStarDetector::reusedBuffers(). */
+        QVector<QPair<void const *, size_t>> reusedBuffers() const override;
+
         /** @brief Configure the detection method.
          * @see FITSStarDetector::configure().
          * @see Detection parameters.
@@ -44,8 +62,10 @@ class FITSCentroidDetector: public FITSStarDetector
         //double JMINDEX { 100 };
         /** @brief Initial source count over which search stops. */
         int MINIMUM_EDGE_LIMIT { 2 };
-        /** @brief Maximum source count over which search aborts. */
-        int MAX_EDGE_LIMIT { 10000 };
+        /** @brief Maximum source count over which search aborts, high as labelling is linear. */
+        int MAX_EDGE_LIMIT { 500000 };
+        /** @brief Minimum number of rows of the bands scanned in parallel. */
+        int MINIMUM_BAND_HEIGHT { 64 };
         /** @brief Minimum value of JMINDEX under which the custom image contrast index from the histogram is used to redefine edge width and count. */
         double DIFFUSE_THRESHOLD { 0.15 };
         /** @brief */
@@ -57,17 +77,83 @@ class FITSCentroidDetector: public FITSStarDetector
         /** @} */
 
     protected:
+        /** @internal Pixels above threshold and the runs qualifying as edges, at one level of the search. */
+        struct Level
+        {
+            double threshold { 0 };
+            /** @brief Value subtracted from the pixels compared to the threshold. */
+            double min { 0 };
+            /** @brief Sky level subtracted from the pixels weighting the moments. */
+            double sky { 0 };
+            float dispersionRatio { 1.5 };
+            int minEdgeWidth { 3 };
+        };
+
+        /** @internal Consecutive pixels above threshold in a row, a node of the union-find structure. */
+        struct Run
+        {
+            int y { 0 };
+            int x0 { 0 };
+            int x1 { 0 };
+            /** @brief Index of the parent run, of itself for a root. */
+            int parent { 0 };
+            bool edge { false };
+            int peak { 0 };
+            /** @brief Flux and its first and second moments along the row. */
+            double flux { 0 };
+            double sumX { 0 };
+            double sumXX { 0 };
+        };
+
+        /** @internal Rows scanned by one task. Its runs are indexed in the band, row after row. */
+        struct Band
+        {
+            int begin { 0 };
+            int end { 0 };
+            std::vector<Run> runs;
+            /** @brief End of the runs of the first row, and beginning of the runs of the last row. */
+            int firstRowEnd { 0 };
+            int lastRowBegin { 0 };
+            int edges { 0 };
+        };
+
+        /** @internal Sums over the runs of a connected component. */
+        struct Component
+        {
+            double flux { 0 };
+            double sumX { 0 };
+            double sumY { 0 };
+            double sumXX { 0 };
+            double sumYY { 0 };
+            double sumXY { 0 };
+            int peak { 0 };
+            int edges { 0 };
+            int width { 0 };
+            int pixels { 0 };
+        };
+
         /** @internal Find sources in the parent FITS data file, dependent of the pixel depth.
          * @see FITSGradientDetector::findSources.
          */
         template <typename T>
         bool findSources(const QRect &boundary);
 
-        /** @internal Check whether two sources overlap.
-         * @param s1, s2 are the two sources to check collision on.
-         * @return true if the sources collide, else false.
-         */
-        bool checkCollision(Edge * s1, Edge * s2) const;
+        /** @internal Scan the rows of a band into runs, and join the runs of consecutive rows. */
+        template <typename T>
+        void labelBand(Band &band, T const *buffer, int width, const QRect &area, const Level &level) const;
+
+        /** @internal Join the overlapping runs of two consecutive rows, in [a, aEnd) and [b, bEnd) of @p runs. */
+        static void joinRows(std::vector<Run> &runs, int a, int aEnd, int b, int bEnd);
+
+        /** @internal Root of the run at @p index, halving the path to it. */
+        static int root(std::vector<Run> &runs, int index);
+
+    private:
+        /** @internal Storage reused from one level of the search to the next. */
+        std::vector<Band> m_Bands;
+        std::vector<Run> m_Runs;
+        std::vector<int> m_Labels;
+        std::vector<Component> m_Components;
 };
 
 #endif // FITSCENTROIDDETECTOR_H
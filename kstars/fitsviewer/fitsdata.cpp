@@ -14,8 +14,6 @@
 #include "fitscentroiddetector.h"
 #include "fitssepdetector.h"
 
-#include "fpack.h"
-
 #include "kstarsdata.h"
 #include "ksutils.h"
 #include "kspaths.h"
@@ -38,6 +36,7 @@
 #include <libraw/libraw.h>
 #endif
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
@@ -85,7 +84,8 @@ FITSData::FITSData(const QSharedPointer<FITSData> &other)
     this->m_Mode = other->m_Mode;
     this->m_Statistics.channels = other->m_Statistics.channels;
     memcpy(&m_Statistics, &(other->m_Statistics), sizeof(m_Statistics));
-    m_ImageBuffer = new uint8_t[m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel];
+    m_ImageBuffer = FrameBufferPool::Instance()->acquire(m_Statistics.samples_per_channel * m_Statistics.channels *
+                    m_Statistics.bytesPerPixel);
     memcpy(m_ImageBuffer, other->m_ImageBuffer,
            m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel);
 }
@@ -120,10 +120,9 @@ FITSData::~FITSData()
     {
         fits_flush_file(fptr, &status);
         fits_close_file(fptr, &status);
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         fptr = nullptr;
     }
+    m_Loader.close();
 }
 
 void FITSData::loadCommon(const QString &inFilename)
@@ -136,14 +135,19 @@ void FITSData::loadCommon(const QString &inFilename)
     {
         fits_flush_file(fptr, &status);
         fits_close_file(fptr, &status);
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         fptr = nullptr;
     }
+    m_Loader.close();
 
     m_Filename = inFilename;
 }
 
+void FITSData::setReadRegion(const QRect &region, int maximumSize)
+{
+    m_ReadRegion = region;
+    m_ReadMaximumSize = maximumSize;
+}
+
 bool FITSData::loadFromBuffer(const QByteArray &buffer, const QString &extension, const QString &inFilename)
 {
     loadCommon(inFilename);
@@ -189,125 +193,54 @@ bool FITSData::privateLoad(const QByteArray &buffer, const QString &extension)
     return false;
 }
 
-bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension, const bool isCompressed)
+bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension)
 {
-    int status = 0, anynull = 0;
+    Q_UNUSED(extension)
+    int status = 0;
     long naxes[3];
 
     m_HistogramConstructed = false;
 
-    if (extension.contains(".fz") || isCompressed)
+    // Files are mapped rather than read, compressed images are decompressed when their pixels are read
+    if (!(buffer.isEmpty() ? m_Loader.open(m_Filename) : m_Loader.open(buffer)))
     {
-        fpstate fpvar;
-        fp_init (&fpvar);
-        bool rc = false;
-
-        if (buffer.isEmpty())
-        {
-            // Store so we don't lose.
-            m_compressedFilename = m_Filename;
-
-            QString uncompressedFile = QDir::tempPath() + QString("/%1").arg(QUuid::createUuid().toString().remove(
-                                           QRegularExpression("[-{}]")));
-
-            rc = fp_unpack_file_to_fits(m_Filename.toLocal8Bit().data(), &fptr, fpvar) < 0;
-            if (rc)
-            {
-                m_Filename = uncompressedFile;
-            }
-        }
-        else
-        {
-            size_t m_PackBufferSize = 100000;
-            free(m_PackBuffer);
-            m_PackBuffer = (uint8_t *)malloc(m_PackBufferSize);
-            rc = fp_unpack_data_to_data(buffer.data(), buffer.size(), &m_PackBuffer, &m_PackBufferSize, fpvar) == 0;
-
-            if (rc)
-            {
-                void *data = reinterpret_cast<void *>(m_PackBuffer);
-                if (fits_open_memfile(&fptr, m_Filename.toLocal8Bit().data(), READONLY, &data, &m_PackBufferSize, 0,
-                                      nullptr, &status))
-                {
-                    m_LastError = i18n("Error reading fits buffer: %1.", fitsErrorToString(status));
-                    return false;
-                }
-
-                m_Statistics.size = m_PackBufferSize;
-            }
-            //rc = fp_unpack_data_to_fits(buffer.data(), buffer.size(), &fptr, fpvar) == 0;
-        }
-
-        if (rc == false)
-        {
-            free(m_PackBuffer);
-            m_PackBuffer = nullptr;
-            m_LastError = i18n("Failed to unpack compressed fits");
-            qCCritical(KSTARS_FITS) << m_LastError;
-            return false;
-        }
+        m_LastError = i18n("Error opening fits file %1 : %2", m_Filename, m_Loader.lastError());
+        return false;
+    }
 
-        m_isTemporary = true;
-        m_isCompressed = true;
-        m_Statistics.size = fptr->Fptr->logfilesize;
+    m_Statistics.size = m_Loader.size();
 
-    }
-    else if (buffer.isEmpty())
+    fptr = m_Loader.openImage(&status);
+    if (fptr == nullptr)
     {
-        // Use open diskfile as it does not use extended file names which has problems opening
-        // files with [ ] or ( ) in their names.
-        if (fits_open_diskfile(&fptr, m_Filename.toLocal8Bit(), READONLY, &status))
-        {
-            m_LastError = i18n("Error opening fits file %1 : %2", m_Filename, fitsErrorToString(status));
-        }
-
-        m_Statistics.size = QFile(m_Filename).size();
+        m_LastError = i18n("Could not locate image HDU: %1", fitsErrorToString(status));
+        return false;
     }
-    else
+
+    if (m_Loader.isCompressed())
     {
-        // Read the FITS file from a memory buffer.
-        void *temp_buffer = const_cast<void *>(reinterpret_cast<const void *>(buffer.data()));
-        size_t temp_size = buffer.size();
-        if (fits_open_memfile(&fptr, m_Filename.toLocal8Bit().data(), READONLY,
-                              &temp_buffer, &temp_size, 0, nullptr, &status))
+        // Store so we don't lose.
+        if (buffer.isEmpty())
         {
-            m_LastError = i18n("Error reading fits buffer: %1", fitsErrorToString(status));
-            return false;
+            m_compressedFilename = m_Filename;
+            m_Filename = QDir::tempPath() + QString("/%1").arg(QUuid::createUuid().toString().remove(
+                             QRegularExpression("[-{}]")));
         }
 
-        m_Statistics.size = temp_size;
-    }
-
-    if (fits_movabs_hdu(fptr, 1, IMAGE_HDU, &status))
-    {
-
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
-        m_LastError = i18n("Could not locate image HDU: %1", fitsErrorToString(status));
+        m_isTemporary = true;
+        m_isCompressed = true;
     }
 
     if (fits_get_img_param(fptr, 3, &m_FITSBITPIX, &(m_Statistics.ndim), naxes, &status))
     {
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         m_LastError = i18n("FITS file open error (fits_get_img_param): %1", fitsErrorToString(status));
         return false;
     }
 
-    // Reload if it is transparently compressed.
-    if ((fits_is_compressed_image(fptr, &status) || m_Statistics.ndim <= 0) && !isCompressed)
-    {
-        loadCommon(m_Filename);
-        qCDebug(KSTARS_FITS) << "Image is compressed. Reloading...";
-        return loadFITSImage(buffer, extension, true);
-    }
-
     if (m_Statistics.ndim < 2)
     {
         m_LastError = i18n("1D FITS images are not supported in KStars.");
         qCCritical(KSTARS_FITS) << m_LastError;
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         return false;
     }
 
@@ -362,13 +295,41 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
     {
         m_LastError = i18n("Image has invalid dimensions %1x%2", naxes[0], naxes[1]);
         qCCritical(KSTARS_FITS) << m_LastError;
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         return false;
     }
 
-    m_Statistics.width               = naxes[0];
-    m_Statistics.height              = naxes[1];
+    // Part of the image to read, and one pixel out of how many along each axis
+    QRect area(0, 0, naxes[0], naxes[1]);
+    int sampling = 1;
+    if (!m_ReadRegion.isNull())
+    {
+        // Start on even pixels, so that the Bayer pattern is kept
+        QRect region = m_ReadRegion;
+        region.setLeft(region.left() & ~1);
+        region.setTop(region.top() & ~1);
+        area = region.intersected(area);
+        if (area.isEmpty())
+        {
+            m_LastError = i18n("Region %1x%2 at %3,%4 is outside of the image", m_ReadRegion.width(),
+                               m_ReadRegion.height(), m_ReadRegion.left(), m_ReadRegion.top());
+            qCCritical(KSTARS_FITS) << m_LastError;
+            return false;
+        }
+    }
+    if (m_ReadMaximumSize > 0)
+    {
+        int const largest = std::max(area.width(), area.height());
+        sampling = (largest + m_ReadMaximumSize - 1) / m_ReadMaximumSize;
+        // Odd, so that the Bayer pattern is kept
+        if (sampling % 2 == 0)
+            sampling++;
+    }
+    QSize const size = FITSLoader::regionSize(area, sampling);
+    m_ReadArea = area;
+    m_ReadSampling = sampling;
+
+    m_Statistics.width               = size.width();
+    m_Statistics.height              = size.height();
     m_Statistics.samples_per_channel = m_Statistics.width * m_Statistics.height;
     roiCenter.setX(m_Statistics.width / 2);
     roiCenter.setY(m_Statistics.height / 2);
@@ -387,25 +348,24 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
         m_Statistics.channels = 1;
 
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
+    m_ImageBuffer = FrameBufferPool::Instance()->acquire(m_ImageBufferSize);
     if (m_ImageBuffer == nullptr)
     {
         qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
                                << m_ImageBufferSize << " bytes.";
         clearImageBuffers();
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
         return false;
     }
 
     rotCounter     = 0;
     flipHCounter   = 0;
     flipVCounter   = 0;
-    long nelements = m_Statistics.samples_per_channel * m_Statistics.channels;
 
-    if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
+    // Bands of lines are read and decompressed across threads
+    if (!m_Loader.read(m_Statistics.dataType, m_Statistics.bytesPerPixel, m_Statistics.channels, m_ImageBuffer, area,
+                       sampling))
     {
-        m_LastError = i18n("Error reading image: %1", fitsErrorToString(status));
+        m_LastError = i18n("Error reading image: %1", m_Loader.lastError());
         return false;
     }
 
@@ -525,7 +485,7 @@ bool FITSData::loadCanonicalImage(const QByteArray &buffer, const QString &exten
     clearImageBuffers();
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * static_cast<uint16_t>
                         (m_Statistics.bytesPerPixel);
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
+    m_ImageBuffer = FrameBufferPool::Instance()->acquire(m_ImageBufferSize);
     if (m_ImageBuffer == nullptr)
     {
         m_LastError = i18n("FITSData: Not enough memory for image_buffer channel. Requested: %1 bytes ", m_ImageBufferSize);
@@ -536,7 +496,9 @@ bool FITSData::loadCanonicalImage(const QByteArray &buffer, const QString &exten
 
     if (m_Statistics.channels == 1)
     {
-        memcpy(m_ImageBuffer, imageFromFile.bits(), m_ImageBufferSize);
+        // QImage pads its lines to 32 bits, the buffer does not
+        for (int y = 0; y < m_Statistics.height; y++)
+            memcpy(m_ImageBuffer + y * m_Statistics.width, imageFromFile.constScanLine(y), m_Statistics.width);
     }
     else
     {
@@ -640,7 +602,7 @@ bool FITSData::loadRAWImage(const QByteArray &buffer, const QString &extension)
     m_Statistics.samples_per_channel = m_Statistics.width * m_Statistics.height;
     clearImageBuffers();
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
+    m_ImageBuffer = FrameBufferPool::Instance()->acquire(m_ImageBufferSize);
     if (m_ImageBuffer == nullptr)
     {
         m_LastError = i18n("FITSData: Not enough memory for image_buffer channel. Requested: %1 bytes ", m_ImageBufferSize);
@@ -816,6 +778,7 @@ bool FITSData::saveImage(const QString &newFilename)
         m_LastError = i18n("Failed to close file: %1", fitsErrorToString(status));
         return false;
     }
+    m_Loader.close();
 
     /* Create a new File, overwriting existing*/
     if (fits_create_file(&new_fptr, QString("!%1").arg(newFilename).toLocal8Bit(), &status))
@@ -986,49 +949,31 @@ bool FITSData::saveImage(const QString &newFilename)
 
 void FITSData::clearImageBuffers()
 {
-    delete[] m_ImageBuffer;
+    FrameBufferPool::Instance()->release(m_ImageBuffer);
     m_ImageBuffer = nullptr;
-    if(m_ImageRoiBuffer != nullptr )
-    {
-        delete[] m_ImageRoiBuffer;
-        m_ImageRoiBuffer = nullptr;
-
-    }
+    m_ROIView = FITSImageView();
     //m_BayerBuffer = nullptr;
 }
 
-void FITSData::makeRoiBuffer(QRect roi)
+FITSImageView FITSData::getImageView() const
 {
-    uint32_t channelSize = roi.height() * roi.width();
-    if(channelSize  > m_Statistics.samples_per_channel || channelSize == 1)
-    {
+    return FITSImageView(m_ImageBuffer, m_Statistics.dataType, m_Statistics.bytesPerPixel, m_Statistics.width,
+                         m_Statistics.height, m_Statistics.channels, m_Statistics.width,
+                         m_Statistics.samples_per_channel);
+}
+
+void FITSData::calculateRoiStats(QRect roi)
+{
+    // The selection is read in place, its samples are numbered as in a buffer holding it only
+    const FITSImageView view = getImageView().sub(roi.translated(-1, -1));
+    if (view.samplesPerChannel() <= 1)
         return;
-    }
-    if(m_ImageRoiBuffer != nullptr )
-    {
-        delete[] m_ImageRoiBuffer;
-        m_ImageRoiBuffer = nullptr;
-    }
-    int xoffset = roi.topLeft().x() - 1;
-    int yoffset = roi.topLeft().y() - 1;
-    uint32_t bpp = m_Statistics.bytesPerPixel;
-    m_ImageRoiBuffer = new uint8_t[roi.height()*roi.width()*m_Statistics.channels * m_Statistics.bytesPerPixel]();
-    for(int n = 0 ; n < m_Statistics.channels ; n++)
-    {
-        for(int i = 0; i < roi.height(); i++)
-        {
-            size_t i1 = n * channelSize * bpp +  i * roi.width() * bpp;
-            size_t i2 = n * m_Statistics.samples_per_channel * bpp + (yoffset + i) * width() * bpp + xoffset * bpp;
-            memcpy(&m_ImageRoiBuffer[i1],
-                   &m_ImageBuffer[i2],
-                   roi.width() * bpp);
-        }
 
-    }
+    m_ROIView = view;
     memcpy(&m_ROIStatistics, &m_Statistics, sizeof(FITSImage::Statistic));
-    m_ROIStatistics.samples_per_channel = roi.height() * roi.width();
-    m_ROIStatistics.width = roi.width();
-    m_ROIStatistics.height = roi.height();
+    m_ROIStatistics.samples_per_channel = view.samplesPerChannel();
+    m_ROIStatistics.width = view.width();
+    m_ROIStatistics.height = view.height();
     calculateStats(false, true);
 }
 void FITSData::calculateStats(bool refresh, bool roi)
@@ -1404,26 +1349,32 @@ void FITSData::calculateMedian(bool refresh, bool roi)
 template <typename T>
 void FITSData::calculateMedian(bool roi)
 {
-    auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
+    const FITSImageView view = roi ? m_ROIView : getImageView();
+    const uint32_t channelSize = roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel;
     const uint32_t maxMedianSize = 500000;
-    uint32_t medianSize = roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel;
     uint8_t downsample = 1;
-    if (medianSize > maxMedianSize)
-    {
-        downsample = (static_cast<double>(medianSize) / maxMedianSize) + 0.999;
-        medianSize /= downsample;
-    }
-    std::vector<T> samples;
-    samples.reserve(medianSize);
+    if (channelSize > maxMedianSize)
+        downsample = (static_cast<double>(channelSize) / maxMedianSize) + 0.999;
+
+    // The buffer of the samples of a selection is kept for the next selections
+    FrameBuffer imageSamples;
+    FrameBuffer &buffer = roi ? m_ROISamples : imageSamples;
+    buffer.allocate(m_Statistics.channels * ((channelSize + downsample - 1) / downsample) * sizeof(T));
+    T * const samples = reinterpret_cast<T *>(buffer.data());
+    uint32_t size = 0;
 
     for (uint8_t n = 0; n < m_Statistics.channels; n++)
     {
-        auto *oneChannel = buffer + n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-        for (uint32_t upto = 0; upto < (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-                upto += downsample)
-            samples.push_back(oneChannel[upto]);
-        const uint32_t middle = samples.size() / 2;
-        std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+        // Sample of the channel to pick next, and first sample of the current span
+        uint32_t upto = 0, spanStart = 0;
+        view.forEachSpan<T>(n * channelSize, channelSize, [&](T const * span, size_t count)
+        {
+            for (; upto < spanStart + count; upto += downsample)
+                samples[size++] = span[upto - spanStart];
+            spanStart += count;
+        });
+        const uint32_t middle = size / 2;
+        std::nth_element(samples, samples + middle, samples + size);
         roi ? m_ROIStatistics.median[n] = samples[middle] : m_Statistics.median[n] = samples[middle];
     }
 }
@@ -1431,21 +1382,17 @@ void FITSData::calculateMedian(bool roi)
 template <typename T>
 QPair<T, T> FITSData::getParitionMinMax(uint32_t start, uint32_t stride, bool roi)
 {
-    auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
     T min = std::numeric_limits<T>::max();
     T max = std::numeric_limits<T>::min();
 
-    uint32_t end = start + stride;
-
-    for (uint32_t i = start; i < end; i++)
+    (roi ? m_ROIView : getImageView()).forEachSpan<T>(start, stride, [&](T const * buffer, size_t count)
     {
-        min = qMin(buffer[i], min);
-        max = qMax(buffer[i], max);
-        //        if (buffer[i] < min)
-        //            min = buffer[i];
-        //        else if (buffer[i] > max)
-        //            max = buffer[i];
-    }
+        for (size_t i = 0; i < count; i++)
+        {
+            min = qMin(buffer[i], min);
+            max = qMax(buffer[i], max);
+        }
+    });
 
     return qMakePair(min, max);
 }
@@ -1508,82 +1455,115 @@ void FITSData::calculateMinMax(bool roi)
 }
 
 template <typename T>
-QPair<double, double> FITSData::getSquaredSumAndMean(uint32_t start, uint32_t stride, bool roi)
+QPair<double, double> FITSData::getSquaredSumAndMean(const FITSImageView &view, uint32_t start, uint32_t stride)
 {
     uint32_t m_n       = 2;
     double m_oldM = 0, m_newM = 0, m_oldS = 0, m_newS = 0;
 
-    auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
-    uint32_t end = start + stride;
-
-    for (uint32_t i = start; i < end; i++)
+    view.forEachSpan<T>(start, stride, [&](T const * buffer, size_t count)
     {
-        m_newM = m_oldM + (buffer[i] - m_oldM) / m_n;
-        m_newS = m_oldS + (buffer[i] - m_oldM) * (buffer[i] - m_newM);
+        for (size_t i = 0; i < count; i++)
+        {
+            m_newM = m_oldM + (buffer[i] - m_oldM) / m_n;
+            m_newS = m_oldS + (buffer[i] - m_oldM) * (buffer[i] - m_newM);
 
-        m_oldM = m_newM;
-        m_oldS = m_newS;
-        m_n++;
-    }
+            m_oldM = m_newM;
+            m_oldS = m_newS;
+            m_n++;
+        }
+    });
 
     return qMakePair<double, double>(m_newM, m_newS);
 }
 
 template <typename T>
-void FITSData::runningAverageStdDev(bool roi )
+QPair<double, double> FITSData::runningAverageStdDev(const FITSImageView &view, int channel)
 {
     // Create N threads
     const uint8_t nThreads = 16;
 
-    for (int n = 0; n < m_Statistics.channels; n++)
-    {
-        uint32_t cStart = n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
+    uint32_t const samples = view.samplesPerChannel();
+    uint32_t cStart = channel * samples;
 
-        // Calculate how many elements we process per thread
-        uint32_t tStride = (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) / nThreads;
+    // Calculate how many elements we process per thread
+    uint32_t tStride = samples / nThreads;
 
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + ((roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) -
-                                      (tStride * nThreads));
+    // Calculate the final stride since we can have some left over due to division above
+    uint32_t fStride = tStride + (samples - (tStride * nThreads));
 
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
+    // Start location for inspecting elements
+    uint32_t tStart = cStart;
 
-        // List of futures
-        QList<QFuture<QPair<double, double>>> futures;
+    // List of futures
+    QList<QFuture<QPair<double, double>>> futures;
 
-        for (int i = 0; i < nThreads; i++)
-        {
-            // Run threads
-            futures.append(QtConcurrent::run(this, &FITSData::getSquaredSumAndMean<T>, tStart,
-                                             (i == (nThreads - 1)) ? fStride : tStride, roi));
-            tStart += tStride;
-        }
+    for (int i = 0; i < nThreads; i++)
+    {
+        // Run threads
+        futures.append(QtConcurrent::run(&FITSData::getSquaredSumAndMean<T>, view, tStart,
+                                         (i == (nThreads - 1)) ? fStride : tStride));
+        tStart += tStride;
+    }
 
-        double mean = 0, squared_sum = 0;
+    double mean = 0, squared_sum = 0;
 
-        // Now wait for results
-        for (int i = 0; i < nThreads; i++)
-        {
-            QPair<double, double> result = futures[i].result();
-            mean += result.first;
-            squared_sum += result.second;
-        }
+    // Now wait for results
+    for (int i = 0; i < nThreads; i++)
+    {
+        QPair<double, double> result = futures[i].result();
+        mean += result.first;
+        squared_sum += result.second;
+    }
+
+    return qMakePair(mean / nThreads, sqrt(squared_sum / samples));
+}
+
+template <typename T>
+void FITSData::runningAverageStdDev(bool roi )
+{
+    const FITSImageView view = roi ? m_ROIView : getImageView();
 
-        double variance = squared_sum / (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
+    for (int n = 0; n < m_Statistics.channels; n++)
+    {
+        QPair<double, double> const result = runningAverageStdDev<T>(view, n);
         if(!roi)
         {
-            m_Statistics.mean[n]   = mean / nThreads;
-            m_Statistics.stddev[n] = sqrt(variance);
+            m_Statistics.mean[n]   = result.first;
+            m_Statistics.stddev[n] = result.second;
         }
         else
         {
-            m_ROIStatistics.mean[n] = mean / nThreads;
-            m_ROIStatistics.stddev[n] = sqrt(variance);
+            m_ROIStatistics.mean[n] = result.first;
+            m_ROIStatistics.stddev[n] = result.second;
         }
     }
 }
 
+QPair<double, double> FITSData::getMeanStdDev(const FITSImageView &view, int channel)
+{
+    switch (view.dataType())
+    {
+        case TBYTE:
+            return runningAverageStdDev<uint8_t>(view, channel);
+        case TSHORT:
+            return runningAverageStdDev<int16_t>(view, channel);
+        case TUSHORT:
+            return runningAverageStdDev<uint16_t>(view, channel);
+        case TLONG:
+            return runningAverageStdDev<int32_t>(view, channel);
+        case TULONG:
+            return runningAverageStdDev<uint32_t>(view, channel);
+        case TFLOAT:
+            return runningAverageStdDev<float>(view, channel);
+        case TLONGLONG:
+            return runningAverageStdDev<int64_t>(view, channel);
+        case TDOUBLE:
+            return runningAverageStdDev<double>(view, channel);
+        default:
+            return qMakePair(0.0, 0.0);
+    }
+}
+
 QVector<double> FITSData::createGaussianKernel(int size, double sigma)
 {
     QVector<double> kernel(size * size);
@@ -1689,7 +1669,7 @@ bool FITSData::parseHeader()
     char * header = nullptr;
     int status = 0, nkeys = 0;
 
-    if (fits_hdr2str(fptr, 0, nullptr, 0, &header, &nkeys, &status))
+    if (fits_convert_hdr2str(fptr, 0, nullptr, 0, &header, &nkeys, &status))
     {
         fits_report_error(stderr, status);
         free(header);
@@ -1867,7 +1847,12 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
     qDeleteAll(starCenters);
     starCenters.clear();
     starsSearched = true;
+    // The HFR of the previous stars must not be served for the new ones
+    cacheHFR = -1;
+    cacheEccentricity = -1;
 
+    // The detectors other than SEP are kept while the algorithm does not change, so that the buffers
+    // they use for a frame are reused for the next ones
     switch (algorithm)
     {
         case ALGORITHM_SEP:
@@ -1892,7 +1877,8 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
         case ALGORITHM_GRADIENT:
         default:
         {
-            m_StarDetector.reset(new FITSGradientDetector(this));
+            if (qobject_cast<FITSGradientDetector *>(m_StarDetector.data()) == nullptr)
+                m_StarDetector.reset(new FITSGradientDetector(this));
             m_StarDetector->setSettings(m_SourceExtractorSettings);
             m_StarFindFuture = m_StarDetector->findSources(trackingBox);
             return m_StarFindFuture;
@@ -1901,7 +1887,8 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
         case ALGORITHM_CENTROID:
         {
 #ifndef KSTARS_LITE
-            m_StarDetector.reset(new FITSCentroidDetector(this));
+            if (qobject_cast<FITSCentroidDetector *>(m_StarDetector.data()) == nullptr)
+                m_StarDetector.reset(new FITSCentroidDetector(this));
             m_StarDetector->setSettings(m_SourceExtractorSettings);
             // We need JMIndex calculated from histogram
             if (!isHistogramConstructed())
@@ -1920,7 +1907,8 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
 
         case ALGORITHM_THRESHOLD:
         {
-            m_StarDetector.reset(new FITSThresholdDetector(this));
+            if (qobject_cast<FITSThresholdDetector *>(m_StarDetector.data()) == nullptr)
+                m_StarDetector.reset(new FITSThresholdDetector(this));
             m_StarDetector->setSettings(m_SourceExtractorSettings);
             m_StarDetector->configure("THRESHOLD_PERCENTAGE", Options::focusThreshold());
             m_StarFindFuture =  m_StarDetector->findSources(trackingBox);
@@ -1929,7 +1917,8 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
 
         case ALGORITHM_BAHTINOV:
         {
-            m_StarDetector.reset(new FITSBahtinovDetector(this));
+            if (qobject_cast<FITSBahtinovDetector *>(m_StarDetector.data()) == nullptr)
+                m_StarDetector.reset(new FITSBahtinovDetector(this));
             m_StarDetector->setSettings(m_SourceExtractorSettings);
             m_StarDetector->configure("NUMBER_OF_AVERAGE_ROWS", Options::focusMultiRowAverage());
             m_StarFindFuture = m_StarDetector->findSources(trackingBox);
@@ -2432,10 +2421,8 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
         case FITS_MEDIAN:
         {
             uint8_t BBP      = m_Statistics.bytesPerPixel;
-            auto * extension = new T[(width + 2) * (height + 2)];
-            //   Check memory allocation
-            if (!extension)
-                return;
+            FrameBuffer extensionBuffer((width + 2) * (height + 2) * sizeof(T));
+            auto * extension = extensionBuffer.data<T>();
             //   Create image extension
             for (uint32_t ch = 0; ch < m_Statistics.channels; ch++)
             {
@@ -2487,9 +2474,6 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
                     }
             }
 
-            //   Free memory
-            delete[] extension;
-
             if (calcStats)
                 runningAverageStdDev<T>();
         }
@@ -2557,8 +2541,10 @@ bool FITSData::checkForWCS()
         m_WCSHandle = nullptr;
         m_nwcs = 0;
     }
+    m_WCSGridSampled = false;
+    m_WCSBoundsFound = false;
 
-    if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
+    if (fits_convert_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
         char errmsg[512];
         fits_get_errstatus(status, errmsg);
@@ -2596,6 +2582,14 @@ bool FITSData::checkForWCS()
         return false;
     }
 
+    if (!mapWCSToReadArea())
+    {
+        wcsvfree(&m_nwcs, &m_WCSHandle);
+        m_WCSHandle = nullptr;
+        m_nwcs = 0;
+        return false;
+    }
+
     cdfix(m_WCSHandle);
     if ((status = wcsset(m_WCSHandle)) != 0)
     {
@@ -2612,6 +2606,48 @@ bool FITSData::checkForWCS()
     return HasWCS;
 }
 
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+bool FITSData::mapWCSToReadArea()
+{
+    // The header describes the whole image, while the buffer holds one pixel out of m_ReadSampling of m_ReadArea.
+    // Pixel p of the buffer is pixel m_ReadArea.left() + 1 + (p - 1) * m_ReadSampling of the image, 1-based.
+    QRect const image(0, 0, m_Loader.width(), m_Loader.height());
+    if (image.isEmpty() || (m_ReadSampling <= 1 && m_ReadArea == image))
+        return true;
+
+    // Distortion polynomials are expressed in the pixels of the whole image, do not guess their mapping
+    for (int i = 0; i < m_nwcs; i++)
+    {
+        if (m_WCSHandle[i].lin.dispre != nullptr || m_WCSHandle[i].lin.disseq != nullptr)
+        {
+            m_LastError = i18n("World coordinates with distortions are not available for part of an image.");
+            return false;
+        }
+    }
+
+    double const sampling = m_ReadSampling;
+    double const origin[2] = { static_cast<double>(m_ReadArea.left()), static_cast<double>(m_ReadArea.top()) };
+    for (int i = 0; i < m_nwcs; i++)
+    {
+        struct wcsprm &wcs = m_WCSHandle[i];
+        int const axes = std::min(wcs.naxis, 2);
+        for (int j = 0; j < axes; j++)
+        {
+            wcs.crpix[j] = (wcs.crpix[j] - origin[j] - 1) / sampling + 1;
+            wcs.cdelt[j] *= sampling;
+        }
+        // The CD matrix replaces CDELT when present, scale its columns of the pixel axes as well
+        if (wcs.altlin & 2)
+        {
+            for (int row = 0; row < wcs.naxis; row++)
+                for (int j = 0; j < axes; j++)
+                    wcs.cd[row * wcs.naxis + j] *= sampling;
+        }
+    }
+    return true;
+}
+#endif
+
 bool FITSData::loadWCS(bool extras)
 {
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
@@ -2628,6 +2664,8 @@ bool FITSData::loadWCS(bool extras)
         m_nwcs = 0;
         m_WCSHandle = nullptr;
     }
+    m_WCSGridSampled = false;
+    m_WCSBoundsFound = false;
 
     qCDebug(KSTARS_FITS) << "Started WCS Data Processing...";
 
@@ -2635,7 +2673,7 @@ bool FITSData::loadWCS(bool extras)
     char * header = nullptr;
     int nkeyrec = 0, nreject = 0;
 
-    if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
+    if (fits_convert_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
         char errmsg[512];
         fits_get_errstatus(status, errmsg);
@@ -2676,6 +2714,15 @@ bool FITSData::loadWCS(bool extras)
         return false;
     }
 
+    if (!mapWCSToReadArea())
+    {
+        wcsvfree(&m_nwcs, &m_WCSHandle);
+        m_WCSHandle = nullptr;
+        m_nwcs = 0;
+        m_WCSState = Failure;
+        return false;
+    }
+
     cdfix(m_WCSHandle);
     if ((status = wcsset(m_WCSHandle)) != 0)
     {
@@ -2736,6 +2783,52 @@ bool FITSData::wcsToPixel(const SkyPoint &wcsCoord, QPointF &wcsPixelPoint, QPoi
 #endif
 }
 
+bool FITSData::wcsToPixels(const QVector<QPointF> &coords, QVector<QPointF> &pixels)
+{
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+    if (m_WCSHandle == nullptr)
+    {
+        m_LastError = i18n("No world coordinate systems found.");
+        return false;
+    }
+
+    const WCSGrid *grid = wcsGrid();
+    if (grid == nullptr)
+    {
+        WCSGrid::worldToPixel(m_WCSHandle, coords, pixels);
+        return true;
+    }
+
+    grid->worldToPixel(coords, pixels);
+
+    // Away from the frame the grid extrapolates, and far from it cannot project, convert these points exactly
+    QVector<int> outside;
+    QVector<QPointF> outsideCoords;
+    for (int i = 0; i < pixels.size(); i++)
+    {
+        if (!grid->covers(pixels[i]))
+        {
+            outside.append(i);
+            outsideCoords.append(coords[i]);
+        }
+    }
+
+    if (!outside.isEmpty())
+    {
+        QVector<QPointF> outsidePixels;
+        WCSGrid::worldToPixel(m_WCSHandle, outsideCoords, outsidePixels);
+        for (int i = 0; i < outside.size(); i++)
+            pixels[outside[i]] = outsidePixels[i];
+    }
+
+    return true;
+#else
+    Q_UNUSED(coords);
+    pixels.clear();
+    return false;
+#endif
+}
+
 bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
 {
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
@@ -2795,39 +2888,48 @@ bool FITSData::findWCSBounds(double &minRA, double &maxRA, double &minDec, doubl
         return false;
     }
 
+    // The bounds are requested on each paint of the grid overlay
+    if (m_WCSBoundsFound)
+    {
+        minRA = m_WCSBounds[0];
+        maxRA = m_WCSBounds[1];
+        minDec = m_WCSBounds[2];
+        maxDec = m_WCSBounds[3];
+        return true;
+    }
+
     maxRA  = -1000;
     minRA  = 1000;
     maxDec = -1000;
     minDec = 1000;
 
-    auto updateMinMax = [&](int x, int y)
-    {
-        int stat[2];
-        double imgcrd[2], phi, pixcrd[2], theta, world[2];
-
-        pixcrd[0] = x;
-        pixcrd[1] = y;
-
-        if (wcsp2s(m_WCSHandle, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0]))
-            return;
-
-        minRA = std::min(minRA, world[0]);
-        maxRA = std::max(maxRA, world[0]);
-        minDec = std::min(minDec, world[1]);
-        maxDec = std::max(maxDec, world[1]);
-    };
-
     // Find min and max values from edges
+    QVector<QPointF> edges;
+    edges.reserve(2 * (width() + height()));
     for (int y = 0; y < height(); y++)
     {
-        updateMinMax(0, y);
-        updateMinMax(width() - 1, y);
+        edges.append(QPointF(0, y));
+        edges.append(QPointF(width() - 1, y));
     }
 
     for (int x = 1; x < width() - 1; x++)
     {
-        updateMinMax(x, 0);
-        updateMinMax(x, height() - 1);
+        edges.append(QPointF(x, 0));
+        edges.append(QPointF(x, height() - 1));
+    }
+
+    QVector<QPointF> world;
+    WCSGrid::pixelToWorld(m_WCSHandle, edges, world);
+    for (const auto &point : world)
+    {
+        // Points that could not be converted are NaN
+        if (std::isnan(point.x()) || std::isnan(point.y()))
+            continue;
+
+        minRA = std::min(minRA, point.x());
+        maxRA = std::max(maxRA, point.x());
+        minDec = std::min(minDec, point.y());
+        maxDec = std::max(maxDec, point.y());
     }
 
     // Check if either pole is in the image
@@ -2848,8 +2950,33 @@ bool FITSData::findWCSBounds(double &minRA, double &maxRA, double &minDec, doubl
             minDec = -90;
         }
     }
+
+    m_WCSBounds[0] = minRA;
+    m_WCSBounds[1] = maxRA;
+    m_WCSBounds[2] = minDec;
+    m_WCSBounds[3] = maxDec;
+    m_WCSBoundsFound = true;
     return true;
 }
+
+const WCSGrid *FITSData::wcsGrid()
+{
+    if (m_WCSHandle == nullptr)
+        return nullptr;
+
+    if (!m_WCSGridSampled)
+    {
+        m_WCSGridSampled = true;
+        if (m_WCSGrid.build(m_WCSHandle, width(), height()))
+            qCDebug(KSTARS_FITS) << "WCS interpolated every" << m_WCSGrid.step() << "pixels, within"
+                                 << m_WCSGrid.maximumError() << "pixels";
+        else
+            qCDebug(KSTARS_FITS) << "WCS cannot be interpolated within" << WCSGrid::DEFAULT_TOLERANCE
+                                 << "pixels, converting exactly";
+    }
+
+    return m_WCSGrid.isValid() ? &m_WCSGrid : nullptr;
+}
 #endif
 
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
@@ -2894,21 +3021,24 @@ bool FITSData::findObjectsInImage(SkyPoint startPoint, SkyPoint endPoint)
                 type == SkyObject::SATELLITE);
     }), list.end());
 
-    double world[2], phi, theta, imgcrd[2], pixcrd[2];
-    int stat[2];
+    QVector<QPointF> coords;
+    coords.reserve(list.size());
     for (auto &object : list)
+        coords.append(QPointF(object->ra0().Degrees(), object->dec0().Degrees()));
+
+    QVector<QPointF> pixels;
+    wcsToPixels(coords, pixels);
+    for (int i = 0; i < list.size(); i++)
     {
-        world[0] = object->ra0().Degrees();
-        world[1] = object->dec0().Degrees();
+        // Objects that could not be projected are NaN
+        if (!std::isfinite(pixels[i].x()) || !std::isfinite(pixels[i].y()))
+            continue;
 
-        if (wcss2p(m_WCSHandle, 1, 2, &world[0], &phi, &theta, &imgcrd[0], &pixcrd[0], &stat[0]) == 0)
-        {
-            //The X and Y are set to the found position if it does work.
-            int x = pixcrd[0];
-            int y = pixcrd[1];
-            if (x > 0 && y > 0 && x < w && y < h)
-                m_SkyObjects.append(new FITSSkyObject(object, x, y));
-        }
+        //The X and Y are set to the found position if it does work.
+        int x = pixels[i].x();
+        int y = pixels[i].y();
+        if (x > 0 && y > 0 && x < w && y < h)
+            m_SkyObjects.append(new FITSSkyObject(list[i], x, y));
     }
 
     delete (num);
@@ -2946,19 +3076,85 @@ void FITSData::setRotCounter(int value)
     rotCounter = value;
 }
 
+namespace
+{
+// Side of the square tiles transposed at once, so that a tile of the source and of the target stay in cache
+constexpr int TRANSPOSE_TILE_SIZE = 64;
+// Lines mirrored by each task
+constexpr int MIRROR_LINES_PER_TASK = 16;
+
+/* Copy the width x height pixels of source into target transposed, then mirrored horizontally and/or vertically.
+ * The target is height pixels wide. Bands of tiles of the source are spread across the global thread pool, each
+ * band writing its own columns of the target.
+ */
+template <typename T>
+void transposeTiles(T const * source, T * target, int width, int height, bool mirrorX, bool mirrorY)
+{
+    QVector<int> bands;
+    for (int y = 0; y < height; y += TRANSPOSE_TILE_SIZE)
+        bands.append(y);
+
+    QtConcurrent::blockingMap(bands, [ = ](int const top)
+    {
+        int const bottom = std::min(height, top + TRANSPOSE_TILE_SIZE);
+        for (int left = 0; left < width; left += TRANSPOSE_TILE_SIZE)
+        {
+            int const right = std::min(width, left + TRANSPOSE_TILE_SIZE);
+            for (int x = left; x < right; x++)
+            {
+                T * line = target + static_cast<size_t>(mirrorY ? width - x - 1 : x) * height;
+                for (int y = top; y < bottom; y++)
+                    line[mirrorX ? height - y - 1 : y] = source[static_cast<size_t>(y) * width + x];
+            }
+        }
+    });
+}
+
+/* Mirror the width x height pixels of buffer horizontally and/or vertically in place.
+ * Mirroring both ways is a rotation by 180 degrees. When mirroring vertically, each line is swapped with its
+ * opposite, so tasks only go through the upper half.
+ */
+template <typename T>
+void mirrorLines(T * buffer, int width, int height, bool mirrorX, bool mirrorY)
+{
+    int const lines = mirrorY ? (height + 1) / 2 : height;
+    QVector<int> bands;
+    for (int y = 0; y < lines; y += MIRROR_LINES_PER_TASK)
+        bands.append(y);
+
+    QtConcurrent::blockingMap(bands, [ = ](int const first)
+    {
+        int const last = std::min(lines, first + MIRROR_LINES_PER_TASK);
+        for (int y = first; y < last; y++)
+        {
+            T * const line = buffer + static_cast<size_t>(y) * width;
+            T * const opposite = buffer + static_cast<size_t>(mirrorY ? height - y - 1 : y) * width;
+
+            if (line == opposite)
+            {
+                if (mirrorX)
+                    std::reverse(line, line + width);
+            }
+            else if (mirrorX)
+            {
+                for (int x = 0; x < width; x++)
+                    std::swap(line[x], opposite[width - x - 1]);
+            }
+            else
+                std::swap_ranges(line, line + width, opposite);
+        }
+    });
+}
+}
+
 /* Rotate an image by 90, 180, or 270 degrees, with an optional
  * reflection across the vertical or horizontal axis.
- * verbose generates extra info on stdout.
- * return nullptr if successful or rotated image.
+ * Each orientation is a transposition, or not, followed by mirrors. The transpositions are copied tile by tile
+ * into a new buffer, the mirrors are done in place.
  */
 template <typename T>
 bool FITSData::rotFITS(int rotate, int mirror)
 {
-    int ny, nx;
-    int x1, y1, x2, y2;
-    uint8_t * rotimage = nullptr;
-    int offset        = 0;
-
     if (rotate == 1)
         rotate = 90;
     else if (rotate == 2)
@@ -2968,238 +3164,85 @@ bool FITSData::rotFITS(int rotate, int mirror)
     else if (rotate < 0)
         rotate = rotate + 360;
 
-    nx = m_Statistics.width;
-    ny = m_Statistics.height;
-
-    int BBP = m_Statistics.bytesPerPixel;
-
-    /* Allocate buffer for rotated image */
-    rotimage = new uint8_t[m_Statistics.samples_per_channel * m_Statistics.channels * BBP];
-
-    if (rotimage == nullptr)
-    {
-        qWarning() << "Unable to allocate memory for rotated image buffer!";
-        return false;
-    }
+    int const nx = m_Statistics.width;
+    int const ny = m_Statistics.height;
 
-    auto * rotBuffer = reinterpret_cast<T *>(rotimage);
-    auto * buffer    = reinterpret_cast<T *>(m_ImageBuffer);
+    bool transpose = false, swapAxes = false, mirrorX = false, mirrorY = false;
 
     /* Mirror image without rotation */
     if (rotate < 45 && rotate > -45)
     {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2 = nx - x1 - 1;
-                    for (y1 = 0; y1 < ny; y1++)
-                        rotBuffer[(y1 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y2 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y1 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
+        mirrorX = mirror == 1;
+        mirrorY = mirror == 2;
     }
-
     /* Rotate by 90 degrees */
     else if (rotate >= 45 && rotate < 135)
     {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(x1 * ny) + y1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = x1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-
-        m_Statistics.width  = ny;
-        m_Statistics.height = nx;
+        transpose = swapAxes = true;
+        mirrorX = mirror != 2;
+        mirrorY = mirror == 1;
     }
-
     /* Rotate by 180 degrees */
     else if (rotate >= 135 && rotate < 225)
     {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y2 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2 = nx - x1 - 1;
-                    for (y1 = 0; y1 < ny; y1++)
-                        rotBuffer[(y1 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        x2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
+        mirrorX = mirror != 1;
+        mirrorY = mirror != 2;
     }
-
     /* Rotate by 270 degrees */
     else if (rotate >= 225 && rotate < 315)
     {
-        if (mirror == 1)
+        transpose = swapAxes = true;
+        mirrorX = mirror == 2;
+        mirrorY = mirror != 1;
+    }
+    /* If rotating by more than 315 degrees, assume top-bottom reflection, the dimensions being kept as they are */
+    else if (rotate >= 315 && mirror)
+        transpose = true;
+
+    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
+
+    if (transpose)
+    {
+        /* Allocate buffer for rotated image */
+        uint32_t const rotSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
+        uint8_t * rotimage = nullptr;
+
+        try
         {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(x1 * ny) + y1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
+            rotimage = FrameBufferPool::Instance()->acquire(rotSize);
         }
-        else if (mirror == 2)
+        catch (const std::bad_alloc &)
         {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
+            logOOMError(rotSize);
+            qWarning() << "Unable to allocate memory for rotated image buffer!";
+            return false;
         }
-        else
+
+        auto * rotBuffer = reinterpret_cast<T *>(rotimage);
+        for (int i = 0; i < m_Statistics.channels; i++)
         {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = y1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
+            size_t const offset = static_cast<size_t>(m_Statistics.samples_per_channel) * i;
+            transposeTiles<T>(buffer + offset, rotBuffer + offset, nx, ny, mirrorX, mirrorY);
         }
 
-        m_Statistics.width  = ny;
-        m_Statistics.height = nx;
-    }
+        FrameBufferPool::Instance()->release(m_ImageBuffer);
+        m_ImageBuffer = rotimage;
 
-    /* If rotating by more than 315 degrees, assume top-bottom reflection */
-    else if (rotate >= 315 && mirror)
+        if (swapAxes)
+        {
+            m_Statistics.width  = ny;
+            m_Statistics.height = nx;
+        }
+    }
+    else if (mirrorX || mirrorY)
     {
         for (int i = 0; i < m_Statistics.channels; i++)
         {
-            offset = m_Statistics.samples_per_channel * i;
-            for (y1 = 0; y1 < ny; y1++)
-            {
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2                                 = y1;
-                    y2                                 = x1;
-                    rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
+            size_t const offset = static_cast<size_t>(m_Statistics.samples_per_channel) * i;
+            mirrorLines<T>(buffer + offset, nx, ny, mirrorX, mirrorY);
         }
     }
 
-    delete[] m_ImageBuffer;
-    m_ImageBuffer = rotimage;
-
     return true;
 }
 
@@ -3498,7 +3541,7 @@ uint8_t const * FITSData::getImageBuffer() const
 
 void FITSData::setImageBuffer(uint8_t * buffer)
 {
-    delete[] m_ImageBuffer;
+    FrameBufferPool::Instance()->release(m_ImageBuffer);
     m_ImageBuffer = buffer;
 }
 
@@ -3608,8 +3651,16 @@ bool FITSData::debayer(bool reload)
     {
         int anynull = 0, status = 0;
 
-        if (fits_read_img(fptr, m_Statistics.dataType, 1, m_Statistics.samples_per_channel, nullptr, m_ImageBuffer,
-                          &anynull, &status))
+        // A region or a preview is read again as it was loaded, unless it was saved since
+        QRect const image(0, 0, m_Loader.width(), m_Loader.height());
+        if (!image.isEmpty() && (m_ReadSampling > 1 || m_ReadArea != image))
+        {
+            if (!m_Loader.read(m_Statistics.dataType, m_Statistics.bytesPerPixel, 1, m_ImageBuffer, m_ReadArea,
+                               m_ReadSampling))
+                return false;
+        }
+        else if (fits_read_img(fptr, m_Statistics.dataType, 1, m_Statistics.samples_per_channel, nullptr, m_ImageBuffer,
+                               &anynull, &status))
         {
             //                char errmsg[512];
             //                fits_get_errstatus(status, errmsg);
@@ -3640,7 +3691,7 @@ bool FITSData::debayer_8bit()
 
     try
     {
-        destinationBuffer = new uint8_t[rgb_size];
+        destinationBuffer = FrameBufferPool::Instance()->acquire(rgb_size);
     }
     catch (const std::bad_alloc &e)
     {
@@ -3677,20 +3728,20 @@ bool FITSData::debayer_8bit()
     {
         m_LastError = i18n("Debayer failed (%1)", error_code);
         m_Statistics.channels = 1;
-        delete[] destinationBuffer;
+        FrameBufferPool::Instance()->release(destinationBuffer);
         return false;
     }
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        FrameBufferPool::Instance()->release(m_ImageBuffer);
         try
         {
-            m_ImageBuffer = new uint8_t[rgb_size];
+            m_ImageBuffer = FrameBufferPool::Instance()->acquire(rgb_size);
         }
         catch (const std::bad_alloc &e)
         {
-            delete[] destinationBuffer;
+            FrameBufferPool::Instance()->release(destinationBuffer);
             logOOMError(rgb_size);
             m_LastError = i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what());
             return false;
@@ -3720,7 +3771,7 @@ bool FITSData::debayer_8bit()
     // frames
     m_Statistics.channels = (m_Mode == FITS_NORMAL || m_Mode == FITS_CALIBRATE) ? 3 : 1;
     m_Statistics.dataType = TBYTE;
-    delete[] destinationBuffer;
+    FrameBufferPool::Instance()->release(destinationBuffer);
     return true;
 }
 
@@ -3732,7 +3783,7 @@ bool FITSData::debayer_16bit()
     uint8_t *destinationBuffer = nullptr;
     try
     {
-        destinationBuffer = new uint8_t[rgb_size];
+        destinationBuffer = FrameBufferPool::Instance()->acquire(rgb_size);
     }
     catch (const std::bad_alloc &e)
     {
@@ -3769,21 +3820,21 @@ bool FITSData::debayer_16bit()
     {
         m_LastError = i18n("Debayer failed (%1)");
         m_Statistics.channels = 1;
-        delete[] destinationBuffer;
+        FrameBufferPool::Instance()->release(destinationBuffer);
         return false;
     }
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        FrameBufferPool::Instance()->release(m_ImageBuffer);
         try
         {
-            m_ImageBuffer = new uint8_t[rgb_size];
+            m_ImageBuffer = FrameBufferPool::Instance()->acquire(rgb_size);
         }
         catch (const std::bad_alloc &e)
         {
             logOOMError(rgb_size);
-            delete[] destinationBuffer;
+            FrameBufferPool::Instance()->release(destinationBuffer);
             m_LastError = i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what());
             return false;
         }
@@ -3809,7 +3860,7 @@ bool FITSData::debayer_16bit()
 
     m_Statistics.channels = (m_Mode == FITS_NORMAL || m_Mode == FITS_CALIBRATE) ? 3 : 1;
     m_Statistics.dataType = TUSHORT;
-    delete[] destinationBuffer;
+    FrameBufferPool::Instance()->release(destinationBuffer);
     return true;
 }
 
@@ -4033,7 +4084,8 @@ bool FITSData::ImageToFITS(const QString &filename, const QString &format, QStri
         // ARGB
         uint32_t srcBytes = naxes[0] * naxes[1] * 4 - 4;
 
-        uint8_t *rgbBuffer = new uint8_t[nelements];
+        FrameBuffer rgb(nelements);
+        uint8_t *rgbBuffer = rgb.data();
         if (rgbBuffer == nullptr)
         {
             qCWarning(KSTARS_FITS) << "Not enough memory for RGB buffer";
@@ -4059,11 +4111,8 @@ bool FITSData::ImageToFITS(const QString &filename, const QString &format, QStri
             status = 0;
             fits_flush_file(fptr, &status);
             fits_close_file(fptr, &status);
-            delete [] rgbBuffer;
             return false;
         }
-
-        delete [] rgbBuffer;
     }
 
     if (fits_flush_file(fptr, &status))
@@ -22,7 +22,10 @@
 #include "bayer.h"
 #include "skybackground.h"
 #include "fitscommon.h"
+#include "fitsimageview.h"
 #include "fitsstardetector.h"
+#include "fitsloader.h"
+#include "framebufferpool.h"
 
 #ifdef WIN32
 // This header must be included before fitsio.h to avoid compiler errors with Visual Studio
@@ -37,10 +40,13 @@
 #include <QVariant>
 #include <QTemporaryFile>
 
+#include <vector>
+
 #ifndef KSTARS_LITE
 #include <kxmlguiwindow.h>
 #ifdef HAVE_WCSLIB
 #include <wcs.h>
+#include "wcsgrid.h"
 #endif
 #endif
 
@@ -117,6 +123,16 @@ class FITSData : public QObject
          */
         bool loadFromBuffer(const QByteArray &buffer, const QString &extension, const QString &inFilename = QString());
 
+        /**
+         * @brief setReadRegion Read only part of the FITS images loaded next, optionally decimated to a preview.
+         * The header still describes the whole image, while the statistics, the stars, the dimensions and the WCS
+         * are those of the pixels read. A WCS with distortions is not loaded for part of an image.
+         * @param region Part of the image to read, the whole image if null. It starts on even pixels to keep the Bayer pattern.
+         * @param maximumSize Read one pixel out of an odd number of them along each axis, so that the region is no
+         * larger than this many pixels, 0 to read all of them.
+         */
+        void setReadRegion(const QRect &region, int maximumSize = 0);
+
         /**
          * @brief parseSolution Parse the WCS solution information from the header into the given struct.
          * @param solution Solution structure to fill out.
@@ -132,6 +148,10 @@ class FITSData : public QObject
         void setImageBuffer(uint8_t *buffer);
         uint8_t const *getImageBuffer() const;
         uint8_t *getWritableImageBuffer();
+        /** @return a view of the image buffer, valid until the buffer is replaced */
+        FITSImageView getImageView() const;
+        /** @return mean and standard deviation of a channel of @p view, calculated as for the statistics of a frame */
+        static QPair<double, double> getMeanStdDev(const FITSImageView &view, int channel = 0);
 
         ////////////////////////////////////////////////////////////////////////////////////////
         ////////////////////////////////////////////////////////////////////////////////////////
@@ -399,6 +419,16 @@ class FITSData : public QObject
              */
         bool wcsToPixel(const SkyPoint &wcsCoord, QPointF &wcsPixelPoint, QPointF &wcsImagePoint);
 
+        /**
+             * @brief wcsToPixels Find in the image the pixel coordinates of many J2000 coordinates at once, for overlays
+             * and object searches. Positions are interpolated by the WCS grid when the frame has one, within
+             * WCSGrid::DEFAULT_TOLERANCE pixels, and converted by wcslib across threads otherwise.
+             * @param coords J2000 RA and DE of the targets in degrees, as the x and y of each point
+             * @param pixels Return XY FITS coordinates of each target, NaN if it cannot be projected
+             * @return True if the image has WCS, false otherwise.
+             */
+        bool wcsToPixels(const QVector<QPointF> &coords, QVector<QPointF> &pixels);
+
         /**
              * @brief pixelToWCS Convert Pixel coordinates to J2000 world coordinates
              * @param wcsPixelPoint Pixel coordinates in XY Image space.
@@ -528,6 +558,8 @@ class FITSData : public QObject
         bool searchObjects();
         bool findObjectsInImage(SkyPoint startPoint, SkyPoint endPoint);
         bool findWCSBounds(double &minRA, double &maxRA, double &minDec, double &maxDec);
+        /** @return the interpolation grid of the WCS, sampled when first needed, or nullptr if it is not accurate enough. */
+        const WCSGrid *wcsGrid();
 #endif
 #endif
         const QList<FITSSkyObject *> &getSkyObjects() const
@@ -567,9 +599,15 @@ class FITSData : public QObject
          */
         void dataChanged();
     public slots:
-        void makeRoiBuffer(QRect roi);
+        /**
+         * @brief calculateRoiStats Calculates the statistics of a selection, reading the image buffer in place.
+         * @param roi Selection, the top left pixel of the image being at (1, 1).
+         */
+        void calculateRoiStats(QRect roi);
 
     private:
+        friend class TestFitsData;
+
         void loadCommon(const QString &inFilename);
         /**
          * @brief privateLoad Load an image (FITS, RAW, or images supported by Qt like jpeg, png).
@@ -581,7 +619,7 @@ class FITSData : public QObject
         // Load Qt-supported images.
         bool loadCanonicalImage(const QByteArray &buffer, const QString &extension);
         // Load FITS images.
-        bool loadFITSImage(const QByteArray &buffer, const QString &extension, const bool isCompressed = false);
+        bool loadFITSImage(const QByteArray &buffer, const QString &extension);
         // Load RAW images.
         bool loadRAWImage(const QByteArray &buffer, const QString &extension);
 
@@ -590,6 +628,11 @@ class FITSData : public QObject
         void calculateMedian(bool refresh = false, bool roi = false);
         bool checkDebayer();
         void readWCSKeys();
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+        // Move the reference pixel and scale the pixel size of the WCS to the region and sampling read,
+        // false if the WCS cannot describe them
+        bool mapWCSToReadArea();
+#endif
 
         // Record last FITS error
         void recordLastError(int errorCode);
@@ -629,7 +672,9 @@ class FITSData : public QObject
         template <typename T>
         void runningAverageStdDev( bool roi = false );
         template <typename T>
-        QPair<double, double> getSquaredSumAndMean(uint32_t start, uint32_t stride, bool roi = false);
+        static QPair<double, double> runningAverageStdDev(const FITSImageView &view, int channel);
+        template <typename T>
+        static QPair<double, double> getSquaredSumAndMean(const FITSImageView &view, uint32_t start, uint32_t stride);
 
         template <typename T>
         void convertToQImage(double dataMin, double dataMax, double scale, double zero, QImage &image);
@@ -647,10 +692,10 @@ class FITSData : public QObject
         uint8_t *m_ImageBuffer { nullptr };
         /// Above buffer size in bytes
         uint32_t m_ImageBufferSize { 0 };
-        /// Image Buffer if Selection is to be done
-        uint8_t *m_ImageRoiBuffer { nullptr };
-        /// Above buffer size in bytes
-        uint32_t m_ImageRoiBufferSize { 0 };
+        /// View of the selection whose statistics are calculated
+        FITSImageView m_ROIView;
+        /// Buffer of the samples of the selection from which its median is calculated
+        FrameBuffer m_ROISamples;
         /// Is this a temporary file or one loaded from disk?
         bool m_isTemporary { false };
         /// is this file compress (.fits.fz)?
@@ -665,8 +710,13 @@ class FITSData : public QObject
         bool FullWCS { false };
         /// Is the image debayarable?
         bool HasDebayer { false };
-        /// Buffer to hold fpack uncompressed data
-        uint8_t *m_PackBuffer {nullptr};
+        /// Mapped FITS file or buffer, from which the pixels are read
+        FITSLoader m_Loader;
+        /// Region and decimation requested, and those of the pixels read
+        QRect m_ReadRegion;
+        int m_ReadMaximumSize { 0 };
+        QRect m_ReadArea;
+        int m_ReadSampling { 1 };
 
         /// Our very own file name
         QString m_Filename, m_compressedFilename;
@@ -690,6 +740,16 @@ class FITSData : public QObject
         /// Number of coordinate representations found.
         int m_nwcs {0};
         WCSState m_WCSState { Idle };
+#ifndef KSTARS_LITE
+#ifdef HAVE_WCSLIB
+        /// Interpolation of the WCS and bounds of the frame on the sky, computed when first needed
+        WCSGrid m_WCSGrid;
+        bool m_WCSGridSampled { false };
+        bool m_WCSBoundsFound { false };
+        /// Minimum and maximum RA, minimum and maximum DE
+        double m_WCSBounds[4] { 0, 0, 0, 0 };
+#endif
+#endif
         /// All the stars we detected, if any.
         QList<Edge *> starCenters;
         QList<Edge *> localStarCenters;
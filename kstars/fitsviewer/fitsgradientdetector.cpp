@@ -10,7 +10,9 @@
 */
 
 #include <math.h>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <QtConcurrent>
 
 #include "fits_debug.h"
@@ -37,7 +39,7 @@ QFuture<bool> FITSGradientDetector::findSources(const QRect &boundary)
             return QtConcurrent::run(this, &FITSGradientDetector::findSources<int32_t>, boundary);
 
         case TULONG:
-            return QtConcurrent::run(this, &FITSGradientDetector::findSources<uint16_t>, boundary);
+            return QtConcurrent::run(this, &FITSGradientDetector::findSources<uint32_t>, boundary);
 
         case TFLOAT:
             return QtConcurrent::run(this, &FITSGradientDetector::findSources<float>, boundary);
@@ -50,76 +52,49 @@ QFuture<bool> FITSGradientDetector::findSources(const QRect &boundary)
     }
 }
 
+QVector<QPair<void const *, size_t>> FITSGradientDetector::reusedBuffers() const
+{
+    QVector<QPair<void const *, size_t>> buffers;
+    for (FrameBuffer const * buffer : {&m_Filtered, &m_Gradients, &m_Directions, &m_IDs})
+        buffers.append(qMakePair<void const *, size_t>(buffer->data(), buffer->capacity()));
+    return buffers;
+}
+
 template <typename T>
 bool FITSGradientDetector::findSources(const QRect &boundary)
 {
-    int subX = qMax(0, boundary.isNull() ? 0 : boundary.x());
-    int subY = qMax(0, boundary.isNull() ? 0 : boundary.y());
-    int subW = (boundary.isNull() ? m_ImageData->width() : boundary.width());
-    int subH = (boundary.isNull() ? m_ImageData->height() : boundary.height());
-
-    int BBP = m_ImageData->getBytesPerPixel();
-
-    uint16_t dataWidth = m_ImageData->width();
-
-    // #1 Find offsets
-    uint32_t size   = subW * subH;
-    uint32_t offset = subX + subY * dataWidth;
-
-    // #2 Create new buffer
-    auto * buffer = new uint8_t[size * BBP];
-    // If there is no offset, copy whole buffer in one go
-    if (offset == 0)
-        memcpy(buffer, m_ImageData->getImageBuffer(), size * BBP);
-    else
-    {
-        uint8_t * dataPtr = buffer;
-        uint8_t const * origDataPtr = m_ImageData->getImageBuffer();
-        uint32_t lineOffset  = 0;
-        // Copy data line by line
-        for (int height = subY; height < (subY + subH); height++)
-        {
-            lineOffset = (subX + height * dataWidth) * BBP;
-            memcpy(dataPtr, origDataPtr + lineOffset, subW * BBP);
-            dataPtr += (subW * BBP);
-        }
-    }
-
-    // #3 Create new FITSData to hold it
-    auto * boundedImage                      = new FITSData();
-    FITSImage::Statistic stats;
-    stats.width               = subW;
-    stats.height              = subH;
-    stats.dataType            = m_ImageData->getStatistics().dataType;
-    stats.bytesPerPixel       = m_ImageData->getStatistics().bytesPerPixel;
-    stats.samples_per_channel = size;
-    stats.ndim                = 2;
-    boundedImage->restoreStatistics(stats);
-
-    // #4 Set image buffer and calculate stats.
-    boundedImage->setImageBuffer(buffer);
+    QRect const frame(0, 0, m_ImageData->width(), m_ImageData->height());
+    QRect const area = boundary.isNull() ? frame : boundary.intersected(frame);
+    if (area.isEmpty())
+        return false;
 
-    boundedImage->calculateStats(true);
+    int subX = area.x();
+    int subY = area.y();
+    int subW = area.width();
+    int subH = area.height();
 
-    // #5 Apply Median + High Contrast filter to remove noise and move data to non-linear domain
-    boundedImage->applyFilter(FITS_MEDIAN);
-    boundedImage->applyFilter(FITS_HIGH_CONTRAST);
+    // #1 Apply Median + High Contrast filter to remove noise and move data to non-linear domain.
+    // The area is read in place, the filtered pixels go to a buffer kept for the next frames.
+    FITSImageView const view = m_ImageData->getImageView().sub(area);
+    uint32_t const samples = view.samplesPerChannel();
+    T * filtered = reinterpret_cast<T *>(m_Filtered.allocate(samples * sizeof(T)));
+    FITSImageView const filteredView(m_Filtered.data(), view.dataType(), view.bytesPerPixel(), subW, subH);
+    medianFilter<T>(view, filtered);
+    highContrastFilter<T>(filteredView, filtered);
 
-    // #6 Perform Sobel to find gradients and their directions
-    QVector<float> gradients;
-    QVector<float> directions;
+    // #2 Perform Sobel to find gradients and their directions
+    float * gradients = reinterpret_cast<float *>(m_Gradients.allocate(samples * sizeof(float)));
+    float * directions = reinterpret_cast<float *>(m_Directions.allocate(samples * sizeof(float)));
 
     // TODO Must trace neighbours and assign IDs to each shape so that they can be centered massed
     // and discarded whenever necessary. It won't work on noisy images unless this is done.
-    sobel<T>(boundedImage, gradients, directions);
+    sobel<T>(filteredView, gradients, directions);
 
-    QVector<int> ids(gradients.size());
+    int * ids = reinterpret_cast<int *>(m_IDs.allocate(samples * sizeof(int)));
+    std::fill(ids, ids + samples, 0);
 
     int maxID = partition(subW, subH, gradients, ids);
 
-    // Not needed anymore
-    delete boundedImage;
-
     if (maxID == 0)
         return 0;
 
@@ -132,7 +107,7 @@ bool FITSGradientDetector::findSources(const QRect &boundary)
 
     QMap<int, massInfo> masses;
 
-    // #7 Calculate center of mass for all detected regions
+    // #3 Calculate center of mass for all detected regions
     for (int y = 0; y < subH; y++)
     {
         for (int x = 0; x < subW; x++)
@@ -230,11 +205,11 @@ bool FITSGradientDetector::findSources(const QRect &boundary)
     QVector<double> subPixels;
     subPixels.reserve(center->width / resolution);
 
-    const T * origBuffer = reinterpret_cast<T const *>(m_ImageData->getImageBuffer()) + offset;
+    const T * origLine = view.line<T>(cen_y);
 
     for (double x = leftEdge; x <= rightEdge; x += resolution)
     {
-        double slice = resolution * (origBuffer[static_cast<int>(floor(x)) + cen_y * dataWidth]);
+        double slice = resolution * (origLine[static_cast<int>(floor(x))]);
         FSum += slice;
         subPixels.append(slice);
     }
@@ -282,37 +257,74 @@ bool FITSGradientDetector::findSources(const QRect &boundary)
     return true;
 }
 
+// Based on http://www.librow.com/articles/article-1, as FITSData applies FITS_MEDIAN
+template <typename T>
+void FITSGradientDetector::medianFilter(FITSImageView const &view, T * filtered) const
+{
+    int const width = view.width();
+    int const height = view.height();
+
+    for (int y = 0; y < height; y++)
+    {
+        // The border pixels are repeated outside the view
+        T const * lines[3] = { view.line<T>(qMax(0, y - 1)), view.line<T>(y), view.line<T>(qMin(height - 1, y + 1)) };
+        for (int x = 0; x < width; x++)
+        {
+            int const columns[3] = { qMax(0, x - 1), x, qMin(width - 1, x + 1) };
+            float window[9];
+            int k = 0;
+            for (T const * line : lines)
+                for (int column : columns)
+                    window[k++] = line[column];
+            std::nth_element(window, window + 4, window + 9);
+            filtered[x + y * width] = window[4];
+        }
+    }
+}
+
+template <typename T>
+void FITSGradientDetector::highContrastFilter(FITSImageView const &view, T * filtered) const
+{
+    QPair<double, double> const meanStdDev = FITSData::getMeanStdDev(view);
+    double const mean = meanStdDev.first, stddev = meanStdDev.second;
+
+    // Keep the values between one and three standard deviations above the mean, as FITS_HIGH_CONTRAST does
+    double const low = mean + stddev, high = mean + stddev * 3;
+    T const min = low < std::numeric_limits<T>::min() ? std::numeric_limits<T>::min() : low;
+    T const max = high > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : high;
+    size_t const size = view.samplesPerChannel();
+    for (size_t i = 0; i < size; i++)
+        filtered[i] = qBound(min, filtered[i], max);
+}
+
 /* CannyDetector, Implementation of Canny edge detector in Qt/C++.
  * Web-Site: https://github.com/hipersayanX/CannyDetector
  */
 
 template <typename T>
-void FITSGradientDetector::sobel(FITSData const *data, QVector<float> &gradient, QVector<float> &direction) const
+void FITSGradientDetector::sobel(FITSImageView const &view, float * gradient, float * direction) const
 {
-    if (data == nullptr)
+    if (view.isNull())
         return;
 
-    FITSImage::Statistic const &stats = data->getStatistics();
-
-    //int size = image.width() * image.height();
-    gradient.resize(stats.samples_per_channel);
-    direction.resize(stats.samples_per_channel);
+    int const width = view.width();
+    int const height = view.height();
 
-    for (int y = 0; y < stats.height; y++)
+    for (int y = 0; y < height; y++)
     {
-        size_t yOffset    = y * stats.width;
-        const T * grayLine = reinterpret_cast<T const *>(data->getImageBuffer()) + yOffset;
+        size_t yOffset    = y * width;
+        const T * grayLine = view.line<T>(y);
 
-        const T * grayLine_m1 = y < 1 ? grayLine : grayLine - stats.width;
-        const T * grayLine_p1 = y >= stats.height - 1 ? grayLine : grayLine + stats.width;
+        const T * grayLine_m1 = y < 1 ? grayLine : view.line<T>(y - 1);
+        const T * grayLine_p1 = y >= height - 1 ? grayLine : view.line<T>(y + 1);
 
-        float * gradientLine  = gradient.data() + yOffset;
-        float * directionLine = direction.data() + yOffset;
+        float * gradientLine  = gradient + yOffset;
+        float * directionLine = direction + yOffset;
 
-        for (int x = 0; x < stats.width; x++)
+        for (int x = 0; x < width; x++)
         {
             int x_m1 = x < 1 ? x : x - 1;
-            int x_p1 = x >= stats.width - 1 ? x : x + 1;
+            int x_p1 = x >= width - 1 ? x : x + 1;
 
             int gradX = grayLine_m1[x_p1] + 2 * grayLine[x_p1] + grayLine_p1[x_p1] - grayLine_m1[x_m1] -
                         2 * grayLine[x_m1] - grayLine_p1[x_m1];
@@ -369,7 +381,7 @@ void FITSGradientDetector::sobel(FITSData const *data, QVector<float> &gradient,
     }
 }
 
-int FITSGradientDetector::partition(int width, int height, QVector<float> &gradient, QVector<int> &ids) const
+int FITSGradientDetector::partition(int width, int height, float const * gradient, int * ids) const
 {
     int id = 0;
 
@@ -390,12 +402,11 @@ int FITSGradientDetector::partition(int width, int height, QVector<float> &gradi
     return id;
 }
 
-void FITSGradientDetector::trace(int width, int height, int id, QVector<float> &image, QVector<int> &ids, int x,
-                                 int y) const
+void FITSGradientDetector::trace(int width, int height, int id, float const * image, int * ids, int x, int y) const
 {
     int yOffset      = y * width;
-    float * cannyLine = image.data() + yOffset;
-    int * idLine      = ids.data() + yOffset;
+    float const * cannyLine = image + yOffset;
+    int * idLine      = ids + yOffset;
 
     if (idLine[x] != 0)
         return;
@@ -409,7 +420,7 @@ void FITSGradientDetector::trace(int width, int height, int id, QVector<float> &
         if (nextY < 0 || nextY >= height)
             continue;
 
-        float * cannyLineNext = cannyLine + j * width;
+        float const * cannyLineNext = cannyLine + j * width;
 
         for (int i = -1; i < 2; i++)
         {
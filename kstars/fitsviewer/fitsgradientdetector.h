@@ -12,7 +12,17 @@
 #define FITSGRADIENTDETECTOR_H
 
 #include "fitsstardetector.h"
+#include "framebufferpool.h"
 
+class FITSImageView;
+
+/**
+ * @class FITSGradientDetector
+ * @short Finds the brightest star of a frame or of a tracking box from the gradients of its pixels.
+ *
+ * The tracking box is read in place. The filtered pixels, the gradients and the labels are kept in buffers of the
+ * FrameBufferPool, reused by the next detections of the same detector and by other frames afterwards.
+ */
 class FITSGradientDetector: public FITSStarDetector
 {
         Q_OBJECT
@@ -26,6 +36,9 @@ class FITSGradientDetector: public FITSStarDetector
          */
         QFuture<bool> findSources(QRect const &boundary = QRect()) override;
 
+        /** @see FITSStarDetector::reusedBuffers(). */
+        QVector<QPair<void const *, size_t>> reusedBuffers() const override;
+
     protected:
         /** @internal Find sources in the parent FITS data file, dependent of the pixel depth.
          * @see FITSGradientDetector::findSources.
@@ -33,29 +46,50 @@ class FITSGradientDetector: public FITSStarDetector
         template <typename T>
         bool findSources(const QRect &boundary);
 
+        /** @internal Median filter over 3x3 pixels, the pixels on the border of the view being repeated outside.
+         * @param view is the area to filter.
+         * @param filtered receives the filtered pixels, line after line.
+         */
+        template <typename T>
+        void medianFilter(FITSImageView const &view, T * filtered) const;
+
+        /** @internal Clamps pixels between one and three standard deviations above their mean.
+         * @param view is the view of the filtered pixels.
+         * @param filtered is the buffer of the view, clamped in place.
+         */
+        template <typename T>
+        void highContrastFilter(FITSImageView const &view, T * filtered) const;
+
         /** @internal Implementation of the Canny Edge detection (CannyEdgeDetector).
          * @copyright 2015 Gonzalo Exequiel Pedone (https://github.com/hipersayanX/CannyDetector).
-         * @param data is the FITS data to run the detection onto.
-         * @param gradient is the vector storing the amount of change in pixel sequences.
-         * @param direction is the vector storing the four directions (horizontal, vertical and two diagonals) the changes stored in 'gradient' are detected in.
+         * @param view is the image to run the detection onto.
+         * @param gradient is the buffer storing the amount of change in pixel sequences, one per pixel of the view.
+         * @param direction is the buffer storing the four directions (horizontal, vertical and two diagonals) the changes stored in 'gradient' are detected in.
          */
         template <typename T>
-        void sobel(FITSData const * data, QVector<float> &gradient, QVector<float> &direction) const;
+        void sobel(FITSImageView const &view, float * gradient, float * direction) const;
 
         /** @internal Identify gradient connections.
          * @param width, height are the dimensions of the frame to work on.
-         * @param gradient is the vector holding the amount of change in pixel sequences.
-         * @param ids is the vector storing which gradient was identified for each pixel.
+         * @param gradient is the buffer holding the amount of change in pixel sequences.
+         * @param ids is the buffer storing which gradient was identified for each pixel, zeroed beforehand.
          */
-        int partition(int width, int height, QVector<float> &gradient, QVector<int> &ids) const;
+        int partition(int width, int height, float const * gradient, int * ids) const;
 
         /** @internal Trace gradient neighbors.
          * @param width, height are the dimensions of the frame to work on.
          * @param image is the image to work on, actually gradients extracted using the sobel algorithm.
-         * @param ids is the vector storing which gradient was identified for each pixel.
+         * @param ids is the buffer storing which gradient was identified for each pixel.
          * @param x, y locate the pixel to trace from.
          */
-        void trace(int width, int height, int id, QVector<float> &image, QVector<int> &ids, int x, int y) const;
+        void trace(int width, int height, int id, float const * image, int * ids, int x, int y) const;
+
+    private:
+        /** Filtered pixels of the tracking box */
+        FrameBuffer m_Filtered;
+        FrameBuffer m_Gradients;
+        FrameBuffer m_Directions;
+        FrameBuffer m_IDs;
 };
 
 #endif // FITSGRADIENTDETECTOR_H
@@ -13,6 +13,7 @@
 #include "fitstab.h"
 #include "fitsview.h"
 #include "fitsviewer.h"
+#include "framebufferpool.h"
 
 #include <KMessageBox>
 
@@ -529,13 +530,8 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
         imageData->width() * imageData->height() * imageData->channels();
     unsigned long totalBytes = totalPixels * imageData->getBytesPerPixel();
 
-    auto * raw_delta = new uint8_t[totalBytes];
-
-    if (raw_delta == nullptr)
-    {
-        qWarning() << "Error! not enough memory to create image delta" << endl;
-        return false;
-    }
+    FrameBuffer rawDelta(totalBytes);
+    uint8_t * raw_delta = rawDelta.data();
 
     for (unsigned int i = 0; i < totalBytes; i++)
         raw_delta[i] = buffer[i] ^ image_buffer[i];
@@ -546,7 +542,6 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
 
     if (delta == nullptr)
     {
-        delete[] raw_delta;
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram Error: Ran out of memory compressing delta";
         return false;
@@ -556,7 +551,6 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
 
     if (r != Z_OK)
     {
-        delete[] raw_delta;
         /* this should NEVER happen */
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram Error: Failed to compress raw_delta";
@@ -566,8 +560,6 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
     // qDebug() << "compressed bytes size " << compressedBytes << " bytes" <<
     // endl;
 
-    delete[] raw_delta;
-
     return true;
 }
 
@@ -581,40 +573,24 @@ bool FITSHistogramCommand::reverseDelta()
         imageData->width() * imageData->height() * imageData->channels();
     unsigned long totalBytes = totalPixels * imageData->getBytesPerPixel();
 
-    auto * output_image = new uint8_t[totalBytes];
-
-    if (output_image == nullptr)
-    {
-        qWarning() << "Error! not enough memory to create output image" << endl;
-        return false;
-    }
-
-    auto * raw_delta = new uint8_t[totalBytes];
-
-    if (raw_delta == nullptr)
-    {
-        delete[] output_image;
-        qWarning() << "Error! not enough memory to create image delta" << endl;
-        return false;
-    }
+    FrameBuffer rawDelta(totalBytes);
+    uint8_t * raw_delta = rawDelta.data();
 
     int r = uncompress(raw_delta, &totalBytes, delta, compressedBytes);
     if (r != Z_OK)
     {
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram compression error in reverseDelta()";
-        delete[] output_image;
-        delete[] raw_delta;
         return false;
     }
 
+    // The output becomes the image buffer, given back to the pool like the one it replaces
+    auto * output_image = FrameBufferPool::Instance()->acquire(totalBytes);
     for (unsigned int i = 0; i < totalBytes; i++)
         output_image[i] = raw_delta[i] ^ image_buffer[i];
 
     imageData->setImageBuffer(output_image);
 
-    delete[] raw_delta;
-
     return true;
 }
 
@@ -653,16 +629,8 @@ void FITSHistogramCommand::redo()
         }
         else
         {
-            buffer = new uint8_t[size * BBP];
-
-            if (buffer == nullptr)
-            {
-                qWarning()
-                        << "Error! not enough memory to create image buffer in redo()"
-                        << endl;
-                QApplication::restoreOverrideCursor();
-                return;
-            }
+            FrameBuffer previous(size * BBP);
+            buffer = previous.data();
 
             memcpy(buffer, image_buffer, size * BBP);
 
@@ -688,7 +656,6 @@ void FITSHistogramCommand::redo()
             }
 
             calculateDelta(buffer);
-            delete[] buffer;
         }
     }
 
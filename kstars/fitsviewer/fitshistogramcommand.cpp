@@ -10,6 +10,7 @@
 #include "fitshistogramcommand.h"
 #include "fitshistogrameditor.h"
 #include "fitsviewer.h"
+#include "framebufferpool.h"
 #include "fits_debug.h"
 
 FITSHistogramCommand::FITSHistogramCommand(const QSharedPointer<FITSData> &data,
@@ -32,7 +33,7 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
     uint32_t totalPixels = m_ImageData->samplesPerChannel() * m_ImageData->channels();
     unsigned long totalBytes = totalPixels * m_ImageData->getBytesPerPixel();
 
-    auto * raw_delta = new uint8_t[totalBytes];
+    auto * raw_delta = FrameBufferPool::Instance()->acquire(totalBytes);
 
     if (raw_delta == nullptr)
     {
@@ -49,7 +50,7 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
 
     if (delta == nullptr)
     {
-        delete[] raw_delta;
+        FrameBufferPool::Instance()->release(raw_delta);
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram Error: Ran out of memory compressing delta";
         return false;
@@ -59,14 +60,14 @@ bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
 
     if (r != Z_OK)
     {
-        delete[] raw_delta;
+        FrameBufferPool::Instance()->release(raw_delta);
         /* this should NEVER happen */
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram Error: Failed to compress raw_delta";
         return false;
     }
 
-    delete[] raw_delta;
+    FrameBufferPool::Instance()->release(raw_delta);
     return true;
 }
 
@@ -76,7 +77,7 @@ bool FITSHistogramCommand::reverseDelta()
     uint32_t totalPixels = m_ImageData->samplesPerChannel() * m_ImageData->channels();
     unsigned long totalBytes = totalPixels * m_ImageData->getBytesPerPixel();
 
-    auto * output_image = new uint8_t[totalBytes];
+    auto * output_image = FrameBufferPool::Instance()->acquire(totalBytes);
 
     if (output_image == nullptr)
     {
@@ -84,11 +85,11 @@ bool FITSHistogramCommand::reverseDelta()
         return false;
     }
 
-    auto * raw_delta = new uint8_t[totalBytes];
+    auto * raw_delta = FrameBufferPool::Instance()->acquire(totalBytes);
 
     if (raw_delta == nullptr)
     {
-        delete[] output_image;
+        FrameBufferPool::Instance()->release(output_image);
         qCWarning(KSTARS_FITS) << "Error! not enough memory to create image delta";
         return false;
     }
@@ -98,8 +99,8 @@ bool FITSHistogramCommand::reverseDelta()
     {
         qCCritical(KSTARS_FITS)
                 << "FITSHistogram compression error in reverseDelta()";
-        delete[] output_image;
-        delete[] raw_delta;
+        FrameBufferPool::Instance()->release(output_image);
+        FrameBufferPool::Instance()->release(raw_delta);
         return false;
     }
 
@@ -108,7 +109,7 @@ bool FITSHistogramCommand::reverseDelta()
 
     m_ImageData->setImageBuffer(output_image);
 
-    delete[] raw_delta;
+    FrameBufferPool::Instance()->release(raw_delta);
 
     return true;
 }
@@ -144,7 +145,7 @@ void FITSHistogramCommand::redo()
         }
         else
         {
-            buffer = new uint8_t[totalPixels * BBP];
+            buffer = FrameBufferPool::Instance()->acquire(totalPixels * BBP);
 
             if (buffer == nullptr)
             {
@@ -177,7 +178,7 @@ void FITSHistogramCommand::redo()
             }
 
             calculateDelta(buffer);
-            delete[] buffer;
+            FrameBufferPool::Instance()->release(buffer);
         }
     }
 
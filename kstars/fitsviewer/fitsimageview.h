@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QRect>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class FITSImageView
+ * @short A rectangle of the pixels of an image buffer, read in place.
+ *
+ * The view does not own the pixels, which must outlive it. Its lines are stride() samples apart and its
+ * channels channelStride() samples apart, so the view of a sub-frame reads the buffer of the frame. The
+ * samples of the view are numbered line after line and channel after channel, as they would be in a buffer
+ * holding a copy of the rectangle.
+ */
+class FITSImageView
+{
+    public:
+        FITSImageView() = default;
+
+        /**
+         * @param data first sample of the first channel
+         * @param dataType FITS data type of the samples (TBYTE, TUSHORT...)
+         * @param stride samples between two lines, by default @p width
+         * @param channelStride samples between two channels, by default @p height lines
+         */
+        FITSImageView(uint8_t const *data, uint32_t dataType, int bytesPerPixel, int width, int height,
+                      int channels = 1, size_t stride = 0, size_t channelStride = 0)
+            : m_Data(data), m_DataType(dataType), m_BytesPerPixel(bytesPerPixel), m_Width(width), m_Height(height),
+              m_Channels(channels), m_Stride(stride ? stride : width),
+              m_ChannelStride(channelStride ? channelStride : (stride ? stride : width) * height)
+        {
+        }
+
+        /** @return the view of the part of @p rect within this view, @p rect being in the coordinates of this view */
+        FITSImageView sub(const QRect &rect) const
+        {
+            QRect const area = rect.intersected(QRect(0, 0, m_Width, m_Height));
+            if (area.isEmpty())
+                return FITSImageView();
+            return FITSImageView(m_Data + (area.y() * m_Stride + area.x()) * m_BytesPerPixel, m_DataType,
+                                 m_BytesPerPixel, area.width(), area.height(), m_Channels, m_Stride, m_ChannelStride);
+        }
+
+        bool isNull() const
+        {
+            return m_Data == nullptr;
+        }
+        uint32_t dataType() const
+        {
+            return m_DataType;
+        }
+        int bytesPerPixel() const
+        {
+            return m_BytesPerPixel;
+        }
+        int width() const
+        {
+            return m_Width;
+        }
+        int height() const
+        {
+            return m_Height;
+        }
+        int channels() const
+        {
+            return m_Channels;
+        }
+        size_t stride() const
+        {
+            return m_Stride;
+        }
+        size_t channelStride() const
+        {
+            return m_ChannelStride;
+        }
+        size_t samplesPerChannel() const
+        {
+            return static_cast<size_t>(m_Width) * m_Height;
+        }
+        /** @return true if the lines follow each other in the buffer */
+        bool isContiguous() const
+        {
+            return m_Stride == static_cast<size_t>(m_Width);
+        }
+
+        template <typename T>
+        T const *line(int y, int channel = 0) const
+        {
+            return reinterpret_cast<T const *>(m_Data) + channel * m_ChannelStride + y * m_Stride;
+        }
+
+        template <typename T>
+        T at(int x, int y, int channel = 0) const
+        {
+            return line<T>(y, channel)[x];
+        }
+
+        /**
+         * @short Calls @p function(T const *samples, size_t count) for each run of consecutive samples in the
+         * buffer among the @p count samples of the view starting at sample @p start.
+         * A contiguous view is read in one run per channel, any other view in one run per line.
+         */
+        template <typename T, typename Function>
+        void forEachSpan(size_t start, size_t count, Function function) const
+        {
+            size_t const perChannel = samplesPerChannel();
+            while (count > 0)
+            {
+                size_t const channel = start / perChannel;
+                size_t const index = start % perChannel;
+                int const y = index / m_Width;
+                int const x = index % m_Width;
+                size_t const span = std::min(count, isContiguous() ? perChannel - index : static_cast<size_t>(m_Width - x));
+                function(line<T>(y, channel) + x, span);
+                start += span;
+                count -= span;
+            }
+        }
+
+    private:
+        uint8_t const *m_Data { nullptr };
+        uint32_t m_DataType { 0 };
+        int m_BytesPerPixel { 1 };
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_Channels { 1 };
+        size_t m_Stride { 0 };
+        size_t m_ChannelStride { 0 };
+};
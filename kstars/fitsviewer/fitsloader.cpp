@@ -0,0 +1,309 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsloader.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+
+#include <fits_debug.h>
+
+namespace
+{
+// Bytes between the reads of a prefetch, the size of a memory page
+constexpr qint64 PREFETCH_STRIDE = 4096;
+// Bytes read at once when the file cannot be mapped
+constexpr qint64 PREFETCH_CHUNK = 1 << 20;
+
+QString fitsError(int status)
+{
+    char message[FLEN_STATUS] = {0};
+    fits_get_errstatus(status, message);
+    return QString(message);
+}
+
+// Prefetches run one at a time, in the background, and a file is not prefetched twice at once
+QThreadPool *prefetchPool()
+{
+    static QThreadPool *pool = []()
+    {
+        auto *pool = new QThreadPool();
+        pool->setMaxThreadCount(1);
+        return pool;
+    }();
+    return pool;
+}
+
+QMutex prefetchMutex;
+QSet<QString> prefetching;
+}
+
+FITSLoader::~FITSLoader()
+{
+    close();
+}
+
+bool FITSLoader::open(const QString &filename)
+{
+    close();
+
+    m_File.setFileName(filename);
+    if (!m_File.open(QIODevice::ReadOnly))
+    {
+        m_LastError = m_File.errorString();
+        return false;
+    }
+
+    // Private so that the file is never written, the handles are read only anyway
+    m_Size = m_File.size();
+    m_Data = m_File.map(0, m_Size, QFileDevice::MapPrivateOption);
+    if (m_Data == nullptr)
+    {
+        // Some file systems cannot be mapped
+        qCDebug(KSTARS_FITS) << "Cannot map" << filename << ":" << m_File.errorString();
+        m_Buffer = m_File.readAll();
+        m_File.close();
+        m_Data = reinterpret_cast<uchar *>(m_Buffer.data());
+        m_Size = m_Buffer.size();
+    }
+
+    return inspect();
+}
+
+bool FITSLoader::open(const QByteArray &buffer)
+{
+    close();
+
+    // Handles are read only, so the buffer is not detached
+    m_Buffer = buffer;
+    m_Data = reinterpret_cast<uchar *>(const_cast<char *>(m_Buffer.constData()));
+    m_Size = m_Buffer.size();
+
+    return inspect();
+}
+
+void FITSLoader::close()
+{
+    // Closing the file unmaps it
+    m_File.close();
+    m_Buffer.clear();
+    m_Data = nullptr;
+    m_Size = 0;
+    m_HandleData = nullptr;
+    m_HandleSize = 0;
+    m_Width = m_Height = 0;
+    m_Depth = 1;
+    m_Compressed = false;
+    m_TileHeight = 1;
+}
+
+fitsfile *FITSLoader::openImage(int *status)
+{
+    if (m_Data == nullptr || m_Size <= 0)
+    {
+        *status = FILE_NOT_OPENED;
+        return nullptr;
+    }
+
+    fitsfile *fptr = nullptr;
+    if (fits_open_memfile(&fptr, "memory", READONLY, &m_HandleData, &m_HandleSize, 0, nullptr, status))
+        return nullptr;
+
+    // fpack leaves the primary HDU empty and compresses the image in an extension
+    for (int hdu = 1; ; hdu++)
+    {
+        if (fits_movabs_hdu(fptr, hdu, nullptr, status))
+            break;
+
+        int naxis = 0;
+        if (fits_get_img_dim(fptr, &naxis, status) == 0 && naxis > 0)
+            return fptr;
+
+        // Not an image, a table for instance
+        *status = 0;
+    }
+
+    int closeStatus = 0;
+    fits_close_file(fptr, &closeStatus);
+    return nullptr;
+}
+
+bool FITSLoader::inspect()
+{
+    // cfitsio keeps these addresses for as long as the handles are open
+    m_HandleData = m_Data;
+    m_HandleSize = static_cast<size_t>(m_Size);
+
+    int status = 0;
+    fitsfile *fptr = openImage(&status);
+    if (fptr == nullptr)
+    {
+        m_LastError = fitsError(status);
+        return false;
+    }
+
+    int bitpix = 0, naxis = 0;
+    long naxes[3] = {0, 0, 1};
+    fits_get_img_param(fptr, 3, &bitpix, &naxis, naxes, &status);
+    m_Compressed = fits_is_compressed_image(fptr, &status);
+    if (m_Compressed)
+    {
+        // Tiles are whole lines unless specified otherwise
+        int tileHeight = 1, keyStatus = 0;
+        if (fits_read_key(fptr, TINT, "ZTILE2", &tileHeight, nullptr, &keyStatus) == 0)
+            m_TileHeight = std::max(1, tileHeight);
+    }
+
+    int closeStatus = 0;
+    fits_close_file(fptr, &closeStatus);
+
+    if (status)
+    {
+        m_LastError = fitsError(status);
+        return false;
+    }
+
+    m_Width = naxes[0];
+    m_Height = naxis > 1 ? naxes[1] : 1;
+    m_Depth = naxis > 2 ? naxes[2] : 1;
+    return true;
+}
+
+QSize FITSLoader::regionSize(const QRect &region, int sampling)
+{
+    sampling = std::max(1, sampling);
+    return QSize((region.width() + sampling - 1) / sampling, (region.height() + sampling - 1) / sampling);
+}
+
+bool FITSLoader::read(int dataType, int bytesPerPixel, int channels, void *target, const QRect &region, int sampling)
+{
+    QRect const image(0, 0, m_Width, m_Height);
+    QRect const area = region.isNull() ? image : region.intersected(image);
+    sampling = std::max(1, sampling);
+    if (m_Data == nullptr || area.isEmpty() || channels < 1 || channels > m_Depth)
+    {
+        m_LastError = QString("Cannot read %1 channels of %2x%3 at %4,%5 from a %6x%7x%8 image")
+                      .arg(channels).arg(area.width()).arg(area.height()).arg(area.left()).arg(area.top())
+                      .arg(m_Width).arg(m_Height).arg(m_Depth);
+        return false;
+    }
+
+    QSize const size = regionSize(area, sampling);
+
+    // Bands of output lines, covering whole tiles of the image so that no tile is decompressed twice
+    int const bandHeight = ((LINES_PER_TASK + m_TileHeight - 1) / m_TileHeight) * m_TileHeight;
+    int const linesPerTask = std::max(1, bandHeight / sampling);
+
+    QVector<int> tasks;
+    for (int first = 0; first < size.height(); first += linesPerTask)
+        tasks.append(first);
+
+    std::atomic<int> failure { 0 };
+    auto const readBand = [&](int const first)
+    {
+        int const last = std::min(size.height(), first + linesPerTask);
+        int status = 0;
+        fitsfile *fptr = openImage(&status);
+
+        for (int channel = 0; fptr != nullptr && status == 0 && channel < channels; channel++)
+        {
+            // cfitsio pixels start at 1 and the last one is included
+            long fpixel[3] = { area.left() + 1, area.top() + first * sampling + 1, channel + 1 };
+            long lpixel[3] = { area.right() + 1, area.top() + (last - 1) * sampling + 1, channel + 1 };
+            long inc[3] = { sampling, sampling, 1 };
+            uint8_t *band = static_cast<uint8_t *>(target) +
+                            (static_cast<size_t>(channel) * size.height() + first) * size.width() * bytesPerPixel;
+            int anynull = 0;
+            fits_read_subset(fptr, dataType, fpixel, lpixel, inc, nullptr, band, &anynull, &status);
+        }
+
+        if (fptr != nullptr)
+        {
+            int closeStatus = 0;
+            fits_close_file(fptr, &closeStatus);
+        }
+        if (status)
+            failure = status;
+    };
+
+    // Types whose size in memory differs from the one cfitsio converts to are read in one band
+    bool const sameSize = dataType == TBYTE || dataType == TUSHORT || dataType == TSHORT || dataType == TFLOAT ||
+                          dataType == TDOUBLE || dataType == TLONGLONG;
+    if (tasks.size() > 1 && fits_is_reentrant() && sameSize)
+        QtConcurrent::blockingMap(tasks, readBand);
+    else if (sameSize)
+    {
+        for (int const first : tasks)
+            readBand(first);
+    }
+    else
+    {
+        int status = 0;
+        fitsfile *fptr = openImage(&status);
+        long fpixel[3] = { area.left() + 1, area.top() + 1, 1 };
+        long lpixel[3] = { area.right() + 1, area.top() + (size.height() - 1) * sampling + 1, channels };
+        long inc[3] = { sampling, sampling, 1 };
+        int anynull = 0;
+        if (fptr != nullptr)
+        {
+            fits_read_subset(fptr, dataType, fpixel, lpixel, inc, nullptr, target, &anynull, &status);
+            int closeStatus = 0;
+            fits_close_file(fptr, &closeStatus);
+        }
+        failure = status;
+    }
+
+    if (failure)
+    {
+        m_LastError = fitsError(failure);
+        return false;
+    }
+    return true;
+}
+
+void FITSLoader::prefetch(const QString &filename)
+{
+    if (filename.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&prefetchMutex);
+        if (prefetching.contains(filename))
+            return;
+        prefetching.insert(filename);
+    }
+
+    QtConcurrent::run(prefetchPool(), [filename]()
+    {
+        QFile file(filename);
+        if (file.open(QIODevice::ReadOnly))
+        {
+            qint64 const size = file.size();
+            if (uchar *data = file.map(0, size))
+            {
+                // Touch each page, the system reads ahead around them
+                uchar volatile sum = 0;
+                for (qint64 offset = 0; offset < size; offset += PREFETCH_STRIDE)
+                    sum += data[offset];
+                file.unmap(data);
+            }
+            else
+            {
+                while (!file.atEnd() && !file.read(PREFETCH_CHUNK).isEmpty())
+                    ;
+            }
+        }
+
+        QMutexLocker locker(&prefetchMutex);
+        prefetching.remove(filename);
+    });
+}
@@ -0,0 +1,123 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <fitsio.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+/**
+ * @class FITSLoader
+ * @short Reads the image of a FITS file or buffer, decoding bands of lines across threads.
+ *
+ * Files are mapped in memory rather than read, and each thread opens its own cfitsio handle on the mapped data to
+ * read a band of lines. Tile compressed images (fpack Rice or GZIP) are decompressed by the threads reading them,
+ * in bands of whole tiles. Reading a region or a decimated preview only decompresses the tiles of the lines it
+ * needs.
+ *
+ * prefetch() reads a file into the system cache in the background, for a viewer to load ahead the frames next to
+ * the one displayed.
+ */
+class FITSLoader
+{
+    public:
+        FITSLoader() = default;
+        ~FITSLoader();
+
+        /**
+         * @brief Map a FITS file, compressed or not.
+         * @return false if the file cannot be read or has no image.
+         */
+        bool open(const QString &filename);
+
+        /** @brief Use a FITS file in memory, which is shared and not copied. */
+        bool open(const QByteArray &buffer);
+
+        /** @brief Release the data. Handles opened on it must be closed first. */
+        void close();
+
+        /**
+         * @brief Open a cfitsio handle on the data, on the HDU of the image. The caller closes it.
+         * @return the handle, or nullptr with @p status set.
+         */
+        fitsfile *openImage(int *status);
+
+        /**
+         * @brief Read pixels of the image, converted to @p dataType, line after line and channel after channel.
+         * @param dataType cfitsio type of the pixels in @p target, TUSHORT for instance
+         * @param bytesPerPixel size of the pixels in @p target
+         * @param channels number of channels to read
+         * @param target buffer for the pixels, large enough for the size returned by regionSize()
+         * @param region part of the image to read, the whole image if null
+         * @param sampling read one pixel out of @p sampling along each axis
+         * @return true on success, false with lastError() set otherwise.
+         */
+        bool read(int dataType, int bytesPerPixel, int channels, void *target, const QRect &region = QRect(),
+                  int sampling = 1);
+
+        /** @return dimensions of the pixels read from @p region with @p sampling. */
+        static QSize regionSize(const QRect &region, int sampling);
+
+        /** @brief Read @p filename into the system cache in the background, unless it is being read already. */
+        static void prefetch(const QString &filename);
+
+        int width() const
+        {
+            return m_Width;
+        }
+        int height() const
+        {
+            return m_Height;
+        }
+        /** @return number of planes of the image, 1 for a 2D image. */
+        int depth() const
+        {
+            return m_Depth;
+        }
+        /** @return true if the image is tile compressed. */
+        bool isCompressed() const
+        {
+            return m_Compressed;
+        }
+        /** @return size of the data in bytes, compressed or not. */
+        qint64 size() const
+        {
+            return m_Size;
+        }
+        const QString &lastError() const
+        {
+            return m_LastError;
+        }
+
+        /** @brief Lines of pixels read by each task, rounded to whole tiles for compressed images. */
+        static constexpr int LINES_PER_TASK { 256 };
+
+    private:
+        /** Open a handle on the data and find the dimensions and tiles of the image */
+        bool inspect();
+
+        // Mapped file, or buffer when mapping is not possible
+        QFile m_File;
+        QByteArray m_Buffer;
+        uchar *m_Data { nullptr };
+        qint64 m_Size { 0 };
+        // cfitsio keeps the addresses of the location and size of the data of its memory files
+        void *m_HandleData { nullptr };
+        size_t m_HandleSize { 0 };
+
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_Depth { 1 };
+        bool m_Compressed { false };
+        // Lines of each tile of a compressed image
+        int m_TileHeight { 1 };
+        QString m_LastError;
+};
@@ -14,6 +14,8 @@
 #include <QHash>
 #include <QStandardItem>
 #include <QFuture>
+#include <QPair>
+#include <QVector>
 
 class FITSData;
 
@@ -80,6 +82,12 @@ class FITSStarDetector : public QObject
          */
         //void configure(QStandardItemModel const &settings);
 
+        /** @brief Address and capacity in bytes of each buffer the detector keeps from one detection to the next. */
+        virtual QVector<QPair<void const *, size_t>> reusedBuffers() const
+        {
+            return {};
+        }
+
     protected:
         FITSData *m_ImageData {nullptr};
         QVariantMap m_Settings;
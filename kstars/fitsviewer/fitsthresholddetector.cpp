@@ -16,6 +16,11 @@
 #include "fitsthresholddetector.h"
 #include "fitsdata.h"
 
+QVector<QPair<void const *, size_t>> FITSThresholdDetector::reusedBuffers() const
+{
+    return { qMakePair<void const *, size_t>(m_SubPixels.data(), m_SubPixels.capacity()) };
+}
+
 //void FITSThresholdDetector::configure(const QString &setting, const QVariant &value)
 //{
 //    if (!setting.compare("THRESHOLD_PERCENTAGE", Qt::CaseInsensitive))
@@ -57,7 +62,7 @@ QFuture<bool> FITSThresholdDetector::findSources(QRect const &boundary)
 }
 
 template <typename T>
-bool FITSThresholdDetector::findOneStar(const QRect &boundary) const
+bool FITSThresholdDetector::findOneStar(const QRect &boundary)
 {
     FITSImage::Statistic const &stats = m_ImageData->getStatistics();
 
@@ -156,15 +161,17 @@ bool FITSThresholdDetector::findOneStar(const QRect &boundary) const
     double rightEdge = center->x + center->width / 2.0;
     double leftEdge  = center->x - center->width / 2.0;
 
-    QVector<double> subPixels;
-    subPixels.reserve(center->width / resolution);
+    // Reused by the next detections, with room for the rounding of the steps
+    int const maxSubPixels = center->width / resolution + 2;
+    double * const subPixels = reinterpret_cast<double *>(m_SubPixels.allocate(maxSubPixels * sizeof(double)));
+    int count = 0;
 
-    for (double x = leftEdge; x <= rightEdge; x += resolution)
+    for (double x = leftEdge; x <= rightEdge && count < maxSubPixels; x += resolution)
     {
         //subPixels[x] = resolution * (image_buffer[static_cast<int>(floor(x)) + cen_y * stats.width] - min);
         double slice = resolution * (buffer[static_cast<int>(floor(x)) + cen_y * stats.width] - min);
         FSum += slice;
-        subPixels.append(slice);
+        subPixels[count++] = slice;
     }
 
     // Half flux
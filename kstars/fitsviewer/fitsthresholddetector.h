@@ -12,6 +12,7 @@
 #define FITSTHRESHOLDDETECTOR_H
 
 #include "fitsstardetector.h"
+#include "framebufferpool.h"
 
 class FITSThresholdDetector: public FITSStarDetector
 {
@@ -26,6 +27,9 @@ class FITSThresholdDetector: public FITSStarDetector
          */
         QFuture<bool> findSources(QRect const &boundary = QRect()) override;
 
+        /** @see FITSStarDetector::reusedBuffers(). */
+        QVector<QPair<void const *, size_t>> reusedBuffers() const override;
+
         /** @brief Configure the detection method.
          * @see FITSStarDetector::configure().
          * @note Parameter "threshold" defaults to THRESHOLD_PERCENTAGE of the mean pixel value of the frame.
@@ -44,7 +48,11 @@ class FITSThresholdDetector: public FITSStarDetector
          * @see FITSGradientDetector::findSources.
          */
         template <typename T>
-        bool findOneStar(const QRect &boundary) const;
+        bool findOneStar(const QRect &boundary);
+
+    private:
+        /** Slices of the profile of the star, reused by the next detection */
+        FrameBuffer m_SubPixels;
 };
 
 #endif // FITSTHRESHOLDDETECTOR_H
@@ -38,6 +38,8 @@
 #include <QGestureEvent>
 #include <QMutexLocker>
 
+#include <cmath>
+
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -93,7 +95,7 @@ void FITSView::doStretch(QImage *outputImage)
                     m_ImageData->channels(), m_ImageData->dataType());
 
     StretchParams tempParams;
-    if (!stretchImage)
+    if (!stretchImage || m_Prestretched)
         tempParams = StretchParams();  // Keeping it linear
     else if (autoStretch)
     {
@@ -341,6 +343,7 @@ void FITSView::loadFile(const QString &inFilename)
         filterStack.push(filter);
 
     m_ImageData.reset(new FITSData(mode), &QObject::deleteLater);
+    m_Prestretched = false;
 
     if (setBayerParams)
         m_ImageData->setBayerParams(&param);
@@ -364,6 +367,18 @@ void FITSView::clearData()
 }
 
 bool FITSView::loadData(const QSharedPointer<FITSData> &data)
+{
+    m_Prestretched = false;
+    return setData(data);
+}
+
+bool FITSView::loadPreview(const QSharedPointer<FITSData> &data)
+{
+    m_Prestretched = true;
+    return setData(data);
+}
+
+bool FITSView::setData(const QSharedPointer<FITSData> &data)
 {
     if (floatingToolBar != nullptr)
     {
@@ -401,7 +416,7 @@ bool FITSView::processData()
     {
         if(m_ImageData)
         {
-            m_ImageData->makeRoiBuffer(roi);
+            m_ImageData->calculateRoiStats(roi);
         }
     });
     currentWidth = m_ImageData->width();
@@ -1431,7 +1446,7 @@ void FITSView::drawEQGrid(QPainter * painter, double scale)
 
         painter->setPen(QPen(Qt::yellow));
 
-        QPointF pixelPoint, imagePoint, pPoint;
+        QPointF imagePoint, pPoint;
 
         //This section draws the RA Gridlines
 
@@ -1446,15 +1461,16 @@ void FITSView::drawEQGrid(QPainter * painter, double scale)
             double increment = std::abs((maxDec - minDec) /
                                         100.0); //This will determine how many points to use to create the RA Line
 
+            QVector<QPointF> coords, pixels;
             for (double targetDec = minDec; targetDec <= maxDec; targetDec += increment)
+                coords.append(QPointF(target, targetDec));
+
+            // The points of a line are converted at once, those that are not in the projection are NaN
+            m_ImageData->wcsToPixels(coords, pixels);
+            for (const auto &pixel : pixels)
             {
-                SkyPoint pointToGet(target / 15.0, targetDec);
-                bool inImage = m_ImageData->wcsToPixel(pointToGet, pixelPoint, imagePoint);
-                if (inImage)
-                {
-                    QPointF pt(pixelPoint.x() * scale, pixelPoint.y() * scale);
-                    eqGridPoints.append(pt);
-                }
+                if (std::isfinite(pixel.x()) && std::isfinite(pixel.y()))
+                    eqGridPoints.append(QPointF(pixel.x() * scale, pixel.y() * scale));
             }
 
             if (eqGridPoints.count() > 1)
@@ -1482,15 +1498,15 @@ void FITSView::drawEQGrid(QPainter * painter, double scale)
                                         100.0); //This will determine how many points to use to create the Dec Line
             double target    = targetDec * decConvert;
 
+            QVector<QPointF> coords, pixels;
             for (double targetRA = minRA; targetRA <= maxRA; targetRA += increment)
+                coords.append(QPointF(targetRA, target));
+
+            m_ImageData->wcsToPixels(coords, pixels);
+            for (const auto &pixel : pixels)
             {
-                SkyPoint pointToGet(targetRA / 15, targetDec * decConvert);
-                bool inImage = m_ImageData->wcsToPixel(pointToGet, pixelPoint, imagePoint);
-                if (inImage)
-                {
-                    QPointF pt(pixelPoint.x() * scale, pixelPoint.y() * scale);
-                    eqGridPoints.append(pt);
-                }
+                if (std::isfinite(pixel.x()) && std::isfinite(pixel.y()))
+                    eqGridPoints.append(QPointF(pixel.x() * scale, pixel.y() * scale));
             }
             if (eqGridPoints.count() > 1)
             {
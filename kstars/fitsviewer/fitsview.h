@@ -69,6 +69,13 @@ class FITSView : public QScrollArea
          */
         bool loadData(const QSharedPointer<FITSData> &data);
 
+        /**
+         * @brief loadPreview Displays an 8-bit preview that is already stretched, such as the ones of the PreviewCache.
+         * The preview is shown linearly, and the stretch settings of the view are kept for the next frame.
+         * @param data pointer to FITSData objects
+         */
+        bool loadPreview(const QSharedPointer<FITSData> &data);
+
         /**
          * @brief clearView Reset view to NO IMAGE
          */
@@ -352,6 +359,7 @@ class FITSView : public QScrollArea
         uint32_t m_ImageRoiBufferSize { 0 };
 
     private:
+        bool setData(const QSharedPointer<FITSData> &data);
         bool processData();
         void doStretch(QImage *outputImage);
         double scaleSize(double size);
@@ -403,6 +411,9 @@ class FITSView : public QScrollArea
         // Params for stretching image.
         StretchParams stretchParams;
 
+        // Whether the displayed data is a preview that was stretched already.
+        bool m_Prestretched { false };
+
         // Resolution for display. Sampling=2 means display every other sample.
         uint8_t m_PreviewSampling { 1 };
         bool m_StretchingInProgress { false};
@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "framebufferpool.h"
+
+#include "ksutils.h"
+#include "Options.h"
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QTimer>
+
+#include <algorithm>
+
+#include <fits_debug.h>
+
+FrameBufferPool *FrameBufferPool::Instance()
+{
+    // Not destroyed, frames may still be released while the application exits
+    static FrameBufferPool *pool = new FrameBufferPool();
+    return pool;
+}
+
+FrameBufferPool::FrameBufferPool()
+{
+    m_Clock.start();
+    m_Budget = configuredBudget();
+
+    if (QCoreApplication::instance() == nullptr)
+        return;
+
+    QTimer *trimTimer = new QTimer(this);
+    trimTimer->setInterval(IDLE_TIMEOUT / 4);
+    connect(trimTimer, &QTimer::timeout, this, [this]()
+    {
+        trimIdle(IDLE_TIMEOUT);
+    });
+    // The pool may be created by a worker thread, idle buffers are trimmed from the thread of the application
+    moveToThread(QCoreApplication::instance()->thread());
+    QMetaObject::invokeMethod(trimTimer, "start", Qt::QueuedConnection);
+
+    connect(Options::self(), &KCoreConfigSkeleton::configChanged, this, [this]()
+    {
+        setBudget(configuredBudget());
+    });
+}
+
+size_t FrameBufferPool::configuredBudget()
+{
+    size_t const MB = 1024 * 1024;
+    if (Options::frameBufferPoolBudget() > 0)
+        return Options::frameBufferPoolBudget() * MB;
+
+    // A sixteenth of the memory, 512 MB with 8 GB
+    double const memory = KSUtils::getTotalRAM();
+    if (memory <= 0)
+        return DEFAULT_BUDGET;
+    return std::min<size_t>(std::max<size_t>(memory / 16, 128 * MB), 2048 * MB);
+}
+
+size_t FrameBufferPool::bucketSize(size_t size)
+{
+    if (size < MINIMUM_SIZE)
+        return size;
+
+    // Four buckets between the power of two below the size and the one above
+    size_t power = MINIMUM_SIZE;
+    while (power * 2 < size)
+        power *= 2;
+    size_t const step = power / 4;
+    return (size + step - 1) / step * step;
+}
+
+uint8_t *FrameBufferPool::acquire(size_t size)
+{
+    if (size < MINIMUM_SIZE)
+        return new uint8_t[std::max<size_t>(size, 1)];
+
+    size_t const bucket = bucketSize(size);
+    QMutexLocker locker(&m_Mutex);
+    m_Statistics.requests++;
+
+    // The buffer released last is the most likely to be still in memory
+    uint8_t *buffer = nullptr;
+    for (int i = m_Idle.size() - 1; i >= 0; i--)
+    {
+        if (m_Idle[i].size == bucket)
+        {
+            buffer = m_Idle.takeAt(i).data;
+            m_Statistics.idle -= bucket;
+            m_Statistics.hits++;
+            break;
+        }
+    }
+
+    if (buffer == nullptr)
+        buffer = new uint8_t[bucket];
+
+    m_Used.insert(buffer, bucket);
+    m_Statistics.used += bucket;
+    m_Statistics.peakUsed = std::max(m_Statistics.peakUsed, m_Statistics.used);
+    m_Statistics.peakHeld = std::max(m_Statistics.peakHeld, m_Statistics.used + m_Statistics.idle);
+    return buffer;
+}
+
+void FrameBufferPool::release(uint8_t *buffer)
+{
+    if (buffer == nullptr)
+        return;
+
+    QMutexLocker locker(&m_Mutex);
+    auto const used = m_Used.find(buffer);
+    if (used == m_Used.end())
+    {
+        locker.unlock();
+        delete[] buffer;
+        return;
+    }
+
+    size_t const size = used.value();
+    m_Used.erase(used);
+    m_Statistics.used -= size;
+
+    // Keeping it would free all the other idle buffers
+    if (size > m_Budget)
+    {
+        if (m_Statistics.discards++ == 0)
+            qCDebug(KSTARS_FITS) << "Frame buffers of" << size << "bytes exceed the pool budget of" << m_Budget
+                                 << "bytes and are not reused";
+        locker.unlock();
+        delete[] buffer;
+        return;
+    }
+
+    m_Idle.append({size, buffer, m_Clock.elapsed()});
+    m_Statistics.idle += size;
+    evict();
+}
+
+void FrameBufferPool::evict()
+{
+    size_t freed = 0;
+    while (!m_Idle.isEmpty() && m_Statistics.idle > m_Budget)
+    {
+        Idle const oldest = m_Idle.takeFirst();
+        m_Statistics.idle -= oldest.size;
+        m_Statistics.evictions++;
+        freed += oldest.size;
+        delete[] oldest.data;
+    }
+
+    if (freed > 0)
+        qCDebug(KSTARS_FITS) << "Frame buffer pool freed" << freed << "bytes of idle buffers to stay within"
+                             << m_Budget << "bytes";
+}
+
+void FrameBufferPool::setBudget(size_t budget)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Budget = budget;
+    evict();
+}
+
+size_t FrameBufferPool::budget() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Budget;
+}
+
+void FrameBufferPool::trim()
+{
+    QMutexLocker locker(&m_Mutex);
+    for (Idle const &idle : m_Idle)
+        delete[] idle.data;
+    m_Statistics.trims += m_Idle.size();
+    m_Statistics.idle = 0;
+    m_Idle.clear();
+}
+
+void FrameBufferPool::trimIdle(qint64 age)
+{
+    QMutexLocker locker(&m_Mutex);
+    qint64 const now = m_Clock.elapsed();
+    // Idle buffers are in the order they were released
+    while (!m_Idle.isEmpty() && now - m_Idle.first().released >= age)
+    {
+        Idle const oldest = m_Idle.takeFirst();
+        m_Statistics.idle -= oldest.size;
+        m_Statistics.trims++;
+        delete[] oldest.data;
+    }
+}
+
+FrameBufferPool::Statistics FrameBufferPool::statistics() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Statistics;
+}
+
+void FrameBufferPool::resetStatistics()
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Statistics.requests = m_Statistics.hits = m_Statistics.evictions = m_Statistics.discards = m_Statistics.trims = 0;
+    m_Statistics.peakUsed = m_Statistics.used;
+    m_Statistics.peakHeld = m_Statistics.used + m_Statistics.idle;
+}
+
+uint8_t *FrameBuffer::allocate(size_t size)
+{
+    if (m_Data == nullptr || size > m_Capacity)
+    {
+        release();
+        m_Data = FrameBufferPool::Instance()->acquire(size);
+        m_Capacity = FrameBufferPool::bucketSize(size);
+    }
+    m_Size = size;
+    return m_Data;
+}
+
+void FrameBuffer::release()
+{
+    FrameBufferPool::Instance()->release(m_Data);
+    m_Data = nullptr;
+    m_Size = m_Capacity = 0;
+}
@@ -0,0 +1,192 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class FrameBufferPool
+ * @short Recycles the large buffers of frames, instead of returning them to the heap after each frame.
+ *
+ * Capture, guide and focus loops allocate buffers of the same few sizes over and over, for the pixels of the frames
+ * and for the temporaries of debayering, rotation or star detection. Freeing them each time fragments the heap and
+ * grows the memory used by the process. Released buffers are kept instead, and handed out again for requests of a
+ * similar size.
+ *
+ * Sizes are rounded up to buckets, four between consecutive powers of two, so that less than a quarter of a buffer
+ * goes unused. The budget limits the idle buffers the pool keeps, not those in use, which are never refused: the
+ * idle buffers released the longest ago are freed to stay within it, and a buffer larger than the budget is freed
+ * when released. Idle buffers not reused for IDLE_TIMEOUT are freed as well, so the memory goes back to the system
+ * once the loops stop. Requests smaller than MINIMUM_SIZE are not pooled.
+ *
+ * The budget is the FrameBufferPoolBudget option, or a share of the physical memory when it is 0.
+ *
+ * The pool is thread-safe.
+ */
+class FrameBufferPool : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Statistics
+        {
+            /// Buffers requested, and those handed out again from the idle ones
+            quint64 requests { 0 };
+            quint64 hits { 0 };
+            /// Idle buffers freed to stay within the budget, released buffers freed as larger than the budget,
+            /// and idle buffers freed as unused for too long or trimmed
+            quint64 evictions { 0 };
+            quint64 discards { 0 };
+            quint64 trims { 0 };
+            /// Bytes of the buffers in use and of the idle ones
+            size_t used { 0 };
+            size_t idle { 0 };
+            /// Most bytes in use, and held in total, at once
+            size_t peakUsed { 0 };
+            size_t peakHeld { 0 };
+        };
+
+        static FrameBufferPool *Instance();
+
+        /**
+         * @brief Get a buffer of at least @p size bytes, its content undefined.
+         * @note Throws std::bad_alloc like new when memory is exhausted.
+         */
+        uint8_t *acquire(size_t size);
+
+        /**
+         * @brief Give a buffer back to the pool. Buffers not acquired from the pool, such as small ones, are deleted.
+         * @param buffer buffer to release, nullptr is ignored.
+         */
+        void release(uint8_t *buffer);
+
+        /** @brief Bytes of idle buffers the pool may keep. */
+        void setBudget(size_t budget);
+        size_t budget() const;
+        /** @return budget set by the options, scaled to the physical memory unless set explicitly. */
+        static size_t configuredBudget();
+
+        /** @brief Free all idle buffers, when memory runs low for instance. */
+        void trim();
+        /** @brief Free the idle buffers released at least @p age milliseconds ago. */
+        void trimIdle(qint64 age);
+
+        Statistics statistics() const;
+        /** @brief Restart the counts and set the peaks to the current usage. */
+        void resetStatistics();
+
+        /** @return size of the buffers handed out for requests of @p size bytes. */
+        static size_t bucketSize(size_t size);
+
+        /** @brief Requests smaller than this many bytes are not pooled. */
+        static constexpr size_t MINIMUM_SIZE { 64 * 1024 };
+        /** @brief Budget when the physical memory is not known, enough for a few large frames and their temporaries. */
+        static constexpr size_t DEFAULT_BUDGET { 512 * 1024 * 1024 };
+        /** @brief Milliseconds after which idle buffers are freed. */
+        static constexpr qint64 IDLE_TIMEOUT { 2 * 60 * 1000 };
+
+    private:
+        FrameBufferPool();
+
+        struct Idle
+        {
+            size_t size;
+            uint8_t *data;
+            qint64 released;
+        };
+
+        /** Free the idle buffers released the longest ago until they fit the budget */
+        void evict();
+
+        mutable QMutex m_Mutex;
+        size_t m_Budget { DEFAULT_BUDGET };
+        // Time of the releases
+        QElapsedTimer m_Clock;
+        // Size of the buffers in use, and idle buffers in the order they were released
+        QHash<uint8_t *, size_t> m_Used;
+        QList<Idle> m_Idle;
+        Statistics m_Statistics;
+};
+
+/**
+ * @class FrameBuffer
+ * @short A buffer of the FrameBufferPool, given back when destroyed or reallocated.
+ */
+class FrameBuffer
+{
+    public:
+        FrameBuffer() = default;
+        explicit FrameBuffer(size_t size)
+        {
+            allocate(size);
+        }
+        ~FrameBuffer()
+        {
+            release();
+        }
+
+        FrameBuffer(const FrameBuffer &) = delete;
+        FrameBuffer &operator=(const FrameBuffer &) = delete;
+        FrameBuffer(FrameBuffer &&other) noexcept : m_Data(other.m_Data), m_Size(other.m_Size),
+            m_Capacity(other.m_Capacity)
+        {
+            other.m_Data = nullptr;
+            other.m_Size = other.m_Capacity = 0;
+        }
+        FrameBuffer &operator=(FrameBuffer &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_Data = other.m_Data;
+                m_Size = other.m_Size;
+                m_Capacity = other.m_Capacity;
+                other.m_Data = nullptr;
+                other.m_Size = other.m_Capacity = 0;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Make room for @p size bytes. The content is not kept when a larger buffer is needed.
+         * @return the buffer.
+         */
+        uint8_t *allocate(size_t size);
+        /** @brief Give the buffer back to the pool. */
+        void release();
+
+        uint8_t *data() const
+        {
+            return m_Data;
+        }
+        template <typename T> T *data() const
+        {
+            return reinterpret_cast<T *>(m_Data);
+        }
+        /** @return bytes requested last. */
+        size_t size() const
+        {
+            return m_Size;
+        }
+        /** @return bytes the buffer can hold without being reallocated. */
+        size_t capacity() const
+        {
+            return m_Capacity;
+        }
+
+    private:
+        uint8_t *m_Data { nullptr };
+        size_t m_Size { 0 };
+        size_t m_Capacity { 0 };
+};
@@ -0,0 +1,287 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "previewcache.h"
+
+#include "fitsdata.h"
+#include "stretch.h"
+#include "kspaths.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include <fits_debug.h>
+
+namespace
+{
+// Header of the preview files
+constexpr quint32 PREVIEW_MAGIC = 0x4b535056;
+constexpr quint16 PREVIEW_VERSION = 1;
+constexpr int PREVIEW_QUALITY = 85;
+// Kilobytes of JPEG previews kept in memory
+constexpr int MEMORY_CACHE_SIZE = 32 * 1024;
+}
+
+PreviewCache *PreviewCache::_PreviewCache = nullptr;
+
+PreviewCache *PreviewCache::Instance()
+{
+    if (_PreviewCache == nullptr)
+        _PreviewCache = new PreviewCache(QDir(KSPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("previews"));
+
+    return _PreviewCache;
+}
+
+PreviewCache::PreviewCache(const QString &directory, QObject *parent) : QObject(parent), m_Directory(directory)
+{
+    QDir().mkpath(m_Directory);
+    m_Entries.setMaxCost(MEMORY_CACHE_SIZE);
+    m_Pool.setMaxThreadCount(1);
+    QtConcurrent::run(&m_Pool, [this]()
+    {
+        prune();
+    });
+}
+
+PreviewCache::~PreviewCache()
+{
+    m_Pool.clear();
+    m_Pool.waitForDone();
+}
+
+QImage PreviewCache::Entry::toImage() const
+{
+    return QImage::fromData(image, "JPG");
+}
+
+QSharedPointer<FITSData> PreviewCache::Entry::toFITSData() const
+{
+    QSharedPointer<FITSData> data(new FITSData(), &QObject::deleteLater);
+    if (image.isEmpty() || !data->loadFromBuffer(image, "jpg"))
+        return QSharedPointer<FITSData>();
+    return data;
+}
+
+void PreviewCache::add(const QSharedPointer<FITSData> &data)
+{
+    if (data.isNull() || data->filename().isEmpty() || m_Pending.contains(data->filename()))
+        return;
+
+    const QFileInfo info(data->filename());
+    if (!info.exists())
+        return;
+
+    Entry entry;
+    entry.filename = data->filename();
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+    entry.size = info.size();
+    // Keep what the capture computed, searching stars again would take longer than the preview itself
+    if (data->areStarsSearched())
+    {
+        entry.hfr = data->getHFR(HFR_AVERAGE);
+        entry.stars = data->getDetectedStars();
+    }
+    entry.median = data->getMedian();
+
+    m_Pending.insert(entry.filename);
+    QtConcurrent::run(&m_Pool, [this, data, entry]() mutable
+    {
+        const bool built = buildPreview(*data, entry) && writeEntry(entry);
+        // The data is released by the main thread
+        QMetaObject::invokeMethod(this, [this, entry, built, data = std::move(data)]()
+        {
+            m_Pending.remove(entry.filename);
+            if (built)
+            {
+                insert(entry);
+                emit ready(entry.filename);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PreviewCache::request(const QString &filename)
+{
+    if (filename.isEmpty() || m_Pending.contains(filename))
+        return;
+
+    Entry entry;
+    if (find(filename, entry))
+    {
+        emit ready(filename);
+        return;
+    }
+
+    m_Pending.insert(filename);
+    QtConcurrent::run(&m_Pool, [this, filename]()
+    {
+        Entry entry;
+        entry.filename = filename;
+        const QFileInfo info(filename);
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        entry.size = info.size();
+
+        bool built = false;
+        // Only the pixels of the preview are read and decompressed
+        FITSData data;
+        data.setReadRegion(QRect(), PREVIEW_SIZE);
+        if (info.exists() && data.loadFromFile(filename).result())
+        {
+            entry.median = data.getMedian();
+            built = buildPreview(data, entry) && writeEntry(entry);
+        }
+        else
+            qCWarning(KSTARS_FITS) << "Failed to load" << filename << "for its preview.";
+
+        QMetaObject::invokeMethod(this, [this, entry, built]()
+        {
+            m_Pending.remove(entry.filename);
+            if (built)
+            {
+                insert(entry);
+                emit ready(entry.filename);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool PreviewCache::find(const QString &filename, Entry &entry)
+{
+    const QFileInfo info(filename);
+    if (filename.isEmpty() || !info.exists())
+        return false;
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    if (const Entry *cached = m_Entries.object(filename))
+    {
+        if (cached->modified == modified && cached->size == info.size())
+        {
+            entry = *cached;
+            return true;
+        }
+        m_Entries.remove(filename);
+    }
+
+    Entry stored;
+    if (!readEntry(filename, stored))
+        return false;
+
+    // The frame was overwritten or edited since
+    if (stored.modified != modified || stored.size != info.size())
+    {
+        QFile::remove(entryPath(filename));
+        return false;
+    }
+
+    insert(stored);
+    entry = stored;
+    return true;
+}
+
+QString PreviewCache::entryPath(const QString &filename) const
+{
+    const QByteArray key = QCryptographicHash::hash(QFileInfo(filename).absoluteFilePath().toUtf8(),
+                           QCryptographicHash::Sha1).toHex();
+    return QDir(m_Directory).filePath(QString::fromLatin1(key) + ".preview");
+}
+
+bool PreviewCache::readEntry(const QString &filename, Entry &entry) const
+{
+    QFile file(entryPath(filename));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != PREVIEW_MAGIC || version != PREVIEW_VERSION)
+        return false;
+
+    in >> entry.filename >> entry.modified >> entry.size >> entry.width >> entry.height
+       >> entry.hfr >> entry.stars >> entry.median >> entry.image;
+
+    // Two paths may share a hash, however unlikely
+    return in.status() == QDataStream::Ok && entry.filename == filename;
+}
+
+bool PreviewCache::writeEntry(const Entry &entry) const
+{
+    QSaveFile file(entryPath(entry.filename));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(KSTARS_FITS) << "Failed to save the preview of" << entry.filename << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << PREVIEW_MAGIC << PREVIEW_VERSION;
+    out << entry.filename << entry.modified << entry.size << entry.width << entry.height
+        << entry.hfr << entry.stars << entry.median << entry.image;
+
+    return file.commit();
+}
+
+void PreviewCache::insert(const Entry &entry)
+{
+    m_Entries.insert(entry.filename, new Entry(entry), std::max(1, entry.image.size() / 1024));
+}
+
+void PreviewCache::prune() const
+{
+    // Newest first
+    const QFileInfoList previews = QDir(m_Directory).entryInfoList(QStringList() << "*.preview", QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const auto &preview : previews)
+    {
+        total += preview.size();
+        if (total > MAXIMUM_DISK_SIZE)
+            QFile::remove(preview.absoluteFilePath());
+    }
+}
+
+bool PreviewCache::buildPreview(const FITSData &data, Entry &entry)
+{
+    const int width = data.width();
+    const int height = data.height();
+    if (width == 0 || height == 0 || data.getImageBuffer() == nullptr)
+        return false;
+
+    // Dimensions of the frame rather than of the pixels read
+    QVariant value;
+    entry.width = data.getRecordValue("NAXIS1", value) ? value.toInt() : width;
+    entry.height = data.getRecordValue("NAXIS2", value) ? value.toInt() : height;
+
+    // Stretch every few pixels, as the view does for large images
+    const int sampling = std::max(1, (std::max(width, height) + PREVIEW_SIZE - 1) / PREVIEW_SIZE);
+    QImage image((width + sampling - 1) / sampling, (height + sampling - 1) / sampling,
+                 data.channels() == 1 ? QImage::Format_Indexed8 : QImage::Format_RGB32);
+    if (data.channels() == 1)
+    {
+        image.setColorCount(256);
+        for (int i = 0; i < 256; i++)
+            image.setColor(i, qRgb(i, i, i));
+    }
+
+    Stretch stretch(width, height, data.channels(), data.dataType());
+    stretch.setParams(stretch.computeParams(data.getImageBuffer()));
+    stretch.run(data.getImageBuffer(), &image, sampling);
+
+    if (data.channels() == 1)
+        image = image.convertToFormat(QImage::Format_Grayscale8);
+
+    entry.image.clear();
+    QBuffer buffer(&entry.image);
+    buffer.open(QIODevice::WriteOnly);
+    return image.save(&buffer, "JPG", PREVIEW_QUALITY);
+}
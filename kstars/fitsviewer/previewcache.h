@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+class FITSData;
+
+/**
+ * @class PreviewCache
+ * @short Downscaled and stretched previews of captured frames, with a few of their statistics.
+ *
+ * Previews are built in the background, from the data of a frame just captured or by loading a frame from disk,
+ * and saved as JPEG with the statistics in a cache directory, keyed by the path of the frame. An entry is only used
+ * while the modification time and the size of the frame are unchanged, so that browsing the capture history or
+ * the Analyze captures does not read, debayer and stretch full resolution frames again.
+ */
+class PreviewCache : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @brief The preview of a frame. */
+        struct Entry
+        {
+            QString filename;
+            qint64 modified { 0 };
+            qint64 size { 0 };
+            /// Dimensions of the frame
+            int width { 0 };
+            int height { 0 };
+            /// Statistics of the frame, negative when unknown
+            double hfr { -1 };
+            int stars { -1 };
+            double median { -1 };
+            /// Stretched preview, encoded as JPEG
+            QByteArray image;
+
+            /** @return the preview decoded. */
+            QImage toImage() const;
+            /** @return the preview as 8-bit data, for FITSView::loadPreview, or null if it cannot be decoded. */
+            QSharedPointer<FITSData> toFITSData() const;
+        };
+
+        static PreviewCache *Instance();
+
+        /** @param directory folder where previews are saved. */
+        explicit PreviewCache(const QString &directory, QObject *parent = nullptr);
+        ~PreviewCache() override;
+
+        /**
+         * @brief Build the preview of a frame that was just captured and saved. The statistics already computed on
+         * @p data are kept, stars are not searched for.
+         */
+        void add(const QSharedPointer<FITSData> &data);
+
+        /** @brief Build the preview of a frame from disk, unless it is cached. ready() is emitted once available. */
+        void request(const QString &filename);
+
+        /**
+         * @brief Look up the preview of a frame in memory, then on disk.
+         * @return true if a preview matching the current state of the file was found.
+         */
+        bool find(const QString &filename, Entry &entry);
+
+        /** @brief Longest side of the previews, in pixels. */
+        static constexpr int PREVIEW_SIZE { 1280 };
+        /** @brief Size of the cache directory, in bytes, above which the oldest previews are removed. */
+        static constexpr qint64 MAXIMUM_DISK_SIZE { 256 * 1024 * 1024 };
+
+    signals:
+        /** @brief The preview of @p filename was built and can be found. */
+        void ready(const QString &filename);
+
+    private:
+        QString entryPath(const QString &filename) const;
+        bool readEntry(const QString &filename, Entry &entry) const;
+        bool writeEntry(const Entry &entry) const;
+        void insert(const Entry &entry);
+        void prune() const;
+
+        /** Stretch and encode the preview of @p data into @p entry */
+        static bool buildPreview(const FITSData &data, Entry &entry);
+
+        static PreviewCache *_PreviewCache;
+
+        QString m_Directory;
+        // Recently used previews, the cost being the size of the JPEG in kilobytes
+        QCache<QString, Entry> m_Entries;
+        // Frames whose preview is being built
+        QSet<QString> m_Pending;
+        // Previews are built one at a time, not to compete with the capture
+        QThreadPool m_Pool;
+};
@@ -0,0 +1,354 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "wcsgrid.h"
+
+#ifdef HAVE_WCSLIB
+
+#include <QtConcurrent>
+
+#include <wcs.h>
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+constexpr double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+// Newton steps to invert the interpolation, a couple are enough within a cell
+constexpr int MAXIMUM_ITERATIONS = 8;
+
+/* Run convert(wcs, first, last) over count points, in tasks of WCSGrid::POINTS_PER_TASK points. wcslib functions
+ * are not reentrant on the same wcsprm, so each task converts with its own copy.
+ */
+template <typename Convert>
+bool convertInTasks(wcsprm *wcs, int count, Convert convert)
+{
+    if (count <= WCSGrid::POINTS_PER_TASK)
+        return convert(wcs, 0, count);
+
+    QVector<int> tasks;
+    for (int first = 0; first < count; first += WCSGrid::POINTS_PER_TASK)
+        tasks.append(first);
+
+    std::atomic<int> failures { 0 };
+    QtConcurrent::blockingMap(tasks, [&](int const first)
+    {
+        int const last = std::min(count, first + WCSGrid::POINTS_PER_TASK);
+        wcsprm copy;
+        copy.flag = -1;
+        if (wcssub(1, wcs, nullptr, nullptr, &copy) != 0 || wcsset(&copy) != 0)
+        {
+            // Let the conversion fill the points of the task with NaN
+            convert(nullptr, first, last);
+            failures++;
+        }
+        else if (!convert(&copy, first, last))
+            failures++;
+        wcsfree(&copy);
+    });
+    return failures == 0;
+}
+}
+
+bool WCSGrid::pixelToWorld(wcsprm *wcs, const QVector<QPointF> &pixels, QVector<QPointF> &world)
+{
+    world.resize(pixels.size());
+    if (pixels.isEmpty())
+        return wcs != nullptr;
+
+    QPointF * const output = world.data();
+    return convertInTasks(wcs, pixels.size(), [&pixels, output](wcsprm * handle, int first, int last)
+    {
+        int const count = last - first;
+        std::vector<double> pixcrd(2 * count), imgcrd(2 * count), worldcrd(2 * count), phi(count), theta(count);
+        std::vector<int> stat(count);
+        for (int i = 0; i < count; i++)
+        {
+            pixcrd[2 * i] = pixels[first + i].x();
+            pixcrd[2 * i + 1] = pixels[first + i].y();
+        }
+
+        // Invalid points are flagged in stat, any other error fails the whole task
+        int const status = handle == nullptr ? -1 : wcsp2s(handle, count, 2, pixcrd.data(), imgcrd.data(), phi.data(),
+                           theta.data(), worldcrd.data(), stat.data());
+        bool const converted = status == 0 || status == WCSERR_BAD_PIX;
+        for (int i = 0; i < count; i++)
+            output[first + i] = converted && stat[i] == 0 ? QPointF(worldcrd[2 * i], worldcrd[2 * i + 1]) :
+                               QPointF(NOT_A_NUMBER, NOT_A_NUMBER);
+        return converted;
+    });
+}
+
+bool WCSGrid::worldToPixel(wcsprm *wcs, const QVector<QPointF> &world, QVector<QPointF> &pixels)
+{
+    pixels.resize(world.size());
+    if (world.isEmpty())
+        return wcs != nullptr;
+
+    QPointF * const output = pixels.data();
+    return convertInTasks(wcs, world.size(), [&world, output](wcsprm * handle, int first, int last)
+    {
+        int const count = last - first;
+        std::vector<double> worldcrd(2 * count), imgcrd(2 * count), pixcrd(2 * count), phi(count), theta(count);
+        std::vector<int> stat(count);
+        for (int i = 0; i < count; i++)
+        {
+            worldcrd[2 * i] = world[first + i].x();
+            worldcrd[2 * i + 1] = world[first + i].y();
+        }
+
+        int const status = handle == nullptr ? -1 : wcss2p(handle, count, 2, worldcrd.data(), phi.data(), theta.data(),
+                           imgcrd.data(), pixcrd.data(), stat.data());
+        bool const converted = status == 0 || status == WCSERR_BAD_WORLD;
+        for (int i = 0; i < count; i++)
+            output[first + i] = converted && stat[i] == 0 ? QPointF(pixcrd[2 * i], pixcrd[2 * i + 1]) :
+                                QPointF(NOT_A_NUMBER, NOT_A_NUMBER);
+        return converted;
+    });
+}
+
+bool WCSGrid::build(wcsprm *wcs, int width, int height, double tolerance)
+{
+    m_Step = 0;
+    m_Nodes.clear();
+    m_MaximumError = 0;
+    if (wcs == nullptr || width <= 0 || height <= 0)
+        return false;
+
+    m_Width = width;
+    m_Height = height;
+    m_RA0 = wcs->crval[0];
+    m_Dec0 = wcs->crval[1];
+
+    // No need for cells larger than the frame
+    int step = MAXIMUM_STEP;
+    while (step > MINIMUM_STEP && step >= std::max(width, height))
+        step /= 2;
+
+    for (; step >= MINIMUM_STEP; step /= 2)
+    {
+        if (sample(wcs, step, tolerance))
+            return true;
+    }
+
+    m_Step = 0;
+    m_Nodes.clear();
+    return false;
+}
+
+bool WCSGrid::sample(wcsprm *wcs, int step, double tolerance)
+{
+    // One cell beyond each edge, for objects at the border of the frame
+    m_Step = step;
+    m_Origin = QPointF(-step, -step);
+    m_Columns = (m_Width + step - 1) / step + 3;
+    m_Rows = (m_Height + step - 1) / step + 3;
+
+    QVector<QPointF> pixels;
+    pixels.reserve(m_Columns * m_Rows);
+    for (int j = 0; j < m_Rows; j++)
+        for (int i = 0; i < m_Columns; i++)
+            pixels.append(m_Origin + QPointF(i * step, j * step));
+
+    QVector<QPointF> world;
+    if (!pixelToWorld(wcs, pixels, world))
+        return false;
+
+    m_Nodes.resize(world.size());
+    for (int n = 0; n < world.size(); n++)
+    {
+        if (!project(world[n], m_Nodes[n]))
+            return false;
+    }
+
+    // Errors and first guesses of the inversion use the scale at the centre of the frame
+    QPointF dx, dy;
+    m_CenterPixel = QPointF(m_Width / 2.0, m_Height / 2.0);
+    m_CenterPlane = interpolate(m_CenterPixel, &dx, &dy);
+    double const determinant = dx.x() * dy.y() - dy.x() * dx.y();
+    if (determinant == 0 || !std::isfinite(determinant))
+        return false;
+    m_Inverse[0][0] = dy.y() / determinant;
+    m_Inverse[0][1] = -dy.x() / determinant;
+    m_Inverse[1][0] = -dx.y() / determinant;
+    m_Inverse[1][1] = dx.x() / determinant;
+
+    // The interpolation is furthest from the WCS halfway between the nodes, along the sides or at the centre of the
+    // cells depending on the distortion
+    QVector<QPointF> checks;
+    checks.reserve(3 * m_Columns * m_Rows);
+    for (int j = 0; j < m_Rows; j++)
+        for (int i = 0; i < m_Columns; i++)
+        {
+            QPointF const node = m_Origin + QPointF(i * step, j * step);
+            if (i + 1 < m_Columns)
+                checks.append(node + QPointF(step / 2.0, 0));
+            if (j + 1 < m_Rows)
+                checks.append(node + QPointF(0, step / 2.0));
+            if (i + 1 < m_Columns && j + 1 < m_Rows)
+                checks.append(node + QPointF(step / 2.0, step / 2.0));
+        }
+
+    if (!pixelToWorld(wcs, checks, world))
+        return false;
+
+    m_MaximumError = 0;
+    for (int k = 0; k < checks.size(); k++)
+    {
+        QPointF plane;
+        if (!project(world[k], plane))
+            return false;
+        QPointF const difference = plane - interpolate(checks[k]);
+        m_MaximumError = std::max(m_MaximumError,
+                                  std::hypot(m_Inverse[0][0] * difference.x() + m_Inverse[0][1] * difference.y(),
+                                             m_Inverse[1][0] * difference.x() + m_Inverse[1][1] * difference.y()));
+    }
+
+    return m_MaximumError <= tolerance;
+}
+
+bool WCSGrid::covers(const QPointF &pixel) const
+{
+    return isValid() && pixel.x() >= m_Origin.x() && pixel.y() >= m_Origin.y() &&
+           pixel.x() <= m_Origin.x() + (m_Columns - 1) * m_Step && pixel.y() <= m_Origin.y() + (m_Rows - 1) * m_Step;
+}
+
+bool WCSGrid::project(const QPointF &world, QPointF &plane) const
+{
+    double const ra = (world.x() - m_RA0) * DEG_TO_RAD;
+    double const dec = world.y() * DEG_TO_RAD;
+    double const dec0 = m_Dec0 * DEG_TO_RAD;
+
+    // Points on the far side of the sky have no projection, NaN fails the comparison too
+    double const cosc = std::sin(dec0) * std::sin(dec) + std::cos(dec0) * std::cos(dec) * std::cos(ra);
+    if (!(cosc > 0))
+        return false;
+
+    plane = QPointF(std::cos(dec) * std::sin(ra) / cosc,
+                    (std::cos(dec0) * std::sin(dec) - std::sin(dec0) * std::cos(dec) * std::cos(ra)) / cosc) / DEG_TO_RAD;
+    return true;
+}
+
+void WCSGrid::deproject(const QPointF &plane, QPointF &world) const
+{
+    double const x = plane.x() * DEG_TO_RAD;
+    double const y = plane.y() * DEG_TO_RAD;
+    double const rho = std::hypot(x, y);
+    if (rho == 0)
+    {
+        world = QPointF(m_RA0, m_Dec0);
+        return;
+    }
+
+    double const dec0 = m_Dec0 * DEG_TO_RAD;
+    double const c = std::atan(rho);
+    double const dec = std::asin(std::cos(c) * std::sin(dec0) + y * std::sin(c) * std::cos(dec0) / rho);
+    double const ra = std::atan2(x * std::sin(c), rho * std::cos(dec0) * std::cos(c) - y * std::sin(dec0) * std::sin(c));
+    world = QPointF(std::fmod(m_RA0 + ra / DEG_TO_RAD + 720.0, 360.0), dec / DEG_TO_RAD);
+}
+
+QPointF WCSGrid::interpolate(const QPointF &pixel, QPointF *dx, QPointF *dy) const
+{
+    double const u = (pixel.x() - m_Origin.x()) / m_Step;
+    double const v = (pixel.y() - m_Origin.y()) / m_Step;
+    if (!std::isfinite(u) || !std::isfinite(v))
+        return QPointF(NOT_A_NUMBER, NOT_A_NUMBER);
+
+    // Outside the grid, the cells of the border are extrapolated
+    int const i = qBound(0, static_cast<int>(std::floor(u)), m_Columns - 2);
+    int const j = qBound(0, static_cast<int>(std::floor(v)), m_Rows - 2);
+    double const fu = u - i;
+    double const fv = v - j;
+
+    QPointF const &n00 = m_Nodes[j * m_Columns + i];
+    QPointF const &n10 = m_Nodes[j * m_Columns + i + 1];
+    QPointF const &n01 = m_Nodes[(j + 1) * m_Columns + i];
+    QPointF const &n11 = m_Nodes[(j + 1) * m_Columns + i + 1];
+
+    if (dx != nullptr)
+        *dx = ((n10 - n00) * (1 - fv) + (n11 - n01) * fv) / m_Step;
+    if (dy != nullptr)
+        *dy = ((n01 - n00) * (1 - fu) + (n11 - n10) * fu) / m_Step;
+
+    return n00 * ((1 - fu) * (1 - fv)) + n10 * (fu * (1 - fv)) + n01 * ((1 - fu) * fv) + n11 * (fu * fv);
+}
+
+bool WCSGrid::pixelToWorld(const QPointF &pixel, QPointF &world) const
+{
+    if (!isValid())
+        return false;
+
+    QPointF const plane = interpolate(pixel);
+    if (!std::isfinite(plane.x()) || !std::isfinite(plane.y()))
+        return false;
+
+    deproject(plane, world);
+    return true;
+}
+
+bool WCSGrid::worldToPixel(const QPointF &world, QPointF &pixel) const
+{
+    pixel = QPointF(NOT_A_NUMBER, NOT_A_NUMBER);
+    QPointF plane;
+    if (!isValid() || !project(world, plane))
+        return false;
+
+    // Start from the scale at the centre of the frame, then follow the cells
+    QPointF const offset = plane - m_CenterPlane;
+    QPointF position = m_CenterPixel + QPointF(m_Inverse[0][0] * offset.x() + m_Inverse[0][1] * offset.y(),
+                       m_Inverse[1][0] * offset.x() + m_Inverse[1][1] * offset.y());
+    for (int iteration = 0; iteration < MAXIMUM_ITERATIONS; iteration++)
+    {
+        QPointF dx, dy;
+        QPointF const residual = plane - interpolate(position, &dx, &dy);
+        double const determinant = dx.x() * dy.y() - dy.x() * dx.y();
+        if (determinant == 0 || !std::isfinite(determinant))
+            break;
+
+        QPointF const correction((dy.y() * residual.x() - dy.x() * residual.y()) / determinant,
+                                 (dx.x() * residual.y() - dx.y() * residual.x()) / determinant);
+        position += correction;
+        if (std::fabs(correction.x()) + std::fabs(correction.y()) < 1e-6)
+            break;
+    }
+
+    if (!std::isfinite(position.x()) || !std::isfinite(position.y()))
+        return false;
+
+    pixel = position;
+    return true;
+}
+
+void WCSGrid::worldToPixel(const QVector<QPointF> &world, QVector<QPointF> &pixels) const
+{
+    pixels.resize(world.size());
+    QPointF * const output = pixels.data();
+    auto const convert = [this, &world, output](int first, int last)
+    {
+        for (int i = first; i < last; i++)
+            worldToPixel(world[i], output[i]);
+    };
+
+    if (world.size() <= POINTS_PER_TASK)
+    {
+        convert(0, world.size());
+        return;
+    }
+
+    QVector<int> tasks;
+    for (int first = 0; first < world.size(); first += POINTS_PER_TASK)
+        tasks.append(first);
+    QtConcurrent::blockingMap(tasks, [&](int const first)
+    {
+        convert(first, std::min(world.size(), first + POINTS_PER_TASK));
+    });
+}
+
+#endif
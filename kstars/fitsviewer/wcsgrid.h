@@ -0,0 +1,110 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "config-kstars.h"
+
+#include <QPointF>
+#include <QVector>
+
+#ifdef HAVE_WCSLIB
+
+struct wcsprm;
+
+/**
+ * @class WCSGrid
+ * @short Fast conversions between the pixels of a frame and the sky, for overlays and object searches.
+ *
+ * The batched conversions call wcslib on chunks of points across threads, each thread with its own copy of the WCS.
+ *
+ * The grid samples the WCS at nodes a few tens of pixels apart, and interpolates between them on the plane tangent
+ * to the sky at the reference point. Gnomonic projections are affine on that plane, so only distortions such as SIP
+ * are interpolated. The grid is refined until the interpolation is within a tolerance of wcslib halfway between the
+ * nodes, and is not valid when it could not be.
+ *
+ * Positions on the sky are J2000 RA and DE in degrees, in the x and y of a QPointF. Pixel positions are in the
+ * convention of FITSData::pixelToWCS. Points that cannot be converted are set to NaN.
+ */
+class WCSGrid
+{
+    public:
+        /** @brief Default tolerance of the grid, in pixels */
+        static constexpr double DEFAULT_TOLERANCE { 0.1 };
+        /** @brief Largest and smallest distance between the nodes, in pixels */
+        static constexpr int MAXIMUM_STEP { 256 };
+        static constexpr int MINIMUM_STEP { 8 };
+        /** @brief Points converted by each task of the batched conversions */
+        static constexpr int POINTS_PER_TASK { 4096 };
+
+        /**
+         * @brief Convert pixel positions to the sky with wcslib.
+         * @return false if wcslib failed on the whole batch.
+         */
+        static bool pixelToWorld(wcsprm *wcs, const QVector<QPointF> &pixels, QVector<QPointF> &world);
+
+        /**
+         * @brief Convert positions on the sky to pixels with wcslib.
+         * @return false if wcslib failed on the whole batch.
+         */
+        static bool worldToPixel(wcsprm *wcs, const QVector<QPointF> &world, QVector<QPointF> &pixels);
+
+        /**
+         * @brief Sample @p wcs over a frame, with a margin around it.
+         * @return true if the grid is within @p tolerance pixels of wcslib.
+         */
+        bool build(wcsprm *wcs, int width, int height, double tolerance = DEFAULT_TOLERANCE);
+
+        bool isValid() const
+        {
+            return m_Step > 0;
+        }
+        /** @return distance between the nodes in pixels, 0 if the grid is not valid. */
+        int step() const
+        {
+            return m_Step;
+        }
+        /** @return largest difference with wcslib found while building, in pixels. */
+        double maximumError() const
+        {
+            return m_MaximumError;
+        }
+        /** @return true if @p pixel is within the area sampled by the grid, false for NaN. */
+        bool covers(const QPointF &pixel) const;
+
+        bool pixelToWorld(const QPointF &pixel, QPointF &world) const;
+        bool worldToPixel(const QPointF &world, QPointF &pixel) const;
+        /** @brief Interpolate a batch of positions on the sky across threads. */
+        void worldToPixel(const QVector<QPointF> &world, QVector<QPointF> &pixels) const;
+
+    private:
+        /** Project the sky on the plane tangent at the reference point, in degrees */
+        bool project(const QPointF &world, QPointF &plane) const;
+        void deproject(const QPointF &plane, QPointF &world) const;
+        /** Interpolate the tangent plane at a pixel, and optionally its derivatives per pixel */
+        QPointF interpolate(const QPointF &pixel, QPointF *dx = nullptr, QPointF *dy = nullptr) const;
+        /** Sample the nodes and check the cells at the given step */
+        bool sample(wcsprm *wcs, int step, double tolerance);
+
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_Step { 0 };
+        // Nodes along each axis and position of the first one
+        int m_Columns { 0 };
+        int m_Rows { 0 };
+        QPointF m_Origin;
+        // Position of the nodes on the tangent plane, line after line
+        QVector<QPointF> m_Nodes;
+        // Reference point and inverse of the scale at the centre of the frame, pixels per degree on the tangent plane
+        double m_RA0 { 0 };
+        double m_Dec0 { 0 };
+        double m_Inverse[2][2] {{0, 0}, {0, 0}};
+        QPointF m_CenterPixel;
+        QPointF m_CenterPlane;
+        double m_MaximumError { 0 };
+};
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "geolocation.h"
 #include "ksnumbers.h"
+#include "ksnumberscache.h"
 #include "kstarsdata.h"
 
 KSAlmanac::KSAlmanac()
@@ -41,22 +42,28 @@ KSAlmanac::KSAlmanac(const KStarsDateTime &midnight, const GeoLocation *g)
 
 void KSAlmanac::update()
 {
-    RiseSetTime(&m_Sun, &SunRise, &SunSet, &SunRiseT, &SunSetT);
-    RiseSetTime(&m_Moon, &MoonRise, &MoonSet, &MoonRiseT, &MoonSetT);
+    // Rise and set times may be up to a day and a half away
+    KSEphemeris *ephemeris = KSEphemeris::Instance();
+    const KSEphemeris::TablePtr sun  = ephemeris->table(KSPlanetBase::SUN, geo, dt.djd() - 2, dt.djd() + 2);
+    const KSEphemeris::TablePtr moon = ephemeris->table(KSPlanetBase::MOON, geo, dt.djd() - 2, dt.djd() + 2);
+
+    RiseSetTime(&m_Sun, *sun, &SunRise, &SunSet, &SunRiseT, &SunSetT);
+    RiseSetTime(&m_Moon, *moon, &MoonRise, &MoonSet, &MoonRiseT, &MoonSetT);
     //    qDebug() << Q_FUNC_INFO << "Sun rise: " << SunRiseT.toString() << " Sun set: " << SunSetT.toString() << " Moon rise: " << MoonRiseT.toString() << " Moon set: " << MoonSetT.toString();
-    findDawnDusk();
+    findDawnDusk(*sun);
     findMoonPhase();
 }
 
-void KSAlmanac::RiseSetTime(SkyObject *o, double *riseTime, double *setTime, QTime *RiseTime, QTime *SetTime)
+void KSAlmanac::RiseSetTime(SkyObject *o, const KSEphemeris::Table &table, double *riseTime, double *setTime,
+                            QTime *RiseTime, QTime *SetTime)
 {
     // Compute object rise and set times
     const KStarsDateTime today = dt;
     const GeoLocation *_geo    = geo;
     *RiseTime                  = o->riseSetTime(
         today, _geo,
-        true); // FIXME: Should we add a day here so that we report future rise time? Not doing so produces the right results for the moon. Not sure about the sun.
-    *SetTime  = o->riseSetTime(today, _geo, false);
+        true, true, table.positions()); // FIXME: Should we add a day here so that we report future rise time? Not doing so produces the right results for the moon. Not sure about the sun.
+    *SetTime  = o->riseSetTime(today, _geo, false, true, table.positions());
     *riseTime = -1.0 * RiseTime->secsTo(QTime(0, 0, 0, 0)) / 86400.0;
     *setTime  = -1.0 * SetTime->secsTo(QTime(0, 0, 0, 0)) / 86400.0;
 
@@ -65,9 +72,9 @@ void KSAlmanac::RiseSetTime(SkyObject *o, double *riseTime, double *setTime, QTi
     //       we freely change the geolocation / time without setting
     //       them back.
 
-    KSNumbers num(dt.djd());
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(dt.djd());
     CachingDms LST = geo->GSTtoLST(dt.gst());
-    o->updateCoords(&num, true, geo->lat(), &LST, true);
+    o->updateCoords(num.data(), true, geo->lat(), &LST, true);
     if (o->checkCircumpolar(geo->lat()))
     {
         if (o->alt().Degrees() > 0.0)
@@ -85,21 +92,21 @@ void KSAlmanac::RiseSetTime(SkyObject *o, double *riseTime, double *setTime, QTi
     }
 }
 
-void KSAlmanac::findDawnDusk(double altitude)
+void KSAlmanac::findDawnDusk(const KSEphemeris::Table &sun, double altitude)
 {
     KStarsDateTime today = dt;
-    KSNumbers num(today.djd());
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(today.djd());
     CachingDms LST = geo->GSTtoLST(today.gst());
 
     // Relocate our local Sun to this almanac time - local midnight
-    m_Sun.updateCoords(&num, true, geo->lat(), &LST, true);
+    m_Sun.updateCoords(num.data(), true, geo->lat(), &LST, true);
 
     // Granularity
     int const h_inc = 5;
 
     // Compute the altitude of the Sun twelve hours before this almanac time
     int const start_h = -1200, end_h = +1200;
-    double last_alt = findAltitude(&m_Sun, start_h/100.0);
+    double last_alt = sun.altitude(today.djd() + start_h / 2400.0).Degrees();
 
     int dawn = -1300, dusk = -1300, min_alt_time = -1300;
     double max_alt = -100.0, min_alt = +100.0;
@@ -108,8 +115,8 @@ void KSAlmanac::findDawnDusk(double altitude)
     // See the header comment about dawn and dusk positions
     for (int h = start_h + h_inc; h <= end_h; h += h_inc)
     {
-        // Compute the Sun's altitude in an increasing hour interval
-        double const alt = findAltitude(&m_Sun, h/100.0);
+        // Compute the Sun's altitude in an increasing hour interval, the Sun moving meanwhile
+        double const alt = sun.altitude(today.djd() + h / 2400.0).Degrees();
 
         // Deduce whether the Sun is rising or setting
         bool const rising = alt - last_alt > 0;
@@ -160,11 +167,11 @@ void KSAlmanac::findDawnDusk(double altitude)
 void KSAlmanac::findMoonPhase()
 {
     const KStarsDateTime today = dt;
-    KSNumbers num(today.djd());
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(today.djd());
     CachingDms LST = geo->GSTtoLST(today.gst());
 
-    m_Sun.updateCoords(&num, true, geo->lat(), &LST, true); // We can abuse our own copy of the sun and/or moon
-    m_Moon.updateCoords(&num, true, geo->lat(), &LST, true);
+    m_Sun.updateCoords(num.data(), true, geo->lat(), &LST, true); // We can abuse our own copy of the sun and/or moon
+    m_Moon.updateCoords(num.data(), true, geo->lat(), &LST, true);
     m_Moon.findPhase(&m_Sun);
     MoonPhase = m_Moon.phase().Degrees();
 }
@@ -189,8 +196,3 @@ double KSAlmanac::sunZenithAngleToTime(double z) const
     double HASunset = acos((-m_Sun.dec().sin() * geo->lat()->sin()) / (m_Sun.dec().cos() * geo->lat()->cos()));
     return SunSet + (HA - HASunset) / 24.0;
 }
-
-double KSAlmanac::findAltitude(const SkyPoint *p, double hour)
-{
-    return SkyPoint::findAltitude(p, dt, geo, hour).Degrees();
-}
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "ksephemeris.h"
 #include "skyobjects/kssun.h"
 #include "skyobjects/ksmoon.h"
 #include "kstarsdatetime.h"
@@ -104,8 +105,10 @@ class KSAlmanac
     /**
           * This function computes the rise and set time for the given SkyObject. This is done in order to
           * have a common function for the computation of the Sun and Moon rise and set times.
+          * The positions of the object are interpolated from @p table.
           */
-    void RiseSetTime(SkyObject *o, double *riseTime, double *setTime, QTime *RiseTime, QTime *SetTime);
+    void RiseSetTime(SkyObject *o, const KSEphemeris::Table &table, double *riseTime, double *setTime,
+                     QTime *RiseTime, QTime *SetTime);
 
     /**
          * Compute the dawn and dusk times in a [-12,+12] hours around the day midnight of this KSAlmanac, if any, as well as min and max altitude.
@@ -114,20 +117,13 @@ class KSAlmanac
          * - If there is no astronomical night time, dawn and dusk will be set to the time of minimal altitude of the Sun.
          * - If there is no twilight or day time, dawn and dusk will be set to the time of minimal altitude of the Sun.
          */
-    void findDawnDusk(double altitude = -18.0);
+    void findDawnDusk(const KSEphemeris::Table &sun, double altitude = -18.0);
 
     /**
          * Computes the moon phase at the given date/time
          */
     void findMoonPhase();
 
-    /**
-         * FIXME: More code duplication!
-         * findAltitude should really be part of KSEngine. Copying from ObservingList.
-         * returns in degrees
-         */
-    double findAltitude(const SkyPoint *p, double hour);
-
     KSSun m_Sun;
     KSMoon m_Moon;
     KStarsDateTime dt;
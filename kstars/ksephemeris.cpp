@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ksephemeris.h"
+
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/ksplanet.h"
+
+#include <QtConcurrent>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Requested ranges are rounded to this many days, so that nearby requests share a table
+constexpr double blockDays = 8.0;
+
+// Tables kept in the cache
+constexpr int maxTables = 32;
+
+KSPlanet *createEarth()
+{
+    return new KSPlanet(i18n("Earth"), QString(), QColor("white"), 12756.28 /*diameter in km*/);
+}
+}  // namespace
+
+bool KSEphemeris::Table::covers(long double startJD, long double stopJD) const
+{
+    // The first and last two grid times are only there for the interpolation
+    return startJD >= m_FirstJD + 2 * m_Step && stopJD <= m_FirstJD + (m_X.size() - 3) * m_Step;
+}
+
+SkyPoint KSEphemeris::Table::position(long double jd) const
+{
+    // Cubic Lagrange interpolation of the direction, from the two grid times on each side
+    const double u = double(jd - m_FirstJD) / m_Step;
+    const int i    = qBound(1, int(std::floor(u)), m_X.size() - 3);
+    const double f = u - i;
+
+    const double w0 = -f * (f - 1) * (f - 2) / 6;
+    const double w1 = (f + 1) * (f - 1) * (f - 2) / 2;
+    const double w2 = -(f + 1) * f * (f - 2) / 2;
+    const double w3 = (f + 1) * f * (f - 1) / 6;
+
+    const double x = w0 * m_X[i - 1] + w1 * m_X[i] + w2 * m_X[i + 1] + w3 * m_X[i + 2];
+    const double y = w0 * m_Y[i - 1] + w1 * m_Y[i] + w2 * m_Y[i + 1] + w3 * m_Y[i + 2];
+    const double z = w0 * m_Z[i - 1] + w1 * m_Z[i] + w2 * m_Z[i + 1] + w3 * m_Z[i + 2];
+
+    dms ra, dec;
+    ra.setRadians(std::atan2(y, x));
+    dec.setRadians(std::atan2(z, std::hypot(x, y)));
+    return SkyPoint(ra.reduce(), dec);
+}
+
+dms KSEphemeris::Table::altitude(long double jd) const
+{
+    SkyPoint p = position(jd);
+    CachingDms lst(KStarsDateTime(jd).gst().Degrees() + m_Longitude.Degrees());
+    p.EquatorialToHorizontal(&lst, &m_Latitude);
+    return p.alt();
+}
+
+SkyObject::PositionFunction KSEphemeris::Table::positions() const
+{
+    return [this](const KStarsDateTime & dt)
+    {
+        return position(dt.djd());
+    };
+}
+
+KSEphemeris *KSEphemeris::Instance()
+{
+    static KSEphemeris instance;
+    return &instance;
+}
+
+KSEphemeris::TablePtr KSEphemeris::table(int planet, const GeoLocation *geo, long double startJD, long double stopJD)
+{
+    {
+        QMutexLocker lock(&m_Mutex);
+        for (int i = 0; i < m_Tables.size(); ++i)
+        {
+            const TablePtr table = m_Tables.at(i);
+            if (table->m_Planet == planet && table->m_Latitude.Degrees() == geo->lat()->Degrees() &&
+                    table->m_Longitude.Degrees() == geo->lng()->Degrees() && table->covers(startJD, stopJD))
+            {
+                m_Tables.move(i, 0);
+                return table;
+            }
+        }
+    }
+
+    // Another thread may compute the same table meanwhile, it costs time but no harm
+    TablePtr table = compute(planet, geo, startJD, stopJD);
+
+    QMutexLocker lock(&m_Mutex);
+    m_Tables.prepend(table);
+    while (m_Tables.size() > maxTables)
+        m_Tables.removeLast();
+    return table;
+}
+
+void KSEphemeris::clear()
+{
+    QMutexLocker lock(&m_Mutex);
+    m_Tables.clear();
+}
+
+int KSEphemeris::planetOf(const SkyObject *object)
+{
+    if (!object || (object->type() != SkyObject::PLANET && object->type() != SkyObject::MOON))
+        return KSPlanetBase::UNKNOWN_PLANET;
+
+    // Same names as SkyMapComposite::planet()
+    const QString name = object->name();
+    for (int planet = KSPlanetBase::MERCURY; planet <= KSPlanetBase::MOON; ++planet)
+    {
+        std::unique_ptr<KSPlanetBase> body(KSPlanetBase::createPlanet(planet));
+        if (body && body->name() == name)
+            return planet;
+    }
+    return KSPlanetBase::UNKNOWN_PLANET;
+}
+
+double KSEphemeris::step(int planet)
+{
+    // The topocentric parallax of the Moon changes over the day, it needs the finer grid
+    return planet == KSPlanetBase::MOON ? 1.0 / 24.0 : 0.25;
+}
+
+KSEphemeris::TablePtr KSEphemeris::compute(int planet, const GeoLocation *geo, long double startJD,
+        long double stopJD)
+{
+    QSharedPointer<Table> table(new Table);
+    table->m_Planet    = planet;
+    table->m_Latitude  = *geo->lat();
+    table->m_Longitude = *geo->lng();
+    table->m_Step      = step(planet);
+
+    // The grid starts and ends two steps beyond the rounded range, for the interpolation
+    const long double first = std::floor(startJD / blockDays) * blockDays;
+    long double last        = std::ceil(stopJD / blockDays) * blockDays;
+    if (last <= first)
+        last = first + blockDays;
+    const int count  = int(std::lround(double(last - first) / table->m_Step)) + 5;
+    table->m_FirstJD = first - 2 * table->m_Step;
+    table->m_X.resize(count);
+    table->m_Y.resize(count);
+    table->m_Z.resize(count);
+
+    QVector<long double> times(count);
+    for (int i = 0; i < count; ++i)
+        times[i] = table->m_FirstJD + i * table->m_Step;
+
+    Table *data = table.data();
+    computePositions(planet, geo, times, [data](int i, const Sample & sample)
+    {
+        double sinRa, cosRa, sinDec, cosDec;
+        sample.body->ra().SinCos(sinRa, cosRa);
+        sample.body->dec().SinCos(sinDec, cosDec);
+        data->m_X[i] = cosDec * cosRa;
+        data->m_Y[i] = cosDec * sinRa;
+        data->m_Z[i] = sinDec;
+    });
+
+    return table;
+}
+
+void KSEphemeris::computePositions(int planet, const GeoLocation *geo, const QVector<long double> &times,
+                                   const std::function<void(int, const Sample &)> &visit)
+{
+    if (times.isEmpty())
+        return;
+
+    // Each chunk of times has its own body and Earth, positioned in place. Destroying a TrailObject
+    // updates the set of objects with a trail, which is not thread safe, so the bodies are created
+    // and destroyed here and the workers only move them.
+    struct Chunk
+    {
+        int begin;
+        int end;
+        std::unique_ptr<KSPlanetBase> body;
+        std::unique_ptr<KSPlanet> earth;
+    };
+
+    const int count     = times.size();
+    const int threads   = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+    const int chunkSize = std::max(16, count / (4 * threads));
+    std::vector<Chunk> chunks;
+    for (int i = 0; i < count; i += chunkSize)
+    {
+        Chunk chunk { i, std::min(count, i + chunkSize), nullptr, nullptr };
+        chunk.body.reset(KSPlanetBase::createPlanet(planet));
+        chunk.earth.reset(createEarth());
+        chunks.push_back(std::move(chunk));
+    }
+    if (!chunks.front().body)
+        return;
+
+    // The orbital data of a planet is loaded on first use and shared by its instances, load it before the workers
+    {
+        KSNumbers num(times.front());
+        chunks.front().earth->findPosition(&num);
+        chunks.front().body->findPosition(&num, nullptr, nullptr, chunks.front().earth.get());
+    }
+
+    const CachingDms latitude(*geo->lat());
+    QtConcurrent::blockingMap(chunks, [&](Chunk & chunk)
+    {
+        for (int i = chunk.begin; i < chunk.end; ++i)
+        {
+            // Same computation as SkyObject::recomputeCoords()
+            const long double jd = times[i];
+            KSNumbers num(jd);
+            const CachingDms lst(geo->GSTtoLST(KStarsDateTime(jd).gst()));
+            chunk.earth->findPosition(&num);
+            chunk.body->findPosition(&num, &latitude, &lst, chunk.earth.get());
+            visit(i, { jd, &num, &lst, chunk.earth.get(), chunk.body.get() });
+        }
+    });
+}
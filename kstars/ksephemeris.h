@@ -0,0 +1,140 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "skyobjects/skyobject.h"
+
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
+
+class GeoLocation;
+class KSNumbers;
+class KSPlanet;
+class KSPlanetBase;
+
+/**
+ * @class KSEphemeris
+ * @short Tabulated positions of the Sun, the Moon and the major planets.
+ *
+ * The planning tools need the position of the same bodies over and over, for every
+ * day of a year or every few minutes of a night. Computing each position from the
+ * theory of the body is expensive, so KSEphemeris computes the topocentric positions
+ * of a body on a regular grid of times, in parallel, and the tools interpolate them.
+ *
+ * The grid step is one hour for the Moon and six hours for the other bodies. The
+ * interpolation error is then a few arcseconds at most, due to the daily change of the
+ * parallax, less than a second in the rise and set times. The tables are cached
+ * per body, location and range of dates, the ranges being rounded so that nearby
+ * requests share a table.
+ *
+ * The rise, set and transit times are computed by the usual SkyObject functions,
+ * given the interpolated positions:
+ * @code
+ * auto table = KSEphemeris::Instance()->table(KSPlanetBase::MARS, geo, startJD, stopJD);
+ * QTime rise = mars->riseSetTime(dt, geo, true, true, table->positions());
+ * @endcode
+ *
+ * computePositions() is the parallel computation behind the tables, for the tools that
+ * need more than the direction of the body at each time.
+ *
+ * All methods are thread safe.
+ */
+class KSEphemeris
+{
+    public:
+        /** Positions of a body seen from a location over a range of dates */
+        class Table
+        {
+            public:
+                /** @return the KSPlanetBase::Planets identifier of the body */
+                int planet() const
+                {
+                    return m_Planet;
+                }
+
+                /** @return true if the table holds the positions from @p startJD to @p stopJD */
+                bool covers(long double startJD, long double stopJD) const;
+
+                /**
+                 * @return the apparent topocentric coordinates of the body at @p jd, interpolated.
+                 * Outside of the range of the table, the positions are extrapolated and quickly wrong.
+                 */
+                SkyPoint position(long double jd) const;
+
+                /** @return the altitude of the body at @p jd, without refraction */
+                dms altitude(long double jd) const;
+
+                /**
+                 * @return the positions of the table, for the rise, set and transit functions of SkyObject.
+                 * The table must outlive the function.
+                 */
+                SkyObject::PositionFunction positions() const;
+
+            private:
+                friend class KSEphemeris;
+
+                int m_Planet { 0 };
+                CachingDms m_Latitude;
+                dms m_Longitude;
+                long double m_FirstJD { 0 };
+                double m_Step { 0 };
+                /** Directions of the body at the grid times */
+                QVector<double> m_X, m_Y, m_Z;
+        };
+
+        typedef QSharedPointer<const Table> TablePtr;
+
+        /** A body positioned at a time by computePositions(), with the values used to compute it */
+        struct Sample
+        {
+            long double jd;
+            const KSNumbers *num;
+            const CachingDms *lst;
+            const KSPlanet *earth;
+            const KSPlanetBase *body;
+        };
+
+        static KSEphemeris *Instance();
+
+        /**
+         * @return the table of @p planet seen from @p geo, covering at least @p startJD to @p stopJD.
+         * The table is computed if it is not in the cache, which may take a while for long ranges.
+         * @param planet a KSPlanetBase::Planets identifier, the Earth shadow excepted
+         */
+        TablePtr table(int planet, const GeoLocation *geo, long double startJD, long double stopJD);
+
+        /** @short Forget the cached tables */
+        void clear();
+
+        /** @return the KSPlanetBase::Planets identifier of @p object, or UNKNOWN_PLANET if it has no table */
+        static int planetOf(const SkyObject *object);
+
+        /** @return the interval between the tabulated positions of @p planet, in days */
+        static double step(int planet);
+
+        /**
+         * @short Compute the topocentric positions of @p planet seen from @p geo at @p times, in parallel.
+         * Blocks until done. @p visit is called from the worker threads with the index of each time and
+         * the sample computed for it, which is only valid during the call.
+         * @param planet a KSPlanetBase::Planets identifier, the Earth shadow excepted
+         */
+        static void computePositions(int planet, const GeoLocation *geo, const QVector<long double> &times,
+                                     const std::function<void(int, const Sample &)> &visit);
+
+    private:
+        KSEphemeris() = default;
+
+        static TablePtr compute(int planet, const GeoLocation *geo, long double startJD, long double stopJD);
+
+        QMutex m_Mutex;
+        /** The cached tables, the most recently used first */
+        QList<TablePtr> m_Tables;
+};
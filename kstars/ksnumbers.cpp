@@ -9,6 +9,82 @@
 
 #include "kstarsdatetime.h" //for J2000 define
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const double UA2km = 1.49597870 / 86400.; // 10^{-8}*UA/dia -> km/s
+
+// Terms of the velocity of the Earth at T Julian centuries since J2000: the argument
+// in radians, then the sine and cosine coefficients of the X, Y and Z components
+void earthVelocityTerms(double T, double (&terms)[36][7])
+{
+    // Mean longitudes for the planets. radians
+    //
+
+    // TODO Pasar a grados [Google Translate says "Jump to Degrees". --asimha]
+    double LVenus   = 3.1761467 + 1021.3285546 * T; // Venus
+    double LMars    = 1.7534703 + 628.3075849 * T;  // Mars
+    double LEarth   = 6.2034809 + 334.0612431 * T;  // Earth
+    double LJupiter = 0.5995465 + 52.9690965 * T;   // Jupiter
+    double LSaturn  = 0.8740168 + 21.3299095 * T;   // Saturn
+    double LNeptune = 5.3118863 + 3.8133036 * T;    // Neptune
+    double LUranus  = 5.4812939 + 7.4781599 * T;    // Uranus
+
+    double LMRad = 3.8103444 + 8399.6847337 * T; // Moon
+    double DRad  = 5.1984667 + 7771.3771486 * T;
+    double MMRad = 2.3555559 + 8328.6914289 * T; // Moon
+    double FRad  = 1.6279052 + 8433.4661601 * T;
+
+    /** Contributions to the velocity of the Earth referred to the barycenter of the solar system
+        in the J2000 equatorial system
+        Velocities 10^{-8} AU/day
+        Ron & Vondrak method
+    **/
+
+    const double table[36][7] = {
+        { LMars, -1719914 - 2 * T, -25, 25 - 13 * T, 1578089 + 156 * T, 10 + 32 * T, 684185 - 358 * T },
+        { 2 * LMars, 6434 + 141 * T, 28007 - 107 * T, 25697 - 95 * T, -5904 - 130 * T, 11141 - 48 * T, -2559 - 55 * T },
+        { LJupiter, 715, 0, 6, -657, -15, -282 },
+        { LMRad, 715, 0, 0, -656, 0, -285 },
+        { 3 * LMars, 486 - 5 * T, -236 - 4 * T, -216 - 4 * T, -446 + 5 * T, -94, -193 },
+        { LSaturn, 159, 0, 2, -147, -6, -61 },
+        { FRad, 0, 0, 0, 26, 0, -59 },
+        { LMRad + MMRad, 39, 0, 0, -36, 0, -16 },
+        { 2 * LJupiter, 33, -10, -9, -30, -5, -13 },
+        { 2 * LMars - LJupiter, 31, 1, 1, -28, 0, -12 },
+        { 3 * LMars - 8 * LEarth + 3 * LJupiter, 8, -28, 25, 8, 11, 3 },
+        { 5 * LMars - 8 * LEarth + 3 * LJupiter, 8, -28, -25, -8, -11, -3 },
+        { 2 * LVenus - LMars, 21, 0, 0, -19, 0, -8 },
+        { LVenus, -19, 0, 0, 17, 0, 8 },
+        { LNeptune, 17, 0, 0, -16, 0, -7 },
+        { LMars - 2 * LJupiter, 16, 0, 0, 15, 1, 7 },
+        { LUranus, 16, 0, 1, -15, -3, -6 },
+        { LMars + LJupiter, 11, -1, -1, -10, -1, -5 },
+        { 2 * LVenus - 2 * LMars, 0, -11, -10, 0, -4, 0 },
+        { LMars - LJupiter, -11, -2, -2, 9, -1, 4 },
+        { 4 * LMars, -7, -8, -8, 6, -3, 3 },
+        { 3 * LMars - 2 * LJupiter, -10, 0, 0, 9, 0, 4 },
+        { LVenus - 2 * LMars, -9, 0, 0, -9, 0, -4 },
+        { 2 * LVenus - 3 * LMars, -9, 0, 0, -8, 0, -4 },
+        { 2 * LSaturn, 0, -9, -8, 0, -3, 0 },
+        { 2 * LVenus - 4 * LMars, 0, -9, 8, 0, 3, 0 },
+        { 3 * LMars - 2 * LEarth, 8, 0, 0, -8, 0, -3 },
+        { LMRad + 2 * DRad - MMRad, 8, 0, 0, -7, 0, -3 },
+        { 8 * LVenus - 12 * LMars, -4, -7, -6, 4, -3, 2 },
+        { 8 * LVenus - 14 * LMars, -4, -7, 6, -4, 3, -2 },
+        { 2 * LEarth, -6, -5, -4, 5, -2, 2 },
+        { 3 * LVenus - 4 * LMars, -1, -1, -2, -7, 1, -4 },
+        { 2 * LMars - 2 * LJupiter, 4, -6, -5, -4, -2, -2 },
+        { 3 * LVenus - 3 * LMars, 0, -7, -6, 0, -3, 0 },
+        { 2 * LMars - 2 * LEarth, 5, -5, -4, -5, -2, -2 },
+        { LMRad - 2 * DRad, 5, 0, 0, -5, 0, -2 }
+    };
+    std::copy(&table[0][0], &table[0][0] + 36 * 7, &terms[0][0]);
+}
+}  // namespace
+
 // 63 elements
 const int KSNumbers::arguments[NUTTERMS][5] = {
     { 0, 0, 0, 0, 1 },   { -2, 0, 0, 2, 2 },  { 0, 0, 0, 2, 2 },   { 0, 0, 0, 0, 2 },  { 0, 1, 0, 0, 0 },
@@ -108,6 +184,68 @@ KSNumbers::KSNumbers(long double jd)
     updateValues(jd);
 }
 
+KSNumbers::KSNumbers(long double jd, const KSNumbers &before, const KSNumbers &after)
+{
+    K.setD(20.49552 / 3600.);
+    P.setD(102.94719);
+
+    computeConstantValues();
+    updateArguments(jd);
+
+    // The nutation and the velocity of the Earth are the expensive series, they vary slowly
+    const double f = double((jd - before.days) / (after.days - before.days));
+    deltaEcLong    = before.deltaEcLong + f * (after.deltaEcLong - before.deltaEcLong);
+    deltaObliquity = before.deltaObliquity + f * (after.deltaObliquity - before.deltaObliquity);
+    for (int j = 0; j < 3; j++)
+        vearth[j] = before.vearth[j] + f * (after.vearth[j] - before.vearth[j]);
+}
+
+double KSNumbers::interpolationError(double step)
+{
+    // Each term of the series is a sine of an argument increasing at a constant rate, its second
+    // derivative is at most its amplitude times its rate squared. A linear interpolation between
+    // dates step days apart is then off by at most step^2 / 8 times the sum over the terms.
+    static const double sum = []()
+    {
+        // Rates of D, M, MM, F and O in degrees per century
+        const double rates[5] = { 445267.111480, 35999.05030, 477198.867398, 483202.017538, -1934.136261 };
+        // Bound of the secular changes of the amplitudes, in centuries from J2000
+        const double centuries = 5.0;
+
+        double longitude = 0, obliquity = 0;
+        for (int i = 0; i < NUTTERMS; i++)
+        {
+            double rate = 0;
+            for (int k = 0; k < 5; k++)
+                rate += arguments[i][k] * rates[k];
+            rate *= dms::DegToRad / 36525.;
+            longitude += (std::abs(amp[i][0]) + std::abs(amp[i][1]) / 10. * centuries) * rate * rate;
+            obliquity += (std::abs(amp[i][2]) + std::abs(amp[i][3]) / 10. * centuries) * rate * rate;
+        }
+        // Arcseconds per day squared
+        double nutation = std::max(longitude, obliquity) * 1e-4;
+
+        // The velocity of the Earth, as an aberration angle
+        double terms[36][7], later[36][7];
+        earthVelocityTerms(0, terms);
+        earthVelocityTerms(1, later);
+        double velocity = 0;
+        for (int i = 0; i < 36; i++)
+        {
+            const double rate = (later[i][0] - terms[i][0]) / 36525.;
+            double amplitude  = 0;
+            for (int j = 0; j < 3; j++)
+                amplitude += std::pow(std::abs(terms[i][2 * j + 1]) + std::abs(terms[i][2 * j + 2]), 2);
+            velocity += std::sqrt(amplitude) * rate * rate;
+        }
+        const double aberration = velocity * UA2km / 299792.458 * 3600. / dms::DegToRad;
+
+        return nutation + aberration;
+    }();
+
+    return step * step / 8 * sum;
+}
+
 void KSNumbers::computeConstantValues()
 {
     // Compute those numbers that need to be computed only
@@ -154,9 +292,13 @@ void KSNumbers::computeConstantValues()
 
 void KSNumbers::updateValues(long double jd)
 {
-    dms arg;
-    double args, argc;
+    updateArguments(jd);
+    updateNutation();
+    updateEarthVelocity();
+}
 
+void KSNumbers::updateArguments(long double jd)
+{
     days = jd;
 
     // FIXME: What is the source for these algorithms / polynomials / numbers? -- asimha
@@ -212,39 +354,6 @@ void KSNumbers::updateValues(long double jd)
                     2.45 * U * U * U * U * U * U * U * U * U * U;
     Obliquity.setD(23.43929111 + dObliq / 3600.0);
 
-    //Nutation parameters
-    dms L2, M2, O2;
-    double sin2L, cos2L, sin2M, cos2M;
-    double sinO, cosO, sin2O, cos2O;
-
-    O2.setD(2.0 * O.Degrees());
-    L2.setD(2.0 * L.Degrees());  //twice mean ecl. long. of Sun
-    M2.setD(2.0 * LM.Degrees()); //twice mean ecl. long. of Moon
-
-    O.SinCos(sinO, cosO);
-    O2.SinCos(sin2O, cos2O);
-    L2.SinCos(sin2L, cos2L);
-    M2.SinCos(sin2M, cos2M);
-
-    //	deltaEcLong = ( -17.2*sinO - 1.32*sin2L - 0.23*sin2M + 0.21*sin2O)/3600.0; //Ecl. long. correction
-    //	deltaObliquity = ( 9.2*cosO + 0.57*cos2L + 0.10*cos2M - 0.09*cos2O)/3600.0; //Obliq. correction
-
-    deltaEcLong    = 0.;
-    deltaObliquity = 0.;
-
-    for (unsigned int i = 0; i < NUTTERMS; i++)
-    {
-        arg.setD(arguments[i][0] * D.Degrees() + arguments[i][1] * M.Degrees() + arguments[i][2] * MM.Degrees() +
-                 arguments[i][3] * F.Degrees() + arguments[i][4] * O.Degrees());
-        arg.SinCos(args, argc);
-
-        deltaEcLong += (amp[i][0] + amp[i][1] / 10. * T) * args * 1e-4;
-        deltaObliquity += (amp[i][2] + amp[i][3] / 10. * T) * argc * 1e-4;
-    }
-
-    deltaEcLong /= 3600.0;
-    deltaObliquity /= 3600.0;
-
     //Compute Precession Matrices:
     XP.setD(0.6406161 * T + 0.0000839 * T2 + 0.0000050 * T3);
     YP.setD(0.5567530 * T - 0.0001185 * T2 - 0.0000116 * T3);
@@ -277,68 +386,51 @@ void KSNumbers::updateValues(long double jd)
     P2(0, 2) = P1(2, 0);
     P2(1, 2) = P1(2, 1);
     P2(2, 2) = P1(2, 2);
+}
 
-    // Mean longitudes for the planets. radians
-    //
+void KSNumbers::updateNutation()
+{
+    dms arg;
+    double args, argc;
 
-    // TODO Pasar a grados [Google Translate says "Jump to Degrees". --asimha]
-    double LVenus   = 3.1761467 + 1021.3285546 * T; // Venus
-    double LMars    = 1.7534703 + 628.3075849 * T;  // Mars
-    double LEarth   = 6.2034809 + 334.0612431 * T;  // Earth
-    double LJupiter = 0.5995465 + 52.9690965 * T;   // Jupiter
-    double LSaturn  = 0.8740168 + 21.3299095 * T;   // Saturn
-    double LNeptune = 5.3118863 + 3.8133036 * T;    // Neptune
-    double LUranus  = 5.4812939 + 7.4781599 * T;    // Uranus
+    //Nutation parameters
+    dms L2, M2, O2;
+    double sin2L, cos2L, sin2M, cos2M;
+    double sinO, cosO, sin2O, cos2O;
 
-    double LMRad = 3.8103444 + 8399.6847337 * T; // Moon
-    double DRad  = 5.1984667 + 7771.3771486 * T;
-    double MMRad = 2.3555559 + 8328.6914289 * T; // Moon
-    double FRad  = 1.6279052 + 8433.4661601 * T;
+    O2.setD(2.0 * O.Degrees());
+    L2.setD(2.0 * L.Degrees());  //twice mean ecl. long. of Sun
+    M2.setD(2.0 * LM.Degrees()); //twice mean ecl. long. of Moon
 
-    /** Contributions to the velocity of the Earth referred to the barycenter of the solar system
-        in the J2000 equatorial system
-        Velocities 10^{-8} AU/day
-        Ron & Vondrak method
-    **/
+    O.SinCos(sinO, cosO);
+    O2.SinCos(sin2O, cos2O);
+    L2.SinCos(sin2L, cos2L);
+    M2.SinCos(sin2M, cos2M);
 
-    double vondrak[36][7] = {
-        { LMars, -1719914 - 2 * T, -25, 25 - 13 * T, 1578089 + 156 * T, 10 + 32 * T, 684185 - 358 * T },
-        { 2 * LMars, 6434 + 141 * T, 28007 - 107 * T, 25697 - 95 * T, -5904 - 130 * T, 11141 - 48 * T, -2559 - 55 * T },
-        { LJupiter, 715, 0, 6, -657, -15, -282 },
-        { LMRad, 715, 0, 0, -656, 0, -285 },
-        { 3 * LMars, 486 - 5 * T, -236 - 4 * T, -216 - 4 * T, -446 + 5 * T, -94, -193 },
-        { LSaturn, 159, 0, 2, -147, -6, -61 },
-        { FRad, 0, 0, 0, 26, 0, -59 },
-        { LMRad + MMRad, 39, 0, 0, -36, 0, -16 },
-        { 2 * LJupiter, 33, -10, -9, -30, -5, -13 },
-        { 2 * LMars - LJupiter, 31, 1, 1, -28, 0, -12 },
-        { 3 * LMars - 8 * LEarth + 3 * LJupiter, 8, -28, 25, 8, 11, 3 },
-        { 5 * LMars - 8 * LEarth + 3 * LJupiter, 8, -28, -25, -8, -11, -3 },
-        { 2 * LVenus - LMars, 21, 0, 0, -19, 0, -8 },
-        { LVenus, -19, 0, 0, 17, 0, 8 },
-        { LNeptune, 17, 0, 0, -16, 0, -7 },
-        { LMars - 2 * LJupiter, 16, 0, 0, 15, 1, 7 },
-        { LUranus, 16, 0, 1, -15, -3, -6 },
-        { LMars + LJupiter, 11, -1, -1, -10, -1, -5 },
-        { 2 * LVenus - 2 * LMars, 0, -11, -10, 0, -4, 0 },
-        { LMars - LJupiter, -11, -2, -2, 9, -1, 4 },
-        { 4 * LMars, -7, -8, -8, 6, -3, 3 },
-        { 3 * LMars - 2 * LJupiter, -10, 0, 0, 9, 0, 4 },
-        { LVenus - 2 * LMars, -9, 0, 0, -9, 0, -4 },
-        { 2 * LVenus - 3 * LMars, -9, 0, 0, -8, 0, -4 },
-        { 2 * LSaturn, 0, -9, -8, 0, -3, 0 },
-        { 2 * LVenus - 4 * LMars, 0, -9, 8, 0, 3, 0 },
-        { 3 * LMars - 2 * LEarth, 8, 0, 0, -8, 0, -3 },
-        { LMRad + 2 * DRad - MMRad, 8, 0, 0, -7, 0, -3 },
-        { 8 * LVenus - 12 * LMars, -4, -7, -6, 4, -3, 2 },
-        { 8 * LVenus - 14 * LMars, -4, -7, 6, -4, 3, -2 },
-        { 2 * LEarth, -6, -5, -4, 5, -2, 2 },
-        { 3 * LVenus - 4 * LMars, -1, -1, -2, -7, 1, -4 },
-        { 2 * LMars - 2 * LJupiter, 4, -6, -5, -4, -2, -2 },
-        { 3 * LVenus - 3 * LMars, 0, -7, -6, 0, -3, 0 },
-        { 2 * LMars - 2 * LEarth, 5, -5, -4, -5, -2, -2 },
-        { LMRad - 2 * DRad, 5, 0, 0, -5, 0, -2 }
-    };
+    //	deltaEcLong = ( -17.2*sinO - 1.32*sin2L - 0.23*sin2M + 0.21*sin2O)/3600.0; //Ecl. long. correction
+    //	deltaObliquity = ( 9.2*cosO + 0.57*cos2L + 0.10*cos2M - 0.09*cos2O)/3600.0; //Obliq. correction
+
+    deltaEcLong    = 0.;
+    deltaObliquity = 0.;
+
+    for (unsigned int i = 0; i < NUTTERMS; i++)
+    {
+        arg.setD(arguments[i][0] * D.Degrees() + arguments[i][1] * M.Degrees() + arguments[i][2] * MM.Degrees() +
+                 arguments[i][3] * F.Degrees() + arguments[i][4] * O.Degrees());
+        arg.SinCos(args, argc);
+
+        deltaEcLong += (amp[i][0] + amp[i][1] / 10. * T) * args * 1e-4;
+        deltaObliquity += (amp[i][2] + amp[i][3] / 10. * T) * argc * 1e-4;
+    }
+
+    deltaEcLong /= 3600.0;
+    deltaObliquity /= 3600.0;
+}
+
+void KSNumbers::updateEarthVelocity()
+{
+    double vondrak[36][7];
+    earthVelocityTerms(T, vondrak);
 
     dms anglev;
     double sa, ca;
@@ -359,8 +451,6 @@ void KSNumbers::updateValues(long double jd)
         }
     }
 
-    const double UA2km = 1.49597870 / 86400.; // 10^{-8}*UA/dia -> km/s
-
     for (double &item : vearth)
     {
         item *= UA2km;
@@ -47,8 +47,26 @@ class KSNumbers
      * @param jd  Julian Day for which the new instance is initialized
      */
     explicit KSNumbers(long double jd);
+
+    /**
+     * Constructor interpolating the nutation and the velocity of the Earth linearly
+     * between two instances computed for nearby dates. The other values are computed
+     * for @p jd, they are cheap.
+     * @param jd  Julian Day for which the new instance is initialized
+     * @param before instance for a date before @p jd
+     * @param after instance for a date after @p jd
+     * @see interpolationError()
+     */
+    KSNumbers(long double jd, const KSNumbers &before, const KSNumbers &after);
+
     ~KSNumbers() = default;
 
+    /**
+     * @return an upper bound of the error, in arcseconds, of the nutation and of the aberration
+     * computed from an instance interpolated between two dates @p step days apart.
+     */
+    static double interpolationError(double step);
+
     /**
      * @return the current Obliquity (the angle of inclination between
      * the celestial equator and the ecliptic)
@@ -130,6 +148,11 @@ class KSNumbers
     inline double vEarth(int i) const { return vearth[i]; }
 
   private:
+    /** @short update the values other than the nutation and the velocity of the Earth */
+    void updateArguments(long double jd);
+    void updateNutation();
+    void updateEarthVelocity();
+
     CachingDms Obliquity, L0, P;
     dms K, L, LM, M, M0, O, D, MM, F;
     dms XP, YP, ZP, XB, YB, ZB;
@@ -0,0 +1,107 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ksnumberscache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Interpolation steps are powers of two of a day within this range, so that the grids nest
+constexpr double minStep = 1.0 / 1024.0;
+constexpr double maxStep = 16.0;
+}  // namespace
+
+KSNumbersCache *KSNumbersCache::Instance()
+{
+    static KSNumbersCache instance;
+    return &instance;
+}
+
+KSNumbersCache::NumbersPtr KSNumbersCache::numbers(long double jd, double resolution)
+{
+    resolution = std::max(resolution, DefaultResolution);
+    const long double rounded = std::round(jd / resolution) * resolution;
+    // The keys count the finest resolution, whatever the resolution asked
+    const qint64 key = std::llround(rounded / DefaultResolution);
+
+    {
+        QMutexLocker lock(&m_Mutex);
+        auto it = m_Index.constFind(key);
+        if (it != m_Index.constEnd())
+        {
+            m_Recent.splice(m_Recent.begin(), m_Recent, it.value());
+            return m_Recent.front().second;
+        }
+    }
+
+    // Another thread may compute the same numbers meanwhile, the first one is kept
+    NumbersPtr numbers(new KSNumbers(rounded));
+
+    QMutexLocker lock(&m_Mutex);
+    auto it = m_Index.constFind(key);
+    if (it != m_Index.constEnd())
+    {
+        m_Recent.splice(m_Recent.begin(), m_Recent, it.value());
+        return m_Recent.front().second;
+    }
+    m_Recent.emplace_front(key, numbers);
+    m_Index.insert(key, m_Recent.begin());
+    trim();
+    return numbers;
+}
+
+KSNumbers KSNumbersCache::interpolated(long double jd, double tolerance)
+{
+    const double step = interpolationStep(tolerance);
+    if (step == 0)
+        return KSNumbers(jd);
+
+    const long double first = std::floor(jd / step) * step;
+    const NumbersPtr before = numbers(first, step);
+    const NumbersPtr after  = numbers(first + step, step);
+    return KSNumbers(jd, *before, *after);
+}
+
+double KSNumbersCache::interpolationStep(double tolerance)
+{
+    for (double step = maxStep; step >= minStep; step /= 2)
+    {
+        if (KSNumbers::interpolationError(step) <= tolerance)
+            return step;
+    }
+    return 0;
+}
+
+int KSNumbersCache::capacity() const
+{
+    QMutexLocker lock(&m_Mutex);
+    return m_Capacity;
+}
+
+void KSNumbersCache::setCapacity(int capacity)
+{
+    QMutexLocker lock(&m_Mutex);
+    m_Capacity = std::max(2, capacity);
+    trim();
+}
+
+void KSNumbersCache::clear()
+{
+    QMutexLocker lock(&m_Mutex);
+    m_Recent.clear();
+    m_Index.clear();
+}
+
+void KSNumbersCache::trim()
+{
+    while (int(m_Recent.size()) > m_Capacity)
+    {
+        m_Index.remove(m_Recent.back().first);
+        m_Recent.pop_back();
+    }
+}
@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "ksnumbers.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include <list>
+#include <utility>
+
+/**
+ * @class KSNumbersCache
+ * @short Shared KSNumbers instances, for the tools computing positions at many dates.
+ *
+ * Constructing a KSNumbers evaluates the nutation series and the velocity of the Earth,
+ * and the planning tools construct one for the same or nearby dates over and over. The
+ * cache keeps the instances computed for Julian dates rounded to a resolution, the least
+ * recently used being dropped beyond the capacity.
+ *
+ * Tools which need many dates can also ask for interpolated instances: the nutation and
+ * the velocity of the Earth are interpolated between cached instances on a grid whose
+ * step keeps the error within a tolerance, and the cheap values are computed for the
+ * exact date:
+ * @code
+ * KSNumbers num = KSNumbersCache::Instance()->interpolated(jd);
+ * @endcode
+ *
+ * All methods are thread safe.
+ */
+class KSNumbersCache
+{
+    public:
+        typedef QSharedPointer<const KSNumbers> NumbersPtr;
+
+        /** Default resolution of the dates, about a millisecond */
+        static constexpr double DefaultResolution = 1e-8;
+
+        /** Default tolerance of the interpolated instances, in arcseconds */
+        static constexpr double DefaultTolerance = 0.01;
+
+        static KSNumbersCache *Instance();
+
+        /**
+         * @return the numbers for @p jd rounded to a multiple of @p resolution days, computed
+         * if not in the cache.
+         * @param resolution at least DefaultResolution
+         */
+        NumbersPtr numbers(long double jd, double resolution = DefaultResolution);
+
+        /**
+         * @return the numbers for @p jd, the nutation and the velocity of the Earth being
+         * interpolated between cached instances.
+         * @param tolerance bound of the error of the nutation and the aberration, in arcseconds.
+         * The numbers are computed for @p jd if the tolerance is too small for an interpolation.
+         */
+        KSNumbers interpolated(long double jd, double tolerance = DefaultTolerance);
+
+        /** @return the interval between the dates interpolated within @p tolerance arcseconds, 0 if none */
+        static double interpolationStep(double tolerance);
+
+        /** @return the number of instances kept in the cache */
+        int capacity() const;
+        void setCapacity(int capacity);
+
+        /** @short Forget the cached instances */
+        void clear();
+
+    private:
+        KSNumbersCache() = default;
+
+        /** Drops the least recently used instances beyond the capacity, with the mutex locked */
+        void trim();
+
+        mutable QMutex m_Mutex;
+        int m_Capacity { 4096 };
+        /** The cached instances and the keys of their dates, the most recently used first */
+        std::list<std::pair<qint64, NumbersPtr>> m_Recent;
+        QHash<qint64, std::list<std::pair<qint64, NumbersPtr>>::iterator> m_Index;
+};
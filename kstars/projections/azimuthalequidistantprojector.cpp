@@ -31,6 +31,12 @@ double AzimuthalEquidistantProjector::projectionK(double x) const
     return ((crad != 0) ? crad / sin(crad) : 1); // This handles the 0/0 case. The limit of x / sin(x) is 1 as x -> 0.
 }
 
+void AzimuthalEquidistantProjector::batchProjectionK(const Batch &x, Batch &k) const
+{
+    const Batch crad = x.acos();
+    k = (crad != 0).select(crad / crad.sin(), 1.0);
+}
+
 double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
@@ -22,6 +22,7 @@ class AzimuthalEquidistantProjector : public Projector
     Projection type() const override;
     double radius() const override;
     double projectionK(double x) const override;
+    void batchProjectionK(const Batch &x, Batch &k) const override;
     double projectionL(double x) const override;
 };
 
@@ -57,6 +57,38 @@ Eigen::Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oR
     return p;
 }
 
+void EquirectangularProjector::toScreenBatch(Batch &longitude, Batch &latitude, bool oRefract, float *x, float *y,
+        bool *visible) const
+{
+    const int n             = longitude.size();
+    const BatchMask invalid = invalidPoints(longitude, latitude);
+    const double zoom       = m_vp.zoomFactor;
+
+    Batch dX, Y;
+    oRefract &= m_vp.useRefraction;
+    if (m_vp.useAltAz)
+    {
+        if (oRefract)
+            refractBatch(latitude); //account for atmospheric refraction
+        const double Y0 = SkyPoint::refract(m_vp.focus->alt(), oRefract).radians();
+        dX = m_vp.focus->az().reduce().radians() - longitude;
+        Y  = 0.5 * m_vp.height - zoom * (latitude - Y0);
+    }
+    else
+    {
+        dX = longitude - m_vp.focus->ra().reduce().radians();
+        Y  = 0.5 * m_vp.height - zoom * (latitude - m_vp.focus->dec().radians());
+    }
+    reduceBatch(dX);
+
+    const Batch X = 0.5 * m_vp.width - zoom * dX;
+
+    Eigen::Map<Eigen::ArrayXf>(x, n) = invalid.select(0.0, X).cast<float>();
+    Eigen::Map<Eigen::ArrayXf>(y, n) = invalid.select(0.0, Y).cast<float>();
+    if (visible)
+        Eigen::Map<Eigen::Array<bool, Eigen::Dynamic, 1>>(visible, n) = !invalid && X > 0 && X < double(m_vp.width);
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, dms *LST, const dms *lat, bool onlyAltAz) const
 {
     SkyPoint result;
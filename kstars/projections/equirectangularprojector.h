@@ -26,6 +26,10 @@ class EquirectangularProjector : public Projector
         SkyPoint fromScreen(const QPointF &p, dms *LST, const dms *lat, bool onlyAltAz = false) const override;
         QVector<Eigen::Vector2f> groundPoly(SkyPoint *labelpoint = nullptr, bool *drawLabel = nullptr) const override;
         void updateClipPoly() override;
+
+    protected:
+        void toScreenBatch(Batch &longitude, Batch &latitude, bool oRefract, float *x, float *y,
+                           bool *visible) const override;
 };
 
 #endif // EQUIRECTANGULARPROJECTOR_H
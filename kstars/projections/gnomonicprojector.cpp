@@ -26,6 +26,11 @@ double GnomonicProjector::projectionK(double x) const
     return 1.0 / x;
 }
 
+void GnomonicProjector::batchProjectionK(const Batch &x, Batch &k) const
+{
+    k = x.inverse();
+}
+
 double GnomonicProjector::projectionL(double x) const
 {
     return atan(x);
@@ -27,6 +27,11 @@ double OrthographicProjector::projectionK(double x) const
     return 1.0;
 }
 
+void OrthographicProjector::batchProjectionK(const Batch &x, Batch &k) const
+{
+    k.setOnes(x.size());
+}
+
 double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
@@ -95,6 +95,103 @@ QPointF Projector::toScreen(const SkyPoint *o, bool oRefract, bool *onVisibleHem
     return KSUtils::vecToPoint(toScreenVec(o, oRefract, onVisibleHemisphere));
 }
 
+void Projector::toScreen(const double *longitude, const double *latitude, int count, float *x, float *y,
+                         bool *visible, bool oRefract) const
+{
+    Batch lon, lat;
+
+    for (int start = 0; start < count; start += BatchSize)
+    {
+        const int n = std::min(BatchSize, count - start);
+        lon = Eigen::Map<const Eigen::ArrayXd>(longitude + start, n);
+        lat = Eigen::Map<const Eigen::ArrayXd>(latitude + start, n);
+        toScreenBatch(lon, lat, oRefract, x + start, y + start, visible ? visible + start : nullptr);
+    }
+}
+
+Projector::BatchMask Projector::invalidPoints(Batch &longitude, Batch &latitude)
+{
+    const BatchMask invalid = !(longitude.isFinite() && latitude.isFinite());
+    if (invalid.any())
+    {
+        longitude = invalid.select(0.0, longitude);
+        latitude  = invalid.select(0.0, latitude);
+    }
+    return invalid;
+}
+
+void Projector::refractBatch(Batch &alt)
+{
+    static const double corrCrit = SkyPoint::refractionCorr(SkyPoint::altCrit);
+
+    const Batch degrees = alt / dms::DegToRad;
+    // SkyPoint::refractionCorr(), which is only used above altCrit
+    const Batch corr = 1.02 / (dms::DegToRad * (degrees + 10.3 / (degrees + 5.11))).tan() / 60;
+    alt = dms::DegToRad * (degrees > SkyPoint::altCrit)
+          .select(degrees + corr, degrees + corrCrit * (degrees + 90) / (SkyPoint::altCrit + 90));
+}
+
+void Projector::reduceBatch(Batch &angle)
+{
+    angle -= 2 * dms::PI * ((angle + dms::PI) / (2 * dms::PI)).floor();
+}
+
+void Projector::toScreenBatch(Batch &longitude, Batch &latitude, bool oRefract, float *x, float *y,
+                              bool *visible) const
+{
+    const int n             = longitude.size();
+    const BatchMask invalid = invalidPoints(longitude, latitude);
+    const double zoom       = m_vp.zoomFactor;
+    const double origX      = m_vp.width / 2;
+    const double origY      = m_vp.height / 2;
+
+    Batch dX;
+    oRefract &= m_vp.useRefraction;
+    if (m_vp.useAltAz)
+    {
+        if (oRefract)
+            refractBatch(latitude); //account for atmospheric refraction
+        dX = m_vp.focus->az().radians() - longitude;
+    }
+    else
+    {
+        dX = longitude - m_vp.focus->ra().radians();
+    }
+    reduceBatch(dX);
+
+    const Batch sindX = dX.sin();
+    const Batch cosdX = dX.cos();
+    const Batch sinY  = latitude.sin();
+    const Batch cosY  = latitude.cos();
+
+    //c is the cosine of the angular distance from the center
+    const Batch c = m_sinY0 * sinY + m_cosY0 * cosY * cosdX;
+    Batch k;
+    batchProjectionK(c, k);
+
+    Batch X = origX - zoom * k * cosY * sindX;
+    Batch Y = origY - zoom * k * (m_cosY0 * sinY - m_sinY0 * cosY * cosdX);
+#ifdef KSTARS_LITE
+    double skyRotation = SkyMapLite::Instance()->getSkyRotation();
+    if (skyRotation != 0)
+    {
+        dms rotation(skyRotation);
+        double cosT, sinT;
+
+        rotation.SinCos(sinT, cosT);
+
+        const Batch newX = origX + (X - origX) * cosT - (Y - origY) * sinT;
+        Y = origY + (X - origX) * sinT + (Y - origY) * cosT;
+        X = newX;
+    }
+#endif
+
+    Eigen::Map<Eigen::ArrayXf>(x, n) = invalid.select(0.0, X).cast<float>();
+    Eigen::Map<Eigen::ArrayXf>(y, n) = invalid.select(0.0, Y).cast<float>();
+    if (visible)
+        Eigen::Map<Eigen::Array<bool, Eigen::Dynamic, 1>>(visible, n) = !invalid && c > cosMaxFieldAngle();
+}
+
 bool Projector::onScreen(const QPointF &p) const
 {
     return (0 <= p.x() && p.x() <= m_vp.width && 0 <= p.y() && p.y() <= m_vp.height);
@@ -27,6 +27,7 @@
 
 #include <QPointF>
 
+#include <algorithm>
 #include <cstddef>
 #include <cmath>
 
@@ -132,6 +133,78 @@ class Projector
          */
         QPointF toScreen(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const;
 
+        /** Number of points projected at a time by the batch functions */
+        static constexpr int BatchSize = 256;
+
+        /** Coordinates of a batch of points, kept on the stack */
+        typedef Eigen::Array<double, Eigen::Dynamic, 1, 0, BatchSize, 1> Batch;
+        typedef Eigen::Array<bool, Eigen::Dynamic, 1, 0, BatchSize, 1> BatchMask;
+
+        /**
+         * @short Determine the pixel coordinates of many points at once.
+         *
+         * The results are those of toScreenVec() for each point, but the values depending
+         * on the focus are computed once, and the points are projected BatchSize at a time
+         * with array operations, which the compiler vectorizes. Points with non finite
+         * coordinates are projected to (0, 0) and are not visible.
+         *
+         * @param longitude right ascensions, or azimuths if the sky map uses horizontal
+         *   coordinates, in radians.
+         * @param latitude declinations, or unrefracted altitudes, in radians.
+         * @param count number of points.
+         * @param x, y arrays receiving the screen pixel coordinates of the points.
+         * @param visible array receiving whether the points are on the visible part of
+         *   the Celestial Sphere, may be nullptr.
+         * @param oRefract true = use Options::useRefraction() value.
+         * @see toScreenVec()
+         */
+        void toScreen(const double *longitude, const double *latitude, int count, float *x, float *y,
+                      bool *visible = nullptr, bool oRefract = true) const;
+
+        /**
+         * @short Determine the pixel coordinates of many SkyPoints at once.
+         *
+         * The coordinates of the points are gathered BatchSize at a time and projected
+         * as above.
+         * @param count number of points.
+         * @param pointAt function returning the SkyPoint at an index from 0 to count - 1.
+         * @param screen array receiving the screen pixel coordinates of the points.
+         * @param visible array receiving whether the points are on the visible part of
+         *   the Celestial Sphere, may be nullptr.
+         * @param oRefract true = use Options::useRefraction() value.
+         */
+        template <typename PointAt>
+        void toScreen(int count, PointAt pointAt, QPointF *screen, bool *visible = nullptr, bool oRefract = true) const
+        {
+            Batch longitude, latitude;
+            float x[BatchSize], y[BatchSize];
+
+            for (int start = 0; start < count; start += BatchSize)
+            {
+                const int n = std::min(BatchSize, count - start);
+                longitude.resize(n);
+                latitude.resize(n);
+                for (int i = 0; i < n; i++)
+                {
+                    const SkyPoint *o = pointAt(start + i);
+                    if (m_vp.useAltAz)
+                    {
+                        longitude[i] = o->az().radians();
+                        latitude[i]  = o->alt().radians();
+                    }
+                    else
+                    {
+                        longitude[i] = o->ra().radians();
+                        latitude[i]  = o->dec().radians();
+                    }
+                }
+
+                toScreenBatch(longitude, latitude, oRefract, x, y, visible ? visible + start : nullptr);
+                for (int i = 0; i < n; i++)
+                    screen[start + i] = QPointF(x[i], y[i]);
+            }
+        }
+
         /**
          * @short Determine RA, Dec coordinates of the pixel at (dx, dy), which are the
          * screen pixel coordinate offsets from the center of the Sky pixmap.
@@ -264,6 +337,34 @@ class Projector
             return x;
         }
 
+        /**
+         * Same as projectionK() for a batch of values, to be reimplemented along with it.
+         * The default implementation calls projectionK() for each value.
+         */
+        virtual void batchProjectionK(const Batch &x, Batch &k) const
+        {
+            k.resize(x.size());
+            for (int i = 0; i < x.size(); i++)
+                k[i] = projectionK(x[i]);
+        }
+
+        /**
+         * Projects a batch of at most BatchSize points, with the coordinates in radians.
+         * This is the batch counterpart of toScreenVec(), to be reimplemented along with it.
+         * @see toScreen()
+         */
+        virtual void toScreenBatch(Batch &longitude, Batch &latitude, bool oRefract, float *x, float *y,
+                                   bool *visible) const;
+
+        /** @short Apply the refraction correction to a batch of altitudes in radians, as SkyPoint::refract() */
+        static void refractBatch(Batch &alt);
+
+        /** @short Reduce a batch of angles in radians to [-PI, PI), as KSUtils::reduceAngle() */
+        static void reduceBatch(Batch &angle);
+
+        /** Marks the points of a batch with non finite coordinates, and zeroes them so that they project somewhere */
+        static BatchMask invalidPoints(Batch &longitude, Batch &latitude);
+
         /**
          * This function handles some of the projection-specific code.
          * @see toScreen()
@@ -26,6 +26,11 @@ double StereographicProjector::projectionK(double x) const
     return 2.0 / (1.0 + x);
 }
 
+void StereographicProjector::batchProjectionK(const Batch &x, Batch &k) const
+{
+    k = 2.0 / (1.0 + x);
+}
+
 double StereographicProjector::projectionL(double x) const
 {
     return 2.0 * atan2(x, 2.0);
@@ -6,8 +6,10 @@
 
 #include "artificialhorizoncomponent.h"
 
+#include "geolocation.h"
 #include "greatcircle.h"
 #include "kstarsdata.h"
+#include "kstarsdatetime.h"
 #include "linelist.h"
 #include "Options.h"
 #include "skymap.h"
@@ -15,6 +17,9 @@
 #include "skypainter.h"
 #include "projections/projector.h"
 
+#include <algorithm>
+#include <cmath>
+
 #define UNDEFINED_ALTITUDE -90
 
 ArtificialHorizonEntity::~ArtificialHorizonEntity()
@@ -263,8 +268,8 @@ void drawSelectedPoint(LineList *lineList, int index, SkyPainter *painter)
 // This creates a set of connected line segments from az1,alt1 to az2,alt2, sampling
 // points on the great circle between az1,alt1 and az2,alt2 every 2 degrees or so.
 // The errors would be obvious for longer lines if we just drew a standard line.
-// If testing is true, HorizontalToEquatorial is not called.
-void appendGreatCirclePoints(double az1, double alt1, double az2, double alt2, LineList *region, bool testing)
+// Only the horizontal coordinates of the points are set.
+void appendGreatCirclePoints(double az1, double alt1, double az2, double alt2, LineList *region)
 {
     constexpr double sampling = 2.0;  // degrees
     const double maxAngleDiff = std::max(fabs(az1 - az2), fabs(alt1 - alt2));
@@ -281,24 +286,19 @@ void appendGreatCirclePoints(double az1, double alt1, double az2, double alt2, L
             std::shared_ptr<SkyPoint> sp(new SkyPoint());
             sp->setAz(az);
             sp->setAlt(alt);
-            if (!testing)
-                sp->HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
             region->append(sp);
         }
     }
     std::shared_ptr<SkyPoint> sp(new SkyPoint());
     sp->setAz(az2);
     sp->setAlt(alt2);
-    // Is HorizontalToEquatorial necessary in any case?
-    if (!testing)
-        sp->HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
     region->append(sp);
 }
 
 }  // namespace
 
-// Draws a polygon, where one of the sides is az1,alt1 --> az2,alt2 (except that's implemented as series
-// of connected line segments along a great circle).
+// Computes a polygon, in horizontal coordinates, where one of the sides is az1,alt1 --> az2,alt2 (except
+// that's implemented as series of connected line segments along a great circle).
 // It figures out the opposite side depending on the type of the constraint for this entity
 // (horizon line or ceiling) and the other contraints that are enabled.
 bool ArtificialHorizon::computePolygon(int entity, double az1, double alt1, double az2, double alt2,
@@ -353,13 +353,11 @@ bool ArtificialHorizon::computePolygon(int entity, double az1, double alt1, doub
     std::shared_ptr<SkyPoint> sp(new SkyPoint());
     sp->setAz(az1);
     sp->setAlt(alt1b);
-    if (!testing)
-        sp->HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
     region->append(sp);
 
-    appendGreatCirclePoints(az1, alt1b,  az1, alt1, region, testing);
-    appendGreatCirclePoints(az1, alt1,   az2, alt2, region, testing);
-    appendGreatCirclePoints(az2, alt2,   az2, alt2b, region, testing);
+    appendGreatCirclePoints(az1, alt1b,  az1, alt1, region);
+    appendGreatCirclePoints(az1, alt1,   az2, alt2, region);
+    appendGreatCirclePoints(az2, alt2,   az2, alt2b, region);
     return true;
 }
 
@@ -472,12 +470,35 @@ void ArtificialHorizon::drawPolygons(int entity, SkyPainter *painter, QList<Line
     }
 }
 
+// The polygons are computed in horizontal coordinates when the entities change. Their
+// equatorial coordinates are updated when they are drawn, as the sky turns.
 void ArtificialHorizon::drawPolygons(SkyPainter *painter, QList<LineList> *regions)
 {
-    for (int i = 0; i < horizonList()->size(); i++)
+    checkEntities();
+    if (!m_PolygonsValid)
     {
-        if (enabled(i))
-            drawPolygons(i, painter, regions);
+        m_Polygons.clear();
+        for (int i = 0; i < horizonList()->size(); i++)
+        {
+            if (enabled(i))
+                drawPolygons(i, nullptr, &m_Polygons);
+        }
+        m_PolygonsValid = true;
+    }
+
+    for (auto &region : m_Polygons)
+    {
+        if (painter != nullptr)
+        {
+            if (!testing)
+            {
+                for (const auto &point : *region.points())
+                    point->HorizontalToEquatorial(KStarsData::Instance()->lst(), KStarsData::Instance()->geo()->lat());
+            }
+            painter->drawSkyPolygon(&region, false);
+        }
+        if (regions != nullptr)
+            regions->append(region);
     }
 }
 
@@ -503,8 +524,7 @@ void ArtificialHorizonComponent::draw(SkyPainter *skyp)
 
     preDraw(skyp);
 
-    QList<LineList> regions;
-    horizon.drawPolygons(skyp, &regions);
+    horizon.drawPolygons(skyp);
 }
 
 bool ArtificialHorizon::enabled(int i) const
@@ -615,6 +635,7 @@ constexpr int PRECOMPUTED_RESOLUTION = 10;
 
 double ArtificialHorizon::altitudeConstraint(double azimuthDegrees) const
 {
+    checkEntities();
     if (precomputedConstraints.size() != 360 * PRECOMPUTED_RESOLUTION)
         precomputeConstraints();
     return precomputedConstraint(azimuthDegrees);
@@ -645,6 +666,229 @@ void ArtificialHorizon::precomputeConstraints() const
 void ArtificialHorizon::resetPrecomputeConstraints() const
 {
     precomputedConstraints.clear();
+    m_Raster.clear();
+    m_Polygons.clear();
+    m_PolygonsValid = false;
+    m_EntityStates.clear();
+}
+
+void ArtificialHorizon::checkEntities() const
+{
+    bool changed = m_EntityStates.size() != m_HorizonList.size();
+    for (int i = 0; !changed && i < m_HorizonList.size(); ++i)
+    {
+        const ArtificialHorizonEntity *entity = m_HorizonList.at(i);
+        const EntityState &state = m_EntityStates.at(i);
+        const std::shared_ptr<LineList> list = entity->list();
+        changed = state.entity != entity || state.list != list.get() ||
+                  state.size != (list ? list->points()->size() : 0) || state.enabled != entity->enabled() ||
+                  state.ceiling != entity->ceiling();
+    }
+    if (!changed)
+        return;
+
+    resetPrecomputeConstraints();
+    for (const ArtificialHorizonEntity *entity : m_HorizonList)
+    {
+        const std::shared_ptr<LineList> list = entity->list();
+        m_EntityStates.append({ entity, list.get(), list ? list->points()->size() : 0, entity->enabled(), entity->ceiling() });
+    }
+}
+
+void ArtificialHorizon::setRasterResolution(int cellsPerDegree)
+{
+    if (cellsPerDegree < 1 || cellsPerDegree == m_RasterResolution)
+        return;
+    m_RasterResolution = cellsPerDegree;
+    m_Raster.clear();
+}
+
+namespace
+{
+// Margin in degrees for the rounding of the altitudes and azimuths of the entities
+constexpr double RASTER_MARGIN = 1e-6;
+
+// The range of altitudes of an entity over the azimuths of a raster column
+struct AltitudeHull
+{
+    double low;
+    double high;
+    bool ceiling;
+};
+
+// Returns 1 if a range of altitudes crossed by no hull is visible, 0 if it is blocked, as
+// isVisibleInternal() would find, or -1 if the nearest entity above or below may be a ceiling
+// at some azimuths and not at others.
+int runVisibility(const QVector<AltitudeHull> &hulls, double low, double high)
+{
+    double nearestAbove = 1e6, nearestBelow = -1e6;
+    for (const AltitudeHull &hull : hulls)
+    {
+        if (hull.low > high)
+            nearestAbove = std::min(nearestAbove, hull.high);
+        else if (hull.high < low)
+            nearestBelow = std::max(nearestBelow, hull.low);
+    }
+
+    // The kinds of the entities which may be the nearest above or below at some azimuth
+    bool aboveCeiling = false, aboveHorizon = false, belowCeiling = false, belowHorizon = false;
+    for (const AltitudeHull &hull : hulls)
+    {
+        if (hull.low > high && hull.low <= nearestAbove)
+        {
+            aboveCeiling |= hull.ceiling;
+            aboveHorizon |= !hull.ceiling;
+        }
+        else if (hull.high < low && hull.high >= nearestBelow)
+        {
+            belowCeiling |= hull.ceiling;
+            belowHorizon |= !hull.ceiling;
+        }
+    }
+    if ((aboveCeiling && aboveHorizon) || (belowCeiling && belowHorizon))
+        return -1;
+    return (aboveHorizon || belowCeiling) ? 0 : 1;
+}
+}  // namespace
+
+// The visibility can only change at any altitude where an entity starts or stops constraining
+// the azimuth, otherwise where an entity crosses the altitude. A column holding the azimuth
+// where an entity starts or stops is left to the entities. Otherwise the cells crossed by the
+// range of altitudes of an entity are, and the visibility between them is that of the
+// nearest entities above and below.
+void ArtificialHorizon::computeRaster() const
+{
+    const int columns = 360 * m_RasterResolution;
+    m_Raster.fill(RASTER_VISIBLE, columns * 180 * m_RasterResolution);
+
+    QVector<double> boundaries;
+    for (const ArtificialHorizonEntity *entity : m_HorizonList)
+    {
+        if (!entity->enabled() || entity->list() == nullptr)
+            continue;
+        for (const auto &p : *entity->list()->points())
+        {
+            const double az = p->az().Degrees();
+            if (qIsNaN(az) || qIsNaN(p->alt().Degrees()))
+                continue;
+            bool before = false, at = false, after = false;
+            entity->altitudeConstraint(az - RASTER_MARGIN, &before);
+            entity->altitudeConstraint(az, &at);
+            entity->altitudeConstraint(az + RASTER_MARGIN, &after);
+            if (before != at || at != after)
+                boundaries.append(normalizeDegrees(az));
+        }
+    }
+
+    for (int column = 0; column < columns; ++column)
+        computeRasterColumn(column, boundaries);
+}
+
+void ArtificialHorizon::computeRasterColumn(int column, const QVector<double> &boundaries) const
+{
+    const double resolution = m_RasterResolution;
+    const int rows          = 180 * m_RasterResolution;
+    quint8 *cells           = m_Raster.data() + column * rows;
+    const double az0 = column / resolution, az1 = (column + 1) / resolution;
+
+    for (const double boundary : boundaries)
+    {
+        for (const double az : { boundary - 360.0, boundary, boundary + 360.0 })
+        {
+            if (az >= az0 - RASTER_MARGIN && az <= az1 + RASTER_MARGIN)
+            {
+                std::fill(cells, cells + rows, RASTER_ENTITY);
+                return;
+            }
+        }
+    }
+
+    QVector<AltitudeHull> hulls;
+    for (const ArtificialHorizonEntity *entity : m_HorizonList)
+    {
+        if (!entity->enabled() || entity->list() == nullptr)
+            continue;
+
+        bool constrained = false;
+        double low = 1e6, high = -1e6;
+        const SkyPoint *last = nullptr;
+        for (const auto &p : *entity->list()->points())
+        {
+            if (qIsNaN(p->az().Degrees()) || qIsNaN(p->alt().Degrees()))
+                continue;
+            const SkyPoint *first = last;
+            last = p.get();
+            if (first == nullptr)
+                continue;
+
+            // The segment constrains the azimuths the short way from one end to the other
+            const double span = fabs(first->az().deltaAngle(last->az()).Degrees());
+            const double altA = first->alt().Degrees(), altB = last->alt().Degrees();
+            if (span >= 180 - RASTER_MARGIN)
+            {
+                constrained = true;
+                low  = std::min(low, std::min(altA, altB));
+                high = std::max(high, std::max(altA, altB));
+                continue;
+            }
+
+            double start = normalizeDegrees(first->az().Degrees());
+            double startAlt = altA, endAlt = altB;
+            if (fabs(dms(normalizeDegrees(start + span)).deltaAngle(last->az()).Degrees()) > RASTER_MARGIN)
+            {
+                start = normalizeDegrees(last->az().Degrees());
+                std::swap(startAlt, endAlt);
+            }
+
+            for (const double offset : { 0.0, 360.0 })
+            {
+                const double from = std::max(az0, start - offset), to = std::min(az1, start + span - offset);
+                if (from > to + RASTER_MARGIN)
+                    continue;
+                constrained = true;
+                if (span <= 0)
+                {
+                    low  = std::min(low, std::min(altA, altB));
+                    high = std::max(high, std::max(altA, altB));
+                    continue;
+                }
+                for (const double az : { from, to })
+                {
+                    const double fraction = qBound(0.0, (az - (start - offset)) / span, 1.0);
+                    const double alt = startAlt + fraction * (endAlt - startAlt);
+                    low  = std::min(low, alt);
+                    high = std::max(high, alt);
+                }
+            }
+        }
+        if (constrained)
+            hulls.append({ low - RASTER_MARGIN, high + RASTER_MARGIN, entity->ceiling() });
+    }
+
+    for (const AltitudeHull &hull : hulls)
+    {
+        const int first = std::max(0, int(std::floor((hull.low + 90) * resolution)));
+        const int last  = std::min(rows - 1, int(std::floor((hull.high + 90) * resolution)));
+        for (int row = first; row <= last; ++row)
+            cells[row] = RASTER_ENTITY;
+    }
+
+    for (int row = 0; row < rows;)
+    {
+        if (cells[row] == RASTER_ENTITY)
+        {
+            ++row;
+            continue;
+        }
+        int end = row;
+        while (end < rows && cells[end] != RASTER_ENTITY)
+            ++end;
+
+        const int visibility = runVisibility(hulls, -90 + row / resolution, -90 + end / resolution);
+        const quint8 cell = visibility < 0 ? RASTER_ENTITY : (visibility > 0 ? RASTER_VISIBLE : RASTER_BLOCKED);
+        std::fill(cells + row, cells + end, cell);
+        row = end;
+    }
 }
 
 double ArtificialHorizon::precomputedConstraint(double azimuth) const
@@ -687,7 +931,7 @@ const ArtificialHorizonEntity *ArtificialHorizon::getConstraintBelow(double azim
 // An altitude is blocked (not visible) if either:
 // - there are constraints above and the closest above constraint is not a ceiling, or
 // - there are constraints below and the closest below constraint is a ceiling.
-bool ArtificialHorizon::isVisible(double azimuthDegrees, double altitudeDegrees) const
+bool ArtificialHorizon::isVisibleInternal(double azimuthDegrees, double altitudeDegrees) const
 {
     const ArtificialHorizonEntity *above = getConstraintAbove(azimuthDegrees, altitudeDegrees);
     if (above != nullptr && !above->ceiling()) return false;
@@ -695,3 +939,63 @@ bool ArtificialHorizon::isVisible(double azimuthDegrees, double altitudeDegrees)
     if (below != nullptr && below->ceiling()) return false;
     return true;
 }
+
+bool ArtificialHorizon::isVisible(double azimuthDegrees, double altitudeDegrees) const
+{
+    checkEntities();
+    if (qIsNaN(azimuthDegrees) || !(altitudeDegrees >= -90 && altitudeDegrees < 90))
+        return isVisibleInternal(azimuthDegrees, altitudeDegrees);
+
+    if (m_Raster.isEmpty())
+        computeRaster();
+
+    const int rows   = 180 * m_RasterResolution;
+    const int column = std::min(int(normalizeDegrees(azimuthDegrees) * m_RasterResolution), 360 * m_RasterResolution - 1);
+    const int row    = std::min(int((altitudeDegrees + 90) * m_RasterResolution), rows - 1);
+    switch (m_Raster[column * rows + row])
+    {
+        case RASTER_VISIBLE:
+            return true;
+        case RASTER_BLOCKED:
+            return false;
+        default:
+            return isVisibleInternal(azimuthDegrees, altitudeDegrees);
+    }
+}
+
+bool ArtificialHorizon::isVisible(double az1, double alt1, double az2, double alt2) const
+{
+    double azDelta = normalizeDegrees(az2 - az1);
+    if (azDelta > 180)
+        azDelta -= 360;
+    const double length = std::max(fabs(azDelta), fabs(alt2 - alt1));
+    const int steps     = std::max(1, int(std::ceil(length * 4 * m_RasterResolution)));
+    for (int i = 0; i <= steps; ++i)
+    {
+        const double fraction = i / static_cast<double>(steps);
+        if (!isVisible(az1 + fraction * azDelta, alt1 + fraction * (alt2 - alt1)))
+            return false;
+    }
+    return true;
+}
+
+bool ArtificialHorizon::isVisible(const SkyPoint &point, const GeoLocation *geo, const KStarsDateTime &start,
+                                  const KStarsDateTime &end, int stepSeconds) const
+{
+    SkyPoint p = point;
+    KStarsDateTime time = start;
+    while (true)
+    {
+        const bool last = time >= end;
+        if (last)
+            time = end;
+
+        CachingDms lst(geo->GSTtoLST(time.gst()));
+        p.EquatorialToHorizontal(&lst, geo->lat());
+        if (!isVisible(p.az().Degrees(), p.alt().Degrees()))
+            return false;
+        if (last)
+            return true;
+        time = time.addSecs(std::max(1, stepSeconds));
+    }
+}
@@ -8,8 +8,12 @@
 
 #include "noprecessindex.h"
 
+#include <QVector>
+
 #include <memory>
 
+class GeoLocation;
+class KStarsDateTime;
 class TestArtificialHorizon;
 
 // An ArtificialHorizonEntity is a set of Azimuth & Altitude values defining
@@ -58,6 +62,12 @@ class ArtificialHorizonEntity
 // at altitudes above the lowest ceiling. If there are a mix of ceilings and standard
 // entities, then for the given azimuth, at an altitude A, the view is blocked if
 // either the closest line below is a ceiling, or if the closest line above is a non-ceiling.
+//
+// The visibility of the enabled entities is rasterized into cells of azimuth and altitude.
+// A cell is either entirely visible, entirely blocked, or crossed by an entity, in which case
+// the point is checked against the entities. Most queries are then a single lookup, with the
+// same results as checking the entities. The raster, and the polygons drawn on the sky map,
+// are computed again when the entities change.
 class ArtificialHorizon
 {
     public:
@@ -81,6 +91,22 @@ class ArtificialHorizon
         // Returns true if the azimuth/altitude point is not blocked by the artificial horzon entities.
         bool isVisible(double azimuthDegrees, double altitudeDegrees) const;
 
+        // Returns true if no point of the line from az1,alt1 to az2,alt2, interpolated linearly the
+        // short way in azimuth, is blocked. The line is sampled at a quarter of the raster resolution.
+        bool isVisible(double az1, double alt1, double az2, double alt2) const;
+
+        // Returns true if the point, in apparent equatorial coordinates, is not blocked as seen from geo
+        // from start to end. The altitude is sampled every stepSeconds, and at end.
+        bool isVisible(const SkyPoint &point, const GeoLocation *geo, const KStarsDateTime &start,
+                       const KStarsDateTime &end, int stepSeconds = 60) const;
+
+        // Cells per degree of the visibility raster, 2 by default.
+        int rasterResolution() const
+        {
+            return m_RasterResolution;
+        }
+        void setRasterResolution(int cellsPerDegree);
+
         // returns the (highest) altitude constraint at the given azimuth.
         // If there are no constraints, then it returns -90.
         double altitudeConstraint(double azimuthDegrees) const;
@@ -122,6 +148,39 @@ class ArtificialHorizon
         double altitudeConstraintInternal(double azimuthDegrees) const;
         mutable QVector<double> precomputedConstraints;
 
+        // Visibility checked against the entities, without the raster.
+        bool isVisibleInternal(double azimuthDegrees, double altitudeDegrees) const;
+
+        // Resets the precomputed data if an entity was enabled, disabled or changed since it was computed.
+        void checkEntities() const;
+        void computeRaster() const;
+        void computeRasterColumn(int column, const QVector<double> &boundaries) const;
+
+        enum RasterCell : quint8
+        {
+            RASTER_VISIBLE,
+            RASTER_BLOCKED,
+            RASTER_ENTITY
+        };
+        int m_RasterResolution { 2 };
+        // Cells by azimuth column, then altitude row from -90 degrees. Empty if not computed.
+        mutable QVector<quint8> m_Raster;
+
+        // The state of the entities when the raster and the polygons were computed.
+        struct EntityState
+        {
+            const ArtificialHorizonEntity *entity;
+            const LineList *list;
+            int size;
+            bool enabled;
+            bool ceiling;
+        };
+        mutable QVector<EntityState> m_EntityStates;
+
+        // The polygons of the blocked areas in horizontal coordinates, empty if not computed.
+        mutable QList<LineList> m_Polygons;
+        mutable bool m_PolygonsValid { false };
+
         friend TestArtificialHorizon;
 };
 
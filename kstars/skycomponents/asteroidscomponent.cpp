@@ -14,6 +14,7 @@
 #include "kstarsdata.h"
 #include "kstars_debug.h"
 #include "Options.h"
+#include "pickingindex.h"
 #include "solarsystemcomposite.h"
 #include "skycomponent.h"
 #include "skylabeler.h"
@@ -204,6 +205,8 @@ void AsteroidsComponent::draw(SkyPainter *skyp)
         else
             drawn = skyp->drawPointSource(ast, ast->mag());
 
+        if (drawn)
+            PickingIndex::Instance()->add(ast, PickingIndex::MINOR_BODY);
         if (drawn && !(hideLabels || ast->mag() >= labelMagLimit))
             SkyLabeler::AddLabel(ast, SkyLabeler::ASTEROID_LABEL);
     }
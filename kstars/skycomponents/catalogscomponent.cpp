@@ -11,6 +11,7 @@
 #include "kstarsdata.h"
 #include "Options.h"
 #include "MeshIterator.h"
+#include "pickingindex.h"
 #include "projections/projector.h"
 #include "skylabeler.h"
 #include "kstars_debug.h"
@@ -156,8 +157,10 @@ void CatalogsComponent::draw(SkyPainter *skyp)
         }
     };
 
+    auto &pickingIndex = *PickingIndex::Instance();
+
     // Helper lambda to JIT update and draw
-    auto drawObjects = [&](std::vector<CatalogObject*>& objects) {
+    auto drawObjects = [&](std::vector<CatalogObject*>& objects, Trixel trixel) {
         // TODO: If we are sure that JITupdate has no side effects
         // that may cause races etc, it will be worth parallelizing
 
@@ -179,9 +182,11 @@ void CatalogsComponent::draw(SkyPainter *skyp)
             if (Options::showInlineImages())
                 object->load_image();
 
-            if (skyp->drawCatalogObject(*object) && !hideLabels)
+            if (skyp->drawCatalogObject(*object))
             {
-                labeler.drawNameLabel(object, proj.toScreen(object), label_padding);
+                pickingIndex.add(m_skyMesh, trixel, object, PickingIndex::DEEP_SKY);
+                if (!hideLabels)
+                    labeler.drawNameLabel(object, proj.toScreen(object), label_padding);
             }
         }
     };
@@ -225,7 +230,7 @@ void CatalogsComponent::draw(SkyPainter *skyp)
         }
 
         // JIT update and draw
-        drawObjects(drawListKnownMag);
+        drawObjects(drawListKnownMag, trixel);
     }
 
     // Handle the objects of unknown magnitude
@@ -273,7 +278,7 @@ void CatalogsComponent::draw(SkyPainter *skyp)
                 });
 
             // JIT update and draw
-            drawObjects(drawListUnknownMag);
+            drawObjects(drawListUnknownMag, trixel);
         }
 
     }
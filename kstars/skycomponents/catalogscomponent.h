@@ -10,6 +10,7 @@
 #include "skycomponent.h"
 #include "catalogsdb.h"
 #include "catalogobject.h"
+#include "pickingindex.h"
 #include "skymesh.h"
 #include "trixelcache.h"
 #include "Options.h"
@@ -110,6 +111,8 @@ class CatalogsComponent : public SkyComponent
          */
         void dropCache()
         {
+            // The picking index refers to the cached objects
+            PickingIndex::Instance()->invalidate();
             m_mainCache.clear();
             m_unknownMagCache.clear();
             m_catalog_colors = m_db_manager.get_catalog_colors();
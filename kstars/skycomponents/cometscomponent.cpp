@@ -21,6 +21,7 @@
 #include "kstarslite.h"
 #endif
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 #include "skypainter.h"
 #include "solarsystemcomposite.h"
@@ -83,6 +84,7 @@ void CometsComponent::loadData()
     emitProgressText(i18n("Loading comets"));
     qCInfo(KSTARS) << "Loading comets";
 
+    PickingIndex::Instance()->invalidate();
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
 
@@ -270,6 +272,8 @@ void CometsComponent::draw(SkyPainter *skyp)
         if (std::isnan(mag) == 0)
         {
             bool drawn = skyp->drawComet(com);
+            if (drawn)
+                PickingIndex::Instance()->add(com, PickingIndex::MINOR_BODY);
             if (drawn && !(hideLabels || com->rsun() >= rsunLabelLimit))
                 SkyLabeler::AddLabel(com, SkyLabeler::COMET_LABEL);
         }
@@ -47,6 +47,9 @@ class ConstellationLines : public LineListIndex
      */
     void JITupdate(LineList *lineList) override;
 
+    /** @short Stars are shared by several lines and updated by StarComponent too */
+    bool concurrentUpdate() override { return false; }
+
     /** @short Set the QColor and QPen for drawing. */
     void preDraw(SkyPainter *skyp) override;
 
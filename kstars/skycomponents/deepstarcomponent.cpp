@@ -9,6 +9,7 @@
 #include "byteorder.h"
 #include "kstarsdata.h"
 #include "Options.h"
+#include "pickingindex.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
 #endif
@@ -42,6 +43,7 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
 
 DeepStarComponent::~DeepStarComponent()
 {
+    PickingIndex::Instance()->invalidate();
     if (fileOpened)
         starReader.closeFile();
     fileOpened = false;
@@ -289,6 +291,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         maglim = hideStarsMag;
 
     StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
+    PickingIndex *pickingIndex           = PickingIndex::Instance();
     //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
     //    qDebug() << Q_FUNC_INFO << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
     QElapsedTimer t;
@@ -389,7 +392,10 @@ void DeepStarComponent::draw(SkyPainter *skyp)
                     break;
 
                 if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
+                {
                     visibleStarCount++;
+                    pickingIndex->add(m_skyMesh, currentRegion, curStar, PickingIndex::DEEP_STAR);
+                }
             }
         }
 
@@ -31,6 +31,16 @@
 #include "skypainter.h"
 #include "htmesh/MeshIterator.h"
 
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace
+{
+// Stale lists updated by a task when drawing
+constexpr int updateBatchSize = 64;
+}
+
 LineListIndex::LineListIndex(SkyComposite *parent, const QString &name) : SkyComponent(parent), m_name(name)
 {
     m_skyMesh   = SkyMesh::Instance();
@@ -182,22 +192,63 @@ void LineListIndex::drawLines(SkyPainter *skyp)
     DrawID drawID     = skyMesh()->drawID();
     UpdateID updateID = KStarsData::Instance()->updateID();
 
-    for (auto &lineListList : m_lineIndex->values())
+    // Collect the lists crossing the visible trixels, each one once
+    QVector<LineList *> visible;
+    QVector<LineList *> stale;
+
+    auto collect = [&](const std::shared_ptr<LineListList> &lineListList)
     {
-        for (int i = 0; i < lineListList->size(); i++)
+        for (const auto &lineList : *lineListList)
         {
-            std::shared_ptr<LineList> lineList = lineListList->at(i);
-
             if (lineList->drawID == drawID)
                 continue;
             lineList->drawID = drawID;
 
+            visible.append(lineList.get());
             if (lineList->updateID != updateID)
-                JITupdate(lineList.get());
+                stale.append(lineList.get());
+        }
+    };
+
+    if (cullLines())
+    {
+        MeshIterator region(skyMesh(), drawBuffer());
 
-            skyp->drawSkyPolyline(lineList.get(), skipList(lineList.get()), label());
+        while (region.hasNext())
+        {
+            std::shared_ptr<LineListList> lineListList = m_lineIndex->value(region.next());
+
+            if (lineListList != nullptr)
+                collect(lineListList);
         }
     }
+    else
+    {
+        for (const auto &lineListList : *m_lineIndex)
+            collect(lineListList);
+    }
+
+    // Update the stale lists in batches across the thread pool, the lists share no points
+    if (concurrentUpdate() && stale.size() > updateBatchSize)
+    {
+        QVector<QPair<int, int>> batches;
+        for (int i = 0; i < stale.size(); i += updateBatchSize)
+            batches.append(qMakePair(i, std::min(int(stale.size()), i + updateBatchSize)));
+
+        QtConcurrent::blockingMap(batches, [&](const QPair<int, int> &batch)
+        {
+            for (int i = batch.first; i < batch.second; i++)
+                JITupdate(stale.at(i));
+        });
+    }
+    else
+    {
+        for (LineList *lineList : stale)
+            JITupdate(lineList);
+    }
+
+    for (LineList *lineList : visible)
+        skyp->drawSkyPolyline(lineList, skipList(lineList), label());
 }
 
 void LineListIndex::drawFilled(SkyPainter *skyp)
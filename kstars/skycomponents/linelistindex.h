@@ -118,7 +118,9 @@ class LineListIndex : public SkyComponent
     void appendBoth(const std::shared_ptr<LineList> &lineList);
 
     /**
-     * @short Draws all the lines in m_listList as simple lines in float mode.
+     * @short Draws the lines crossing the visible trixels of drawBuffer() as
+     * simple lines in float mode.  The stale lists are JIT updated first, in
+     * batches across the global thread pool.
      */
     void drawLines(SkyPainter *skyp);
 
@@ -160,6 +162,21 @@ class LineListIndex : public SkyComponent
 
     virtual LineListLabel *label() { return nullptr; }
 
+    /**
+     * @short Controls whether drawLines() draws only the lines crossing the
+     * visible trixels.  Overridden to return false by the components whose
+     * points move on the sky between updates, since their trixel index is
+     * only valid for the coordinates at the time they were appended.
+     */
+    virtual bool cullLines() { return true; }
+
+    /**
+     * @short Controls whether drawLines() may call JITupdate() on several
+     * lists concurrently.  Overridden to return false by ConstellationLines,
+     * whose points are stars also updated by StarComponent.
+     */
+    virtual bool concurrentUpdate() { return true; }
+
     inline LineListList listList() const { return m_listList; }
 
   private:
@@ -7,6 +7,7 @@
 #include "listcomponent.h"
 
 #include "kstarsdata.h"
+#include "pickingindex.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
 #endif
@@ -26,6 +27,7 @@ ListComponent::~ListComponent()
 
 void ListComponent::clear()
 {
+    PickingIndex::Instance()->invalidate();
     while (!m_ObjectList.isEmpty())
     {
         SkyObject *o = m_ObjectList.takeFirst();
@@ -30,4 +30,8 @@ class LocalMeridianComponent : public CoordinateGrid
     void update(KSNumbers *) override;
 
     bool selected() override;
+
+  protected:
+    /** @short The points are fixed in horizontal coordinates, their trixels change with time */
+    bool cullLines() override { return false; }
 };
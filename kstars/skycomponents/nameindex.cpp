@@ -0,0 +1,494 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "nameindex.h"
+
+#include <QSet>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Lexicographic comparison of two runs of characters
+int compareKeys(const QChar *a, int na, const QChar *b, int nb)
+{
+    const int n = qMin(na, nb);
+    for (int i = 0; i < n; ++i)
+    {
+        if (a[i] != b[i])
+            return a[i].unicode() < b[i].unicode() ? -1 : 1;
+    }
+    return na - nb;
+}
+
+bool startsWith(const QChar *key, int length, const QString &text)
+{
+    return length >= text.size() && compareKeys(key, text.size(), text.constData(), text.size()) == 0;
+}
+
+// Normalized name, and if @p words is not null the positions in it of the words after the first one
+QString normalizeName(const QString &name, QVector<int> *words)
+{
+    QString key;
+    key.reserve(name.size());
+    bool boundary = false;
+    for (const QChar c : name)
+    {
+        if (c.isSpace())
+        {
+            boundary = true;
+            continue;
+        }
+        if (words && boundary && !key.isEmpty() && c.isLetterOrNumber())
+            words->append(key.size());
+        boundary = c.isPunct();
+        key.append(c.toCaseFolded());
+    }
+    return key;
+}
+
+// Edit distance between @p a and @p b, or maxDistance + 1 if larger
+int editDistance(const QString &a, const QString &b, int maxDistance)
+{
+    if (qAbs(a.size() - b.size()) > maxDistance)
+        return maxDistance + 1;
+
+    std::vector<int> row(b.size() + 1), next(b.size() + 1);
+    for (int j = 0; j <= b.size(); ++j)
+        row[j] = j;
+    for (int i = 1; i <= a.size(); ++i)
+    {
+        next[0]  = i;
+        int best = next[0];
+        for (int j = 1; j <= b.size(); ++j)
+        {
+            next[j] = std::min({ row[j] + 1, next[j - 1] + 1, row[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0) });
+            best    = std::min(best, next[j]);
+        }
+        if (best > maxDistance)
+            return maxDistance + 1;
+        row.swap(next);
+    }
+    return std::min(row.back(), maxDistance + 1);
+}
+}  // namespace
+
+NameIndex::NameIndex(const QHash<int, NameList> &lists) : m_Lists(lists)
+{
+}
+
+NameIndex::~NameIndex()
+{
+    for (auto &build : m_Builds)
+        build.waitForFinished();
+}
+
+QString NameIndex::normalize(const QString &name)
+{
+    return normalizeName(name, nullptr);
+}
+
+NameIndex::TypeIndexPtr NameIndex::build(NameList source)
+{
+    QSharedPointer<TypeIndex> index(new TypeIndex);
+    index->source = source;
+    index->names.reserve(source.size());
+    index->buffer.reserve(source.size() * 12);
+
+    QVector<int> words;
+    for (int i = 0; i < source.size(); ++i)
+    {
+        words.clear();
+        // at(), a non const access would detach the list
+        const QString key = normalizeName(source.at(i).first, &words);
+        const int offset  = index->buffer.size();
+        index->buffer.append(key);
+        index->names.append({ offset, key.size(), i });
+        for (const int start : words)
+            index->words.append({ offset + start, key.size() - start, i });
+    }
+
+    const QChar *buffer = index->buffer.constData();
+    auto less = [buffer](const Key & a, const Key & b)
+    {
+        return compareKeys(buffer + a.offset, a.length, buffer + b.offset, b.length) < 0;
+    };
+    std::sort(index->names.begin(), index->names.end(), less);
+    std::sort(index->words.begin(), index->words.end(), less);
+
+    return index;
+}
+
+NameIndex::TypeIndexPtr NameIndex::indexOf(int type)
+{
+    QMutexLocker locker(&m_Mutex);
+    return indexOfLocked(type);
+}
+
+NameIndex::TypeIndexPtr NameIndex::indexOfLocked(int type)
+{
+    auto pending = m_Builds.find(type);
+    if (pending != m_Builds.end() && pending->isFinished())
+    {
+        m_Indexes[type] = pending->result();
+        m_Builds.erase(pending);
+    }
+
+    auto list = m_Lists.constFind(type);
+    if (list == m_Lists.constEnd())
+        return TypeIndexPtr();
+
+    // The indexed copy shares the data of the list until either changes
+    TypeIndexPtr index = m_Indexes.value(type);
+    if (index && index->source.constData() == list->constData() && index->source.size() == list->size())
+        return index;
+
+    if (!m_Builds.contains(type))
+        m_Builds.insert(type, QtConcurrent::run(&NameIndex::build, *list));
+    return TypeIndexPtr();
+}
+
+QList<int> NameIndex::searchedTypes(const QList<int> &types) const
+{
+    if (!types.isEmpty())
+        return types;
+
+    // Not in the order of the hash, which changes between runs
+    QList<int> keys = m_Lists.keys();
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void NameIndex::update()
+{
+    QMutexLocker locker(&m_Mutex);
+    updateLocked();
+}
+
+void NameIndex::updateLocked()
+{
+    // Drop the builds of the lists removed meanwhile
+    for (auto build = m_Builds.begin(); build != m_Builds.end();)
+    {
+        if (!m_Lists.contains(build.key()) && build->isFinished())
+        {
+            m_Indexes.remove(build.key());
+            build = m_Builds.erase(build);
+        }
+        else
+            ++build;
+    }
+
+    for (const int type : m_Lists.keys())
+        indexOfLocked(type);
+}
+
+void NameIndex::waitForBuilds()
+{
+    // The lists cannot change meanwhile, so the finished builds are up to date
+    QMutexLocker locker(&m_Mutex);
+    while (!m_Builds.isEmpty())
+    {
+        // Queries may start builds meanwhile, they are waited for in the next round
+        const QList<QFuture<TypeIndexPtr>> builds = m_Builds.values();
+        locker.unlock();
+        for (auto build : builds)
+            build.waitForFinished();
+        locker.relock();
+        updateLocked();
+    }
+}
+
+bool NameIndex::isReady()
+{
+    QMutexLocker locker(&m_Mutex);
+    updateLocked();
+    return m_Builds.isEmpty();
+}
+
+QVector<NameIndex::Match> NameIndex::exact(const QString &name, const QList<int> &types)
+{
+    QVector<Match> matches;
+    const QString key = normalize(name);
+
+    for (const int type : searchedTypes(types))
+    {
+        auto list = m_Lists.constFind(type);
+        if (list == m_Lists.constEnd())
+            continue;
+
+        TypeIndexPtr index = indexOf(type);
+        if (!index)
+        {
+            for (const auto &item : *list)
+            {
+                if (normalize(item.first) == key)
+                    matches.append({ item.first, item.second, type, 0 });
+            }
+            continue;
+        }
+
+        const QChar *buffer = index->buffer.constData();
+        auto it             = std::lower_bound(index->names.cbegin(), index->names.cend(), key,
+                                               [buffer](const Key & k, const QString & text)
+        {
+            return compareKeys(buffer + k.offset, k.length, text.constData(), text.size()) < 0;
+        });
+        // Equal keys are in no particular order after sorting, return them in the order of the list
+        QVector<int> sources;
+        for (; it != index->names.cend() && it->length == key.size() &&
+                compareKeys(buffer + it->offset, it->length, key.constData(), key.size()) == 0;
+                ++it)
+            sources.append(it->source);
+        std::sort(sources.begin(), sources.end());
+        for (const int source : sources)
+        {
+            const auto &item = index->source.at(source);
+            matches.append({ item.first, item.second, type, 0 });
+        }
+    }
+
+    std::stable_partition(matches.begin(), matches.end(), [&name](const Match & match)
+    {
+        return match.name == name;
+    });
+    return matches;
+}
+
+QVector<NameIndex::Match> NameIndex::prefix(const QString &text, const QList<int> &types, int limit)
+{
+    QVector<Match> matches;
+    const QString key = normalize(text);
+
+    auto full = [&]()
+    {
+        return limit >= 0 && matches.size() >= limit;
+    };
+
+    for (const int type : searchedTypes(types))
+    {
+        if (full())
+            break;
+
+        auto list = m_Lists.constFind(type);
+        if (list == m_Lists.constEnd())
+            continue;
+
+        TypeIndexPtr index = indexOf(type);
+        if (!index)
+        {
+            QVector<int> words;
+            for (const auto &item : *list)
+            {
+                if (full())
+                    break;
+                words.clear();
+                const QString name = normalizeName(item.first, &words);
+                bool found         = name.startsWith(key);
+                for (int i = 0; !found && i < words.size(); ++i)
+                    found = startsWith(name.constData() + words[i], name.size() - words[i], key);
+                if (found)
+                    matches.append({ item.first, item.second, type, 0 });
+            }
+            continue;
+        }
+
+        // Whole names first, then the names with a matching word that were not found already
+        const QChar *buffer = index->buffer.constData();
+        QSet<int> found;
+        for (const QVector<Key> *keys : { &index->names, &index->words })
+        {
+            auto it = std::lower_bound(keys->cbegin(), keys->cend(), key, [buffer](const Key & k, const QString & text)
+            {
+                return compareKeys(buffer + k.offset, k.length, text.constData(), text.size()) < 0;
+            });
+            for (; it != keys->cend() && !full() && startsWith(buffer + it->offset, it->length, key); ++it)
+            {
+                if (keys == &index->words && found.contains(it->source))
+                    continue;
+                found.insert(it->source);
+                const auto &item = index->source.at(it->source);
+                matches.append({ item.first, item.second, type, 0 });
+            }
+        }
+    }
+    return matches;
+}
+
+QVector<NameIndex::Match> NameIndex::contains(const QString &text, const QList<int> &types, int limit)
+{
+    QVector<Match> matches;
+    for (const int type : searchedTypes(types))
+    {
+        auto list = m_Lists.constFind(type);
+        if (list == m_Lists.constEnd())
+            continue;
+
+        for (const auto &item : *list)
+        {
+            if (limit >= 0 && matches.size() >= limit)
+                return matches;
+            if (item.first.contains(text, Qt::CaseInsensitive))
+                matches.append({ item.first, item.second, type, 0 });
+        }
+    }
+    return matches;
+}
+
+namespace
+{
+/**
+ * Depth first walk of sorted keys as a trie. Every node is the range of keys sharing a prefix,
+ * its children are found by binary search on the next character. The edit distance between
+ * the query and the prefix is computed row by row, and a branch is dropped as soon as every
+ * entry of its row exceeds the maximum distance.
+ */
+template <typename Key>
+class FuzzyWalk
+{
+    public:
+        FuzzyWalk(const QChar *buffer, const QVector<Key> &keys, const QString &query, int maxDistance)
+            : m_Buffer(buffer), m_Keys(keys), m_Query(query), m_Width(query.size() + 1), m_MaxDistance(maxDistance),
+              m_Rows((query.size() + maxDistance + 2) * m_Width)
+        {
+            for (int j = 0; j < m_Width; ++j)
+                m_Rows[j] = j;
+        }
+
+        /** @return the positions of the matching keys with their distances */
+        QVector<QPair<int, int>> run()
+        {
+            walk(0, m_Keys.size(), 0);
+            return m_Found;
+        }
+
+    private:
+        /** @return the smallest entry of the row of the child of @p row on character @p c */
+        int childRow(const int *row, int *next, int depth, QChar c) const
+        {
+            next[0]  = depth + 1;
+            int best = next[0];
+            for (int q = 1; q < m_Width; ++q)
+            {
+                next[q] = std::min({ row[q] + 1, next[q - 1] + 1, row[q - 1] + (m_Query[q - 1] != c ? 1 : 0) });
+                best    = std::min(best, next[q]);
+            }
+            return best;
+        }
+
+        /** @return the end of the keys in [@p lo, @p hi) with a character at @p depth not above @p c */
+        int upperBound(int lo, int hi, int depth, QChar c) const
+        {
+            return std::upper_bound(m_Keys.cbegin() + lo, m_Keys.cbegin() + hi, c, [this, depth](QChar ch, const Key & k)
+            {
+                return ch.unicode() < m_Buffer[k.offset + depth].unicode();
+            }) - m_Keys.cbegin();
+        }
+
+        void walk(int lo, int hi, int depth)
+        {
+            const int *row = &m_Rows[depth * m_Width];
+            const int last = m_Width - 1;
+
+            // The key equal to the prefix sorts first
+            int i = lo;
+            for (; i < hi && m_Keys[i].length == depth; ++i)
+            {
+                if (row[last] <= m_MaxDistance)
+                    m_Found.append({ i, row[last] });
+            }
+            if (i == hi)
+                return;
+
+            // Entries of a row are at least depth - query length, so walks stop before the last row
+            int *next = &m_Rows[(depth + 1) * m_Width];
+
+            // Any character missing from the query around this depth gives the same row. When that row is
+            // too far already, only the children on the characters of the query are worth looking up.
+            if (childRow(row, next, depth, QChar()) > m_MaxDistance)
+            {
+                QVector<QChar> chars;
+                for (int q = qMax(0, depth - m_MaxDistance); q <= qMin(m_Width - 2, depth + m_MaxDistance); ++q)
+                    chars.append(m_Query[q]);
+                std::sort(chars.begin(), chars.end());
+                chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+                for (const QChar c : chars)
+                {
+                    const int begin = std::lower_bound(m_Keys.cbegin() + i, m_Keys.cbegin() + hi, c,
+                                                       [this, depth](const Key & k, QChar ch)
+                    {
+                        return m_Buffer[k.offset + depth].unicode() < ch.unicode();
+                    }) - m_Keys.cbegin();
+                    const int end = upperBound(begin, hi, depth, c);
+                    if (begin < end && childRow(row, next, depth, c) <= m_MaxDistance)
+                        walk(begin, end, depth + 1);
+                    i = end;
+                }
+                return;
+            }
+
+            while (i < hi)
+            {
+                const QChar c = m_Buffer[m_Keys[i].offset + depth];
+                const int end = upperBound(i, hi, depth, c);
+                if (childRow(row, next, depth, c) <= m_MaxDistance)
+                    walk(i, end, depth + 1);
+                i = end;
+            }
+        }
+
+        const QChar *m_Buffer;
+        const QVector<Key> &m_Keys;
+        const QString &m_Query;
+        const int m_Width;
+        const int m_MaxDistance;
+        std::vector<int> m_Rows;
+        QVector<QPair<int, int>> m_Found;
+};
+}  // namespace
+
+QVector<NameIndex::Match> NameIndex::fuzzy(const QString &text, int maxDistance, const QList<int> &types, int limit)
+{
+    QVector<Match> matches;
+    const QString key = normalize(text);
+
+    for (const int type : searchedTypes(types))
+    {
+        auto list = m_Lists.constFind(type);
+        if (list == m_Lists.constEnd())
+            continue;
+
+        TypeIndexPtr index = indexOf(type);
+        if (!index)
+        {
+            for (const auto &item : *list)
+            {
+                const int distance = editDistance(normalize(item.first), key, maxDistance);
+                if (distance <= maxDistance)
+                    matches.append({ item.first, item.second, type, distance });
+            }
+            continue;
+        }
+
+        FuzzyWalk<Key> walk(index->buffer.constData(), index->names, key, maxDistance);
+        for (const auto &found : walk.run())
+        {
+            const auto &item = index->source.at(index->names[found.first].source);
+            matches.append({ item.first, item.second, type, found.second });
+        }
+    }
+
+    std::stable_sort(matches.begin(), matches.end(), [](const Match & a, const Match & b)
+    {
+        return a.distance < b.distance;
+    });
+    if (limit >= 0 && matches.size() > limit)
+        matches.resize(limit);
+    return matches;
+}
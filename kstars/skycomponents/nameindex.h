@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class SkyObject;
+
+/**
+ * @class NameIndex
+ * Index of the object names registered in SkyComponent::objectLists(), used by
+ * SkyMapComposite::findByName() and the Find dialog.
+ *
+ * Names are normalized, see normalize(), and kept in sorted arrays, one per object type.
+ * Exact and prefix queries are binary searches. Prefix queries also match the start of
+ * every word of a name, so that "galaxy" finds "Andromeda Galaxy". Fuzzy queries walk
+ * the sorted names as a trie, computing the edit distance to the query one character
+ * at a time and skipping every branch already too far from it.
+ *
+ * The index of a type is built in a background thread from a copy of its name list.
+ * The copy shares the data of the list, so any change of the list detaches it and the
+ * index of that type is known to be out of date. Queries rebuild such indexes in the
+ * background, and meanwhile scan the changed lists directly.
+ *
+ * Queries may come from any thread, the indexes and pending builds are guarded by a mutex.
+ * The name lists themselves must only change in the thread that owns them.
+ */
+class NameIndex
+{
+    public:
+        typedef QVector<QPair<QString, const SkyObject *>> NameList;
+
+        struct Match
+        {
+            /** The name as registered */
+            QString name;
+            const SkyObject *object { nullptr };
+            /** The type of the object, the key of its name list */
+            int type { 0 };
+            /** Edit distance between the normalized name and query, 0 except for fuzzy queries */
+            int distance { 0 };
+        };
+
+        /** @param lists the name lists to index, must outlive the index */
+        explicit NameIndex(const QHash<int, NameList> &lists);
+        ~NameIndex();
+
+        /** @short Start building the indexes of the name lists that changed since they were indexed. */
+        void update();
+
+        /** @short Block until the pending builds are finished. */
+        void waitForBuilds();
+
+        /** @return true if the indexes of all the name lists are up to date */
+        bool isReady();
+
+        /**
+         * @short Find the names equal to @p name, once normalized.
+         * The names with the same case as @p name come first, then the matches are in the order of the
+         * types, and of the lists of each type.
+         * @param types the types of object to search, all if empty, in increasing order then
+         */
+        QVector<Match> exact(const QString &name, const QList<int> &types = QList<int>());
+
+        /**
+         * @short Find the names starting with @p text, or with a word starting with @p text.
+         * @param types the types of object to search, all if empty
+         * @param limit maximum number of matches, no limit if negative
+         */
+        QVector<Match> prefix(const QString &text, const QList<int> &types = QList<int>(), int limit = -1);
+
+        /**
+         * @short Find the names containing @p text anywhere, ignoring case, by scanning the name lists.
+         * @param types the types of object to search, all if empty
+         * @param limit maximum number of matches, no limit if negative
+         */
+        QVector<Match> contains(const QString &text, const QList<int> &types = QList<int>(), int limit = -1);
+
+        /**
+         * @short Find the names within @p maxDistance edits of @p text, once normalized.
+         * The matches are sorted by increasing distance.
+         * @param types the types of object to search, all if empty
+         * @param limit maximum number of matches, no limit if negative
+         */
+        QVector<Match> fuzzy(const QString &text, int maxDistance, const QList<int> &types = QList<int>(),
+                             int limit = 100);
+
+        /**
+         * @return the search key of @p name: case folded, without white space.
+         * "M 31" and "m31" have the same key.
+         */
+        static QString normalize(const QString &name);
+
+    private:
+        struct Key
+        {
+            /** Position of the key in the buffer of the type */
+            int offset;
+            int length;
+            /** Position of the name in the list of the type */
+            int source;
+        };
+
+        struct TypeIndex
+        {
+            /** Copy of the indexed list, sharing its data until the list changes */
+            NameList source;
+            /** The normalized names, one after another */
+            QString buffer;
+            /** Keys of the whole names, sorted */
+            QVector<Key> names;
+            /** Keys of the words after the first one, sorted. They point into the whole names. */
+            QVector<Key> words;
+        };
+
+        typedef QSharedPointer<const TypeIndex> TypeIndexPtr;
+
+        static TypeIndexPtr build(NameList source);
+
+        /** @return the up to date index of @p type, or null if the list must be scanned */
+        TypeIndexPtr indexOf(int type);
+        /** Same as indexOf(), with m_Mutex already locked */
+        TypeIndexPtr indexOfLocked(int type);
+        /** Same as update(), with m_Mutex already locked */
+        void updateLocked();
+
+        /** @return the types to search for @p types */
+        QList<int> searchedTypes(const QList<int> &types) const;
+
+        const QHash<int, NameList> &m_Lists;
+        QMutex m_Mutex;
+        QHash<int, TypeIndexPtr> m_Indexes;
+        QHash<int, QFuture<TypeIndexPtr>> m_Builds;
+};
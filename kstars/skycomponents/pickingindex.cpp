@@ -0,0 +1,215 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "pickingindex.h"
+
+#include "kstarsdata.h"
+#include "skymesh.h"
+#include "htmesh/MeshIterator.h"
+#include "skyobjects/skyobject.h"
+
+#include <cmath>
+
+PickingIndex *PickingIndex::pinstance = nullptr;
+
+PickingIndex *PickingIndex::Instance()
+{
+    if (!pinstance)
+        pinstance = new PickingIndex();
+    return pinstance;
+}
+
+void PickingIndex::begin(const Projector *proj, double radius)
+{
+    m_Valid = false;
+
+    // Keep the allocated lists, the next frame usually covers the same trixels
+    for (auto &layer : m_Layers)
+    {
+        for (auto &list : layer.trixels)
+            list.clear();
+        layer.lastTrixel = -1;
+        layer.lastList   = nullptr;
+    }
+    m_LastLayer = -1;
+    m_Loose.clear();
+    m_Size = 0;
+
+    m_Projection       = proj->type();
+    m_ViewParams       = proj->viewParams();
+    m_FocusRA          = m_ViewParams.focus ? m_ViewParams.focus->ra().Degrees() : 0;
+    m_FocusDec         = m_ViewParams.focus ? m_ViewParams.focus->dec().Degrees() : 0;
+    m_ViewParams.focus = nullptr;
+    m_Radius           = radius;
+}
+
+void PickingIndex::end()
+{
+    m_Valid = true;
+}
+
+void PickingIndex::invalidate()
+{
+    m_Valid = false;
+}
+
+void PickingIndex::add(SkyMesh *mesh, Trixel trixel, SkyObject *object, ObjectKind kind)
+{
+    if (m_LastLayer < 0 || m_Layers[m_LastLayer].mesh != mesh)
+    {
+        m_LastLayer = -1;
+        for (int i = 0; i < m_Layers.size(); ++i)
+        {
+            if (m_Layers[i].mesh == mesh)
+                m_LastLayer = i;
+        }
+        if (m_LastLayer < 0)
+        {
+            m_Layers.append(Layer());
+            m_LastLayer          = m_Layers.size() - 1;
+            m_Layers.last().mesh = mesh;
+        }
+    }
+
+    // Components draw trixel after trixel, so the list of the previous object is usually the right one
+    Layer &layer = m_Layers[m_LastLayer];
+    if (!layer.lastList || layer.lastTrixel != trixel)
+    {
+        layer.lastTrixel = trixel;
+        layer.lastList   = &layer.trixels[trixel];
+    }
+    layer.lastList->append({ object, kind });
+    ++m_Size;
+}
+
+void PickingIndex::add(SkyObject *object, ObjectKind kind)
+{
+    m_Loose.append({ object, kind });
+    ++m_Size;
+}
+
+bool PickingIndex::covers(const SkyPoint *p, double maxrad, const Projector *proj) const
+{
+    if (!m_Valid || !proj)
+        return false;
+
+    // The view must not have changed since the frame was drawn
+    const ViewParams vp = proj->viewParams();
+    if (proj->type() != m_Projection || !vp.focus || vp.width != m_ViewParams.width ||
+            vp.height != m_ViewParams.height || vp.zoomFactor != m_ViewParams.zoomFactor ||
+            vp.useAltAz != m_ViewParams.useAltAz || vp.useRefraction != m_ViewParams.useRefraction ||
+            vp.fillGround != m_ViewParams.fillGround || vp.focus->ra().Degrees() != m_FocusRA ||
+            vp.focus->dec().Degrees() != m_FocusDec)
+        return false;
+
+    // The components only drew the aperture around the focus
+    SkyPoint focus(dms(m_FocusRA), dms(m_FocusDec));
+    if (focus.angularDistanceTo(p).Degrees() + maxrad > m_Radius)
+        return false;
+
+    // Objects off screen were not drawn, so the search circle must lie inside the frame.
+    // The margin is twice the nominal radius to allow for the distortion of the projection.
+    SkyPoint point(p->ra(), p->dec());
+    if (vp.useAltAz)
+    {
+        KStarsData *data = KStarsData::Instance();
+        point.EquatorialToHorizontal(data->lst(), data->geo()->lat());
+    }
+
+    bool visible        = false;
+    const QPointF pos   = proj->toScreen(&point, true, &visible);
+    const double margin = 2.0 * maxrad * dms::DegToRad * vp.zoomFactor;
+
+    return visible && pos.x() >= margin && pos.y() >= margin && pos.x() <= vp.width - margin &&
+           pos.y() <= vp.height - margin;
+}
+
+double PickingIndex::starDistance(float mag, double r)
+{
+    if (mag < 4.0)
+        return r * 0.75;
+    if (mag > 12.0)
+        return r * 1.75;
+    return r * 1.5;
+}
+
+double PickingIndex::weightedDistance(const Entry &entry, double r)
+{
+    // Same preferences as the search of the components in SkyMapComposite::objectNearest()
+    switch (entry.kind)
+    {
+        case STAR:
+            // Named stars are preferred to the unnamed stars of the deep star catalogs
+            return starDistance(entry.object->mag(), r * 0.5);
+        case DEEP_STAR:
+            return starDistance(entry.object->mag(), r);
+        case SOLAR_SYSTEM:
+            // Sun, moon, major planets and their moons
+            return r * 0.25;
+        case MINOR_BODY:
+            // There are gazillions of faint asteroids and comets, only bright ones get some precedence
+            if (std::isfinite(entry.object->mag()) && entry.object->mag() < 12.0)
+                return r * 0.75;
+            return r;
+        default:
+            return r;
+    }
+}
+
+SkyObject *PickingIndex::objectNearest(SkyPoint *p, double &maxrad, ObjectKind *kind) const
+{
+    const Entry *best = nullptr;
+    double rBest      = maxrad;
+
+    auto consider = [&](const Entry & entry)
+    {
+        const double r = entry.object->angularDistanceTo(p).Degrees();
+        if (r >= maxrad)
+            return;
+        const double weighted = weightedDistance(entry, r);
+        if (weighted < rBest)
+        {
+            rBest = weighted;
+            best  = &entry;
+        }
+    };
+
+    for (const auto &layer : m_Layers)
+    {
+        // Stars are indexed at their proper motion corrected position, hence the extra degree
+        layer.mesh->aperture(p, maxrad + 1.0, OBJ_NEAREST_BUF);
+        MeshIterator region(layer.mesh, OBJ_NEAREST_BUF);
+        while (region.hasNext())
+        {
+            auto list = layer.trixels.constFind(region.next());
+            if (list == layer.trixels.constEnd())
+                continue;
+            for (const auto &entry : *list)
+                consider(entry);
+        }
+    }
+
+    // The difference in declination is a lower bound of the distance, and much cheaper
+    const double dec = p->dec().Degrees();
+    for (const auto &entry : m_Loose)
+    {
+        if (std::fabs(entry.object->dec().Degrees() - dec) < maxrad)
+            consider(entry);
+    }
+
+    if (!best)
+        return nullptr;
+
+    maxrad = rBest;
+    if (kind)
+        *kind = best->kind;
+    return best->object;
+}
+
+int PickingIndex::size() const
+{
+    return m_Size;
+}
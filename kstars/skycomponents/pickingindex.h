@@ -0,0 +1,133 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "typedef.h"
+#include "projections/projector.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <atomic>
+
+class SkyMesh;
+class SkyObject;
+class SkyPoint;
+
+/**
+ * @class PickingIndex
+ * Index of the objects drawn in the last frame of the sky map, used to answer
+ * SkyMapComposite::objectNearest() for hover and click handling.
+ *
+ * Components register each object they actually draw. Objects of components that
+ * iterate their own trixel index (stars, deep sky objects) are stored by that trixel,
+ * so a query only looks at the few trixels around the point. The other objects
+ * (solar system, satellites, supernovae) are few and stored in a flat list.
+ *
+ * The index only answers for points whose search radius lies well inside the last
+ * frame drawn with the current view, see covers(). Anywhere else the caller must
+ * fall back to searching the components.
+ *
+ * Like SkyLabeler, there is a single instance shared by the components.
+ */
+class PickingIndex
+{
+    public:
+        /** Kind of object, used to weigh the distances as the component searches do. */
+        enum ObjectKind
+        {
+            STAR,
+            DEEP_STAR,
+            DEEP_SKY,
+            SOLAR_SYSTEM,
+            MINOR_BODY,
+            SATELLITE,
+            SUPERNOVA
+        };
+
+        static PickingIndex *Instance();
+
+        /**
+         * @short Start indexing a new frame, forgetting the objects of the previous one.
+         * @param proj the projector the frame is drawn with
+         * @param radius radius in degrees of the aperture drawn around the focus
+         */
+        void begin(const Projector *proj, double radius);
+
+        /** @short The frame is complete, the index can answer queries. */
+        void end();
+
+        /**
+         * @short Forget the current frame, must be called when indexed objects are deleted,
+         * or when the star blocks they are in are released.
+         */
+        void invalidate();
+
+        /** @short Register an object drawn from @p trixel of @p mesh */
+        void add(SkyMesh *mesh, Trixel trixel, SkyObject *object, ObjectKind kind);
+
+        /** @short Register a drawn object that has no trixel */
+        void add(SkyObject *object, ObjectKind kind);
+
+        /**
+         * @return true if the index holds every drawn object within @p maxrad degrees of @p p,
+         * for the view of @p proj.
+         */
+        bool covers(const SkyPoint *p, double maxrad, const Projector *proj) const;
+
+        /**
+         * @short Find the drawn object nearest to @p p.
+         * Distances are weighted by object kind, so that faint stars and asteroids do not take
+         * precedence over planets and deep sky objects.
+         * @param p the query point
+         * @param maxrad the search radius in degrees, set to the weighted distance of the result
+         * @param kind if not null, set to the kind of the result
+         * @return the nearest object, or nullptr if none was drawn within @p maxrad
+         */
+        SkyObject *objectNearest(SkyPoint *p, double &maxrad, ObjectKind *kind = nullptr) const;
+
+        /** @return the number of indexed objects */
+        int size() const;
+
+    private:
+        PickingIndex() = default;
+
+        struct Entry
+        {
+            SkyObject *object;
+            ObjectKind kind;
+        };
+
+        typedef QVector<Entry> EntryList;
+
+        struct Layer
+        {
+            SkyMesh *mesh { nullptr };
+            QHash<Trixel, EntryList> trixels;
+            Trixel lastTrixel { -1 };
+            EntryList *lastList { nullptr };
+        };
+
+        /** @return the distance @p r to a star of magnitude @p mag, weighted as the component search does */
+        static double starDistance(float mag, double r);
+        /** @return the distance to @p p weighted by the kind of the entry */
+        static double weightedDistance(const Entry &entry, double r);
+
+        static PickingIndex *pinstance;
+
+        QVector<Layer> m_Layers;
+        int m_LastLayer { -1 };
+        EntryList m_Loose;
+        int m_Size { 0 };
+
+        // View of the indexed frame
+        std::atomic<bool> m_Valid { false };
+        Projector::Projection m_Projection { Projector::Lambert };
+        ViewParams m_ViewParams;
+        double m_FocusRA { 0 }, m_FocusDec { 0 };
+        double m_Radius { 0 };
+};
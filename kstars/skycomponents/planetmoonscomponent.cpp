@@ -8,6 +8,7 @@
 
 #include "kstarsdata.h"
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 #include "skypainter.h"
 #include "kssun.h"
@@ -124,7 +125,8 @@ void PlanetMoonsComponent::draw(SkyPainter *skyp)
         else
         {
             //Draw Moons that are further than the planet
-            skyp->drawPointSource(pmoons->moon(i), pmoons->moon(i)->mag());
+            if (skyp->drawPointSource(pmoons->moon(i), pmoons->moon(i)->mag()))
+                PickingIndex::Instance()->add(pmoons->moon(i), PickingIndex::SOLAR_SYSTEM);
         }
     }
 
@@ -134,7 +136,8 @@ void PlanetMoonsComponent::draw(SkyPainter *skyp)
     //Now draw the remaining moons, as stored in frontMoons
     foreach (TrailObject *moon, frontMoons)
     {
-        skyp->drawPointSource(moon, moon->mag());
+        if (skyp->drawPointSource(moon, moon->mag()))
+            PickingIndex::Instance()->add(moon, PickingIndex::SOLAR_SYSTEM);
     }
 
     //Draw Moon name labels if at high zoom
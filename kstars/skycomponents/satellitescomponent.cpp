@@ -10,6 +10,7 @@
 #include "ksnotification.h"
 #include "kstarsdata.h"
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 #include "skymap.h"
 #include "skypainter.h"
@@ -20,6 +21,8 @@
 #include <QProgressDialog>
 #include <QtConcurrent>
 
+#include <numeric>
+
 SatellitesComponent::SatellitesComponent(SkyComposite *parent) : SkyComponent(parent)
 {
     QtConcurrent::run(this, &SatellitesComponent::loadData);
@@ -81,12 +84,82 @@ void SatellitesComponent::update(KSNumbers *)
     if (!selected())
         return;
 
+    // The observer is shared by all satellites, and each satellite only touches its own state,
+    // so the whole set is propagated concurrently.
+    struct PendingUpdate
+    {
+        SatelliteGroup *group;
+        Satellite *sat;
+        int rc;
+    };
+
+    const Satellite::Observer observer = Satellite::currentObserver();
+    // Below the horizon satellites are hidden by the ground, so they can wait for their earliest rise
+    const bool skipBelowHorizon = Options::showGround();
+
+    QVector<PendingUpdate> updates;
     foreach (SatelliteGroup *group, m_groups)
     {
-        group->updateSatellitesPos();
+        for (int i = 0; i < group->size(); i++)
+        {
+            Satellite *sat = group->at(i);
+            if (sat->selected() && !(skipBelowHorizon && sat->isBelowHorizonUntil(observer)))
+                updates.append({ group, sat, 0 });
+        }
+    }
+
+    QtConcurrent::blockingMap(updates, [&observer](PendingUpdate & update)
+    {
+        update.rc = update.sat->updatePos(observer);
+    });
+
+    // If position cannot be calculated, remove it from list
+    for (const auto &update : updates)
+    {
+        if (update.rc != 0)
+            update.group->removeOne(update.sat);
     }
 }
 
+QList<QPair<Satellite *, Satellite::Pass>> SatellitesComponent::findPasses(double startJD, double endJD,
+        double minAltitude)
+{
+    QVector<Satellite *> sats;
+    foreach (SatelliteGroup *group, m_groups)
+    {
+        for (int i = 0; i < group->size(); i++)
+        {
+            if (group->at(i)->selected())
+                sats.append(group->at(i));
+        }
+    }
+
+    const GeoLocation *geo = KStarsData::Instance()->geo();
+    QVector<QList<Satellite::Pass>> passes(sats.size());
+    QVector<int> indexes(sats.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    QtConcurrent::blockingMap(indexes, [&](int i)
+    {
+        passes[i] = sats[i]->findPasses(geo, startJD, endJD, minAltitude);
+    });
+
+    QList<QPair<Satellite *, Satellite::Pass>> result;
+    for (int i = 0; i < sats.size(); i++)
+    {
+        for (const auto &pass : passes[i])
+            result.append(qMakePair(sats[i], pass));
+    }
+
+    std::sort(result.begin(), result.end(), [](const QPair<Satellite *, Satellite::Pass> &a,
+              const QPair<Satellite *, Satellite::Pass> &b)
+    {
+        return a.second.riseJD < b.second.riseJD;
+    });
+
+    return result;
+}
+
 void SatellitesComponent::draw(SkyPainter *skyp)
 {
 #ifndef KSTARS_LITE
@@ -102,7 +175,8 @@ void SatellitesComponent::draw(SkyPainter *skyp)
         {
             Satellite *sat = group->at(i);
 
-            if (sat->selected())
+            // Satellites below the horizon may not have been updated, their equatorial position is stale
+            if (sat->selected() && !(Options::showGround() && sat->alt().Degrees() < 0))
             {
                 bool drawn = false;
                 if (Options::showVisibleSatellites())
@@ -115,6 +189,8 @@ void SatellitesComponent::draw(SkyPainter *skyp)
                     drawn = skyp->drawSatellite(sat);
                 }
 
+                if (drawn)
+                    PickingIndex::Instance()->add(sat, PickingIndex::SATELLITE);
                 if (drawn && !hideLabels)
                     SkyLabeler::AddLabel(sat, SkyLabeler::SATELLITE_LABEL);
             }
@@ -170,6 +246,8 @@ void SatellitesComponent::updateTLEs()
             {
                 file.write(response->readAll());
                 file.close();
+                // Reading the TLEs deletes the satellites of the group
+                PickingIndex::Instance()->invalidate();
                 group->readTLE();
                 group->updateSatellitesPos();
                 progressDlg.setValue(++i);
@@ -8,11 +8,12 @@
 
 #include "satellitegroup.h"
 #include "skycomponent.h"
+#include "skyobjects/satellite.h"
 
 #include <QList>
+#include <QPair>
 
 class QPointF;
-class Satellite;
 
 /**
  * @class SatellitesComponent
@@ -51,6 +52,16 @@ class SatellitesComponent : public SkyComponent
          */
         void update(KSNumbers *num) override;
 
+        /**
+         * Compute the passes of all selected satellites for the current location.
+         * Satellites are processed concurrently.
+         * @param startJD Beginning of the time window (UTC Julian day)
+         * @param endJD End of the time window (UTC Julian day)
+         * @param minAltitude Minimum altitude of a pass in degrees
+         * @return The passes sorted by rise time
+         */
+        QList<QPair<Satellite *, Satellite::Pass>> findPasses(double startJD, double endJD, double minAltitude = 0.0);
+
         /**
          * Download new TLE files
          */
@@ -6,6 +6,8 @@
 
 #include "skylabeler.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 
 #include <QPainter>
@@ -16,17 +18,11 @@
 #include "skymap.h"
 #include "projections/projector.h"
 
-//---------------------------------------------------------------------------//
-// A Little data container class
-//---------------------------------------------------------------------------//
-
-typedef struct LabelRun
+namespace
 {
-    LabelRun(int s, int e) : start(s), end(e) {}
-    int start;
-    int end;
-
-} LabelRun;
+// Rows of the virtual screen per line of text
+constexpr int rowsPerLine = 4;
+}
 
 //----- Now for the main event ----------------------------------------------//
 
@@ -97,17 +93,7 @@ SkyLabeler::SkyLabeler()
 #endif
 }
 
-SkyLabeler::~SkyLabeler()
-{
-    for (auto &row : screenRows)
-    {
-        for (auto &item : *row)
-        {
-            delete item;
-        }
-        delete row;
-    }
-}
+SkyLabeler::~SkyLabeler() = default;
 
 bool SkyLabeler::drawGuideLabel(QPointF &o, const QString &text, double angle)
 {
@@ -165,10 +151,8 @@ bool SkyLabeler::drawNameLabel(SkyObject *obj, const QPointF &_p,
     if (sLabel.isEmpty())
         return false;
 
-    double offset = obj->labelOffset();
-    QPointF p(_p.x() + offset, _p.y() + offset);
-
-    if (!markText(p, sLabel, padding_factor))
+    QPointF p;
+    if (!markLabel(_p, obj->labelOffset(), sLabel, p, padding_factor))
     {
         return false;
     }
@@ -265,53 +249,15 @@ void SkyLabeler::reset(SkyMap *skyMap)
     setZoomFont();
     m_skyFont     = m_p.font();
     m_fontMetrics = QFontMetrics(m_skyFont);
-    m_minDeltaX   = (int)m_fontMetrics.width("MMMMM");
 
     // ----- Set up Zoom Dependent Offset -----
     m_offset = SkyLabeler::ZoomOffset();
 
     // ----- Prepare Virtual Screen -----
-    m_yScale = (m_fontMetrics.height() + 1.0);
-
-    int maxY = int(skyMap->height() / m_yScale);
-    if (maxY < 1)
-        maxY = 1; // prevents a crash below?
-
-    int m_maxX = skyMap->width();
-    m_size     = (maxY + 1) * m_maxX;
-
-    // Resize if needed:
-    if (maxY > m_maxY)
-    {
-        screenRows.resize(m_maxY);
-        for (int y = m_maxY; y <= maxY; y++)
-        {
-            screenRows.append(new LabelRow());
-        }
-        //printf("resize: %d -> %d, size:%d\n", m_maxY, maxY, screenRows.size());
-    }
-
-    // Clear all pre-existing rows as needed
-
-    int minMaxY = (maxY < m_maxY) ? maxY : m_maxY;
-
-    for (int y = 0; y <= minMaxY; y++)
-    {
-        LabelRow *row = screenRows[y];
-
-        for (auto &item : *row)
-        {
-            delete item;
-        }
-        row->clear();
-    }
-
-    // never decrease m_maxY:
-    if (m_maxY < maxY)
-        m_maxY = maxY;
+    resizeScreen(skyMap->width(), skyMap->height());
 
     // reset the counters
-    m_marks = m_hits = m_misses = m_elements = 0;
+    m_marks = m_hits = m_misses = 0;
 
     //----- Clear out labelList -----
     for (auto &item : labelList)
@@ -331,59 +277,53 @@ void SkyLabeler::reset()
     setZoomFont();
     m_skyFont     = m_drawFont;
     m_fontMetrics = QFontMetrics(m_skyFont);
-    m_minDeltaX   = (int)m_fontMetrics.width("MMMMM");
     // ----- Set up Zoom Dependent Offset -----
     m_offset = ZoomOffset();
 
     // ----- Prepare Virtual Screen -----
-    m_yScale = (m_fontMetrics.height() + 1.0);
+    resizeScreen(skyMap->width(), skyMap->height());
 
-    int maxY = int(skyMap->height() / m_yScale);
-    if (maxY < 1)
-        maxY = 1; // prevents a crash below?
-
-    int m_maxX = skyMap->width();
-    m_size     = (maxY + 1) * m_maxX;
+    // reset the counters
+    m_marks = m_hits = m_misses = 0;
 
-    // Resize if needed:
-    if (maxY > m_maxY)
+    //----- Clear out labelList -----
+    for (int i = 0; i < labelList.size(); i++)
     {
-        screenRows.resize(m_maxY);
-        for (int y = m_maxY; y <= maxY; y++)
-        {
-            screenRows.append(new LabelRow());
-        }
-        //printf("resize: %d -> %d, size:%d\n", m_maxY, maxY, screenRows.size());
+        labelList[i].clear();
     }
+}
+#endif
 
-    // Clear all pre-existing rows as needed
+void SkyLabeler::resizeScreen(int width, int height)
+{
+    m_yScale = (m_fontMetrics.height() + 1.0) / rowsPerLine;
 
-    int minMaxY = (maxY < m_maxY) ? maxY : m_maxY;
+    int maxY = int(height / m_yScale);
+    if (maxY < 1)
+        maxY = 1; // prevents a crash below?
 
-    for (int y = 0; y <= minMaxY; y++)
-    {
-        LabelRow *row = screenRows[y];
-        for (int i = 0; i < row->size(); i++)
-        {
-            delete row->at(i);
-        }
-        row->clear();
-    }
+    m_maxX = width;
+    m_size = (maxY + 1) * m_maxX;
 
-    // never decrease m_maxY:
-    if (m_maxY < maxY)
+    // Resize if needed, the rows are then cleared
+    const int words = (std::max(m_maxX, 1) + 63) / 64;
+    if (maxY != m_maxY || screenRows.isEmpty() || screenRows[0].bits.size() != words)
+    {
+        screenRows.fill(ScreenRow(), maxY + 1);
+        for (auto &row : screenRows)
+            row.bits.resize(words);
         m_maxY = maxY;
+    }
 
-    // reset the counters
-    m_marks = m_hits = m_misses = m_elements = 0;
-
-    //----- Clear out labelList -----
-    for (int i = 0; i < labelList.size(); i++)
+    // A new generation clears all the rows at once. Should the counter wrap,
+    // the rows of the generation with the same number are cleared first.
+    if (++m_generation == 0)
     {
-        labelList[i].clear();
+        for (auto &row : screenRows)
+            row.generation = 0;
+        m_generation = 1;
     }
 }
-#endif
 
 void SkyLabeler::draw(QPainter &p)
 {
@@ -400,10 +340,33 @@ void SkyLabeler::draw(QPainter &p)
     //m_p.begin(&m_picture);
 }
 
-// We use Run Length Encoding to hold the information instead of an array of
-// chars.  This is both faster and smaller but the code is more complicated.
-//
-// This code is easy to break and hard to fix.
+// Each row of the virtual screen holds one bit per pixel, valid only if the
+// row was written in the current generation.
+
+bool SkyLabeler::markLabel(const QPointF &o, double offset, const QString &text, QPointF &p,
+                           qreal padding_factor)
+{
+    const qreal width = m_fontMetrics.width(text);
+    // A line apart, plus a row so that the lines do not share a row
+    const qreal line = m_fontMetrics.height() + m_yScale;
+
+    // Positions of the text, the usual one first: to the right of the point,
+    // then to the left, above and below on either side.
+    const QPointF candidates[] = { { offset, offset },
+                                   { -offset - width, offset },
+                                   { offset, offset - line },
+                                   { offset, offset + line },
+                                   { -offset - width, offset - line },
+                                   { -offset - width, offset + line } };
+
+    for (const auto &candidate : candidates)
+    {
+        p = o + candidate;
+        if (markText(p, text, padding_factor))
+            return true;
+    }
+    return false;
+}
 
 bool SkyLabeler::markText(const QPointF &p, const QString &text, qreal padding_factor)
 {
@@ -440,9 +403,12 @@ bool SkyLabeler::markRegion(qreal left, qreal right, qreal top, qreal bot)
         minX = int(right);
     }
 
-    // setup y coordinates
-    int maxY = int(bot / m_yScale);
-    int minY = int(top / m_yScale);
+    // setup y coordinates, the rows from top to bot excluded so that
+    // labels just above one another do not share a row
+    if (bot < top)
+        std::swap(top, bot);
+    int minY = int(std::floor(top / m_yScale));
+    int maxY = std::max(int(std::ceil(bot / m_yScale)) - 1, minY);
 
     if (maxY < 0)
         maxY = 0;
@@ -453,122 +419,61 @@ bool SkyLabeler::markRegion(qreal left, qreal right, qreal top, qreal bot)
     if (minY > m_maxY)
         minY = m_maxY;
 
-    if (maxY < minY)
+    // Labels beyond the sides of the screen can not overlap anything drawn
+    if (maxX < 0 || minX >= m_maxX)
+        return true;
+    minX = std::max(minX, 0);
+    maxX = std::min(maxX, m_maxX - 1);
+
+    // The words of the rows covering minX to maxX, and the bits of the first and last one
+    const int firstWord     = minX / 64;
+    const int lastWord      = maxX / 64;
+    const quint64 firstBits = ~quint64(0) << (minX % 64);
+    const quint64 lastBits  = ~quint64(0) >> (63 - maxX % 64);
+
+    auto bits = [&](int word)
     {
-        int temp = maxY;
-        maxY     = minY;
-        minY     = temp;
-    }
+        quint64 mask = ~quint64(0);
+        if (word == firstWord)
+            mask &= firstBits;
+        if (word == lastWord)
+            mask &= lastBits;
+        return mask;
+    };
 
     // check to see if we overlap any existing label
     // We must check all rows before we start marking
     for (int y = minY; y <= maxY; y++)
     {
-        LabelRow *row = screenRows[y];
-        int i;
-        for (i = 0; i < row->size(); i++)
+        const ScreenRow &row = screenRows[y];
+        if (row.generation != m_generation)
+            continue;
+
+        for (int word = firstWord; word <= lastWord; word++)
         {
-            if (row->at(i)->end < minX)
-                continue; // skip past these
-            if (row->at(i)->start > maxX)
-                break;
-            m_misses++;
-            return false;
+            if (row.bits[word] & bits(word))
+            {
+                m_misses++;
+                return false;
+            }
         }
     }
 
     m_hits++;
     m_marks += (maxX - minX + 1) * (maxY - minY + 1);
 
-    // Okay, there was no overlap so let's insert the current rectangle into
-    // screenRows.
-
+    // Okay, there was no overlap so let's mark the current rectangle
     for (int y = minY; y <= maxY; y++)
     {
-        LabelRow *row = screenRows[y];
-
-        // Simplest case: an empty row
-        if (row->size() < 1)
+        ScreenRow &row = screenRows[y];
+        if (row.generation != m_generation)
         {
-            row->append(new LabelRun(minX, maxX));
-            m_elements++;
-            continue;
+            std::fill(row.bits.begin(), row.bits.end(), 0);
+            row.generation = m_generation;
         }
 
-        // Find out our place in the universe (or row).
-        // H'mm.  Maybe we could cache these numbers above.
-        int i;
-        for (i = 0; i < row->size(); i++)
-        {
-            if (row->at(i)->end >= minX)
-                break;
-        }
-
-        // i now points to first label PAST ours
-
-        // if we are first, append or merge at start of list
-        if (i == 0)
-        {
-            if (row->at(0)->start - maxX < m_minDeltaX)
-            {
-                row->at(0)->start = minX;
-            }
-            else
-            {
-                row->insert(0, new LabelRun(minX, maxX));
-                m_elements++;
-            }
-            continue;
-        }
-
-        // if we are past the last label, merge or append at end
-        else if (i == row->size())
-        {
-            if (minX - row->at(i - 1)->end < m_minDeltaX)
-            {
-                row->at(i - 1)->end = maxX;
-            }
-            else
-            {
-                row->append(new LabelRun(minX, maxX));
-                m_elements++;
-            }
-            continue;
-        }
-
-        // if we got here, we must insert or merge the new label
-        //  between [i-1] and [i]
-
-        bool mergeHead = (minX - row->at(i - 1)->end < m_minDeltaX);
-        bool mergeTail = (row->at(i)->start - maxX < m_minDeltaX);
-
-        // double merge => combine all 3 into one
-        if (mergeHead && mergeTail)
-        {
-            row->at(i - 1)->end = row->at(i)->end;
-            delete row->at(i);
-            row->removeAt(i);
-            m_elements--;
-        }
-
-        // Merge label with [i-1]
-        else if (mergeHead)
-        {
-            row->at(i - 1)->end = maxX;
-        }
-
-        // Merge label with [i]
-        else if (mergeTail)
-        {
-            row->at(i)->start = minX;
-        }
-
-        // insert between the two
-        else
-        {
-            row->insert(i, new LabelRun(minX, maxX));
-            m_elements++;
-        }
+        for (int word = firstWord; word <= lastWord; word++)
+            row.bits[word] |= bits(word);
     }
 
     return true;
@@ -687,8 +592,11 @@ void SkyLabeler::printInfo()
     printf("  hits=%d  misses=%d  ratio=%.1f%%\n", m_hits, m_misses, hitRatio());
     printf("  yScale=%.1f maxY=%d\n", m_yScale, m_maxY);
 
-    printf("  screenRows=%d elements=%d virtualSize=%.1f Kbytes\n", screenRows.size(), m_elements,
-           float(m_size) / 1024.0);
+    int rows = 0;
+    for (const auto &row : screenRows)
+        rows += (row.generation == m_generation);
+    printf("  screenRows=%d used=%d virtualSize=%.1f Kbytes\n", screenRows.size(), rows,
+           float(m_size) / 8.0 / 1024.0);
 
 //    static const char *labelName[NUM_LABEL_TYPES];
 //
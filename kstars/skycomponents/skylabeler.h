@@ -18,10 +18,6 @@ class QString;
 class QPointF;
 class SkyMap;
 class Projector;
-struct LabelRun;
-
-typedef QList<LabelRun *> LabelRow;
-typedef QVector<LabelRow *> ScreenRows;
 
 /**
  *@class SkyLabeler
@@ -35,21 +31,16 @@ typedef QVector<LabelRow *> ScreenRows;
  * and return true.
  *
  * Since we need to check for overlap for every label every time it is
- * potentially drawn on the screen, efficiency is essential.  So instead of
- * having a 2-dimensional array of boolean values we use Run Length Encoding
- * and store the virtual array in a QVector of QLists.  Each element of the
- * vector, a LabelRow, corresponds to a horizontal strip of pixels on the actual
- * screen.  How many vertical pixels are in each strip is controlled by
- * m_yDensity.  The higher the density, the fewer vertical pixels per strip and
- * hence a larger number of strips are needed to cover the screen.  As
- * m_yDensity increases so does the density of the strips.
+ * potentially drawn on the screen, efficiency is essential.  Each row of the
+ * virtual screen corresponds to a horizontal strip of pixels on the actual
+ * screen, a quarter of a line of text high, and holds one bit per pixel in
+ * 64-bit words.  Checking or marking a label then tests or sets a few words in
+ * each of the strips it covers.
  *
- * The information in the X-dimension is completed run length encoded. A
- * consecutive run of pixels in one strip that are covered by one or more labels
- * is stored in a LabelRun object that merely stores the start pixel and the end
- * pixel.  A LabelRow is a list of LabelRun's stored in ascending order.  This
- * saves a lot of space over an explicit array and it also makes checking for
- * overlaps faster and even makes inserting new overlaps faster on average.
+ * Clearing the virtual screen for every frame would mean writing every word of
+ * every row.  Instead each row carries the generation in which it was last
+ * written, and reset() merely starts a new generation.  A row from an older
+ * generation is empty, and is cleared when a label is first marked in it.
  *
  * Synopsis:
  *
@@ -231,6 +222,18 @@ class SkyLabeler
          */
     bool drawNameLabel(SkyObject *obj, const QPointF &_p, const qreal padding_factor = 1);
 
+    /**
+         * @short Finds room for the label of a point at @p o.  The label is
+         * tried to the right of the point first, as drawn by default, then to
+         * its left, above and below.  If there is room, the label is marked and
+         * @p p is set to where its text is to be drawn.
+         * @param o the position of the point
+         * @param offset the distance of the label from the point
+         * @return true if there was room for the label
+         */
+    bool markLabel(const QPointF &o, double offset, const QString &text, QPointF &p,
+                   qreal padding_factor = 1);
+
     /**
          *@short draw the object's name label on the map, without checking for
          *overlap with other labels.
@@ -324,17 +327,31 @@ class SkyLabeler
     int hits() { return m_hits; }
     int marks() { return m_marks; }
 
+  protected:
+    /**
+         * @short clears the virtual screen and sizes it for a screen of
+         * @p width by @p height pixels, in strips sized for the current font.
+         */
+    void resizeScreen(int width, int height);
+
   private:
-    ScreenRows screenRows;
+    /// A strip of the virtual screen, one bit per pixel
+    struct ScreenRow
+    {
+        QVector<quint64> bits;
+        /// The bits are cleared if this is not the current generation
+        quint32 generation { 0 };
+    };
+
+    QVector<ScreenRow> screenRows;
+    /// The generation of the rows written since the last reset
+    quint32 m_generation { 1 };
     int m_maxX { 0 };
     int m_maxY { 0 };
     int m_size { 0 };
-    /// When to merge two adjacent regions
-    int m_minDeltaX { 30 };
     int m_marks { 0 };
     int m_hits { 0 };
     int m_misses { 0 };
-    int m_elements { 0 };
     int m_errors { 0 };
     qreal m_yScale { 0 };
     double m_offset { 0 };
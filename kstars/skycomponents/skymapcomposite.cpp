@@ -29,6 +29,7 @@
 #endif
 #include "kstarsdata.h"
 #include "milkyway.h"
+#include "pickingindex.h"
 #include "satellitescomponent.h"
 #include "skylabeler.h"
 #include "skypainter.h"
@@ -52,11 +53,14 @@
 
 #include <QApplication>
 
+#include <algorithm>
+
 #include <kstars_debug.h>
 
 SkyMapComposite::SkyMapComposite(SkyComposite *parent)
     : SkyComposite(parent), m_reindexNum(J2000)
 {
+    m_NameIndex.reset(new NameIndex(m_ObjectLists));
     m_skyLabeler.reset(SkyLabeler::Instance());
     m_skyMesh = SkyMesh::Create(3); // level 5 mesh = 8192 trixels
     m_skyMesh->debug(0);
@@ -178,6 +182,9 @@ SkyMapComposite::SkyMapComposite(SkyComposite *parent)
 #endif
     connect(this, SIGNAL(progressText(QString)), KStarsData::Instance(),
             SIGNAL(progressText(QString)));
+
+    // Index the names registered by the components in the background
+    m_NameIndex->update();
 }
 
 void SkyMapComposite::update(KSNumbers *num)
@@ -273,6 +280,10 @@ void SkyMapComposite::draw(SkyPainter *skyp)
     SkyPoint *focus = map->focus();
     m_skyMesh->aperture(focus, radius + 1.0, DRAW_BUF); // divide by 2 for testing
 
+    // Components register the objects they draw for objectNearest()
+    PickingIndex *pickingIndex = PickingIndex::Instance();
+    pickingIndex->begin(map->projector(), radius);
+
     // create the no-precess aperture if needed
     if (Options::showEquatorialGrid() || Options::showHorizontalGrid() ||
             Options::showCBounds() || Options::showEquator())
@@ -342,6 +353,8 @@ void SkyMapComposite::draw(SkyPainter *skyp)
 
     m_Supernovae->draw(skyp);
 
+    pickingIndex->end();
+
     map->drawObjectLabels(labelObjects());
 
     m_skyLabeler->drawQueuedLabels();
@@ -405,6 +418,25 @@ void SkyMapComposite::draw(SkyPainter *skyp)
 // custom object = 0.5
 // Solar system = 0.25
 SkyObject *SkyMapComposite::objectNearest(SkyPoint *p, double &maxrad)
+{
+#ifndef KSTARS_LITE
+    PickingIndex *pickingIndex = PickingIndex::Instance();
+    SkyMap *map                = SkyMap::Instance();
+    if (map && pickingIndex->covers(p, maxrad, map->projector()))
+    {
+        PickingIndex::ObjectKind kind;
+        SkyObject *o = pickingIndex->objectNearest(p, maxrad, &kind);
+        // Drawn catalog objects live in the component cache, hand out the same stable copy as its own search
+        if (o && kind == PickingIndex::DEEP_SKY)
+            o = &m_Catalogs->insertStaticObject(*static_cast<CatalogObject *>(o));
+        return o;
+    }
+#endif
+
+    return objectNearestInComponents(p, maxrad);
+}
+
+SkyObject *SkyMapComposite::objectNearestInComponents(SkyPoint *p, double &maxrad)
 {
     double rTry      = maxrad;
     double rBest     = maxrad;
@@ -550,6 +582,34 @@ QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1,
     return list;
 }
 
+namespace
+{
+// Order in which findByName() searches the components for each type of object
+int searchPrecedence(int type)
+{
+    switch (type)
+    {
+        case SkyObject::PLANET:
+        case SkyObject::MOON:
+        case SkyObject::ASTEROID:
+        case SkyObject::COMET:
+            return 0;
+        case SkyObject::CONSTELLATION:
+            return 2;
+        case SkyObject::STAR:
+        case SkyObject::CATALOG_STAR:
+            return 3;
+        case SkyObject::SUPERNOVA:
+            return 4;
+        case SkyObject::SATELLITE:
+            return 5;
+        default:
+            // Deep sky objects
+            return 1;
+    }
+}
+}  // namespace
+
 SkyObject *SkyMapComposite::findByName(const QString &name, bool exact)
 {
 #ifndef KSTARS_LITE
@@ -557,6 +617,22 @@ SkyObject *SkyMapComposite::findByName(const QString &name, bool exact)
         return nullptr;
 #endif
 
+    // The names registered by the components are looked up in the index. Several objects may share
+    // a name, pick them in the same order as the search of the components below. Among those searched
+    // first, the index orders the names of the same case first, then the types and the lists in order.
+    const auto matches = m_NameIndex->exact(name);
+    if (!matches.isEmpty())
+    {
+        // The first of the smallest elements
+        auto best = std::min_element(matches.cbegin(), matches.cend(),
+                                     [](const NameIndex::Match & a, const NameIndex::Match & b)
+        {
+            return searchPrecedence(a.type) < searchPrecedence(b.type);
+        });
+        return const_cast<SkyObject *>(best->object);
+    }
+
+    // Deep sky objects not loaded yet, partial matches and other names still need the components.
     //We search the children in an "intelligent" order (most-used
     //object types first), in order to avoid wasting too much time
     //looking for a match.  The most important part of this ordering
@@ -8,6 +8,7 @@
 
 #include "culturelist.h"
 #include "ksnumbers.h"
+#include "nameindex.h"
 #include "skycomposite.h"
 #include "skylabeler.h"
 #include "skymesh.h"
@@ -117,9 +118,21 @@ class SkyMapComposite : public QObject, public SkyComposite
              * @param maxrad The maximum search radius, in Degrees
              * @note the angular separation to the matched object is returned
              * through the maxrad variable.
+             * @note Points well inside the last drawn frame are answered from the
+             * objects drawn in that frame, see PickingIndex.
              */
         SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
 
+        /**
+             * @return the object nearest a given point in the sky, searching every
+             * component whether its objects were drawn or not.
+             * @param p The point to find an object near
+             * @param maxrad The maximum search radius, in Degrees
+             * @note the angular separation to the matched object is returned
+             * through the maxrad variable.
+             */
+        SkyObject *objectNearestInComponents(SkyPoint *p, double &maxrad);
+
         /**
              * @return the star nearest a given point in the sky.
              * @param p The point to find a star near
@@ -135,8 +148,10 @@ class SkyMapComposite : public QObject, public SkyComposite
              *
              * The objects' primary, secondary and long-form names will
              * all be checked for a match.
-             * @note Overloaded from SkyComposite.  In this version, we search
-             * the most likely object classes first to be more efficient.
+             * @note Overloaded from SkyComposite.  In this version, the names
+             * registered in objectLists() are looked up in the NameIndex first.
+             * Otherwise we search the most likely object classes first to be
+             * more efficient.
              * @p name the name to be matched
              * @p exact If true, it will return an exact match (default), otherwise it can return
              * a partial match.
@@ -225,6 +240,12 @@ class SkyMapComposite : public QObject, public SkyComposite
             return m_Catalogs;
         }
 
+        /** @return the index of the names in objectLists(), for name searches */
+        inline NameIndex *nameIndex()
+        {
+            return m_NameIndex.get();
+        }
+
         inline MilkyWay *milkyWay()
         {
             return m_MilkyWay;
@@ -313,5 +334,6 @@ class SkyMapComposite : public QObject, public SkyComposite
         QList<SkyObject *> m_LabeledObjects;
         QHash<int, QStringList> m_ObjectNames;
         QHash<int, QVector<QPair<QString, const SkyObject *>>> m_ObjectLists;
+        std::unique_ptr<NameIndex> m_NameIndex;
         QHash<QString, QString> m_ConstellationNames;
 };
@@ -21,6 +21,7 @@
 #endif
 
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 
 #include "skypainter.h"
@@ -116,6 +117,8 @@ void SolarSystemSingleComponent::draw(SkyPainter *skyp)
     skyp->setBrush(m_Planet->color());
 
     bool drawn = skyp->drawPlanet(m_Planet);
+    if (drawn)
+        PickingIndex::Instance()->add(m_Planet, PickingIndex::SOLAR_SYSTEM);
     if (drawn && Options::showPlanetNames())
         SkyLabeler::AddLabel(m_Planet, SkyLabeler::PLANET_LABEL);
 }
@@ -8,6 +8,7 @@
 
 #include "binfilehelper.h"
 #include "deepstarcomponent.h"
+#include "pickingindex.h"
 #include "starblock.h"
 #include "starcomponent.h"
 
@@ -43,6 +44,9 @@ int StarBlockList::releaseBlock(StarBlock *block)
             }
         }
 #endif
+        // The stars of the block may have been drawn in the last frame
+        PickingIndex::Instance()->invalidate();
+
         blocks.removeLast();
         nBlocks--;
         nStars -= block->getStarCount();
@@ -15,6 +15,7 @@
 #include "kstarsdata.h"
 #include "kstarssplash.h"
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 #include "skymap.h"
 #include "skymesh.h"
@@ -306,6 +307,7 @@ void StarComponent::draw(SkyPainter *skyp)
 
     m_StarBlockFactory->drawID = m_skyMesh->drawID();
 
+    PickingIndex *pickingIndex = PickingIndex::Instance();
     int nTrixels = 0;
 
     while (region.hasNext())
@@ -329,6 +331,8 @@ void StarComponent::draw(SkyPainter *skyp)
                 star->JITupdate();
 
             bool drawn = skyp->drawPointSource(star, mag, star->spchar());
+            if (drawn)
+                pickingIndex->add(m_skyMesh, currentRegion, star, PickingIndex::STAR);
 
             //FIXME_SKYPAINTER: find a better way to do this.
             if (drawn && !(m_hideLabels || mag > labelMagLim))
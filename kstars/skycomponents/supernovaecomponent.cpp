@@ -19,6 +19,7 @@
 #include "ksnotification.h"
 #include "kstarsdata.h"
 #include "Options.h"
+#include "pickingindex.h"
 #include "skylabeler.h"
 #include "skymesh.h"
 #include "skypainter.h"
@@ -57,6 +58,7 @@ bool SupernovaeComponent::selected()
 
 void SupernovaeComponent::loadData()
 {
+    PickingIndex::Instance()->invalidate();
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
 
@@ -197,7 +199,8 @@ void SupernovaeComponent::draw(SkyPainter *skyp)
         //Do not draw if mag>maglim
         if (mag > maglim)
             continue;
-        skyp->drawSupernova(sup);
+        if (skyp->drawSupernova(sup))
+            PickingIndex::Instance()->add(sup, PickingIndex::SUPERNOVA);
     }
 }
 
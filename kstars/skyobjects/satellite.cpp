@@ -11,12 +11,12 @@
 #include "kspopupmenu.h"
 #endif
 #include "kstarsdata.h"
-#include "kssun.h"
 #include "Options.h"
-#include "skymapcomposite.h"
 
 #include <QDebug>
+#include <QRegularExpression>
 
+#include <algorithm>
 #include <cmath>
 #include <typeinfo>
 
@@ -45,8 +45,17 @@
 #define F       3.35281066474748e-3      // Flattening factor
 #define MFACTOR 7.292115e-5
 
-Satellite::Satellite(const QString &name, const QString &line1, const QString &line2)
+Satellite::Satellite(const QString &nameLine, const QString &line1, const QString &line2)
 {
+    // McCants TLE files follow the name with the length, width and depth in meters, the standard magnitude
+    // and a letter telling how the magnitude was found
+    static const QRegularExpression mccants(
+        R"(^(.*\S)\s+\d+\.\d+\s+\d+\.\d+\s+\d+\.\d+\s+(-?\d+\.\d+)(\s+[a-z])?\s*$)");
+    const QRegularExpressionMatch match = mccants.match(nameLine);
+    const QString name = match.hasMatch() ? match.captured(1) : nameLine;
+    if (match.hasMatch())
+        m_standard_magnitude = match.captured(2).toDouble();
+
     //m_name          = name;
     m_number      = line1.midRef(2, 5).toInt();
     m_class       = line1.at(7);
@@ -703,16 +712,169 @@ void Satellite::init()
     }
 }
 
-int Satellite::updatePos()
+Satellite::Observer Satellite::currentObserver()
 {
     KStarsData *data = KStarsData::Instance();
-    return sgp4((data->clock()->utc().djd() - m_tle_jd) * MINPD);
+    Observer observer;
+
+    observer.jd   = data->clock()->utc().djd();
+    observer.lat  = *data->geo()->lat();
+    observer.lng  = *data->geo()->lng();
+    observer.lmst = data->geo()->LMST(observer.jd);
+    observer.lst  = *data->lst();
+
+    return observer;
 }
 
-int Satellite::sgp4(double tsince)
+Satellite::Observer Satellite::observerAt(double jd, const GeoLocation *geo)
 {
-    KStarsData *data = KStarsData::Instance();
+    Observer observer;
+
+    observer.jd   = jd;
+    observer.lat  = *geo->lat();
+    observer.lng  = *geo->lng();
+    observer.lmst = geo->LMST(jd);
+    observer.lst  = geo->GSTtoLST(KStarsDateTime(static_cast<long double>(jd)).gst());
+
+    return observer;
+}
+
+int Satellite::updatePos()
+{
+    return updatePos(currentObserver());
+}
+
+int Satellite::updatePos(const Observer &observer)
+{
+    return sgp4((observer.jd - m_tle_jd) * MINPD, observer);
+}
+
+bool Satellite::isBelowHorizonUntil(const Observer &observer) const
+{
+    return observer.jd >= m_update_jd && observer.jd < m_earliest_rise_jd && observer.lat.Degrees() == m_update_lat &&
+           observer.lng.Degrees() == m_update_lng;
+}
+
+QList<Satellite::Pass> Satellite::findPasses(const GeoLocation *geo, double startJD, double endJD, double minAltitude) const
+{
+    QList<Pass> passes;
+    // Work on a copy so the position displayed in the sky map is not modified
+    Satellite sat(*this);
+    bool failed = false;
+
+    auto altitudeAt = [&](double jd)
+    {
+        if (sat.updatePos(observerAt(jd, geo)) != 0)
+        {
+            failed = true;
+            return -90.0;
+        }
+        return sat.alt().Degrees();
+    };
+
+    // Refine a rise or set, the altitude crosses minAltitude between jd1 and jd2
+    auto crossing = [&](double jd1, double jd2, bool rising)
+    {
+        while (jd2 - jd1 > 1.0 / 86400.0 && !failed)
+        {
+            double mid = 0.5 * (jd1 + jd2);
+            if ((altitudeAt(mid) > minAltitude) == rising)
+                jd2 = mid;
+            else
+                jd1 = mid;
+        }
+        return 0.5 * (jd1 + jd2);
+    };
 
+    // Golden section search of the culmination, the altitude is unimodal during a pass
+    auto culmination = [&](double jd1, double jd2)
+    {
+        const double ratio = 0.5 * (sqrt(5.0) - 1.0);
+        double c = jd2 - ratio * (jd2 - jd1);
+        double d = jd1 + ratio * (jd2 - jd1);
+        double altC = altitudeAt(c);
+        double altD = altitudeAt(d);
+        while (jd2 - jd1 > 1.0 / 86400.0 && !failed)
+        {
+            if (altC > altD)
+            {
+                jd2  = d;
+                d    = c;
+                altD = altC;
+                c    = jd2 - ratio * (jd2 - jd1);
+                altC = altitudeAt(c);
+            }
+            else
+            {
+                jd1  = c;
+                c    = d;
+                altC = altD;
+                d    = jd1 + ratio * (jd2 - jd1);
+                altD = altitudeAt(d);
+            }
+        }
+        return 0.5 * (jd1 + jd2);
+    };
+
+    // Sampling step: one minute, finer for very short periods. A pass shorter than the step can be missed.
+    const double period = TWOPI / m_mean_motion;
+    const double step   = std::min(1.0, period / 60.0) / MINPD;
+    // Do not follow a pass forever after the end of the window, geostationary satellites never set
+    const double limitJD = endJD + std::max(period, 60.0) / MINPD;
+
+    double jd      = startJD;
+    bool above     = altitudeAt(jd) > minAltitude;
+    bool inPass    = false;
+    double riseJD  = 0;
+    double riseAz  = 0;
+
+    while (!failed && (jd < endJD || inPass) && jd < limitJD)
+    {
+        double next = jd + step;
+        // Below the horizon, jump directly to the earliest possible rise. The bound is only valid for the
+        // geometric horizon, it is still a lower bound for any positive minimum altitude.
+        if (!above && minAltitude >= 0.0)
+            next = std::max(next, sat.m_earliest_rise_jd);
+        if (!inPass)
+            next = std::min(next, endJD);
+
+        const bool nextAbove = altitudeAt(next) > minAltitude;
+
+        if (!above && nextAbove)
+        {
+            riseJD = crossing(jd, next, true);
+            altitudeAt(riseJD);
+            riseAz = sat.az().Degrees();
+            inPass = true;
+        }
+        else if (above && !nextAbove && inPass)
+        {
+            Pass pass;
+            pass.riseJD        = riseJD;
+            pass.riseAzimuth   = riseAz;
+            pass.setJD         = crossing(jd, next, false);
+            altitudeAt(pass.setJD);
+            pass.setAzimuth    = sat.az().Degrees();
+            pass.culminationJD = culmination(riseJD, pass.setJD);
+            pass.maxAltitude   = altitudeAt(pass.culminationJD);
+            pass.magnitude     = sat.estimatedMagnitude();
+            pass.visible       = sat.isVisible();
+            if (!failed)
+                passes.append(pass);
+            inPass = false;
+        }
+
+        if (next <= jd)
+            break;
+        jd    = next;
+        above = nextAbove;
+    }
+
+    return passes;
+}
+
+int Satellite::sgp4(double tsince, const Observer &observer)
+{
     int ktr;
     double am, axnl, aynl, betal, cosim, cnod, cos2u, coseo1 = 0, cosi, cosip, cosisq, cossu, cosu, delm, delomg, em,
                                                       ecose, el2, eo1, ep, esine, argpm, argpp, argpdf, pl,
@@ -725,7 +887,9 @@ int Satellite::sgp4(double tsince)
 
     const double temp4 = 1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
+    double jul_utc = observer.jd;
+
+    m_earliest_rise_jd = 0;
 
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
@@ -1136,9 +1300,9 @@ int Satellite::sgp4(double tsince)
     }
 
     // Observer ECI position and velocity
-    sinlat   = sin(data->geo()->lat()->radians());
-    coslat   = cos(data->geo()->lat()->radians());
-    thetageo = data->geo()->LMST(jul_utc);
+    sinlat   = sin(observer.lat.radians());
+    coslat   = cos(observer.lat.radians());
+    thetageo = observer.lmst;
     sintheta = sin(thetageo);
     costheta = cos(thetageo);
     c        = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
@@ -1179,7 +1343,7 @@ int Satellite::sgp4(double tsince)
 
     setAz(azimuth / DEG2RAD);
     setAlt(elevation / DEG2RAD);
-    HorizontalToEquatorial(data->lst(), data->geo()->lat());
+    HorizontalToEquatorial(&observer.lst, &observer.lat);
 
     // is the satellite visible ?
     // Find ECI coordinates of the sun
@@ -1221,10 +1385,47 @@ int Satellite::sgp4(double tsince)
     double earth_w = sat_posw;
     delta      = PIO2 - arcSin((sun_posx * earth_x + sun_posy * earth_y + sun_posz * earth_z) / (sun_posw * earth_w));
     depth      = sd_earth - sd_sun - delta;
-    KSSun *sun = dynamic_cast<KSSun *>(data->skyComposite()->findByName(i18n("Sun")));
+
+    // Sun elevation seen from the observer, from the same low precision ECI position
+    double sun_top_z = coslat * costheta * (sun_posx - obs_posx) + coslat * sintheta * (sun_posy - obs_posy) +
+                       sinlat * (sun_posz - obs_posz);
+    double sun_elevation = arcSin(sun_top_z / sqrt((sun_posx - obs_posx) * (sun_posx - obs_posx) +
+                                  (sun_posy - obs_posy) * (sun_posy - obs_posy) +
+                                  (sun_posz - obs_posz) * (sun_posz - obs_posz)));
 
     m_is_eclipsed = sd_earth >= sd_sun && depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
+    m_is_visible  = !m_is_eclipsed && sun_elevation <= -12.0 * DEG2RAD && elevation >= 0.0;
+
+    // Phase angle between the directions to the sun and to the observer
+    double cos_phase = (rho_x * -range_posx + rho_y * -range_posy + rho_z * -range_posz) / (rho_w * m_range);
+    m_phase_angle    = acos(std::max(-1.0, std::min(1.0, cos_phase)));
+
+    m_pos_x = sat_posx;
+    m_pos_y = sat_posy;
+    m_pos_z = sat_posz;
+
+    // Lower bound of the time the satellite needs to rise above the horizon of this observer.
+    // The geocentric angle between observer and satellite must first drop below the horizon radius
+    // of the orbit apogee, and it cannot shrink faster than the orbital motion at perigee plus the
+    // rotation of the earth.
+    m_update_jd  = jul_utc;
+    m_update_lat = observer.lat.Degrees();
+    m_update_lng = observer.lng.Degrees();
+    if (elevation >= 0.0)
+    {
+        m_earliest_rise_jd = jul_utc;
+    }
+    else
+    {
+        double obs_radius  = sqrt(obs_posx * obs_posx + obs_posy * obs_posy + obs_posz * obs_posz);
+        double cos_lambda  = (sat_posx * obs_posx + sat_posy * obs_posy + sat_posz * obs_posz) / (sat_posw * obs_radius);
+        double lambda      = acos(std::max(-1.0, std::min(1.0, cos_lambda)));
+        double apogee      = std::max(sat_posw, pow(XKE / nm, X2O3) * (1.0 + em) * RADIUSEARTHKM);
+        // One degree of margin covers the difference between geodetic and geocentric horizon
+        double lambda0     = acos(std::min(1.0, obs_radius / apogee)) + DEG2RAD;
+        double max_rate    = 1.25 * (nm * (1.0 + em) * (1.0 + em) / pow(1.0 - em * em, 1.5) + MFACTOR * 60.0);
+        m_earliest_rise_jd = jul_utc + std::max(0.0, lambda - lambda0) / max_rate / MINPD;
+    }
 
     return (0);
 }
@@ -1330,6 +1531,45 @@ double Satellite::range() const
     return m_range;
 }
 
+double Satellite::phaseAngle() const
+{
+    return m_phase_angle / DEG2RAD;
+}
+
+double Satellite::standardMagnitude() const
+{
+    return m_standard_magnitude;
+}
+
+void Satellite::setStandardMagnitude(double magnitude)
+{
+    m_standard_magnitude = magnitude;
+}
+
+double Satellite::estimatedMagnitude() const
+{
+    if (std::isnan(m_standard_magnitude))
+        return m_standard_magnitude;
+
+    // McCants: standard magnitude is given at 1000 km range and 50% illumination
+    double illumination = 0.5 * (1.0 + cos(m_phase_angle));
+    if (illumination <= 0.0)
+        return 99.0;
+    return m_standard_magnitude - 15.75 + 2.5 * log10(m_range * m_range / illumination);
+}
+
+void Satellite::positionECI(double &x, double &y, double &z) const
+{
+    x = m_pos_x;
+    y = m_pos_y;
+    z = m_pos_z;
+}
+
+double Satellite::tleJD() const
+{
+    return m_tle_jd;
+}
+
 QString Satellite::id() const
 {
     return m_id;
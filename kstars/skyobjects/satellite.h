@@ -8,8 +8,12 @@
 
 #include "skyobject.h"
 
+#include <QList>
 #include <QString>
 
+#include <limits>
+
+class GeoLocation;
 class KSPopupMenu;
 
 /**
@@ -22,8 +26,11 @@ class KSPopupMenu;
 class Satellite : public SkyObject
 {
     public:
-        /** @short Constructor */
-        Satellite(const QString &name, const QString &line1, const QString &line2);
+        /**
+         * @short Constructor
+         * @param nameLine Name line of the TLE, followed by the dimensions and the standard magnitude in McCants files
+         */
+        Satellite(const QString &nameLine, const QString &line1, const QString &line2);
 
         /**
          * @return a clone of this object
@@ -34,9 +41,78 @@ class Satellite : public SkyObject
         /** @short Destructor */
         virtual ~Satellite() override = default;
 
-        /** @short Update satellite position */
+        /**
+         * @struct Observer
+         * Observer state shared by every satellite propagated for the same instant.
+         * Building it once per update keeps the per-satellite work free of global lookups.
+         */
+        struct Observer
+        {
+            /// Julian day (UTC) of the observation
+            double jd { 0 };
+            /// Geographic latitude
+            dms lat;
+            /// Geographic longitude
+            dms lng;
+            /// Local mean sidereal time, in radians
+            double lmst { 0 };
+            /// Local sidereal time, used to convert horizontal to equatorial coordinates
+            dms lst;
+        };
+
+        /**
+         * @struct Pass
+         * A pass of the satellite above the observer's horizon.
+         */
+        struct Pass
+        {
+            /// Julian day of the rise
+            double riseJD { 0 };
+            /// Julian day of the culmination
+            double culminationJD { 0 };
+            /// Julian day of the set
+            double setJD { 0 };
+            /// Altitude at culmination, in degrees
+            double maxAltitude { 0 };
+            /// Azimuth at rise, in degrees
+            double riseAzimuth { 0 };
+            /// Azimuth at set, in degrees
+            double setAzimuth { 0 };
+            /// Estimated visual magnitude at culmination, NaN if the standard magnitude of the satellite is unknown
+            double magnitude { std::numeric_limits<double>::quiet_NaN() };
+            /// True if the satellite can be seen at culmination (sunlit and sky dark enough)
+            bool visible { false };
+        };
+
+        /** @return Observer state for the current simulation time and location */
+        static Observer currentObserver();
+
+        /** @return Observer state for the given Julian day (UTC) and location */
+        static Observer observerAt(double jd, const GeoLocation *geo);
+
+        /** @short Update satellite position for the current simulation time and location */
         int updatePos();
 
+        /**
+         * @short Update satellite position for the given observer.
+         * Does not access global state, so satellites can be updated concurrently.
+         * @return 0 on success, an sgp4 error code otherwise
+         */
+        int updatePos(const Observer &observer);
+
+        /**
+         * @return True if the last computed position proves the satellite is still below the horizon
+         * of @p observer, so the update can be skipped.
+         */
+        bool isBelowHorizonUntil(const Observer &observer) const;
+
+        /**
+         * @short Find the passes of the satellite above @p minAltitude degrees.
+         * Propagates a private copy, so the displayed position is left untouched.
+         * Passes rising between @p startJD and @p endJD are returned, in chronological order.
+         */
+        QList<Pass> findPasses(const GeoLocation *geo, double startJD, double endJD, double minAltitude = 0.0) const;
+
         /**
          * @return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
          */
@@ -57,6 +133,30 @@ class Satellite : public SkyObject
         /** @return Satellite range from observer in km */
         double range() const;
 
+        /** @return Phase angle (sun - satellite - observer) in degrees */
+        double phaseAngle() const;
+
+        /**
+         * @return Standard magnitude (at 1000 km and half illuminated), read from the name line of
+         * TLE files in the McCants format, NaN if unknown
+         */
+        double standardMagnitude() const;
+
+        /** @short Set the standard magnitude (at 1000 km and half illuminated) */
+        void setStandardMagnitude(double magnitude);
+
+        /**
+         * @return Visual magnitude estimated from range and phase angle with the standard magnitude,
+         * NaN if the standard magnitude is unknown
+         */
+        double estimatedMagnitude() const;
+
+        /** @return Satellite position (TEME frame, km) computed by the last update */
+        void positionECI(double &x, double &y, double &z) const;
+
+        /** @return Julian day of the TLE epoch */
+        double tleJD() const;
+
         /** @return Satellite international designator */
         QString id() const;
 
@@ -77,10 +177,10 @@ class Satellite : public SkyObject
         void init();
 
         /** @short Compute satellite position */
-        int sgp4(double tsince);
+        int sgp4(double tsince, const Observer &observer);
 
         /** @return Arcsine of the argument */
-        double arcSin(double arg);
+        static double arcSin(double arg);
 
         /**
          * Provides the difference between UT (approximately the same as UTC)
@@ -88,10 +188,10 @@ class Satellite : public SkyObject
          * This function is based on a least squares fit of data from 1950
          * to 1991 and will need to be updated periodically.
          */
-        double deltaET(double year);
+        static double deltaET(double year);
 
         /** @return arg1 mod arg2 */
-        double Modulus(double arg1, double arg2);
+        static double Modulus(double arg1, double arg2);
 
         // TLE
         /// Satellite Number
@@ -146,6 +246,20 @@ class Satellite : public SkyObject
         double m_altitude { 0 };
         /// Satellite range from observer in km
         double m_range { 0 };
+        /// Phase angle in radians
+        double m_phase_angle { 0 };
+        /// Standard magnitude, NaN if unknown
+        double m_standard_magnitude { std::numeric_limits<double>::quiet_NaN() };
+        /// Satellite position (TEME, km)
+        double m_pos_x { 0 }, m_pos_y { 0 }, m_pos_z { 0 };
+
+        // Horizon skipping
+        /// Julian day of the last successful update
+        double m_update_jd { 0 };
+        /// Observer latitude and longitude of the last successful update, in degrees
+        double m_update_lat { 0 }, m_update_lng { 0 };
+        /// The satellite cannot rise above the horizon of the last observer before this Julian day
+        double m_earliest_rise_jd { 0 };
 
         // Near Earth
         bool isimp { false };
@@ -8,6 +8,7 @@
 
 #include "geolocation.h"
 #include "ksnumbers.h"
+#include "ksnumberscache.h"
 #include "kspaths.h"
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
@@ -91,9 +92,24 @@ void SkyObject::setLongName(const QString &longname)
 }
 
 QTime SkyObject::riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact) const
+{
+    return riseSetTime(dt, geo, rst, exact, [this, geo](const KStarsDateTime & t)
+    {
+        return recomputeCoords(t, geo);
+    }, this);
+}
+
+QTime SkyObject::riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                             const PositionFunction &position) const
+{
+    return riseSetTime(dt, geo, rst, exact, position, nullptr);
+}
+
+QTime SkyObject::riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                             const PositionFunction &position, const SkyPoint *guess) const
 {
     // If this object does not rise or set, return an invalid time
-    SkyPoint p = recomputeCoords(dt, geo);
+    SkyPoint p = position(dt);
     if (p.checkCircumpolar(geo->lat()))
         return QTime();
 
@@ -117,7 +133,7 @@ QTime SkyObject::riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, b
     // compute the _closest_ rise time and the _closest_ set time to
     // the current time.
 
-    QTime rstUt = riseSetTimeUT(dt2, geo, rst, exact);
+    QTime rstUt = riseSetTimeUT(dt2, geo, rst, exact, position, guess);
     if (!rstUt.isValid())
         return QTime();
 
@@ -125,9 +141,25 @@ QTime SkyObject::riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, b
 }
 
 QTime SkyObject::riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool riseT, bool exact) const
+{
+    return riseSetTimeUT(dt, geo, riseT, exact, [this, geo](const KStarsDateTime & t)
+    {
+        return recomputeCoords(t, geo);
+    }, this);
+}
+
+QTime SkyObject::riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool riseT, bool exact,
+                               const PositionFunction &position) const
+{
+    return riseSetTimeUT(dt, geo, riseT, exact, position, nullptr);
+}
+
+QTime SkyObject::riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool riseT, bool exact,
+                               const PositionFunction &position, const SkyPoint *guess) const
 {
     // First trial to calculate UT
-    QTime UT = auxRiseSetTimeUT(dt, geo, &ra(), &dec(), riseT);
+    const SkyPoint first = guess ? *guess : position(dt);
+    QTime UT = auxRiseSetTimeUT(dt, geo, &first.ra(), &first.dec(), riseT);
 
     // We iterate once more using the calculated UT to compute again
     // the ra and dec for that time and hence the rise/set time.
@@ -151,7 +183,7 @@ QTime SkyObject::riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo,
         dt0 = dt0.addDays(1);
     }
 
-    SkyPoint sp = recomputeCoords(dt0, geo);
+    SkyPoint sp = position(dt0);
     UT          = auxRiseSetTimeUT(dt0, geo, &sp.ra(), &sp.dec(), riseT);
 
     if (exact)
@@ -159,7 +191,7 @@ QTime SkyObject::riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo,
         // We iterate a second time (For the Moon the second iteration changes
         // aprox. 1.5 arcmin the coordinates).
         dt0.setTime(UT);
-        sp = recomputeCoords(dt0, geo);
+        sp = position(dt0);
         UT = auxRiseSetTimeUT(dt0, geo, &sp.ra(), &sp.dec(), riseT);
     }
 
@@ -219,17 +251,32 @@ dms SkyObject::riseSetTimeAz(const KStarsDateTime &dt, const GeoLocation *geo, b
 }
 
 QTime SkyObject::transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo) const
+{
+    return transitTimeUT(dt, geo, [this, geo](const KStarsDateTime & t)
+    {
+        return recomputeCoords(t, geo);
+    }, this);
+}
+
+QTime SkyObject::transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const
+{
+    return transitTimeUT(dt, geo, position, nullptr);
+}
+
+QTime SkyObject::transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position,
+                               const SkyPoint *guess) const
 {
     dms LST = geo->GSTtoLST(dt.gst());
 
     //dSec is the number of seconds until the object transits.
-    dms HourAngle = dms(LST.Degrees() - ra().Degrees());
+    const SkyPoint first = guess ? *guess : position(dt);
+    dms HourAngle = dms(LST.Degrees() - first.ra().Degrees());
     int dSec      = static_cast<int>(-3600. * HourAngle.Degrees() / 15.0);
 
     //dt0 is the first guess at the transit time.
     KStarsDateTime dt0 = dt.addSecs(dSec);
     //recompute object's position at UT0 and then find transit time of this refined position
-    SkyPoint sp = recomputeCoords(dt0, geo);
+    SkyPoint sp = position(dt0);
     HourAngle = dms(LST.Degrees() - sp.ra().Degrees());
     dSec      = static_cast<int>(-3600. * HourAngle.Degrees() / 15.0);
 
@@ -241,6 +288,11 @@ QTime SkyObject::transitTime(const KStarsDateTime &dt, const GeoLocation *geo) c
     return geo->UTtoLT(KStarsDateTime(dt.date(), transitTimeUT(dt, geo))).time();
 }
 
+QTime SkyObject::transitTime(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const
+{
+    return geo->UTtoLT(KStarsDateTime(dt.date(), transitTimeUT(dt, geo, position))).time();
+}
+
 dms SkyObject::transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo) const
 {
     KStarsDateTime dt0 = dt;
@@ -253,6 +305,18 @@ dms SkyObject::transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo)
     return dms(delta);
 }
 
+dms SkyObject::transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const
+{
+    KStarsDateTime dt0 = dt;
+    dt0.setTime(transitTimeUT(dt, geo, position));
+    SkyPoint sp = position(dt0);
+
+    double delta = 90 - geo->lat()->Degrees() + sp.dec().Degrees();
+    if (delta > 90)
+        delta = 180 - delta;
+    return dms(delta);
+}
+
 double SkyObject::approxHourAngle(const dms *h0, const dms *gLat, const dms *dec) const
 {
     double sh0 = sin(h0->radians());
@@ -298,7 +362,7 @@ SkyPoint SkyObject::recomputeCoords(const KStarsDateTime &dt, const GeoLocation
     SkyObject *c = this->clone();
 
     // compute coords of the copy for new time jd
-    KSNumbers num(dt.djd());
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(dt.djd());
 
     // Note: isSolarSystem() below should give the same result on this
     // and c. The only very minor reason to prefer this is so that we
@@ -309,11 +373,11 @@ SkyPoint SkyObject::recomputeCoords(const KStarsDateTime &dt, const GeoLocation
     if (isSolarSystem() && geo)
     {
         CachingDms LST = geo->GSTtoLST(dt.gst());
-        c->updateCoords(&num, true, geo->lat(), &LST);
+        c->updateCoords(num.data(), true, geo->lat(), &LST);
     }
     else
     {
-        c->updateCoords(&num);
+        c->updateCoords(num.data());
     }
 
     // Transfer the coordinates into a SkyPoint
@@ -15,6 +15,8 @@
 #include <QString>
 #include <QStringList>
 
+#include <functional>
+
 class QPoint;
 class GeoLocation;
 class KSPopupMenu;
@@ -242,6 +244,20 @@ class SkyObject : public SkyPoint
      */
     QTime riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact = true) const;
 
+    /**
+     * @short Computes the coordinates of the object at a given UT date and time, like recomputeCoords().
+     * The overloads of the rise, set and transit functions taking one iterate on these
+     * positions instead, for instance positions interpolated from a KSEphemeris table.
+     */
+    typedef std::function<SkyPoint(const KStarsDateTime &)> PositionFunction;
+
+    /**
+     * @short Same as riseSetTime(), with the coordinates given by @p position.
+     * The iteration starts from the position at @p dt rather than the current one.
+     */
+    QTime riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                      const PositionFunction &position) const;
+
     /**
      * @return the UT time when the object will rise or set
      * @param dt  target date/time
@@ -252,6 +268,10 @@ class SkyObject : public SkyPoint
      */
     QTime riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact = true) const;
 
+    /** @short Same as riseSetTimeUT(), with the coordinates given by @p position */
+    QTime riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                        const PositionFunction &position) const;
+
     /**
      * @return the Azimuth time when the object will rise or set. This function
      * recomputes set or rise UT times.
@@ -270,6 +290,9 @@ class SkyObject : public SkyPoint
      */
     QTime transitTime(const KStarsDateTime &dt, const GeoLocation *geo) const;
 
+    /** @short Same as transitTime(), with the coordinates given by @p position */
+    QTime transitTime(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const;
+
     /**
      * @return the universal time that the object will transit the meridian.
      * @param dt   target date/time
@@ -277,6 +300,9 @@ class SkyObject : public SkyPoint
      */
     QTime transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo) const;
 
+    /** @short Same as transitTimeUT(), with the coordinates given by @p position */
+    QTime transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const;
+
     /**
      * @return the altitude of the object at the moment it transits the meridian.
      * @param dt  target date/time
@@ -284,6 +310,9 @@ class SkyObject : public SkyPoint
      */
     dms transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo) const;
 
+    /** @short Same as transitAltitude(), with the coordinates given by @p position */
+    dms transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position) const;
+
     /**
      * The equatorial coordinates for the object on date dt are computed and returned,
      * but the object's internal coordinates are not modified.
@@ -335,6 +364,17 @@ class SkyObject : public SkyPoint
     bool hashBeenUpdated() { return has_been_updated; }
 
   private:
+    /**
+     * The rise, set and transit computations, iterating on @p position from @p guess.
+     * If @p guess is null, the iteration starts from the position at @p dt.
+     */
+    QTime riseSetTime(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                      const PositionFunction &position, const SkyPoint *guess) const;
+    QTime riseSetTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, bool rst, bool exact,
+                        const PositionFunction &position, const SkyPoint *guess) const;
+    QTime transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, const PositionFunction &position,
+                        const SkyPoint *guess) const;
+
     /**
      * Compute the UT time when the object will rise or set. It is an auxiliary
      * procedure because it does not use the RA and DEC of the object but values
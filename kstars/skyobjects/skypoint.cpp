@@ -9,6 +9,7 @@
 
 #include "dms.h"
 #include "ksnumbers.h"
+#include "ksnumberscache.h"
 #include "kstarsdatetime.h"
 #include "kssun.h"
 #include "kstarsdata.h"
@@ -658,10 +659,10 @@ void SkyPoint::precessFromAnyEpoch(long double jd0, long double jdf)
             //Need to first precess to J2000.0 coords
             //s is the product of P1 and v; s represents the
             //coordinates precessed to J2000
-            KSNumbers num(jd0);
+            const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(jd0);
             for (unsigned int i = 0; i < 3; ++i)
             {
-                s[i] = num.p1(0, i) * v[0] + num.p1(1, i) * v[1] + num.p1(2, i) * v[2];
+                s[i] = num->p1(0, i) * v[0] + num->p1(1, i) * v[1] + num->p1(2, i) * v[2];
             }
 
             //Input coords already in J2000, set s accordingly.
@@ -682,10 +683,10 @@ void SkyPoint::precessFromAnyEpoch(long double jd0, long double jdf)
             return;
         }
 
-        KSNumbers num(jdf);
+        const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(jdf);
         for (unsigned int i = 0; i < 3; ++i)
         {
-            v[i] = num.p2(0, i) * s[0] + num.p2(1, i) * s[1] + num.p2(2, i) * s[2];
+            v[i] = num->p2(0, i) * s[0] + num->p2(1, i) * s[1] + num->p2(2, i) * s[2];
         }
 
         RA.setUsing_atan2(v[1], v[0]);
@@ -700,22 +701,22 @@ void SkyPoint::precessFromAnyEpoch(long double jd0, long double jdf)
 void SkyPoint::apparentCoord(long double jd0, long double jdf)
 {
     precessFromAnyEpoch(jd0, jdf);
-    KSNumbers num(jdf);
-    nutate(&num);
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(jdf);
+    nutate(num.data());
     if (Options::useRelativistic() && checkBendLight())
         bendlight();
-    aberrate(&num);
+    aberrate(num.data());
 }
 
 SkyPoint SkyPoint::catalogueCoord(long double jdf)
 {
-    KSNumbers num(jdf);
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(jdf);
 
     // remove abberation
-    aberrate(&num, true);
+    aberrate(num.data(), true);
 
     // remove nutation
-    nutate(&num, true);
+    nutate(num.data(), true);
 
     // remove precession
     // the start position needs to be in RA0,Dec0
@@ -1008,8 +1009,8 @@ double SkyPoint::vREarth(long double jd0)
     the source coordinates are also in the same reference system.
     */
 
-    KSNumbers num(jd0);
-    return num.vEarth(0) * cosDec * cosRA + num.vEarth(1) * cosDec * sinRA + num.vEarth(2) * sinDec;
+    const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(jd0);
+    return num->vEarth(0) * cosDec * cosRA + num->vEarth(1) * cosDec * sinRA + num->vEarth(2) * sinDec;
 }
 
 double SkyPoint::vGeocentric(double vhelio, long double jd0)
@@ -298,53 +298,50 @@ void SkyQPainter::drawSkyPolyline(LineList *list, SkipHashList *skipList,
                                   LineListLabel *label)
 {
     SkyList *points = list->points();
-    bool isVisible, isVisibleLast;
+    const int size  = points->size();
 
-    if (points->size() == 0)
+    if (size == 0)
         return;
-    QPointF oLast = m_proj->toScreen(points->first().get(), true, &isVisibleLast);
-    // & with the result of checkVisibility to clip away things below horizon
-    isVisibleLast &= m_proj->checkVisibility(points->first().get());
-    QPointF oThis, oThis2;
 
-    for (int j = 1; j < points->size(); j++)
+    // Project all the points first, into buffers kept between calls
+    m_polylinePoints.resize(size);
+    m_polylineVisible.resize(size);
+    m_proj->toScreen(size, [points](int j)
     {
-        SkyPoint *pThis = points->at(j).get();
+        return points->at(j).get();
+    }, m_polylinePoints.data(), m_polylineVisible.data());
+    // & with the result of checkVisibility to clip away things below horizon
+    for (int j = 0; j < size; j++)
+        m_polylineVisible[j] = m_polylineVisible[j] && m_proj->checkVisibility(points->at(j).get());
 
-        oThis2 = oThis = m_proj->toScreen(pThis, true, &isVisible);
-        // & with the result of checkVisibility to clip away things below horizon
-        isVisible &= m_proj->checkVisibility(pThis);
-        bool doSkip = false;
-        if (skipList)
-        {
-            doSkip = skipList->skip(j);
-        }
+    //Temporary solution to avoid random lines in Gnomonic projection and draw lines up to horizon
+    const bool gnomonic = m_proj->type() == Projector::Gnomonic;
 
+    // Draw the runs of consecutive segments as polylines
+    int runStart = -1;
+    for (int j = 1; j <= size; j++)
+    {
         bool pointsVisible = false;
-        //Temporary solution to avoid random lines in Gnomonic projection and draw lines up to horizon
-        if (SkyMap::Instance()->projector()->type() == Projector::Gnomonic)
+        if (j < size && !(skipList && skipList->skip(j)))
         {
-            if (isVisible && isVisibleLast)
-                pointsVisible = true;
+            if (gnomonic)
+                pointsVisible = m_polylineVisible[j] && m_polylineVisible[j - 1];
+            else
+                pointsVisible = m_polylineVisible[j] || m_polylineVisible[j - 1];
         }
-        else
+
+        if (pointsVisible)
         {
-            if (isVisible || isVisibleLast)
-                pointsVisible = true;
+            if (runStart < 0)
+                runStart = j - 1;
+            if (label)
+                label->updateLabelCandidates(m_polylinePoints[j].x(), m_polylinePoints[j].y(), list, j);
         }
-
-        if (!doSkip)
+        else if (runStart >= 0)
         {
-            if (pointsVisible)
-            {
-                drawLine(oLast, oThis);
-                if (label)
-                    label->updateLabelCandidates(oThis.x(), oThis.y(), list, j);
-            }
+            drawPolyline(m_polylinePoints.constData() + runStart, j - runStart);
+            runStart = -1;
         }
-
-        oLast         = oThis2;
-        isVisibleLast = isVisible;
     }
 }
 
@@ -11,6 +11,8 @@
 
 #include <QColor>
 #include <QMap>
+#include <QPointF>
+#include <QVector>
 
 class Projector;
 class QWidget;
@@ -117,6 +119,9 @@ class SkyQPainter : public SkyPainter, public QPainter
         TerrainRenderer *m_terrainRender{ nullptr };
         QSize m_size;
         QScopedPointer<QImage> m_HiPSImage;
+        /** Screen positions and visibility of the points of the last polyline, reused between calls */
+        QVector<QPointF> m_polylinePoints;
+        QVector<bool> m_polylineVisible;
         static int starColorMode;
         static QColor m_starColor;
         static QMap<char, QColor> ColorMap;
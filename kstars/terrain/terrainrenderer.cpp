@@ -16,6 +16,8 @@
 #include "kstars.h"
 
 #include <QStatusBar>
+#include <QThread>
+#include <QtConcurrent>
 
 // This is the factory that builds the one-and-only TerrainRenderer.
 TerrainRenderer * TerrainRenderer::_terrainRenderer = nullptr;
@@ -27,12 +29,35 @@ TerrainRenderer *TerrainRenderer::Instance()
     return _terrainRenderer;
 }
 
+// Put degrees in the range of 0 -> 359.99999999
+double rationalizeAz(double degrees)
+{
+    if (degrees < -1000 || degrees > 1000)
+        return 0;
+
+    while (degrees < 0)
+        degrees += 360.0;
+    while (degrees >= 360.0)
+        degrees -= 360.0;
+    return degrees;
+}
+
+// Checks that degrees in the range of -90 -> 90.
+double rationalizeAlt(double degrees)
+{
+    if (degrees > 90.0)
+        return 90.0;
+    if (degrees < -90)
+        return -90;
+    return degrees;
+}
+
 // This class implements a quick 2D float array.
 class TerrainLookup
 {
     public:
         TerrainLookup(int width, int height) :
-            valPtr(new float[width * height]), valWidth(width)
+            valPtr(new float[width * height]), valWidth(width), valHeight(height)
         {
             memset(valPtr, 0, width * height * sizeof(float));
         }
@@ -48,9 +73,18 @@ class TerrainLookup
         {
             valPtr[h * valWidth + w] = val;
         }
+        inline float *data()
+        {
+            return valPtr;
+        }
+        inline int size() const
+        {
+            return valWidth * valHeight;
+        }
     private:
         float *valPtr;
         int valWidth = 0;
+        int valHeight = 0;
 };
 
 // Samples 2-D array and returns interpolated values for the unsampled elements.
@@ -88,7 +122,7 @@ class InterpArray
 
         // Get the azimuth and altitude values from the 2D arrays.
         // Inputs are a full-image position
-        inline void get(int x, int y, float *az, float *alt)
+        inline void get(int x, int y, float *az, float *alt) const
         {
             const bool rowSampled = y % sampling == 0;
             const bool colSampled = x % sampling == 0;
@@ -172,6 +206,24 @@ class InterpArray
                 return;
             }
         }
+        // When the view is only panned in azimuth (in horizontal coordinates), all pixels keep
+        // their altitudes and their azimuths move by the same amount, so the lookup can be
+        // updated in place instead of re-projecting every sampled pixel.
+        void shiftAzimuth(double deltaAz)
+        {
+            float *az = azLookup->data();
+            const int size = azLookup->size();
+            for (int i = 0; i < size; ++i)
+                az[i] = rationalizeAz(az[i] + deltaAz);
+        }
+        int width() const
+        {
+            return lastDownsampledCol + 1;
+        }
+        int height() const
+        {
+            return lastDownsampledRow + 1;
+        }
         TerrainLookup *azimuthLookup()
         {
             return azLookup;
@@ -193,42 +245,51 @@ class InterpArray
         TerrainLookup *altLookup = nullptr;
 };
 
-TerrainRenderer::TerrainRenderer()
+namespace
 {
-}
+// A contiguous range of rows [start, end) processed by one worker.
+struct RowBand
+{
+    int start;
+    int end;
+};
 
-// Put degrees in the range of 0 -> 359.99999999
-double rationalizeAz(double degrees)
+// Splits numRows rows into bands to be processed in parallel.
+// Band boundaries fall on multiples of rowMultiple so that work which writes
+// rowMultiple rows at a time never crosses into a neighboring band.
+QVector<RowBand> makeBands(int numRows, int rowMultiple)
 {
-    if (degrees < -1000 || degrees > 1000)
-        return 0;
+    // A few bands per thread balance the load when some bands are mostly transparent.
+    const int numBands = std::max(1, QThread::idealThreadCount() * 4);
+    int rowsPerBand = (numRows + numBands - 1) / numBands;
+    rowsPerBand = std::max(rowMultiple, ((rowsPerBand + rowMultiple - 1) / rowMultiple) * rowMultiple);
+
+    QVector<RowBand> bands;
+    for (int start = 0; start < numRows; start += rowsPerBand)
+        bands.append({start, std::min(numRows, start + rowsPerBand)});
+    return bands;
+}
+}  // namespace
 
-    while (degrees < 0)
-        degrees += 360.0;
-    while (degrees >= 360.0)
-        degrees -= 360.0;
-    return degrees;
+TerrainRenderer::TerrainRenderer()
+{
 }
 
-// Checks that degrees in the range of -90 -> 90.
-double rationalizeAlt(double degrees)
+TerrainRenderer::~TerrainRenderer()
 {
-    if (degrees > 90.0)
-        return 90.0;
-    if (degrees < -90)
-        return -90;
-    return degrees;
 }
 
 // Assumes the source photosphere has rows which, left-to-right go from AZ=0 to AZ=360
 // and columns go from -90 altitude on the bottom to +90 on top.
 // Returns the pixel for the desired azimuth and altitude.
+// This is called for every rendered pixel from several threads, so it reads the option
+// values cached in render() and accesses the source image through its scanlines.
 QRgb TerrainRenderer::getPixel(double az, double alt) const
 {
-    az = rationalizeAz(az + Options::terrainSourceCorrectAz());
+    az = rationalizeAz(az + terrainSourceCorrectAz);
     // This may make alt > 90 (due to a negative sourceCorrectAlt).
     // If so, it returns 0, which is a transparent pixel.
-    alt = alt - Options::terrainSourceCorrectAlt();
+    alt = alt - terrainSourceCorrectAlt;
     if (az < 0 || az >= 360 || alt < -90 || alt > 90)
         return(0);
 
@@ -237,8 +298,12 @@ QRgb TerrainRenderer::getPixel(double az, double alt) const
         az = az - 360.0;
     const int width = sourceImage.width();
     const int height = sourceImage.height();
+    auto sourcePixel = [this](int x, int y)
+    {
+        return reinterpret_cast<const QRgb *>(sourceImage.constScanLine(y))[x];
+    };
 
-    if (!Options::terrainSmoothPixels())
+    if (!terrainSmoothPixels)
     {
         // az=0 should be the middle of the image.
         int pixX = width / 2 + (az / 360.0) * width;
@@ -250,7 +315,7 @@ QRgb TerrainRenderer::getPixel(double az, double alt) const
         if (pixY > height - 1)
             pixY = height - 1;
         pixY = (height - 1) - pixY;
-        return sourceImage.pixel(pixX, pixY);
+        return sourcePixel(pixX, pixY);
     }
 
     // Get floating point pixel positions so we can interpolate.
@@ -264,18 +329,18 @@ QRgb TerrainRenderer::getPixel(double az, double alt) const
         pixY = height - 1;
     pixY = (height - 1) - pixY;
 
-    // Don't bother interpolating for transparent pixels.
-    constexpr int lowAlpha = 0.1 * 255;
-    if (qAlpha(sourceImage.pixel(pixX, pixY)) < lowAlpha)
-        return sourceImage.pixel(pixX, pixY);
-
     // Instead of just returning the pixel at the truncated position as above,
     // below we interpolate the pixel RGBA values based on the floating-point pixel position.
     int x1 = static_cast<int>(pixX);
     int y1 = static_cast<int>(pixY);
 
+    // Don't bother interpolating for transparent pixels.
+    constexpr int lowAlpha = 0.1 * 255;
+    if (qAlpha(sourcePixel(x1, y1)) < lowAlpha)
+        return sourcePixel(x1, y1);
+
     if ((x1 >= width - 1) || (y1 >= height - 1))
-        return sourceImage.pixel(x1, y1);
+        return sourcePixel(x1, y1);
 
     // weights for the x & x+1, and y & y+1 positions.
     float wx2 = pixX - x1;
@@ -284,10 +349,10 @@ QRgb TerrainRenderer::getPixel(double az, double alt) const
     float wy1 = 1.0 - wy2;
 
     // The pixels we'll interpolate.
-    QRgb c11(qUnpremultiply(sourceImage.pixel(pixX, pixY)));
-    QRgb c12(qUnpremultiply(sourceImage.pixel(pixX, pixY + 1)));
-    QRgb c21(qUnpremultiply(sourceImage.pixel(pixX + 1, pixY)));
-    QRgb c22(qUnpremultiply(sourceImage.pixel(pixX + 1, pixY + 1)));
+    QRgb c11(qUnpremultiply(sourcePixel(x1, y1)));
+    QRgb c12(qUnpremultiply(sourcePixel(x1, y1 + 1)));
+    QRgb c21(qUnpremultiply(sourcePixel(x1 + 1, y1)));
+    QRgb c22(qUnpremultiply(sourcePixel(x1 + 1, y1 + 1)));
 
     // Weights for the above pixels.
     float w11 = wx1 * wy1;
@@ -403,65 +468,76 @@ bool TerrainRenderer::render(uint16_t w, uint16_t h, QImage *terrainImage, const
     // Only compute the pixel's az and alt values for every Nth pixel.
     // Get the other pixel az and alt values by interpolation.
     // This saves a lot of time.
-    const int sampling = Options::terrainDownsampling();
-    InterpArray interp(w, h, sampling);
+    const int sampling = terrainDownsampling;
     QElapsedTimer setupTimer;
     setupTimer.start();
-    setupLookup(w, h, sampling, proj, interp.azimuthLookup(), interp.altitudeLookup());
+    const InterpArray *interp = setupLookup(w, h, sampling, proj);
 
     const double setupTime = setupTimer.elapsed() / 1000.0; ///////////////////
 
     // Another speedup. If true, our calculations are downsampled by 2 in each dimension.
-    const bool skip = Options::terrainSkipSpeedup() || SkyMap::IsSlewing();
-    int increment = skip ? 2 : 1;
+    const bool skip = terrainSkipSpeedup || SkyMap::IsSlewing();
+    const int increment = skip ? 2 : 1;
+    const bool transparencySpeedup = terrainTransparencySpeedup;
+
+    // Pixels are written directly through the scanlines below, which requires a 32-bit image.
+    if (terrainImage->format() != QImage::Format_ARGB32_Premultiplied)
+        *terrainImage = terrainImage->convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
     // Assign transparent pixels everywhere by default.
     terrainImage->fill(0);
 
+    // bits() detaches the image, so call it once here rather than from the worker threads.
+    uchar *imageBits = terrainImage->bits();
+    const int bytesPerLine = terrainImage->bytesPerLine();
+
     // Go through the image, and for each pixel, using the previously computed az and alt values
     // get the corresponding pixel from the terrain image.
-    bool lastTransparent = false;
-    for (int j = 0; j < h; j += increment)
+    // The rows are split in bands which are rendered in parallel.
+    auto renderBand = [&](const RowBand & band)
     {
-        bool notLastRow = j != h - 1;
-        for (int i = 0; i < w; i += increment)
+        for (int j = band.start; j < band.end; j += increment)
         {
-            if (lastTransparent && Options::terrainTransparencySpeedup())
-            {
-                // Speedup--if the last pixel was transparent, then this
-                // one is assumed transparent too (but next is calculated).
-                lastTransparent = false;
-                continue;
-            }
-
-            const QPointF imgPoint(i, j);
-            bool equiRectangular = (proj->type() == Projector::Equirectangular);
-            bool usable = equiRectangular ? !dynamic_cast<const EquirectangularProjector*>(proj)->unusablePoint(imgPoint)
-                          : !proj->unusablePoint(imgPoint);
-            if (usable)
+            QRgb *row = reinterpret_cast<QRgb *>(imageBits + j * bytesPerLine);
+            QRgb *nextRow = (skip && j != h - 1) ? reinterpret_cast<QRgb *>(imageBits + (j + 1) * bytesPerLine) : nullptr;
+            bool lastTransparent = false;
+            for (int i = 0; i < w; i += increment)
             {
-                float az, alt;
-                interp.get(i, j, &az, &alt);
-                const QRgb pixel = getPixel(az, alt);
-                terrainImage->setPixel(i, j, pixel);
-                lastTransparent = (pixel == 0);
+                if (lastTransparent && transparencySpeedup)
+                {
+                    // Speedup--if the last pixel was transparent, then this
+                    // one is assumed transparent too (but next is calculated).
+                    lastTransparent = false;
+                    continue;
+                }
 
-                if (skip)
+                if (!proj->unusablePoint(QPointF(i, j)))
                 {
-                    // If we've skipped, fill in the missing pixels.
-                    bool notLastCol = i != w - 1;
-                    if (notLastCol)
-                        terrainImage->setPixel(i + 1, j, pixel);
-                    if (notLastRow)
-                        terrainImage->setPixel(i, j + 1, pixel);
-                    if (notLastRow && notLastCol)
-                        terrainImage->setPixel(i + 1, j + 1, pixel);
+                    float az, alt;
+                    interp->get(i, j, &az, &alt);
+                    const QRgb pixel = getPixel(az, alt);
+                    row[i] = pixel;
+                    lastTransparent = (pixel == 0);
+
+                    if (skip)
+                    {
+                        // If we've skipped, fill in the missing pixels.
+                        bool notLastCol = i != w - 1;
+                        if (notLastCol)
+                            row[i + 1] = pixel;
+                        if (nextRow)
+                            nextRow[i] = pixel;
+                        if (nextRow && notLastCol)
+                            nextRow[i + 1] = pixel;
+                    }
                 }
+                // Otherwise terrainImage was already filled with transparent pixels
+                // so i,j will be transparent.
             }
-            // Otherwise terrainImage was already filled with transparent pixels
-            // so i,j will be transparent.
         }
-    }
+    };
+    QVector<RowBand> bands = makeBands(h, increment);
+    QtConcurrent::blockingMap(bands, renderBand);
 
     savedImage = terrainImage->copy();
 
@@ -473,11 +549,11 @@ bool TerrainRenderer::render(uint16_t w, uint16_t h, QImage *terrainImage, const
                    .arg(timer.elapsed() / 1000.0, 5, 'f', 3)
                    .arg(setupTime, 5, 'f', 3)
                    .arg(fName)
-                   .arg(Options::terrainDownsampling())
-                   .arg(Options::terrainSkipSpeedup() ? "T" : "F")
-                   .arg(Options::terrainTransparencySpeedup() ? "T" : "F")
+                   .arg(terrainDownsampling)
+                   .arg(terrainSkipSpeedup ? "T" : "F")
+                   .arg(terrainTransparencySpeedup ? "T" : "F")
                    .arg(Options::terrainPanning() ? "T" : "F")
-                   .arg(Options::terrainSmoothPixels() ? "T" : "F"));
+                   .arg(terrainSmoothPixels ? "T" : "F"));
     //qCDebug(KSTARS) << dbgMsg;
     //fprintf(stderr, "%s\n", dbgMsg.toLatin1().data());
 
@@ -487,31 +563,74 @@ bool TerrainRenderer::render(uint16_t w, uint16_t h, QImage *terrainImage, const
 
 // Goes through every Nth input pixel position, finding their azimuth and altitude
 // and storing that for future use in the interpolations above.
-// This is the most time-costly part of the computation.
-void TerrainRenderer::setupLookup(uint16_t w, uint16_t h, int sampling, const Projector *proj, TerrainLookup *azLookup,
-                                  TerrainLookup *altLookup)
+// This is the most time-costly part of the computation, so the sampled rows are
+// projected in parallel, and the previous lookup is re-used when possible.
+const InterpArray *TerrainRenderer::setupLookup(uint16_t w, uint16_t h, int sampling, const Projector *proj)
 {
-    const auto &lst = KStarsData::Instance()->lst();
-    const auto &lat = KStarsData::Instance()->geo()->lat();
-    for (int j = 0, js = 0; j < h; j += sampling, js++)
+    const ViewParams view = proj->viewParams();
+    const double focusAz = view.focus->az().Degrees();
+    const double focusAlt = view.focus->alt().Degrees();
+
+    // Accumulated float rounding from repeated shifts is bounded by periodically recomputing.
+    constexpr int maxLookupShifts = 100;
+    const bool sameGeometry = lookup && lookupWidth == w && lookupHeight == h &&
+                              lookupSampling == sampling &&
+                              lookupProjection == proj->type() &&
+                              lookupViewParams.width == view.width &&
+                              lookupViewParams.height == view.height &&
+                              lookupViewParams.zoomFactor == view.zoomFactor &&
+                              lookupViewParams.useRefraction == view.useRefraction &&
+                              lookupViewParams.useAltAz == view.useAltAz;
+
+    // In horizontal coordinates, a pure azimuth pan shifts all the azimuths by the same amount.
+    // In equatorial coordinates the sky rotates with time, so the lookup is always recomputed.
+    if (sameGeometry && view.useAltAz && focusAlt == lookupAlt && lookupShifts < maxLookupShifts)
+    {
+        if (focusAz != lookupAz)
+        {
+            lookup->shiftAzimuth(focusAz - lookupAz);
+            lookupAz = focusAz;
+            lookupShifts++;
+        }
+        return lookup.get();
+    }
+
+    if (!sameGeometry)
+        lookup.reset(new InterpArray(w, h, sampling));
+    lookupWidth = w;
+    lookupHeight = h;
+    lookupSampling = sampling;
+    lookupProjection = proj->type();
+    lookupViewParams = view;
+    lookupViewParams.focus = nullptr;
+    lookupAz = focusAz;
+    lookupAlt = focusAlt;
+    lookupShifts = 0;
+
+    TerrainLookup *azLookup = lookup->azimuthLookup();
+    TerrainLookup *altLookup = lookup->altitudeLookup();
+    dms *lst = KStarsData::Instance()->lst();
+    const dms *lat = KStarsData::Instance()->geo()->lat();
+    auto setupBand = [&](const RowBand & band)
     {
-        for (int i = 0, is = 0; i < w; i += sampling, is++)
+        for (int js = band.start; js < band.end; js++)
         {
-            const QPointF imgPoint(i, j);
-            bool equiRectangular = (proj->type() == Projector::Equirectangular);
-            bool usable = equiRectangular ? !dynamic_cast<const EquirectangularProjector*>(proj)->unusablePoint(imgPoint)
-                          : !proj->unusablePoint(imgPoint);
-            if (usable)
+            const int j = js * sampling;
+            for (int i = 0, is = 0; i < w; i += sampling, is++)
             {
-                SkyPoint point = equiRectangular ?
-                                 dynamic_cast<const EquirectangularProjector*>(proj)->fromScreen(imgPoint, lst, lat, true)
-                                 : proj->fromScreen(imgPoint, lst, lat, true);
-                const double az = rationalizeAz(point.az().Degrees());
-                const double alt = rationalizeAlt(point.alt().Degrees());
-                azLookup->set(is, js, az);
-                altLookup->set(is, js, alt);
+                const QPointF imgPoint(i, j);
+                if (!proj->unusablePoint(imgPoint))
+                {
+                    SkyPoint point = proj->fromScreen(imgPoint, lst, lat, true);
+                    const double az = rationalizeAz(point.az().Degrees());
+                    const double alt = rationalizeAlt(point.alt().Degrees());
+                    azLookup->set(is, js, az);
+                    altLookup->set(is, js, alt);
+                }
             }
         }
-    }
+    };
+    QVector<RowBand> bands = makeBands(lookup->height(), 1);
+    QtConcurrent::blockingMap(bands, setupBand);
+    return lookup.get();
 }
-
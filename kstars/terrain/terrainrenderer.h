@@ -11,7 +11,7 @@
 #include <QImage>
 #include "projections/projector.h"
 
-class TerrainLookup;
+class InterpArray;
 
 class TerrainRenderer : public QObject
 {
@@ -20,7 +20,10 @@ class TerrainRenderer : public QObject
         // Create an instance of TerrainRenderer. We only have one.
         static TerrainRenderer *Instance();
 
+        ~TerrainRenderer() override;
+
         // Render terrainImage according to the loaded image and the projection.
+        // terrainImage should be in QImage::Format_ARGB32_Premultiplied.
         bool render(uint16_t w, uint16_t h, QImage *terrainImage, const Projector *proj);
     signals:
 
@@ -32,8 +35,8 @@ class TerrainRenderer : public QObject
 
         // Speed-up the image calculations by downsampling azimuth and altitude
         // computations of the pixels in the input view.
-        void setupLookup(uint16_t w, uint16_t h, int sampling, const Projector *proj,
-                         TerrainLookup *azLookup, TerrainLookup *altLookup);
+        // Returns the lookup, which is kept for re-use by the next frame.
+        const InterpArray *setupLookup(uint16_t w, uint16_t h, int sampling, const Projector *proj);
 
         // Returns the pixel in sourceImage for the given coordinates.
         QRgb getPixel(double az, double alt) const;
@@ -56,6 +59,18 @@ class TerrainRenderer : public QObject
         double savedAz, savedAlt;
         QImage savedImage;
 
+        // The azimuth/altitude lookup from the last render, and the view it was computed for.
+        // It is shifted, rather than recomputed, when the view is only panned in azimuth.
+        std::unique_ptr<InterpArray> lookup;
+        ViewParams lookupViewParams;
+        Projector::Projection lookupProjection { Projector::UnknownProjection };
+        int lookupWidth { 0 };
+        int lookupHeight { 0 };
+        int lookupSampling { 0 };
+        int lookupShifts { 0 };
+        double lookupAz { 0 };
+        double lookupAlt { 0 };
+
         // Keep the parameters used to display the last image
         // to see if something's changed and we need to redisplay.
         QString sourceFilename;
@@ -63,6 +78,6 @@ class TerrainRenderer : public QObject
         bool terrainSkipSpeedup = false;
         bool terrainSmoothPixels = false;
         bool terrainTransparencySpeedup = false;
-        bool terrainSourceCorrectAz = 0;
-        bool terrainSourceCorrectAlt = 0;
+        int terrainSourceCorrectAz = 0;
+        int terrainSourceCorrectAlt = 0;
 };
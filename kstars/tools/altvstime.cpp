@@ -414,9 +414,10 @@ void AltVsTime::processObject(SkyObject *o, bool forceAdd)
         // time range: 24h
 
         int offset = 3;
+        const KSEphemeris::TablePtr table = ephemerisOf(o);
         for (double h = -12.0, i = 0; h <= 12.0; h += 0.25, i++)
         {
-            y[i] = findAltitude(o, h);
+            y[i] = table ? findAltitude(*table, h) : findAltitude(o, h);
             if (y[i] > maxAlt)
                 maxAlt = y[i];
             if (y[i] < minAlt)
@@ -475,6 +476,23 @@ double AltVsTime::findAltitude(SkyPoint *p, double hour)
     return p->alt().Degrees();
 }
 
+double AltVsTime::findAltitude(const KSEphemeris::Table &table, double hour)
+{
+    hour += 24.0 * DayOffset;
+    return table.altitude(getDate().djd() + hour / 24.0).Degrees();
+}
+
+KSEphemeris::TablePtr AltVsTime::ephemerisOf(const SkyObject *o)
+{
+    const int planet = KSEphemeris::planetOf(o);
+    if (planet == KSPlanetBase::UNKNOWN_PLANET)
+        return KSEphemeris::TablePtr();
+
+    // The displayed day runs from noon to noon
+    const long double jd = getDate().djd() + DayOffset;
+    return KSEphemeris::Instance()->table(planet, geo, jd - 0.5, jd + 0.5);
+}
+
 void AltVsTime::slotHighlight(int row)
 {
     if (row < 0)
@@ -1001,9 +1019,10 @@ void AltVsTime::slotUpdateDateLoc()
             // compute the new graph values:
             // time range: 24h
             int offset = 3;
+            const KSEphemeris::TablePtr table = ephemerisOf(o);
             for (double h = -12.0, i = 0; h <= 12.0; h += 0.25, i++)
             {
-                point_altitudeValue = findAltitude(o, h);
+                point_altitudeValue = table ? findAltitude(*table, h) : findAltitude(o, h);
                 altitude_dataSet.push_back(point_altitudeValue);
                 if (point_altitudeValue > maxAlt)
                     maxAlt = point_altitudeValue;
@@ -9,6 +9,7 @@
 #include <QList>
 #include <QDialog>
 
+#include "ksephemeris.h"
 #include "ui_altvstime.h"
 
 class QCPAbstractPlottable;
@@ -106,6 +107,18 @@ class AltVsTime : public QDialog
      */
     double findAltitude(SkyPoint *p, double hour);
 
+    /**
+     * @short Determine the altitude of a solar system body, given an hour of the day.
+     * Unlike the SkyPoint version, this accounts for the motion of the body during the day.
+     * @param table the ephemeris of the body, see ephemerisOf()
+     * @param hour the time in the displayed day, expressed in hours
+     * @return the Altitude, expressed in degrees
+     */
+    double findAltitude(const KSEphemeris::Table &table, double hour);
+
+    /** @return the ephemeris of @p o over the displayed day, or null if @p o is not a major solar system body */
+    KSEphemeris::TablePtr ephemerisOf(const SkyObject *o);
+
     /**
      * @short get object name. If star has no name, generate a name based on catalog number.
      * @param o sky object.
@@ -12,7 +12,6 @@
 #include "conjunctions.h"
 
 #include "geolocation.h"
-#include "ksconjunct.h"
 #include "kstars.h"
 #include "ksnotification.h"
 #include "kstarsdata.h"
@@ -72,11 +71,8 @@ ConjunctionsTool::ConjunctionsTool(QWidget *parentSplit) : QFrame(parentSplit)
     // Mode Change
     connect(ModeSelector, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &ConjunctionsTool::setMode);
 
-    //connect(ComputeButton, SIGNAL(clicked()), this, SLOT(slotCompute()));
-    connect(ComputeButton, &QPushButton::clicked, [this]()
-    {
-        QtConcurrent::run(this, &ConjunctionsTool::slotCompute);
-    });
+    // The search itself runs in the background, see slotCompute()
+    connect(ComputeButton, SIGNAL(clicked()), this, SLOT(slotCompute()));
     connect(FilterTypeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(slotFilterType(int)));
     connect(ClearButton, SIGNAL(clicked()), this, SLOT(slotClear()));
     connect(ExportButton, SIGNAL(clicked()), this, SLOT(slotExport()));
@@ -128,6 +124,15 @@ ConjunctionsTool::ConjunctionsTool(QWidget *parentSplit) : QFrame(parentSplit)
     show();
 }
 
+ConjunctionsTool::~ConjunctionsTool()
+{
+    if (m_Search)
+    {
+        m_Search->cancel();
+        m_Watcher->waitForFinished();
+    }
+}
+
 void ConjunctionsTool::slotGoto()
 {
     int index      = m_SortModel->mapToSource(OutputList->currentIndex()).row(); // Get the number of the line
@@ -241,7 +246,10 @@ void ConjunctionsTool::slotCompute(void)
         opposition = true;
     QStringList objects; // List of sky object used as Object1
     KStarsData *data = KStarsData::Instance();
-    int progress     = 0;
+
+    // One search at a time
+    if (m_Search)
+        return;
 
     // Check if we have a valid angle in maxSeparationBox
     dms maxSeparation(0.0);
@@ -269,11 +277,6 @@ void ConjunctionsTool::slotCompute(void)
         return;
     }
 
-    // Init KSConjunct object
-    KSConjunct ksc;
-    connect(&ksc, SIGNAL(madeProgress(int)), this, SLOT(showProgress(int)));
-    ksc.setGeoLocation(geoPlace);
-
     switch (FilterTypeComboBox->currentIndex())
     {
         case 1: // All object types
@@ -340,55 +343,82 @@ void ConjunctionsTool::slotCompute(void)
         objects.removeAll("Iapetus");
     }
 
-    ksc.setMaxSeparation(maxSeparation);
-    ksc.setObject2(Object2);
-    ksc.setOpposition(opposition);
-
-    if (FilterTypeComboBox->currentIndex() != 0)
+    // The objects are looked up here, the search clones them in the background
+    QVector<QPair<QString, const SkyObject *>> searched;
+    SkyObject_s object1 = Object1;
+    if (FilterTypeComboBox->currentIndex() == 0)
     {
-        // Show a progress dialog while processing
-        QProgressDialog progressDlg(i18n("Compute conjunction..."), i18n("Abort"), 0, objects.count(), this);
-        progressDlg.setWindowTitle(i18nc("@title:window", "Conjunction"));
-        progressDlg.setWindowModality(Qt::WindowModal);
-        progressDlg.setValue(0);
-
-        for (auto &object : objects)
+        searched.append(qMakePair(Object1->name(), static_cast<const SkyObject *>(Object1.get())));
+    }
+    else
+    {
+        for (const auto &name : objects)
         {
-            // If the user click on the 'cancel' button
-            if (progressDlg.wasCanceled())
-                break;
-
-            // Update progress dialog
-            ++progress;
-            progressDlg.setValue(progress);
-            progressDlg.setLabelText(i18n("Compute conjunction between %1 and %2", Object2->name(), object));
-
-            // Compute conjuction
-            Object1 = std::shared_ptr<SkyObject>(data->skyComposite()->findByName(object)->clone());
-            ksc.setObject1(Object1);
-            showConjunctions(ksc.findClosestApproach(startJD, stopJD),
-                             object, Object2->name());
+            const SkyObject *object = data->skyComposite()->findByName(name);
+            if (object)
+                searched.append(qMakePair(name, object));
         }
+    }
 
-        progressDlg.setValue(objects.count());
+    const QString object2 = Object2->name();
+    m_Search              = new ConjunctionSearch(this);
+    m_Search->setGeoLocation(geoPlace);
+    m_Search->setPlanet(Obj2ComboBox->currentIndex());
+    m_Search->setMaxSeparation(maxSeparation);
+    m_Search->setOpposition(opposition);
+    Object2.reset();
+
+    QProgressDialog *progressDlg = nullptr;
+    if (FilterTypeComboBox->currentIndex() != 0)
+    {
+        // Show a progress dialog while processing
+        progressDlg = new QProgressDialog(i18n("Compute conjunction between %1 and %2 objects...", object2,
+                                               searched.count()), i18n("Abort"), 0, 100, this);
+        progressDlg->setWindowTitle(i18nc("@title:window", "Conjunction"));
+        progressDlg->setWindowModality(Qt::WindowModal);
+        progressDlg->setValue(0);
+        connect(m_Search, &ConjunctionSearch::madeProgress, progressDlg, &QProgressDialog::setValue);
+        connect(progressDlg, &QProgressDialog::canceled, m_Search, &ConjunctionSearch::cancel);
     }
     else
     {
         // Change cursor while we search for conjunction
         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-
         ComputeStack->setCurrentIndex(1);
+        connect(m_Search, &ConjunctionSearch::madeProgress, this, &ConjunctionsTool::showProgress);
+    }
+    ComputeButton->setEnabled(false);
 
-        ksc.setObject1(Object1);
-        showConjunctions(ksc.findClosestApproach(startJD, stopJD),
-                         Object1->name(), Object2->name());
-        ComputeStack->setCurrentIndex(0);
+    m_Watcher = new QFutureWatcher<QVector<ConjunctionSearch::Event>>(this);
+    connect(m_Watcher, &QFutureWatcherBase::finished, this, [this, progressDlg, object2]()
+    {
+        showConjunctions(m_Watcher->result(), object2);
 
-        // Restore cursor
-        QApplication::restoreOverrideCursor();
-    }
+        if (progressDlg)
+        {
+            progressDlg->deleteLater();
+        }
+        else
+        {
+            ComputeStack->setCurrentIndex(0);
+            // Restore cursor
+            QApplication::restoreOverrideCursor();
+        }
+        ComputeButton->setEnabled(true);
 
-    Object2.reset();
+        m_Search->deleteLater();
+        m_Watcher->deleteLater();
+        m_Search  = nullptr;
+        m_Watcher = nullptr;
+    });
+
+    ConjunctionSearch *search = m_Search;
+    m_Watcher->setFuture(QtConcurrent::run([search, searched, object1, startJD, stopJD]()
+    {
+        // The single object is a clone, kept alive until the search is done
+        Q_UNUSED(object1)
+        return search->find(searched, startJD, stopJD);
+    }));
 }
 
 void ConjunctionsTool::showProgress(int n)
@@ -426,6 +456,21 @@ void ConjunctionsTool::showConjunctions(const QMap<long double, dms> &conjunctio
     }
 }
 
+void ConjunctionsTool::showConjunctions(const QVector<ConjunctionSearch::Event> &events, const QString &object2)
+{
+    // The events of an object follow one another
+    QMap<long double, dms> conjunctionlist;
+    for (int i = 0; i < events.size(); ++i)
+    {
+        conjunctionlist.insert(events[i].jd, events[i].separation);
+        if (i + 1 == events.size() || events[i + 1].object != events[i].object)
+        {
+            showConjunctions(conjunctionlist, events[i].object, object2);
+            conjunctionlist.clear();
+        }
+    }
+}
+
 void ConjunctionsTool::setUpConjunctionOpposition()
 {
 
@@ -12,9 +12,11 @@
 #pragma once
 
 #include "dms.h"
+#include "conjunctionsearch.h"
 #include "ui_conjunctions.h"
 
 #include <QFrame>
+#include <QFutureWatcher>
 #include <QMap>
 #include <QString>
 #include "skycomponents/typedef.h"
@@ -30,7 +32,7 @@ class SkyObject;
 //FIXME: URGENT! There's a bug when setting max sep to 0!
 
 /**
-  * @short Predicts conjunctions using KSConjunct in the background
+  * @short Predicts conjunctions using ConjunctionSearch in the background
   */
 class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
 {
@@ -38,7 +40,7 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
 
   public:
     explicit ConjunctionsTool(QWidget *p);
-    virtual ~ConjunctionsTool() override = default;
+    virtual ~ConjunctionsTool() override;
 
   public slots:
 
@@ -57,6 +59,9 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
     void showConjunctions(const QMap<long double, dms> &conjunctionlist, const QString &object1,
                           const QString &object2);
 
+    /** @short Show the events of a search, grouped by object */
+    void showConjunctions(const QVector<ConjunctionSearch::Event> &events, const QString &object2);
+
     /**
      * @brief setUpConjunctionOpposition
      * @short set up ui for conj./opp.
@@ -83,4 +88,7 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
     QStandardItemModel *m_Model { nullptr };
     QSortFilterProxyModel *m_SortModel { nullptr };
     int m_index { 0 };
+    /// The running search, if any
+    ConjunctionSearch *m_Search { nullptr };
+    QFutureWatcher<QVector<ConjunctionSearch::Event>> *m_Watcher { nullptr };
 };
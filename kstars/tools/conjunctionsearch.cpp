@@ -0,0 +1,329 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "conjunctionsearch.h"
+
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "kstarsdata.h"
+#include "ksephemeris.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/ksplanetbase.h"
+#include "skyobjects/skyobject.h"
+
+#include <KLocalizedString>
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+struct ConjunctionSearch::Epoch
+{
+    long double jd { 0 };
+    std::unique_ptr<KSNumbers> num;
+    CachingDms lst;
+    std::unique_ptr<KSPlanet> earth;
+    // Direction of the planet
+    double x { 0 }, y { 0 }, z { 0 };
+};
+
+// Destroying a TrailObject updates the set of objects with a trail, which is not thread safe. The clones
+// are created and destroyed by the thread running find(), the workers only position them.
+struct ConjunctionSearch::Task
+{
+    std::unique_ptr<SkyObject> object;
+    QString name;
+    // Grid times whose minima the task looks for
+    int begin { 0 };
+    int end { 0 };
+    // Created when a minimum needs refining
+    std::unique_ptr<KSPlanetBase> planet;
+    std::unique_ptr<KSPlanet> earth;
+    QVector<Event> events;
+};
+
+namespace
+{
+// The first object is either a solar system body or a fixed object
+void updateObject(SkyObject *object, const KSNumbers *num, const CachingDms *lat, const CachingDms *lst,
+                  const KSPlanet *earth)
+{
+    KSPlanetBase *body = dynamic_cast<KSPlanetBase *>(object);
+    if (body)
+        body->findPosition(num, lat, lst, earth);
+    else
+        object->updateCoordsNow(num);
+}
+
+// Clones must not grow the trail of the original
+SkyObject *cloneObject(const SkyObject *object)
+{
+    SkyObject *clone  = object->clone();
+    KSPlanetBase *body = dynamic_cast<KSPlanetBase *>(clone);
+    if (body && body->hasTrail())
+        body->clearTrail();
+    return clone;
+}
+
+void direction(const SkyPoint *point, double *x, double *y, double *z)
+{
+    double sinRa, cosRa, sinDec, cosDec;
+    point->ra().SinCos(sinRa, cosRa);
+    point->dec().SinCos(sinDec, cosDec);
+    *x = cosDec * cosRa;
+    *y = cosDec * sinRa;
+    *z = sinDec;
+}
+}  // namespace
+
+ConjunctionSearch::ConjunctionSearch(QObject *parent) : QObject(parent)
+{
+    m_Geo   = KStarsData::Instance()->geo();
+    m_Earth = KSPlanet(i18n("Earth"), QString(), QColor("white"), 12756.28 /*diameter in km*/);
+}
+
+void ConjunctionSearch::setGeoLocation(const GeoLocation *geo)
+{
+    m_Geo = geo ? geo : KStarsData::Instance()->geo();
+}
+
+void ConjunctionSearch::setPlanet(int planet)
+{
+    m_Planet = planet;
+}
+
+void ConjunctionSearch::setMaxSeparation(const dms &separation)
+{
+    m_MaxSeparation = separation.radians();
+}
+
+void ConjunctionSearch::setOpposition(bool opposition)
+{
+    m_Opposition = opposition;
+}
+
+void ConjunctionSearch::cancel()
+{
+    m_Canceled = true;
+}
+
+double ConjunctionSearch::sampleStep(const SkyObject *object)
+{
+    // Short enough that the separation has at most one minimum over two steps
+    switch (object->type())
+    {
+        case SkyObject::MOON:
+            return 0.25;
+        case SkyObject::COMET:
+            return 0.5;
+        case SkyObject::ASTEROID:
+            return 1.0;
+        case SkyObject::PLANET:
+            break;
+        default:
+            // Stars and deep sky objects do not move
+            return std::numeric_limits<double>::infinity();
+    }
+
+    const QString name = object->name();
+    if (name == i18n("Mercury") || name == i18n("Venus"))
+        return 1.0;
+    if (name == i18n("Sun") || name == i18n("Mars"))
+        return 2.0;
+    if (name == i18n("Jupiter") || name == i18n("Saturn"))
+        return 5.0;
+    return 10.0;
+}
+
+double ConjunctionSearch::separationAt(long double jd, SkyObject *object, KSPlanetBase *planet, KSPlanet *earth) const
+{
+    // Same computation as KSConjunct::updatePositions()
+    KStarsDateTime t(jd);
+    KSNumbers num(jd);
+    earth->findPosition(&num);
+    CachingDms lst(m_Geo->GSTtoLST(t.gst()));
+
+    updateObject(object, &num, m_Geo->lat(), &lst, earth);
+    planet->findPosition(&num, m_Geo->lat(), &lst, earth);
+
+    const double separation = object->angularDistanceTo(planet).radians();
+    return m_Opposition ? dms::PI - separation : separation;
+}
+
+void ConjunctionSearch::refine(long double start, long double stop, SkyObject *object, KSPlanetBase *planet,
+                               KSPlanet *earth, long double *jd, double *separation) const
+{
+    // Golden section search, the separation has a single minimum in the interval
+    const double ratio = (std::sqrt(5.0) - 1) / 2;
+    long double a = start, b = stop;
+    long double c = b - ratio * (b - a), d = a + ratio * (b - a);
+    double fc = separationAt(c, object, planet, earth);
+    double fd = separationAt(d, object, planet, earth);
+    while (b - a > 0.5 / 1440.0)
+    {
+        if (fc < fd)
+        {
+            b  = d;
+            d  = c;
+            fd = fc;
+            c  = b - ratio * (b - a);
+            fc = separationAt(c, object, planet, earth);
+        }
+        else
+        {
+            a  = c;
+            c  = d;
+            fc = fd;
+            d  = a + ratio * (b - a);
+            fd = separationAt(d, object, planet, earth);
+        }
+    }
+
+    *jd         = (a + b) / 2;
+    *separation = separationAt(*jd, object, planet, earth);
+}
+
+QVector<ConjunctionSearch::Event> ConjunctionSearch::find(const QVector<QPair<QString, const SkyObject *>> &objects,
+        long double startJD, long double stopJD)
+{
+    m_Canceled = false;
+    if (objects.isEmpty() || stopJD <= startJD)
+        return QVector<Event>();
+
+    std::unique_ptr<KSPlanetBase> planet(KSPlanetBase::createPlanet(m_Planet));
+    if (!planet)
+        return QVector<Event>();
+
+    // The orbital data of the planets among the objects is loaded on first use, load it before the workers
+    {
+        KSPlanet earth(m_Earth);
+        for (const auto &object : objects)
+        {
+            if (object.second->type() == SkyObject::PLANET || object.second->type() == SkyObject::MOON)
+            {
+                std::unique_ptr<SkyObject> clone(cloneObject(object.second));
+                separationAt(startJD, clone.get(), planet.get(), &earth);
+            }
+        }
+    }
+
+    // A common grid, fine enough for the fastest of the objects
+    double step = std::min(sampleStep(planet.get()), double(stopJD - startJD) / 4.0);
+    for (const auto &object : objects)
+        step = std::min(step, sampleStep(object.second));
+    const int count = int(std::ceil(double(stopJD - startJD) / step)) + 1;
+
+    // The planet at the grid times, with what the objects need to be positioned at the same times
+    QVector<long double> times(count);
+    for (int i = 0; i < count; ++i)
+        times[i] = std::min(stopJD, startJD + i * step);
+
+    std::vector<Epoch> epochs(count);
+    KSEphemeris::computePositions(m_Planet, m_Geo, times, [&epochs](int i, const KSEphemeris::Sample & sample)
+    {
+        Epoch &epoch = epochs[i];
+        epoch.jd     = sample.jd;
+        epoch.num.reset(new KSNumbers(*sample.num));
+        epoch.lst = *sample.lst;
+        epoch.earth.reset(new KSPlanet(*sample.earth));
+        direction(sample.body, &epoch.x, &epoch.y, &epoch.z);
+    });
+
+    const int threads = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    // With few objects, the grid is split too so that all threads have work
+    const int parts = std::max(1, std::min(count / 16, (2 * threads + objects.size() - 1) / objects.size()));
+    std::vector<Task> tasks(objects.size() * parts);
+    for (int i = 0; i < objects.size(); ++i)
+    {
+        for (int part = 0; part < parts; ++part)
+        {
+            Task &task = tasks[i * parts + part];
+            task.object.reset(cloneObject(objects[i].second));
+            task.name  = objects[i].first;
+            task.begin = qint64(count) * part / parts;
+            task.end   = qint64(count) * (part + 1) / parts;
+        }
+    }
+
+    std::atomic<int> done { 0 };
+    std::atomic<int> reported { 0 };
+    QtConcurrent::blockingMap(tasks, [&](Task & task)
+    {
+        if (m_Canceled)
+            return;
+
+        // The samples on both sides of the task are needed to find its minima
+        const int first = std::max(0, task.begin - 1);
+        const int last  = std::min(count, task.end + 1);
+        const int size  = last - first;
+
+        SkyObject *object = task.object.get();
+        std::vector<double> x(size), y(size), z(size);
+        for (int i = 0; i < size; ++i)
+        {
+            const Epoch &epoch = epochs[first + i];
+            updateObject(object, epoch.num.get(), m_Geo->lat(), &epoch.lst, epoch.earth.get());
+            direction(object, &x[i], &y[i], &z[i]);
+        }
+
+        // Coarse separations, a plain loop over arrays
+        std::vector<double> separation(size);
+        for (int i = 0; i < size; ++i)
+        {
+            const Epoch &epoch = epochs[first + i];
+            const double dot   = x[i] * epoch.x + y[i] * epoch.y + z[i] * epoch.z;
+            separation[i]      = std::acos(std::max(-1.0, std::min(1.0, dot)));
+        }
+        if (m_Opposition)
+        {
+            for (auto &value : separation)
+                value = dms::PI - value;
+        }
+
+        for (int k = std::max(task.begin, 1); k < std::min(task.end, count - 1); ++k)
+        {
+            const int i = k - first;
+            if (separation[i] > separation[i - 1] || separation[i] >= separation[i + 1])
+                continue;
+
+            // Between samples, the separation cannot drop by more than the largest change over a step
+            const double margin = std::max(separation[i - 1] - separation[i], separation[i + 1] - separation[i]);
+            if (separation[i] - margin >= m_MaxSeparation)
+                continue;
+
+            if (!task.planet)
+            {
+                task.planet.reset(KSPlanetBase::createPlanet(m_Planet));
+                task.earth.reset(new KSPlanet(m_Earth));
+            }
+
+            Event event;
+            double value;
+            refine(epochs[k - 1].jd, epochs[k + 1].jd, object, task.planet.get(), task.earth.get(), &event.jd,
+                   &value);
+            if (value < m_MaxSeparation)
+            {
+                event.object = task.name;
+                event.separation.setRadians(value);
+                task.events.append(event);
+            }
+        }
+
+        const int progress = int(100.0 * ++done / tasks.size());
+        if (progress > reported.exchange(progress))
+            emit madeProgress(progress);
+    });
+
+    QVector<Event> events;
+    for (const auto &task : tasks)
+        events.append(task.events);
+    return events;
+}
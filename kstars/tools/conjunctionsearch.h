@@ -0,0 +1,100 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "dms.h"
+#include "skyobjects/ksplanet.h"
+
+#include <QObject>
+#include <QPair>
+#include <QVector>
+
+#include <atomic>
+
+class GeoLocation;
+class SkyObject;
+
+/**
+ * @class ConjunctionSearch
+ * @short Finds the conjunctions or oppositions of many objects with a planet, in parallel.
+ *
+ * Unlike KSConjunct, which steps through the time range one object at a time, the search
+ * samples the positions of all objects on a common grid of times. The positions of the
+ * planet are computed once for the grid. The work is split by object and, when there are
+ * few objects, by time range too, across the threads of the global thread pool.
+ *
+ * The separations at the grid times are a coarse scan. Only the local minima that may lie
+ * within the maximum separation, given how fast the separation changes between samples,
+ * are refined to the minute. Pairs that never get close cost one scan and nothing more.
+ */
+class ConjunctionSearch : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Event
+        {
+            /** Name of the first object, as given to find() */
+            QString object;
+            long double jd { 0 };
+            dms separation;
+        };
+
+        explicit ConjunctionSearch(QObject *parent = nullptr);
+
+        /** @short Sets the location the positions are computed for, the current location if null */
+        void setGeoLocation(const GeoLocation *geo);
+
+        /** @short Sets the second object, a KSPlanetBase::Planets identifier */
+        void setPlanet(int planet);
+
+        void setMaxSeparation(const dms &separation);
+
+        /** @short Look for oppositions instead of conjunctions */
+        void setOpposition(bool opposition);
+
+        /**
+         * @short Finds the closest approaches of each object to the planet between two dates.
+         * Blocks until done. The objects are cloned, they are not modified.
+         * @param objects the names and objects to search
+         * @return the events closer than the maximum separation, by object and date
+         */
+        QVector<Event> find(const QVector<QPair<QString, const SkyObject *>> &objects, long double startJD,
+                            long double stopJD);
+
+        /** @return the interval between the coarse samples of @p object, in days */
+        static double sampleStep(const SkyObject *object);
+
+    public slots:
+        /** @short Stops a running search, find() returns the events found so far */
+        void cancel();
+
+    signals:
+        /** @param progress progress in percent, emitted from the worker threads */
+        void madeProgress(int progress);
+
+    private:
+        /** Time of the coarse grid, with what is needed to compute the positions at that time */
+        struct Epoch;
+
+        /** An object over a part of the grid */
+        struct Task;
+
+        /** @short Separation in radians between @p object and @p planet at @p jd, updating both */
+        double separationAt(long double jd, SkyObject *object, KSPlanetBase *planet, KSPlanet *earth) const;
+
+        /** @short Finds the minimum of the separation between @p start and @p stop, to the minute */
+        void refine(long double start, long double stop, SkyObject *object, KSPlanetBase *planet, KSPlanet *earth,
+                    long double *jd, double *separation) const;
+
+        const GeoLocation *m_Geo { nullptr };
+        int m_Planet { KSPlanetBase::MOON };
+        double m_MaxSeparation { 1.0 * dms::DegToRad };
+        bool m_Opposition { false };
+        KSPlanet m_Earth;
+        std::atomic<bool> m_Canceled { false };
+};
@@ -7,6 +7,7 @@
 #include "jmoontool.h"
 
 #include "ksnumbers.h"
+#include "ksnumberscache.h"
 #include "kstars.h"
 
 #include "skymapcomposite.h"
@@ -134,7 +135,7 @@ void JMoonTool::initPlotObjects()
     //t is the offset from jd0, in days.
     for (double t = dataRect.y(); t <= dataRect.bottom(); t += dy)
     {
-        KSNumbers num(jd0 + t);
+        KSNumbers num = KSNumbersCache::Instance()->interpolated(jd0 + t);
         jm.findPosition(&num, jup, ksun);
 
         //jm.x(i) tells the offset from Jupiter, in units of Jupiter's angular radius.
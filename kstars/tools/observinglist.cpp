@@ -16,6 +16,7 @@
 #include "imageviewer.h"
 #include "ksalmanac.h"
 #include "ksnotification.h"
+#include "ksnumberscache.h"
 #include "ksdssdownloader.h"
 #include "kspaths.h"
 #include "kstars.h"
@@ -296,9 +297,9 @@ void ObservingList::slotAddObject(const SkyObject *_obj, bool session, bool upda
             obj->type() == SkyObject::PLANET) &&
             obj->mag() == 0)
     {
-        KSNumbers num(dt.djd());
+        const KSNumbersCache::NumbersPtr num = KSNumbersCache::Instance()->numbers(dt.djd());
         CachingDms LST = geo->GSTtoLST(dt.gst());
-        obj->updateCoords(&num, true, geo->lat(), &LST, true);
+        obj->updateCoords(num.data(), true, geo->lat(), &LST, true);
     }
 
     QString smag = "--";
@@ -0,0 +1,300 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "obslistfilter.h"
+
+#include "catalogobject.h"
+#include "dms.h"
+#include "skyobjects/skyobject.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Objects evaluated by a task
+constexpr int chunkSize = 4096;
+
+struct Chunk
+{
+    int begin;
+    int end;
+};
+
+std::vector<Chunk> chunks(int size)
+{
+    std::vector<Chunk> result;
+    for (int i = 0; i < size; i += chunkSize)
+        result.push_back({ i, std::min(size, i + chunkSize) });
+    return result;
+}
+
+// Runs @p function over the chunks of [0, size) in parallel
+void forEachChunk(int size, const std::function<void(int, int)> &function)
+{
+    std::vector<Chunk> list = chunks(size);
+    QtConcurrent::blockingMap(list, [&](const Chunk & chunk)
+    {
+        function(chunk.begin, chunk.end);
+    });
+}
+}  // namespace
+
+void ObsListFilter::addObjects(Category category, const QList<SkyObject *> &objects)
+{
+    for (SkyObject *object : objects)
+        append(object, category);
+}
+
+void ObsListFilter::addDeepSkyObjects(CatalogsDB::CatalogObjectList objects)
+{
+    for (auto it = objects.begin(); it != objects.end();)
+    {
+        const Category category = deepSkyCategory(it->type());
+        if (category == CATEGORY_COUNT)
+        {
+            it = objects.erase(it);
+            continue;
+        }
+        append(&*it, category);
+        ++it;
+    }
+    // The elements of a list do not move when it is spliced
+    m_DeepSky.splice(m_DeepSky.end(), objects);
+}
+
+ObsListFilter::Category ObsListFilter::deepSkyCategory(int type)
+{
+    switch (type)
+    {
+        case SkyObject::OPEN_CLUSTER:
+            return OPEN_CLUSTERS;
+        case SkyObject::GLOBULAR_CLUSTER:
+            return GLOBULAR_CLUSTERS;
+        case SkyObject::GASEOUS_NEBULA:
+        case SkyObject::SUPERNOVA_REMNANT:
+            return GASEOUS_NEBULAE;
+        case SkyObject::PLANETARY_NEBULA:
+            return PLANETARY_NEBULAE;
+        case SkyObject::GALAXY:
+            return GALAXIES;
+        default:
+            return CATEGORY_COUNT;
+    }
+}
+
+void ObsListFilter::append(SkyObject *object, Category category)
+{
+    double sinRA, cosRA, sinDec, cosDec;
+    object->ra().SinCos(sinRA, cosRA);
+    object->dec().SinCos(sinDec, cosDec);
+
+    m_Objects.push_back(object);
+    m_Category.push_back(category);
+    m_Mag.push_back(object->mag());
+    m_RA.push_back(object->ra().Hours());
+    m_Dec.push_back(object->dec().Degrees());
+    m_SinRA.push_back(sinRA);
+    m_CosRA.push_back(cosRA);
+    m_SinDec.push_back(sinDec);
+    m_CosDec.push_back(cosDec);
+    m_Constellation.push_back(-1);
+
+    m_RegionValid = m_MagnitudeValid = m_ObservableValid = false;
+}
+
+void ObsListFilter::updateConstellations(const Criteria &criteria,
+        const std::function<QString(const SkyPoint *)> &constellationName)
+{
+    if (criteria.region != CONSTELLATIONS)
+        return;
+
+    for (int i = 0; i < size(); ++i)
+    {
+        if (m_Constellation[i] >= 0 || !(criteria.categories & (1u << m_Category[i])))
+            continue;
+
+        const QString name = constellationName(m_Objects[i]);
+        int index          = m_ConstellationNames.indexOf(name);
+        if (index < 0)
+        {
+            index = m_ConstellationNames.size();
+            m_ConstellationNames.append(name);
+        }
+        m_Constellation[i] = index;
+        m_RegionValid      = false;
+    }
+}
+
+void ObsListFilter::update(const Criteria &criteria)
+{
+    const int n = size();
+    m_InRegion.resize(n);
+    m_Bright.resize(n);
+    m_Observable.resize(n);
+
+    const Criteria &last = m_Last;
+
+    // Region
+    const bool sameRegion =
+        m_RegionValid && criteria.region == last.region &&
+        (criteria.region != CONSTELLATIONS || criteria.constellations == last.constellations) &&
+        (criteria.region != RECTANGLE || (criteria.raMin == last.raMin && criteria.raMax == last.raMax &&
+                                          criteria.decMin == last.decMin && criteria.decMax == last.decMax)) &&
+        (criteria.region != CIRCLE || (criteria.centerRA == last.centerRA && criteria.centerDec == last.centerDec &&
+                                       criteria.radius == last.radius));
+    if (!sameRegion)
+    {
+        switch (criteria.region)
+        {
+            case ALL_SKY:
+                std::fill(m_InRegion.begin(), m_InRegion.end(), 1);
+                break;
+
+            case CONSTELLATIONS:
+            {
+                std::vector<char> selected(m_ConstellationNames.size());
+                for (int i = 0; i < m_ConstellationNames.size(); ++i)
+                    selected[i] = criteria.constellations.contains(m_ConstellationNames.at(i));
+                forEachChunk(n, [&](int begin, int end)
+                {
+                    for (int i = begin; i < end; ++i)
+                        m_InRegion[i] = m_Constellation[i] >= 0 && selected[m_Constellation[i]];
+                });
+                break;
+            }
+
+            case RECTANGLE:
+                forEachChunk(n, [&](int begin, int end)
+                {
+                    for (int i = begin; i < end; ++i)
+                    {
+                        const double ra = m_RA[i], dec = m_Dec[i];
+                        bool inside     = dec >= criteria.decMin && dec <= criteria.decMax;
+                        if (criteria.raMin < 0.0)
+                            inside = inside && (ra >= criteria.raMin + 24.0 || ra <= criteria.raMax);
+                        else
+                            inside = inside && ra >= criteria.raMin && ra <= criteria.raMax;
+                        m_InRegion[i] = inside;
+                    }
+                });
+                break;
+
+            case CIRCLE:
+            {
+                // Within the radius if the cosine of the distance to the center is larger
+                double sinRA0, cosRA0, sinDec0, cosDec0;
+                dms(criteria.centerRA).SinCos(sinRA0, cosRA0);
+                dms(criteria.centerDec).SinCos(sinDec0, cosDec0);
+                const double cosRadius = std::cos(criteria.radius * dms::DegToRad);
+                forEachChunk(n, [&](int begin, int end)
+                {
+                    for (int i = begin; i < end; ++i)
+                    {
+                        const double cosRA = m_CosRA[i] * cosRA0 + m_SinRA[i] * sinRA0;
+                        m_InRegion[i] = m_SinDec[i] * sinDec0 + m_CosDec[i] * cosDec0 * cosRA > cosRadius;
+                    }
+                });
+                break;
+            }
+        }
+        m_RegionValid = true;
+    }
+
+    // Magnitude
+    const bool sameMagnitude = m_MagnitudeValid && criteria.byMagnitude == last.byMagnitude &&
+                               (!criteria.byMagnitude || (criteria.maglim == last.maglim &&
+                                       criteria.includeNoMag == last.includeNoMag));
+    if (!sameMagnitude)
+    {
+        forEachChunk(n, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                if (!criteria.byMagnitude)
+                    m_Bright[i] = true;
+                else if (m_Mag[i] > 90.0)
+                    m_Bright[i] = criteria.includeNoMag;
+                else
+                    m_Bright[i] = m_Mag[i] <= criteria.maglim;
+            }
+        });
+        m_MagnitudeValid = true;
+    }
+
+    // Observability, the altitude is within range when its sine is
+    const bool sameObservable =
+        m_ObservableValid && criteria.byDate == last.byDate &&
+        (!criteria.byDate || (criteria.siderealTimes == last.siderealTimes && criteria.latitude == last.latitude &&
+                              criteria.minAlt == last.minAlt && criteria.maxAlt == last.maxAlt &&
+                              criteria.coverage == last.coverage));
+    if (!sameObservable)
+    {
+        if (!criteria.byDate)
+        {
+            std::fill(m_Observable.begin(), m_Observable.end(), 1);
+        }
+        else
+        {
+            const int samples = criteria.siderealTimes.size();
+            std::vector<double> sinLST(samples), cosLST(samples);
+            for (int s = 0; s < samples; ++s)
+                dms(criteria.siderealTimes[s]).SinCos(sinLST[s], cosLST[s]);
+
+            double sinLat, cosLat;
+            dms(criteria.latitude).SinCos(sinLat, cosLat);
+            const double low  = std::sin(qBound(-90.0, criteria.minAlt, 90.0) * dms::DegToRad);
+            const double high = std::sin(qBound(-90.0, criteria.maxAlt, 90.0) * dms::DegToRad);
+            // The object must be visible in that many samples
+            const double needed = samples * criteria.coverage / 100.0;
+
+            forEachChunk(n, [&](int begin, int end)
+            {
+                std::vector<int> visible(end - begin);
+                for (int s = 0; s < samples; ++s)
+                {
+                    for (int i = begin; i < end; ++i)
+                    {
+                        // Hour angle cosine from the sidereal time and right ascension
+                        const double cosH   = cosLST[s] * m_CosRA[i] + sinLST[s] * m_SinRA[i];
+                        const double sinAlt = m_SinDec[i] * sinLat + m_CosDec[i] * cosLat * cosH;
+                        visible[i - begin] += sinAlt >= low && sinAlt <= high;
+                    }
+                }
+                for (int i = begin; i < end; ++i)
+                    m_Observable[i] = samples > 0 && visible[i - begin] >= needed;
+            });
+        }
+        m_ObservableValid = true;
+    }
+
+    m_Last = criteria;
+}
+
+int ObsListFilter::count(const Criteria &criteria)
+{
+    update(criteria);
+
+    int result = 0;
+    for (int i = 0; i < size(); ++i)
+        result += passes(criteria, i);
+    return result;
+}
+
+QVector<int> ObsListFilter::matches(const Criteria &criteria)
+{
+    update(criteria);
+
+    QVector<int> result;
+    for (int i = 0; i < size(); ++i)
+    {
+        if (passes(criteria, i))
+            result.append(i);
+    }
+    return result;
+}
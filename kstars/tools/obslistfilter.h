@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "catalogsdb.h"
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+#include <vector>
+
+class SkyObject;
+class SkyPoint;
+
+/**
+ * @class ObsListFilter
+ * @short Filters the objects offered by the observing list wizard.
+ *
+ * The coordinates and magnitudes of the objects are copied into arrays once. The region,
+ * magnitude and observability predicates are then evaluated over the arrays, in chunks
+ * across the threads of the global thread pool. The altitudes are computed for all the
+ * objects of a chunk at one time after another, from the sines and cosines kept in the
+ * arrays.
+ *
+ * The result of each predicate is kept per object. When the criteria change, only the
+ * predicates whose criteria changed are evaluated again, so changing the magnitude limit
+ * does not compute the altitudes again.
+ *
+ * count() and matches() may be called from any thread, but not concurrently with each
+ * other or with the functions adding objects or updating the constellations.
+ */
+class ObsListFilter
+{
+    public:
+        /** The object types of the wizard */
+        enum Category
+        {
+            STARS,
+            PLANETS,
+            OPEN_CLUSTERS,
+            GLOBULAR_CLUSTERS,
+            GASEOUS_NEBULAE,
+            PLANETARY_NEBULAE,
+            GALAXIES,
+            COMETS,
+            ASTEROIDS,
+            CATEGORY_COUNT
+        };
+
+        enum Region
+        {
+            ALL_SKY,
+            CONSTELLATIONS,
+            RECTANGLE,
+            CIRCLE
+        };
+
+        struct Criteria
+        {
+            /** Selected categories, one bit per Category */
+            uint categories { 0 };
+
+            Region region { ALL_SKY };
+            /** Names of the selected constellations */
+            QSet<QString> constellations;
+            /** Rectangle in hours and degrees. raMin is negative for a rectangle across 0h. */
+            double raMin { 0 }, raMax { 24 }, decMin { -90 }, decMax { 90 };
+            /** Circle center and radius, in degrees */
+            double centerRA { 0 }, centerDec { 0 }, radius { 0 };
+
+            bool byMagnitude { false };
+            double maglim { 100 };
+            /** Keep the objects without magnitude, whose magnitude is above 90 */
+            bool includeNoMag { false };
+
+            bool byDate { false };
+            /** Local sidereal times at which the altitudes are sampled, in degrees */
+            QVector<double> siderealTimes;
+            /** Latitude of the location, in degrees */
+            double latitude { 0 };
+            double minAlt { 15 }, maxAlt { 90 };
+            /** Percentage of the samples at which the altitude must be within range */
+            double coverage { 100 };
+        };
+
+        /** @short Adds objects of a category. Their coordinates are copied, the objects must outlive the filter. */
+        void addObjects(Category category, const QList<SkyObject *> &objects);
+
+        /** @short Adds deep sky objects, the filter keeps them. Objects of other types are ignored. */
+        void addDeepSkyObjects(CatalogsDB::CatalogObjectList objects);
+
+        /** @return the number of objects */
+        int size() const
+        {
+            return int(m_Objects.size());
+        }
+
+        SkyObject *object(int index) const
+        {
+            return m_Objects[index];
+        }
+
+        Category category(int index) const
+        {
+            return Category(m_Category[index]);
+        }
+
+        /** @return the category of deep sky objects of @p type, or CATEGORY_COUNT if none */
+        static Category deepSkyCategory(int type);
+
+        static bool isDeepSky(Category category)
+        {
+            return category >= OPEN_CLUSTERS && category <= GALAXIES;
+        }
+
+        /**
+         * @short Finds the constellations of the objects of the selected categories, if the region is by constellation.
+         * Each object is located once. To be called before count() or matches(), from the thread that may locate objects.
+         * @param constellationName returns the name of the constellation of a point
+         */
+        void updateConstellations(const Criteria &criteria,
+                                  const std::function<QString(const SkyPoint *)> &constellationName);
+
+        /** @return the number of objects meeting @p criteria */
+        int count(const Criteria &criteria);
+
+        /** @return the indexes of the objects meeting @p criteria, in the order they were added */
+        QVector<int> matches(const Criteria &criteria);
+
+    private:
+        /** @short Evaluates the predicates whose criteria changed since the last call */
+        void update(const Criteria &criteria);
+
+        void append(SkyObject *object, Category category);
+
+        /** @return true if the object at @p index passes the predicates of @p criteria */
+        bool passes(const Criteria &criteria, int index) const
+        {
+            return (criteria.categories & (1u << m_Category[index])) && m_InRegion[index] && m_Bright[index] &&
+                   m_Observable[index];
+        }
+
+        std::vector<SkyObject *> m_Objects;
+        std::vector<quint8> m_Category;
+        std::vector<float> m_Mag;
+        /** Right ascensions in hours and declinations in degrees */
+        std::vector<double> m_RA, m_Dec;
+        std::vector<double> m_SinRA, m_CosRA, m_SinDec, m_CosDec;
+        /** Index in m_ConstellationNames, -1 while not located */
+        std::vector<int> m_Constellation;
+        QStringList m_ConstellationNames;
+
+        /** Results of the predicates, the category excepted */
+        std::vector<char> m_InRegion, m_Bright, m_Observable;
+        /** Criteria of the results, and whether they are up to date */
+        Criteria m_Last;
+        bool m_RegionValid { false };
+        bool m_MagnitudeValid { false };
+        bool m_ObservableValid { false };
+
+        CatalogsDB::CatalogObjectList m_DeepSky;
+};
@@ -13,9 +13,14 @@
 #include "skycomponents/constellationboundarylines.h"
 #include "skycomponents/catalogscomponent.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skyobjects/ksplanetbase.h"
 #include "catalogobject.h"
 #include "catalogsdb.h"
 
+#include <QtConcurrent>
+
+#include <algorithm>
+
 ObsListWizardUI::ObsListWizardUI(QWidget *p) : QFrame(p)
 {
     setupUi(this);
@@ -57,9 +62,12 @@ ObsListWizard::ObsListWizard(QWidget *ksparent) : QDialog(ksparent)
 
     //Update the count of objects when the user asks for it
     connect(olw->updateButton, SIGNAL(clicked()), this, SLOT(slotUpdateObjectCount()));
+    connect(&m_CountWatcher, &QFutureWatcher<int>::finished, this, &ObsListWizard::slotCountFinished);
+    connect(&m_DeepSkyWatcher, &QFutureWatcher<void>::finished, this, &ObsListWizard::slotDeepSkyLoaded);
 
-    // Enable the update count button when certain elements are changed
+    // Count the objects again when certain elements are changed
     connect(olw->TypeList, &QListWidget::itemSelectionChanged, this, &ObsListWizard::slotObjectCountDirty);
+    connect(olw->RegionList, &QListWidget::itemSelectionChanged, this, &ObsListWizard::slotObjectCountDirty);
     connect(olw->ConstellationList, &QListWidget::itemSelectionChanged, this, &ObsListWizard::slotObjectCountDirty);
     connect(olw->RAMin, &QLineEdit::editingFinished, this, &ObsListWizard::slotParseRegion);
     connect(olw->RAMax, &QLineEdit::editingFinished, this, &ObsListWizard::slotParseRegion);
@@ -118,54 +126,37 @@ void ObsListWizard::initialize()
     olw->RAMin->setUnits(dmsBox::HOURS);
     olw->RAMax->setUnits(dmsBox::HOURS);
 
-    //Initialize object counts
-    ObjectCount   = 0; //number of objects in observing list
-    StarCount     = data->skyComposite()->stars().size();     //total number of stars
-    PlanetCount   = 10;                                       //Sun, Moon, 8 planets
-    AsteroidCount = data->skyComposite()->asteroids().size(); //total number of asteroids
-    CometCount    = data->skyComposite()->comets().size();    //total number of comets
-    //DeepSkyObjects
-    OpenClusterCount = 0;
-    GlobClusterCount = 0;
-    GasNebCount      = 0;
-    PlanNebCount     = 0;
-    GalaxyCount      = 0;
-
-    CatalogsDB::DBManager manager{ CatalogsDB::dso_db_path() };
-
-    const auto &stats{ manager.get_master_statistics() };
-    if (!stats.first)
-        return;
+    //The objects to filter, but for the deep sky objects which are loaded when needed.
+    //Setting up the widgets may have started a count already.
+    m_CountWatcher.waitForFinished();
+    ObjectCount = 0; //number of objects in observing list
+    QList<SkyObject *> stars;
+    for (SkyObject *o : data->skyComposite()->stars())
+    {
+        // JM 2012-10-22: Skip unnamed stars
+        if (o->name() != "star")
+            stars.append(o);
+    }
+    m_Filter.addObjects(ObsListFilter::STARS, stars);
 
-    for (const auto &element : stats.second.object_counts)
+    QList<SkyObject *> planets;
+    for (const int planet : { KSPlanetBase::SUN, KSPlanetBase::MOON, KSPlanetBase::MERCURY, KSPlanetBase::VENUS,
+                              KSPlanetBase::MARS, KSPlanetBase::JUPITER, KSPlanetBase::SATURN, KSPlanetBase::URANUS,
+                              KSPlanetBase::NEPTUNE })
     {
-        auto cnt = element.second;
-        switch (element.first)
-        {
-            case SkyObject::GALAXY:
-                GalaxyCount += cnt;
-                break;
-            case SkyObject::STAR:
-            case SkyObject::CATALOG_STAR:
-                StarCount += cnt;
-                break;
-            case SkyObject::OPEN_CLUSTER:
-                OpenClusterCount += cnt;
-                break;
-            case SkyObject::GLOBULAR_CLUSTER:
-                GlobClusterCount += cnt;
-                break;
-            case SkyObject::GASEOUS_NEBULA:
-            case SkyObject::SUPERNOVA_REMNANT:
-                GasNebCount += cnt;
-                break;
-            case SkyObject::PLANETARY_NEBULA:
-                PlanNebCount += cnt;
-                break;
-            default:
-                break;
-        }
+        if (SkyObject *o = data->skyComposite()->planet(planet))
+            planets.append(o);
     }
+    m_Filter.addObjects(ObsListFilter::PLANETS, planets);
+    m_Filter.addObjects(ObsListFilter::COMETS, data->skyComposite()->comets());
+    m_Filter.addObjects(ObsListFilter::ASTEROIDS, data->skyComposite()->asteroids());
+}
+
+ObsListWizard::~ObsListWizard()
+{
+    // The threads use the filter
+    m_CountWatcher.waitForFinished();
+    m_DeepSkyWatcher.waitForFinished();
 }
 
 bool ObsListWizard::isItemSelected(const QString &name, QListWidget *listWidget, bool *ok)
@@ -407,610 +398,234 @@ void ObsListWizard::slotParseRegion()
 void ObsListWizard::slotObjectCountDirty()
 {
     olw->updateButton->setDisabled(false);
+    slotUpdateObjectCount();
 }
 
-void ObsListWizard::slotUpdateObjectCount()
+ObsListFilter::Criteria ObsListWizard::criteria()
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    ObjectCount = 0;
-    if (isItemSelected(i18n("Stars"), olw->TypeList))
-        ObjectCount += StarCount;
-    if (isItemSelected(i18n("Sun, moon, planets"), olw->TypeList))
-        ObjectCount += PlanetCount;
-    if (isItemSelected(i18n("Comets"), olw->TypeList))
-        ObjectCount += CometCount;
-    if (isItemSelected(i18n("Asteroids"), olw->TypeList))
-        ObjectCount += AsteroidCount;
-    if (isItemSelected(i18n("Galaxies"), olw->TypeList))
-        ObjectCount += GalaxyCount;
-    if (isItemSelected(i18n("Open clusters"), olw->TypeList))
-        ObjectCount += OpenClusterCount;
-    if (isItemSelected(i18n("Globular clusters"), olw->TypeList))
-        ObjectCount += GlobClusterCount;
-    if (isItemSelected(i18n("Gaseous nebulae"), olw->TypeList))
-        ObjectCount += GasNebCount;
-    if (isItemSelected(i18n("Planetary nebulae"), olw->TypeList))
-        ObjectCount += PlanNebCount;
-
-    applyFilters(false); //false = only adjust counts, do not build list
-    QApplication::restoreOverrideCursor();
-    olw->updateButton->setDisabled(true);
-}
-
-void ObsListWizard::applyFilters(bool doBuildList)
-{
-    bool filterPass  = true;
-    KStarsData *data = KStarsData::Instance();
-    if (doBuildList)
-        obsList().clear();
+    ObsListFilter::Criteria criteria;
 
-    //We don't need to call applyRegionFilter() if no region filter is selected, *and*
-    //we are just counting items (i.e., doBuildList is false)
-    bool needRegion = true;
-    if (!doBuildList && isItemSelected(i18n("all over the sky"), olw->RegionList))
-        needRegion = false;
-
-    double maglimit = 100.;
-    if (olw->SelectByMagnitude->isChecked())
-        maglimit = olw->Mag->value();
-
-    //Stars
-    if (isItemSelected(i18n("Stars"), olw->TypeList))
+    const QList<QPair<QString, ObsListFilter::Category>> types =
     {
-        const QList<SkyObject *> &starList = data->skyComposite()->stars();
-        int starIndex(starList.size());
-        if (maglimit < 100.)
-        {
-            //Stars are sorted by mag, so use binary search algo to find index of faintest mag
-            int low(0), high(starList.size() - 1), middle(high);
-            while (low < high)
-            {
-                middle = (low + high) / 2;
-                if (maglimit == starList.at(middle)->mag())
-                    break;
-                if (maglimit < starList.at(middle)->mag())
-                    high = middle - 1;
-                if (maglimit > starList.at(middle)->mag())
-                    low = middle + 1;
-            }
-            //now, the star at "middle" has the right mag, but we want the *last* star that has this mag.
-            for (starIndex = middle + 1; starIndex < starList.size(); ++starIndex)
-            {
-                if (starList.at(starIndex)->mag() > maglimit)
-                    break;
-            }
-        }
-
-        //DEBUG
-        qDebug() << Q_FUNC_INFO << QString("starIndex for mag %1: %2").arg(maglimit).arg(starIndex);
-
-        if (!doBuildList)
-        {
-            //reduce StarCount by appropriate amount
-            ObjectCount -= StarCount;
-            ObjectCount += starIndex;
-        }
-        for (int i = 0; i < starIndex; ++i)
-        {
-            SkyObject *o = (SkyObject *)(starList[i]);
-
-            // JM 2012-10-22: Skip unnamed stars
-            if (o->name() == "star")
-            {
-                if (!doBuildList)
-                    --ObjectCount;
-                continue;
-            }
-
-            if (needRegion)
-                filterPass = applyRegionFilter(o, doBuildList, !doBuildList);
-            //Filter objects visible from geo at Date if region filter passes
-            if (olw->SelectByDate->isChecked() && filterPass)
-                applyObservableFilter(o, doBuildList, !doBuildList);
-        }
+        { i18n("Stars"), ObsListFilter::STARS },
+        { i18n("Sun, moon, planets"), ObsListFilter::PLANETS },
+        { i18n("Comets"), ObsListFilter::COMETS },
+        { i18n("Asteroids"), ObsListFilter::ASTEROIDS },
+        { i18n("Galaxies"), ObsListFilter::GALAXIES },
+        { i18n("Open clusters"), ObsListFilter::OPEN_CLUSTERS },
+        { i18n("Globular clusters"), ObsListFilter::GLOBULAR_CLUSTERS },
+        { i18n("Gaseous nebulae"), ObsListFilter::GASEOUS_NEBULAE },
+        { i18n("Planetary nebulae"), ObsListFilter::PLANETARY_NEBULAE }
+    };
+    for (const auto &type : types)
+    {
+        if (isItemSelected(type.first, olw->TypeList))
+            criteria.categories |= 1u << type.second;
     }
 
-    //Sun, Moon, Planets
-    if (isItemSelected(i18n("Sun, moon, planets"), olw->TypeList))
+    if (isItemSelected(i18n("by constellation"), olw->RegionList))
     {
-        if (maglimit < data->skyComposite()->findByName(i18n("Sun"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Sun")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Sun")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Moon"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Moon")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Moon")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Mercury"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Mercury")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Mercury")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Venus"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Venus")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Venus")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Mars"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Mars")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Mars")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Jupiter"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Jupiter")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Jupiter")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Saturn"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Saturn")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Saturn")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Uranus"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Uranus")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Uranus")), doBuildList);
-
-        if (maglimit < data->skyComposite()->findByName(i18n("Neptune"))->mag())
-        {
-            if (!doBuildList)
-                --ObjectCount;
-            filterPass = false;
-        }
-        else
-            filterPass = true;
-
-        if (needRegion && filterPass)
-            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18n("Neptune")), doBuildList);
-        if (olw->SelectByDate->isChecked() && filterPass)
-            applyObservableFilter(data->skyComposite()->findByName(i18n("Neptune")), doBuildList);
-
-        //        if (maglimit < data->skyComposite()->findByName(i18nc("Asteroid name (optional)", "Pluto"))->mag())
-        //        {
-        //            if (!doBuildList)
-        //                --ObjectCount;
-        //            filterPass = false;
-        //        }
-        //        else
-        //            filterPass = true;
-
-        //        if (needRegion && filterPass)
-        //            filterPass = applyRegionFilter(data->skyComposite()->findByName(i18nc("Asteroid name (optional)", "Pluto")), doBuildList);
-        //        if (olw->SelectByDate->isChecked() && filterPass)
-        //            applyObservableFilter(data->skyComposite()->findByName(i18nc("Asteroid name (optional)", "Pluto")), doBuildList);
+        criteria.region = ObsListFilter::CONSTELLATIONS;
+        for (const QListWidgetItem *item : olw->ConstellationList->selectedItems())
+            criteria.constellations.insert(item->text());
     }
-
-    //Deep sky objects
-    bool dso =
-        (isItemSelected(i18n("Open clusters"), olw->TypeList) ||
-         isItemSelected(i18n("Globular clusters"), olw->TypeList) ||
-         isItemSelected(i18n("Gaseous nebulae"), olw->TypeList) ||
-         isItemSelected(i18n("Planetary nebulae"), olw->TypeList) || isItemSelected(i18n("Galaxies"), olw->TypeList));
-
-    if (dso)
+    else if (isItemSelected(i18n("in a rectangular region"), olw->RegionList))
     {
-        //Don't need to do anything if we are just counting objects and not
-        //filtering by region or magnitude
-        if (needRegion || olw->SelectByMagnitude->isChecked() || olw->SelectByDate->isChecked())
-        {
-
-            CatalogsDB::DBManager manager{ CatalogsDB::dso_db_path() };
-
-            for(auto& o : manager.get_objects(olw->SelectByMagnitude->isChecked() ? maglimit : 99))
-            {
-                //Skip unselected object types
-                bool typeSelected = false;
-                // if ( (o->type() == SkyObject::STAR || o->type() == SkyObject::CATALOG_STAR) &&
-                //       isItemSelected( i18n( "Stars" ), olw->TypeList ) )
-    //                         typeSelected = true;
-                switch (o.type())
-                {
-                    case SkyObject::OPEN_CLUSTER:
-                        if (isItemSelected(i18n("Open clusters"), olw->TypeList))
-                            typeSelected = true;
-                        break;
-
-                    case SkyObject::GLOBULAR_CLUSTER:
-                        if (isItemSelected(i18n("Globular clusters"), olw->TypeList))
-                            typeSelected = true;
-                        break;
-
-                    case SkyObject::GASEOUS_NEBULA:
-                    case SkyObject::SUPERNOVA_REMNANT:
-                        if (isItemSelected(i18n("Gaseous nebulae"), olw->TypeList))
-                            typeSelected = true;
-                        break;
-
-                    case SkyObject::PLANETARY_NEBULA:
-                        if (isItemSelected(i18n("Planetary nebulae"), olw->TypeList))
-                            typeSelected = true;
-                        break;
-                    case SkyObject::GALAXY:
-                        if (isItemSelected(i18n("Galaxies"), olw->TypeList))
-                            typeSelected = true;
-                        break;
-                }
-
-                if (!typeSelected)
-                    continue;
-
-                if (olw->SelectByMagnitude->isChecked())
-                {
-                    if (o.mag() > 90.)
-                    {
-                        if (olw->IncludeNoMag->isChecked())
-                        {
-                            auto *obj = &o;
-                            if(doBuildList)
-                                obj = &data->skyComposite()->catalogsComponent()
-                                           ->insertStaticObject(o);
-
-                            if (needRegion)
-                                filterPass = applyRegionFilter(obj, doBuildList);
-                            if (olw->SelectByDate->isChecked() && filterPass)
-                                applyObservableFilter(obj, doBuildList);
-                        }
-                        else if (!doBuildList)
-                            --ObjectCount;
-                    }
-                    else
-                    {
-                        if (o.mag() <= maglimit)
-                        {
-                            auto *obj = &o;
-                            if(doBuildList)
-                                obj = &data->skyComposite()->catalogsComponent()
-                                           ->insertStaticObject(o);
-
-                            if (needRegion)
-                                filterPass = applyRegionFilter(obj, doBuildList);
-                            if (olw->SelectByDate->isChecked() && filterPass)
-                                applyObservableFilter(obj, doBuildList);
-                        }
-                        else if (!doBuildList)
-                            --ObjectCount;
-                    }
-                }
-                else
-                {
-                    auto *obj = &o;
-                    if(doBuildList)
-                        obj = &data->skyComposite()->catalogsComponent()
-                                   ->insertStaticObject(o);
-
-                    if (needRegion)
-                        filterPass = applyRegionFilter(obj, doBuildList);
-                    if (olw->SelectByDate->isChecked() && filterPass)
-                        applyObservableFilter(obj, doBuildList);
-                }
-            }
-        }
+        criteria.region = ObsListFilter::RECTANGLE;
+        criteria.raMin  = xRect1;
+        criteria.raMax  = xRect2;
+        criteria.decMin = yRect1;
+        criteria.decMax = yRect2;
     }
-
-    //Comets
-    if (isItemSelected(i18n("Comets"), olw->TypeList))
+    else if (isItemSelected(i18n("in a circular region"), olw->RegionList))
     {
-        foreach (SkyObject *o, data->skyComposite()->comets())
-        {
-            if (olw->SelectByMagnitude->isChecked())
-            {
-                if (o->mag() > 90.)
-                {
-                    if (olw->IncludeNoMag->isChecked())
-                    {
-                        if (needRegion)
-                            filterPass = applyRegionFilter(o, doBuildList);
-                        if (olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter(o, doBuildList);
-                    }
-                    else if (!doBuildList)
-                        --ObjectCount;
-                }
-                else
-                {
-                    if (o->mag() <= maglimit)
-                    {
-                        if (needRegion)
-                            filterPass = applyRegionFilter(o, doBuildList);
-                        if (olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter(o, doBuildList);
-                    }
-                    else if (!doBuildList)
-                        --ObjectCount;
-                }
-            }
-            else
-            {
-                if (needRegion)
-                    filterPass = applyRegionFilter(o, doBuildList);
-                if (olw->SelectByDate->isChecked() && filterPass)
-                    applyObservableFilter(o, doBuildList);
-            }
-        }
+        criteria.region    = ObsListFilter::CIRCLE;
+        criteria.centerRA  = pCirc.ra().Degrees();
+        criteria.centerDec = pCirc.dec().Degrees();
+        criteria.radius    = rCirc;
     }
 
-    //Asteroids
-    if (isItemSelected(i18n("Asteroids"), olw->TypeList))
+    criteria.byMagnitude  = olw->SelectByMagnitude->isChecked();
+    criteria.maglim       = olw->Mag->value();
+    criteria.includeNoMag = olw->IncludeNoMag->isChecked();
+
+    criteria.byDate = olw->SelectByDate->isChecked();
+    if (criteria.byDate)
     {
-        foreach (SkyObject *o, data->skyComposite()->asteroids())
+        //Check altitude of object every hour from 18:00 to midnight
+        //If it's ever above 15 degrees, flag it as visible
+        KStarsDateTime Evening(olw->Date->date(), QTime(18, 0, 0), Qt::LocalTime);
+        KStarsDateTime Midnight(olw->Date->date().addDays(1), QTime(0, 0, 0), Qt::LocalTime);
+
+        // Or use user-selected values, if they're valid
+        if (olw->timeFrom->time().isValid() && olw->timeTo->time().isValid())
         {
-            if (olw->SelectByMagnitude->isChecked())
+            Evening.setTime(olw->timeFrom->time());
+            Midnight.setTime(olw->timeTo->time());
+
+            // If time from < timeTo (e.g. 06:00 PM to 9:00 PM)
+            // then we stay on the same day.
+            if (olw->timeFrom->time() < olw->timeTo->time())
             {
-                if (o->mag() > 90.)
-                {
-                    if (olw->IncludeNoMag->isChecked())
-                    {
-                        if (needRegion)
-                            filterPass = applyRegionFilter(o, doBuildList);
-                        if (olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter(o, doBuildList);
-                    }
-                    else if (!doBuildList)
-                        --ObjectCount;
-                }
-                else
-                {
-                    if (o->mag() <= maglimit)
-                    {
-                        if (needRegion)
-                            filterPass = applyRegionFilter(o, doBuildList);
-                        if (olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter(o, doBuildList);
-                    }
-                    else if (!doBuildList)
-                        --ObjectCount;
-                }
+                Midnight.setDate(olw->Date->date());
             }
+            // Otherwise we advance by one day
             else
             {
-                if (needRegion)
-                    filterPass = applyRegionFilter(o, doBuildList);
-                if (olw->SelectByDate->isChecked() && filterPass)
-                    applyObservableFilter(o, doBuildList);
+                Midnight.setDate(olw->Date->date().addDays(1));
             }
         }
-    }
 
-    //Update the object count label
-    if (doBuildList)
-        ObjectCount = obsList().size();
+        for (KStarsDateTime t = Evening; t < Midnight; t = t.addSecs(3600.0))
+            criteria.siderealTimes.append(geo->GSTtoLST(t.gst()).Degrees());
 
-    olw->CountLabel->setText(i18np("Your observing list currently has 1 object",
-                                   "Your observing list currently has %1 objects", ObjectCount));
+        criteria.latitude = geo->lat()->Degrees();
+        criteria.minAlt   = olw->minAlt->value();
+        criteria.maxAlt   = olw->maxAlt->value();
+
+        // This is the "relaxed" search mode
+        // where if the object obeys the restrictions in 50% of the time of the range
+        // then it qualifies as "visible"
+        criteria.coverage = olw->coverage->value();
+    }
+
+    return criteria;
 }
 
-bool ObsListWizard::applyRegionFilter(SkyObject *o, bool doBuildList, bool doAdjustCount)
+void ObsListWizard::loadDeepSky(const ObsListFilter::Criteria &criteria)
 {
-    //select by constellation
-    if (isItemSelected(i18n("by constellation"), olw->RegionList))
-    {
-        QString c = KStarsData::Instance()->skyComposite()->constellationBoundary()->constellationName(o);
+    const uint deepSky = (1u << ObsListFilter::OPEN_CLUSTERS) | (1u << ObsListFilter::GLOBULAR_CLUSTERS) |
+                         (1u << ObsListFilter::GASEOUS_NEBULAE) | (1u << ObsListFilter::PLANETARY_NEBULAE) |
+                         (1u << ObsListFilter::GALAXIES);
+    if (m_DeepSkyLoaded || m_DeepSkyLoading || !(criteria.categories & deepSky))
+        return;
 
-        if (isItemSelected(c, olw->ConstellationList))
+    m_DeepSkyLoading = true;
+    m_DeepSkyWatcher.setFuture(QtConcurrent::run([this]()
+    {
+        try
         {
-            if (doBuildList)
-                obsList().append(o);
-
-            return true;
+            CatalogsDB::DBManager manager{ CatalogsDB::dso_db_path() };
+            m_LoadedDeepSky = manager.get_objects(99);
         }
-        else if (doAdjustCount)
+        catch (const CatalogsDB::DatabaseError &error)
         {
-            --ObjectCount;
-            return false;
+            qWarning() << error.message();
         }
-        else
-            return false;
-    }
+    }));
+}
 
-    //select by rectangular region
-    else if (isItemSelected(i18n("in a rectangular region"), olw->RegionList))
-    {
-        double ra      = o->ra().Hours();
-        double dec     = o->dec().Degrees();
-        bool addObject = false;
-        if (dec >= yRect1 && dec <= yRect2)
-        {
-            if (xRect1 < 0.0)
-            {
-                addObject = ra >= xRect1 + 24.0 || ra <= xRect2;
-            }
-            else
-            {
-                addObject = ra >= xRect1 && ra <= xRect2;
-            }
-        }
+void ObsListWizard::slotDeepSkyLoaded()
+{
+    if (!m_DeepSkyLoading)
+        return;
 
-        if (addObject)
-        {
-            if (doBuildList)
-                obsList().append(o);
+    // A count started before the loading may still use the filter
+    m_CountWatcher.waitForFinished();
+    m_Filter.addDeepSkyObjects(std::move(m_LoadedDeepSky));
+    m_LoadedDeepSky.clear();
+    m_DeepSkyLoading = false;
+    m_DeepSkyLoaded  = true;
 
-            return true;
-        }
+    if (m_CountPending)
+        slotUpdateObjectCount();
+}
 
-        else
-        {
-            if (doAdjustCount)
-                --ObjectCount;
+void ObsListWizard::slotUpdateObjectCount()
+{
+    const ObsListFilter::Criteria criteria = this->criteria();
+    loadDeepSky(criteria);
 
-            return false;
-        }
+    // The filter is busy, count again when it is done
+    if (m_CountWatcher.isRunning() || m_DeepSkyLoading)
+    {
+        m_CountPending = true;
+        olw->CountLabel->setText(i18n("Counting objects..."));
+        return;
     }
+    m_CountPending = false;
 
-    //select by circular region
-    //make sure circ region data are valid
-    else if (isItemSelected(i18n("in a circular region"), olw->RegionList))
+    // Locating objects in constellations uses the sky mesh, which belongs to this thread
+    m_Filter.updateConstellations(criteria, [](const SkyPoint * p)
     {
-        if (o->angularDistanceTo(&pCirc).Degrees() < rCirc)
-        {
-            if (doBuildList)
-                obsList().append(o);
-
-            return true;
-        }
-        else if (doAdjustCount)
-        {
-            --ObjectCount;
-            return false;
-        }
-        else
-            return false;
-    }
+        return KStarsData::Instance()->skyComposite()->constellationBoundary()->constellationName(p);
+    });
+    m_CountWatcher.setFuture(QtConcurrent::run([this, criteria]()
+    {
+        return m_Filter.count(criteria);
+    }));
+    olw->updateButton->setDisabled(true);
+}
 
-    //No region filter, just add the object
-    else if (doBuildList)
+void ObsListWizard::slotCountFinished()
+{
+    if (m_CountPending)
     {
-        obsList().append(o);
+        slotUpdateObjectCount();
+        return;
     }
 
-    return true;
+    ObjectCount = m_CountWatcher.result();
+    olw->CountLabel->setText(i18np("Your observing list currently has 1 object",
+                                   "Your observing list currently has %1 objects", ObjectCount));
 }
 
-bool ObsListWizard::applyObservableFilter(SkyObject *o, bool doBuildList, bool doAdjustCount)
+void ObsListWizard::slotApplyFilters()
 {
-    SkyPoint p = *o;
+    KStarsData *data = KStarsData::Instance();
+    obsList().clear();
 
-    //Check altitude of object every hour from 18:00 to midnight
-    //If it's ever above 15 degrees, flag it as visible
-    KStarsDateTime Evening(olw->Date->date(), QTime(18, 0, 0), Qt::LocalTime);
-    KStarsDateTime Midnight(olw->Date->date().addDays(1), QTime(0, 0, 0), Qt::LocalTime);
-    double minAlt = 15, maxAlt = 90;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    // Wait for the deep sky objects and for the filter
+    const ObsListFilter::Criteria criteria = this->criteria();
+    m_CountPending = false;
+    loadDeepSky(criteria);
+    m_DeepSkyWatcher.waitForFinished();
+    slotDeepSkyLoaded();
+    m_CountWatcher.waitForFinished();
 
-    // Or use user-selected values, if they're valid
-    if (olw->timeFrom->time().isValid() && olw->timeTo->time().isValid())
+    m_Filter.updateConstellations(criteria, [](const SkyPoint * p)
     {
-        Evening.setTime(olw->timeFrom->time());
-        Midnight.setTime(olw->timeTo->time());
+        return KStarsData::Instance()->skyComposite()->constellationBoundary()->constellationName(p);
+    });
+    QVector<int> matches = m_Filter.matches(criteria);
 
-        // If time from < timeTo (e.g. 06:00 PM to 9:00 PM)
-        // then we stay on the same day.
-        if (olw->timeFrom->time() < olw->timeTo->time())
-        {
-            Midnight.setDate(olw->Date->date());
-        }
-        // Otherwise we advance by one day
-        else
+    // Stars, solar system bodies, deep sky objects, comets then asteroids
+    auto rank = [this](int index)
+    {
+        const ObsListFilter::Category category = m_Filter.category(index);
+        if (ObsListFilter::isDeepSky(category))
+            return 2;
+        switch (category)
         {
-            Midnight.setDate(olw->Date->date().addDays(1));
+            case ObsListFilter::STARS:
+                return 0;
+            case ObsListFilter::PLANETS:
+                return 1;
+            case ObsListFilter::COMETS:
+                return 3;
+            default:
+                return 4;
         }
-    }
-
-    minAlt = olw->minAlt->value();
-    maxAlt = olw->maxAlt->value();
-
-    // This is the "relaxed" search mode
-    // where if the object obeys the restrictions in 50% of the time of the range
-    // then it qualifies as "visible"
-    double totalCount = 0, visibleCount = 0;
-    for (KStarsDateTime t = Evening; t < Midnight; t = t.addSecs(3600.0))
+    };
+    std::stable_sort(matches.begin(), matches.end(), [&](int a, int b)
     {
-        dms LST = geo->GSTtoLST(t.gst());
-        p.EquatorialToHorizontal(&LST, geo->lat());
-        totalCount++;
-        if (p.alt().Degrees() >= minAlt && p.alt().Degrees() <= maxAlt)
-            visibleCount++;
-    }
-
-    // If the object is within the min/max alt at least coverage % of the time range
-    // then consider it visible
-    if (visibleCount / totalCount >= olw->coverage->value() / 100.0)
-        return true;
-
-    if (doAdjustCount)
-        --ObjectCount;
-    if (doBuildList)
-        obsList().takeAt(obsList().indexOf(o));
-
-    return false;
+        return rank(a) < rank(b);
+    });
 
-    // This is the strict mode where ANY object that does not meet the min & max
-    // altitude at ANY time would be removed from the list.
-#if 0
-    for (KStarsDateTime t = Evening; t < Midnight; t = t.addSecs(3600.0))
+    for (const int index : matches)
     {
-        dms LST = geo->GSTtoLST(t.gst());
-        p.EquatorialToHorizontal(&LST, geo->lat());
-        if (p.alt().Degrees() < minAlt || p.alt().Degrees() > maxAlt)
-        {
-            if (doAdjustCount)
-                --ObjectCount;
-            if (doBuildList)
-                obsList().takeAt(obsList().indexOf(o));
-            return false;
-        }
+        SkyObject *o = m_Filter.object(index);
+        // The deep sky objects must live in the catalogs component to be listed
+        if (ObsListFilter::isDeepSky(m_Filter.category(index)))
+            o = &data->skyComposite()->catalogsComponent()->insertStaticObject(*static_cast<CatalogObject *>(o));
+        obsList().append(o);
     }
-    return true;
-#endif
+    QApplication::restoreOverrideCursor();
 
+    //Update the object count label
+    ObjectCount = obsList().size();
+    olw->CountLabel->setText(i18np("Your observing list currently has 1 object",
+                                   "Your observing list currently has %1 objects", ObjectCount));
 }
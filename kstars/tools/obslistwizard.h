@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include "obslistfilter.h"
 #include "ui_obslistwizard.h"
 #include "skyobjects/skypoint.h"
 
 #include <QDialog>
+#include <QFutureWatcher>
 
 class QListWidget;
 class QPushButton;
@@ -29,6 +31,10 @@ class ObsListWizardUI : public QFrame, public Ui::ObsListWizard
  * @class ObsListWizard
  * @short Wizard for constructing observing lists
  *
+ * The objects are filtered by an ObsListFilter. The count of objects is updated in the
+ * background whenever a criterion changes, and the deep sky objects are loaded from the
+ * database the first time a deep sky type is selected.
+ *
  * @author Jason Harris
  */
 class ObsListWizard : public QDialog
@@ -36,7 +42,7 @@ class ObsListWizard : public QDialog
     Q_OBJECT
   public:
     explicit ObsListWizard(QWidget *parent);
-    virtual ~ObsListWizard() override = default;
+    virtual ~ObsListWizard() override;
 
     /** @return reference to QPtrList of objects selected by the wizard */
     QList<SkyObject *> &obsList() { return ObsList; }
@@ -57,15 +63,19 @@ class ObsListWizard : public QDialog
     /** @short Construct the observing list by applying the selected filters */
     void slotObjectCountDirty();
     void slotUpdateObjectCount();
-    void slotApplyFilters() { applyFilters(true); }
+    void slotApplyFilters();
+
+    void slotCountFinished();
+    void slotDeepSkyLoaded();
 
   private:
     void initialize();
-    void applyFilters(bool doBuildList);
 
-    /** @return true if the object passes the filter region constraints, false otherwise.*/
-    bool applyRegionFilter(SkyObject *o, bool doBuildList, bool doAdjustCount = true);
-    bool applyObservableFilter(SkyObject *o, bool doBuildList, bool doAdjustCount = true);
+    /** @return the criteria selected in the wizard */
+    ObsListFilter::Criteria criteria();
+
+    /** @short Start loading the deep sky objects if @p criteria need them */
+    void loadDeepSky(const ObsListFilter::Criteria &criteria);
 
     /**
      * Convenience function for safely getting the selected state of a QListWidget item by name.
@@ -89,15 +99,15 @@ class ObsListWizard : public QDialog
     QList<SkyObject *> ObsList;
     ObsListWizardUI *olw { nullptr };
     uint ObjectCount { 0 };
-    uint StarCount { 0 };
-    uint PlanetCount { 0 };
-    uint CometCount { 0 };
-    uint AsteroidCount { 0 };
-    uint GalaxyCount { 0 };
-    uint OpenClusterCount { 0 };
-    uint GlobClusterCount { 0 };
-    uint GasNebCount { 0 };
-    uint PlanNebCount { 0 };
+    ObsListFilter m_Filter;
+    QFutureWatcher<int> m_CountWatcher;
+    QFutureWatcher<void> m_DeepSkyWatcher;
+    /** Deep sky objects read in the background, until they are given to the filter */
+    CatalogsDB::CatalogObjectList m_LoadedDeepSky;
+    bool m_DeepSkyLoading { false };
+    bool m_DeepSkyLoaded { false };
+    /** The criteria changed while counting or loading */
+    bool m_CountPending { false };
     double xRect1 { 0 };
     double xRect2 { 0 };
     double yRect1 { 0 };
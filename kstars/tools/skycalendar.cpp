@@ -7,6 +7,7 @@
 #include "skycalendar.h"
 
 #include "geolocation.h"
+#include "ksephemeris.h"
 #include "ksplanetbase.h"
 #include "kstarsdata.h"
 #include "dialogs/locationdialog.h"
@@ -20,7 +21,6 @@
 #include <QPrinter>
 #include <QPushButton>
 #include <QScreen>
-#include <QtConcurrent>
 
 SkyCalendarUI::SkyCalendarUI(QWidget *parent) : QFrame(parent)
 {
@@ -90,20 +90,22 @@ void SkyCalendar::slotFillCalendar()
     scUI->CalendarView->resetPlot();
     scUI->CalendarView->setHorizon();
 
+    // The positions are interpolated from ephemeris tables computed in parallel, so the
+    // events of the whole year take little time and the plot is filled from this thread
     if (scUI->checkBox_Mercury->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::MERCURY);
+        addPlanetEvents(KSPlanetBase::MERCURY);
     if (scUI->checkBox_Venus->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::VENUS);
+        addPlanetEvents(KSPlanetBase::VENUS);
     if (scUI->checkBox_Mars->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::MARS);
+        addPlanetEvents(KSPlanetBase::MARS);
     if (scUI->checkBox_Jupiter->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::JUPITER);
+        addPlanetEvents(KSPlanetBase::JUPITER);
     if (scUI->checkBox_Saturn->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::SATURN);
+        addPlanetEvents(KSPlanetBase::SATURN);
     if (scUI->checkBox_Uranus->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::URANUS);
+        addPlanetEvents(KSPlanetBase::URANUS);
     if (scUI->checkBox_Neptune->isChecked())
-        QtConcurrent::run(this, &SkyCalendar::addPlanetEvents, KSPlanetBase::NEPTUNE);
+        addPlanetEvents(KSPlanetBase::NEPTUNE);
 
     scUI->CreateButton->setText(i18n("Plot Planetary Almanac"));
     scUI->CreateButton->setEnabled(true);
@@ -164,6 +166,12 @@ void SkyCalendar::addPlanetEvents(int nPlanet)
     //QVector<QPointF> vRise, vSet, vTransit;
     std::vector<QPointF> vRise, vSet, vTransit;
 
+    // The events of a day may be computed from positions up to a day and a half away
+    const long double startJD = KStarsDateTime(QDate(year(), 1, 1), QTime(0, 0, 0)).djd() - 2;
+    const long double stopJD  = KStarsDateTime(QDate(year() + 1, 1, 1), QTime(0, 0, 0)).djd() + 2;
+    const KSEphemeris::TablePtr table = KSEphemeris::Instance()->table(nPlanet, geo, startJD, stopJD);
+    const SkyObject::PositionFunction position = table->positions();
+
     for (KStarsDateTime kdt(QDate(year(), 1, 1), QTime(12, 0, 0)); kdt.date().year() == year();
             kdt = kdt.addDays(scUI->spinBox_Interval->value()))
     {
@@ -171,9 +179,9 @@ void SkyCalendar::addPlanetEvents(int nPlanet)
 
         //Compute rise/set/transit times.  If they occur before noon,
         //recompute for the following day
-        QTime tmp_rTime = ksp->riseSetTime(kdt, geo, true, true);  //rise time, exact
-        QTime tmp_sTime = ksp->riseSetTime(kdt, geo, false, true); //set time, exact
-        QTime tmp_tTime = ksp->transitTime(kdt, geo);
+        QTime tmp_rTime = ksp->riseSetTime(kdt, geo, true, true, position);  //rise time, exact
+        QTime tmp_sTime = ksp->riseSetTime(kdt, geo, false, true, position); //set time, exact
+        QTime tmp_tTime = ksp->transitTime(kdt, geo, position);
         QTime midday(12, 0, 0);
 
         // NOTE: riseSetTime should be fix now, this test is no longer necessary
@@ -200,7 +208,7 @@ void SkyCalendar::addPlanetEvents(int nPlanet)
         }
         else
         {
-            if (ksp->transitAltitude(kdt, geo).degree() > 0)
+            if (ksp->transitAltitude(kdt, geo, position).degree() > 0)
             {
                 rTime = -24.0;
                 sTime = 24.0;
@@ -13,6 +13,30 @@
 
 #include <kstars_debug.h>
 
+#include <QSet>
+
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace
+{
+// Half width of the corridor of stars considered, in fields of view plus a fraction of the hop
+constexpr double corridorFovs     = 2.0;
+constexpr double corridorFraction = 0.1;
+
+void direction(const SkyPoint *p, double *x, double *y, double *z)
+{
+    double sinRa, cosRa, sinDec, cosDec;
+    p->ra().SinCos(sinRa, cosRa);
+    p->dec().SinCos(sinDec, cosDec);
+    *x = cosDec * cosRa;
+    *y = cosDec * sinRa;
+    *z = sinDec;
+}
+}  // namespace
+
 QList<StarObject *> *StarHopper::computePath(const SkyPoint &src, const SkyPoint &dest, float fov__, float maglim__,
                                              QStringList *metadata_)
 {
@@ -33,51 +57,38 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
     start  = &src;
     end    = &dest;
 
-    came_from.clear();
     result_path.clear();
-
-    // Implements the A* search algorithm
-
-    QList<SkyPoint const *> cSet;
-    QList<SkyPoint const *> oSet;
-    QHash<SkyPoint const *, double> g_score;
-    QHash<SkyPoint const *, double> f_score;
-    QHash<SkyPoint const *, double> h_score;
+    patternNames.clear();
 
     qCDebug(KSTARS) << "StarHopper is trying to compute a path from source: " << src.ra().toHMSString()
              << src.dec().toDMSString() << " to destination: " << dest.ra().toHMSString() << dest.dec().toDMSString()
              << "; a starhop of " << src.angularDistanceTo(&dest).Degrees() << " degrees!";
 
-    oSet.append(&src);
-    g_score[&src] = 0;
-    h_score[&src] = src.angularDistanceTo(&dest).Degrees() / fov;
-    f_score[&src] = h_score[&src];
+    buildGraph(src, dest);
+    qCDebug(KSTARS) << "Considering" << m_Nodes.size() - 1 << "stars in the corridor";
+
+    // Implements the A* search algorithm, the open set is a heap of f-scores, the lowest first.
+    // Nodes whose score improved are pushed again, the outdated entries are skipped.
+    typedef QPair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> oSet;
 
-    while (!oSet.isEmpty())
+    m_Nodes[0].open = true;
+    oSet.push(Entry(m_Nodes[0].h, 0));
+
+    while (!oSet.empty())
     {
-        qCDebug(KSTARS) << "Next step";
-        // Find the node with the lowest f_score value
-        SkyPoint const *curr_node = nullptr;
-        double lowfscore          = 1.0e8;
+        const Entry entry = oSet.top();
+        oSet.pop();
 
-        foreach (const SkyPoint *sp, oSet)
-        {
-            if (f_score[sp] < lowfscore)
-            {
-                lowfscore = f_score[sp];
-                curr_node = sp;
-            }
-        }
-        if (curr_node == nullptr)
+        const int curr_node = entry.second;
+        Node &curr          = m_Nodes[curr_node];
+        if (curr.closed || entry.first > curr.g + curr.h)
             continue;
 
-        qCDebug(KSTARS) << "Lowest fscore (vertex distance-plus-cost score) is " << lowfscore
-                 << " with coords: " << curr_node->ra().toHMSString() << curr_node->dec().toDMSString()
-                 << ". Considering this node now.";
-        if (curr_node == &dest || (curr_node != &src && h_score[curr_node] < 0.5))
+        if (curr_node != 0 && curr.h < 0.5)
         {
             // We are at destination
-            reconstructPath(came_from[curr_node]);
+            reconstructPath(curr.cameFrom);
             qCDebug(KSTARS) << "We've arrived at the destination! Yay! Result path count: " << result_path.count();
 
             // Just a test -- try to print out useful instructions to the debug console. Once we make star hopper unexperimental, we should move this to some sort of a display
@@ -121,60 +132,39 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
             return result_path;
         }
 
-        oSet.removeOne(curr_node);
-        cSet.append(curr_node);
+        curr.closed = true;
 
         // FIXME: Make sense. If current node ---> dest distance is
         // larger than src --> dest distance by more than 20%, don't
         // even bother considering it.
-
-        if (h_score[curr_node] > h_score[&src] * 1.2)
-        {
-            qCDebug(KSTARS) << "Node under consideration has larger distance to destination (h-score) than start node! "
-                        "Ignoring it.";
+        if (curr.h > m_Nodes[0].h * 1.2)
             continue;
-        }
 
-        // Get the list of stars that are neighbours of this node
-        QList<StarObject *> neighbors;
-
-        // FIXME: Actually, this should be done in
-        // HorizontalToEquatorial, but we do it here because SkyPoint
-        // needs a lot of fixing to handle unprecessed and precessed,
-        // equatorial and horizontal coordinates nicely
-        SkyPoint *CurrentNode = const_cast<SkyPoint *>(curr_node);
-        //CurrentNode->deprecess(KStarsData::Instance()->updateNum());
-        CurrentNode->catalogueCoord(KStarsData::Instance()->updateNum()->julianDay());
-        //qCDebug(KSTARS) << "Calling starsInAperture";
-        StarComponent::Instance()->starsInAperture(neighbors, *curr_node, fov, maglim);
-        qCDebug(KSTARS) << "Choosing next node from a set of " << neighbors.count();
-        // Look for the potential next node
-        double curr_g_score = g_score[curr_node];
-
-        for (auto &nhd_node : neighbors)
+        scan(curr_node);
+        const double curr_g_score = curr.g;
+
+        for (const auto &neighbor : curr.neighbors)
         {
-            if (cSet.contains(nhd_node))
+            Node &nhd = m_Nodes[neighbor.first];
+            if (nhd.closed)
                 continue;
 
-            // Compute the tentative g_score
-            double tentative_g_score = curr_g_score + cost(curr_node, nhd_node);
-            bool tentative_better;
-            if (!oSet.contains(nhd_node))
-            {
-                oSet.append(nhd_node);
-                tentative_better = true;
-            }
-            else if (tentative_g_score < g_score[nhd_node])
-                tentative_better = true;
-            else
-                tentative_better = false;
+            // The cost of the star is computed along with its neighbours
+            scan(neighbor.first);
+
+            // Test 4: How far is the hop? 1 "magnitude" incremental cost for 1 FOV.
+            double netcost = nhd.cost + neighbor.second / fov;
+            if (netcost < 0)
+                netcost = 0.1; // FIXME: Heuristics aren't supposed to be entirely random. This one is.
 
-            if (tentative_better)
+            // Compute the tentative g_score
+            const double tentative_g_score = curr_g_score + netcost;
+            if (!nhd.open || tentative_g_score < nhd.g)
             {
-                came_from[nhd_node] = curr_node;
-                g_score[nhd_node]   = tentative_g_score;
-                h_score[nhd_node]   = nhd_node->angularDistanceTo(&dest).Degrees() / fov;
-                f_score[nhd_node]   = g_score[nhd_node] + h_score[nhd_node];
+                nhd.open     = true;
+                nhd.cameFrom = curr_node;
+                nhd.g        = tentative_g_score;
+                oSet.push(Entry(nhd.g + nhd.h, neighbor.first));
             }
         }
     }
@@ -182,83 +172,159 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
     return QList<StarObject const *>(); // Return an empty QList
 }
 
-void StarHopper::reconstructPath(SkyPoint const *curr_node)
+void StarHopper::buildGraph(const SkyPoint &src, const SkyPoint &dest)
 {
-    if (curr_node != start)
+    m_Nodes.clear();
+    m_Grid.clear();
+    m_CellSize = 2 * std::sin(fov * dms::DegToRad / 2);
+    m_CosFov   = std::cos(fov * dms::DegToRad);
+
+    // The stars of the corridor, and the fainter ones that count for the density around them
+    const double distance = src.angularDistanceTo(&dest).Degrees();
+    const double radius   = corridorFovs * fov + corridorFraction * distance;
+    const int steps       = std::max(1, int(std::ceil(distance / radius)));
+
+    double sx, sy, sz, dx, dy, dz;
+    direction(&src, &sx, &sy, &sz);
+    direction(&dest, &dx, &dy, &dz);
+
+    QList<StarObject *> stars;
+    QSet<const StarObject *> seen;
+    const long double jd = KStarsData::Instance()->updateNum()->julianDay();
+    for (int i = 0; i <= steps; ++i)
+    {
+        // Apertures along the great circle from the source to the destination
+        const double t = double(i) / steps;
+        const double x = sx + t * (dx - sx), y = sy + t * (dy - sy), z = sz + t * (dz - sz);
+        if (std::hypot(std::hypot(x, y), z) < 1e-6)
+            continue;
+
+        dms ra, dec;
+        ra.setRadians(std::atan2(y, x));
+        dec.setRadians(std::atan2(z, std::hypot(x, y)));
+        SkyPoint center(ra.reduce(), dec);
+        center.catalogueCoord(jd);
+
+        QList<StarObject *> found;
+        StarComponent::Instance()->starsInAperture(found, center, radius, maglim + 1.0);
+        for (StarObject *star : found)
+        {
+            if (star->mag() <= maglim + 1.0 && !seen.contains(star))
+            {
+                seen.insert(star);
+                stars.append(star);
+            }
+        }
+    }
+
+    m_Nodes.resize(stars.size() + 1);
+    m_Nodes[0].point = &src;
+    for (int i = 0; i < stars.size(); ++i)
+    {
+        Node &node = m_Nodes[i + 1];
+        node.point = stars[i];
+        node.star  = stars[i];
+        node.mag   = stars[i]->mag();
+    }
+
+    for (int i = 0; i < m_Nodes.size(); ++i)
     {
-        StarObject const *s = dynamic_cast<StarObject const *>(curr_node);
-        Q_ASSERT(s);
-        result_path.prepend(s);
-        reconstructPath(came_from[s]);
+        Node &node = m_Nodes[i];
+        direction(node.point, &node.x, &node.y, &node.z);
+        node.h = node.point->angularDistanceTo(&dest).Degrees() / fov;
+        if (i > 0)
+            m_Grid[cellKey(int(std::floor(node.x / m_CellSize)), int(std::floor(node.y / m_CellSize)),
+                           int(std::floor(node.z / m_CellSize)))].append(i);
     }
 }
 
-float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
+void StarHopper::scan(int index)
 {
-    // This is a very heuristic method, that tries to produce a cost
-    // for each hop.
-
-    float netcost = 0;
+    Node &node = m_Nodes[index];
+    if (node.scanned)
+        return;
+    node.scanned = true;
+
+    // The stars within a field of view lie in the cells around the one of the node
+    QVector<QPair<int, float>> nearby;
+    const int ci = int(std::floor(node.x / m_CellSize));
+    const int cj = int(std::floor(node.y / m_CellSize));
+    const int ck = int(std::floor(node.z / m_CellSize));
+    for (int i = ci - 1; i <= ci + 1; ++i)
+    {
+        for (int j = cj - 1; j <= cj + 1; ++j)
+        {
+            for (int k = ck - 1; k <= ck + 1; ++k)
+            {
+                auto cell = m_Grid.constFind(cellKey(i, j, k));
+                if (cell == m_Grid.constEnd())
+                    continue;
+                for (const int other : *cell)
+                {
+                    const Node &star  = m_Nodes[other];
+                    const double cosd = node.x * star.x + node.y * star.y + node.z * star.z;
+                    if (other == index || cosd < m_CosFov)
+                        continue;
+                    nearby.append(qMakePair(other, float(std::acos(std::min(1.0, cosd)) / dms::DegToRad)));
+                }
+            }
+        }
+    }
 
-    // Convert 'next' into a StarObject
-    if (next == start)
+    for (const auto &star : nearby)
     {
-        // If the next hop is back to square one, junk it
-        return 1e8;
+        if (m_Nodes[star.first].mag <= maglim)
+            node.neighbors.append(star);
     }
-    bool isThisTheEnd = (next == end);
 
-    float magcost, speccost;
-    magcost = speccost = 0;
+    if (node.star)
+        node.cost = cost(node, nearby);
+}
+
+quint64 StarHopper::cellKey(int i, int j, int k)
+{
+    const quint64 offset = 1 << 20;
+    return ((i + offset) << 42) | ((j + offset) << 21) | (k + offset);
+}
 
-    if (!isThisTheEnd)
+void StarHopper::reconstructPath(int node)
+{
+    while (node > 0)
     {
-        // We ought to be dealing with a star
-        StarObject const *nextstar = dynamic_cast<StarObject const *>(next);
-        Q_ASSERT(nextstar);
-
-        // Test 1: How bright is the star?
-        magcost =
-            nextstar->mag() - 7.0 +
-            5 * log10(
-                    fov); // The brighter, the better. FIXME: 8.0 is now an arbitrary reference to the average faint star. Should actually depend on FOV, something like log( FOV ).
-
-        // Test 2: Is the star strikingly red / yellow coloured?
-        QString SpType = nextstar->sptype();
-        char spclass   = SpType.at(0).toLatin1();
-        speccost       = (spclass == 'G' || spclass == 'K' || spclass == 'M') ? -0.3 : 0;
-        /*
-        // Test 3: Is the star in the general direction of the object?
-        // We use the cosine rule to find the angle between the hop direction, and the direction to destination
-        // a = side joining curr to end
-        // b = side joining curr to next
-        // c = side joining next to end
-        // C = angle between curr-next and curr-end
-        double sina, sinb, cosa, cosb;
-        curr->angularDistanceTo(dest).SinCos( &sina, &cosa );
-        curr->angularDistanceTo(next).SinCos( &sinb, &cosb );
-        double cosc = cos(next->angularDistanceTo(end).radians());
-        double cosC = ( cosc - cosa * cosb ) / (sina * sinb);
-        float dircost;
-        if( cosC < 0 ) // Wrong direction!
-        dircost = 1e8; // Some humongous number;
-        else
-        dircost = sqrt( 1 - cosC * cosC ) / cosC; // tan( C )
-        */
+        result_path.prepend(m_Nodes[node].star);
+        node = m_Nodes[node].cameFrom;
     }
+}
+
+float StarHopper::cost(const Node &node, const QVector<QPair<int, float>> &nearby)
+{
+    // This is a very heuristic method, that tries to produce a cost
+    // for each hop.
+
+    StarObject const *nextstar = node.star;
+    Q_ASSERT(nextstar);
+
+    // Test 1: How bright is the star?
+    float magcost =
+        nextstar->mag() - 7.0 +
+        5 * log10(
+                fov); // The brighter, the better. FIXME: 8.0 is now an arbitrary reference to the average faint star. Should actually depend on FOV, something like log( FOV ).
 
-    // Test 4: How far is the hop?
-    double distcost =
-        (curr->angularDistanceTo(next).Degrees() /
-         fov); // 1 "magnitude" incremental cost for 1 FOV. Is this even required, or is it just equivalent to halving our distance unit? I think it is required since the hop is not necessarily in the direction of the object -- asimha
+    // Test 2: Is the star strikingly red / yellow coloured?
+    QString SpType = nextstar->sptype();
+    char spclass   = SpType.isEmpty() ? 0 : SpType.at(0).toLatin1();
+    float speccost = (spclass == 'G' || spclass == 'K' || spclass == 'M') ? -0.3 : 0;
 
-    // Test 5: How effective is the hop? [Might not be required with A*]
-    //    double distredcost = -((src->angularDistanceTo( dest ).Degrees() - next->angularDistanceTo( dest ).Degrees()) * 60 / fov)*3; // 3 "magnitudes" for 1 FOV closer
+    // Test 4, the length of the hop, depends on the previous node and is added by the caller
 
     // Test 6: Is the destination an asterism? Are there bright stars clustered nearby?
-    QList<StarObject *> localNeighbors;
-    StarComponent::Instance()->starsInAperture(localNeighbors, *next, fov / 10, maglim + 1.0);
-    double stardensitycost = 1 - localNeighbors.count(); // -1 "magnitude" for every neighbouring star
+    int localCount = 1; // The star itself
+    for (const auto &star : nearby)
+    {
+        if (star.second <= fov / 10 && m_Nodes[star.first].mag <= maglim + 1.0)
+            localCount++;
+    }
+    double stardensitycost = 1 - localCount; // -1 "magnitude" for every neighbouring star
 
 // Test 7: Identify star patterns
 
@@ -267,86 +333,72 @@ float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
 
     double patterncost = 0;
     QString patternName;
-    if (!isThisTheEnd)
-    {
-        // We ought to be dealing with a star
-        StarObject const *nextstar = dynamic_cast<StarObject const *>(next);
-        Q_ASSERT(nextstar);
 
-        float factor = 1.0;
-        while (factor <= 10.0)
+    // Use a larger aperture for pattern identification; max 1.0 mag difference
+    QList<const StarObject *> localNeighbors;
+    float factor = 1.0;
+    for (; factor <= 10.0; factor += 1.0)
+    {
+        localNeighbors.clear();
+        for (const auto &star : nearby)
         {
-            localNeighbors.clear();
-            StarComponent::Instance()->starsInAperture(
-                localNeighbors, *next, fov / factor,
-                nextstar->mag() + 1.0); // Use a larger aperture for pattern identification; max 1.0 mag difference
-            foreach (StarObject *star, localNeighbors)
-            {
-                if (star == nextstar)
-                    localNeighbors.removeOne(star);
-                else if (fabs(star->mag() - nextstar->mag()) > 1.0)
-                    localNeighbors.removeOne(star);
-            } // Now, we should have a pruned list
-            factor += 1.0;
-            if (localNeighbors.size() == 2)
-                break;
+            if (star.second <= fov / factor && fabs(m_Nodes[star.first].mag - nextstar->mag()) <= 1.0)
+                localNeighbors.append(m_Nodes[star.first].star);
         }
-        factor -= 1.0;
         if (localNeighbors.size() == 2)
+            break;
+    }
+    if (localNeighbors.size() == 2)
+    {
+        patternName = i18n("triangle (of similar magnitudes)"); // any three stars form a triangle!
+        // Try to find triangles. Note that we assume that the standard Euclidian metric works on a sphere for small angles, i.e. the celestial sphere is nearly flat over our FOV.
+        StarObject const *star1 = localNeighbors[0];
+        double dRA1       = nextstar->ra().radians() - star1->ra().radians();
+        double dDec1      = nextstar->dec().radians() - star1->dec().radians();
+        double dist1sqr   = dRA1 * dRA1 + dDec1 * dDec1;
+
+        StarObject const *star2 = localNeighbors[1];
+        double dRA2       = nextstar->ra().radians() - star2->ra().radians();
+        double dDec2      = nextstar->dec().radians() - star2->dec().radians();
+        double dist2sqr   = dRA2 * dRA2 + dDec2 * dDec2;
+
+        // Check for right-angled triangles (without loss of generality, right angle is at this vertex)
+        if (fabs((dRA1 * dRA2 - dDec1 * dDec2) / sqrt(dist1sqr * dist2sqr)) < RIGHT_ANGLE_THRESHOLD)
+        {
+            // We have a right angled triangle! Give -3 magnitudes!
+            patterncost += -3;
+            patternName = i18n("right-angled triangle");
+        }
+
+        // Check for isosceles triangles (without loss of generality, this is the vertex)
+        if (fabs((dist1sqr - dist2sqr) / (dist1sqr)) < EQUAL_EDGE_THRESHOLD)
         {
-            patternName = i18n("triangle (of similar magnitudes)"); // any three stars form a triangle!
-            // Try to find triangles. Note that we assume that the standard Euclidian metric works on a sphere for small angles, i.e. the celestial sphere is nearly flat over our FOV.
-            StarObject *star1 = localNeighbors[0];
-            double dRA1       = nextstar->ra().radians() - star1->ra().radians();
-            double dDec1      = nextstar->dec().radians() - star1->dec().radians();
-            double dist1sqr   = dRA1 * dRA1 + dDec1 * dDec1;
-
-            StarObject *star2 = localNeighbors[1];
-            double dRA2       = nextstar->ra().radians() - star2->ra().radians();
-            double dDec2      = nextstar->dec().radians() - star2->dec().radians();
-            double dist2sqr   = dRA2 * dRA2 + dDec2 * dDec2;
-
-            // Check for right-angled triangles (without loss of generality, right angle is at this vertex)
-            if (fabs((dRA1 * dRA2 - dDec1 * dDec2) / sqrt(dist1sqr * dist2sqr)) < RIGHT_ANGLE_THRESHOLD)
+            patterncost += -1;
+            patternName = i18n("isosceles triangle");
+            if (fabs((dRA2 * dDec1 - dRA1 * dDec2) / sqrt(dist1sqr * dist2sqr)) < RIGHT_ANGLE_THRESHOLD)
             {
-                // We have a right angled triangle! Give -3 magnitudes!
-                patterncost += -3;
-                patternName = i18n("right-angled triangle");
+                patterncost += -1;
+                patternName = i18n("straight line of 3 stars");
             }
-
-            // Check for isosceles triangles (without loss of generality, this is the vertex)
-            if (fabs((dist1sqr - dist2sqr) / (dist1sqr)) < EQUAL_EDGE_THRESHOLD)
+            // Check for equilateral triangles
+            double dist3    = star1->angularDistanceTo(star2).radians();
+            double dist3sqr = dist3 * dist3;
+            if (fabs((dist3sqr - dist1sqr) / dist1sqr) < EQUAL_EDGE_THRESHOLD)
             {
                 patterncost += -1;
-                patternName = i18n("isosceles triangle");
-                if (fabs((dRA2 * dDec1 - dRA1 * dDec2) / sqrt(dist1sqr * dist2sqr)) < RIGHT_ANGLE_THRESHOLD)
-                {
-                    patterncost += -1;
-                    patternName = i18n("straight line of 3 stars");
-                }
-                // Check for equilateral triangles
-                double dist3    = star1->angularDistanceTo(star2).radians();
-                double dist3sqr = dist3 * dist3;
-                if (fabs((dist3sqr - dist1sqr) / dist1sqr) < EQUAL_EDGE_THRESHOLD)
-                {
-                    patterncost += -1;
-                    patternName = i18n("equilateral triangle");
-                }
+                patternName = i18n("equilateral triangle");
             }
         }
-        // TODO: Identify squares.
-        if (!patternName.isEmpty())
-        {
-            patternName += i18n(" within %1% of FOV of the marked star", (int)(100.0 / factor));
-            patternNames.insert(nextstar, patternName);
-        }
+    }
+    // TODO: Identify squares.
+    if (!patternName.isEmpty())
+    {
+        patternName += i18n(" within %1% of FOV of the marked star", (int)(100.0 / factor));
+        patternNames.insert(nextstar, patternName);
     }
 
-    netcost = magcost + speccost + distcost + stardensitycost + patterncost;
-    if (netcost < 0)
-        netcost = 0.1; // FIXME: Heuristics aren't supposed to be entirely random. This one is.
-    qCDebug(KSTARS) << "Mag cost: " << magcost << "; Spec Cost: " << speccost << "; Dist Cost: " << distcost
-             << "; Density cost: " << stardensitycost << "; Pattern cost: " << patterncost << "; Net cost: " << netcost
-             << "; Pattern: " << patternName;
+    float netcost = magcost + speccost + stardensitycost + patterncost;
+    qCDebug(KSTARS) << "Mag cost: " << magcost << "; Spec Cost: " << speccost << "; Density cost: " << stardensitycost
+             << "; Pattern cost: " << patterncost << "; Net cost but distance: " << netcost << "; Pattern: " << patternName;
     return netcost;
 }
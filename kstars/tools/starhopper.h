@@ -8,6 +8,8 @@
 
 #include <QHash>
 #include <QList>
+#include <QPair>
+#include <QVector>
 
 class QStringList;
 
@@ -18,6 +20,12 @@ class StarObject;
  * @class StarHopper
  * @short Helps planning star hopping
  *
+ * The path is found with the A* search algorithm over the stars of a corridor around the
+ * great circle from the source to the destination. The stars of the corridor are gathered
+ * once from the trixel index, and kept in a grid of cells one field of view wide, from which
+ * the neighbours of each star and the stars around it are found. The open set is a binary
+ * heap. The search time is thus bounded by the number of stars in the corridor.
+ *
  * @version 1.0
  * @author Akarsh Simha
  */
@@ -43,21 +51,50 @@ class StarHopper
                                                 QStringList *metadata = nullptr);
 
   private:
+    /** A node of the search, the source or a star of the corridor */
+    struct Node
+    {
+        const SkyPoint *point { nullptr };
+        /** Null for the source */
+        const StarObject *star { nullptr };
+        float mag { 0 };
+        /** Direction of the node */
+        double x { 0 }, y { 0 }, z { 0 };
+        /** Distance to the destination, in fields of view */
+        double h { 0 };
+        /** Cost of the path from the source */
+        double g { 0 };
+        int cameFrom { -1 };
+        bool open { false };
+        bool closed { false };
+        bool scanned { false };
+        /** Cost of hopping to this star, the length of the hop excepted */
+        float cost { 0 };
+        /** Stars within a field of view that may be hopped to, with their distance in degrees */
+        QVector<QPair<int, float>> neighbors;
+    };
+
+    /** @short Gathers the stars of the corridor from @p src to @p dest and indexes them */
+    void buildGraph(const SkyPoint &src, const SkyPoint &dest);
+
+    /** @short Finds the neighbours and the cost of a node, once */
+    void scan(int node);
+
     /**
-     * @short The cost function for hopping from current position to the a given star, in view of the final destination
-     * @param curr Source SkyPoint
-     * @param next Next point in the hop.
-     * @note If 'next' is neither the starting point of the hop, nor
-     * the ending point, it _has_ to be a StarObject. A dynamic cast
-     * followed by a Q_ASSERT will ensure this.
+     * @short The cost function for hopping to a given star, but for the length of the hop
+     * @param node the star
+     * @param nearby the stars within a field of view of it, with their distance in degrees
      */
-    float cost(const SkyPoint *curr, const SkyPoint *next);
+    float cost(const Node &node, const QVector<QPair<int, float>> &nearby);
 
     /**
      * @short For internal use by the A* Search Algorithm. Completes
      * the star-hop path. See https://en.wikipedia.org/wiki/A*_search_algorithm for details
      */
-    void reconstructPath(SkyPoint const *curr_node);
+    void reconstructPath(int node);
+
+    /** @return the key of a cell of the grid */
+    static quint64 cellKey(int i, int j, int k);
 
     float fov { 0 };
     float maglim { 0 };
@@ -65,7 +102,12 @@ class StarHopper
     // Useful for internal computations
     SkyPoint const *start { nullptr };
     SkyPoint const *end { nullptr };
-    QHash<const SkyPoint *, const SkyPoint *> came_from; // Used by the A* search algorithm
     QList<StarObject const *> result_path;
     QHash<SkyPoint const *, QString> patternNames; // if patterns were identified, they are added to this hash.
+    /** The source, then the stars of the corridor */
+    QVector<Node> m_Nodes;
+    /** Stars of the corridor by cell */
+    QHash<quint64, QVector<int>> m_Grid;
+    double m_CellSize { 1 };
+    double m_CosFov { 1 };
 };
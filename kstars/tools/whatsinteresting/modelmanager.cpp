@@ -7,6 +7,7 @@
 #include "modelmanager.h"
 
 #include "ksfilereader.h"
+#include "ksnumbers.h"
 #include "kstars.h"
 #include "kstarsdata.h"
 #include "obsconditions.h"
@@ -18,6 +19,12 @@
 
 #include <QtConcurrent>
 
+namespace
+{
+// Objects evaluated by a thread at once
+constexpr int batchSize = 256;
+}
+
 ModelManager::ModelManager(ObsConditions *obs)
 {
     m_ObsConditions = obs;
@@ -37,11 +44,18 @@ ModelManager::ModelManager(ObsConditions *obs)
         m_ObjectList.append(QList<SkyObjItem *>());
     }
 
-    QtConcurrent::run(this, &ModelManager::loadLists);
+    connect(&m_UpdateWatcher, &QFutureWatcher<Batch>::resultReadyAt, this, &ModelManager::slotBatchReady);
+    connect(&m_UpdateWatcher, &QFutureWatcher<Batch>::finished, this, &ModelManager::slotUpdateFinished);
+
+    m_LoadFuture = QtConcurrent::run(this, &ModelManager::loadLists);
 }
 
 ModelManager::~ModelManager()
 {
+    // The threads use the lists
+    m_LoadFuture.waitForFinished();
+    cancelUpdate();
+
     qDeleteAll(m_ModelList);
     foreach (QList<SkyObjItem *> list, m_ObjectList)
         qDeleteAll(list);
@@ -55,25 +69,14 @@ void ModelManager::loadLists()
 
     emit loadProgressUpdated(0);
     KStarsData *data = KStarsData::Instance();
-    QVector<QPair<QString, const SkyObject *>> listStars;
-    listStars.append(data->skyComposite()->objectLists(SkyObject::STAR));
-    for (int i = 0; i < listStars.size(); i++)
-    {
-        QPair<QString, const SkyObject *> pair = listStars.value(i);
-        const StarObject *star                 = dynamic_cast<const StarObject *>(pair.second);
-        if (star != nullptr && star->hasLatinName())
-            m_ObjectList[Stars].append(new SkyObjItem((SkyObject *)(star)));
-    }
-    QString prevName;
-    for (int i = 0; i < m_ObjectList[Stars].size(); i++)
+    QSet<QString> names;
+    for (const auto &pair : data->skyComposite()->objectLists(SkyObject::STAR))
     {
-        SkyObjItem *star = m_ObjectList[Stars].at(i);
-        if (prevName == star->getName())
-        {
-            m_ObjectList[Stars].removeAt(i);
-            i--;
-        }
-        prevName = star->getName();
+        const StarObject *star = dynamic_cast<const StarObject *>(pair.second);
+        if (star == nullptr || !star->hasLatinName() || names.contains(star->name()))
+            continue;
+        names.insert(star->name());
+        m_ObjectList[Stars].append(new SkyObjItem((SkyObject *)(star)));
     }
 
     KSFileReader fileReader;
@@ -150,7 +153,13 @@ void ModelManager::updateAllModels(ObsConditions *obs)
     resetAllModels();
 
     for (int i = 0; i < NumberOfLists; i++)
+    {
         loadObjectsIntoModel(*m_ModelList[i], m_ObjectList[i]);
+        m_UpdateWatcher.waitForFinished();
+        slotBatchReady();
+        m_UpdatedModel = nullptr;
+    }
+    emit modelUpdated();
 }
 
 void ModelManager::updateModel(ObsConditions *obs, QString modelName)
@@ -170,7 +179,10 @@ void ModelManager::updateModel(ObsConditions *obs, QString modelName)
             loadObjectsIntoModel(*m_ModelList[modelNumber], favoriteClusters);
         else
             loadObjectsIntoModel(*m_ModelList[modelNumber], m_ObjectList[modelNumber]);
-        emit modelUpdated();
+
+        // Otherwise emitted once the background update is finished
+        if (m_UpdatedModel == nullptr)
+            emit modelUpdated();
     }
 }
 
@@ -179,50 +191,128 @@ void ModelManager::loadObjectList(QList<SkyObjItem *> &skyObjectList, int type)
     if (KStars::Closing)
         return;
 
-    KStarsData *data                                   = KStarsData::Instance();
-    QVector<QPair<QString, const SkyObject *>> objects = data->skyComposite()->objectLists(type);
+    KStarsData *data = KStarsData::Instance();
 
-    for (int i = 0; i < objects.size(); i++)
+    // The objects have an entry for each of their names, keep one item per name
+    QSet<QString> names;
+    for (const SkyObjItem *item : skyObjectList)
+        names.insert(item->getName());
+
+    for (const auto &pair : data->skyComposite()->objectLists(type))
     {
         if (KStars::Closing)
             return;
 
-        QPair<QString, const SkyObject *> pair = objects.value(i);
-        const SkyObject *listObject            = pair.second;
-        if (listObject->name() != i18n("Sun"))
-            skyObjectList.append(new SkyObjItem(const_cast<SkyObject *>(listObject)));
+        const SkyObject *listObject = pair.second;
+        if (listObject->name() == i18n("Sun") || names.contains(listObject->name()))
+            continue;
+        names.insert(listObject->name());
+        skyObjectList.append(new SkyObjItem(const_cast<SkyObject *>(listObject)));
     }
-    QString prevName;
-    for (int i = 0; i < skyObjectList.size(); i++)
+}
+
+void ModelManager::loadObjectsIntoModel(SkyObjListModel &model, QList<SkyObjItem *> &skyObjectList)
+{
+    cancelUpdate();
+
+    if (!showOnlyVisible)
     {
-        if (KStars::Closing)
-            return;
+        model.addSkyObjects(skyObjectList.toVector());
+        return;
+    }
 
-        SkyObjItem *obj = skyObjectList.at(i);
-        if (prevName == obj->getName())
+    // Clones of solar system objects must be created in the main thread
+    KStarsData *data = KStarsData::Instance();
+    QVector<SkyObjItem *> visible, others;
+    for (SkyObjItem *soitem : skyObjectList)
+    {
+        SkyObject *so = soitem->getSkyObject();
+        if (so->isSolarSystem() || so->type() == SkyObject::SATELLITE)
         {
-            skyObjectList.removeAt(i);
-            i--;
+            if (m_ObsConditions->isVisible(data->geo(), data->lst(), so))
+                visible.append(soitem);
         }
-        prevName = obj->getName();
+        else
+            others.append(soitem);
     }
+    model.addSkyObjects(visible);
+
+    if (others.isEmpty())
+        return;
+
+    const auto conditions = currentConditions();
+    QVector<Batch> batches;
+    for (int i = 0; i < others.size(); i += batchSize)
+        batches.append({ conditions, others.mid(i, batchSize), {} });
+
+    m_UpdatedModel = &model;
+    m_NextBatch    = 0;
+    m_UpdateWatcher.setFuture(QtConcurrent::mapped(batches, &ModelManager::evaluate));
 }
 
-void ModelManager::loadObjectsIntoModel(SkyObjListModel &model, QList<SkyObjItem *> &skyObjectList)
+std::shared_ptr<const ModelManager::Conditions> ModelManager::currentConditions() const
 {
-    KStarsData *data = KStarsData::Instance();
+    KStarsData *data  = KStarsData::Instance();
+    KStarsDateTime ut = data->geo()->LTtoUT(KStarsDateTime(QDateTime::currentDateTime().toLocalTime()));
+
+    auto conditions      = std::make_shared<Conditions>();
+    conditions->lst      = *data->lst();
+    conditions->latitude = *data->geo()->lat();
+    conditions->num      = std::make_shared<KSNumbers>(ut.djd());
+    conditions->magLimit = m_ObsConditions->getTrueMagLim();
+    return conditions;
+}
+
+ModelManager::Batch ModelManager::evaluate(const Batch &batch)
+{
+    const Conditions &conditions = *batch.conditions;
 
-    foreach (SkyObjItem *soitem, skyObjectList)
+    // Same criteria as ObsConditions::isVisible()
+    Batch result;
+    for (SkyObjItem *soitem : batch.items)
     {
-        bool isVisible =
-            (showOnlyVisible) ? (m_ObsConditions->isVisible(data->geo(), data->lst(), soitem->getSkyObject())) : true;
-        if (isVisible)
-            model.addSkyObject(soitem);
+        if (soitem->getSkyObject()->mag() >= conditions.magLimit)
+            continue;
+
+        SkyPoint sp = soitem->apparentPosition(conditions.num.get());
+        sp.EquatorialToHorizontal(&conditions.lst, &conditions.latitude);
+        if (sp.alt().Degrees() > 6.0)
+            result.visible.append(soitem);
     }
+    return result;
+}
+
+void ModelManager::slotBatchReady()
+{
+    if (m_UpdatedModel == nullptr)
+        return;
+
+    // Add the batches in order, a batch ready early waits for those before it
+    const QFuture<Batch> future = m_UpdateWatcher.future();
+    while (future.isResultReadyAt(m_NextBatch))
+        m_UpdatedModel->addSkyObjects(future.resultAt(m_NextBatch++).visible);
+}
+
+void ModelManager::slotUpdateFinished()
+{
+    if (m_UpdatedModel == nullptr)
+        return;
+
+    slotBatchReady();
+    m_UpdatedModel = nullptr;
+    emit modelUpdated();
+}
+
+void ModelManager::cancelUpdate()
+{
+    m_UpdateWatcher.cancel();
+    m_UpdateWatcher.waitForFinished();
+    m_UpdatedModel = nullptr;
 }
 
 void ModelManager::resetAllModels()
 {
+    cancelUpdate();
     foreach (SkyObjListModel *model, m_ModelList)
         model->resetModel();
 }
@@ -301,6 +391,10 @@ void ModelManager::loadCatalog(const QString &name)
     for (auto &obj : lst)
         p_lst.append(&obj);
 
-    updateModel(m_ObsConditions, name);
-    emit loadProgressUpdated(1);
+    // The models are updated in the main thread
+    QMetaObject::invokeMethod(this, [this, name]()
+    {
+        updateModel(m_ObsConditions, name);
+        emit loadProgressUpdated(1);
+    }, Qt::QueuedConnection);
 };
@@ -9,12 +9,17 @@
 #include "catalogobject.h"
 #include "skyobjitem.h"
 #include "catalogsdb.h"
+#include "cachingdms.h"
+#include <QFutureWatcher>
 #include <QList>
 #include <QObject>
+#include <QVector>
 
 #include "polyfills/qstring_hash.h"
+#include <memory>
 #include <unordered_map>
 
+class KSNumbers;
 class ObsConditions;
 class SkyObjListModel;
 
@@ -22,6 +27,13 @@ class SkyObjListModel;
  * @class ModelManager
  * @brief Manages models for QML listviews of different types of sky-objects.
  *
+ * The object lists are built in a background thread when the manager is created. Updating a
+ * model evaluates the visibility of its objects in batches across the global thread pool, and
+ * adds the visible objects to the model batch after batch, as they are ready. The apparent
+ * coordinates of the objects outside of the solar system are kept for a day, so that a change
+ * of time or location only computes their altitudes again. Solar system objects are evaluated
+ * on the main thread, before the others.
+ *
  * @author Samikshan Bairagya
  */
 class ModelManager : public QObject
@@ -58,9 +70,15 @@ class ModelManager : public QObject
     explicit ModelManager(ObsConditions *obs);
     ~ModelManager() override;
 
-    /** Updates sky-object list models. */
+    /** Updates sky-object list models. Returns once all the models are updated. */
     void updateAllModels(ObsConditions *obs);
 
+    /**
+     * @brief Updates the model of given type. The visible objects are added to the model in the
+     * background, modelUpdated() is emitted when they all are.
+     * @param obs   Pointer to an ObsConditions object.
+     * @param modelName Name of sky-object model to be updated.
+     */
     void updateModel(ObsConditions *obs, QString modelName);
 
     /** Clears all sky-objects list models. */
@@ -98,13 +116,53 @@ class ModelManager : public QObject
     void loadProgressUpdated(double progress);
     void modelUpdated();
 
+  private slots:
+    void slotBatchReady();
+    void slotUpdateFinished();
+
   private:
+    /** Observing conditions of an update, shared by the threads evaluating the objects */
+    struct Conditions
+    {
+        CachingDms lst;
+        CachingDms latitude;
+        std::shared_ptr<const KSNumbers> num;
+        double magLimit { 0 };
+    };
+
+    /** Objects evaluated by one thread, and those of them found visible */
+    struct Batch
+    {
+        std::shared_ptr<const Conditions> conditions;
+        QVector<SkyObjItem *> items;
+        QVector<SkyObjItem *> visible;
+    };
+
     void loadLists();
     void loadObjectList(QList<SkyObjItem *> &skyObjectList, int type);
     void loadNamedStarList();
+
+    /**
+     * @brief Starts adding the visible objects of @p skyObjectList to @p model.
+     * The solar system objects are evaluated before returning, the others in the background.
+     */
     void loadObjectsIntoModel(SkyObjListModel &model, QList<SkyObjItem *> &skyObjectList);
 
+    /** @brief Stops the update in progress, the objects evaluated so far stay in the model */
+    void cancelUpdate();
+
+    /** @return the conditions of the observation now */
+    std::shared_ptr<const Conditions> currentConditions() const;
+
+    /** @return @p batch with its visible objects, which are not in the solar system */
+    static Batch evaluate(const Batch &batch);
+
     ObsConditions *m_ObsConditions{ nullptr };
+    /** The background update, the model it fills and the next batch to add to it */
+    QFutureWatcher<Batch> m_UpdateWatcher;
+    SkyObjListModel *m_UpdatedModel { nullptr };
+    int m_NextBatch { 0 };
+    QFuture<void> m_LoadFuture;
     QList<QList<SkyObjItem *>> m_ObjectList;
     QList<SkyObjListModel *> m_ModelList;
     bool showOnlyVisible{ true };
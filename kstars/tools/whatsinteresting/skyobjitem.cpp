@@ -8,11 +8,15 @@
 
 #include "catalogobject.h"
 #include "ksfilereader.h"
+#include "ksnumbers.h"
 #include "kspaths.h"
 #include "ksplanetbase.h"
 #include "kstarsdata.h"
 #include "ksutils.h"
 
+#include <cmath>
+#include <memory>
+
 SkyObjItem::SkyObjItem(SkyObject *so)
     : m_Name(so->name()), m_LongName(so->longname()), m_TypeName(so->typeName()), m_So(so)
 {
@@ -48,8 +52,6 @@ SkyObjItem::SkyObjItem(SkyObject *so)
         case SkyObject::SUPERNOVA:
             m_Type = Supernova;
     }
-
-    setPosition(m_So);
 }
 
 QVariant SkyObjItem::data(int role)
@@ -119,6 +121,18 @@ void SkyObjItem::setPosition(SkyObject *so)
                      "</span>";
 }
 
+const SkyPoint &SkyObjItem::apparentPosition(const KSNumbers *num)
+{
+    if (m_ApparentJD == 0 || std::abs(num->getJD() - m_ApparentJD) > 1)
+    {
+        std::unique_ptr<SkyObject> c(m_So->clone());
+        c->updateCoords(num);
+        m_Apparent   = *c;
+        m_ApparentJD = num->getJD();
+    }
+    return m_Apparent;
+}
+
 QString findImage(const QString &prefix, const SkyObject &obj, const QString &suffix)
 {
     static const auto base =
@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "skypoint.h"
+
 #include <QString>
 #include <QVariant>
 
+class KSNumbers;
 class SkyObject;
 
 /**
@@ -158,6 +161,16 @@ class SkyObjItem
      */
     void setPosition(SkyObject *so);
 
+    /**
+     * @brief Get the apparent coordinates of the sky-object for the date of @p num.
+     * They are computed again only when the date differs by more than a day from the last computation,
+     * in which they change by a few arcseconds. Not for solar system objects, whose clones must not be
+     * created in other threads.
+     * @param num Numbers of the date
+     * @return Apparent coordinates of the sky-object
+     */
+    const SkyPoint &apparentPosition(const KSNumbers *num);
+
   private:
     /// Name of sky-object
     QString m_Name;
@@ -171,4 +184,7 @@ class SkyObjItem
     Type m_Type { SkyObjItem::Planet };
     /// Pointer to SkyObject represented by SkyObjItem
     SkyObject *m_So { nullptr };
+    /// Apparent coordinates of sky-object, and the Julian day they were computed for
+    SkyPoint m_Apparent;
+    long double m_ApparentJD { 0 };
 };
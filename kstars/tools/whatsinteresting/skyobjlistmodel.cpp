@@ -35,6 +35,17 @@ void SkyObjListModel::addSkyObject(SkyObjItem *soitem)
     endInsertRows();
 }
 
+void SkyObjListModel::addSkyObjects(const QVector<SkyObjItem *> &items)
+{
+    if (items.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + items.size() - 1);
+    for (SkyObjItem *soitem : items)
+        m_SoItemList.append(soitem);
+    endInsertRows();
+}
+
 int SkyObjListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
@@ -77,5 +88,7 @@ int SkyObjListModel::getSkyObjIndex(SkyObjItem *item)
 
 void SkyObjListModel::resetModel()
 {
+    beginResetModel();
     m_SoItemList.clear();
+    endResetModel();
 }
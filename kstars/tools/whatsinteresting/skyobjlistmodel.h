@@ -8,6 +8,8 @@
 
 #include "qabstractitemmodel.h"
 
+#include <QVector>
+
 class SkyObjItem;
 
 /**
@@ -30,6 +32,13 @@ class SkyObjListModel : public QAbstractListModel
      */
     void addSkyObject(SkyObjItem *sobj);
 
+    /**
+     * @brief Add sky-objects to the model at once.
+     * @param items
+     * Pointers to sky-objects to be added.
+     */
+    void addSkyObjects(const QVector<SkyObjItem *> &items);
+
     /**
      * @brief Create and return a QHash<int, QByteArray> of rolenames for the SkyObjItem.
      * @return QHash<int, QByteArray> of rolenames for the SkyObjItem.
@@ -540,6 +540,7 @@ void WIView::loadDetailsView(SkyObjItem *soitem, int index)
     QObject *detailsTextObj = m_DetailsViewObj->findChild<QObject *>("detailsTextObj");
 
     sonameObj->setProperty("text", soitem->getDescName());
+    soitem->setPosition(soitem->getSkyObject());
     posTextObj->setProperty("text", soitem->getPosition());
     detailImage->setProperty("refreshableSource", soitem->getImageURL(false));
 